@@ -21,7 +21,7 @@ namespace AOT {
 
 class Compiler {
 public:
-  static inline uint32_t kVersion = 1;
+  static inline uint32_t kVersion = 5;
 
   Expect<void> compile(const Bytes &Data, const AST::Module &Module,
                        std::string_view OutputPath);
@@ -38,6 +38,7 @@ public:
     Sec_Element,
     Sec_Code,
     Sec_Data,
+    Sec_DataCount,
     Desc_Import,
     Desc_Export,
     Seg_Global,
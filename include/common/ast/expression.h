@@ -35,14 +35,18 @@ public:
   Expect<void> loadBinary(FileMgr &Mgr) override;
 
   /// Getter of instructions vector.
-  InstrVec &getInstrs() { return Instrs; }
+  const InstrVec &getInstrs() const { return Instrs; }
+
+  /// Getter of the arena which stores the instruction nodes.
+  std::shared_ptr<const Arena> getArena() const { return Pool; }
 
 protected:
   /// The node type should be Attr::Expression.
   Attr NodeAttr = Attr::Expression;
 
 private:
-  /// Instruction set list.
+  /// Instruction set list. All nodes are freed with the arena at once.
+  std::shared_ptr<Arena> Pool;
   InstrVec Instrs;
 };
 
@@ -16,24 +16,29 @@
 #include "common/types.h"
 #include "common/value.h"
 #include "loader/filemgr.h"
+#include "support/arena.h"
+#include "support/span.h"
 #include "support/variant.h"
 
+#include <array>
 #include <memory>
 #include <vector>
 
 namespace SSVM {
 namespace AST {
 
-/// Type aliasing
+/// Type aliasing. Instruction nodes and sequences are stored in the arena of
+/// the expression they belong to.
 class Instruction;
-using InstrVec = std::vector<std::unique_ptr<Instruction>>;
-using InstrIter = InstrVec::const_iterator;
+using InstrVec = Span<Instruction *const>;
+using InstrIter = InstrVec::iterator;
 
-/// Loader class of Instruction node.
+/// Loader class of Instruction node. Instruction nodes are trivially
+/// destructible and freed with their arena.
 class Instruction {
 public:
   /// Instruction opcode enumeration class.
-  enum class OpCode : uint8_t {
+  enum class OpCode : uint16_t {
     /// Control instructions
     Unreachable = 0x00,
     Nop = 0x01,
@@ -48,10 +53,13 @@ public:
     Return = 0x0F,
     Call = 0x10,
     Call_indirect = 0x11,
+    Return_call = 0x12,
+    Return_call_indirect = 0x13,
 
     /// Parametric Instructions
     Drop = 0x1A,
     Select = 0x1B,
+    Select_t = 0x1C,
 
     /// Variable Instructions
     Local__get = 0x20,
@@ -60,6 +68,10 @@ public:
     Global__get = 0x23,
     Global__set = 0x24,
 
+    /// Table Instructions
+    Table__get = 0x25,
+    Table__set = 0x26,
+
     /// Memory Instructions
     I32__load = 0x28,
     I64__load = 0x29,
@@ -216,15 +228,347 @@ public:
     I32__reinterpret_f32 = 0xBC,
     I64__reinterpret_f64 = 0xBD,
     F32__reinterpret_i32 = 0xBE,
-    F64__reinterpret_i64 = 0xBF
+    F64__reinterpret_i64 = 0xBF,
+
+    /// Reference instructions
+    Ref__null = 0xD0,
+    Ref__is_null = 0xD1,
+    Ref__func = 0xD2,
+
+    /// Bulk memory instructions, which are 0xFC and the LEB128 encoded
+    /// sub-opcode.
+    Memory__init = 0xFC08,
+    Data__drop = 0xFC09,
+    Memory__copy = 0xFC0A,
+    Memory__fill = 0xFC0B,
+    Table__init = 0xFC0C,
+    Elem__drop = 0xFC0D,
+    Table__copy = 0xFC0E,
+    Table__grow = 0xFC0F,
+    Table__size = 0xFC10,
+    Table__fill = 0xFC11,
+
+    /// SIMD instructions, which are 0xFD and the LEB128 encoded sub-opcode.
+    V128__load = 0xFD00,
+    V128__load8x8_s = 0xFD01,
+    V128__load8x8_u = 0xFD02,
+    V128__load16x4_s = 0xFD03,
+    V128__load16x4_u = 0xFD04,
+    V128__load32x2_s = 0xFD05,
+    V128__load32x2_u = 0xFD06,
+    V128__load8_splat = 0xFD07,
+    V128__load16_splat = 0xFD08,
+    V128__load32_splat = 0xFD09,
+    V128__load64_splat = 0xFD0A,
+    V128__store = 0xFD0B,
+    V128__const = 0xFD0C,
+    I8x16__shuffle = 0xFD0D,
+    I8x16__swizzle = 0xFD0E,
+    I8x16__splat = 0xFD0F,
+    I16x8__splat = 0xFD10,
+    I32x4__splat = 0xFD11,
+    I64x2__splat = 0xFD12,
+    F32x4__splat = 0xFD13,
+    F64x2__splat = 0xFD14,
+    I8x16__extract_lane_s = 0xFD15,
+    I8x16__extract_lane_u = 0xFD16,
+    I8x16__replace_lane = 0xFD17,
+    I16x8__extract_lane_s = 0xFD18,
+    I16x8__extract_lane_u = 0xFD19,
+    I16x8__replace_lane = 0xFD1A,
+    I32x4__extract_lane = 0xFD1B,
+    I32x4__replace_lane = 0xFD1C,
+    I64x2__extract_lane = 0xFD1D,
+    I64x2__replace_lane = 0xFD1E,
+    F32x4__extract_lane = 0xFD1F,
+    F32x4__replace_lane = 0xFD20,
+    F64x2__extract_lane = 0xFD21,
+    F64x2__replace_lane = 0xFD22,
+    I8x16__eq = 0xFD23,
+    I8x16__ne = 0xFD24,
+    I8x16__lt_s = 0xFD25,
+    I8x16__lt_u = 0xFD26,
+    I8x16__gt_s = 0xFD27,
+    I8x16__gt_u = 0xFD28,
+    I8x16__le_s = 0xFD29,
+    I8x16__le_u = 0xFD2A,
+    I8x16__ge_s = 0xFD2B,
+    I8x16__ge_u = 0xFD2C,
+    I16x8__eq = 0xFD2D,
+    I16x8__ne = 0xFD2E,
+    I16x8__lt_s = 0xFD2F,
+    I16x8__lt_u = 0xFD30,
+    I16x8__gt_s = 0xFD31,
+    I16x8__gt_u = 0xFD32,
+    I16x8__le_s = 0xFD33,
+    I16x8__le_u = 0xFD34,
+    I16x8__ge_s = 0xFD35,
+    I16x8__ge_u = 0xFD36,
+    I32x4__eq = 0xFD37,
+    I32x4__ne = 0xFD38,
+    I32x4__lt_s = 0xFD39,
+    I32x4__lt_u = 0xFD3A,
+    I32x4__gt_s = 0xFD3B,
+    I32x4__gt_u = 0xFD3C,
+    I32x4__le_s = 0xFD3D,
+    I32x4__le_u = 0xFD3E,
+    I32x4__ge_s = 0xFD3F,
+    I32x4__ge_u = 0xFD40,
+    F32x4__eq = 0xFD41,
+    F32x4__ne = 0xFD42,
+    F32x4__lt = 0xFD43,
+    F32x4__gt = 0xFD44,
+    F32x4__le = 0xFD45,
+    F32x4__ge = 0xFD46,
+    F64x2__eq = 0xFD47,
+    F64x2__ne = 0xFD48,
+    F64x2__lt = 0xFD49,
+    F64x2__gt = 0xFD4A,
+    F64x2__le = 0xFD4B,
+    F64x2__ge = 0xFD4C,
+    V128__not = 0xFD4D,
+    V128__and = 0xFD4E,
+    V128__andnot = 0xFD4F,
+    V128__or = 0xFD50,
+    V128__xor = 0xFD51,
+    V128__bitselect = 0xFD52,
+    V128__any_true = 0xFD53,
+    V128__load8_lane = 0xFD54,
+    V128__load16_lane = 0xFD55,
+    V128__load32_lane = 0xFD56,
+    V128__load64_lane = 0xFD57,
+    V128__store8_lane = 0xFD58,
+    V128__store16_lane = 0xFD59,
+    V128__store32_lane = 0xFD5A,
+    V128__store64_lane = 0xFD5B,
+    V128__load32_zero = 0xFD5C,
+    V128__load64_zero = 0xFD5D,
+    F32x4__demote_f64x2_zero = 0xFD5E,
+    F64x2__promote_low_f32x4 = 0xFD5F,
+    I8x16__abs = 0xFD60,
+    I8x16__neg = 0xFD61,
+    I8x16__popcnt = 0xFD62,
+    I8x16__all_true = 0xFD63,
+    I8x16__bitmask = 0xFD64,
+    I8x16__narrow_i16x8_s = 0xFD65,
+    I8x16__narrow_i16x8_u = 0xFD66,
+    F32x4__ceil = 0xFD67,
+    F32x4__floor = 0xFD68,
+    F32x4__trunc = 0xFD69,
+    F32x4__nearest = 0xFD6A,
+    I8x16__shl = 0xFD6B,
+    I8x16__shr_s = 0xFD6C,
+    I8x16__shr_u = 0xFD6D,
+    I8x16__add = 0xFD6E,
+    I8x16__add_sat_s = 0xFD6F,
+    I8x16__add_sat_u = 0xFD70,
+    I8x16__sub = 0xFD71,
+    I8x16__sub_sat_s = 0xFD72,
+    I8x16__sub_sat_u = 0xFD73,
+    F64x2__ceil = 0xFD74,
+    F64x2__floor = 0xFD75,
+    I8x16__min_s = 0xFD76,
+    I8x16__min_u = 0xFD77,
+    I8x16__max_s = 0xFD78,
+    I8x16__max_u = 0xFD79,
+    F64x2__trunc = 0xFD7A,
+    I8x16__avgr_u = 0xFD7B,
+    I16x8__extadd_pairwise_i8x16_s = 0xFD7C,
+    I16x8__extadd_pairwise_i8x16_u = 0xFD7D,
+    I32x4__extadd_pairwise_i16x8_s = 0xFD7E,
+    I32x4__extadd_pairwise_i16x8_u = 0xFD7F,
+    I16x8__abs = 0xFD80,
+    I16x8__neg = 0xFD81,
+    I16x8__q15mulr_sat_s = 0xFD82,
+    I16x8__all_true = 0xFD83,
+    I16x8__bitmask = 0xFD84,
+    I16x8__narrow_i32x4_s = 0xFD85,
+    I16x8__narrow_i32x4_u = 0xFD86,
+    I16x8__extend_low_i8x16_s = 0xFD87,
+    I16x8__extend_high_i8x16_s = 0xFD88,
+    I16x8__extend_low_i8x16_u = 0xFD89,
+    I16x8__extend_high_i8x16_u = 0xFD8A,
+    I16x8__shl = 0xFD8B,
+    I16x8__shr_s = 0xFD8C,
+    I16x8__shr_u = 0xFD8D,
+    I16x8__add = 0xFD8E,
+    I16x8__add_sat_s = 0xFD8F,
+    I16x8__add_sat_u = 0xFD90,
+    I16x8__sub = 0xFD91,
+    I16x8__sub_sat_s = 0xFD92,
+    I16x8__sub_sat_u = 0xFD93,
+    F64x2__nearest = 0xFD94,
+    I16x8__mul = 0xFD95,
+    I16x8__min_s = 0xFD96,
+    I16x8__min_u = 0xFD97,
+    I16x8__max_s = 0xFD98,
+    I16x8__max_u = 0xFD99,
+    I16x8__avgr_u = 0xFD9B,
+    I16x8__extmul_low_i8x16_s = 0xFD9C,
+    I16x8__extmul_high_i8x16_s = 0xFD9D,
+    I16x8__extmul_low_i8x16_u = 0xFD9E,
+    I16x8__extmul_high_i8x16_u = 0xFD9F,
+    I32x4__abs = 0xFDA0,
+    I32x4__neg = 0xFDA1,
+    I32x4__all_true = 0xFDA3,
+    I32x4__bitmask = 0xFDA4,
+    I32x4__extend_low_i16x8_s = 0xFDA7,
+    I32x4__extend_high_i16x8_s = 0xFDA8,
+    I32x4__extend_low_i16x8_u = 0xFDA9,
+    I32x4__extend_high_i16x8_u = 0xFDAA,
+    I32x4__shl = 0xFDAB,
+    I32x4__shr_s = 0xFDAC,
+    I32x4__shr_u = 0xFDAD,
+    I32x4__add = 0xFDAE,
+    I32x4__sub = 0xFDB1,
+    I32x4__mul = 0xFDB5,
+    I32x4__min_s = 0xFDB6,
+    I32x4__min_u = 0xFDB7,
+    I32x4__max_s = 0xFDB8,
+    I32x4__max_u = 0xFDB9,
+    I32x4__dot_i16x8_s = 0xFDBA,
+    I32x4__extmul_low_i16x8_s = 0xFDBC,
+    I32x4__extmul_high_i16x8_s = 0xFDBD,
+    I32x4__extmul_low_i16x8_u = 0xFDBE,
+    I32x4__extmul_high_i16x8_u = 0xFDBF,
+    I64x2__abs = 0xFDC0,
+    I64x2__neg = 0xFDC1,
+    I64x2__all_true = 0xFDC3,
+    I64x2__bitmask = 0xFDC4,
+    I64x2__extend_low_i32x4_s = 0xFDC7,
+    I64x2__extend_high_i32x4_s = 0xFDC8,
+    I64x2__extend_low_i32x4_u = 0xFDC9,
+    I64x2__extend_high_i32x4_u = 0xFDCA,
+    I64x2__shl = 0xFDCB,
+    I64x2__shr_s = 0xFDCC,
+    I64x2__shr_u = 0xFDCD,
+    I64x2__add = 0xFDCE,
+    I64x2__sub = 0xFDD1,
+    I64x2__mul = 0xFDD5,
+    I64x2__eq = 0xFDD6,
+    I64x2__ne = 0xFDD7,
+    I64x2__lt_s = 0xFDD8,
+    I64x2__gt_s = 0xFDD9,
+    I64x2__le_s = 0xFDDA,
+    I64x2__ge_s = 0xFDDB,
+    I64x2__extmul_low_i32x4_s = 0xFDDC,
+    I64x2__extmul_high_i32x4_s = 0xFDDD,
+    I64x2__extmul_low_i32x4_u = 0xFDDE,
+    I64x2__extmul_high_i32x4_u = 0xFDDF,
+    F32x4__abs = 0xFDE0,
+    F32x4__neg = 0xFDE1,
+    F32x4__sqrt = 0xFDE3,
+    F32x4__add = 0xFDE4,
+    F32x4__sub = 0xFDE5,
+    F32x4__mul = 0xFDE6,
+    F32x4__div = 0xFDE7,
+    F32x4__min = 0xFDE8,
+    F32x4__max = 0xFDE9,
+    F32x4__pmin = 0xFDEA,
+    F32x4__pmax = 0xFDEB,
+    F64x2__abs = 0xFDEC,
+    F64x2__neg = 0xFDED,
+    F64x2__sqrt = 0xFDEF,
+    F64x2__add = 0xFDF0,
+    F64x2__sub = 0xFDF1,
+    F64x2__mul = 0xFDF2,
+    F64x2__div = 0xFDF3,
+    F64x2__min = 0xFDF4,
+    F64x2__max = 0xFDF5,
+    F64x2__pmin = 0xFDF6,
+    F64x2__pmax = 0xFDF7,
+    I32x4__trunc_sat_f32x4_s = 0xFDF8,
+    I32x4__trunc_sat_f32x4_u = 0xFDF9,
+    F32x4__convert_i32x4_s = 0xFDFA,
+    F32x4__convert_i32x4_u = 0xFDFB,
+    I32x4__trunc_sat_f64x2_s_zero = 0xFDFC,
+    I32x4__trunc_sat_f64x2_u_zero = 0xFDFD,
+    F64x2__convert_low_i32x4_s = 0xFDFE,
+    F64x2__convert_low_i32x4_u = 0xFDFF,
+
+    /// Atomic instructions, which are 0xFE and the LEB128 encoded sub-opcode.
+    Memory__atomic__notify = 0xFE00,
+    Memory__atomic__wait32 = 0xFE01,
+    Memory__atomic__wait64 = 0xFE02,
+    Atomic__fence = 0xFE03,
+    I32__atomic__load = 0xFE10,
+    I64__atomic__load = 0xFE11,
+    I32__atomic__load8_u = 0xFE12,
+    I32__atomic__load16_u = 0xFE13,
+    I64__atomic__load8_u = 0xFE14,
+    I64__atomic__load16_u = 0xFE15,
+    I64__atomic__load32_u = 0xFE16,
+    I32__atomic__store = 0xFE17,
+    I64__atomic__store = 0xFE18,
+    I32__atomic__store8 = 0xFE19,
+    I32__atomic__store16 = 0xFE1A,
+    I64__atomic__store8 = 0xFE1B,
+    I64__atomic__store16 = 0xFE1C,
+    I64__atomic__store32 = 0xFE1D,
+    I32__atomic__rmw__add = 0xFE1E,
+    I64__atomic__rmw__add = 0xFE1F,
+    I32__atomic__rmw8__add_u = 0xFE20,
+    I32__atomic__rmw16__add_u = 0xFE21,
+    I64__atomic__rmw8__add_u = 0xFE22,
+    I64__atomic__rmw16__add_u = 0xFE23,
+    I64__atomic__rmw32__add_u = 0xFE24,
+    I32__atomic__rmw__sub = 0xFE25,
+    I64__atomic__rmw__sub = 0xFE26,
+    I32__atomic__rmw8__sub_u = 0xFE27,
+    I32__atomic__rmw16__sub_u = 0xFE28,
+    I64__atomic__rmw8__sub_u = 0xFE29,
+    I64__atomic__rmw16__sub_u = 0xFE2A,
+    I64__atomic__rmw32__sub_u = 0xFE2B,
+    I32__atomic__rmw__and = 0xFE2C,
+    I64__atomic__rmw__and = 0xFE2D,
+    I32__atomic__rmw8__and_u = 0xFE2E,
+    I32__atomic__rmw16__and_u = 0xFE2F,
+    I64__atomic__rmw8__and_u = 0xFE30,
+    I64__atomic__rmw16__and_u = 0xFE31,
+    I64__atomic__rmw32__and_u = 0xFE32,
+    I32__atomic__rmw__or = 0xFE33,
+    I64__atomic__rmw__or = 0xFE34,
+    I32__atomic__rmw8__or_u = 0xFE35,
+    I32__atomic__rmw16__or_u = 0xFE36,
+    I64__atomic__rmw8__or_u = 0xFE37,
+    I64__atomic__rmw16__or_u = 0xFE38,
+    I64__atomic__rmw32__or_u = 0xFE39,
+    I32__atomic__rmw__xor = 0xFE3A,
+    I64__atomic__rmw__xor = 0xFE3B,
+    I32__atomic__rmw8__xor_u = 0xFE3C,
+    I32__atomic__rmw16__xor_u = 0xFE3D,
+    I64__atomic__rmw8__xor_u = 0xFE3E,
+    I64__atomic__rmw16__xor_u = 0xFE3F,
+    I64__atomic__rmw32__xor_u = 0xFE40,
+    I32__atomic__rmw__xchg = 0xFE41,
+    I64__atomic__rmw__xchg = 0xFE42,
+    I32__atomic__rmw8__xchg_u = 0xFE43,
+    I32__atomic__rmw16__xchg_u = 0xFE44,
+    I64__atomic__rmw8__xchg_u = 0xFE45,
+    I64__atomic__rmw16__xchg_u = 0xFE46,
+    I64__atomic__rmw32__xchg_u = 0xFE47,
+    I32__atomic__rmw__cmpxchg = 0xFE48,
+    I64__atomic__rmw__cmpxchg = 0xFE49,
+    I32__atomic__rmw8__cmpxchg_u = 0xFE4A,
+    I32__atomic__rmw16__cmpxchg_u = 0xFE4B,
+    I64__atomic__rmw8__cmpxchg_u = 0xFE4C,
+    I64__atomic__rmw16__cmpxchg_u = 0xFE4D,
+    I64__atomic__rmw32__cmpxchg_u = 0xFE4E
   };
 
   /// Constructor assigns the OpCode.
   Instruction(const OpCode &Byte) : Code(Byte) {}
-  virtual ~Instruction() noexcept = default;
 
   /// Binary loading from file manager. Default not load anything.
-  virtual Expect<void> loadBinary(FileMgr &Mgr) { return {}; }
+  ///
+  /// \param Mgr the file manager reference.
+  /// \param Pool the arena of instruction nodes.
+  ///
+  /// \returns void when success, ErrMsg when failed.
+  virtual Expect<void> loadBinary(FileMgr &Mgr,
+                                  [[maybe_unused]] Arena &Pool) {
+    return {};
+  }
 
   /// Getter of OpCode.
   OpCode getOpCode() const { return Code; }
@@ -239,9 +583,6 @@ class ControlInstruction : public Instruction {
 public:
   /// Call base constructor to initialize OpCode.
   ControlInstruction(const OpCode &Byte) : Instruction(Byte) {}
-  /// Copy constructor.
-  ControlInstruction(const ControlInstruction &Instr)
-      : Instruction(Instr.Code) {}
 };
 
 /// Derived block control instruction node.
@@ -249,8 +590,6 @@ class BlockControlInstruction : public Instruction {
 public:
   /// Call base constructor to initialize OpCode.
   BlockControlInstruction(const OpCode &Byte) : Instruction(Byte) {}
-  /// Copy constructor.
-  BlockControlInstruction(const BlockControlInstruction &Instr);
 
   /// Load binary from file manager.
   ///
@@ -258,12 +597,13 @@ public:
   /// Read the return type, instructions in block body.
   ///
   /// \param Mgr the file manager reference.
+  /// \param Pool the arena of instruction nodes.
   ///
   /// \returns void when success, ErrMsg when failed.
-  Expect<void> loadBinary(FileMgr &Mgr) override;
+  Expect<void> loadBinary(FileMgr &Mgr, Arena &Pool) override;
 
   /// Getter of block type
-  ValType getResultType() const { return BlockType; }
+  BlockType getBlockType() const { return ResType; }
 
   /// Getter of Block Body
   const InstrVec &getBody() const { return Body; }
@@ -271,7 +611,7 @@ public:
 private:
   /// \name Data of block instruction: return type and block body.
   /// @{
-  ValType BlockType;
+  BlockType ResType;
   InstrVec Body;
   /// @}
 }; // namespace AST
@@ -281,8 +621,6 @@ class IfElseControlInstruction : public Instruction {
 public:
   /// Call base constructor to initialize OpCode.
   IfElseControlInstruction(const OpCode &Byte) : Instruction(Byte) {}
-  /// Copy constructor.
-  IfElseControlInstruction(const IfElseControlInstruction &Instr);
 
   /// Load binary from file manager.
   ///
@@ -290,12 +628,13 @@ public:
   /// Read the return type, instructions in If and Else statements.
   ///
   /// \param Mgr the file manager reference.
+  /// \param Pool the arena of instruction nodes.
   ///
   /// \returns void when success, ErrMsg when failed.
-  Expect<void> loadBinary(FileMgr &Mgr) override;
+  Expect<void> loadBinary(FileMgr &Mgr, Arena &Pool) override;
 
   /// Getter of block type
-  ValType getResultType() const { return BlockType; }
+  BlockType getBlockType() const { return ResType; }
 
   /// Getter of if statement.
   const InstrVec &getIfStatement() const { return IfStatement; }
@@ -306,7 +645,7 @@ public:
 private:
   /// \name Data of block instruction: return type and statements.
   /// @{
-  ValType BlockType;
+  BlockType ResType;
   InstrVec IfStatement;
   InstrVec ElseStatement;
   /// @}
@@ -317,9 +656,6 @@ class BrControlInstruction : public Instruction {
 public:
   /// Call base constructor to initialize OpCode.
   BrControlInstruction(const OpCode &Byte) : Instruction(Byte) {}
-  /// Copy constructor.
-  BrControlInstruction(const BrControlInstruction &Instr)
-      : Instruction(Instr.Code), LabelIdx(Instr.LabelIdx) {}
 
   /// Load binary from file manager.
   ///
@@ -327,9 +663,10 @@ public:
   /// Read the branch label index.
   ///
   /// \param Mgr the file manager reference.
+  /// \param Pool the arena of instruction nodes.
   ///
   /// \returns void when success, ErrMsg when failed.
-  Expect<void> loadBinary(FileMgr &Mgr) override;
+  Expect<void> loadBinary(FileMgr &Mgr, Arena &Pool) override;
 
   /// Get label index
   uint32_t getLabelIndex() const { return LabelIdx; }
@@ -344,10 +681,6 @@ class BrTableControlInstruction : public Instruction {
 public:
   /// Call base constructor to initialize OpCode.
   BrTableControlInstruction(const OpCode &Byte) : Instruction(Byte) {}
-  /// Copy constructor.
-  BrTableControlInstruction(const BrTableControlInstruction &Instr)
-      : Instruction(Instr.Code), LabelTable(Instr.LabelTable),
-        LabelIdx(Instr.LabelIdx) {}
 
   /// Load binary from file manager.
   ///
@@ -355,12 +688,13 @@ public:
   /// Read the vector of labels and default branch label of indirect branch.
   ///
   /// \param Mgr the file manager reference.
+  /// \param Pool the arena of instruction nodes.
   ///
   /// \returns void when success, ErrMsg when failed.
-  Expect<void> loadBinary(FileMgr &Mgr) override;
+  Expect<void> loadBinary(FileMgr &Mgr, Arena &Pool) override;
 
   /// Getter of label table
-  const std::vector<uint32_t> &getLabelTable() const { return LabelTable; }
+  Span<const uint32_t> getLabelTable() const { return LabelTable; }
 
   /// Getter of label index
   uint32_t getLabelIndex() const { return LabelIdx; }
@@ -368,7 +702,7 @@ public:
 private:
   /// \name Data of branch instruction: label vector and defalt label.
   /// @{
-  std::vector<uint32_t> LabelTable;
+  Span<const uint32_t> LabelTable;
   uint32_t LabelIdx = 0;
   /// @}
 };
@@ -378,26 +712,29 @@ class CallControlInstruction : public Instruction {
 public:
   /// Call base constructor to initialize OpCode.
   CallControlInstruction(const OpCode &Byte) : Instruction(Byte) {}
-  /// Copy constructor.
-  CallControlInstruction(const CallControlInstruction &Instr)
-      : Instruction(Instr.Code), FuncIdx(Instr.FuncIdx) {}
 
   /// Load binary from file manager.
   ///
   /// Inheritted and overrided from Instruction.
-  /// Read the function index.
+  /// Read the function index, or the type index and the table index in the
+  /// call_indirect and return_call_indirect cases.
   ///
   /// \param Mgr the file manager reference.
+  /// \param Pool the arena of instruction nodes.
   ///
   /// \returns void when success, ErrMsg when failed.
-  Expect<void> loadBinary(FileMgr &Mgr) override;
+  Expect<void> loadBinary(FileMgr &Mgr, Arena &Pool) override;
 
-  /// Getter of the index
+  /// Getters of the function index and the table index.
   uint32_t getFuncIndex() const { return FuncIdx; }
+  uint32_t getTableIndex() const { return TableIdx; }
 
 private:
-  /// Call function index.
+  /// \name Data of call instruction: Function index and table index.
+  /// @{
   uint32_t FuncIdx = 0;
+  uint32_t TableIdx = 0;
+  /// @}
 };
 
 /// Derived parametric instruction node.
@@ -405,6 +742,24 @@ class ParametricInstruction : public Instruction {
 public:
   /// Call base constructor to initialize OpCode.
   ParametricInstruction(const OpCode &Byte) : Instruction(Byte) {}
+
+  /// Load binary from file manager.
+  ///
+  /// Inheritted and overrided from Instruction.
+  /// Read the value type in the typed select case.
+  ///
+  /// \param Mgr the file manager reference.
+  /// \param Pool the arena of instruction nodes.
+  ///
+  /// \returns void when success, ErrMsg when failed.
+  Expect<void> loadBinary(FileMgr &Mgr, Arena &Pool) override;
+
+  /// Getter of the value type of typed select. None for the others.
+  ValType getValType() const { return Type; }
+
+private:
+  /// Operand type of typed select.
+  ValType Type = ValType::None;
 };
 
 /// Derived variable instruction node.
@@ -412,9 +767,6 @@ class VariableInstruction : public Instruction {
 public:
   /// Call base constructor to initialize OpCode.
   VariableInstruction(const OpCode &Byte) : Instruction(Byte) {}
-  /// Copy constructor.
-  VariableInstruction(const VariableInstruction &Instr)
-      : Instruction(Instr.Code), VarIdx(Instr.VarIdx) {}
 
   /// Load binary from file manager.
   ///
@@ -422,9 +774,10 @@ public:
   /// Read the global or local variable index.
   ///
   /// \param Mgr the file manager reference.
+  /// \param Pool the arena of instruction nodes.
   ///
   /// \returns void when success, ErrMsg when failed.
-  Expect<void> loadBinary(FileMgr &Mgr) override;
+  Expect<void> loadBinary(FileMgr &Mgr, Arena &Pool) override;
 
   /// Getter of the index
   uint32_t getVariableIndex() const { return VarIdx; }
@@ -439,29 +792,91 @@ class MemoryInstruction : public Instruction {
 public:
   /// Call base constructor to initialize OpCode.
   MemoryInstruction(const OpCode &Byte) : Instruction(Byte) {}
-  /// Copy constructor.
-  MemoryInstruction(const MemoryInstruction &Instr)
-      : Instruction(Instr.Code), Align(Instr.Align), Offset(Instr.Offset) {}
 
   /// Load binary from file manager.
   ///
   /// Inheritted and overrided from Instruction.
-  /// Read the memory arguments: alignment and offset.
+  /// Read the memory arguments: alignment and offset, or the data segment
+  /// index in the bulk memory cases.
   ///
   /// \param Mgr the file manager reference.
+  /// \param Pool the arena of instruction nodes.
   ///
   /// \returns void when success, ErrMsg when failed.
-  Expect<void> loadBinary(FileMgr &Mgr) override;
+  Expect<void> loadBinary(FileMgr &Mgr, Arena &Pool) override;
 
-  /// Getters of memory align and offset.
+  /// Getters of memory align, offset, and data segment index.
   uint32_t getMemoryAlign() const { return Align; }
   uint32_t getMemoryOffset() const { return Offset; }
+  uint32_t getDataIndex() const { return DataIdx; }
 
 private:
-  /// \name Data of memory instruction: Alignment and offset.
+  /// \name Data of memory instruction: Alignment, offset, and data index.
   /// @{
   uint32_t Align = 0;
   uint32_t Offset = 0;
+  uint32_t DataIdx = 0;
+  /// @}
+};
+
+/// Derived table instruction node.
+class TableInstruction : public Instruction {
+public:
+  /// Call base constructor to initialize OpCode.
+  TableInstruction(const OpCode &Byte) : Instruction(Byte) {}
+
+  /// Load binary from file manager.
+  ///
+  /// Inheritted and overrided from Instruction.
+  /// Read the element segment index and the table indices.
+  ///
+  /// \param Mgr the file manager reference.
+  /// \param Pool the arena of instruction nodes.
+  ///
+  /// \returns void when success, ErrMsg when failed.
+  Expect<void> loadBinary(FileMgr &Mgr, Arena &Pool) override;
+
+  /// Getters of destination table, source table, and element segment index.
+  uint32_t getTargetIndex() const { return TargetIdx; }
+  uint32_t getSourceIndex() const { return SourceIdx; }
+  uint32_t getElemIndex() const { return ElemIdx; }
+
+private:
+  /// \name Data of table instruction: Table indices and element index.
+  /// @{
+  uint32_t TargetIdx = 0;
+  uint32_t SourceIdx = 0;
+  uint32_t ElemIdx = 0;
+  /// @}
+};
+
+/// Derived reference instruction node.
+class ReferenceInstruction : public Instruction {
+public:
+  /// Call base constructor to initialize OpCode.
+  ReferenceInstruction(const OpCode &Byte) : Instruction(Byte) {}
+
+  /// Load binary from file manager.
+  ///
+  /// Inheritted and overrided from Instruction.
+  /// Read the reference type in ref.null case and the function index in
+  /// ref.func case.
+  ///
+  /// \param Mgr the file manager reference.
+  /// \param Pool the arena of instruction nodes.
+  ///
+  /// \returns void when success, ErrMsg when failed.
+  Expect<void> loadBinary(FileMgr &Mgr, Arena &Pool) override;
+
+  /// Getters of reference type and function index.
+  ValType getReferenceType() const { return Type; }
+  uint32_t getFuncIndex() const { return FuncIdx; }
+
+private:
+  /// \name Data of reference instruction: Reference type and function index.
+  /// @{
+  ValType Type = ValType::FuncRef;
+  uint32_t FuncIdx = 0;
   /// @}
 };
 
@@ -470,9 +885,6 @@ class ConstInstruction : public Instruction {
 public:
   /// Call base constructor to initialize OpCode.
   ConstInstruction(const OpCode &Byte) : Instruction(Byte) {}
-  /// Copy constructor.
-  ConstInstruction(const ConstInstruction &Instr)
-      : Instruction(Instr.Code), Num(Instr.Num) {}
 
   /// Load binary from file manager.
   ///
@@ -480,9 +892,10 @@ public:
   /// Read and decode the const value.
   ///
   /// \param Mgr the file manager reference.
+  /// \param Pool the arena of instruction nodes.
   ///
   /// \returns void when success, ErrMsg when failed.
-  Expect<void> loadBinary(FileMgr &Mgr) override;
+  Expect<void> loadBinary(FileMgr &Mgr, Arena &Pool) override;
 
   /// Getter of the constant value.
   ValVariant getConstValue() const { return Num; }
@@ -497,9 +910,6 @@ class UnaryNumericInstruction : public Instruction {
 public:
   /// Call base constructor to initialize OpCode.
   UnaryNumericInstruction(const OpCode &Byte) : Instruction(Byte) {}
-  /// Copy constructor.
-  UnaryNumericInstruction(const UnaryNumericInstruction &Instr)
-      : Instruction(Instr.Code) {}
 };
 
 /// Derived numeric instruction node.
@@ -507,9 +917,125 @@ class BinaryNumericInstruction : public Instruction {
 public:
   /// Call base constructor to initialize OpCode.
   BinaryNumericInstruction(const OpCode &Byte) : Instruction(Byte) {}
-  /// Copy constructor.
-  BinaryNumericInstruction(const BinaryNumericInstruction &Instr)
-      : Instruction(Instr.Code) {}
+};
+
+/// Derived SIMD memory instruction node.
+class SIMDMemoryInstruction : public Instruction {
+public:
+  /// Call base constructor to initialize OpCode.
+  SIMDMemoryInstruction(const OpCode &Byte) : Instruction(Byte) {}
+
+  /// Load binary from file manager.
+  ///
+  /// Inheritted and overrided from Instruction.
+  /// Read the memory arguments: alignment and offset, and the lane index in
+  /// the load lane and store lane cases.
+  ///
+  /// \param Mgr the file manager reference.
+  /// \param Pool the arena of instruction nodes.
+  ///
+  /// \returns void when success, ErrMsg when failed.
+  Expect<void> loadBinary(FileMgr &Mgr, Arena &Pool) override;
+
+  /// Getters of memory align, offset, and lane index.
+  uint32_t getMemoryAlign() const { return Align; }
+  uint32_t getMemoryOffset() const { return Offset; }
+  uint8_t getLaneIndex() const { return Lane; }
+
+private:
+  /// \name Data of SIMD memory instruction: Alignment, offset, and lane.
+  /// @{
+  uint32_t Align = 0;
+  uint32_t Offset = 0;
+  uint8_t Lane = 0;
+  /// @}
+};
+
+/// Derived SIMD lane instruction node.
+class SIMDLaneInstruction : public Instruction {
+public:
+  /// Call base constructor to initialize OpCode.
+  SIMDLaneInstruction(const OpCode &Byte) : Instruction(Byte) {}
+
+  /// Load binary from file manager.
+  ///
+  /// Inheritted and overrided from Instruction.
+  /// Read the lane index.
+  ///
+  /// \param Mgr the file manager reference.
+  /// \param Pool the arena of instruction nodes.
+  ///
+  /// \returns void when success, ErrMsg when failed.
+  Expect<void> loadBinary(FileMgr &Mgr, Arena &Pool) override;
+
+  /// Getter of the lane index.
+  uint8_t getLaneIndex() const { return Lane; }
+
+private:
+  /// Extracted or replaced lane index.
+  uint8_t Lane = 0;
+};
+
+/// Derived SIMD shuffle instruction node.
+class SIMDShuffleInstruction : public Instruction {
+public:
+  /// Call base constructor to initialize OpCode.
+  SIMDShuffleInstruction(const OpCode &Byte) : Instruction(Byte) {}
+
+  /// Load binary from file manager.
+  ///
+  /// Inheritted and overrided from Instruction.
+  /// Read the 16 lane indices.
+  ///
+  /// \param Mgr the file manager reference.
+  /// \param Pool the arena of instruction nodes.
+  ///
+  /// \returns void when success, ErrMsg when failed.
+  Expect<void> loadBinary(FileMgr &Mgr, Arena &Pool) override;
+
+  /// Getter of the lane indices.
+  const std::array<uint8_t, 16> &getShuffleLanes() const { return Lanes; }
+
+private:
+  /// Lane indices into the concatenation of the two operands.
+  std::array<uint8_t, 16> Lanes = {};
+};
+
+/// Derived SIMD numeric instruction node.
+class SIMDNumericInstruction : public Instruction {
+public:
+  /// Call base constructor to initialize OpCode.
+  SIMDNumericInstruction(const OpCode &Byte) : Instruction(Byte) {}
+};
+
+/// Derived atomic memory instruction node.
+class AtomicMemoryInstruction : public Instruction {
+public:
+  /// Call base constructor to initialize OpCode.
+  AtomicMemoryInstruction(const OpCode &Byte) : Instruction(Byte) {}
+
+  /// Load binary from file manager.
+  ///
+  /// Inheritted and overrided from Instruction.
+  /// Read the memory arguments: alignment and offset, or the reserved byte in
+  /// the fence case.
+  ///
+  /// \param Mgr the file manager reference.
+  /// \param Pool the arena of instruction nodes.
+  ///
+  /// \returns void when success, ErrMsg when failed.
+  Expect<void> loadBinary(FileMgr &Mgr, Arena &Pool) override;
+
+  /// Getters of memory align and offset.
+  uint32_t getMemoryAlign() const { return Align; }
+  uint32_t getMemoryOffset() const { return Offset; }
+
+private:
+  /// \name Data of atomic memory instruction: Alignment and offset.
+  /// @{
+  uint32_t Align = 0;
+  uint32_t Offset = 0;
+  /// @}
 };
 
 template <typename T>
@@ -537,10 +1063,13 @@ auto dispatchInstruction(Instruction::OpCode Code, T &&Visitor) {
 
   case Instruction::OpCode::Call:
   case Instruction::OpCode::Call_indirect:
+  case Instruction::OpCode::Return_call:
+  case Instruction::OpCode::Return_call_indirect:
     return Visitor(Support::tag<CallControlInstruction>());
 
   case Instruction::OpCode::Drop:
   case Instruction::OpCode::Select:
+  case Instruction::OpCode::Select_t:
     return Visitor(Support::tag<ParametricInstruction>());
 
   case Instruction::OpCode::Local__get:
@@ -575,12 +1104,32 @@ auto dispatchInstruction(Instruction::OpCode Code, T &&Visitor) {
   case Instruction::OpCode::I64__store32:
   case Instruction::OpCode::Memory__size:
   case Instruction::OpCode::Memory__grow:
+  case Instruction::OpCode::Memory__init:
+  case Instruction::OpCode::Data__drop:
+  case Instruction::OpCode::Memory__copy:
+  case Instruction::OpCode::Memory__fill:
     return Visitor(Support::tag<MemoryInstruction>());
 
+  case Instruction::OpCode::Table__get:
+  case Instruction::OpCode::Table__set:
+  case Instruction::OpCode::Table__init:
+  case Instruction::OpCode::Elem__drop:
+  case Instruction::OpCode::Table__copy:
+  case Instruction::OpCode::Table__grow:
+  case Instruction::OpCode::Table__size:
+  case Instruction::OpCode::Table__fill:
+    return Visitor(Support::tag<TableInstruction>());
+
+  case Instruction::OpCode::Ref__null:
+  case Instruction::OpCode::Ref__is_null:
+  case Instruction::OpCode::Ref__func:
+    return Visitor(Support::tag<ReferenceInstruction>());
+
   case Instruction::OpCode::I32__const:
   case Instruction::OpCode::I64__const:
   case Instruction::OpCode::F32__const:
   case Instruction::OpCode::F64__const:
+  case Instruction::OpCode::V128__const:
     return Visitor(Support::tag<ConstInstruction>());
 
   case Instruction::OpCode::I32__eqz:
@@ -711,6 +1260,318 @@ auto dispatchInstruction(Instruction::OpCode Code, T &&Visitor) {
   case Instruction::OpCode::F64__copysign:
     return Visitor(Support::tag<BinaryNumericInstruction>());
 
+  case Instruction::OpCode::V128__load:
+  case Instruction::OpCode::V128__load8x8_s:
+  case Instruction::OpCode::V128__load8x8_u:
+  case Instruction::OpCode::V128__load16x4_s:
+  case Instruction::OpCode::V128__load16x4_u:
+  case Instruction::OpCode::V128__load32x2_s:
+  case Instruction::OpCode::V128__load32x2_u:
+  case Instruction::OpCode::V128__load8_splat:
+  case Instruction::OpCode::V128__load16_splat:
+  case Instruction::OpCode::V128__load32_splat:
+  case Instruction::OpCode::V128__load64_splat:
+  case Instruction::OpCode::V128__store:
+  case Instruction::OpCode::V128__load8_lane:
+  case Instruction::OpCode::V128__load16_lane:
+  case Instruction::OpCode::V128__load32_lane:
+  case Instruction::OpCode::V128__load64_lane:
+  case Instruction::OpCode::V128__store8_lane:
+  case Instruction::OpCode::V128__store16_lane:
+  case Instruction::OpCode::V128__store32_lane:
+  case Instruction::OpCode::V128__store64_lane:
+  case Instruction::OpCode::V128__load32_zero:
+  case Instruction::OpCode::V128__load64_zero:
+    return Visitor(Support::tag<SIMDMemoryInstruction>());
+
+  case Instruction::OpCode::I8x16__extract_lane_s:
+  case Instruction::OpCode::I8x16__extract_lane_u:
+  case Instruction::OpCode::I8x16__replace_lane:
+  case Instruction::OpCode::I16x8__extract_lane_s:
+  case Instruction::OpCode::I16x8__extract_lane_u:
+  case Instruction::OpCode::I16x8__replace_lane:
+  case Instruction::OpCode::I32x4__extract_lane:
+  case Instruction::OpCode::I32x4__replace_lane:
+  case Instruction::OpCode::I64x2__extract_lane:
+  case Instruction::OpCode::I64x2__replace_lane:
+  case Instruction::OpCode::F32x4__extract_lane:
+  case Instruction::OpCode::F32x4__replace_lane:
+  case Instruction::OpCode::F64x2__extract_lane:
+  case Instruction::OpCode::F64x2__replace_lane:
+    return Visitor(Support::tag<SIMDLaneInstruction>());
+
+  case Instruction::OpCode::I8x16__shuffle:
+    return Visitor(Support::tag<SIMDShuffleInstruction>());
+
+  case Instruction::OpCode::I8x16__swizzle:
+  case Instruction::OpCode::I8x16__splat:
+  case Instruction::OpCode::I16x8__splat:
+  case Instruction::OpCode::I32x4__splat:
+  case Instruction::OpCode::I64x2__splat:
+  case Instruction::OpCode::F32x4__splat:
+  case Instruction::OpCode::F64x2__splat:
+  case Instruction::OpCode::I8x16__eq:
+  case Instruction::OpCode::I8x16__ne:
+  case Instruction::OpCode::I8x16__lt_s:
+  case Instruction::OpCode::I8x16__lt_u:
+  case Instruction::OpCode::I8x16__gt_s:
+  case Instruction::OpCode::I8x16__gt_u:
+  case Instruction::OpCode::I8x16__le_s:
+  case Instruction::OpCode::I8x16__le_u:
+  case Instruction::OpCode::I8x16__ge_s:
+  case Instruction::OpCode::I8x16__ge_u:
+  case Instruction::OpCode::I16x8__eq:
+  case Instruction::OpCode::I16x8__ne:
+  case Instruction::OpCode::I16x8__lt_s:
+  case Instruction::OpCode::I16x8__lt_u:
+  case Instruction::OpCode::I16x8__gt_s:
+  case Instruction::OpCode::I16x8__gt_u:
+  case Instruction::OpCode::I16x8__le_s:
+  case Instruction::OpCode::I16x8__le_u:
+  case Instruction::OpCode::I16x8__ge_s:
+  case Instruction::OpCode::I16x8__ge_u:
+  case Instruction::OpCode::I32x4__eq:
+  case Instruction::OpCode::I32x4__ne:
+  case Instruction::OpCode::I32x4__lt_s:
+  case Instruction::OpCode::I32x4__lt_u:
+  case Instruction::OpCode::I32x4__gt_s:
+  case Instruction::OpCode::I32x4__gt_u:
+  case Instruction::OpCode::I32x4__le_s:
+  case Instruction::OpCode::I32x4__le_u:
+  case Instruction::OpCode::I32x4__ge_s:
+  case Instruction::OpCode::I32x4__ge_u:
+  case Instruction::OpCode::F32x4__eq:
+  case Instruction::OpCode::F32x4__ne:
+  case Instruction::OpCode::F32x4__lt:
+  case Instruction::OpCode::F32x4__gt:
+  case Instruction::OpCode::F32x4__le:
+  case Instruction::OpCode::F32x4__ge:
+  case Instruction::OpCode::F64x2__eq:
+  case Instruction::OpCode::F64x2__ne:
+  case Instruction::OpCode::F64x2__lt:
+  case Instruction::OpCode::F64x2__gt:
+  case Instruction::OpCode::F64x2__le:
+  case Instruction::OpCode::F64x2__ge:
+  case Instruction::OpCode::V128__not:
+  case Instruction::OpCode::V128__and:
+  case Instruction::OpCode::V128__andnot:
+  case Instruction::OpCode::V128__or:
+  case Instruction::OpCode::V128__xor:
+  case Instruction::OpCode::V128__bitselect:
+  case Instruction::OpCode::V128__any_true:
+  case Instruction::OpCode::F32x4__demote_f64x2_zero:
+  case Instruction::OpCode::F64x2__promote_low_f32x4:
+  case Instruction::OpCode::I8x16__abs:
+  case Instruction::OpCode::I8x16__neg:
+  case Instruction::OpCode::I8x16__popcnt:
+  case Instruction::OpCode::I8x16__all_true:
+  case Instruction::OpCode::I8x16__bitmask:
+  case Instruction::OpCode::I8x16__narrow_i16x8_s:
+  case Instruction::OpCode::I8x16__narrow_i16x8_u:
+  case Instruction::OpCode::F32x4__ceil:
+  case Instruction::OpCode::F32x4__floor:
+  case Instruction::OpCode::F32x4__trunc:
+  case Instruction::OpCode::F32x4__nearest:
+  case Instruction::OpCode::I8x16__shl:
+  case Instruction::OpCode::I8x16__shr_s:
+  case Instruction::OpCode::I8x16__shr_u:
+  case Instruction::OpCode::I8x16__add:
+  case Instruction::OpCode::I8x16__add_sat_s:
+  case Instruction::OpCode::I8x16__add_sat_u:
+  case Instruction::OpCode::I8x16__sub:
+  case Instruction::OpCode::I8x16__sub_sat_s:
+  case Instruction::OpCode::I8x16__sub_sat_u:
+  case Instruction::OpCode::F64x2__ceil:
+  case Instruction::OpCode::F64x2__floor:
+  case Instruction::OpCode::I8x16__min_s:
+  case Instruction::OpCode::I8x16__min_u:
+  case Instruction::OpCode::I8x16__max_s:
+  case Instruction::OpCode::I8x16__max_u:
+  case Instruction::OpCode::F64x2__trunc:
+  case Instruction::OpCode::I8x16__avgr_u:
+  case Instruction::OpCode::I16x8__extadd_pairwise_i8x16_s:
+  case Instruction::OpCode::I16x8__extadd_pairwise_i8x16_u:
+  case Instruction::OpCode::I32x4__extadd_pairwise_i16x8_s:
+  case Instruction::OpCode::I32x4__extadd_pairwise_i16x8_u:
+  case Instruction::OpCode::I16x8__abs:
+  case Instruction::OpCode::I16x8__neg:
+  case Instruction::OpCode::I16x8__q15mulr_sat_s:
+  case Instruction::OpCode::I16x8__all_true:
+  case Instruction::OpCode::I16x8__bitmask:
+  case Instruction::OpCode::I16x8__narrow_i32x4_s:
+  case Instruction::OpCode::I16x8__narrow_i32x4_u:
+  case Instruction::OpCode::I16x8__extend_low_i8x16_s:
+  case Instruction::OpCode::I16x8__extend_high_i8x16_s:
+  case Instruction::OpCode::I16x8__extend_low_i8x16_u:
+  case Instruction::OpCode::I16x8__extend_high_i8x16_u:
+  case Instruction::OpCode::I16x8__shl:
+  case Instruction::OpCode::I16x8__shr_s:
+  case Instruction::OpCode::I16x8__shr_u:
+  case Instruction::OpCode::I16x8__add:
+  case Instruction::OpCode::I16x8__add_sat_s:
+  case Instruction::OpCode::I16x8__add_sat_u:
+  case Instruction::OpCode::I16x8__sub:
+  case Instruction::OpCode::I16x8__sub_sat_s:
+  case Instruction::OpCode::I16x8__sub_sat_u:
+  case Instruction::OpCode::F64x2__nearest:
+  case Instruction::OpCode::I16x8__mul:
+  case Instruction::OpCode::I16x8__min_s:
+  case Instruction::OpCode::I16x8__min_u:
+  case Instruction::OpCode::I16x8__max_s:
+  case Instruction::OpCode::I16x8__max_u:
+  case Instruction::OpCode::I16x8__avgr_u:
+  case Instruction::OpCode::I16x8__extmul_low_i8x16_s:
+  case Instruction::OpCode::I16x8__extmul_high_i8x16_s:
+  case Instruction::OpCode::I16x8__extmul_low_i8x16_u:
+  case Instruction::OpCode::I16x8__extmul_high_i8x16_u:
+  case Instruction::OpCode::I32x4__abs:
+  case Instruction::OpCode::I32x4__neg:
+  case Instruction::OpCode::I32x4__all_true:
+  case Instruction::OpCode::I32x4__bitmask:
+  case Instruction::OpCode::I32x4__extend_low_i16x8_s:
+  case Instruction::OpCode::I32x4__extend_high_i16x8_s:
+  case Instruction::OpCode::I32x4__extend_low_i16x8_u:
+  case Instruction::OpCode::I32x4__extend_high_i16x8_u:
+  case Instruction::OpCode::I32x4__shl:
+  case Instruction::OpCode::I32x4__shr_s:
+  case Instruction::OpCode::I32x4__shr_u:
+  case Instruction::OpCode::I32x4__add:
+  case Instruction::OpCode::I32x4__sub:
+  case Instruction::OpCode::I32x4__mul:
+  case Instruction::OpCode::I32x4__min_s:
+  case Instruction::OpCode::I32x4__min_u:
+  case Instruction::OpCode::I32x4__max_s:
+  case Instruction::OpCode::I32x4__max_u:
+  case Instruction::OpCode::I32x4__dot_i16x8_s:
+  case Instruction::OpCode::I32x4__extmul_low_i16x8_s:
+  case Instruction::OpCode::I32x4__extmul_high_i16x8_s:
+  case Instruction::OpCode::I32x4__extmul_low_i16x8_u:
+  case Instruction::OpCode::I32x4__extmul_high_i16x8_u:
+  case Instruction::OpCode::I64x2__abs:
+  case Instruction::OpCode::I64x2__neg:
+  case Instruction::OpCode::I64x2__all_true:
+  case Instruction::OpCode::I64x2__bitmask:
+  case Instruction::OpCode::I64x2__extend_low_i32x4_s:
+  case Instruction::OpCode::I64x2__extend_high_i32x4_s:
+  case Instruction::OpCode::I64x2__extend_low_i32x4_u:
+  case Instruction::OpCode::I64x2__extend_high_i32x4_u:
+  case Instruction::OpCode::I64x2__shl:
+  case Instruction::OpCode::I64x2__shr_s:
+  case Instruction::OpCode::I64x2__shr_u:
+  case Instruction::OpCode::I64x2__add:
+  case Instruction::OpCode::I64x2__sub:
+  case Instruction::OpCode::I64x2__mul:
+  case Instruction::OpCode::I64x2__eq:
+  case Instruction::OpCode::I64x2__ne:
+  case Instruction::OpCode::I64x2__lt_s:
+  case Instruction::OpCode::I64x2__gt_s:
+  case Instruction::OpCode::I64x2__le_s:
+  case Instruction::OpCode::I64x2__ge_s:
+  case Instruction::OpCode::I64x2__extmul_low_i32x4_s:
+  case Instruction::OpCode::I64x2__extmul_high_i32x4_s:
+  case Instruction::OpCode::I64x2__extmul_low_i32x4_u:
+  case Instruction::OpCode::I64x2__extmul_high_i32x4_u:
+  case Instruction::OpCode::F32x4__abs:
+  case Instruction::OpCode::F32x4__neg:
+  case Instruction::OpCode::F32x4__sqrt:
+  case Instruction::OpCode::F32x4__add:
+  case Instruction::OpCode::F32x4__sub:
+  case Instruction::OpCode::F32x4__mul:
+  case Instruction::OpCode::F32x4__div:
+  case Instruction::OpCode::F32x4__min:
+  case Instruction::OpCode::F32x4__max:
+  case Instruction::OpCode::F32x4__pmin:
+  case Instruction::OpCode::F32x4__pmax:
+  case Instruction::OpCode::F64x2__abs:
+  case Instruction::OpCode::F64x2__neg:
+  case Instruction::OpCode::F64x2__sqrt:
+  case Instruction::OpCode::F64x2__add:
+  case Instruction::OpCode::F64x2__sub:
+  case Instruction::OpCode::F64x2__mul:
+  case Instruction::OpCode::F64x2__div:
+  case Instruction::OpCode::F64x2__min:
+  case Instruction::OpCode::F64x2__max:
+  case Instruction::OpCode::F64x2__pmin:
+  case Instruction::OpCode::F64x2__pmax:
+  case Instruction::OpCode::I32x4__trunc_sat_f32x4_s:
+  case Instruction::OpCode::I32x4__trunc_sat_f32x4_u:
+  case Instruction::OpCode::F32x4__convert_i32x4_s:
+  case Instruction::OpCode::F32x4__convert_i32x4_u:
+  case Instruction::OpCode::I32x4__trunc_sat_f64x2_s_zero:
+  case Instruction::OpCode::I32x4__trunc_sat_f64x2_u_zero:
+  case Instruction::OpCode::F64x2__convert_low_i32x4_s:
+  case Instruction::OpCode::F64x2__convert_low_i32x4_u:
+    return Visitor(Support::tag<SIMDNumericInstruction>());
+
+  case Instruction::OpCode::Memory__atomic__notify:
+  case Instruction::OpCode::Memory__atomic__wait32:
+  case Instruction::OpCode::Memory__atomic__wait64:
+  case Instruction::OpCode::Atomic__fence:
+  case Instruction::OpCode::I32__atomic__load:
+  case Instruction::OpCode::I64__atomic__load:
+  case Instruction::OpCode::I32__atomic__load8_u:
+  case Instruction::OpCode::I32__atomic__load16_u:
+  case Instruction::OpCode::I64__atomic__load8_u:
+  case Instruction::OpCode::I64__atomic__load16_u:
+  case Instruction::OpCode::I64__atomic__load32_u:
+  case Instruction::OpCode::I32__atomic__store:
+  case Instruction::OpCode::I64__atomic__store:
+  case Instruction::OpCode::I32__atomic__store8:
+  case Instruction::OpCode::I32__atomic__store16:
+  case Instruction::OpCode::I64__atomic__store8:
+  case Instruction::OpCode::I64__atomic__store16:
+  case Instruction::OpCode::I64__atomic__store32:
+  case Instruction::OpCode::I32__atomic__rmw__add:
+  case Instruction::OpCode::I64__atomic__rmw__add:
+  case Instruction::OpCode::I32__atomic__rmw8__add_u:
+  case Instruction::OpCode::I32__atomic__rmw16__add_u:
+  case Instruction::OpCode::I64__atomic__rmw8__add_u:
+  case Instruction::OpCode::I64__atomic__rmw16__add_u:
+  case Instruction::OpCode::I64__atomic__rmw32__add_u:
+  case Instruction::OpCode::I32__atomic__rmw__sub:
+  case Instruction::OpCode::I64__atomic__rmw__sub:
+  case Instruction::OpCode::I32__atomic__rmw8__sub_u:
+  case Instruction::OpCode::I32__atomic__rmw16__sub_u:
+  case Instruction::OpCode::I64__atomic__rmw8__sub_u:
+  case Instruction::OpCode::I64__atomic__rmw16__sub_u:
+  case Instruction::OpCode::I64__atomic__rmw32__sub_u:
+  case Instruction::OpCode::I32__atomic__rmw__and:
+  case Instruction::OpCode::I64__atomic__rmw__and:
+  case Instruction::OpCode::I32__atomic__rmw8__and_u:
+  case Instruction::OpCode::I32__atomic__rmw16__and_u:
+  case Instruction::OpCode::I64__atomic__rmw8__and_u:
+  case Instruction::OpCode::I64__atomic__rmw16__and_u:
+  case Instruction::OpCode::I64__atomic__rmw32__and_u:
+  case Instruction::OpCode::I32__atomic__rmw__or:
+  case Instruction::OpCode::I64__atomic__rmw__or:
+  case Instruction::OpCode::I32__atomic__rmw8__or_u:
+  case Instruction::OpCode::I32__atomic__rmw16__or_u:
+  case Instruction::OpCode::I64__atomic__rmw8__or_u:
+  case Instruction::OpCode::I64__atomic__rmw16__or_u:
+  case Instruction::OpCode::I64__atomic__rmw32__or_u:
+  case Instruction::OpCode::I32__atomic__rmw__xor:
+  case Instruction::OpCode::I64__atomic__rmw__xor:
+  case Instruction::OpCode::I32__atomic__rmw8__xor_u:
+  case Instruction::OpCode::I32__atomic__rmw16__xor_u:
+  case Instruction::OpCode::I64__atomic__rmw8__xor_u:
+  case Instruction::OpCode::I64__atomic__rmw16__xor_u:
+  case Instruction::OpCode::I64__atomic__rmw32__xor_u:
+  case Instruction::OpCode::I32__atomic__rmw__xchg:
+  case Instruction::OpCode::I64__atomic__rmw__xchg:
+  case Instruction::OpCode::I32__atomic__rmw8__xchg_u:
+  case Instruction::OpCode::I32__atomic__rmw16__xchg_u:
+  case Instruction::OpCode::I64__atomic__rmw8__xchg_u:
+  case Instruction::OpCode::I64__atomic__rmw16__xchg_u:
+  case Instruction::OpCode::I64__atomic__rmw32__xchg_u:
+  case Instruction::OpCode::I32__atomic__rmw__cmpxchg:
+  case Instruction::OpCode::I64__atomic__rmw__cmpxchg:
+  case Instruction::OpCode::I32__atomic__rmw8__cmpxchg_u:
+  case Instruction::OpCode::I32__atomic__rmw16__cmpxchg_u:
+  case Instruction::OpCode::I64__atomic__rmw8__cmpxchg_u:
+  case Instruction::OpCode::I64__atomic__rmw16__cmpxchg_u:
+  case Instruction::OpCode::I64__atomic__rmw32__cmpxchg_u:
+    return Visitor(Support::tag<AtomicMemoryInstruction>());
+
   default:
     return Visitor(Support::tag<void>());
   }
@@ -719,24 +1580,29 @@ auto dispatchInstruction(Instruction::OpCode Code, T &&Visitor) {
 /// Make the new instruction node.
 ///
 /// Select the node type corresponding to the input Code.
-/// Create the derived instruction class and return pointer.
+/// Create the derived instruction class in the arena and return pointer.
 ///
 /// \param Code the OpCode of instruction to make.
+/// \param Pool the arena of instruction nodes.
 ///
-/// \returns unique pointer of instruction node if success, ErrMsg when failed.
-Expect<std::unique_ptr<Instruction>>
-makeInstructionNode(const Instruction::OpCode &Code);
+/// \returns pointer of instruction node if success, ErrMsg when failed.
+Expect<Instruction *> makeInstructionNode(const Instruction::OpCode &Code,
+                                          Arena &Pool);
 
-/// Make the new instruction node from old one.
+/// Load the instruction sequence.
 ///
-/// Select the node type corresponding to the input Code.
-/// Create the duplicated instruction node and return pointer.
+/// Read and make Instruction nodes until the OpCode of End, or the OpCode of
+/// Else if it is allowed.
 ///
-/// \param Instr the instruction to duplicate.
+/// \param Mgr the file manager reference.
+/// \param Pool the arena of instruction nodes and the sequence.
+/// \param Seq the loaded instruction sequence.
+/// \param AllowElse true if the sequence can end with OpCode::Else.
 ///
-/// \returns unique pointer of instruction node if success, ErrMsg when failed.
-Expect<std::unique_ptr<Instruction>>
-makeInstructionNode(const Instruction &Instr);
+/// \returns OpCode which ends the sequence if success, ErrMsg when failed.
+Expect<Instruction::OpCode> loadInstrSeq(FileMgr &Mgr, Arena &Pool,
+                                         InstrVec &Seq,
+                                         const bool AllowElse = false);
 
 } // namespace AST
 } // namespace SSVM
@@ -40,6 +40,28 @@ public:
   /// \returns void when success, ErrMsg when failed.
   Expect<void> loadBinary(FileMgr &Mgr) override;
 
+  /// Load the Magic and Version sequences.
+  ///
+  /// \param Mgr the file manager reference.
+  ///
+  /// \returns void when success, ErrMsg when failed.
+  Expect<void> loadHeader(FileMgr &Mgr);
+
+  /// Load a section after its section ID.
+  ///
+  /// Create the Section node if not exists and read the content size and
+  /// content.
+  ///
+  /// \param Id the section ID.
+  /// \param Mgr the file manager reference.
+  ///
+  /// \returns void when success, ErrMsg when failed.
+  Expect<void> loadSection(const uint8_t Id, FileMgr &Mgr);
+
+  /// Get the code section, which is created if not exists. Used by streaming
+  /// loading to append code segments. See CodeSection::loadSegments().
+  CodeSection &initCodeSection();
+
   /// Load compiled function from loadable manager.
   Expect<void> loadCompiled(LDMgr &Mgr);
 
@@ -56,17 +78,73 @@ public:
   ElementSection *getElementSection() const { return ElementSec.get(); }
   CodeSection *getCodeSection() const { return CodeSec.get(); }
   DataSection *getDataSection() const { return DataSec.get(); }
+  DataCountSection *getDataCountSection() const { return DataCountSec.get(); }
 
   using TrapProxy = void (*)(Interpreter::Interpreter *, uint32_t);
   using CallProxy = void (*)(Interpreter::Interpreter *, const uint32_t,
                              const ValVariant *, ValVariant *);
   using MemGrowProxy = uint32_t (*)(Interpreter::Interpreter *, const uint32_t);
   using MemSizeProxy = uint32_t (*)(Interpreter::Interpreter *);
-  using Ctor = void (*)(TrapProxy, CallProxy, MemGrowProxy, MemSizeProxy);
+  using MemInitProxy = void (*)(Interpreter::Interpreter *, const uint32_t,
+                                const uint32_t, const uint32_t,
+                                const uint32_t);
+  using DataDropProxy = void (*)(Interpreter::Interpreter *, const uint32_t);
+  using TableSizeProxy = uint32_t (*)(Interpreter::Interpreter *,
+                                      const uint32_t);
+  using TableGrowProxy = uint32_t (*)(Interpreter::Interpreter *,
+                                      const uint32_t, const uint64_t,
+                                      const uint32_t);
+  using TableGetProxy = uint64_t (*)(Interpreter::Interpreter *,
+                                     const uint32_t, const uint32_t);
+  using TableSetProxy = void (*)(Interpreter::Interpreter *, const uint32_t,
+                                 const uint32_t, const uint64_t);
+  using TableFillProxy = void (*)(Interpreter::Interpreter *, const uint32_t,
+                                  const uint32_t, const uint64_t,
+                                  const uint32_t);
+  using TableInitProxy = void (*)(Interpreter::Interpreter *, const uint32_t,
+                                  const uint32_t, const uint32_t,
+                                  const uint32_t, const uint32_t);
+  using TableCopyProxy = void (*)(Interpreter::Interpreter *, const uint32_t,
+                                  const uint32_t, const uint32_t,
+                                  const uint32_t, const uint32_t);
+  using ElemDropProxy = void (*)(Interpreter::Interpreter *, const uint32_t);
+  using RefFuncProxy = uint64_t (*)(Interpreter::Interpreter *,
+                                    const uint32_t);
+  using TableGetFuncIdxProxy = uint32_t (*)(Interpreter::Interpreter *,
+                                            const uint32_t, const uint32_t,
+                                            const uint32_t);
+  using CallIndirectProxy = void (*)(Interpreter::Interpreter *,
+                                     const uint32_t, const uint32_t,
+                                     const uint32_t, const ValVariant *,
+                                     ValVariant *);
+  using MemAtomicNotifyProxy = uint32_t (*)(Interpreter::Interpreter *,
+                                            const uint64_t, const uint32_t);
+  using MemAtomicWaitProxy = uint32_t (*)(Interpreter::Interpreter *,
+                                          const uint64_t, const uint64_t,
+                                          const int64_t, const uint32_t);
+  using Ctor = void (*)(TrapProxy, CallProxy, MemGrowProxy, MemSizeProxy,
+                        MemInitProxy, DataDropProxy, MemAtomicNotifyProxy,
+                        MemAtomicWaitProxy, TableSizeProxy, TableGrowProxy,
+                        TableGetProxy, TableSetProxy, TableFillProxy,
+                        TableInitProxy, TableCopyProxy, ElemDropProxy,
+                        RefFuncProxy, TableGetFuncIdxProxy, CallIndirectProxy);
 
   Ctor getCtor() const { return CtorFunc; }
   void setCtor(Ctor F) { CtorFunc = F; }
 
+  /// Setter of lazy loading of function bodies. See CodeSection::setLazy().
+  void setLazyCode(const bool Lazy) { IsLazyCode = Lazy; }
+
+  /// Getter and setter of the module is loaded from a module cache, which was
+  /// validated when the cache was made. See "include/loader/cache.h".
+  bool isValidated() const { return IsValidated; }
+  void setValidated(const bool Validated) { IsValidated = Validated; }
+
+  /// Getter and setter of the binary kept to make module cache after
+  /// validation.
+  const SharedBytes &getSource() const { return Source; }
+  void setSource(SharedBytes Bin) { Source = std::move(Bin); }
+
 protected:
   /// The node type should be Attr::Module.
   Attr NodeAttr = Attr::Module;
@@ -92,9 +170,13 @@ private:
   std::unique_ptr<ElementSection> ElementSec;
   std::unique_ptr<CodeSection> CodeSec;
   std::unique_ptr<DataSection> DataSec;
+  std::unique_ptr<DataCountSection> DataCountSec;
   /// @}
 
   Ctor CtorFunc = nullptr;
+  bool IsLazyCode = false;
+  bool IsValidated = false;
+  SharedBytes Source;
 };
 
 } // namespace AST
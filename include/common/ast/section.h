@@ -93,8 +93,8 @@ protected:
   Attr NodeAttr = Attr::Sec_Custom;
 
 private:
-  /// Vector of raw bytes of content.
-  Bytes Content;
+  /// Raw bytes of content, which may refer to the mapped module file.
+  SharedBytes Content;
 };
 
 /// AST TypeSection node.
@@ -281,6 +281,23 @@ public:
     return Content;
   }
 
+  /// Setter of lazy loading. When set, only the raw bytes of function bodies
+  /// are kept in loading. See CodeSegment::deferBody().
+  void setLazy(const bool Lazy) { IsLazy = Lazy; }
+
+  /// Append code segments and parse their bodies.
+  ///
+  /// Used for both the content loading and the streaming loading, which hands
+  /// over the segments as soon as their bytes arrive.
+  ///
+  /// \param Segs the code segments whose sizes are loaded.
+  /// \param Bodies the raw bytes of the segments read by
+  /// CodeSegment::loadSize().
+  ///
+  /// \returns void when success, ErrMsg when failed.
+  Expect<void> loadSegments(std::vector<std::unique_ptr<CodeSegment>> Segs,
+                            std::vector<SharedBytes> Bodies);
+
 protected:
   /// Overrided content loading of code section.
   virtual Expect<void> loadContent(FileMgr &Mgr);
@@ -289,6 +306,11 @@ protected:
   Attr NodeAttr = Attr::Sec_Code;
 
 private:
+  /// Total size of function bodies above which they are parsed in parallel.
+  static inline constexpr size_t kParallelLoadSize = 64 * 1024;
+
+  bool IsLazy = false;
+
   /// Vector of CodeSegment nodes.
   std::vector<std::unique_ptr<CodeSegment>> Content;
 };
@@ -313,5 +335,23 @@ private:
   std::vector<std::unique_ptr<DataSegment>> Content;
 };
 
+/// AST DataCountSection node.
+class DataCountSection : public Section {
+public:
+  /// Getter of content.
+  uint32_t getContent() const { return Content; }
+
+protected:
+  /// Overrided content loading of data count section.
+  virtual Expect<void> loadContent(FileMgr &Mgr);
+
+  /// The node type should be Attr::Sec_DataCount.
+  Attr NodeAttr = Attr::Sec_DataCount;
+
+private:
+  /// Count of data segments.
+  uint32_t Content;
+};
+
 } // namespace AST
 } // namespace SSVM
@@ -17,11 +17,18 @@
 #include "instruction.h"
 #include "type.h"
 
+#include <functional>
 #include <memory>
 
 namespace SSVM {
 namespace AST {
 
+/// Mode of element and data segments. Active segments initialize the table or
+/// memory in instantiation, and passive segments are copied by the table.init
+/// and memory.init instructions. Declarative element segments only declare
+/// the functions they contain.
+enum class SegmentMode : uint8_t { Active, Passive, Declarative };
+
 /// Segment's base class.
 class Segment : public Base {
 public:
@@ -30,8 +37,11 @@ public:
     return Unexpect(ErrCode::InvalidGrammar);
   };
 
-  /// Getter of locals vector.
-  InstrVec &getInstrs() const { return Expr->getInstrs(); }
+  /// Getter of instructions vector.
+  const InstrVec &getInstrs() const { return Expr->getInstrs(); }
+
+  /// Getter of the arena which stores the instruction nodes.
+  std::shared_ptr<const Arena> getArena() const { return Expr->getArena(); }
 
 protected:
   /// Load binary from file manager.
@@ -80,19 +90,32 @@ public:
   /// Load binary from file manager.
   ///
   /// Inheritted and overrided from Base.
-  /// Read the table index, expression, and function indices.
+  /// Read the segment flags, the table index and offset expression of active
+  /// segments, the reference type, and function indices or element
+  /// expressions.
   ///
   /// \param Mgr the file manager reference.
   ///
   /// \returns void when success, ErrMsg when failed.
   Expect<void> loadBinary(FileMgr &Mgr) override;
 
+  /// Getter of segment mode.
+  SegmentMode getMode() const { return Mode; }
+
   /// Getter of table index.
   uint32_t getIdx() const { return TableIdx; }
 
-  /// Getter of function indices.
+  /// Getter of reference type of elements.
+  ElemType getRefType() const { return RefType; }
+
+  /// Getter of function indices. Empty when the segment has expressions.
   const std::vector<uint32_t> &getFuncIdxes() const { return FuncIdxes; }
 
+  /// Getter of element expressions. Empty when the segment has indices.
+  const std::vector<std::unique_ptr<Expression>> &getInitExprs() const {
+    return InitExprs;
+  }
+
 protected:
   /// The node type should be Attr::Seg_Element.
   Attr NodeAttr = Attr::Seg_Element;
@@ -100,8 +123,11 @@ protected:
 private:
   /// \name Data of ElementSegment node.
   /// @{
+  SegmentMode Mode = SegmentMode::Active;
   uint32_t TableIdx = 0;
+  ElemType RefType = ElemType::FuncRef;
   std::vector<uint32_t> FuncIdxes;
+  std::vector<std::unique_ptr<Expression>> InitExprs;
   /// @}
 };
 
@@ -118,6 +144,36 @@ public:
   /// \returns void when success, ErrMsg when failed.
   Expect<void> loadBinary(FileMgr &Mgr) override;
 
+  /// Read the segment size and the raw bytes of locals and function body.
+  ///
+  /// \param Mgr the file manager reference.
+  ///
+  /// \returns raw bytes when success, ErrMsg when failed.
+  Expect<SharedBytes> loadSize(FileMgr &Mgr);
+
+  /// Parse the locals and function body from the raw bytes read by
+  /// loadSize(). Independent segments can be parsed concurrently.
+  ///
+  /// \param Body the raw bytes of this segment.
+  ///
+  /// \returns void when success, ErrMsg when failed.
+  Expect<void> loadBody(SharedBytes Body);
+
+  /// Keep the raw bytes read by loadSize() undecoded for lazy loading. The
+  /// locals and instructions are not available until loadBody() is called.
+  ///
+  /// \param Body the raw bytes of this segment.
+  void deferBody(SharedBytes Body) {
+    Deferred = std::move(Body);
+    IsLoaded = false;
+  }
+
+  /// Getter of checking locals and function body are decoded.
+  bool isLoaded() const { return IsLoaded; }
+
+  /// Getter of the undecoded raw bytes in lazy loading.
+  const SharedBytes &getDeferredBody() const { return Deferred; }
+
   /// Getter of locals vector.
   const std::vector<std::pair<uint32_t, ValType>> &getLocals() const {
     return Locals;
@@ -132,27 +188,40 @@ private:
   /// @{
   uint32_t SegSize = 0;
   std::vector<std::pair<uint32_t, ValType>> Locals;
+  bool IsLoaded = true;
+  SharedBytes Deferred;
   /// @}
 };
 
+/// Validation of a code segment decoded after the module validation, which
+/// takes the segment and the type index of the function.
+using CodeValidator =
+    std::function<Expect<void>(const CodeSegment &, const uint32_t)>;
+
 /// AST DataSegment node.
 class DataSegment : public Segment {
 public:
   /// Load binary from file manager.
   ///
   /// Inheritted and overrided from Base.
-  /// Read the memory index, offset expression, and initialization data.
+  /// Read the segment flags, and the memory index and offset expression of
+  /// active segments, and initialization data.
   ///
   /// \param Mgr the file manager reference.
   ///
   /// \returns void when success, ErrMsg when failed.
   Expect<void> loadBinary(FileMgr &Mgr) override;
 
+  /// Getter of segment mode.
+  SegmentMode getMode() const { return Mode; }
+
   /// Getter of memory index.
   uint32_t getIdx() const { return MemoryIdx; }
 
   /// Getter of data.
-  const Bytes &getData() const { return Data; }
+  Span<const Byte> getData() const { return Data.getSpan(); }
+  /// Getter of data which shares the ownership of the loaded buffer.
+  const SharedBytes &getSharedData() const { return Data; }
 
 protected:
   /// The node type should be Attr::Seg_Data.
@@ -161,8 +230,9 @@ protected:
 private:
   /// \name Data of DataSegment node.
   /// @{
+  SegmentMode Mode = SegmentMode::Active;
   uint32_t MemoryIdx = 0;
-  Bytes Data;
+  SharedBytes Data;
   /// @}
 };
 
@@ -69,7 +69,10 @@ enum class ErrCode : uint8_t {
   UninitializedElement = 0x48, /// Uninitialized element in table instance
   UndefinedElement = 0x49,     /// Access undefined element in table instances
   IndirectCallTypeMismatch = 0x4A, /// Func type mismatch in call_indirect
-  ExecutionFailed = 0x4B           /// Host function execution failed
+  ExecutionFailed = 0x4B,          /// Host function execution failed
+  TableOutOfBounds = 0x4C,         /// Out of bounds table access
+  UnalignedAtomicAccess = 0x4D,    /// Unaligned address of atomic access
+  ExpectSharedMemory = 0x4E        /// Wait on unshared memory
 };
 
 /// Error code enumeration string mapping.
@@ -102,7 +105,10 @@ static std::map<ErrCode, std::string> ErrCodeStr = {
     {ErrCode::UninitializedElement, "uninitialized element"},
     {ErrCode::UndefinedElement, "undefined element"},
     {ErrCode::IndirectCallTypeMismatch, "indirect call type mismatch"},
-    {ErrCode::ExecutionFailed, "host function failed"}};
+    {ErrCode::ExecutionFailed, "host function failed"},
+    {ErrCode::TableOutOfBounds, "out of bounds table access"},
+    {ErrCode::UnalignedAtomicAccess, "unaligned atomic"},
+    {ErrCode::ExpectSharedMemory, "expected shared memory"}};
 
 static inline WasmPhase getErrCodePhase(ErrCode Code) {
   return static_cast<WasmPhase>((static_cast<uint8_t>(Code) & 0xF0) >> 4);
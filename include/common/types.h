@@ -11,7 +11,9 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <variant>
 
 namespace SSVM {
 
@@ -21,11 +23,39 @@ enum class ValType : uint8_t {
   I32 = 0x7F,
   I64 = 0x7E,
   F32 = 0x7D,
-  F64 = 0x7C
+  F64 = 0x7C,
+  V128 = 0x7B,
+  FuncRef = 0x70,
+  ExternRef = 0x6F
 };
 
-/// Element types enumeration class.
-enum class ElemType : uint8_t { Func = 0x60, FuncRef = 0x70 };
+/// Return true if the value type is a reference type.
+inline constexpr bool isRefType(const ValType Type) noexcept {
+  return Type == ValType::FuncRef || Type == ValType::ExternRef;
+}
+
+/// Block type, which is a value type or an index of function types.
+using BlockType = std::variant<ValType, uint32_t>;
+
+/// 128-bit integer types, which hold the bits of v128 values.
+using uint128_t = unsigned __int128;
+using int128_t = __int128;
+
+/// Vector types of v128 values, which the compiler maps to the SSE or NEON
+/// registers. SIMDArray<T, N> is the vector of T with the total size N bytes.
+template <typename T, size_t N> struct SIMDArrayType {
+  using type [[gnu::vector_size(N)]] = T;
+};
+template <typename T, size_t N = 16>
+using SIMDArray = typename SIMDArrayType<T, N>::type;
+
+/// Element types enumeration class. The reference types of tables and element
+/// segments share the encodings of the value types.
+enum class ElemType : uint8_t {
+  Func = 0x60,
+  FuncRef = 0x70,
+  ExternRef = 0x6F
+};
 
 /// Value mutability enumeration class.
 enum class ValMut : uint8_t { Const = 0x00, Var = 0x01 };
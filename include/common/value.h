@@ -20,7 +20,29 @@
 
 namespace SSVM {
 
-using ValVariant = Support::Variant<uint32_t, uint64_t, float, double>;
+/// Reference values. A reference is 64 bits wide and all bits are zero for
+/// the null reference, so that any reference can be checked through
+/// UnknownRef. A function reference holds the function address in the store.
+struct UnknownRef {
+  static constexpr bool IsRef = true;
+  uint64_t Value = 0;
+};
+struct FuncRef {
+  static constexpr bool IsRef = true;
+  uint32_t NotNull = 0;
+  uint32_t Idx = 0;
+};
+struct ExternRef {
+  static constexpr bool IsRef = true;
+  void *Ptr = nullptr;
+};
+static_assert(sizeof(FuncRef) == sizeof(UnknownRef) &&
+                  sizeof(ExternRef) == sizeof(UnknownRef),
+              "references must have the same size");
+
+using ValVariant =
+    Support::Variant<uint32_t, uint64_t, float, double, uint128_t, UnknownRef,
+                     FuncRef, ExternRef>;
 using Byte = uint8_t;
 using Bytes = std::vector<Byte>;
 
@@ -44,6 +66,15 @@ template <> inline ValType ValTypeFromType<float>() noexcept {
 template <> inline ValType ValTypeFromType<double>() noexcept {
   return ValType::F64;
 }
+template <> inline ValType ValTypeFromType<uint128_t>() noexcept {
+  return ValType::V128;
+}
+template <> inline ValType ValTypeFromType<FuncRef>() noexcept {
+  return ValType::FuncRef;
+}
+template <> inline ValType ValTypeFromType<ExternRef>() noexcept {
+  return ValType::ExternRef;
+}
 
 inline constexpr ValVariant ValueFromType(ValType Type) noexcept {
   switch (Type) {
@@ -56,6 +87,11 @@ inline constexpr ValVariant ValueFromType(ValType Type) noexcept {
     return float(0.0F);
   case ValType::F64:
     return double(0.0);
+  case ValType::V128:
+    return uint128_t(0U);
+  case ValType::FuncRef:
+  case ValType::ExternRef:
+    return UnknownRef();
   }
 }
 
@@ -76,4 +112,22 @@ template <typename T> inline T &&retrieveValue(ValVariant &&Val) {
       *reinterpret_cast<T *>(&std::get<Support::TypeToWasmTypeT<T>>(Val)));
 }
 
+/// Reference helpers.
+inline constexpr ValVariant genNullRef() noexcept { return UnknownRef(); }
+inline constexpr ValVariant genFuncRef(const uint32_t FuncAddr) noexcept {
+  return FuncRef{1U, FuncAddr};
+}
+template <typename T> inline ValVariant genExternRef(T *Ptr) noexcept {
+  return ExternRef{reinterpret_cast<void *>(Ptr)};
+}
+inline bool isNullRef(const ValVariant &Val) noexcept {
+  return retrieveValue<UnknownRef>(Val).Value == 0;
+}
+inline uint32_t retrieveFuncAddr(const ValVariant &Val) noexcept {
+  return retrieveValue<FuncRef>(Val).Idx;
+}
+template <typename T> inline T *retrieveExternRef(const ValVariant &Val) {
+  return reinterpret_cast<T *>(retrieveValue<ExternRef>(Val).Ptr);
+}
+
 } // namespace SSVM
\ No newline at end of file
@@ -0,0 +1,66 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <sys/epoll.h>
+#include <vector>
+
+namespace SSVM {
+namespace Host {
+
+/// Persistent epoll instance for poll_oneoff.
+///
+/// The interest of a file descriptor is registered at its first poll, and
+/// only updated when the polled events change, so that a guest polling the
+/// same descriptors in a loop costs no epoll_ctl calls. One timerfd on
+/// CLOCK_MONOTONIC wakes the wait at the nearest clock deadline.
+class EventPoll {
+public:
+  EventPoll() noexcept;
+  ~EventPoll() noexcept;
+  EventPoll(const EventPoll &) = delete;
+  EventPoll &operator=(const EventPoll &) = delete;
+
+  /// Getter of availability.
+  bool isAvailable() const noexcept { return EPollFd >= 0 && TimerFd >= 0; }
+
+  /// Getter of the mutex for waiting. Only one thread waits on the instance
+  /// at a time.
+  std::mutex &getMutex() noexcept { return WaitMutex; }
+
+  /// Start a new poll. The descriptors which are not watched in this poll
+  /// are quieted when they report events.
+  void beginPoll() noexcept { ++Generation; }
+
+  /// Watch the events of the file descriptor in this poll. Returns false and
+  /// sets errno if failed.
+  bool watch(int Fd, uint32_t Events) noexcept;
+
+  /// Drop the registration of the file descriptor, before it is closed or
+  /// replaced.
+  void forget(int Fd) noexcept;
+
+  /// Wait for the watched events. Deadline is the absolute time on
+  /// CLOCK_MONOTONIC in nanoseconds, or negative for no deadline. Returns
+  /// false and sets errno if failed.
+  bool wait(int64_t Deadline, int64_t Now,
+            std::vector<epoll_event> &Events) noexcept;
+
+private:
+  bool armTimer(int64_t Deadline) noexcept;
+
+  int EPollFd = -1;
+  int TimerFd = -1;
+  int64_t ArmedDeadline = -1;
+  uint64_t Generation = 0;
+  /// Registered interests and the last polls, indexed by file descriptors.
+  std::vector<uint32_t> Interests;
+  std::vector<uint32_t> Wanted;
+  std::vector<uint64_t> WantedGeneration;
+  std::mutex InterestMutex;
+  std::mutex WaitMutex;
+};
+
+} // namespace Host
+} // namespace SSVM
@@ -0,0 +1,82 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <sys/uio.h>
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace SSVM {
+namespace Host {
+
+/// Minimal io_uring engine for WASI file I/O.
+///
+/// The guest linear memory is registered as a fixed buffer, so that the
+/// iovecs which lie in it are submitted as a linked batch of fixed-buffer
+/// operations and served without mapping the pages on every request. The
+/// engine waits for the completions of a batch before returning, and falls
+/// back to the plain system calls when the kernel refuses to set up a ring.
+class IOUring {
+public:
+  IOUring(uint32_t Entries = 64) noexcept;
+  ~IOUring() noexcept;
+  IOUring(const IOUring &) = delete;
+  IOUring &operator=(const IOUring &) = delete;
+
+  /// Getter of ring availability.
+  bool isAvailable() const noexcept { return RingFd >= 0; }
+
+  /// Read into the iovecs. A negative offset reads from the file position.
+  ///
+  /// \param Memory the base of the guest linear memory.
+  /// \param MemorySize the byte size of the guest linear memory.
+  ///
+  /// \returns the read bytes, or the negated errno when failed.
+  int64_t readv(int Fd, const iovec *IOVS, uint32_t Count, int64_t Offset,
+                uint8_t *Memory, size_t MemorySize) noexcept;
+
+  /// Write from the iovecs. A negative offset writes to the file position.
+  ///
+  /// \returns the written bytes, or the negated errno when failed.
+  int64_t writev(int Fd, const iovec *IOVS, uint32_t Count, int64_t Offset,
+                 uint8_t *Memory, size_t MemorySize) noexcept;
+
+private:
+  int64_t transfer(bool IsWrite, int Fd, const iovec *IOVS, uint32_t Count,
+                   int64_t Offset, uint8_t *Memory, size_t MemorySize) noexcept;
+  /// Register the linear memory as the fixed buffer 0 if it moved or grew.
+  bool registerMemory(uint8_t *Memory, size_t MemorySize) noexcept;
+  io_uring_sqe *getSqe() noexcept;
+  int64_t submitAndWait(uint32_t Count, int64_t *Results) noexcept;
+
+  int RingFd = -1;
+  uint32_t Entries = 0;
+  void *SQRing = nullptr;
+  size_t SQRingSize = 0;
+  void *CQRing = nullptr;
+  size_t CQRingSize = 0;
+  io_uring_sqe *SQEs = nullptr;
+  size_t SQEsSize = 0;
+
+  uint32_t *SQHead = nullptr;
+  uint32_t *SQTail = nullptr;
+  uint32_t SQMask = 0;
+  uint32_t *SQArray = nullptr;
+  uint32_t *CQHead = nullptr;
+  uint32_t *CQTail = nullptr;
+  uint32_t CQMask = 0;
+  io_uring_cqe *CQEs = nullptr;
+
+  uint8_t *RegisteredBase = nullptr;
+  size_t RegisteredSize = 0;
+  bool CanRegister = true;
+
+  /// Threads of a guest share one ring.
+  std::mutex Mutex;
+};
+
+} // namespace Host
+} // namespace SSVM
@@ -0,0 +1,58 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+namespace SSVM {
+namespace Host {
+
+/// ChaCha20 keystream generator for random_get.
+///
+/// The key is seeded from the system entropy, and replaced by the head of
+/// the keystream after every request, so that the output can not be
+/// recovered from a later state. A fresh key is taken from the system after
+/// the reseed interval, and in the child process after fork.
+class RandomGenerator {
+public:
+  /// Default bytes generated between two reseeds.
+  static inline constexpr const uint64_t kDefaultReseedInterval = 1 << 20;
+
+  RandomGenerator() noexcept;
+  ~RandomGenerator() noexcept;
+  RandomGenerator(const RandomGenerator &) = delete;
+  RandomGenerator &operator=(const RandomGenerator &) = delete;
+
+  /// Setter of the reseed interval in bytes. Zero reseeds at every request.
+  void setReseedInterval(uint64_t Bytes) noexcept;
+  /// Getter of the reseed interval in bytes.
+  uint64_t getReseedInterval() noexcept;
+
+  /// Fill the buffer with random bytes. Returns false and sets errno if the
+  /// system entropy is not available.
+  bool generate(uint8_t *Buf, size_t Len) noexcept;
+
+  /// Produce the ChaCha20 block of the key, the 64-bit block counter, and
+  /// the 64-bit nonce.
+  static void block(const std::array<uint32_t, 8> &BlockKey,
+                    uint64_t BlockCounter, uint64_t Nonce,
+                    uint8_t *Out) noexcept;
+
+private:
+  bool reseed() noexcept;
+  /// Produce the next keystream block.
+  void nextBlock(uint8_t *Out) noexcept;
+
+  std::array<uint32_t, 8> Key = {};
+  uint64_t Counter = 0;
+  uint64_t Generated = 0;
+  uint64_t ReseedInterval = kDefaultReseedInterval;
+  uint64_t ForkGeneration = 0;
+  bool Seeded = false;
+  std::mutex Mutex;
+};
+
+} // namespace Host
+} // namespace SSVM
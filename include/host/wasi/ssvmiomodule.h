@@ -0,0 +1,18 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "runtime/importobj.h"
+#include "wasienv.h"
+
+namespace SSVM {
+namespace Host {
+
+/// Non-standard I/O extensions on the file descriptors of a WASI
+/// environment.
+class SSVMIOModule : public Runtime::ImportObject {
+public:
+  SSVMIOModule(WasiEnvironment &Env);
+};
+
+} // namespace Host
+} // namespace SSVM
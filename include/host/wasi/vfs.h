@@ -0,0 +1,149 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "wasi/core.h"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <sys/uio.h>
+#include <utility>
+#include <vector>
+
+namespace SSVM {
+namespace Host {
+
+/// Node of a virtual filesystem which backs a preopened directory.
+///
+/// The files of the preopened directories live in the host filesystem by
+/// default, and the WASI functions call the system calls on them. A directory
+/// preopened with a virtual root serves its whole subtree through this
+/// interface instead.
+class VFSNode {
+public:
+  virtual ~VFSNode() noexcept = default;
+
+  /// Getter of the file type.
+  virtual __wasi_filetype_t getType() const noexcept = 0;
+  /// Fill the file status.
+  virtual void stat(__wasi_filestat_t &Stat) const noexcept = 0;
+
+  /// Read into the iovecs from the offset of a regular file.
+  virtual __wasi_errno_t read(const iovec *IOVS, int Count, uint64_t Offset,
+                              uint64_t &NRead) noexcept = 0;
+  /// Write the iovecs at the offset of a regular file.
+  virtual __wasi_errno_t write(const iovec *IOVS, int Count, uint64_t Offset,
+                               uint64_t &NWritten) noexcept = 0;
+  /// Resize a regular file.
+  virtual __wasi_errno_t truncate(uint64_t Size) noexcept = 0;
+
+  /// Find the entry of a directory.
+  virtual __wasi_errno_t lookup(std::string_view Name,
+                                std::shared_ptr<VFSNode> &Node) noexcept = 0;
+  /// Create a regular file or a directory entry.
+  virtual __wasi_errno_t create(std::string_view Name, __wasi_filetype_t Type,
+                                std::shared_ptr<VFSNode> &Node) noexcept = 0;
+  /// Remove a directory entry. Directory selects rmdir or unlink.
+  virtual __wasi_errno_t remove(std::string_view Name,
+                                bool Directory) noexcept = 0;
+  /// Move a directory entry into the directory NewDir.
+  virtual __wasi_errno_t rename(std::string_view Name, VFSNode &NewDir,
+                                std::string_view NewName) noexcept = 0;
+  /// List the directory entries in a stable order.
+  virtual __wasi_errno_t
+  list(std::vector<std::pair<std::string, std::shared_ptr<VFSNode>>>
+           &Entries) noexcept = 0;
+};
+
+/// Resolve the path relative to the directory. The path can not escape the
+/// directory.
+__wasi_errno_t resolvePath(std::shared_ptr<VFSNode> Dir, std::string_view Path,
+                           std::shared_ptr<VFSNode> &Node);
+/// Resolve the parent directory of the path, and the name of the last
+/// component.
+__wasi_errno_t resolveParent(std::shared_ptr<VFSNode> Dir,
+                             std::string_view Path,
+                             std::shared_ptr<VFSNode> &Parent,
+                             std::string &Name);
+
+/// Node of the tmpfs-like in-memory filesystem.
+///
+/// A node created from an image node is a copy-on-write overlay of it. The
+/// file content is shared until the first modification, and the directory
+/// entries are copied as overlays at the first access.
+class MemoryNode final : public VFSNode {
+public:
+  MemoryNode(__wasi_filetype_t Type);
+  MemoryNode(std::shared_ptr<const MemoryNode> Lower);
+
+  __wasi_filetype_t getType() const noexcept override { return Type; }
+  void stat(__wasi_filestat_t &Stat) const noexcept override;
+  __wasi_errno_t read(const iovec *IOVS, int Count, uint64_t Offset,
+                      uint64_t &NRead) noexcept override;
+  __wasi_errno_t write(const iovec *IOVS, int Count, uint64_t Offset,
+                       uint64_t &NWritten) noexcept override;
+  __wasi_errno_t truncate(uint64_t Size) noexcept override;
+  __wasi_errno_t lookup(std::string_view Name,
+                        std::shared_ptr<VFSNode> &Node) noexcept override;
+  __wasi_errno_t create(std::string_view Name, __wasi_filetype_t Type,
+                        std::shared_ptr<VFSNode> &Node) noexcept override;
+  __wasi_errno_t remove(std::string_view Name,
+                        bool Directory) noexcept override;
+  __wasi_errno_t rename(std::string_view Name, VFSNode &NewDir,
+                        std::string_view NewName) noexcept override;
+  __wasi_errno_t
+  list(std::vector<std::pair<std::string, std::shared_ptr<VFSNode>>> &Entries)
+      noexcept override;
+
+private:
+  friend class MemoryImage;
+
+  /// Copy the entries of the lower directory as overlays. Returns ENOMEM if
+  /// failed, and the remaining entries are copied in the next call.
+  __wasi_errno_t materialize() noexcept;
+  /// Check whether the node is this directory or in its subtree.
+  bool contains(const MemoryNode &Node) const noexcept;
+  /// Make the content private before modifying it.
+  std::vector<uint8_t> &getMutableContent();
+  void touch() noexcept;
+
+  __wasi_filetype_t Type;
+  uint64_t Ino;
+  __wasi_timestamp_t ATim, MTim, CTim;
+  std::shared_ptr<std::vector<uint8_t>> Content;
+  bool SharedContent = false;
+  std::map<std::string, std::shared_ptr<MemoryNode>, std::less<>> Children;
+  std::shared_ptr<const MemoryNode> Lower;
+};
+
+/// Pre-populated read-only image of the in-memory filesystem.
+///
+/// Populate the image first, and then share it as const. Every mount is a
+/// private copy-on-write view of it, so instances never see the writes of
+/// each other.
+class MemoryImage {
+public:
+  MemoryImage();
+
+  /// Add a directory, and the parent directories as needed.
+  bool addDirectory(std::string_view Path);
+  /// Add a regular file, and the parent directories as needed.
+  bool addFile(std::string_view Path, std::vector<uint8_t> Content);
+  /// Copy the directories and the regular files under the host directory
+  /// into the directory Path. Symbolic links and other file types are
+  /// skipped.
+  bool addHostDirectory(std::string_view Path, const std::string &HostPath);
+
+  /// Create a writable view of the image for preopening.
+  std::shared_ptr<VFSNode> mount() const;
+
+private:
+  std::shared_ptr<MemoryNode> getDirectory(std::string_view Path);
+
+  std::shared_ptr<MemoryNode> Root;
+};
+
+} // namespace Host
+} // namespace SSVM
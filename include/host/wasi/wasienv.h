@@ -1,16 +1,26 @@
 // SPDX-License-Identifier: Apache-2.0
 #pragma once
 
+#include "host/wasi/eventpoll.h"
+#include "host/wasi/random.h"
+#include "host/wasi/vfs.h"
 #include "wasi/core.h"
 
-#include <algorithm>
+#ifdef SSVM_WASI_IO_URING
+#include "host/wasi/iouring.h"
+#endif
+
+#include <atomic>
 #include <mutex>
+#include <shared_mutex>
 #include <boost/align/aligned_allocator.hpp>
 #include <dirent.h>
 #include <fcntl.h>
+#include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <sys/uio.h>
 #include <unistd.h>
 #include <vector>
 
@@ -34,6 +44,11 @@ public:
     __wasi_rights_t InheritingRights;
     std::string Path;
     std::optional<DirFdStat> Dir;
+    /// Node of the virtual file, or null for a host file.
+    std::shared_ptr<VFSNode> Node;
+    /// File position and flags of the virtual file.
+    uint64_t Offset = 0;
+    bool Append = false;
 
     File(__wasi_fd_t F, __wasi_rights_t R, __wasi_rights_t IR,
          std::string_view P)
@@ -44,6 +59,17 @@ public:
              (InheritingRights & RequiredInheritingRights) ==
                  RequiredInheritingRights;
     }
+    bool isVirtual() const noexcept { return Node != nullptr; }
+  };
+
+  /// Policies of the host-side write combining buffer.
+  enum class WriteBufferMode : uint8_t {
+    /// Every fd_write is written through.
+    None,
+    /// The buffer is flushed when a newline is written.
+    Line,
+    /// The buffer is flushed when it reaches the capacity.
+    Full
   };
 
   WasiEnvironment();
@@ -56,24 +82,129 @@ public:
   int getExitCode() const { return ExitCode; }
   void setExitCode(int ExitCode) { this->ExitCode = ExitCode; }
 
-  template <typename... Args> void emplaceFile(Args &&... args) {
-    FileArray.emplace_back(std::forward<Args>(args)...);
+  /// The file table is indexed by file descriptors. The host allocates the
+  /// lowest free descriptor, so the freed slots are reused. The table is
+  /// shared by the guest threads, so the slots are guarded by FileTableMutex.
+  /// The entries are shared, so an entry closed by one thread stays alive
+  /// until the others holding it are done.
+  template <typename... Args>
+  std::shared_ptr<File> emplaceFile(__wasi_fd_t Fd, Args &&... args) {
+    auto Entry = std::make_shared<File>(Fd, std::forward<Args>(args)...);
+    std::unique_lock Lock(FileTableMutex);
+    if (Fd >= FileTable.size()) {
+      FileTable.resize(Fd + 1);
+    }
+    FileTable[Fd] = Entry;
+    return Entry;
   }
-  std::vector<File>::iterator getFile(uint32_t Fd) noexcept {
-    return std::find_if(FileArray.begin(), FileArray.end(),
-                        [Fd](const File &File) { return File.Fd == Fd; });
+  /// Get the file entry. The pending buffered writes of the file are flushed
+  /// first, so that any other operation on it observes them. Reading stdin
+  /// flushes too, for the prompts to show up.
+  std::shared_ptr<File> getFile(uint32_t Fd) noexcept {
+    if (const int64_t Pending = BufferFd.load(std::memory_order_relaxed);
+        Pending >= 0 && (Pending == Fd || Fd == STDIN_FILENO)) {
+      flushWriteBuffer();
+    }
+    return getFileForWrite(Fd);
   }
-  std::vector<File>::iterator getFileEnd() noexcept { return FileArray.end(); }
-  void eraseFile(std::vector<File>::iterator File) noexcept {
-    FileArray.erase(File);
+  /// Get the file entry without flushing, for fd_write to append more.
+  std::shared_ptr<File> getFileForWrite(uint32_t Fd) noexcept {
+    std::shared_lock Lock(FileTableMutex);
+    return Fd < FileTable.size() ? FileTable[Fd] : nullptr;
+  }
+  void eraseFile(__wasi_fd_t Fd) noexcept {
+    std::shared_ptr<File> Entry;
+    {
+      std::unique_lock Lock(FileTableMutex);
+      Entry = std::move(FileTable[Fd]);
+    }
+  }
+  void renumberFile(__wasi_fd_t Fd, __wasi_fd_t ToFd) noexcept {
+    std::unique_lock Lock(FileTableMutex);
+    FileTable[ToFd] = std::move(FileTable[Fd]);
+    FileTable[ToFd]->Fd = ToFd;
+  }
+#ifdef SSVM_WASI_IO_URING
+  IOUring &getIOUring() noexcept { return Ring; }
+#endif
+  EventPoll &getEventPoll() noexcept { return Poll; }
+  RandomGenerator &getRandom() noexcept { return Random; }
+
+  /// Preopen the root of a virtual filesystem as the directory Path, e.g. a
+  /// mount of a MemoryImage. Returns the file descriptor, or -1 if failed.
+  int32_t preopenVirtual(std::string_view Path, std::shared_ptr<VFSNode> Root);
+  /// Open a file descriptor for a virtual node. Returns the file descriptor,
+  /// or -1 and sets errno if failed.
+  int32_t openVirtual(std::shared_ptr<VFSNode> Node, __wasi_rights_t Rights,
+                      __wasi_rights_t InheritingRights, std::string_view Path);
+
+  /// Set up the write combining buffer for stdout and stderr, and also for
+  /// the other files if IncludeFiles is set. Both streams share the buffer,
+  /// so that their outputs keep the order of the writes.
+  void setWriteBuffer(WriteBufferMode Mode, size_t Capacity = 4096,
+                      bool IncludeFiles = false);
+  /// Check whether the writes to the file descriptor are buffered.
+  bool isWriteBuffered(__wasi_fd_t Fd) const noexcept {
+    return BufferMode != WriteBufferMode::None &&
+           (Fd == STDOUT_FILENO || Fd == STDERR_FILENO ||
+            (BufferFiles && Fd > STDERR_FILENO));
+  }
+  /// Append the iovecs to the write buffer of the file descriptor. Returns
+  /// the written size, or -1 and sets errno when failed like writev.
+  ssize_t bufferWrite(__wasi_fd_t Fd, const iovec *IOVS, int Count) noexcept;
+  /// Write out the pending buffered data. Returns false and sets errno when
+  /// failed.
+  bool flushWriteBuffer() noexcept;
+
+  /// Serve the realtime and monotonic clocks from the times cached at the
+  /// start of the invocation, for the deterministic and cheap time queries.
+  void setFrozenClock(bool Enable) noexcept;
+  /// Cache the current times if the clocks are frozen. The VM calls it before
+  /// every invocation.
+  void freezeClocks() noexcept;
+  /// Get the cached time of the clock. Returns false if the clock is live.
+  bool getFrozenTime(__wasi_clockid_t ClockId,
+                     __wasi_timestamp_t &Time) const noexcept {
+    if (!FrozenClock) {
+      return false;
+    }
+    switch (ClockId) {
+    case __WASI_CLOCK_REALTIME:
+      Time = FrozenRealtime.load(std::memory_order_relaxed);
+      return true;
+    case __WASI_CLOCK_MONOTONIC:
+      Time = FrozenMonotonic.load(std::memory_order_relaxed);
+      return true;
+    default:
+      return false;
+    }
   }
 
 private:
   int32_t Status;
   std::vector<std::string> CmdArgs;
   std::vector<std::string_view> Environs;
-  std::vector<File> FileArray;
+  std::vector<std::shared_ptr<File>> FileTable;
+  mutable std::shared_mutex FileTableMutex;
   int ExitCode = 0;
+
+  bool flushWriteBufferLocked() noexcept;
+
+  WriteBufferMode BufferMode = WriteBufferMode::None;
+  bool BufferFiles = false;
+  size_t BufferCapacity = 0;
+  /// The file descriptor which owns the pending data, or -1 if none.
+  std::atomic<int64_t> BufferFd{-1};
+  std::vector<uint8_t> WriteBuffer;
+  std::mutex WriteBufferMutex;
+  bool FrozenClock = false;
+  std::atomic<__wasi_timestamp_t> FrozenRealtime{0};
+  std::atomic<__wasi_timestamp_t> FrozenMonotonic{0};
+  EventPoll Poll;
+  RandomGenerator Random;
+#ifdef SSVM_WASI_IO_URING
+  IOUring Ring;
+#endif
 };
 
 } // namespace Host
@@ -472,5 +472,18 @@ public:
                         uint32_t SdFlags);
 };
 
+/// `fd_copy` of the ssvm_io extension. Copy up to Len bytes from the current
+/// position of Src to Dst in the host, without passing the data through the
+/// linear memory. Like fd_read, the copied size may be less than Len, and it
+/// is zero at the end of Src.
+class WasiFdCopy : public Wasi<WasiFdCopy> {
+public:
+  WasiFdCopy(WasiEnvironment &HostEnv) : Wasi(HostEnv) {}
+
+  Expect<uint32_t> body(Runtime::Instance::MemoryInstance &MemInst,
+                        int32_t Src, int32_t Dst, uint64_t Len,
+                        uint32_t NCopiedPtr);
+};
+
 } // namespace Host
 } // namespace SSVM
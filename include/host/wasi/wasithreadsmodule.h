@@ -0,0 +1,43 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include "common/errcode.h"
+#include "runtime/hostfunc.h"
+#include "runtime/importobj.h"
+
+#include <cstdint>
+#include <functional>
+
+namespace SSVM {
+namespace Host {
+
+/// Callback which starts a guest thread with the start argument and returns
+/// the thread id.
+using WasiThreadSpawner = std::function<Expect<uint32_t>(uint32_t)>;
+
+/// `thread-spawn` of wasi-threads. Returns the positive thread id, or a
+/// negative value when the thread can not be started.
+class WasiThreadSpawn : public Runtime::HostFunction<WasiThreadSpawn> {
+public:
+  WasiThreadSpawn(WasiThreadSpawner &Func) : Spawner(Func) {}
+
+  Expect<int32_t> body(Runtime::Instance::MemoryInstance &MemInst,
+                       uint32_t StartArg);
+
+private:
+  WasiThreadSpawner &Spawner;
+};
+
+class WasiThreadsModule : public Runtime::ImportObject {
+public:
+  WasiThreadsModule();
+
+  /// Setter of the callback which runs `wasi_thread_start` in a new thread.
+  void setSpawner(WasiThreadSpawner Func) { Spawner = std::move(Func); }
+
+private:
+  WasiThreadSpawner Spawner;
+};
+
+} // namespace Host
+} // namespace SSVM
@@ -0,0 +1,175 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "common/ast/instruction.h"
+#include "common/value.h"
+#include "interpreter/interpreter.h"
+#include "runtime/instance/memory.h"
+
+#include <cstdint>
+
+namespace SSVM {
+namespace Interpreter {
+
+namespace {
+
+/// Read-modify-write operations of atomic instructions. Each one returns the
+/// old value in memory.
+struct AtomicAdd {
+  template <typename T> T operator()(T *Ptr, const T Val) const {
+    return __atomic_fetch_add(Ptr, Val, __ATOMIC_SEQ_CST);
+  }
+};
+struct AtomicSub {
+  template <typename T> T operator()(T *Ptr, const T Val) const {
+    return __atomic_fetch_sub(Ptr, Val, __ATOMIC_SEQ_CST);
+  }
+};
+struct AtomicAnd {
+  template <typename T> T operator()(T *Ptr, const T Val) const {
+    return __atomic_fetch_and(Ptr, Val, __ATOMIC_SEQ_CST);
+  }
+};
+struct AtomicOr {
+  template <typename T> T operator()(T *Ptr, const T Val) const {
+    return __atomic_fetch_or(Ptr, Val, __ATOMIC_SEQ_CST);
+  }
+};
+struct AtomicXor {
+  template <typename T> T operator()(T *Ptr, const T Val) const {
+    return __atomic_fetch_xor(Ptr, Val, __ATOMIC_SEQ_CST);
+  }
+};
+struct AtomicXchg {
+  template <typename T> T operator()(T *Ptr, const T Val) const {
+    return __atomic_exchange_n(Ptr, Val, __ATOMIC_SEQ_CST);
+  }
+};
+
+} // namespace
+
+template <typename T, typename TMem>
+Expect<void>
+Interpreter::runAtomicLoadOp(Runtime::Instance::MemoryInstance &MemInst,
+                             const AST::AtomicMemoryInstruction &Instr) {
+  /// Calculate EA
+  ValVariant &Val = StackMgr.getTop();
+  if (retrieveValue<uint32_t>(Val) >
+      std::numeric_limits<uint32_t>::max() - Instr.getMemoryOffset()) {
+    return Unexpect(ErrCode::MemoryOutOfBounds);
+  }
+  uint32_t EA = retrieveValue<uint32_t>(Val) + Instr.getMemoryOffset();
+
+  /// Value = Mem.Data[EA : sizeof(TMem)] and zero extend.
+  if (auto Res = MemInst.getAtomicPointer<TMem>(EA)) {
+    Val = static_cast<T>(__atomic_load_n(*Res, __ATOMIC_SEQ_CST));
+  } else {
+    return Unexpect(Res);
+  }
+  return {};
+}
+
+template <typename T, typename TMem>
+Expect<void>
+Interpreter::runAtomicStoreOp(Runtime::Instance::MemoryInstance &MemInst,
+                              const AST::AtomicMemoryInstruction &Instr) {
+  /// Pop the value t.const c from the Stack
+  ValVariant C = StackMgr.pop();
+
+  /// Calculate EA = i + offset
+  ValVariant I = StackMgr.pop();
+  if (retrieveValue<uint32_t>(I) >
+      std::numeric_limits<uint32_t>::max() - Instr.getMemoryOffset()) {
+    return Unexpect(ErrCode::MemoryOutOfBounds);
+  }
+  uint32_t EA = retrieveValue<uint32_t>(I) + Instr.getMemoryOffset();
+
+  /// Store the wrapped value to Mem.Data[EA : sizeof(TMem)].
+  if (auto Res = MemInst.getAtomicPointer<TMem>(EA)) {
+    __atomic_store_n(*Res, static_cast<TMem>(retrieveValue<T>(C)),
+                     __ATOMIC_SEQ_CST);
+  } else {
+    return Unexpect(Res);
+  }
+  return {};
+}
+
+template <typename T, typename TMem, typename Op>
+Expect<void>
+Interpreter::runAtomicRMWOp(Runtime::Instance::MemoryInstance &MemInst,
+                            const AST::AtomicMemoryInstruction &Instr) {
+  /// Pop the operand from the Stack
+  ValVariant C = StackMgr.pop();
+
+  /// Calculate EA = i + offset
+  ValVariant &Val = StackMgr.getTop();
+  if (retrieveValue<uint32_t>(Val) >
+      std::numeric_limits<uint32_t>::max() - Instr.getMemoryOffset()) {
+    return Unexpect(ErrCode::MemoryOutOfBounds);
+  }
+  uint32_t EA = retrieveValue<uint32_t>(Val) + Instr.getMemoryOffset();
+
+  /// Modify Mem.Data[EA : sizeof(TMem)] and return the old value.
+  if (auto Res = MemInst.getAtomicPointer<TMem>(EA)) {
+    Val = static_cast<T>(Op()(*Res, static_cast<TMem>(retrieveValue<T>(C))));
+  } else {
+    return Unexpect(Res);
+  }
+  return {};
+}
+
+template <typename T, typename TMem>
+Expect<void>
+Interpreter::runAtomicCmpxchgOp(Runtime::Instance::MemoryInstance &MemInst,
+                                const AST::AtomicMemoryInstruction &Instr) {
+  /// Pop the replacement and the expected value from the Stack
+  ValVariant Replacement = StackMgr.pop();
+  ValVariant Expected = StackMgr.pop();
+
+  /// Calculate EA = i + offset
+  ValVariant &Val = StackMgr.getTop();
+  if (retrieveValue<uint32_t>(Val) >
+      std::numeric_limits<uint32_t>::max() - Instr.getMemoryOffset()) {
+    return Unexpect(ErrCode::MemoryOutOfBounds);
+  }
+  uint32_t EA = retrieveValue<uint32_t>(Val) + Instr.getMemoryOffset();
+
+  /// Compare with the wrapped expected value and return the old value.
+  if (auto Res = MemInst.getAtomicPointer<TMem>(EA)) {
+    TMem Old = static_cast<TMem>(retrieveValue<T>(Expected));
+    __atomic_compare_exchange_n(
+        *Res, &Old, static_cast<TMem>(retrieveValue<T>(Replacement)), false,
+        __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+    Val = static_cast<T>(Old);
+  } else {
+    return Unexpect(Res);
+  }
+  return {};
+}
+
+template <typename T>
+Expect<void>
+Interpreter::runAtomicWaitOp(Runtime::Instance::MemoryInstance &MemInst,
+                             const AST::AtomicMemoryInstruction &Instr) {
+  /// Pop the timeout and the expected value from the Stack
+  ValVariant Timeout = StackMgr.pop();
+  ValVariant Expected = StackMgr.pop();
+
+  /// Calculate EA = i + offset
+  ValVariant &Val = StackMgr.getTop();
+  if (retrieveValue<uint32_t>(Val) >
+      std::numeric_limits<uint32_t>::max() - Instr.getMemoryOffset()) {
+    return Unexpect(ErrCode::MemoryOutOfBounds);
+  }
+  uint32_t EA = retrieveValue<uint32_t>(Val) + Instr.getMemoryOffset();
+
+  /// Block until notified or timed out.
+  if (auto Res = MemInst.atomicWait<T>(EA, retrieveValue<T>(Expected),
+                                       retrieveValue<int64_t>(Timeout))) {
+    Val = *Res;
+  } else {
+    return Unexpect(Res);
+  }
+  return {};
+}
+
+} // namespace Interpreter
+} // namespace SSVM
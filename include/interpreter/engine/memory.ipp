@@ -44,5 +44,130 @@ TypeB<T> Interpreter::runStoreOp(Runtime::Instance::MemoryInstance &MemInst,
   return MemInst.storeValue(retrieveValue<T>(C), EA, BitWidth / 8);
 }
 
+template <typename TIn, typename TOut>
+Expect<void>
+Interpreter::runLoadExpandOp(Runtime::Instance::MemoryInstance &MemInst,
+                             const AST::SIMDMemoryInstruction &Instr) {
+  /// Calculate EA
+  ValVariant &Val = StackMgr.getTop();
+  if (retrieveValue<uint32_t>(Val) >
+      std::numeric_limits<uint32_t>::max() - Instr.getMemoryOffset()) {
+    return Unexpect(ErrCode::MemoryOutOfBounds);
+  }
+  uint32_t EA = retrieveValue<uint32_t>(Val) + Instr.getMemoryOffset();
+
+  /// Load 8 bytes and extend each lane.
+  constexpr size_t Lanes = 8 / sizeof(TIn);
+  TIn Buffer[Lanes];
+  if (auto Res = MemInst.getArray(reinterpret_cast<uint8_t *>(Buffer), EA, 8);
+      !Res) {
+    return Unexpect(Res);
+  }
+  SIMDArray<TOut> Vec;
+  for (size_t I = 0; I < Lanes; ++I) {
+    Vec[I] = Buffer[I];
+  }
+  setVector(Val, Vec);
+  return {};
+}
+
+template <typename T>
+Expect<void>
+Interpreter::runLoadSplatOp(Runtime::Instance::MemoryInstance &MemInst,
+                            const AST::SIMDMemoryInstruction &Instr) {
+  /// Calculate EA
+  ValVariant &Val = StackMgr.getTop();
+  if (retrieveValue<uint32_t>(Val) >
+      std::numeric_limits<uint32_t>::max() - Instr.getMemoryOffset()) {
+    return Unexpect(ErrCode::MemoryOutOfBounds);
+  }
+  uint32_t EA = retrieveValue<uint32_t>(Val) + Instr.getMemoryOffset();
+
+  /// Load a value and copy it to all lanes.
+  T Value;
+  if (auto Res = MemInst.getArray(reinterpret_cast<uint8_t *>(&Value), EA,
+                                  sizeof(T));
+      !Res) {
+    return Unexpect(Res);
+  }
+  SIMDArray<T> Vec;
+  for (size_t I = 0; I < 16 / sizeof(T); ++I) {
+    Vec[I] = Value;
+  }
+  setVector(Val, Vec);
+  return {};
+}
+
+template <typename T>
+Expect<void>
+Interpreter::runLoadZeroOp(Runtime::Instance::MemoryInstance &MemInst,
+                           const AST::SIMDMemoryInstruction &Instr) {
+  /// Calculate EA
+  ValVariant &Val = StackMgr.getTop();
+  if (retrieveValue<uint32_t>(Val) >
+      std::numeric_limits<uint32_t>::max() - Instr.getMemoryOffset()) {
+    return Unexpect(ErrCode::MemoryOutOfBounds);
+  }
+  uint32_t EA = retrieveValue<uint32_t>(Val) + Instr.getMemoryOffset();
+
+  /// Value = Mem.Data[EA : sizeof(T)], and the rest bytes are zero.
+  uint128_t Value = 0U;
+  if (auto Res = MemInst.getArray(reinterpret_cast<uint8_t *>(&Value), EA,
+                                  sizeof(T));
+      !Res) {
+    return Unexpect(Res);
+  }
+  Val = Value;
+  return {};
+}
+
+template <typename T>
+Expect<void>
+Interpreter::runLoadLaneOp(Runtime::Instance::MemoryInstance &MemInst,
+                           const AST::SIMDMemoryInstruction &Instr) {
+  /// Pop the v128 value from the Stack
+  ValVariant Vec = StackMgr.pop();
+
+  /// Calculate EA
+  ValVariant &Val = StackMgr.getTop();
+  if (retrieveValue<uint32_t>(Val) >
+      std::numeric_limits<uint32_t>::max() - Instr.getMemoryOffset()) {
+    return Unexpect(ErrCode::MemoryOutOfBounds);
+  }
+  uint32_t EA = retrieveValue<uint32_t>(Val) + Instr.getMemoryOffset();
+
+  /// Replace the lane with Mem.Data[EA : sizeof(T)].
+  uint8_t *Lane = reinterpret_cast<uint8_t *>(&retrieveValue<uint128_t>(Vec));
+  if (auto Res = MemInst.getArray(Lane + Instr.getLaneIndex() * sizeof(T), EA,
+                                  sizeof(T));
+      !Res) {
+    return Unexpect(Res);
+  }
+  Val = Vec;
+  return {};
+}
+
+template <typename T>
+Expect<void>
+Interpreter::runStoreLaneOp(Runtime::Instance::MemoryInstance &MemInst,
+                            const AST::SIMDMemoryInstruction &Instr) {
+  /// Pop the v128 value from the Stack
+  ValVariant Vec = StackMgr.pop();
+
+  /// Calculate EA = i + offset
+  ValVariant I = StackMgr.pop();
+  if (retrieveValue<uint32_t>(I) >
+      std::numeric_limits<uint32_t>::max() - Instr.getMemoryOffset()) {
+    return Unexpect(ErrCode::MemoryOutOfBounds);
+  }
+  uint32_t EA = retrieveValue<uint32_t>(I) + Instr.getMemoryOffset();
+
+  /// Store the lane to bytes.
+  const uint8_t *Lane =
+      reinterpret_cast<const uint8_t *>(&retrieveValue<uint128_t>(Vec));
+  return MemInst.setArray(Lane + Instr.getLaneIndex() * sizeof(T), EA,
+                          sizeof(T));
+}
+
 } // namespace Interpreter
 } // namespace SSVM
@@ -42,10 +42,10 @@ public:
 
   /// Push instruction sequence.
   void pushInstrs(SeqType Type) {
-    Iters.emplace_back(Type, EmptyVec.cbegin(), EmptyVec.cend());
+    Iters.emplace_back(Type, EmptyVec.begin(), EmptyVec.end());
   }
   void pushInstrs(SeqType Type, const AST::InstrVec &Instrs) {
-    Iters.emplace_back(Type, Instrs.cbegin(), Instrs.cend());
+    Iters.emplace_back(Type, Instrs.begin(), Instrs.end());
   }
 
   /// Unsafe pop instruction sequence. Should be correct according to
@@ -0,0 +1,560 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "common/value.h"
+#include "interpreter/interpreter.h"
+#include "support/roundeven.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+namespace SSVM {
+namespace Interpreter {
+
+template <typename TIn, typename TOut>
+Expect<void> Interpreter::runExtractLaneOp(ValVariant &Val,
+                                           const uint8_t Index) const {
+  /// Extend the lane to the Wasm built-in type TOut. Signed case handled.
+  Val = static_cast<TOut>(toVector<TIn>(Val)[Index]);
+  return {};
+}
+
+template <typename TIn, typename TOut>
+Expect<void> Interpreter::runReplaceLaneOp(ValVariant &Val1,
+                                           const ValVariant &Val2,
+                                           const uint8_t Index) const {
+  SIMDArray<TOut> Vec = toVector<TOut>(Val1);
+  Vec[Index] = static_cast<TOut>(retrieveValue<TIn>(Val2));
+  setVector(Val1, Vec);
+  return {};
+}
+
+inline Expect<void>
+Interpreter::runShuffleOp(ValVariant &Val1, const ValVariant &Val2,
+                          const std::array<uint8_t, 16> &Lanes) const {
+  /// Lane indices 0 to 15 select from v1, and 16 to 31 select from v2.
+  const SIMDArray<uint8_t> Vec1 = toVector<uint8_t>(Val1);
+  const SIMDArray<uint8_t> Vec2 = toVector<uint8_t>(Val2);
+  SIMDArray<uint8_t> Res;
+  for (size_t I = 0; I < 16; ++I) {
+    Res[I] = Lanes[I] < 16 ? Vec1[Lanes[I]] : Vec2[Lanes[I] - 16];
+  }
+  setVector(Val1, Res);
+  return {};
+}
+
+template <typename TIn, typename TOut>
+Expect<void> Interpreter::runSplatOp(ValVariant &Val) const {
+  const TOut Value = static_cast<TOut>(retrieveValue<TIn>(Val));
+  SIMDArray<TOut> Vec;
+  for (size_t I = 0; I < 16 / sizeof(TOut); ++I) {
+    Vec[I] = Value;
+  }
+  setVector(Val, Vec);
+  return {};
+}
+
+inline Expect<void> Interpreter::runSwizzleOp(ValVariant &Val1,
+                                              const ValVariant &Val2) const {
+  /// Out of range indices select zero.
+  const SIMDArray<uint8_t> Vec1 = toVector<uint8_t>(Val1);
+  const SIMDArray<uint8_t> Vec2 = toVector<uint8_t>(Val2);
+  SIMDArray<uint8_t> Res;
+  for (size_t I = 0; I < 16; ++I) {
+    Res[I] = Vec2[I] < 16 ? Vec1[Vec2[I]] : 0;
+  }
+  setVector(Val1, Res);
+  return {};
+}
+
+/// Comparisons set all bits of the true lanes.
+template <typename T>
+Expect<void> Interpreter::runVectorEqOp(ValVariant &Val1,
+                                        const ValVariant &Val2) const {
+  setVector(Val1, toVector<T>(Val1) == toVector<T>(Val2));
+  return {};
+}
+
+template <typename T>
+Expect<void> Interpreter::runVectorNeOp(ValVariant &Val1,
+                                        const ValVariant &Val2) const {
+  setVector(Val1, toVector<T>(Val1) != toVector<T>(Val2));
+  return {};
+}
+
+template <typename T>
+Expect<void> Interpreter::runVectorLtOp(ValVariant &Val1,
+                                        const ValVariant &Val2) const {
+  setVector(Val1, toVector<T>(Val1) < toVector<T>(Val2));
+  return {};
+}
+
+template <typename T>
+Expect<void> Interpreter::runVectorGtOp(ValVariant &Val1,
+                                        const ValVariant &Val2) const {
+  setVector(Val1, toVector<T>(Val1) > toVector<T>(Val2));
+  return {};
+}
+
+template <typename T>
+Expect<void> Interpreter::runVectorLeOp(ValVariant &Val1,
+                                        const ValVariant &Val2) const {
+  setVector(Val1, toVector<T>(Val1) <= toVector<T>(Val2));
+  return {};
+}
+
+template <typename T>
+Expect<void> Interpreter::runVectorGeOp(ValVariant &Val1,
+                                        const ValVariant &Val2) const {
+  setVector(Val1, toVector<T>(Val1) >= toVector<T>(Val2));
+  return {};
+}
+
+inline Expect<void> Interpreter::runVectorNotOp(ValVariant &Val) const {
+  retrieveValue<uint128_t>(Val) = ~retrieveValue<uint128_t>(Val);
+  return {};
+}
+
+inline Expect<void> Interpreter::runVectorAndOp(ValVariant &Val1,
+                                                const ValVariant &Val2) const {
+  retrieveValue<uint128_t>(Val1) &= retrieveValue<uint128_t>(Val2);
+  return {};
+}
+
+inline Expect<void>
+Interpreter::runVectorAndNotOp(ValVariant &Val1, const ValVariant &Val2) const {
+  retrieveValue<uint128_t>(Val1) &= ~retrieveValue<uint128_t>(Val2);
+  return {};
+}
+
+inline Expect<void> Interpreter::runVectorOrOp(ValVariant &Val1,
+                                               const ValVariant &Val2) const {
+  retrieveValue<uint128_t>(Val1) |= retrieveValue<uint128_t>(Val2);
+  return {};
+}
+
+inline Expect<void> Interpreter::runVectorXorOp(ValVariant &Val1,
+                                                const ValVariant &Val2) const {
+  retrieveValue<uint128_t>(Val1) ^= retrieveValue<uint128_t>(Val2);
+  return {};
+}
+
+inline Expect<void>
+Interpreter::runVectorBitSelectOp(ValVariant &Val1, const ValVariant &Val2,
+                                  const ValVariant &Val3) const {
+  /// Select the bits of v1 where the bits of mask v3 are set, else v2.
+  uint128_t &V1 = retrieveValue<uint128_t>(Val1);
+  const uint128_t &Mask = retrieveValue<uint128_t>(Val3);
+  V1 = (V1 & Mask) | (retrieveValue<uint128_t>(Val2) & ~Mask);
+  return {};
+}
+
+inline Expect<void> Interpreter::runVectorAnyTrueOp(ValVariant &Val) const {
+  Val = static_cast<uint32_t>(retrieveValue<uint128_t>(Val) != 0U);
+  return {};
+}
+
+template <typename T>
+Expect<void> Interpreter::runVectorAbsOp(ValVariant &Val) const {
+  if constexpr (std::is_floating_point_v<T>) {
+    /// Clear the sign bits.
+    using U = std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>;
+    setVector(Val, toVector<U>(Val) & ~(U(1) << (sizeof(T) * 8 - 1)));
+  } else {
+    /// Negate the negative lanes. The minimum value is wrapped.
+    using U = std::make_unsigned_t<T>;
+    const SIMDArray<U> Vec = toVector<U>(Val);
+    setVector(Val, toVector<T>(Val) < 0 ? -Vec : Vec);
+  }
+  return {};
+}
+
+template <typename T>
+Expect<void> Interpreter::runVectorNegOp(ValVariant &Val) const {
+  if constexpr (std::is_floating_point_v<T>) {
+    /// Flip the sign bits.
+    using U = std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>;
+    setVector(Val, toVector<U>(Val) ^ (U(1) << (sizeof(T) * 8 - 1)));
+  } else {
+    setVector(Val, -toVector<std::make_unsigned_t<T>>(Val));
+  }
+  return {};
+}
+
+inline Expect<void> Interpreter::runVectorPopcntOp(ValVariant &Val) const {
+  SIMDArray<uint8_t> Vec = toVector<uint8_t>(Val);
+  for (size_t I = 0; I < 16; ++I) {
+    Vec[I] = static_cast<uint8_t>(__builtin_popcount(Vec[I]));
+  }
+  setVector(Val, Vec);
+  return {};
+}
+
+template <typename T>
+Expect<void> Interpreter::runVectorAllTrueOp(ValVariant &Val) const {
+  const SIMDArray<T> Vec = toVector<T>(Val);
+  uint32_t Res = 1U;
+  for (size_t I = 0; I < 16 / sizeof(T); ++I) {
+    Res &= static_cast<uint32_t>(Vec[I] != 0);
+  }
+  Val = Res;
+  return {};
+}
+
+template <typename T>
+Expect<void> Interpreter::runVectorBitMaskOp(ValVariant &Val) const {
+  /// Collect the sign bits of the signed lanes.
+  const SIMDArray<T> Vec = toVector<T>(Val);
+  uint32_t Res = 0U;
+  for (size_t I = 0; I < 16 / sizeof(T); ++I) {
+    Res |= static_cast<uint32_t>(Vec[I] < 0) << I;
+  }
+  Val = Res;
+  return {};
+}
+
+template <typename TIn, typename TOut>
+Expect<void> Interpreter::runVectorNarrowOp(ValVariant &Val1,
+                                            const ValVariant &Val2) const {
+  /// Saturate the signed lanes of v1 and v2 to the lanes of TOut.
+  constexpr size_t Lanes = 16 / sizeof(TIn);
+  const TIn Min = static_cast<TIn>(std::numeric_limits<TOut>::min());
+  const TIn Max = static_cast<TIn>(std::numeric_limits<TOut>::max());
+  const SIMDArray<TIn> Vec1 = toVector<TIn>(Val1);
+  const SIMDArray<TIn> Vec2 = toVector<TIn>(Val2);
+  SIMDArray<TOut> Res;
+  for (size_t I = 0; I < Lanes; ++I) {
+    Res[I] = static_cast<TOut>(std::clamp(Vec1[I], Min, Max));
+    Res[I + Lanes] = static_cast<TOut>(std::clamp(Vec2[I], Min, Max));
+  }
+  setVector(Val1, Res);
+  return {};
+}
+
+template <typename T>
+Expect<void> Interpreter::runVectorCeilOp(ValVariant &Val) const {
+  SIMDArray<T> Vec = toVector<T>(Val);
+  for (size_t I = 0; I < 16 / sizeof(T); ++I) {
+    Vec[I] = std::ceil(Vec[I]);
+  }
+  setVector(Val, Vec);
+  return {};
+}
+
+template <typename T>
+Expect<void> Interpreter::runVectorFloorOp(ValVariant &Val) const {
+  SIMDArray<T> Vec = toVector<T>(Val);
+  for (size_t I = 0; I < 16 / sizeof(T); ++I) {
+    Vec[I] = std::floor(Vec[I]);
+  }
+  setVector(Val, Vec);
+  return {};
+}
+
+template <typename T>
+Expect<void> Interpreter::runVectorTruncOp(ValVariant &Val) const {
+  SIMDArray<T> Vec = toVector<T>(Val);
+  for (size_t I = 0; I < 16 / sizeof(T); ++I) {
+    Vec[I] = std::trunc(Vec[I]);
+  }
+  setVector(Val, Vec);
+  return {};
+}
+
+template <typename T>
+Expect<void> Interpreter::runVectorNearestOp(ValVariant &Val) const {
+  SIMDArray<T> Vec = toVector<T>(Val);
+  for (size_t I = 0; I < 16 / sizeof(T); ++I) {
+    Vec[I] = SSVM::roundeven(T(Vec[I]));
+  }
+  setVector(Val, Vec);
+  return {};
+}
+
+template <typename T>
+Expect<void> Interpreter::runVectorSqrtOp(ValVariant &Val) const {
+  SIMDArray<T> Vec = toVector<T>(Val);
+  for (size_t I = 0; I < 16 / sizeof(T); ++I) {
+    Vec[I] = std::sqrt(Vec[I]);
+  }
+  setVector(Val, Vec);
+  return {};
+}
+
+template <typename T>
+Expect<void> Interpreter::runVectorShlOp(ValVariant &Val1,
+                                         const ValVariant &Val2) const {
+  /// The shift count is modulo the lane width.
+  const uint32_t Count = retrieveValue<uint32_t>(Val2) & (sizeof(T) * 8 - 1);
+  setVector(Val1, toVector<T>(Val1) << Count);
+  return {};
+}
+
+template <typename T>
+Expect<void> Interpreter::runVectorShrOp(ValVariant &Val1,
+                                         const ValVariant &Val2) const {
+  /// Arithmetic shift for signed lanes, and logical shift for unsigned lanes.
+  const uint32_t Count = retrieveValue<uint32_t>(Val2) & (sizeof(T) * 8 - 1);
+  setVector(Val1, toVector<T>(Val1) >> Count);
+  return {};
+}
+
+/// Integer lanes are unsigned, so the results are modulo 2^N.
+template <typename T>
+Expect<void> Interpreter::runVectorAddOp(ValVariant &Val1,
+                                         const ValVariant &Val2) const {
+  setVector(Val1, toVector<T>(Val1) + toVector<T>(Val2));
+  return {};
+}
+
+template <typename T>
+Expect<void> Interpreter::runVectorSubOp(ValVariant &Val1,
+                                         const ValVariant &Val2) const {
+  setVector(Val1, toVector<T>(Val1) - toVector<T>(Val2));
+  return {};
+}
+
+template <typename T>
+Expect<void> Interpreter::runVectorMulOp(ValVariant &Val1,
+                                         const ValVariant &Val2) const {
+  setVector(Val1, toVector<T>(Val1) * toVector<T>(Val2));
+  return {};
+}
+
+template <typename T>
+Expect<void> Interpreter::runVectorDivOp(ValVariant &Val1,
+                                         const ValVariant &Val2) const {
+  setVector(Val1, toVector<T>(Val1) / toVector<T>(Val2));
+  return {};
+}
+
+template <typename T>
+Expect<void> Interpreter::runVectorAddSatOp(ValVariant &Val1,
+                                            const ValVariant &Val2) const {
+  /// The 8-bit and 16-bit lanes are added in 32-bit and then saturated.
+  constexpr int32_t Min = std::numeric_limits<T>::min();
+  constexpr int32_t Max = std::numeric_limits<T>::max();
+  SIMDArray<T> Vec1 = toVector<T>(Val1);
+  const SIMDArray<T> Vec2 = toVector<T>(Val2);
+  for (size_t I = 0; I < 16 / sizeof(T); ++I) {
+    Vec1[I] = static_cast<T>(
+        std::clamp(int32_t(Vec1[I]) + int32_t(Vec2[I]), Min, Max));
+  }
+  setVector(Val1, Vec1);
+  return {};
+}
+
+template <typename T>
+Expect<void> Interpreter::runVectorSubSatOp(ValVariant &Val1,
+                                            const ValVariant &Val2) const {
+  /// The 8-bit and 16-bit lanes are subtracted in 32-bit and then saturated.
+  constexpr int32_t Min = std::numeric_limits<T>::min();
+  constexpr int32_t Max = std::numeric_limits<T>::max();
+  SIMDArray<T> Vec1 = toVector<T>(Val1);
+  const SIMDArray<T> Vec2 = toVector<T>(Val2);
+  for (size_t I = 0; I < 16 / sizeof(T); ++I) {
+    Vec1[I] = static_cast<T>(
+        std::clamp(int32_t(Vec1[I]) - int32_t(Vec2[I]), Min, Max));
+  }
+  setVector(Val1, Vec1);
+  return {};
+}
+
+template <typename T>
+Expect<void> Interpreter::runVectorMinOp(ValVariant &Val1,
+                                         const ValVariant &Val2) const {
+  SIMDArray<T> Vec1 = toVector<T>(Val1);
+  const SIMDArray<T> Vec2 = toVector<T>(Val2);
+  if constexpr (std::is_floating_point_v<T>) {
+    /// Same as the scalar min: NaN propagates and -0.0 is less than +0.0.
+    for (size_t I = 0; I < 16 / sizeof(T); ++I) {
+      const T Z1 = Vec1[I], Z2 = Vec2[I];
+      if (std::isnan(Z2)) {
+        Vec1[I] = Z2;
+      } else if (Z1 == 0.0 && Z2 == 0.0 &&
+                 std::signbit(Z1) != std::signbit(Z2)) {
+        Vec1[I] = -0.0;
+      } else if (!std::isnan(Z1)) {
+        Vec1[I] = std::min(Z1, Z2);
+      }
+    }
+    setVector(Val1, Vec1);
+  } else {
+    setVector(Val1, Vec1 < Vec2 ? Vec1 : Vec2);
+  }
+  return {};
+}
+
+template <typename T>
+Expect<void> Interpreter::runVectorMaxOp(ValVariant &Val1,
+                                         const ValVariant &Val2) const {
+  SIMDArray<T> Vec1 = toVector<T>(Val1);
+  const SIMDArray<T> Vec2 = toVector<T>(Val2);
+  if constexpr (std::is_floating_point_v<T>) {
+    /// Same as the scalar max: NaN propagates and +0.0 is greater than -0.0.
+    for (size_t I = 0; I < 16 / sizeof(T); ++I) {
+      const T Z1 = Vec1[I], Z2 = Vec2[I];
+      if (std::isnan(Z2)) {
+        Vec1[I] = Z2;
+      } else if (Z1 == 0.0 && Z2 == 0.0 &&
+                 std::signbit(Z1) != std::signbit(Z2)) {
+        Vec1[I] = 0.0;
+      } else if (!std::isnan(Z1)) {
+        Vec1[I] = std::max(Z1, Z2);
+      }
+    }
+    setVector(Val1, Vec1);
+  } else {
+    setVector(Val1, Vec1 > Vec2 ? Vec1 : Vec2);
+  }
+  return {};
+}
+
+template <typename T>
+Expect<void> Interpreter::runVectorPMinOp(ValVariant &Val1,
+                                          const ValVariant &Val2) const {
+  /// Pseudo-minimum: v2 < v1 ? v2 : v1.
+  const SIMDArray<T> Vec1 = toVector<T>(Val1);
+  const SIMDArray<T> Vec2 = toVector<T>(Val2);
+  setVector(Val1, Vec2 < Vec1 ? Vec2 : Vec1);
+  return {};
+}
+
+template <typename T>
+Expect<void> Interpreter::runVectorPMaxOp(ValVariant &Val1,
+                                          const ValVariant &Val2) const {
+  /// Pseudo-maximum: v1 < v2 ? v2 : v1.
+  const SIMDArray<T> Vec1 = toVector<T>(Val1);
+  const SIMDArray<T> Vec2 = toVector<T>(Val2);
+  setVector(Val1, Vec1 < Vec2 ? Vec2 : Vec1);
+  return {};
+}
+
+template <typename T>
+Expect<void> Interpreter::runVectorAvgrOp(ValVariant &Val1,
+                                          const ValVariant &Val2) const {
+  /// Rounding average of the unsigned lanes: (v1 + v2 + 1) / 2.
+  SIMDArray<T> Vec1 = toVector<T>(Val1);
+  const SIMDArray<T> Vec2 = toVector<T>(Val2);
+  for (size_t I = 0; I < 16 / sizeof(T); ++I) {
+    Vec1[I] = static_cast<T>((uint32_t(Vec1[I]) + uint32_t(Vec2[I]) + 1U) / 2U);
+  }
+  setVector(Val1, Vec1);
+  return {};
+}
+
+inline Expect<void>
+Interpreter::runVectorQ15MulSatOp(ValVariant &Val1,
+                                  const ValVariant &Val2) const {
+  /// Q15 fixed-point multiplication with rounding and saturation.
+  SIMDArray<int16_t> Vec1 = toVector<int16_t>(Val1);
+  const SIMDArray<int16_t> Vec2 = toVector<int16_t>(Val2);
+  for (size_t I = 0; I < 8; ++I) {
+    const int32_t Res = (int32_t(Vec1[I]) * int32_t(Vec2[I]) + 0x4000) >> 15;
+    Vec1[I] = static_cast<int16_t>(std::min(Res, int32_t(INT16_MAX)));
+  }
+  setVector(Val1, Vec1);
+  return {};
+}
+
+inline Expect<void> Interpreter::runVectorDotOp(ValVariant &Val1,
+                                                const ValVariant &Val2) const {
+  /// Add the products of the adjacent signed 16-bit lanes.
+  const SIMDArray<int16_t> Vec1 = toVector<int16_t>(Val1);
+  const SIMDArray<int16_t> Vec2 = toVector<int16_t>(Val2);
+  SIMDArray<uint32_t> Res;
+  for (size_t I = 0; I < 4; ++I) {
+    Res[I] = static_cast<uint32_t>(int32_t(Vec1[I * 2]) * Vec2[I * 2]) +
+             static_cast<uint32_t>(int32_t(Vec1[I * 2 + 1]) * Vec2[I * 2 + 1]);
+  }
+  setVector(Val1, Res);
+  return {};
+}
+
+template <typename TIn, typename TOut>
+Expect<void> Interpreter::runVectorExtAddPairwiseOp(ValVariant &Val) const {
+  const SIMDArray<TIn> Vec = toVector<TIn>(Val);
+  SIMDArray<TOut> Res;
+  for (size_t I = 0; I < 16 / sizeof(TOut); ++I) {
+    Res[I] = static_cast<TOut>(TOut(Vec[I * 2]) + TOut(Vec[I * 2 + 1]));
+  }
+  setVector(Val, Res);
+  return {};
+}
+
+template <typename TIn, typename TOut>
+Expect<void> Interpreter::runVectorConvertOp(ValVariant &Val) const {
+  constexpr size_t Lanes = 16 / std::max(sizeof(TIn), sizeof(TOut));
+  const SIMDArray<TIn> Vec = toVector<TIn>(Val);
+  SIMDArray<TOut> Res = {};
+  for (size_t I = 0; I < Lanes; ++I) {
+    Res[I] = static_cast<TOut>(Vec[I]);
+  }
+  setVector(Val, Res);
+  return {};
+}
+
+template <typename TIn, typename TOut>
+Expect<void> Interpreter::runVectorExtendHighOp(ValVariant &Val) const {
+  constexpr size_t Lanes = 16 / sizeof(TOut);
+  const SIMDArray<TIn> Vec = toVector<TIn>(Val);
+  SIMDArray<TOut> Res;
+  for (size_t I = 0; I < Lanes; ++I) {
+    Res[I] = static_cast<TOut>(Vec[I + Lanes]);
+  }
+  setVector(Val, Res);
+  return {};
+}
+
+template <typename TIn, typename TOut>
+Expect<void> Interpreter::runVectorExtMulLowOp(ValVariant &Val1,
+                                               const ValVariant &Val2) const {
+  const SIMDArray<TIn> Vec1 = toVector<TIn>(Val1);
+  const SIMDArray<TIn> Vec2 = toVector<TIn>(Val2);
+  SIMDArray<TOut> Res;
+  for (size_t I = 0; I < 16 / sizeof(TOut); ++I) {
+    Res[I] = static_cast<TOut>(TOut(Vec1[I]) * TOut(Vec2[I]));
+  }
+  setVector(Val1, Res);
+  return {};
+}
+
+template <typename TIn, typename TOut>
+Expect<void> Interpreter::runVectorExtMulHighOp(ValVariant &Val1,
+                                                const ValVariant &Val2) const {
+  constexpr size_t Lanes = 16 / sizeof(TOut);
+  const SIMDArray<TIn> Vec1 = toVector<TIn>(Val1);
+  const SIMDArray<TIn> Vec2 = toVector<TIn>(Val2);
+  SIMDArray<TOut> Res;
+  for (size_t I = 0; I < Lanes; ++I) {
+    Res[I] =
+        static_cast<TOut>(TOut(Vec1[I + Lanes]) * TOut(Vec2[I + Lanes]));
+  }
+  setVector(Val1, Res);
+  return {};
+}
+
+template <typename TIn, typename TOut>
+Expect<void> Interpreter::runVectorTruncSatOp(ValVariant &Val) const {
+  /// NaN is converted to 0, and the out of range values are saturated.
+  constexpr size_t Lanes = 16 / sizeof(TIn);
+  const SIMDArray<TIn> Vec = toVector<TIn>(Val);
+  SIMDArray<TOut> Res = {};
+  for (size_t I = 0; I < Lanes; ++I) {
+    const TIn Z = Vec[I];
+    if (std::isnan(Z)) {
+      Res[I] = 0;
+    } else if (Z <= static_cast<TIn>(std::numeric_limits<TOut>::min())) {
+      Res[I] = std::numeric_limits<TOut>::min();
+    } else if (Z >= static_cast<TIn>(std::numeric_limits<TOut>::max())) {
+      Res[I] = std::numeric_limits<TOut>::max();
+    } else {
+      Res[I] = static_cast<TOut>(Z);
+    }
+  }
+  setVector(Val, Res);
+  return {};
+}
+
+} // namespace Interpreter
+} // namespace SSVM
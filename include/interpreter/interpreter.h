@@ -24,6 +24,8 @@
 #include "support/time.h"
 
 #include <csetjmp>
+#include <cstring>
+#include <map>
 #include <memory>
 #include <type_traits>
 #include <vector>
@@ -84,6 +86,20 @@ using TypeBB = typename std::enable_if_t<Support::IsWasmBuiltInV<T1> &&
                                              sizeof(T1) == sizeof(T2),
                                          Expect<void>>;
 
+/// Get the lanes of a v128 value.
+template <typename T> inline SIMDArray<T> toVector(const ValVariant &Val) {
+  SIMDArray<T> Vec;
+  std::memcpy(&Vec, &retrieveValue<uint128_t>(Val), sizeof(Vec));
+  return Vec;
+}
+/// Set the lanes of a v128 value.
+template <typename V> inline void setVector(ValVariant &Val, const V &Vec) {
+  static_assert(sizeof(V) == sizeof(uint128_t));
+  uint128_t Value;
+  std::memcpy(&Value, &Vec, sizeof(Value));
+  Val = Value;
+}
+
 } // namespace
 
 /// Executor flow control class.
@@ -105,11 +121,23 @@ public:
   Expect<void> registerModule(Runtime::StoreManager &StoreMgr,
                               const AST::Module &Mod, const std::string &Name);
 
+  /// Setter of the validation of function bodies in lazy loading, which is
+  /// used by the function instances of the following instantiations.
+  void setCodeValidator(AST::CodeValidator Validator) {
+    CodeValidator = std::move(Validator);
+  }
+
   /// Invoke function by function address in Store manager.
   Expect<std::vector<ValVariant>> invoke(Runtime::StoreManager &StoreMgr,
                                          const uint32_t FuncAddr,
                                          const std::vector<ValVariant> &Params);
 
+  /// Give this engine its own copies of the mutable globals defined by the
+  /// module, e.g. the stack pointer of a guest thread. The memories, tables
+  /// and imported globals are still shared through the store.
+  Expect<void> setThreadGlobals(Runtime::StoreManager &StoreMgr,
+                                const uint32_t ModAddr);
+
 private:
   /// Run Wasm bytecode expression for initialization.
   Expect<void> runExpression(Runtime::StoreManager &StoreMgr,
@@ -203,21 +231,39 @@ private:
                        const AST::VariableInstruction &Instr);
   Expect<void> execute(Runtime::StoreManager &StoreMgr,
                        const AST::MemoryInstruction &Instr);
+  Expect<void> execute(Runtime::StoreManager &StoreMgr,
+                       const AST::TableInstruction &Instr);
+  Expect<void> execute(Runtime::StoreManager &StoreMgr,
+                       const AST::ReferenceInstruction &Instr);
   Expect<void> execute(Runtime::StoreManager &StoreMgr,
                        const AST::ConstInstruction &Instr);
   Expect<void> execute(Runtime::StoreManager &StoreMgr,
                        const AST::UnaryNumericInstruction &Instr);
   Expect<void> execute(Runtime::StoreManager &StoreMgr,
                        const AST::BinaryNumericInstruction &Instr);
+  Expect<void> execute(Runtime::StoreManager &StoreMgr,
+                       const AST::SIMDMemoryInstruction &Instr);
+  Expect<void> execute(Runtime::StoreManager &StoreMgr,
+                       const AST::SIMDLaneInstruction &Instr);
+  Expect<void> execute(Runtime::StoreManager &StoreMgr,
+                       const AST::SIMDShuffleInstruction &Instr);
+  Expect<void> execute(Runtime::StoreManager &StoreMgr,
+                       const AST::SIMDNumericInstruction &Instr);
+  Expect<void> execute(Runtime::StoreManager &StoreMgr,
+                       const AST::AtomicMemoryInstruction &Instr);
   /// @}
 
   /// \name Helper Functions for block controls.
   /// @{
   /// Helper function for entering blocks.
-  Expect<void> enterBlock(const uint32_t Arity,
+  Expect<void> enterBlock(const uint32_t Arity, const uint32_t Coarity,
                           const AST::BlockControlInstruction *Instr,
                           const AST::InstrVec &Seq);
 
+  /// Helper function for getting the parameter and result counts of blocks.
+  std::pair<uint32_t, uint32_t> getBlockArity(Runtime::StoreManager &StoreMgr,
+                                              const BlockType &Type);
+
   /// Helper function for leaving blocks.
   Expect<void> leaveBlock();
 
@@ -225,6 +271,11 @@ private:
   Expect<void> enterFunction(Runtime::StoreManager &StoreMgr,
                              const Runtime::Instance::FunctionInstance &Func);
 
+  /// Helper function for tail calling functions with the current frame.
+  Expect<void>
+  tailCallFunction(Runtime::StoreManager &StoreMgr,
+                   const Runtime::Instance::FunctionInstance &Func);
+
   /// Helper function for return from functions.
   Expect<void> leaveFunction();
 
@@ -250,9 +301,12 @@ private:
   /// \name Run instructions functions
   /// @{
   /// ======= Control instructions =======
-  Expect<void> runBlockOp(const AST::BlockControlInstruction &Instr);
-  Expect<void> runLoopOp(const AST::BlockControlInstruction &Instr);
-  Expect<void> runIfElseOp(const AST::IfElseControlInstruction &Instr);
+  Expect<void> runBlockOp(Runtime::StoreManager &StoreMgr,
+                          const AST::BlockControlInstruction &Instr);
+  Expect<void> runLoopOp(Runtime::StoreManager &StoreMgr,
+                         const AST::BlockControlInstruction &Instr);
+  Expect<void> runIfElseOp(Runtime::StoreManager &StoreMgr,
+                           const AST::IfElseControlInstruction &Instr);
   Expect<void> runBrOp(const AST::BrControlInstruction &Instr);
   Expect<void> runBrIfOp(const AST::BrControlInstruction &Instr);
   Expect<void> runBrTableOp(const AST::BrTableControlInstruction &Instr);
@@ -280,6 +334,44 @@ private:
                       const uint32_t BitWidth = sizeof(T) * 8);
   Expect<void> runMemorySizeOp(Runtime::Instance::MemoryInstance &MemInst);
   Expect<void> runMemoryGrowOp(Runtime::Instance::MemoryInstance &MemInst);
+  Expect<void> runMemoryInitOp(Runtime::StoreManager &StoreMgr,
+                               Runtime::Instance::MemoryInstance &MemInst,
+                               const AST::MemoryInstruction &Instr);
+  Expect<void> runDataDropOp(Runtime::StoreManager &StoreMgr,
+                             const AST::MemoryInstruction &Instr);
+  Expect<void> runMemoryCopyOp(Runtime::Instance::MemoryInstance &MemInst);
+  Expect<void> runMemoryFillOp(Runtime::Instance::MemoryInstance &MemInst);
+  /// ======= Table instructions =======
+  Expect<void> runTableInitOp(Runtime::StoreManager &StoreMgr,
+                              Runtime::Instance::TableInstance &TabInst,
+                              const AST::TableInstruction &Instr);
+  Expect<void> runElemDropOp(Runtime::StoreManager &StoreMgr,
+                             const AST::TableInstruction &Instr);
+  Expect<void> runTableCopyOp(Runtime::Instance::TableInstance &TabInstDst,
+                              Runtime::Instance::TableInstance &TabInstSrc);
+  Expect<void> runTableGetOp(Runtime::Instance::TableInstance &TabInst);
+  Expect<void> runTableSetOp(Runtime::Instance::TableInstance &TabInst);
+  Expect<void> runTableGrowOp(Runtime::Instance::TableInstance &TabInst);
+  Expect<void> runTableSizeOp(Runtime::Instance::TableInstance &TabInst);
+  Expect<void> runTableFillOp(Runtime::Instance::TableInstance &TabInst);
+  /// ======= Atomic instructions =======
+  template <typename T, typename TMem>
+  Expect<void> runAtomicLoadOp(Runtime::Instance::MemoryInstance &MemInst,
+                               const AST::AtomicMemoryInstruction &Instr);
+  template <typename T, typename TMem>
+  Expect<void> runAtomicStoreOp(Runtime::Instance::MemoryInstance &MemInst,
+                                const AST::AtomicMemoryInstruction &Instr);
+  template <typename T, typename TMem, typename Op>
+  Expect<void> runAtomicRMWOp(Runtime::Instance::MemoryInstance &MemInst,
+                              const AST::AtomicMemoryInstruction &Instr);
+  template <typename T, typename TMem>
+  Expect<void> runAtomicCmpxchgOp(Runtime::Instance::MemoryInstance &MemInst,
+                                  const AST::AtomicMemoryInstruction &Instr);
+  template <typename T>
+  Expect<void> runAtomicWaitOp(Runtime::Instance::MemoryInstance &MemInst,
+                               const AST::AtomicMemoryInstruction &Instr);
+  Expect<void> runAtomicNotifyOp(Runtime::Instance::MemoryInstance &MemInst,
+                                 const AST::AtomicMemoryInstruction &Instr);
   /// ======= Test and Relation Numeric instructions =======
   template <typename T> TypeU<T> runEqzOp(ValVariant &Val) const;
   template <typename T>
@@ -351,6 +443,120 @@ private:
   TypeFF<TIn, TOut> runPromoteOp(ValVariant &Val) const;
   template <typename TIn, typename TOut>
   TypeBB<TIn, TOut> runReinterpretOp(ValVariant &Val) const;
+  /// ======= SIMD Memory instructions =======
+  /// Load N lanes of TIn and extend them to TOut.
+  template <typename TIn, typename TOut>
+  Expect<void> runLoadExpandOp(Runtime::Instance::MemoryInstance &MemInst,
+                               const AST::SIMDMemoryInstruction &Instr);
+  template <typename T>
+  Expect<void> runLoadSplatOp(Runtime::Instance::MemoryInstance &MemInst,
+                              const AST::SIMDMemoryInstruction &Instr);
+  /// Load T into the lowest bytes and zero the rest. T = uint128_t loads the
+  /// whole v128 value.
+  template <typename T>
+  Expect<void> runLoadZeroOp(Runtime::Instance::MemoryInstance &MemInst,
+                             const AST::SIMDMemoryInstruction &Instr);
+  template <typename T>
+  Expect<void> runLoadLaneOp(Runtime::Instance::MemoryInstance &MemInst,
+                             const AST::SIMDMemoryInstruction &Instr);
+  /// Store the lane of T. T = uint128_t stores the whole v128 value.
+  template <typename T>
+  Expect<void> runStoreLaneOp(Runtime::Instance::MemoryInstance &MemInst,
+                              const AST::SIMDMemoryInstruction &Instr);
+  /// ======= SIMD Lane instructions =======
+  template <typename TIn, typename TOut>
+  Expect<void> runExtractLaneOp(ValVariant &Val, const uint8_t Index) const;
+  template <typename TIn, typename TOut>
+  Expect<void> runReplaceLaneOp(ValVariant &Val1, const ValVariant &Val2,
+                                const uint8_t Index) const;
+  Expect<void> runShuffleOp(ValVariant &Val1, const ValVariant &Val2,
+                            const std::array<uint8_t, 16> &Lanes) const;
+  /// ======= SIMD Numeric instructions =======
+  template <typename TIn, typename TOut>
+  Expect<void> runSplatOp(ValVariant &Val) const;
+  Expect<void> runSwizzleOp(ValVariant &Val1, const ValVariant &Val2) const;
+  template <typename T>
+  Expect<void> runVectorEqOp(ValVariant &Val1, const ValVariant &Val2) const;
+  template <typename T>
+  Expect<void> runVectorNeOp(ValVariant &Val1, const ValVariant &Val2) const;
+  template <typename T>
+  Expect<void> runVectorLtOp(ValVariant &Val1, const ValVariant &Val2) const;
+  template <typename T>
+  Expect<void> runVectorGtOp(ValVariant &Val1, const ValVariant &Val2) const;
+  template <typename T>
+  Expect<void> runVectorLeOp(ValVariant &Val1, const ValVariant &Val2) const;
+  template <typename T>
+  Expect<void> runVectorGeOp(ValVariant &Val1, const ValVariant &Val2) const;
+  Expect<void> runVectorNotOp(ValVariant &Val) const;
+  Expect<void> runVectorAndOp(ValVariant &Val1, const ValVariant &Val2) const;
+  Expect<void> runVectorAndNotOp(ValVariant &Val1,
+                                 const ValVariant &Val2) const;
+  Expect<void> runVectorOrOp(ValVariant &Val1, const ValVariant &Val2) const;
+  Expect<void> runVectorXorOp(ValVariant &Val1, const ValVariant &Val2) const;
+  Expect<void> runVectorBitSelectOp(ValVariant &Val1, const ValVariant &Val2,
+                                    const ValVariant &Val3) const;
+  Expect<void> runVectorAnyTrueOp(ValVariant &Val) const;
+  template <typename T> Expect<void> runVectorAbsOp(ValVariant &Val) const;
+  template <typename T> Expect<void> runVectorNegOp(ValVariant &Val) const;
+  Expect<void> runVectorPopcntOp(ValVariant &Val) const;
+  template <typename T> Expect<void> runVectorAllTrueOp(ValVariant &Val) const;
+  template <typename T> Expect<void> runVectorBitMaskOp(ValVariant &Val) const;
+  template <typename TIn, typename TOut>
+  Expect<void> runVectorNarrowOp(ValVariant &Val1,
+                                 const ValVariant &Val2) const;
+  template <typename T> Expect<void> runVectorCeilOp(ValVariant &Val) const;
+  template <typename T> Expect<void> runVectorFloorOp(ValVariant &Val) const;
+  template <typename T> Expect<void> runVectorTruncOp(ValVariant &Val) const;
+  template <typename T> Expect<void> runVectorNearestOp(ValVariant &Val) const;
+  template <typename T> Expect<void> runVectorSqrtOp(ValVariant &Val) const;
+  template <typename T>
+  Expect<void> runVectorShlOp(ValVariant &Val1, const ValVariant &Val2) const;
+  template <typename T>
+  Expect<void> runVectorShrOp(ValVariant &Val1, const ValVariant &Val2) const;
+  template <typename T>
+  Expect<void> runVectorAddOp(ValVariant &Val1, const ValVariant &Val2) const;
+  template <typename T>
+  Expect<void> runVectorSubOp(ValVariant &Val1, const ValVariant &Val2) const;
+  template <typename T>
+  Expect<void> runVectorMulOp(ValVariant &Val1, const ValVariant &Val2) const;
+  template <typename T>
+  Expect<void> runVectorDivOp(ValVariant &Val1, const ValVariant &Val2) const;
+  template <typename T>
+  Expect<void> runVectorAddSatOp(ValVariant &Val1,
+                                 const ValVariant &Val2) const;
+  template <typename T>
+  Expect<void> runVectorSubSatOp(ValVariant &Val1,
+                                 const ValVariant &Val2) const;
+  template <typename T>
+  Expect<void> runVectorMinOp(ValVariant &Val1, const ValVariant &Val2) const;
+  template <typename T>
+  Expect<void> runVectorMaxOp(ValVariant &Val1, const ValVariant &Val2) const;
+  template <typename T>
+  Expect<void> runVectorPMinOp(ValVariant &Val1, const ValVariant &Val2) const;
+  template <typename T>
+  Expect<void> runVectorPMaxOp(ValVariant &Val1, const ValVariant &Val2) const;
+  template <typename T>
+  Expect<void> runVectorAvgrOp(ValVariant &Val1, const ValVariant &Val2) const;
+  Expect<void> runVectorQ15MulSatOp(ValVariant &Val1,
+                                    const ValVariant &Val2) const;
+  Expect<void> runVectorDotOp(ValVariant &Val1, const ValVariant &Val2) const;
+  template <typename TIn, typename TOut>
+  Expect<void> runVectorExtAddPairwiseOp(ValVariant &Val) const;
+  /// Convert the low lanes of TIn to TOut, and zero the rest lanes.
+  template <typename TIn, typename TOut>
+  Expect<void> runVectorConvertOp(ValVariant &Val) const;
+  template <typename TIn, typename TOut>
+  Expect<void> runVectorExtendHighOp(ValVariant &Val) const;
+  template <typename TIn, typename TOut>
+  Expect<void> runVectorExtMulLowOp(ValVariant &Val1,
+                                    const ValVariant &Val2) const;
+  template <typename TIn, typename TOut>
+  Expect<void> runVectorExtMulHighOp(ValVariant &Val1,
+                                     const ValVariant &Val2) const;
+  /// Truncate the lanes of TIn to TOut with saturation, and zero the rest
+  /// lanes.
+  template <typename TIn, typename TOut>
+  Expect<void> runVectorTruncSatOp(ValVariant &Val) const;
   /// @}
 
   /// \name Run compiled functions
@@ -359,18 +565,88 @@ private:
   void call(const uint32_t FuncIndex, const ValVariant *Args, ValVariant *Rets);
   uint32_t memGrow(const uint32_t NewSize);
   uint32_t memSize();
+  void memInit(const uint32_t DataIdx, const uint32_t Dst, const uint32_t Src,
+               const uint32_t Len);
+  void dataDrop(const uint32_t DataIdx);
+  uint32_t tableSize(const uint32_t TableIdx);
+  uint32_t tableGrow(const uint32_t TableIdx, const uint64_t Ref,
+                     const uint32_t Count);
+  uint64_t tableGet(const uint32_t TableIdx, const uint32_t Idx);
+  void tableSet(const uint32_t TableIdx, const uint32_t Idx,
+                const uint64_t Ref);
+  void tableFill(const uint32_t TableIdx, const uint32_t Off,
+                 const uint64_t Ref, const uint32_t Len);
+  void tableInit(const uint32_t TableIdx, const uint32_t ElemIdx,
+                 const uint32_t Dst, const uint32_t Src, const uint32_t Len);
+  void tableCopy(const uint32_t TableIdxDst, const uint32_t TableIdxSrc,
+                 const uint32_t Dst, const uint32_t Src, const uint32_t Len);
+  void elemDrop(const uint32_t ElemIdx);
+  uint64_t refFunc(const uint32_t FuncIdx);
+  /// Resolve the callee of call_indirect. Returns the index of the function
+  /// if it is defined in the current module, or UINT32_MAX otherwise.
+  uint32_t tableGetFuncIdx(const uint32_t TableIdx, const uint32_t FuncTypeIdx,
+                           const uint32_t Idx);
+  /// Call the callee of call_indirect which is not defined in the current
+  /// module.
+  void callIndirect(const uint32_t TableIdx, const uint32_t FuncTypeIdx,
+                    const uint32_t Idx, const ValVariant *Args,
+                    ValVariant *Rets);
+  /// Get the checked function address of call_indirect.
+  uint32_t getIndirectFuncAddr(const uint32_t TableIdx,
+                               const uint32_t FuncTypeIdx, const uint32_t Idx);
+  uint32_t memAtomicNotify(const uint64_t Address, const uint32_t Count);
+  uint32_t memAtomicWait(const uint64_t Address, const uint64_t Expected,
+                         const int64_t Timeout, const uint32_t BitWidth);
 
   static void trapProxy(Interpreter *This, uint32_t Status);
   static void callProxy(Interpreter *This, const uint32_t FuncIndex,
                         const ValVariant *Args, ValVariant *Rets);
   static uint32_t memGrowProxy(Interpreter *This, const uint32_t NewSize);
   static uint32_t memSizeProxy(Interpreter *This);
+  static void memInitProxy(Interpreter *This, const uint32_t DataIdx,
+                           const uint32_t Dst, const uint32_t Src,
+                           const uint32_t Len);
+  static void dataDropProxy(Interpreter *This, const uint32_t DataIdx);
+  static uint32_t tableSizeProxy(Interpreter *This, const uint32_t TableIdx);
+  static uint32_t tableGrowProxy(Interpreter *This, const uint32_t TableIdx,
+                                 const uint64_t Ref, const uint32_t Count);
+  static uint64_t tableGetProxy(Interpreter *This, const uint32_t TableIdx,
+                                const uint32_t Idx);
+  static void tableSetProxy(Interpreter *This, const uint32_t TableIdx,
+                            const uint32_t Idx, const uint64_t Ref);
+  static void tableFillProxy(Interpreter *This, const uint32_t TableIdx,
+                             const uint32_t Off, const uint64_t Ref,
+                             const uint32_t Len);
+  static void tableInitProxy(Interpreter *This, const uint32_t TableIdx,
+                             const uint32_t ElemIdx, const uint32_t Dst,
+                             const uint32_t Src, const uint32_t Len);
+  static void tableCopyProxy(Interpreter *This, const uint32_t TableIdxDst,
+                             const uint32_t TableIdxSrc, const uint32_t Dst,
+                             const uint32_t Src, const uint32_t Len);
+  static void elemDropProxy(Interpreter *This, const uint32_t ElemIdx);
+  static uint64_t refFuncProxy(Interpreter *This, const uint32_t FuncIdx);
+  static uint32_t tableGetFuncIdxProxy(Interpreter *This,
+                                       const uint32_t TableIdx,
+                                       const uint32_t FuncTypeIdx,
+                                       const uint32_t Idx);
+  static void callIndirectProxy(Interpreter *This, const uint32_t TableIdx,
+                                const uint32_t FuncTypeIdx, const uint32_t Idx,
+                                const ValVariant *Args, ValVariant *Rets);
+  static uint32_t memAtomicNotifyProxy(Interpreter *This,
+                                       const uint64_t Address,
+                                       const uint32_t Count);
+  static uint32_t memAtomicWaitProxy(Interpreter *This, const uint64_t Address,
+                                     const uint64_t Expected,
+                                     const int64_t Timeout,
+                                     const uint32_t BitWidth);
   /// @}
 
   enum class InstantiateMode : uint8_t { Instantiate = 0, ImportWasm };
 
   /// Instantiate mode
   InstantiateMode InsMode;
+  /// Validation of lazy loaded function bodies.
+  AST::CodeValidator CodeValidator;
   /// Stack
   Runtime::StackManager StackMgr;
   /// Instruction provider
@@ -380,13 +656,18 @@ private:
   /// jmp_buf for trap.
   std::jmp_buf TrapJump;
   Runtime::StoreManager *CurrentStore;
+  /// Thread-local global instances, indexed by the global address in store.
+  std::map<uint32_t, std::unique_ptr<Runtime::Instance::GlobalInstance>>
+      ThreadGlobInsts;
 };
 
 } // namespace Interpreter
 } // namespace SSVM
 
+#include "engine/atomic.ipp"
 #include "engine/binary_numeric.ipp"
 #include "engine/cast_numeric.ipp"
 #include "engine/memory.ipp"
 #include "engine/relation_numeric.ipp"
+#include "engine/simd_numeric.ipp"
 #include "engine/unary_numeric.ipp"
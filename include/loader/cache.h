@@ -0,0 +1,81 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/loader/cache.h - Module cache file definition ----------------===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the declaration of the module cache file, which records
+/// the validation result of a WASM module. A module found in the cache skips
+/// the validation and decodes the function bodies on demand. The module is
+/// still parsed when loaded, since the cache holds no lowered form of it.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "common/errcode.h"
+#include "loader/filemgr.h"
+#include "support/span.h"
+
+#include <cstdint>
+#include <string>
+
+namespace SSVM {
+namespace Loader {
+
+/// Header of module cache file, followed by the module in WASM binary format.
+/// Integers are in host byte order, since the cache is not portable.
+struct CacheHeader {
+  uint8_t Magic[8];
+  /// Version of cache format.
+  uint32_t Format;
+  /// Bit flags. See kCacheValidated.
+  uint32_t Flags;
+  /// Version of SSVM which validated the module.
+  uint64_t BuildVersion;
+  /// Hash and size of the module. See "include/support/hash.h".
+  uint64_t ModuleHash;
+  uint64_t ModuleSize;
+  /// Hash of the fields above.
+  uint64_t Checksum;
+};
+static_assert(sizeof(CacheHeader) == 48);
+
+/// The module passed validation.
+inline constexpr uint32_t kCacheValidated = 1U << 0;
+
+/// Check if the data starts with the magic of module cache.
+bool isModuleCache(Span<const Byte> Data);
+
+/// Verify the header of module cache file without reading the module.
+///
+/// \param Data the head of cache file, at least the size of the header.
+///
+/// \returns the header when success, ErrMsg when the header is corrupted or
+/// made by another version.
+Expect<CacheHeader> readCacheHeader(Span<const Byte> Data);
+
+/// Verify module cache and get the module in it.
+///
+/// \param Data the whole cache file.
+///
+/// \returns the module bytes sharing the ownership of Data when success,
+/// ErrMsg when the cache is corrupted or made by another version.
+Expect<SharedBytes> readModuleCache(const SharedBytes &Data);
+
+/// Write module cache file of a validated module. The file is replaced
+/// atomically.
+///
+/// \param Path the path of cache file.
+/// \param Wasm the module in WASM binary format.
+///
+/// \returns void when success, ErrMsg when failed.
+Expect<void> writeModuleCache(const std::string &Path, Span<const Byte> Wasm);
+
+/// Get the path of cache file in cache directory, which is keyed by the module
+/// hash.
+std::string getModuleCachePath(const std::string &Dir, uint64_t ModuleHash);
+
+} // namespace Loader
+} // namespace SSVM
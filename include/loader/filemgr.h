@@ -15,13 +15,44 @@
 #include "common/errcode.h"
 #include "common/types.h"
 #include "common/value.h"
+#include "support/span.h"
 
 #include <fstream>
+#include <memory>
 #include <string>
 #include <vector>
 
 namespace SSVM {
 
+/// Read-only byte range which shares ownership of its underlying buffer.
+///
+/// The buffer is either a vector owned by this object or a region of a mapped
+/// file, so payloads can be kept without copying them out of the mapping.
+class SharedBytes {
+public:
+  SharedBytes() = default;
+  SharedBytes(Bytes &&Data)
+      : Owner(std::make_shared<const Bytes>(std::move(Data))),
+        View(*std::static_pointer_cast<const Bytes>(Owner)) {}
+  SharedBytes(std::shared_ptr<const void> Holder, Span<const Byte> Range)
+      : Owner(std::move(Holder)), View(Range) {}
+
+  Span<const Byte> getSpan() const { return View; }
+  /// Sub-range which shares the ownership of this buffer.
+  SharedBytes slice(size_t Offset, size_t Length) const {
+    return SharedBytes(Owner, View.subspan(Offset, Length));
+  }
+  const Byte *data() const { return View.data(); }
+  size_t size() const { return View.size(); }
+  bool empty() const { return View.empty(); }
+  auto begin() const { return View.begin(); }
+  auto end() const { return View.end(); }
+
+private:
+  std::shared_ptr<const void> Owner;
+  Span<const Byte> View;
+};
+
 /// File manager interface.
 class FileMgr {
 public:
@@ -39,6 +70,10 @@ public:
   /// Read number of bytes into a vector.
   virtual Expect<Bytes> readBytes(size_t SizeToRead) = 0;
 
+  /// Read number of bytes without copying them when the manager owns a shared
+  /// buffer. The default implementation copies through readBytes().
+  virtual Expect<SharedBytes> readSharedBytes(size_t SizeToRead);
+
   /// Read an unsigned int.
   virtual Expect<uint32_t> readU32() = 0;
 
@@ -107,6 +142,7 @@ public:
   Expect<void> setCode(const Bytes &CodeData) override;
   Expect<Byte> readByte() override;
   Expect<Bytes> readBytes(size_t SizeToRead) override;
+  Expect<SharedBytes> readSharedBytes(size_t SizeToRead) override;
   Expect<uint32_t> readU32() override;
   Expect<uint64_t> readU64() override;
   Expect<int32_t> readS32() override;
@@ -116,17 +152,67 @@ public:
   Expect<std::string> readName() override;
   uint32_t getOffset() override { return Pos; }
 
+  /// Set the binary data by sharing the buffer without copying.
+  Expect<void> setCode(SharedBytes CodeData);
+
   uint32_t getRemainSize() const { return Code.size() - Pos; }
   void clearBuffer() {
-    Code.clear();
+    Code = SharedBytes();
     Pos = 0;
     Status = ErrCode::EndOfFile;
   }
 
 private:
-  /// Reference to input vector.
-  Bytes Code;
+  /// Input buffer, shared with the payloads read from it.
+  SharedBytes Code;
   uint32_t Pos = 0;
 };
 
+/// Memory-mapped version of file manager.
+///
+/// Maps the whole file read-only and decodes directly from the mapping. The
+/// mapping stays alive as long as any SharedBytes read from it.
+class FileMgrMmap : public FileMgr {
+public:
+  FileMgrMmap() = default;
+
+  /// Inheritted from FileMgr.
+  Expect<void> setPath(const std::string &FilePath) override;
+  Expect<void> setCode(const Bytes &CodeData) override {
+    return Unexpect(ErrCode::InvalidPath);
+  }
+  Expect<Byte> readByte() override;
+  Expect<Bytes> readBytes(size_t SizeToRead) override;
+  Expect<SharedBytes> readSharedBytes(size_t SizeToRead) override;
+  Expect<uint32_t> readU32() override;
+  Expect<uint64_t> readU64() override;
+  Expect<int32_t> readS32() override;
+  Expect<int64_t> readS64() override;
+  Expect<float> readF32() override;
+  Expect<double> readF64() override;
+  Expect<std::string> readName() override;
+  uint32_t getOffset() override { return Pos; }
+
+  size_t getRemainSize() const { return Size - Pos; }
+
+  /// Release the mapping held by this manager.
+  void clearBuffer() {
+    Map.reset();
+    Data = nullptr;
+    Size = 0;
+    Pos = 0;
+    Status = ErrCode::InvalidPath;
+  }
+
+private:
+  /// Check the status and the remaining size before reading.
+  Expect<void> checkRead(size_t SizeToRead);
+
+  /// Mapped region, unmapped when the last reference is released.
+  std::shared_ptr<const Byte> Map;
+  const Byte *Data = nullptr;
+  size_t Size = 0;
+  size_t Pos = 0;
+};
+
 } // namespace SSVM
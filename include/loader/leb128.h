@@ -0,0 +1,144 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/loader/leb128.h - LEB128 decoding functions ------------------===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the LEB128 decoding functions on raw byte ranges, which
+/// are used by the file managers that hold the whole module in memory.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "common/errcode.h"
+#include "common/types.h"
+#include "common/value.h"
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+namespace SSVM {
+namespace LEB128 {
+
+namespace detail {
+
+/// Decode one LEB128 number byte by byte. Used near the end of the range and
+/// for encodings longer than 8 bytes.
+template <typename T>
+inline Expect<T> decodeSlow(const Byte *&Ptr, const Byte *End) {
+  using U = std::make_unsigned_t<T>;
+  constexpr uint32_t kBits = sizeof(T) * 8;
+  U Result = 0;
+  uint32_t Offset = 0;
+  uint8_t Val = 0x80;
+  while (Val & 0x80) {
+    if (Ptr >= End) {
+      return Unexpect(ErrCode::EndOfFile);
+    }
+    Val = *Ptr++;
+    if (Offset < kBits) {
+      Result |= static_cast<U>(Val & UINT8_C(0x7F)) << Offset;
+    }
+    Offset += 7;
+  }
+  if constexpr (std::is_signed_v<T>) {
+    if (Val & 0x40 && Offset < kBits) {
+      Result |= ~U(0) << Offset;
+    }
+  }
+  return static_cast<T>(Result);
+}
+
+/// Decode one LEB128 number which has at least 8 readable bytes. The length is
+/// found from the continuation bits of one 8-byte load, and the payload bits
+/// are gathered without a per-byte loop. Return false if the encoding is
+/// longer than 8 bytes.
+template <typename T> inline bool decodeFast(const Byte *&Ptr, T &Out) {
+  using U = std::make_unsigned_t<T>;
+  uint64_t Word;
+  std::memcpy(&Word, Ptr, sizeof(Word));
+  const uint64_t Stops = ~Word & UINT64_C(0x8080808080808080);
+  if (Stops == 0) {
+    return false;
+  }
+  /// Bit index of the continuation bit of the last byte, plus one.
+  const uint32_t EndBit = __builtin_ctzll(Stops) + 1;
+  const uint32_t Length = EndBit / 8;
+  const uint64_t Bytes =
+      EndBit == 64 ? Word : Word & ((UINT64_C(1) << EndBit) - 1);
+#if defined(__BMI2__)
+  uint64_t Value = _pext_u64(Bytes, UINT64_C(0x7F7F7F7F7F7F7F7F));
+#else
+  uint64_t Value = (Bytes & UINT64_C(0x000000000000007F)) |
+                   ((Bytes & UINT64_C(0x0000000000007F00)) >> 1) |
+                   ((Bytes & UINT64_C(0x00000000007F0000)) >> 2) |
+                   ((Bytes & UINT64_C(0x000000007F000000)) >> 3) |
+                   ((Bytes & UINT64_C(0x0000007F00000000)) >> 4) |
+                   ((Bytes & UINT64_C(0x00007F0000000000)) >> 5) |
+                   ((Bytes & UINT64_C(0x007F000000000000)) >> 6) |
+                   ((Bytes & UINT64_C(0x7F00000000000000)) >> 7);
+#endif
+  if constexpr (std::is_signed_v<T>) {
+    const uint32_t Offset = Length * 7;
+    if ((Bytes >> (EndBit - 2)) & 1U) {
+      Value |= ~UINT64_C(0) << Offset;
+    }
+  }
+  Out = static_cast<T>(static_cast<U>(Value));
+  Ptr += Length;
+  return true;
+}
+
+template <typename T>
+inline Expect<T> decode(const Byte *&Ptr, const Byte *End) {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  if (End - Ptr >= 8) {
+    T Result;
+    if (decodeFast(Ptr, Result)) {
+      return Result;
+    }
+  }
+#endif
+  return decodeSlow<T>(Ptr, End);
+}
+
+} // namespace detail
+
+/// Decode an unsigned 32-bit LEB128 number from [Ptr, End) and advance Ptr.
+///
+/// The range is checked once when at least 8 bytes remain, and byte by byte
+/// otherwise.
+///
+/// \param Ptr the reading position, moved past the decoded number.
+/// \param End the end of the readable range.
+///
+/// \returns decoded number when success, ErrCode::EndOfFile when the number is
+/// truncated.
+inline Expect<uint32_t> readU32(const Byte *&Ptr, const Byte *End) {
+  return detail::decode<uint32_t>(Ptr, End);
+}
+
+/// Decode an unsigned 64-bit LEB128 number. See readU32().
+inline Expect<uint64_t> readU64(const Byte *&Ptr, const Byte *End) {
+  return detail::decode<uint64_t>(Ptr, End);
+}
+
+/// Decode a signed 32-bit LEB128 number. See readU32().
+inline Expect<int32_t> readS32(const Byte *&Ptr, const Byte *End) {
+  return detail::decode<int32_t>(Ptr, End);
+}
+
+/// Decode a signed 64-bit LEB128 number. See readU32().
+inline Expect<int64_t> readS64(const Byte *&Ptr, const Byte *End) {
+  return detail::decode<int64_t>(Ptr, End);
+}
+
+} // namespace LEB128
+} // namespace SSVM
@@ -33,14 +33,40 @@ public:
   /// Parse module from file path.
   Expect<std::unique_ptr<AST::Module>> parseModule(const std::string &FilePath);
 
+  /// Parse module from file descriptor of pipe or socket. The module is
+  /// parsed while its bytes are arriving. See "include/loader/stream.h".
+  Expect<std::unique_ptr<AST::Module>> parseModule(const int Fd);
+
   /// Parse module from byte code.
   Expect<std::unique_ptr<AST::Module>>
   parseModule(const std::vector<uint8_t> &Code);
 
+  /// Setter of lazy loading. When set, function bodies of parsed modules are
+  /// decoded on their first call instead. See "include/common/ast/section.h".
+  void setLazyCode(const bool Lazy) { IsLazyCode = Lazy; }
+
+  /// Setter of module cache directory. When set, parsed modules are looked up
+  /// in the cache by their hash. See "include/loader/cache.h".
+  void setCacheDir(const std::string &Dir) { CacheDir = Dir; }
+
+  /// Store module cache of a validated module, which is parsed without a cache
+  /// hit.
+  Expect<void> saveCache(const AST::Module &Mod);
+
 private:
-  FileMgrFStream FSMgr;
+  /// Parse module from WASM binary, which is trusted only if it is found in
+  /// the cache directory.
+  Expect<std::unique_ptr<AST::Module>> parseBinary(SharedBytes Data,
+                                                   const bool LazyCode);
+
+  /// Size of reading from file descriptor.
+  static inline constexpr size_t kStreamChunkSize = 64 * 1024;
+
+  FileMgrMmap FMMgr;
   FileMgrVector FVMgr;
   LDMgr LMgr;
+  bool IsLazyCode = false;
+  std::string CacheDir;
 };
 
 } // namespace Loader
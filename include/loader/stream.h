@@ -0,0 +1,82 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/loader/stream.h - Streaming loader class definition ----------===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the declaration of the StreamLoader class, which parses
+/// WASM module from byte chunks while the rest of the bytes is arriving.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "common/ast/module.h"
+#include "common/errcode.h"
+#include "support/span.h"
+
+#include <memory>
+#include <vector>
+
+namespace SSVM {
+namespace Loader {
+
+/// Incremental module parser.
+///
+/// Every section is parsed as soon as its last byte arrives. In the code
+/// section, function bodies are handed over to the parser, and to the thread
+/// pool if there are enough of them, as soon as each body arrives.
+class StreamLoader {
+public:
+  StreamLoader();
+  ~StreamLoader() = default;
+
+  /// Setter of lazy loading. See "include/loader/loader.h".
+  void setLazyCode(const bool Lazy) { Mod->setLazyCode(Lazy); }
+
+  /// Append bytes and parse the completed parts.
+  ///
+  /// \param Chunk the next bytes of the module.
+  ///
+  /// \returns void when success, ErrMsg when failed. Later calls keep
+  /// returning the same error.
+  Expect<void> feed(Span<const Byte> Chunk);
+
+  /// Finish loading after the last byte arrives.
+  ///
+  /// \returns the loaded module when success, ErrMsg when failed.
+  Expect<std::unique_ptr<AST::Module>> finish();
+
+private:
+  enum class State : uint8_t { Header, Section, CodeCount, CodeBody };
+
+  /// Parse the completed parts of buffer.
+  Expect<void> parse();
+  /// Parse the completed parts of code section. Return false when waiting
+  /// for more bytes, or true when the code section is finished.
+  Expect<bool> parseCode();
+  /// Parse the batched code segments.
+  Expect<void> flushCode();
+
+  /// Batched code segment size above which the batch is parsed before more
+  /// bytes arrive.
+  static inline constexpr size_t kFlushSize = 64 * 1024;
+
+  std::unique_ptr<AST::Module> Mod;
+  ErrCode Status = ErrCode::Success;
+  State St = State::Header;
+  /// Received bytes not parsed yet, starting at the offset Pos.
+  Bytes Buffer;
+  size_t Pos = 0;
+  /// Code segments left to read and the buffer offset of code section end.
+  uint32_t CodeLeft = 0;
+  size_t CodeEnd = 0;
+  /// Code segments read but not parsed yet.
+  std::vector<std::unique_ptr<AST::CodeSegment>> Segs;
+  std::vector<SharedBytes> Bodies;
+  size_t BodySize = 0;
+};
+
+} // namespace Loader
+} // namespace SSVM
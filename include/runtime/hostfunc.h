@@ -17,6 +17,9 @@
 #include "stackmgr.h"
 #include "support/span.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <memory>
 #include <tuple>
 #include <vector>
@@ -24,6 +27,94 @@
 namespace SSVM {
 namespace Runtime {
 
+/// Call statistics of a host function, which are recorded only when enabled.
+///
+/// Guest threads may call the same host function at the same time, so the
+/// counters are relaxed atomics.
+class HostFuncStats {
+public:
+  /// Buckets of the latency histogram. Bucket I counts the calls taking less
+  /// than 2^I nanoseconds and not less than 2^(I-1), and the last one counts
+  /// all the longer calls.
+  static inline constexpr const size_t kHistogramSize = 40;
+
+  /// Setter and getter of recording. Enable it before running the guest.
+  void setEnabled(bool Enable) noexcept { Enabled = Enable; }
+  bool isEnabled() const noexcept { return Enabled; }
+
+  /// Record a call with its latency.
+  void recordCall(uint64_t Nanoseconds) noexcept {
+    Calls.fetch_add(1, std::memory_order_relaxed);
+    TotalTime.fetch_add(Nanoseconds, std::memory_order_relaxed);
+    const size_t Bucket =
+        Nanoseconds == 0 ? 0 : 64 - __builtin_clzll(Nanoseconds);
+    Histogram[std::min(Bucket, kHistogramSize - 1)].fetch_add(
+        1, std::memory_order_relaxed);
+  }
+  /// Record the bytes moved into the linear memory.
+  void addBytesIn(uint64_t Bytes) noexcept {
+    if (Enabled) {
+      BytesIn.fetch_add(Bytes, std::memory_order_relaxed);
+    }
+  }
+  /// Record the bytes moved out of the linear memory.
+  void addBytesOut(uint64_t Bytes) noexcept {
+    if (Enabled) {
+      BytesOut.fetch_add(Bytes, std::memory_order_relaxed);
+    }
+  }
+
+  uint64_t getCalls() const noexcept {
+    return Calls.load(std::memory_order_relaxed);
+  }
+  /// Getter of the total latency in nanoseconds.
+  uint64_t getTotalTime() const noexcept {
+    return TotalTime.load(std::memory_order_relaxed);
+  }
+  uint64_t getBytesIn() const noexcept {
+    return BytesIn.load(std::memory_order_relaxed);
+  }
+  uint64_t getBytesOut() const noexcept {
+    return BytesOut.load(std::memory_order_relaxed);
+  }
+  uint64_t getHistogram(size_t Bucket) const noexcept {
+    return Histogram[Bucket].load(std::memory_order_relaxed);
+  }
+  /// Get the upper bound in nanoseconds of the latency percentile, from the
+  /// histogram.
+  uint64_t getPercentile(double Percent) const noexcept {
+    const uint64_t Target =
+        static_cast<uint64_t>(static_cast<double>(getCalls()) * Percent / 100);
+    uint64_t Count = 0;
+    for (size_t I = 0; I < kHistogramSize; ++I) {
+      Count += getHistogram(I);
+      if (Count > Target) {
+        return UINT64_C(1) << I;
+      }
+    }
+    return UINT64_C(1) << (kHistogramSize - 1);
+  }
+
+  /// Clear the counters.
+  void reset() noexcept {
+    Calls.store(0, std::memory_order_relaxed);
+    TotalTime.store(0, std::memory_order_relaxed);
+    BytesIn.store(0, std::memory_order_relaxed);
+    BytesOut.store(0, std::memory_order_relaxed);
+    for (auto &Bucket : Histogram) {
+      Bucket.store(0, std::memory_order_relaxed);
+    }
+  }
+
+private:
+  bool Enabled = false;
+  std::atomic<uint64_t> Calls = 0;
+  std::atomic<uint64_t> TotalTime = 0;
+  std::atomic<uint64_t> BytesIn = 0;
+  std::atomic<uint64_t> BytesOut = 0;
+  std::array<std::atomic<uint64_t>, kHistogramSize> Histogram = {};
+};
+
 class HostFunctionBase {
 public:
   HostFunctionBase() = delete;
@@ -39,9 +130,14 @@ public:
   /// Getter of host function cost.
   uint64_t getCost() const { return Cost; }
 
+  /// Getter of call statistics.
+  HostFuncStats &getStats() { return Stats; }
+  const HostFuncStats &getStats() const { return Stats; }
+
 protected:
   Instance::FType FuncType;
   const uint64_t Cost;
+  HostFuncStats Stats;
 };
 
 template <typename T> class HostFunction : public HostFunctionBase {
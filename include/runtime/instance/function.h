@@ -12,10 +12,13 @@
 #pragma once
 
 #include "common/ast/instruction.h"
+#include "common/ast/segment.h"
 #include "module.h"
 #include "runtime/hostfunc.h"
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -31,16 +34,17 @@ public:
   /// Constructor for native function.
   FunctionInstance(const uint32_t ModAddr, const FType &Type,
                    const std::vector<std::pair<uint32_t, ValType>> &Locs,
-                   const AST::InstrVec &Expr)
+                   const AST::InstrVec &Expr, std::shared_ptr<const Arena> Pool)
       : IsHostFunction(false), FuncType(Type), ModuleAddr(ModAddr),
-        Locals(Locs) {
-    /// Copy instructions
-    for (auto &It : Expr) {
-      if (auto Res = makeInstructionNode(*It.get())) {
-        Instrs.push_back(std::move(*Res));
-      }
-    }
-  }
+        Locals(Locs), Instrs(Expr), InstrPool(std::move(Pool)) {}
+  /// Constructor for native function in lazy loading. The body is decoded and
+  /// validated on the first call by loadBody().
+  FunctionInstance(const uint32_t ModAddr, const FType &Type,
+                   const uint32_t TypeIdx, SharedBytes Body,
+                   std::shared_ptr<const AST::CodeValidator> Validator)
+      : IsHostFunction(false), FuncType(Type), ModuleAddr(ModAddr),
+        IsLoaded(false), LazyTypeIdx(TypeIdx), LazyBody(std::move(Body)),
+        LazyValidator(std::move(Validator)) {}
   /// Constructor for host function. Module address will not be used.
   FunctionInstance(std::unique_ptr<HostFunctionBase> &Func)
       : IsHostFunction(true), FuncType(Func->getFuncType()), ModuleAddr(0),
@@ -61,11 +65,40 @@ public:
 
   /// Getter of function body instrs.
   const std::vector<std::pair<uint32_t, ValType>> &getLocals() const {
-    return Locals;
+    return LazyCode ? LazyCode->getLocals() : Locals;
   }
 
   /// Getter of function body instrs.
-  const AST::InstrVec &getInstrs() const { return Instrs; }
+  const AST::InstrVec &getInstrs() const {
+    return LazyCode ? LazyCode->getInstrs() : Instrs;
+  }
+
+  /// Getter of checking the function body is ready to run.
+  bool isLoaded() const { return IsLoaded.load(std::memory_order_acquire); }
+
+  /// Decode and validate the function body in lazy loading, and cache the
+  /// result. Do nothing if the body is already loaded.
+  Expect<void> loadBody() const {
+    if (isLoaded()) {
+      return {};
+    }
+    std::unique_lock Lock(LazyMutex);
+    if (isLoaded()) {
+      return {};
+    }
+    auto Code = std::make_unique<AST::CodeSegment>();
+    if (auto Res = Code->loadBody(LazyBody); !Res) {
+      return Unexpect(Res);
+    }
+    if (auto Res = (*LazyValidator)(*Code.get(), LazyTypeIdx); !Res) {
+      return Unexpect(Res);
+    }
+    LazyCode = std::move(Code);
+    LazyBody = SharedBytes();
+    LazyValidator.reset();
+    IsLoaded.store(true, std::memory_order_release);
+    return {};
+  }
 
   /// Getter of symbol
   CompiledFunction getSymbol() const { return Symbol; }
@@ -83,10 +116,22 @@ private:
   /// @{
   uint32_t ModuleAddr;
   const std::vector<std::pair<uint32_t, ValType>> Locals;
+  /// Instructions are shared with the module and kept alive by the arena.
   AST::InstrVec Instrs;
+  std::shared_ptr<const Arena> InstrPool;
   CompiledFunction Symbol = nullptr;
   /// @}
 
+  /// \name Data of function instance for lazy loaded function.
+  /// @{
+  mutable std::atomic<bool> IsLoaded = true;
+  mutable std::mutex LazyMutex;
+  const uint32_t LazyTypeIdx = 0;
+  mutable SharedBytes LazyBody;
+  mutable std::shared_ptr<const AST::CodeValidator> LazyValidator;
+  mutable std::unique_ptr<AST::CodeSegment> LazyCode;
+  /// @}
+
   /// \name Data of function instance for host function.
   /// @{
   std::unique_ptr<HostFunctionBase> HostFunc;
@@ -15,12 +15,18 @@
 #include "common/errcode.h"
 #include "common/value.h"
 #include "support/casting.h"
+#include "support/futex.h"
 #include "support/span.h"
 
 #include <algorithm>
+#include <atomic>
 #include <boost/align/aligned_allocator.hpp>
+#include <chrono>
 #include <cstring>
+#include <deque>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -33,13 +39,23 @@ public:
   static inline constexpr const uint64_t kPageSize = UINT64_C(65536);
   MemoryInstance() = delete;
   MemoryInstance(const AST::Limit &Lim)
-      : HasMaxPage(Lim.hasMax()), MinPage(Lim.getMin()), MaxPage(Lim.getMax()),
-        CurrPage(Lim.getMin()), Data(CurrPage * kPageSize) {}
+      : IsShared(Lim.isShared()), HasMaxPage(Lim.hasMax()),
+        MinPage(Lim.getMin()), MaxPage(Lim.getMax()), CurrPage(Lim.getMin()) {
+    /// Shared memory reserves its maximum size, so that growing never moves
+    /// the data which other threads are accessing.
+    if (IsShared) {
+      Data.reserve(std::min(MaxPage, UINT32_C(65536)) * kPageSize);
+    }
+    Data.resize(CurrPage * kPageSize);
+  }
   virtual ~MemoryInstance() noexcept = default;
 
   /// Get page size of memory.data
   uint32_t getDataPageSize() const noexcept { return CurrPage; }
 
+  /// Getter of shared memory flag.
+  bool isShared() const noexcept { return IsShared; }
+
   /// Getter of limit definition.
   bool getHasMax() const noexcept { return HasMaxPage; }
 
@@ -60,14 +76,19 @@ public:
     if (HasMaxPage) {
       MaxPageCaped = std::min(MaxPage, MaxPageCaped);
     }
-    if (Count + CurrPage > MaxPageCaped) {
+    /// Threads sharing the memory may grow it at the same time.
+    std::unique_lock Lock(GrowMutex);
+    if (static_cast<uint64_t>(Count) + CurrPage.load() > MaxPageCaped) {
       return Unexpect(ErrCode::MemoryOutOfBounds);
     }
-    CurrPage += Count;
-    Data.resize(CurrPage * kPageSize);
+    const uint32_t NewPage = CurrPage.load(std::memory_order_relaxed) + Count;
+    Data.resize(NewPage * kPageSize);
     if (Symbol) {
       *Symbol = Data.data();
     }
+    /// Publish the new bound after the pages are ready. The accesses of other
+    /// threads check against the page count, never the vector size.
+    CurrPage.store(NewPage, std::memory_order_release);
     return {};
   }
 
@@ -89,8 +110,8 @@ public:
     }
 
     /// Check input data validation.
-    if ((Slice.size() > 0 && Start >= Slice.size()) ||
-        Start + Length > Slice.size()) {
+    if (static_cast<uint64_t>(Start) + static_cast<uint64_t>(Length) >
+        Slice.size()) {
       return Unexpect(ErrCode::MemoryOutOfBounds);
     }
 
@@ -102,6 +123,32 @@ public:
     return {};
   }
 
+  /// Copy Data[Src : Src + Length - 1] to Data[Dst :], which may overlap.
+  Expect<void> copyBytes(const uint32_t Dst, const uint32_t Src,
+                         const uint32_t Length) {
+    /// Check memory boundary of both ranges.
+    if (!checkDataSize(Dst, Length) || !checkDataSize(Src, Length)) {
+      return Unexpect(ErrCode::MemoryOutOfBounds);
+    }
+    if (Length > 0) {
+      std::memmove(&Data[Dst], &Data[Src], Length);
+    }
+    return {};
+  }
+
+  /// Fill Data[Offset : Offset + Length - 1] with Val.
+  Expect<void> fillBytes(const uint32_t Offset, const uint8_t Val,
+                         const uint32_t Length) {
+    /// Check memory boundary.
+    if (!checkDataSize(Offset, Length)) {
+      return Unexpect(ErrCode::MemoryOutOfBounds);
+    }
+    if (Length > 0) {
+      std::memset(&Data[Offset], Val, Length);
+    }
+    return {};
+  }
+
   /// Get an uint8 array from Data[Offset : Offset + Length - 1]
   Expect<void> getArray(uint8_t *Arr, const uint32_t Offset,
                         const uint32_t Length, const bool IsReverse = false) {
@@ -236,6 +283,120 @@ public:
     return {};
   }
 
+  /// Get pointer of the atomic access to Data[Offset : Offset + sizeof(T)].
+  ///
+  /// \param Offset the start offset in data array.
+  ///
+  /// \returns pointer when success, ErrCode when out of bounds or unaligned.
+  template <typename T>
+  typename std::enable_if_t<std::is_unsigned_v<T>, Expect<T *>>
+  getAtomicPointer(const uint32_t Offset) {
+    if (!checkDataSize(Offset, sizeof(T))) {
+      return Unexpect(ErrCode::MemoryOutOfBounds);
+    }
+    if (Offset % sizeof(T) != 0) {
+      return Unexpect(ErrCode::UnalignedAtomicAccess);
+    }
+    return reinterpret_cast<T *>(&Data[Offset]);
+  }
+
+  /// Block the thread until notified, if Data[Offset] equals to Expected.
+  ///
+  /// \param Offset the start offset in data array.
+  /// \param Expected the value to compare with.
+  /// \param Timeout the relative timeout in nanoseconds, or negative for no
+  /// timeout.
+  ///
+  /// \returns 0 when notified, 1 when the value is not equal, 2 when timed
+  /// out, and ErrCode when failed.
+  template <typename T>
+  typename std::enable_if_t<std::is_unsigned_v<T>, Expect<uint32_t>>
+  atomicWait(const uint32_t Offset, const T Expected, const int64_t Timeout) {
+    if (!IsShared) {
+      return Unexpect(ErrCode::ExpectSharedMemory);
+    }
+    T *Ptr;
+    if (auto Res = getAtomicPointer<T>(Offset)) {
+      Ptr = *Res;
+    } else {
+      return Unexpect(Res);
+    }
+
+    /// Compare and enqueue under the lock, so that a notify after the
+    /// comparison always finds this waiter.
+    WaitNode Node;
+    {
+      std::unique_lock Lock(WaitMutex);
+      if (__atomic_load_n(Ptr, __ATOMIC_SEQ_CST) != Expected) {
+        return 1;
+      }
+      Waiters[Offset].push_back(&Node);
+    }
+
+    /// Clamp the timeout to avoid the overflow of the deadline.
+    const auto Deadline =
+        std::chrono::steady_clock::now() +
+        std::chrono::nanoseconds(std::min(Timeout, INT64_MAX / 2));
+    while (Node.Woken.load() == 0) {
+      int64_t Remain = -1;
+      if (Timeout >= 0) {
+        Remain = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                     Deadline - std::chrono::steady_clock::now())
+                     .count();
+        if (Remain <= 0) {
+          break;
+        }
+      }
+      futexWait(Node.Woken, 0, Remain);
+    }
+
+    /// The notifier dequeues the node under the lock, so the node is removed
+    /// here only when timed out.
+    std::unique_lock Lock(WaitMutex);
+    if (Node.Woken.load() != 0) {
+      return 0;
+    }
+    auto &Queue = Waiters[Offset];
+    Queue.erase(std::find(Queue.begin(), Queue.end(), &Node));
+    if (Queue.empty()) {
+      Waiters.erase(Offset);
+    }
+    return 2;
+  }
+
+  /// Wake at most Count threads waiting on Data[Offset].
+  ///
+  /// \param Offset the start offset in data array.
+  /// \param Count the maximum number of threads to wake.
+  ///
+  /// \returns the number of woken threads, or ErrCode when failed.
+  Expect<uint32_t> atomicNotify(const uint32_t Offset, const uint32_t Count) {
+    if (auto Res = getAtomicPointer<uint32_t>(Offset); !Res) {
+      return Unexpect(Res);
+    }
+    if (!IsShared) {
+      return 0;
+    }
+    std::unique_lock Lock(WaitMutex);
+    auto It = Waiters.find(Offset);
+    if (It == Waiters.end()) {
+      return 0;
+    }
+    auto &Queue = It->second;
+    uint32_t Woken = 0;
+    while (Woken < Count && !Queue.empty()) {
+      WaitNode *Node = Queue.front();
+      Queue.pop_front();
+      Node->Woken.store(1);
+      futexWake(Node->Woken, 1);
+      ++Woken;
+    }
+    if (Queue.empty()) {
+      Waiters.erase(It);
+    }
+    return Woken;
+  }
+
   /// Getter of symbol
   void *getSymbol() const { return Symbol; }
   /// Setter of symbol
@@ -245,22 +406,37 @@ public:
   }
 
 private:
-  /// Check access size is valid and adjust vector.
+  /// Check access size is valid. The bound is the atomic page count, because
+  /// other threads may be growing the shared memory.
   bool checkDataSize(uint32_t Offset, uint32_t Length) const noexcept {
     const uint64_t AccessLen =
         static_cast<uint64_t>(Offset) + static_cast<uint64_t>(Length);
-    return AccessLen <= Data.size();
+    return AccessLen <=
+           CurrPage.load(std::memory_order_acquire) * kPageSize;
   }
 
+  /// Waiting thread of atomic wait.
+  struct WaitNode {
+    std::atomic<uint32_t> Woken = 0;
+  };
+
   /// \name Data of memory instance.
   /// @{
+  const bool IsShared;
   const bool HasMaxPage;
   const uint32_t MinPage;
   const uint32_t MaxPage;
-  uint32_t CurrPage;
+  std::atomic<uint32_t> CurrPage;
   std::vector<Byte, boost::alignment::aligned_allocator<Byte, 65536>> Data;
   uint8_t **Symbol = nullptr;
   /// @}
+
+  /// \name Data of threads sharing the memory.
+  /// @{
+  std::mutex GrowMutex;
+  std::mutex WaitMutex;
+  std::unordered_map<uint32_t, std::deque<WaitNode *>> Waiters;
+  /// @}
 };
 
 } // namespace Instance
@@ -13,6 +13,9 @@
 
 #include "common/errcode.h"
 #include "common/types.h"
+#include "common/value.h"
+#include "loader/filemgr.h"
+#include "support/span.h"
 #include "type.h"
 
 #include <map>
@@ -39,11 +42,41 @@ public:
 
   /// Map the external instences between Module and Store.
   void addFuncAddr(const uint32_t FuncAddr) { FuncAddrs.push_back(FuncAddr); }
+  /// Map the imported functions, which precede the defined ones.
+  void addImportedFuncAddr(const uint32_t FuncAddr) {
+    FuncAddrs.push_back(FuncAddr);
+    ++ImpFuncNum;
+  }
   void addTableAddr(const uint32_t TabAddr) { TableAddrs.push_back(TabAddr); }
   void addMemAddr(const uint32_t MemAddr) { MemAddrs.push_back(MemAddr); }
   void addGlobalAddr(const uint32_t GlobAddr) {
     GlobalAddrs.push_back(GlobAddr);
   }
+  /// Map the imported globals, which precede the defined ones.
+  void addImportedGlobalAddr(const uint32_t GlobAddr) {
+    GlobalAddrs.push_back(GlobAddr);
+    ++ImpGlobalNum;
+  }
+
+  /// Add the data segments and the element segments of references, which are
+  /// copied by memory.init and table.init. The data segments share the
+  /// ownership of the loaded bytes, so they outlive the AST module.
+  void addData(SharedBytes Data) { Datas.push_back(std::move(Data)); }
+  void addElem(std::vector<ValVariant> Refs) {
+    Elems.push_back(std::move(Refs));
+  }
+
+  /// Drop the data and element segments. Dropped segments become empty.
+  void dropData(const uint32_t Idx) {
+    if (Idx < Datas.size()) {
+      Datas[Idx] = {};
+    }
+  }
+  void dropElem(const uint32_t Idx) {
+    if (Idx < Elems.size()) {
+      Elems[Idx].clear();
+    }
+  }
 
   /// Exports functions.
   void exportFuncion(const std::string &Name, const uint32_t Idx) {
@@ -87,6 +120,19 @@ public:
     }
     return FuncAddrs[Idx];
   }
+  /// Get the index of a function defined in this module by its address in
+  /// Store. The defined functions are stored contiguously.
+  std::optional<uint32_t> getDefinedFuncIdx(const uint32_t FuncAddr) const {
+    if (ImpFuncNum >= FuncAddrs.size() || FuncAddr < FuncAddrs[ImpFuncNum]) {
+      return std::nullopt;
+    }
+    const uint64_t Idx =
+        static_cast<uint64_t>(ImpFuncNum) + (FuncAddr - FuncAddrs[ImpFuncNum]);
+    if (Idx >= FuncAddrs.size() || FuncAddrs[Idx] != FuncAddr) {
+      return std::nullopt;
+    }
+    return static_cast<uint32_t>(Idx);
+  }
   Expect<uint32_t> getTableAddr(const uint32_t Idx) const {
     if (Idx >= TableAddrs.size()) {
       return Unexpect(ErrCode::WrongInstanceAddress);
@@ -106,11 +152,26 @@ public:
     return GlobalAddrs[Idx];
   }
 
+  /// Get the data and element segments by index.
+  Expect<Span<const Byte>> getData(const uint32_t Idx) const {
+    if (Idx >= Datas.size()) {
+      return Unexpect(ErrCode::WrongInstanceAddress);
+    }
+    return Datas[Idx].getSpan();
+  }
+  Expect<Span<const ValVariant>> getElem(const uint32_t Idx) const {
+    if (Idx >= Elems.size()) {
+      return Unexpect(ErrCode::WrongInstanceAddress);
+    }
+    return Span<const ValVariant>(Elems[Idx]);
+  }
+
   /// Get the added external values' numbers.
   uint32_t getFuncNum() const { return FuncAddrs.size(); }
   uint32_t getTableNum() const { return TableAddrs.size(); }
   uint32_t getMemNum() const { return MemAddrs.size(); }
   uint32_t getGlobalNum() const { return GlobalAddrs.size(); }
+  uint32_t getImportedGlobalNum() const { return ImpGlobalNum; }
 
   /// Set start function index and find the address in Store.
   void setStartIdx(const uint32_t Idx) {
@@ -141,6 +202,12 @@ private:
   std::vector<uint32_t> TableAddrs;
   std::vector<uint32_t> MemAddrs;
   std::vector<uint32_t> GlobalAddrs;
+  uint32_t ImpFuncNum = 0;
+  uint32_t ImpGlobalNum = 0;
+
+  /// Data segments and element segments of references.
+  std::vector<SharedBytes> Datas;
+  std::vector<std::vector<ValVariant>> Elems;
 
   /// Exports.
   std::map<std::string, uint32_t> ExpFuncs;
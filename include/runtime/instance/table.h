@@ -14,6 +14,8 @@
 #include "common/ast/type.h"
 #include "common/errcode.h"
 #include "common/types.h"
+#include "common/value.h"
+#include "support/span.h"
 
 #include <algorithm>
 #include <cstdint>
@@ -28,8 +30,7 @@ public:
   TableInstance() = delete;
   TableInstance(const ElemType &Elem, const AST::Limit &Lim)
       : Type(Elem), HasMaxSize(Lim.hasMax()), MinSize(Lim.getMin()),
-        MaxSize(Lim.getMax()), FuncElem(MinSize), FuncElemInit(MinSize, false) {
-  }
+        MaxSize(Lim.getMax()), Refs(MinSize, genNullRef()) {}
   virtual ~TableInstance() = default;
 
   /// Getter of element type.
@@ -44,33 +45,107 @@ public:
   /// Getter of limit definition.
   uint32_t getMax() const { return MaxSize; }
 
-  /// Set the function index initialization list.
+  /// Getter of table size.
+  uint32_t getSize() const { return static_cast<uint32_t>(Refs.size()); }
+
+  /// Set the reference initialization list.
   Expect<void> setInitList(const uint32_t Offset,
-                           const std::vector<uint32_t> &Addrs) {
-    if (Offset + Addrs.size() > MinSize) {
+                           const std::vector<ValVariant> &InitRefs) {
+    if (static_cast<uint64_t>(Offset) + InitRefs.size() > Refs.size()) {
       return Unexpect(ErrCode::ElemSegDoesNotFit);
     }
-    std::copy(Addrs.begin(), Addrs.end(), FuncElem.begin() + Offset);
-    std::fill(FuncElemInit.begin() + Offset,
-              FuncElemInit.begin() + Offset + Addrs.size(), true);
+    std::copy(InitRefs.begin(), InitRefs.end(), Refs.begin() + Offset);
+    return {};
+  }
+
+  /// Set the references of Src[Start : Start + Length - 1] to the elements
+  /// from Offset.
+  Expect<void> setElems(const uint32_t Offset, Span<const ValVariant> Src,
+                        const uint32_t Start, const uint32_t Length) {
+    /// Check table and input boundaries.
+    if (static_cast<uint64_t>(Offset) + Length > Refs.size() ||
+        static_cast<uint64_t>(Start) + Length > Src.size()) {
+      return Unexpect(ErrCode::TableOutOfBounds);
+    }
+    std::copy(Src.begin() + Start, Src.begin() + Start + Length,
+              Refs.begin() + Offset);
+    return {};
+  }
+
+  /// Copy the elements of Src[SrcOffset : SrcOffset + Length - 1] to the
+  /// elements from Offset. The source table can be this table.
+  Expect<void> copyElems(const uint32_t Offset, const TableInstance &Src,
+                         const uint32_t SrcOffset, const uint32_t Length) {
+    /// Check table boundaries of both ranges.
+    if (static_cast<uint64_t>(Offset) + Length > Refs.size() ||
+        static_cast<uint64_t>(SrcOffset) + Length > Src.Refs.size()) {
+      return Unexpect(ErrCode::TableOutOfBounds);
+    }
+    /// Copy backward when the ranges overlap and the destination is behind.
+    auto SrcRef = Src.Refs.begin() + SrcOffset;
+    if (Offset <= SrcOffset) {
+      std::copy(SrcRef, SrcRef + Length, Refs.begin() + Offset);
+    } else {
+      std::copy_backward(SrcRef, SrcRef + Length,
+                         Refs.begin() + Offset + Length);
+    }
+    return {};
+  }
+
+  /// Fill the elements of [Offset : Offset + Length - 1] with the reference.
+  Expect<void> fillElems(const uint32_t Offset, const ValVariant &Ref,
+                         const uint32_t Length) {
+    if (static_cast<uint64_t>(Offset) + Length > Refs.size()) {
+      return Unexpect(ErrCode::TableOutOfBounds);
+    }
+    std::fill(Refs.begin() + Offset, Refs.begin() + Offset + Length, Ref);
     return {};
   }
 
+  /// Grow the table by Count elements initialized with the reference. Return
+  /// false if the size exceeds the limit.
+  bool growTable(const uint32_t Count, const ValVariant &Ref) {
+    const uint64_t NewSize = static_cast<uint64_t>(Refs.size()) + Count;
+    const uint64_t Limit = HasMaxSize ? MaxSize : UINT32_MAX;
+    if (NewSize > Limit) {
+      return false;
+    }
+    Refs.resize(NewSize, Ref);
+    return true;
+  }
+
   /// Check is out of bound.
-  bool checkAccessBound(const uint32_t Offset) {
-    return (Offset > MinSize) ? false : true;
+  bool checkAccessBound(const uint64_t Offset) const {
+    return Offset <= Refs.size();
+  }
+
+  /// Get the reference.
+  Expect<ValVariant> getRef(const uint32_t Idx) const {
+    if (Idx >= Refs.size()) {
+      return Unexpect(ErrCode::TableOutOfBounds);
+    }
+    return Refs[Idx];
+  }
+
+  /// Set the reference.
+  Expect<void> setRef(const uint32_t Idx, const ValVariant &Ref) {
+    if (Idx >= Refs.size()) {
+      return Unexpect(ErrCode::TableOutOfBounds);
+    }
+    Refs[Idx] = Ref;
+    return {};
   }
 
   /// Get the elem address.
   Expect<uint32_t> getElemAddr(const uint32_t Idx) const {
-    if (Idx >= FuncElem.size()) {
+    if (Idx >= Refs.size()) {
       return Unexpect(ErrCode::UndefinedElement);
     }
     if (Symbol) {
       return Symbol[Idx];
     } else {
-      if (FuncElemInit[Idx]) {
-        return FuncElem[Idx];
+      if (!isNullRef(Refs[Idx])) {
+        return retrieveFuncAddr(Refs[Idx]);
       } else {
         return Unexpect(ErrCode::UninitializedElement);
       }
@@ -89,8 +164,7 @@ private:
   const bool HasMaxSize;
   const uint32_t MinSize = 0;
   const uint32_t MaxSize = 0;
-  std::vector<uint32_t> FuncElem;
-  std::vector<bool> FuncElemInit;
+  std::vector<ValVariant> Refs;
   uint32_t *Symbol = nullptr;
   /// @}
 };
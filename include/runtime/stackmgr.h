@@ -104,13 +104,30 @@ public:
     return LabelPopped;
   }
 
-  /// Push a new label entry to stack.
-  void pushLabel(const uint32_t Coarity,
+  /// Unsafe reuse of top frame for tail call. Keep the top Arity values as
+  /// the arguments of the callee. Return number of popped label.
+  uint32_t reuseFrame(const uint32_t ModuleAddr, const uint32_t Arity) {
+    auto &F = FrameStack.back();
+    uint32_t LabelPopped = LabelStack.size() - F.LStackSize;
+    LabelStack.erase(LabelStack.begin() + F.LStackSize, LabelStack.end());
+    ValueStack.erase(ValueStack.begin() + F.VStackSize,
+                     ValueStack.end() - Arity);
+    F.ModAddr = ModuleAddr;
+    return LabelPopped;
+  }
+
+  /// Push a new label entry to stack. The top Arity values are the block
+  /// parameters, and the Coarity values are kept when branching to label.
+  void pushLabel(const uint32_t Arity, const uint32_t Coarity,
                  const AST::BlockControlInstruction *Instr = nullptr) {
-    LabelStack.emplace_back(ValueStack.size(), Coarity, Instr);
+    LabelStack.emplace_back(ValueStack.size() - Arity, Coarity, Instr);
   }
 
-  /// Unsafe pop top label.
+  /// Unsafe pop top label at the end of block. The block results are the
+  /// only values above the label according to validation.
+  void leaveLabel() { LabelStack.pop_back(); }
+
+  /// Unsafe pop top label for branching. Move the kept values in bulk.
   void popLabel(const uint32_t Cnt = 1) {
     const auto &L = getLabelWithCount(Cnt - 1);
     ValueStack.erase(ValueStack.begin() + L.StackSize,
@@ -0,0 +1,89 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/support/arena.h - Bump allocator definition ------------------===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the declaration of the Arena class, which allocates
+/// trivially destructible objects from large blocks and frees them at once.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "support/span.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace SSVM {
+
+/// Bump allocator. Objects are never destroyed one by one, and the memory is
+/// released when the arena is destroyed.
+class Arena {
+public:
+  Arena() = default;
+  ~Arena() noexcept;
+
+  Arena(const Arena &) = delete;
+  Arena &operator=(const Arena &) = delete;
+
+  /// Allocate uninitialized memory.
+  void *allocate(size_t Size, size_t Align) {
+    const uintptr_t Ptr = (reinterpret_cast<uintptr_t>(Curr) + Align - 1) &
+                          ~static_cast<uintptr_t>(Align - 1);
+    if (Curr == nullptr || Ptr + Size > reinterpret_cast<uintptr_t>(End)) {
+      return allocateSlow(Size, Align);
+    }
+    Curr = reinterpret_cast<std::byte *>(Ptr + Size);
+    return reinterpret_cast<void *>(Ptr);
+  }
+
+  /// Construct an object in the arena.
+  template <typename T, typename... ArgsT> T *make(ArgsT &&... Args) {
+    static_assert(std::is_trivially_destructible_v<T>,
+                  "arena objects are never destroyed");
+    return new (allocate(sizeof(T), alignof(T)))
+        T(std::forward<ArgsT>(Args)...);
+  }
+
+  /// Copy an array into the arena.
+  template <typename T> Span<const T> copy(Span<const T> Data) {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "arena arrays are copied bytewise");
+    if (Data.empty()) {
+      return {};
+    }
+    void *Ptr = allocate(Data.size_bytes(), alignof(T));
+    std::memcpy(Ptr, Data.data(), Data.size_bytes());
+    return Span<const T>(static_cast<const T *>(Ptr), Data.size());
+  }
+
+  /// Getter of the number of allocated blocks.
+  size_t getBlockCount() const { return BlockCount; }
+
+private:
+  /// Allocate a new block which fits the request.
+  void *allocateSlow(size_t Size, size_t Align);
+
+  /// Block size doubles from the minimum up to the maximum.
+  static inline constexpr size_t kMinBlockSize = 256;
+  static inline constexpr size_t kMaxBlockSize = 64 * 1024;
+
+  /// Allocated blocks are linked from the newest one.
+  struct Block {
+    Block *Prev;
+  };
+  Block *Head = nullptr;
+  std::byte *Curr = nullptr;
+  std::byte *End = nullptr;
+  size_t NextSize = kMinBlockSize;
+  size_t BlockCount = 0;
+};
+
+} // namespace SSVM
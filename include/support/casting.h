@@ -54,6 +54,22 @@ struct IsWasmBuiltIn : std::bool_constant<IsWasmUnsignV<T> || IsWasmFloatV<T>> {
 template <typename T>
 inline constexpr const bool IsWasmBuiltInV = IsWasmBuiltIn<T>::value;
 
+/// Return true if Wasm 128-bit vector (unsigned __int128).
+template <typename T>
+struct IsWasmV128
+    : std::bool_constant<std::is_same_v<RemoveCVRefT<T>, unsigned __int128>> {
+};
+template <typename T>
+inline constexpr const bool IsWasmV128V = IsWasmV128<T>::value;
+
+/// Return true if Wasm reference (the struct types tagged with IsRef).
+template <typename T, typename = void> struct IsWasmRef : std::false_type {};
+template <typename T>
+struct IsWasmRef<T, std::void_t<decltype(RemoveCVRefT<T>::IsRef)>>
+    : std::bool_constant<RemoveCVRefT<T>::IsRef> {};
+template <typename T>
+inline constexpr const bool IsWasmRefV = IsWasmRef<T>::value;
+
 /// Return signed type.
 template <typename T>
 using MakeWasmSignedT =
@@ -84,7 +100,9 @@ template <> struct TypeToWasmType<int32_t> { using type = uint32_t; };
 template <> struct TypeToWasmType<int64_t> { using type = uint64_t; };
 template <typename T>
 using TypeToWasmTypeT =
-    typename std::enable_if_t<IsWasmTypeV<T>, typename TypeToWasmType<T>::type>;
+    typename std::enable_if_t<IsWasmTypeV<T> || IsWasmV128V<T> ||
+                                  IsWasmRefV<T>,
+                              typename TypeToWasmType<T>::type>;
 
 } // namespace Support
 } // namespace SSVM
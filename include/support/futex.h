@@ -0,0 +1,37 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/support/futex.h - Futex wrapper definition -------------------===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the declaration of the futex wrappers, which block and
+/// wake threads on a 32-bit word.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace SSVM {
+
+/// Sleep while Word equals to Expected.
+///
+/// The thread may wake up spuriously, so the caller needs to check its own
+/// condition again.
+///
+/// \param Word the word to sleep on.
+/// \param Expected the value of Word to keep sleeping.
+/// \param Timeout the relative timeout in nanoseconds, or negative for no
+/// timeout.
+///
+/// \returns false when timed out, true otherwise.
+bool futexWait(std::atomic<uint32_t> &Word, uint32_t Expected,
+               int64_t Timeout);
+
+/// Wake at most Count threads sleeping on Word.
+void futexWake(std::atomic<uint32_t> &Word, uint32_t Count);
+
+} // namespace SSVM
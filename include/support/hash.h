@@ -0,0 +1,58 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/support/hash.h - Byte hashing --------------------------------===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents the non-cryptographic hash function of byte ranges,
+/// which keys and checksums module cache files.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "support/span.h"
+
+#include <cstdint>
+#include <cstring>
+
+namespace SSVM {
+
+namespace detail {
+inline constexpr uint64_t kHashPrime1 = UINT64_C(0x9E3779B185EBCA87);
+inline constexpr uint64_t kHashPrime2 = UINT64_C(0xC2B2AE3D27D4EB4F);
+
+inline uint64_t hashRound(uint64_t Hash, uint64_t Word) {
+  Hash ^= Word * kHashPrime2;
+  Hash = (Hash << 31) | (Hash >> 33);
+  return Hash * kHashPrime1;
+}
+} // namespace detail
+
+/// Hash byte range into 64 bits. Words are read in host byte order.
+inline uint64_t hash64(Span<const uint8_t> Data, uint64_t Seed = 0) {
+  using namespace detail;
+  uint64_t Hash = Seed ^ (Data.size() * kHashPrime1);
+  const uint8_t *Ptr = Data.data();
+  const uint8_t *End = Ptr + Data.size();
+  for (; End - Ptr >= 8; Ptr += 8) {
+    uint64_t Word;
+    std::memcpy(&Word, Ptr, 8);
+    Hash = hashRound(Hash, Word);
+  }
+  if (Ptr != End) {
+    uint64_t Word = 0;
+    std::memcpy(&Word, Ptr, End - Ptr);
+    Hash = hashRound(Hash, Word);
+  }
+  /// Final avalanche.
+  Hash ^= Hash >> 33;
+  Hash *= kHashPrime2;
+  Hash ^= Hash >> 29;
+  Hash *= kHashPrime1;
+  Hash ^= Hash >> 32;
+  return Hash;
+}
+
+} // namespace SSVM
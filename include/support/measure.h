@@ -11,12 +11,26 @@ namespace Support {
 
 class Measurement {
 public:
+  /// Cost table size, which has a page of 256 entries for the single byte
+  /// opcodes and one for each opcode prefix from 0xFC to 0xFE.
+  static inline constexpr size_t kCostTableSize = 0x400;
+
+  /// Get the index of an opcode in the cost table.
+  static constexpr size_t getCostIndex(const AST::Instruction::OpCode &Code) {
+    const uint16_t Value = static_cast<uint16_t>(Code);
+    if (Value < 0x100U) {
+      return Value;
+    }
+    return (((Value >> 8) - 0xFBU) << 8) | (Value & 0xFFU);
+  }
+
   Measurement(const uint64_t Lim = UINT64_MAX)
-      : CostTab(256, 0ULL), InstrCnt(0), CostLimit(Lim), CostSum(0) {}
+      : CostTab(kCostTableSize, 0ULL), InstrCnt(0), CostLimit(Lim),
+        CostSum(0) {}
   Measurement(const std::vector<uint64_t> &Tab, const uint64_t Lim = UINT64_MAX)
       : CostTab(Tab), InstrCnt(0), CostLimit(Lim), CostSum(0) {
-    if (CostTab.size() < 256) {
-      CostTab.resize(256);
+    if (CostTab.size() < kCostTableSize) {
+      CostTab.resize(kCostTableSize);
     }
   }
   ~Measurement() = default;
@@ -30,14 +44,14 @@ public:
   /// Setter of cost table.
   void setCostTable(const std::vector<uint64_t> &NewTable) {
     CostTab = NewTable;
-    if (CostTab.size() < 256) {
-      CostTab.resize(256);
+    if (CostTab.size() < kCostTableSize) {
+      CostTab.resize(kCostTableSize);
     }
   }
 
   /// Adder for instruction costs.
   bool addInstrCost(const AST::Instruction::OpCode &Code) {
-    return addCost(CostTab[static_cast<uint64_t>(Code)]);
+    return addCost(CostTab[getCostIndex(Code)]);
   }
 
   /// Getter reference of cost limit.
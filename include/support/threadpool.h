@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/support/threadpool.h - Thread pool definition ----------------===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the declaration of the ThreadPool class, which runs
+/// independent tasks of the loading and validation phases on worker threads.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <sys/types.h>
+
+namespace SSVM {
+
+/// Fixed-size pool of worker threads for data-parallel loops.
+class ThreadPool {
+public:
+  /// Create pool with given number of worker threads. The calling thread of
+  /// parallelFor() also takes tasks, so zero workers means serial execution.
+  explicit ThreadPool(uint32_t WorkerCount);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  /// Process-wide pool with one thread per hardware thread.
+  static ThreadPool &getDefault();
+
+  /// Get the number of threads including the calling thread.
+  uint32_t getConcurrency() const { return Workers.size() + 1; }
+
+  /// Call Func(I) for every I in [0, N) and wait for all of them.
+  ///
+  /// Tasks are handed out in index order. When the pool is already running a
+  /// loop, e.g. a nested call from a task or another thread, or in a forked
+  /// child which has no workers, the tasks run serially on the calling thread
+  /// instead.
+  ///
+  /// \param N the number of tasks.
+  /// \param Func the task function, which must be safe to call concurrently.
+  void parallelFor(size_t N, const std::function<void(size_t)> &Func);
+
+private:
+  /// Take tasks of the current loop until none is left.
+  void runTasks();
+  void workerLoop();
+
+  std::vector<std::thread> Workers;
+  /// Process which owns the worker threads.
+  pid_t Owner;
+  /// Serializes loops submitted to the pool.
+  std::mutex LoopMutex;
+  /// Protects the fields below and pairs with the condition variables.
+  std::mutex Mutex;
+  std::condition_variable WakeUp;
+  std::condition_variable Finished;
+  bool Stop = false;
+  uint64_t Generation = 0;
+  uint32_t Running = 0;
+  /// Current loop.
+  const std::function<void(size_t)> *Task = nullptr;
+  size_t TaskCount = 0;
+  std::atomic<size_t> NextTask = 0;
+};
+
+} // namespace SSVM
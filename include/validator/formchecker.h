@@ -19,19 +19,51 @@
 #include "common/value.h"
 
 #include <deque>
+#include <memory>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 namespace SSVM {
 namespace Validator {
 
-enum class VType : uint32_t { Unknown, I32, I64, F32, F64 };
+enum class VType : uint32_t {
+  Unknown,
+  I32,
+  I64,
+  F32,
+  F64,
+  V128,
+  FuncRef,
+  ExternRef
+};
 using OpCode = AST::Instruction::OpCode;
 
-/// TODO: Validator should update due to applying multi-value returns in spec.
+/// Module-level contexts, which are shared by the checkers of function bodies
+/// after freezing.
+struct FormContext {
+  std::vector<std::pair<std::vector<VType>, std::vector<VType>>> Types;
+  std::vector<uint32_t> Funcs;
+  std::vector<ElemType> Tables;
+  std::vector<uint32_t> Mems;
+  std::vector<std::pair<VType, ValMut>> Globals;
+  uint32_t NumImportGlobals = 0;
+  /// Element types of element segments, and count of data segments declared
+  /// in data count section.
+  std::vector<ElemType> Elems;
+  uint32_t NumDatas = 0;
+  /// Function indices declared outside of function bodies, which can be
+  /// referred by ref.func in function bodies.
+  std::unordered_set<uint32_t> Refs;
+};
 
 class FormChecker {
 public:
-  FormChecker() = default;
+  FormChecker()
+      : Owned(std::make_shared<FormContext>()), Context(Owned) {}
+  /// Constructor of checker on frozen contexts. See freeze().
+  explicit FormChecker(std::shared_ptr<const FormContext> Frozen)
+      : Context(std::move(Frozen)) {}
   ~FormChecker() = default;
 
   void reset(bool CleanGlobal = false);
@@ -46,16 +78,29 @@ public:
   void addTable(const AST::TableType &Tab);
   void addMemory(const AST::MemoryType &Mem);
   void addGlobal(const AST::GlobalType &Glob, const bool IsImport = false);
+  void addElem(const AST::ElementSegment &Elem);
+  void setDataCount(const uint32_t Count);
+  void addRef(const uint32_t FuncIdx);
   void addLocal(const ValType &V);
   void addLocal(const VType &V);
 
+  /// Freeze the contexts to share them with other checkers, which can check
+  /// function bodies concurrently. Later adders copy the contexts first.
+  std::shared_ptr<const FormContext> freeze() {
+    Owned.reset();
+    return Context;
+  }
+
   std::deque<VType> result() { return ValStack; };
-  auto &getTypes() { return Types; }
-  auto &getFunctions() { return Funcs; }
-  auto &getTables() { return Tables; }
-  auto &getMemories() { return Mems; }
-  auto &getGlobals() { return Globals; }
-  uint32_t getNumImportGlobals() const { return NumImportGlobals; }
+  const auto &getTypes() const { return Context->Types; }
+  const auto &getFunctions() const { return Context->Funcs; }
+  const auto &getTables() const { return Context->Tables; }
+  const auto &getMemories() const { return Context->Mems; }
+  const auto &getGlobals() const { return Context->Globals; }
+  uint32_t getNumImportGlobals() const { return Context->NumImportGlobals; }
+  const auto &getElems() const { return Context->Elems; }
+  uint32_t getDataCount() const { return Context->NumDatas; }
+  const auto &getRefs() const { return Context->Refs; }
 
 private:
   struct CtrlFrame {
@@ -76,12 +121,22 @@ private:
   Expect<void> checkInstr(const AST::ParametricInstruction &Instr);
   Expect<void> checkInstr(const AST::VariableInstruction &Instr);
   Expect<void> checkInstr(const AST::MemoryInstruction &Instr);
+  Expect<void> checkInstr(const AST::TableInstruction &Instr);
+  Expect<void> checkInstr(const AST::ReferenceInstruction &Instr);
   Expect<void> checkInstr(const AST::ConstInstruction &Instr);
   Expect<void> checkInstr(const AST::UnaryNumericInstruction &Instr);
   Expect<void> checkInstr(const AST::BinaryNumericInstruction &Instr);
+  Expect<void> checkInstr(const AST::SIMDMemoryInstruction &Instr);
+  Expect<void> checkInstr(const AST::SIMDLaneInstruction &Instr);
+  Expect<void> checkInstr(const AST::SIMDShuffleInstruction &Instr);
+  Expect<void> checkInstr(const AST::SIMDNumericInstruction &Instr);
+  Expect<void> checkInstr(const AST::AtomicMemoryInstruction &Instr);
 
   /// Helper function
   VType ASTToVType(const ValType &V);
+  Expect<std::pair<std::vector<VType>, std::vector<VType>>>
+  resolveBlockType(const BlockType &Type);
+  FormContext &getMutableContext();
 
   /// Stack operations
   void pushType(VType);
@@ -95,13 +150,9 @@ private:
   Expect<void> StackTrans(const std::vector<VType> &Take,
                           const std::vector<VType> &Put);
 
-  /// Contexts.
-  std::vector<std::pair<std::vector<VType>, std::vector<VType>>> Types;
-  std::vector<uint32_t> Funcs;
-  std::vector<ElemType> Tables;
-  std::vector<uint32_t> Mems;
-  std::vector<std::pair<VType, ValMut>> Globals;
-  uint32_t NumImportGlobals = 0;
+  /// Contexts. Owned is null when the contexts are frozen.
+  std::shared_ptr<FormContext> Owned;
+  std::shared_ptr<const FormContext> Context;
   std::vector<VType> Locals;
   std::vector<VType> Returns;
 
@@ -30,13 +30,17 @@ public:
   /// Validate AST::Module.
   Expect<void> validate(const AST::Module &Mod);
 
+  /// Get the validation of function bodies skipped in lazy loading of the last
+  /// validated module. The result is empty if no function body is skipped, and
+  /// accepts every body if the module is loaded from module cache.
+  AST::CodeValidator getCodeValidator() const;
+
 private:
   /// Validate AST::Types
   Expect<void> validate(const AST::Limit &Lim, const uint32_t K);
-  Expect<void> validate(const AST::FunctionType &Func);
   Expect<void> validate(const AST::TableType &Tab);
   Expect<void> validate(const AST::MemoryType &Mem);
-  /// GlobalType is always valid.
+  /// FunctionType and GlobalType are always valid.
 
   /// Validate AST::Segments
   Expect<void> validate(const AST::GlobalSegment &GlobSeg);
@@ -68,7 +72,14 @@ private:
 
   const uint32_t LIMIT_TABLETYPE = UINT32_MAX; // 2^32-1
   const uint32_t LIMIT_MEMORYTYPE = 1U << 16;
+  /// Total top-level instructions of function bodies above which they are
+  /// validated in parallel.
+  static inline constexpr size_t kParallelValidateSize = 16 * 1024;
   FormChecker Checker;
+  /// Context of the last validated module for lazy loaded function bodies.
+  std::shared_ptr<const FormContext> DeferredContext;
+  /// The last validated module is loaded from module cache.
+  bool IsTrusted = false;
 };
 
 } // namespace Validator
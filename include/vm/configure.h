@@ -11,11 +11,17 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 namespace SSVM {
+namespace Host {
+class MemoryImage;
+} // namespace Host
 namespace VM {
 
 class Configure {
@@ -23,6 +29,9 @@ public:
   /// VM type enum class.
   enum class VMType : uint8_t { Wasm = 0, Wasi };
 
+  /// WASI write buffer mode enum class.
+  enum class WriteBufferMode : uint8_t { None = 0, Line, Full };
+
   Configure() { Types.insert(VMType::Wasm); }
   ~Configure() = default;
 
@@ -34,8 +43,73 @@ public:
     return ((Types.find(Type) != Types.end()) ? true : false);
   }
 
+  /// Lazy loading: decode and validate function bodies on their first call.
+  void setLazyLoading(const bool Lazy) { LazyLoading = Lazy; }
+
+  bool isLazyLoading() const { return LazyLoading; }
+
+  /// Module cache: keep validated modules in the directory and load them
+  /// without validation next time. Empty means disabled.
+  void setCacheDir(const std::string &Dir) { CacheDir = Dir; }
+
+  const std::string &getCacheDir() const { return CacheDir; }
+
+  /// Host function statistics: count the calls, latencies, and bytes of
+  /// every host function.
+  void setHostFuncStats(const bool Enable) { HostFuncStats = Enable; }
+
+  bool isHostFuncStats() const { return HostFuncStats; }
+
+  /// In-memory WASI preopens: serve the guest directory from a private
+  /// copy-on-write mount of the image. The image can be shared by many VMs.
+  void addMemoryPreopen(const std::string &GuestPath,
+                        std::shared_ptr<const Host::MemoryImage> Image) {
+    MemoryPreopens.emplace_back(GuestPath, std::move(Image));
+  }
+
+  const std::vector<
+      std::pair<std::string, std::shared_ptr<const Host::MemoryImage>>> &
+  getMemoryPreopens() const {
+    return MemoryPreopens;
+  }
+
+  /// WASI write buffer: combine the small writes of stdout and stderr into
+  /// larger host writes, flushed on a newline or when the buffer is full.
+  void setWriteBuffer(const WriteBufferMode Mode,
+                      const size_t Capacity = 4096) {
+    BufferMode = Mode;
+    BufferCapacity = Capacity;
+  }
+
+  WriteBufferMode getWriteBufferMode() const { return BufferMode; }
+
+  size_t getWriteBufferCapacity() const { return BufferCapacity; }
+
+  /// WASI frozen clock: serve the realtime and monotonic clocks from the
+  /// time taken at the start of every invocation.
+  void setFrozenClock(const bool Enable) { FrozenClock = Enable; }
+
+  bool isFrozenClock() const { return FrozenClock; }
+
+  /// WASI random reseed interval: the bytes random_get generates before it
+  /// takes a fresh key from the system entropy. Zero reseeds at every call.
+  void setRandomReseedInterval(const uint64_t Bytes) {
+    ReseedInterval = Bytes;
+  }
+
+  uint64_t getRandomReseedInterval() const { return ReseedInterval; }
+
 private:
   std::unordered_set<VMType> Types;
+  bool LazyLoading = false;
+  std::string CacheDir;
+  bool HostFuncStats = false;
+  std::vector<std::pair<std::string, std::shared_ptr<const Host::MemoryImage>>>
+      MemoryPreopens;
+  WriteBufferMode BufferMode = WriteBufferMode::None;
+  size_t BufferCapacity = 4096;
+  bool FrozenClock = false;
+  uint64_t ReseedInterval = UINT64_C(1) << 20;
 };
 
 } // namespace VM
@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "configure.h"
+#include "support/measure.h"
 
 #include <unordered_map>
 #include <vector>
@@ -28,11 +29,13 @@ public:
     switch (Type) {
     case Configure::VMType::Wasm:
       /// Wasm cost table
-      Costs[Type] = std::vector<uint64_t>(256, 1);
+      Costs[Type] =
+          std::vector<uint64_t>(Support::Measurement::kCostTableSize, 1);
       return true;
     case Configure::VMType::Wasi:
       /// Wasi cost table
-      Costs[Type] = std::vector<uint64_t>(256, 1);
+      Costs[Type] =
+          std::vector<uint64_t>(Support::Measurement::kCostTableSize, 1);
       return true;
     default:
       break;
@@ -23,9 +23,13 @@
 #include "support/measure.h"
 #include "validator/validator.h"
 
+#include <atomic>
 #include <cstdint>
+#include <iosfwd>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace SSVM {
@@ -37,7 +41,7 @@ public:
   VM() = delete;
   VM(Configure &InputConfig);
   VM(Configure &InputConfig, Runtime::StoreManager &S);
-  ~VM() = default;
+  ~VM() { joinThreads(); }
 
   /// ======= Functions can be called before instantiated stage. =======
   /// Register wasm modules and host modules.
@@ -75,6 +79,16 @@ public:
   execute(const std::string &Mod, const std::string &Func,
           const std::vector<ValVariant> &Params = {});
 
+  /// Spawn a guest thread which invokes the exported function of the
+  /// instantiated module. The thread has its own stack and shares the
+  /// instances in the store, including the shared memory.
+  Expect<void> spawnThread(const std::string &Func,
+                           std::vector<ValVariant> Params = {});
+
+  /// Wait for all spawned guest threads to finish, and flush the buffered
+  /// WASI output.
+  void joinThreads();
+
   /// ======= Functions which are stageless. =======
   /// Clean up VM status
   void cleanup();
@@ -86,6 +100,14 @@ public:
   /// Get import objects by configurations.
   Runtime::ImportObject *getImportModule(const Configure::VMType Type);
 
+  /// Get the call statistics of the host functions, named by
+  /// "module.function". They are recorded only if enabled in the configure.
+  std::vector<std::pair<std::string, const Runtime::HostFuncStats *>>
+  getHostFuncStats() const;
+
+  /// Print a summary of the host function statistics, like `strace -c`.
+  void dumpHostFuncStats(std::ostream &OS) const;
+
   /// Getter of store set in VM.
   Runtime::StoreManager &getStoreManager() { return StoreRef; }
 
@@ -107,6 +129,12 @@ private:
   Expect<std::vector<ValVariant>>
   runWasmFile(const AST::Module &Module, const std::string &Func,
               const std::vector<ValVariant> &Params);
+  /// Invoke the function, with the per-invocation states of the host modules
+  /// refreshed.
+  Expect<std::vector<ValVariant>> invoke(uint32_t FuncAddr,
+                                         const std::vector<ValVariant> &Params);
+  /// Track the host module for the statistics.
+  void addHostModule(const Runtime::ImportObject &Obj);
 
   /// VM environment.
   Configure &Config;
@@ -120,11 +148,20 @@ private:
 
   /// VM Storage.
   std::unique_ptr<AST::Module> Mod;
+  AST::CodeValidator ModCodeValidator;
   std::unique_ptr<Runtime::StoreManager> Store;
   Runtime::StoreManager &StoreRef;
   std::map<Configure::VMType, std::unique_ptr<Runtime::ImportObject>> ImpObjs;
+  std::unique_ptr<Runtime::ImportObject> ThreadsMod;
+  std::unique_ptr<Runtime::ImportObject> IOMod;
+  std::vector<const Runtime::ImportObject *> HostModules;
   CostTable CostTab;
 
+  /// Spawned guest threads.
+  std::mutex ThreadsMutex;
+  std::vector<std::thread> Threads;
+  std::atomic<uint32_t> NextThreadId = 1;
+
   /// Identification
   std::string ServiceName;
   uint64_t UUID;
@@ -32,6 +32,9 @@ using ExceptionBehavior = llvm::ConstrainedFPIntrinsic::ExceptionBehavior;
 static inline unsigned Align(unsigned Value) noexcept { return Value; }
 #endif
 
+/// Element of the table 0 which is not initialized in compile time.
+static inline constexpr const uint32_t kNullElement = UINT32_MAX;
+
 static bool isVoidReturn(const std::vector<SSVM::ValType> &ValTypes);
 static llvm::Type *toLLVMType(llvm::LLVMContext &Context,
                               const SSVM::ValType &ValType);
@@ -45,10 +48,12 @@ static llvm::FunctionType *toLLVMType(llvm::LLVMContext &Context,
 static llvm::Constant *toLLVMConstantZero(llvm::LLVMContext &Context,
                                           const SSVM::ValType &ValType);
 static std::vector<llvm::Value *> getUndefValue(llvm::Type *Ty);
-static llvm::Value *packStruct(llvm::IRBuilder<> &Builder, llvm::Value *Vals,
-                               unsigned N);
+static llvm::Value *packStruct(llvm::IRBuilder<> &Builder,
+                               llvm::ArrayRef<llvm::Value *> Values);
 static std::vector<llvm::Value *> unpackStruct(llvm::IRBuilder<> &Builder,
                                                llvm::Value *Struct);
+static bool isTableWritten(const SSVM::AST::InstrVec &Instrs);
+static bool isTableShared(const SSVM::AST::Module &Module);
 class FunctionCompiler;
 
 } // namespace
@@ -70,6 +75,9 @@ struct SSVM::AOT::Compiler::CompileContext {
 #endif
   std::vector<const AST::FunctionType *> FunctionTypes;
   std::vector<unsigned int> Elements;
+  /// The table 0 is never changed after instantiation, so call_indirect can
+  /// dispatch on the elements resolved in compile time.
+  bool StaticTable = false;
   std::vector<
       std::tuple<unsigned int, llvm::Function *, SSVM::AST::CodeSegment *>>
       Functions;
@@ -79,6 +87,21 @@ struct SSVM::AOT::Compiler::CompileContext {
   llvm::GlobalVariable *Call;
   llvm::GlobalVariable *MemGrow;
   llvm::GlobalVariable *MemSize;
+  llvm::GlobalVariable *MemInit;
+  llvm::GlobalVariable *DataDrop;
+  llvm::GlobalVariable *MemAtomicNotify;
+  llvm::GlobalVariable *MemAtomicWait;
+  llvm::GlobalVariable *TableSize;
+  llvm::GlobalVariable *TableGrow;
+  llvm::GlobalVariable *TableGet;
+  llvm::GlobalVariable *TableSet;
+  llvm::GlobalVariable *TableFill;
+  llvm::GlobalVariable *TableInit;
+  llvm::GlobalVariable *TableCopy;
+  llvm::GlobalVariable *ElemDrop;
+  llvm::GlobalVariable *RefFunc;
+  llvm::GlobalVariable *TableGetFuncIdx;
+  llvm::GlobalVariable *CallIndirect;
   llvm::GlobalVariable *Mem;
   llvm::GlobalVariable *InstrCount;
   llvm::MDNode *Likely;
@@ -116,6 +139,167 @@ struct SSVM::AOT::Compiler::CompileContext {
                                     {llvm::Type::getInt8PtrTy(Context)}, false)
                 ->getPointerTo(),
             false, llvm::GlobalVariable::InternalLinkage, nullptr, "memsize")),
+        MemInit(new llvm::GlobalVariable(
+            Module,
+            llvm::FunctionType::get(llvm::Type::getVoidTy(Context),
+                                    {llvm::Type::getInt8PtrTy(Context),
+                                     llvm::Type::getInt32Ty(Context),
+                                     llvm::Type::getInt32Ty(Context),
+                                     llvm::Type::getInt32Ty(Context),
+                                     llvm::Type::getInt32Ty(Context)},
+                                    false)
+                ->getPointerTo(),
+            false, llvm::GlobalVariable::InternalLinkage, nullptr, "meminit")),
+        DataDrop(new llvm::GlobalVariable(
+            Module,
+            llvm::FunctionType::get(llvm::Type::getVoidTy(Context),
+                                    {llvm::Type::getInt8PtrTy(Context),
+                                     llvm::Type::getInt32Ty(Context)},
+                                    false)
+                ->getPointerTo(),
+            false, llvm::GlobalVariable::InternalLinkage, nullptr,
+            "datadrop")),
+        MemAtomicNotify(new llvm::GlobalVariable(
+            Module,
+            llvm::FunctionType::get(llvm::Type::getInt32Ty(Context),
+                                    {llvm::Type::getInt8PtrTy(Context),
+                                     llvm::Type::getInt64Ty(Context),
+                                     llvm::Type::getInt32Ty(Context)},
+                                    false)
+                ->getPointerTo(),
+            false, llvm::GlobalVariable::InternalLinkage, nullptr,
+            "memnotify")),
+        MemAtomicWait(new llvm::GlobalVariable(
+            Module,
+            llvm::FunctionType::get(llvm::Type::getInt32Ty(Context),
+                                    {llvm::Type::getInt8PtrTy(Context),
+                                     llvm::Type::getInt64Ty(Context),
+                                     llvm::Type::getInt64Ty(Context),
+                                     llvm::Type::getInt64Ty(Context),
+                                     llvm::Type::getInt32Ty(Context)},
+                                    false)
+                ->getPointerTo(),
+            false, llvm::GlobalVariable::InternalLinkage, nullptr, "memwait")),
+        TableSize(new llvm::GlobalVariable(
+            Module,
+            llvm::FunctionType::get(llvm::Type::getInt32Ty(Context),
+                                    {llvm::Type::getInt8PtrTy(Context),
+                                     llvm::Type::getInt32Ty(Context)},
+                                    false)
+                ->getPointerTo(),
+            false, llvm::GlobalVariable::InternalLinkage, nullptr,
+            "tablesize")),
+        TableGrow(new llvm::GlobalVariable(
+            Module,
+            llvm::FunctionType::get(llvm::Type::getInt32Ty(Context),
+                                    {llvm::Type::getInt8PtrTy(Context),
+                                     llvm::Type::getInt32Ty(Context),
+                                     llvm::Type::getInt64Ty(Context),
+                                     llvm::Type::getInt32Ty(Context)},
+                                    false)
+                ->getPointerTo(),
+            false, llvm::GlobalVariable::InternalLinkage, nullptr,
+            "tablegrow")),
+        TableGet(new llvm::GlobalVariable(
+            Module,
+            llvm::FunctionType::get(llvm::Type::getInt64Ty(Context),
+                                    {llvm::Type::getInt8PtrTy(Context),
+                                     llvm::Type::getInt32Ty(Context),
+                                     llvm::Type::getInt32Ty(Context)},
+                                    false)
+                ->getPointerTo(),
+            false, llvm::GlobalVariable::InternalLinkage, nullptr,
+            "tableget")),
+        TableSet(new llvm::GlobalVariable(
+            Module,
+            llvm::FunctionType::get(llvm::Type::getVoidTy(Context),
+                                    {llvm::Type::getInt8PtrTy(Context),
+                                     llvm::Type::getInt32Ty(Context),
+                                     llvm::Type::getInt32Ty(Context),
+                                     llvm::Type::getInt64Ty(Context)},
+                                    false)
+                ->getPointerTo(),
+            false, llvm::GlobalVariable::InternalLinkage, nullptr,
+            "tableset")),
+        TableFill(new llvm::GlobalVariable(
+            Module,
+            llvm::FunctionType::get(llvm::Type::getVoidTy(Context),
+                                    {llvm::Type::getInt8PtrTy(Context),
+                                     llvm::Type::getInt32Ty(Context),
+                                     llvm::Type::getInt32Ty(Context),
+                                     llvm::Type::getInt64Ty(Context),
+                                     llvm::Type::getInt32Ty(Context)},
+                                    false)
+                ->getPointerTo(),
+            false, llvm::GlobalVariable::InternalLinkage, nullptr,
+            "tablefill")),
+        TableInit(new llvm::GlobalVariable(
+            Module,
+            llvm::FunctionType::get(llvm::Type::getVoidTy(Context),
+                                    {llvm::Type::getInt8PtrTy(Context),
+                                     llvm::Type::getInt32Ty(Context),
+                                     llvm::Type::getInt32Ty(Context),
+                                     llvm::Type::getInt32Ty(Context),
+                                     llvm::Type::getInt32Ty(Context),
+                                     llvm::Type::getInt32Ty(Context)},
+                                    false)
+                ->getPointerTo(),
+            false, llvm::GlobalVariable::InternalLinkage, nullptr,
+            "tableinit")),
+        TableCopy(new llvm::GlobalVariable(
+            Module,
+            llvm::FunctionType::get(llvm::Type::getVoidTy(Context),
+                                    {llvm::Type::getInt8PtrTy(Context),
+                                     llvm::Type::getInt32Ty(Context),
+                                     llvm::Type::getInt32Ty(Context),
+                                     llvm::Type::getInt32Ty(Context),
+                                     llvm::Type::getInt32Ty(Context),
+                                     llvm::Type::getInt32Ty(Context)},
+                                    false)
+                ->getPointerTo(),
+            false, llvm::GlobalVariable::InternalLinkage, nullptr,
+            "tablecopy")),
+        ElemDrop(new llvm::GlobalVariable(
+            Module,
+            llvm::FunctionType::get(llvm::Type::getVoidTy(Context),
+                                    {llvm::Type::getInt8PtrTy(Context),
+                                     llvm::Type::getInt32Ty(Context)},
+                                    false)
+                ->getPointerTo(),
+            false, llvm::GlobalVariable::InternalLinkage, nullptr,
+            "elemdrop")),
+        RefFunc(new llvm::GlobalVariable(
+            Module,
+            llvm::FunctionType::get(llvm::Type::getInt64Ty(Context),
+                                    {llvm::Type::getInt8PtrTy(Context),
+                                     llvm::Type::getInt32Ty(Context)},
+                                    false)
+                ->getPointerTo(),
+            false, llvm::GlobalVariable::InternalLinkage, nullptr, "reffunc")),
+        TableGetFuncIdx(new llvm::GlobalVariable(
+            Module,
+            llvm::FunctionType::get(llvm::Type::getInt32Ty(Context),
+                                    {llvm::Type::getInt8PtrTy(Context),
+                                     llvm::Type::getInt32Ty(Context),
+                                     llvm::Type::getInt32Ty(Context),
+                                     llvm::Type::getInt32Ty(Context)},
+                                    false)
+                ->getPointerTo(),
+            false, llvm::GlobalVariable::InternalLinkage, nullptr,
+            "tablegetfuncidx")),
+        CallIndirect(new llvm::GlobalVariable(
+            Module,
+            llvm::FunctionType::get(llvm::Type::getVoidTy(Context),
+                                    {llvm::Type::getInt8PtrTy(Context),
+                                     llvm::Type::getInt32Ty(Context),
+                                     llvm::Type::getInt32Ty(Context),
+                                     llvm::Type::getInt32Ty(Context),
+                                     llvm::Type::getInt8PtrTy(Context),
+                                     llvm::Type::getInt8PtrTy(Context)},
+                                    false)
+                ->getPointerTo(),
+            false, llvm::GlobalVariable::InternalLinkage, nullptr,
+            "callindirect")),
         Mem(new llvm::GlobalVariable(Module, llvm::Type::getInt8PtrTy(Context),
                                      false, llvm::GlobalValue::ExternalLinkage,
                                      nullptr, "mem")),
@@ -142,6 +326,25 @@ struct SSVM::AOT::Compiler::CompileContext {
     MemSize->setInitializer(
         llvm::ConstantPointerNull::get(llvm::cast<llvm::PointerType>(
             MemSize->getType()->getPointerElementType())));
+    MemInit->setInitializer(
+        llvm::ConstantPointerNull::get(llvm::cast<llvm::PointerType>(
+            MemInit->getType()->getPointerElementType())));
+    DataDrop->setInitializer(
+        llvm::ConstantPointerNull::get(llvm::cast<llvm::PointerType>(
+            DataDrop->getType()->getPointerElementType())));
+    MemAtomicNotify->setInitializer(
+        llvm::ConstantPointerNull::get(llvm::cast<llvm::PointerType>(
+            MemAtomicNotify->getType()->getPointerElementType())));
+    MemAtomicWait->setInitializer(
+        llvm::ConstantPointerNull::get(llvm::cast<llvm::PointerType>(
+            MemAtomicWait->getType()->getPointerElementType())));
+    for (auto *Proxy : {TableSize, TableGrow, TableGet, TableSet, TableFill,
+                        TableInit, TableCopy, ElemDrop, RefFunc,
+                        TableGetFuncIdx, CallIndirect}) {
+      Proxy->setInitializer(
+          llvm::ConstantPointerNull::get(llvm::cast<llvm::PointerType>(
+              Proxy->getType()->getPointerElementType())));
+    }
     Mem->setInitializer(
         llvm::ConstantPointerNull::get(llvm::cast<llvm::PointerType>(
             Mem->getType()->getPointerElementType())));
@@ -194,6 +397,97 @@ struct SSVM::AOT::Compiler::CompileContext {
     auto *MemSizeFunc = Builder.CreateLoad(MemSize);
     return Builder.CreateCall(MemSizeFunc, {Ctx});
   }
+  void callMemInit(llvm::IRBuilder<> &Builder, llvm::Value *Ctx,
+                   llvm::Value *DataIdx, llvm::Value *Dst, llvm::Value *Src,
+                   llvm::Value *Len) {
+    auto *MemInitFunc = Builder.CreateLoad(MemInit);
+    Builder.CreateCall(MemInitFunc, {Ctx, DataIdx, Dst, Src, Len});
+  }
+  void callDataDrop(llvm::IRBuilder<> &Builder, llvm::Value *Ctx,
+                    llvm::Value *DataIdx) {
+    auto *DataDropFunc = Builder.CreateLoad(DataDrop);
+    Builder.CreateCall(DataDropFunc, {Ctx, DataIdx});
+  }
+  llvm::Value *callMemAtomicNotify(llvm::IRBuilder<> &Builder,
+                                   llvm::Value *Ctx, llvm::Value *Address,
+                                   llvm::Value *Count) {
+    auto *MemAtomicNotifyFunc = Builder.CreateLoad(MemAtomicNotify);
+    return Builder.CreateCall(MemAtomicNotifyFunc, {Ctx, Address, Count});
+  }
+  llvm::Value *callMemAtomicWait(llvm::IRBuilder<> &Builder, llvm::Value *Ctx,
+                                 llvm::Value *Address, llvm::Value *Expected,
+                                 llvm::Value *Timeout, llvm::Value *BitWidth) {
+    auto *MemAtomicWaitFunc = Builder.CreateLoad(MemAtomicWait);
+    return Builder.CreateCall(MemAtomicWaitFunc,
+                              {Ctx, Address, Expected, Timeout, BitWidth});
+  }
+  llvm::Value *callTableSize(llvm::IRBuilder<> &Builder, llvm::Value *Ctx,
+                             llvm::Value *TableIdx) {
+    auto *TableSizeFunc = Builder.CreateLoad(TableSize);
+    return Builder.CreateCall(TableSizeFunc, {Ctx, TableIdx});
+  }
+  llvm::Value *callTableGrow(llvm::IRBuilder<> &Builder, llvm::Value *Ctx,
+                             llvm::Value *TableIdx, llvm::Value *Ref,
+                             llvm::Value *Count) {
+    auto *TableGrowFunc = Builder.CreateLoad(TableGrow);
+    return Builder.CreateCall(TableGrowFunc, {Ctx, TableIdx, Ref, Count});
+  }
+  llvm::Value *callTableGet(llvm::IRBuilder<> &Builder, llvm::Value *Ctx,
+                            llvm::Value *TableIdx, llvm::Value *Idx) {
+    auto *TableGetFunc = Builder.CreateLoad(TableGet);
+    return Builder.CreateCall(TableGetFunc, {Ctx, TableIdx, Idx});
+  }
+  void callTableSet(llvm::IRBuilder<> &Builder, llvm::Value *Ctx,
+                    llvm::Value *TableIdx, llvm::Value *Idx,
+                    llvm::Value *Ref) {
+    auto *TableSetFunc = Builder.CreateLoad(TableSet);
+    Builder.CreateCall(TableSetFunc, {Ctx, TableIdx, Idx, Ref});
+  }
+  void callTableFill(llvm::IRBuilder<> &Builder, llvm::Value *Ctx,
+                     llvm::Value *TableIdx, llvm::Value *Off, llvm::Value *Ref,
+                     llvm::Value *Len) {
+    auto *TableFillFunc = Builder.CreateLoad(TableFill);
+    Builder.CreateCall(TableFillFunc, {Ctx, TableIdx, Off, Ref, Len});
+  }
+  void callTableInit(llvm::IRBuilder<> &Builder, llvm::Value *Ctx,
+                     llvm::Value *TableIdx, llvm::Value *ElemIdx,
+                     llvm::Value *Dst, llvm::Value *Src, llvm::Value *Len) {
+    auto *TableInitFunc = Builder.CreateLoad(TableInit);
+    Builder.CreateCall(TableInitFunc, {Ctx, TableIdx, ElemIdx, Dst, Src, Len});
+  }
+  void callTableCopy(llvm::IRBuilder<> &Builder, llvm::Value *Ctx,
+                     llvm::Value *TableIdxDst, llvm::Value *TableIdxSrc,
+                     llvm::Value *Dst, llvm::Value *Src, llvm::Value *Len) {
+    auto *TableCopyFunc = Builder.CreateLoad(TableCopy);
+    Builder.CreateCall(TableCopyFunc,
+                       {Ctx, TableIdxDst, TableIdxSrc, Dst, Src, Len});
+  }
+  void callElemDrop(llvm::IRBuilder<> &Builder, llvm::Value *Ctx,
+                    llvm::Value *ElemIdx) {
+    auto *ElemDropFunc = Builder.CreateLoad(ElemDrop);
+    Builder.CreateCall(ElemDropFunc, {Ctx, ElemIdx});
+  }
+  llvm::Value *callRefFunc(llvm::IRBuilder<> &Builder, llvm::Value *Ctx,
+                           llvm::Value *FuncIdx) {
+    auto *RefFuncFunc = Builder.CreateLoad(RefFunc);
+    return Builder.CreateCall(RefFuncFunc, {Ctx, FuncIdx});
+  }
+  llvm::Value *callTableGetFuncIdx(llvm::IRBuilder<> &Builder,
+                                   llvm::Value *Ctx, llvm::Value *TableIdx,
+                                   llvm::Value *FuncTypeIdx,
+                                   llvm::Value *Idx) {
+    auto *TableGetFuncIdxFunc = Builder.CreateLoad(TableGetFuncIdx);
+    return Builder.CreateCall(TableGetFuncIdxFunc,
+                              {Ctx, TableIdx, FuncTypeIdx, Idx});
+  }
+  void callCallIndirect(llvm::IRBuilder<> &Builder, llvm::Value *Ctx,
+                        llvm::Value *TableIdx, llvm::Value *FuncTypeIdx,
+                        llvm::Value *Idx, llvm::Value *Args,
+                        llvm::Value *Rets) {
+    auto *CallIndirectFunc = Builder.CreateLoad(CallIndirect);
+    Builder.CreateCall(CallIndirectFunc,
+                       {Ctx, TableIdx, FuncTypeIdx, Idx, Args, Rets});
+  }
 };
 
 namespace {
@@ -216,6 +510,11 @@ static llvm::Type *toLLVMType(llvm::LLVMContext &Context,
     return llvm::Type::getFloatTy(Context);
   case ValType::F64:
     return llvm::Type::getDoubleTy(Context);
+  case ValType::V128:
+    return llvm::VectorType::get(llvm::Type::getInt64Ty(Context), 2);
+  case ValType::FuncRef:
+  case ValType::ExternRef:
+    return llvm::Type::getInt64Ty(Context);
   default:
     assert(false);
     __builtin_unreachable();
@@ -246,7 +545,7 @@ static llvm::Type *toLLVMRetsType(llvm::LLVMContext &Context,
   for (const auto &Type : ValTypes) {
     Result.push_back(toLLVMType(Context, Type));
   }
-  return llvm::StructType::create(Result);
+  return llvm::StructType::get(Context, Result);
 }
 
 static llvm::FunctionType *toLLVMType(llvm::LLVMContext &Context,
@@ -262,11 +561,15 @@ static llvm::Constant *toLLVMConstantZero(llvm::LLVMContext &Context,
   case ValType::I32:
     return llvm::ConstantInt::get(llvm::Type::getInt32Ty(Context), 0);
   case ValType::I64:
+  case ValType::FuncRef:
+  case ValType::ExternRef:
     return llvm::ConstantInt::get(llvm::Type::getInt64Ty(Context), 0);
   case ValType::F32:
     return llvm::ConstantFP::get(llvm::Type::getFloatTy(Context), 0.0f);
   case ValType::F64:
     return llvm::ConstantFP::get(llvm::Type::getDoubleTy(Context), 0.0);
+  case ValType::V128:
+    return llvm::ConstantAggregateZero::get(toLLVMType(Context, ValType));
   default:
     assert(false);
     __builtin_unreachable();
@@ -279,7 +582,13 @@ public:
   FunctionCompiler(AOT::Compiler::CompileContext &Context, llvm::Function *F,
                    const std::vector<ValType> &Locals, bool CalculateInstrCount)
       : Context(Context), VMContext(Context.Context), F(F),
-        Builder(llvm::BasicBlock::Create(VMContext, "entry", F)) {
+        Builder(llvm::BasicBlock::Create(VMContext, "entry", F)),
+        Int8x16Ty(llvm::VectorType::get(Builder.getInt8Ty(), 16)),
+        Int16x8Ty(llvm::VectorType::get(Builder.getInt16Ty(), 8)),
+        Int32x4Ty(llvm::VectorType::get(Builder.getInt32Ty(), 4)),
+        Int64x2Ty(llvm::VectorType::get(Builder.getInt64Ty(), 2)),
+        Floatx4Ty(llvm::VectorType::get(Builder.getFloatTy(), 4)),
+        Doublex2Ty(llvm::VectorType::get(Builder.getDoubleTy(), 2)) {
     if (F) {
       Builder.setIsFPConstrained(true);
       Builder.setDefaultConstrainedRounding(RoundingMode::rmToNearest);
@@ -333,7 +642,7 @@ public:
               if (auto Status = compile(
                       *static_cast<
                           const typename std::decay_t<decltype(Arg)>::type *>(
-                          Instr.get()));
+                          Instr));
                   !Status) {
                 return Unexpect(Status);
               }
@@ -389,27 +698,41 @@ public:
     return {};
   }
   Expect<void> compile(const AST::BlockControlInstruction &Instr) {
+    const auto [Params, Results] = resolveBlockType(Instr.getBlockType());
+    setParams(Params);
     switch (Instr.getOpCode()) {
     case OpCode::Block: {
       auto *Block = llvm::BasicBlock::Create(VMContext, "block", F);
       auto *EndBlock = llvm::BasicBlock::Create(VMContext, "block.end", F);
       Builder.CreateBr(Block);
 
-      enterBlock(EndBlock, true, Instr.getResultType());
+      enterBlock(EndBlock, true, Params.size(), Results);
       Builder.SetInsertPoint(Block);
       compile(Instr.getBody());
-      buildPHI({Instr.getResultType()}, leaveBlock(EndBlock));
+      buildPHI(Results, leaveBlock(EndBlock));
       break;
     }
     case OpCode::Loop: {
+      auto *Curr = Builder.GetInsertBlock();
       auto *Loop = llvm::BasicBlock::Create(VMContext, "loop", F);
       auto *EndLoop = llvm::BasicBlock::Create(VMContext, "loop.end", F);
       Builder.CreateBr(Loop);
 
-      enterBlock(Loop, false, Instr.getResultType());
+      /// The loop parameters are passed by the branches to loop.
       Builder.SetInsertPoint(Loop);
+      std::vector<llvm::PHINode *> PHIs;
+      PHIs.reserve(Params.size());
+      for (auto Iter = Stack.end() - Params.size(); Iter != Stack.end();
+           ++Iter) {
+        llvm::PHINode *PHI = Builder.CreatePHI((*Iter)->getType(), 2);
+        PHI->addIncoming(*Iter, Curr);
+        PHIs.push_back(PHI);
+        *Iter = PHI;
+      }
+
+      enterBlock(Loop, false, Params.size(), Results, std::move(PHIs));
       compile(Instr.getBody());
-      buildPHI({Instr.getResultType()}, leaveBlock(EndLoop));
+      buildPHI(Results, leaveBlock(EndLoop));
       break;
     }
     default:
@@ -423,18 +746,24 @@ public:
       llvm::Value *Cond =
           Builder.CreateICmpNE(Stack.back(), Builder.getInt32(0));
       Stack.pop_back();
+      const auto [Params, Results] = resolveBlockType(Instr.getBlockType());
+      setParams(Params);
+      const std::vector<llvm::Value *> Args(Stack.end() - Params.size(),
+                                            Stack.end());
 
       auto *Then = llvm::BasicBlock::Create(VMContext, "then", F);
       auto *Else = llvm::BasicBlock::Create(VMContext, "else", F);
       auto *EndIf = llvm::BasicBlock::Create(VMContext, "if.end", F);
       Builder.CreateCondBr(Cond, Then, Else);
 
-      enterBlock(EndIf, true, Instr.getResultType());
+      enterBlock(EndIf, true, Params.size(), Results);
       Builder.SetInsertPoint(Then);
       compile(Instr.getIfStatement());
       auto IfResult = leaveBlock(EndIf);
 
-      enterBlock(EndIf, true, Instr.getResultType());
+      /// The else statement takes the same parameters.
+      Stack.insert(Stack.end(), Args.begin(), Args.end());
+      enterBlock(EndIf, true, Params.size(), Results);
       Builder.SetInsertPoint(Else);
       compile(Instr.getElseStatement());
       auto ElseResult = leaveBlock(EndIf);
@@ -442,7 +771,7 @@ public:
       IfResult.reserve(IfResult.size() + ElseResult.size());
       IfResult.insert(IfResult.end(), ElseResult.begin(), ElseResult.end());
 
-      buildPHI({Instr.getResultType()}, IfResult);
+      buildPHI(Results, IfResult);
 
       break;
     }
@@ -481,7 +810,7 @@ public:
     return {};
   }
   Expect<void> compile(const AST::BrTableControlInstruction &Instr) {
-    const std::vector<unsigned int> &LabelTable = Instr.getLabelTable();
+    const auto LabelTable = Instr.getLabelTable();
     switch (Instr.getOpCode()) {
     case OpCode::Br_table: {
       if (!setLableJumpPHI(Instr.getLabelIndex())) {
@@ -512,9 +841,13 @@ public:
     switch (Instr.getOpCode()) {
     case OpCode::Call:
       return compileCallOp(Instr.getFuncIndex());
-    case OpCode::Call_indirect: {
-      return compileIndirectCallOp(Instr.getFuncIndex());
-    }
+    case OpCode::Call_indirect:
+      return compileIndirectCallOp(Instr.getTableIndex(), Instr.getFuncIndex());
+    case OpCode::Return_call:
+      return compileReturnCallOp(Instr.getFuncIndex());
+    case OpCode::Return_call_indirect:
+      return compileReturnCallIndirectOp(Instr.getTableIndex(),
+                                         Instr.getFuncIndex());
     default:
       __builtin_unreachable();
     }
@@ -524,7 +857,8 @@ public:
     case OpCode::Drop:
       Stack.pop_back();
       break;
-    case OpCode::Select: {
+    case OpCode::Select:
+    case OpCode::Select_t: {
       llvm::Value *Cond =
           Builder.CreateICmpNE(Stack.back(), Builder.getInt32(0));
       Stack.pop_back();
@@ -650,6 +984,149 @@ public:
       Stack.push_back(Context.callMemGrow(Builder, Ctx, Stack.back()));
       Builder.CreateStore(Builder.CreateLoad(Context.Mem), LocalMemPtr);
       break;
+    case OpCode::Memory__init: {
+      if (Stack.size() < 3) {
+        return Unexpect(ErrCode::ValidationFailed);
+      }
+      llvm::Value *Len = Stack.back();
+      Stack.pop_back();
+      llvm::Value *Src = Stack.back();
+      Stack.pop_back();
+      llvm::Value *Dst = Stack.back();
+      Stack.pop_back();
+      Context.callMemInit(Builder, Ctx, Builder.getInt32(Instr.getDataIndex()),
+                          Dst, Src, Len);
+      break;
+    }
+    case OpCode::Data__drop:
+      Context.callDataDrop(Builder, Ctx,
+                           Builder.getInt32(Instr.getDataIndex()));
+      break;
+    case OpCode::Memory__copy: {
+      if (Stack.size() < 3) {
+        return Unexpect(ErrCode::ValidationFailed);
+      }
+      llvm::Value *Len = Stack.back();
+      Stack.pop_back();
+      llvm::Value *Src = Stack.back();
+      Stack.pop_back();
+      llvm::Value *Dst = Stack.back();
+      Stack.pop_back();
+      compileMemoryBoundCheck(Dst, Len);
+      compileMemoryBoundCheck(Src, Len);
+      Builder.CreateMemMove(getMemoryPtr(Dst), Align(1), getMemoryPtr(Src),
+                            Align(1), Len);
+      break;
+    }
+    case OpCode::Memory__fill: {
+      if (Stack.size() < 3) {
+        return Unexpect(ErrCode::ValidationFailed);
+      }
+      llvm::Value *Len = Stack.back();
+      Stack.pop_back();
+      llvm::Value *Val = Builder.CreateTrunc(Stack.back(), Builder.getInt8Ty());
+      Stack.pop_back();
+      llvm::Value *Dst = Stack.back();
+      Stack.pop_back();
+      compileMemoryBoundCheck(Dst, Len);
+      Builder.CreateMemSet(getMemoryPtr(Dst), Val, Len, Align(1));
+      break;
+    }
+    default:
+      __builtin_unreachable();
+    }
+    return {};
+  }
+  Expect<void> compile(const AST::TableInstruction &Instr) {
+    /// Tables live in the store, so they are accessed through the proxies.
+    auto *TableIdx = Builder.getInt32(Instr.getTargetIndex());
+    switch (Instr.getOpCode()) {
+    case OpCode::Table__get: {
+      auto *Idx = Stack.back();
+      Stack.back() = Context.callTableGet(Builder, Ctx, TableIdx, Idx);
+      break;
+    }
+    case OpCode::Table__set: {
+      auto *Ref = Stack.back();
+      Stack.pop_back();
+      auto *Idx = Stack.back();
+      Stack.pop_back();
+      Context.callTableSet(Builder, Ctx, TableIdx, Idx, Ref);
+      break;
+    }
+    case OpCode::Table__size:
+      Stack.push_back(Context.callTableSize(Builder, Ctx, TableIdx));
+      break;
+    case OpCode::Table__grow: {
+      auto *Count = Stack.back();
+      Stack.pop_back();
+      auto *Ref = Stack.back();
+      Stack.back() = Context.callTableGrow(Builder, Ctx, TableIdx, Ref, Count);
+      break;
+    }
+    case OpCode::Table__fill: {
+      auto *Len = Stack.back();
+      Stack.pop_back();
+      auto *Ref = Stack.back();
+      Stack.pop_back();
+      auto *Off = Stack.back();
+      Stack.pop_back();
+      Context.callTableFill(Builder, Ctx, TableIdx, Off, Ref, Len);
+      break;
+    }
+    case OpCode::Table__init: {
+      auto *Len = Stack.back();
+      Stack.pop_back();
+      auto *Src = Stack.back();
+      Stack.pop_back();
+      auto *Dst = Stack.back();
+      Stack.pop_back();
+      Context.callTableInit(Builder, Ctx, TableIdx,
+                            Builder.getInt32(Instr.getElemIndex()), Dst, Src,
+                            Len);
+      break;
+    }
+    case OpCode::Table__copy: {
+      auto *Len = Stack.back();
+      Stack.pop_back();
+      auto *Src = Stack.back();
+      Stack.pop_back();
+      auto *Dst = Stack.back();
+      Stack.pop_back();
+      Context.callTableCopy(Builder, Ctx, TableIdx,
+                            Builder.getInt32(Instr.getSourceIndex()), Dst, Src,
+                            Len);
+      break;
+    }
+    case OpCode::Elem__drop:
+      Context.callElemDrop(Builder, Ctx,
+                           Builder.getInt32(Instr.getElemIndex()));
+      break;
+    default:
+      __builtin_unreachable();
+    }
+    return {};
+  }
+  Expect<void> compile(const AST::ReferenceInstruction &Instr) {
+    /// References are i64, and the null reference is 0.
+    switch (Instr.getOpCode()) {
+    case OpCode::Ref__null:
+      Stack.push_back(Builder.getInt64(0));
+      break;
+    case OpCode::Ref__is_null:
+      Stack.back() = Builder.CreateZExt(
+          Builder.CreateICmpEQ(Stack.back(), Builder.getInt64(0)),
+          Builder.getInt32Ty());
+      break;
+    case OpCode::Ref__func:
+      /// Function addresses in the store are only known in runtime, so the
+      /// reference can not be a constant expression.
+      if (F == nullptr) {
+        return Unexpect(ErrCode::InstrTypeMismatch);
+      }
+      Stack.push_back(Context.callRefFunc(
+          Builder, Ctx, Builder.getInt32(Instr.getFuncIndex())));
+      break;
     default:
       __builtin_unreachable();
     }
@@ -673,6 +1150,12 @@ public:
       Stack.push_back(llvm::ConstantFP::get(
           Builder.getDoubleTy(), std::get<double>(Instr.getConstValue())));
       break;
+    case OpCode::V128__const: {
+      const uint128_t Value = std::get<uint128_t>(Instr.getConstValue());
+      const uint64_t Lanes[2] = {uint64_t(Value), uint64_t(Value >> 64)};
+      Stack.push_back(llvm::ConstantDataVector::get(VMContext, Lanes));
+      break;
+    }
     default:
       __builtin_unreachable();
     }
@@ -1148,67 +1631,1023 @@ public:
     return {};
   }
 
-  static llvm::Constant *evaluate(const AST::InstrVec &Instrs,
-                                  AOT::Compiler::CompileContext &Context) {
-    FunctionCompiler FC(Context, nullptr, {}, false);
-    FC.compile(Instrs);
-    return llvm::cast<llvm::Constant>(FC.Stack.back());
-  }
-
-private:
-  Expect<void> compileCallOp(const unsigned int FuncIndex) {
-    const auto &FuncType =
-        *Context.FunctionTypes[std::get<0>(Context.Functions[FuncIndex])];
-    const auto &Function = std::get<1>(Context.Functions[FuncIndex]);
-
-    if (Stack.size() < FuncType.getParamTypes().size()) {
-      return Unexpect(ErrCode::ValidationFailed);
-    }
-    auto Begin = Stack.end() - FuncType.getParamTypes().size();
-    auto End = Stack.end();
-    std::vector<llvm::Value *> Args = {Ctx};
-    Args.insert(Args.end(), Begin, End);
-
-    llvm::Value *Ret = Builder.CreateCall(Function, Args);
-    Stack.erase(Begin, End);
-    llvm::Type *Ty = Function->getReturnType();
-    if (Ty->isVoidTy()) {
-      // nothing to do
-    } else if (Ty->isStructTy()) {
-      for (auto *Val : unpackStruct(Builder, Ret)) {
-        Stack.push_back(Val);
-      }
-    } else {
-      Stack.push_back(Ret);
+  Expect<void> compile(const AST::SIMDMemoryInstruction &Instr) {
+    const unsigned Offset = Instr.getMemoryOffset();
+    const unsigned Alignment = Instr.getMemoryAlign();
+    const unsigned Lane = Instr.getLaneIndex();
+    switch (Instr.getOpCode()) {
+    case OpCode::V128__load:
+      return compileVectorLoadOp(Offset, Alignment, Int64x2Ty);
+    case OpCode::V128__load8x8_s:
+      return compileVectorLoadOp(Offset, Alignment,
+                                 llvm::VectorType::get(Builder.getInt8Ty(), 8),
+                                 Int16x8Ty, true);
+    case OpCode::V128__load8x8_u:
+      return compileVectorLoadOp(Offset, Alignment,
+                                 llvm::VectorType::get(Builder.getInt8Ty(), 8),
+                                 Int16x8Ty, false);
+    case OpCode::V128__load16x4_s:
+      return compileVectorLoadOp(Offset, Alignment,
+                                 llvm::VectorType::get(Builder.getInt16Ty(), 4),
+                                 Int32x4Ty, true);
+    case OpCode::V128__load16x4_u:
+      return compileVectorLoadOp(Offset, Alignment,
+                                 llvm::VectorType::get(Builder.getInt16Ty(), 4),
+                                 Int32x4Ty, false);
+    case OpCode::V128__load32x2_s:
+      return compileVectorLoadOp(Offset, Alignment,
+                                 llvm::VectorType::get(Builder.getInt32Ty(), 2),
+                                 Int64x2Ty, true);
+    case OpCode::V128__load32x2_u:
+      return compileVectorLoadOp(Offset, Alignment,
+                                 llvm::VectorType::get(Builder.getInt32Ty(), 2),
+                                 Int64x2Ty, false);
+    case OpCode::V128__load8_splat:
+      return compileSplatLoadOp(Offset, Alignment, Int8x16Ty);
+    case OpCode::V128__load16_splat:
+      return compileSplatLoadOp(Offset, Alignment, Int16x8Ty);
+    case OpCode::V128__load32_splat:
+      return compileSplatLoadOp(Offset, Alignment, Int32x4Ty);
+    case OpCode::V128__load64_splat:
+      return compileSplatLoadOp(Offset, Alignment, Int64x2Ty);
+    case OpCode::V128__load32_zero:
+      return compileLoadLaneOp(Offset, Alignment, 0, Int32x4Ty, true);
+    case OpCode::V128__load64_zero:
+      return compileLoadLaneOp(Offset, Alignment, 0, Int64x2Ty, true);
+    case OpCode::V128__load8_lane:
+      return compileLoadLaneOp(Offset, Alignment, Lane, Int8x16Ty);
+    case OpCode::V128__load16_lane:
+      return compileLoadLaneOp(Offset, Alignment, Lane, Int16x8Ty);
+    case OpCode::V128__load32_lane:
+      return compileLoadLaneOp(Offset, Alignment, Lane, Int32x4Ty);
+    case OpCode::V128__load64_lane:
+      return compileLoadLaneOp(Offset, Alignment, Lane, Int64x2Ty);
+    case OpCode::V128__store:
+      return compileStoreOp(Offset, Alignment, Int64x2Ty);
+    case OpCode::V128__store8_lane:
+      return compileStoreLaneOp(Offset, Alignment, Lane, Int8x16Ty);
+    case OpCode::V128__store16_lane:
+      return compileStoreLaneOp(Offset, Alignment, Lane, Int16x8Ty);
+    case OpCode::V128__store32_lane:
+      return compileStoreLaneOp(Offset, Alignment, Lane, Int32x4Ty);
+    case OpCode::V128__store64_lane:
+      return compileStoreLaneOp(Offset, Alignment, Lane, Int64x2Ty);
+    default:
+      __builtin_unreachable();
     }
-
-    Builder.CreateStore(Builder.CreateLoad(Context.Mem), LocalMemPtr);
-    return {};
   }
-
-  Expect<void> compileIndirectCallOp(const unsigned int FuncTypeIndex) {
-    const auto &FuncType = *Context.FunctionTypes[FuncTypeIndex];
-    if (Stack.size() < FuncType.getParamTypes().size()) {
-      return Unexpect(ErrCode::ValidationFailed);
-    }
-    auto Begin = Stack.end() - FuncType.getParamTypes().size() - 1;
-    auto End = Stack.end() - 1;
-    std::vector<llvm::Value *> Args = {Ctx};
-    Args.insert(Args.end(), Begin, End);
-
-    std::vector<std::pair<size_t, llvm::Function *>> Table;
-    for (uint32_t I = 0; I < Context.Elements.size(); ++I) {
-      const size_t FuncIdx = Context.Elements[I];
-      if (std::get<0>(Context.Functions[FuncIdx]) == FuncTypeIndex) {
-        Table.emplace_back(I, std::get<1>(Context.Functions[FuncIdx]));
-      }
+  Expect<void> compile(const AST::SIMDLaneInstruction &Instr) {
+    const unsigned Lane = Instr.getLaneIndex();
+    switch (Instr.getOpCode()) {
+    case OpCode::I8x16__extract_lane_s:
+      return compileExtractLaneOp(Int8x16Ty, Lane, Builder.getInt32Ty(), true);
+    case OpCode::I8x16__extract_lane_u:
+      return compileExtractLaneOp(Int8x16Ty, Lane, Builder.getInt32Ty(), false);
+    case OpCode::I16x8__extract_lane_s:
+      return compileExtractLaneOp(Int16x8Ty, Lane, Builder.getInt32Ty(), true);
+    case OpCode::I16x8__extract_lane_u:
+      return compileExtractLaneOp(Int16x8Ty, Lane, Builder.getInt32Ty(), false);
+    case OpCode::I32x4__extract_lane:
+      return compileExtractLaneOp(Int32x4Ty, Lane);
+    case OpCode::I64x2__extract_lane:
+      return compileExtractLaneOp(Int64x2Ty, Lane);
+    case OpCode::F32x4__extract_lane:
+      return compileExtractLaneOp(Floatx4Ty, Lane);
+    case OpCode::F64x2__extract_lane:
+      return compileExtractLaneOp(Doublex2Ty, Lane);
+    case OpCode::I8x16__replace_lane:
+      return compileReplaceLaneOp(Int8x16Ty, Lane);
+    case OpCode::I16x8__replace_lane:
+      return compileReplaceLaneOp(Int16x8Ty, Lane);
+    case OpCode::I32x4__replace_lane:
+      return compileReplaceLaneOp(Int32x4Ty, Lane);
+    case OpCode::I64x2__replace_lane:
+      return compileReplaceLaneOp(Int64x2Ty, Lane);
+    case OpCode::F32x4__replace_lane:
+      return compileReplaceLaneOp(Floatx4Ty, Lane);
+    case OpCode::F64x2__replace_lane:
+      return compileReplaceLaneOp(Doublex2Ty, Lane);
+    default:
+      __builtin_unreachable();
     }
-    llvm::BasicBlock *OK =
+  }
+  Expect<void> compile(const AST::SIMDShuffleInstruction &Instr) {
+    const auto &Lanes = Instr.getShuffleLanes();
+    const std::vector<uint32_t> Mask(Lanes.begin(), Lanes.end());
+    return compileVectorVectorOp(
+        Int8x16Ty, [this, &Mask](llvm::Value *LHS, llvm::Value *RHS) {
+          return Builder.CreateShuffleVector(LHS, RHS, getShuffleMask(Mask));
+        });
+  }
+  Expect<void> compile(const AST::SIMDNumericInstruction &Instr) {
+    switch (Instr.getOpCode()) {
+    case OpCode::I8x16__swizzle:
+      return compileVectorSwizzleOp();
+    case OpCode::I8x16__splat:
+      return compileSplatOp(Int8x16Ty);
+    case OpCode::I16x8__splat:
+      return compileSplatOp(Int16x8Ty);
+    case OpCode::I32x4__splat:
+      return compileSplatOp(Int32x4Ty);
+    case OpCode::I64x2__splat:
+      return compileSplatOp(Int64x2Ty);
+    case OpCode::F32x4__splat:
+      return compileSplatOp(Floatx4Ty);
+    case OpCode::F64x2__splat:
+      return compileSplatOp(Doublex2Ty);
+    case OpCode::I8x16__eq:
+      return compileVectorCompareOp(Int8x16Ty, llvm::CmpInst::ICMP_EQ);
+    case OpCode::I8x16__ne:
+      return compileVectorCompareOp(Int8x16Ty, llvm::CmpInst::ICMP_NE);
+    case OpCode::I8x16__lt_s:
+      return compileVectorCompareOp(Int8x16Ty, llvm::CmpInst::ICMP_SLT);
+    case OpCode::I8x16__lt_u:
+      return compileVectorCompareOp(Int8x16Ty, llvm::CmpInst::ICMP_ULT);
+    case OpCode::I8x16__gt_s:
+      return compileVectorCompareOp(Int8x16Ty, llvm::CmpInst::ICMP_SGT);
+    case OpCode::I8x16__gt_u:
+      return compileVectorCompareOp(Int8x16Ty, llvm::CmpInst::ICMP_UGT);
+    case OpCode::I8x16__le_s:
+      return compileVectorCompareOp(Int8x16Ty, llvm::CmpInst::ICMP_SLE);
+    case OpCode::I8x16__le_u:
+      return compileVectorCompareOp(Int8x16Ty, llvm::CmpInst::ICMP_ULE);
+    case OpCode::I8x16__ge_s:
+      return compileVectorCompareOp(Int8x16Ty, llvm::CmpInst::ICMP_SGE);
+    case OpCode::I8x16__ge_u:
+      return compileVectorCompareOp(Int8x16Ty, llvm::CmpInst::ICMP_UGE);
+    case OpCode::I16x8__eq:
+      return compileVectorCompareOp(Int16x8Ty, llvm::CmpInst::ICMP_EQ);
+    case OpCode::I16x8__ne:
+      return compileVectorCompareOp(Int16x8Ty, llvm::CmpInst::ICMP_NE);
+    case OpCode::I16x8__lt_s:
+      return compileVectorCompareOp(Int16x8Ty, llvm::CmpInst::ICMP_SLT);
+    case OpCode::I16x8__lt_u:
+      return compileVectorCompareOp(Int16x8Ty, llvm::CmpInst::ICMP_ULT);
+    case OpCode::I16x8__gt_s:
+      return compileVectorCompareOp(Int16x8Ty, llvm::CmpInst::ICMP_SGT);
+    case OpCode::I16x8__gt_u:
+      return compileVectorCompareOp(Int16x8Ty, llvm::CmpInst::ICMP_UGT);
+    case OpCode::I16x8__le_s:
+      return compileVectorCompareOp(Int16x8Ty, llvm::CmpInst::ICMP_SLE);
+    case OpCode::I16x8__le_u:
+      return compileVectorCompareOp(Int16x8Ty, llvm::CmpInst::ICMP_ULE);
+    case OpCode::I16x8__ge_s:
+      return compileVectorCompareOp(Int16x8Ty, llvm::CmpInst::ICMP_SGE);
+    case OpCode::I16x8__ge_u:
+      return compileVectorCompareOp(Int16x8Ty, llvm::CmpInst::ICMP_UGE);
+    case OpCode::I32x4__eq:
+      return compileVectorCompareOp(Int32x4Ty, llvm::CmpInst::ICMP_EQ);
+    case OpCode::I32x4__ne:
+      return compileVectorCompareOp(Int32x4Ty, llvm::CmpInst::ICMP_NE);
+    case OpCode::I32x4__lt_s:
+      return compileVectorCompareOp(Int32x4Ty, llvm::CmpInst::ICMP_SLT);
+    case OpCode::I32x4__lt_u:
+      return compileVectorCompareOp(Int32x4Ty, llvm::CmpInst::ICMP_ULT);
+    case OpCode::I32x4__gt_s:
+      return compileVectorCompareOp(Int32x4Ty, llvm::CmpInst::ICMP_SGT);
+    case OpCode::I32x4__gt_u:
+      return compileVectorCompareOp(Int32x4Ty, llvm::CmpInst::ICMP_UGT);
+    case OpCode::I32x4__le_s:
+      return compileVectorCompareOp(Int32x4Ty, llvm::CmpInst::ICMP_SLE);
+    case OpCode::I32x4__le_u:
+      return compileVectorCompareOp(Int32x4Ty, llvm::CmpInst::ICMP_ULE);
+    case OpCode::I32x4__ge_s:
+      return compileVectorCompareOp(Int32x4Ty, llvm::CmpInst::ICMP_SGE);
+    case OpCode::I32x4__ge_u:
+      return compileVectorCompareOp(Int32x4Ty, llvm::CmpInst::ICMP_UGE);
+    case OpCode::F32x4__eq:
+      return compileVectorCompareOp(Floatx4Ty, llvm::CmpInst::FCMP_OEQ);
+    case OpCode::F32x4__ne:
+      return compileVectorCompareOp(Floatx4Ty, llvm::CmpInst::FCMP_UNE);
+    case OpCode::F32x4__lt:
+      return compileVectorCompareOp(Floatx4Ty, llvm::CmpInst::FCMP_OLT);
+    case OpCode::F32x4__gt:
+      return compileVectorCompareOp(Floatx4Ty, llvm::CmpInst::FCMP_OGT);
+    case OpCode::F32x4__le:
+      return compileVectorCompareOp(Floatx4Ty, llvm::CmpInst::FCMP_OLE);
+    case OpCode::F32x4__ge:
+      return compileVectorCompareOp(Floatx4Ty, llvm::CmpInst::FCMP_OGE);
+    case OpCode::F64x2__eq:
+      return compileVectorCompareOp(Doublex2Ty, llvm::CmpInst::FCMP_OEQ);
+    case OpCode::F64x2__ne:
+      return compileVectorCompareOp(Doublex2Ty, llvm::CmpInst::FCMP_UNE);
+    case OpCode::F64x2__lt:
+      return compileVectorCompareOp(Doublex2Ty, llvm::CmpInst::FCMP_OLT);
+    case OpCode::F64x2__gt:
+      return compileVectorCompareOp(Doublex2Ty, llvm::CmpInst::FCMP_OGT);
+    case OpCode::F64x2__le:
+      return compileVectorCompareOp(Doublex2Ty, llvm::CmpInst::FCMP_OLE);
+    case OpCode::F64x2__ge:
+      return compileVectorCompareOp(Doublex2Ty, llvm::CmpInst::FCMP_OGE);
+    case OpCode::V128__not:
+      return compileVectorOp(
+          Int64x2Ty, [this](llvm::Value *V) { return Builder.CreateNot(V); });
+    case OpCode::V128__and:
+      return compileVectorVectorOp(
+          Int64x2Ty, [this](llvm::Value *LHS, llvm::Value *RHS) {
+            return Builder.CreateAnd(LHS, RHS);
+          });
+    case OpCode::V128__andnot:
+      return compileVectorVectorOp(
+          Int64x2Ty, [this](llvm::Value *LHS, llvm::Value *RHS) {
+            return Builder.CreateAnd(LHS, Builder.CreateNot(RHS));
+          });
+    case OpCode::V128__or:
+      return compileVectorVectorOp(
+          Int64x2Ty, [this](llvm::Value *LHS, llvm::Value *RHS) {
+            return Builder.CreateOr(LHS, RHS);
+          });
+    case OpCode::V128__xor:
+      return compileVectorVectorOp(
+          Int64x2Ty, [this](llvm::Value *LHS, llvm::Value *RHS) {
+            return Builder.CreateXor(LHS, RHS);
+          });
+    case OpCode::V128__bitselect:
+    {
+      llvm::Value *Mask = Stack.back();
+      Stack.pop_back();
+      llvm::Value *RHS = Stack.back();
+      Stack.pop_back();
+      Stack.back() =
+          Builder.CreateOr(Builder.CreateAnd(Stack.back(), Mask),
+                           Builder.CreateAnd(RHS, Builder.CreateNot(Mask)));
+      return {};
+    }
+    case OpCode::V128__any_true:
+      Stack.back() = Builder.CreateZExt(
+          Builder.CreateICmpNE(
+              Builder.CreateBitCast(Stack.back(), Builder.getIntNTy(128)),
+              Builder.getIntN(128, 0)),
+          Builder.getInt32Ty());
+      return {};
+    case OpCode::F32x4__demote_f64x2_zero:
+      return compileVectorOp(Doublex2Ty, [this](llvm::Value *V) {
+        return Builder.CreateShuffleVector(
+            Builder.CreateFPTrunc(V, llvm::VectorType::get(
+                                         Builder.getFloatTy(), 2)),
+            llvm::ConstantAggregateZero::get(
+                llvm::VectorType::get(Builder.getFloatTy(), 2)),
+            getShuffleMask({0, 1, 2, 3}));
+      });
+    case OpCode::F64x2__promote_low_f32x4:
+      return compileVectorOp(Floatx4Ty, [this](llvm::Value *V) {
+        return Builder.CreateFPExt(createVectorHalf(V, 2, true), Doublex2Ty);
+      });
+    case OpCode::I8x16__abs:
+      return compileVectorAbsOp(Int8x16Ty);
+    case OpCode::I8x16__neg:
+      return compileVectorOp(
+          Int8x16Ty, [this](llvm::Value *V) { return Builder.CreateNeg(V); });
+    case OpCode::I8x16__popcnt:
+      return compileVectorOp(Int8x16Ty, [this](llvm::Value *V) {
+        return Builder.CreateUnaryIntrinsic(llvm::Intrinsic::ctpop, V);
+      });
+    case OpCode::I8x16__all_true:
+      return compileVectorAllTrueOp(Int8x16Ty);
+    case OpCode::I8x16__bitmask:
+      return compileVectorBitMaskOp(Int8x16Ty);
+    case OpCode::I8x16__narrow_i16x8_s:
+      return compileVectorNarrowOp(Int16x8Ty, true);
+    case OpCode::I8x16__narrow_i16x8_u:
+      return compileVectorNarrowOp(Int16x8Ty, false);
+    case OpCode::F32x4__ceil:
+      return compileVectorOp(Floatx4Ty, [this](llvm::Value *V) {
+        return Builder.CreateUnaryIntrinsic(llvm::Intrinsic::ceil, V);
+      });
+    case OpCode::F32x4__floor:
+      return compileVectorOp(Floatx4Ty, [this](llvm::Value *V) {
+        return Builder.CreateUnaryIntrinsic(llvm::Intrinsic::floor, V);
+      });
+    case OpCode::F32x4__trunc:
+      return compileVectorOp(Floatx4Ty, [this](llvm::Value *V) {
+        return Builder.CreateUnaryIntrinsic(llvm::Intrinsic::trunc, V);
+      });
+    case OpCode::F32x4__nearest:
+      return compileVectorOp(Floatx4Ty, [this](llvm::Value *V) {
+        return Builder.CreateUnaryIntrinsic(llvm::Intrinsic::nearbyint, V);
+      });
+    case OpCode::I8x16__shl:
+      return compileVectorShiftOp(Int8x16Ty, llvm::Instruction::Shl);
+    case OpCode::I8x16__shr_s:
+      return compileVectorShiftOp(Int8x16Ty, llvm::Instruction::AShr);
+    case OpCode::I8x16__shr_u:
+      return compileVectorShiftOp(Int8x16Ty, llvm::Instruction::LShr);
+    case OpCode::I8x16__add:
+      return compileVectorVectorOp(
+          Int8x16Ty, [this](llvm::Value *LHS, llvm::Value *RHS) {
+            return Builder.CreateAdd(LHS, RHS);
+          });
+    case OpCode::I8x16__add_sat_s:
+      return compileVectorVectorOp(
+          Int8x16Ty, [this](llvm::Value *LHS, llvm::Value *RHS) {
+            return Builder.CreateBinaryIntrinsic(llvm::Intrinsic::sadd_sat, LHS,
+                                                 RHS);
+          });
+    case OpCode::I8x16__add_sat_u:
+      return compileVectorVectorOp(
+          Int8x16Ty, [this](llvm::Value *LHS, llvm::Value *RHS) {
+            return Builder.CreateBinaryIntrinsic(llvm::Intrinsic::uadd_sat, LHS,
+                                                 RHS);
+          });
+    case OpCode::I8x16__sub:
+      return compileVectorVectorOp(
+          Int8x16Ty, [this](llvm::Value *LHS, llvm::Value *RHS) {
+            return Builder.CreateSub(LHS, RHS);
+          });
+    case OpCode::I8x16__sub_sat_s:
+      return compileVectorVectorOp(
+          Int8x16Ty, [this](llvm::Value *LHS, llvm::Value *RHS) {
+            return Builder.CreateBinaryIntrinsic(llvm::Intrinsic::ssub_sat, LHS,
+                                                 RHS);
+          });
+    case OpCode::I8x16__sub_sat_u:
+      return compileVectorVectorOp(
+          Int8x16Ty, [this](llvm::Value *LHS, llvm::Value *RHS) {
+            return Builder.CreateBinaryIntrinsic(llvm::Intrinsic::usub_sat, LHS,
+                                                 RHS);
+          });
+    case OpCode::F64x2__ceil:
+      return compileVectorOp(Doublex2Ty, [this](llvm::Value *V) {
+        return Builder.CreateUnaryIntrinsic(llvm::Intrinsic::ceil, V);
+      });
+    case OpCode::F64x2__floor:
+      return compileVectorOp(Doublex2Ty, [this](llvm::Value *V) {
+        return Builder.CreateUnaryIntrinsic(llvm::Intrinsic::floor, V);
+      });
+    case OpCode::I8x16__min_s:
+      return compileVectorSelectOp(Int8x16Ty, llvm::CmpInst::ICMP_SLT);
+    case OpCode::I8x16__min_u:
+      return compileVectorSelectOp(Int8x16Ty, llvm::CmpInst::ICMP_ULT);
+    case OpCode::I8x16__max_s:
+      return compileVectorSelectOp(Int8x16Ty, llvm::CmpInst::ICMP_SGT);
+    case OpCode::I8x16__max_u:
+      return compileVectorSelectOp(Int8x16Ty, llvm::CmpInst::ICMP_UGT);
+    case OpCode::F64x2__trunc:
+      return compileVectorOp(Doublex2Ty, [this](llvm::Value *V) {
+        return Builder.CreateUnaryIntrinsic(llvm::Intrinsic::trunc, V);
+      });
+    case OpCode::I8x16__avgr_u:
+      return compileVectorAvgrOp(Int8x16Ty);
+    case OpCode::I16x8__extadd_pairwise_i8x16_s:
+      return compileVectorExtAddPairwiseOp(Int8x16Ty, true);
+    case OpCode::I16x8__extadd_pairwise_i8x16_u:
+      return compileVectorExtAddPairwiseOp(Int8x16Ty, false);
+    case OpCode::I32x4__extadd_pairwise_i16x8_s:
+      return compileVectorExtAddPairwiseOp(Int16x8Ty, true);
+    case OpCode::I32x4__extadd_pairwise_i16x8_u:
+      return compileVectorExtAddPairwiseOp(Int16x8Ty, false);
+    case OpCode::I16x8__abs:
+      return compileVectorAbsOp(Int16x8Ty);
+    case OpCode::I16x8__neg:
+      return compileVectorOp(
+          Int16x8Ty, [this](llvm::Value *V) { return Builder.CreateNeg(V); });
+    case OpCode::I16x8__q15mulr_sat_s:
+      return compileVectorQ15MulSatOp();
+    case OpCode::I16x8__all_true:
+      return compileVectorAllTrueOp(Int16x8Ty);
+    case OpCode::I16x8__bitmask:
+      return compileVectorBitMaskOp(Int16x8Ty);
+    case OpCode::I16x8__narrow_i32x4_s:
+      return compileVectorNarrowOp(Int32x4Ty, true);
+    case OpCode::I16x8__narrow_i32x4_u:
+      return compileVectorNarrowOp(Int32x4Ty, false);
+    case OpCode::I16x8__extend_low_i8x16_s:
+      return compileVectorExtendOp(Int8x16Ty, true, true);
+    case OpCode::I16x8__extend_high_i8x16_s:
+      return compileVectorExtendOp(Int8x16Ty, true, false);
+    case OpCode::I16x8__extend_low_i8x16_u:
+      return compileVectorExtendOp(Int8x16Ty, false, true);
+    case OpCode::I16x8__extend_high_i8x16_u:
+      return compileVectorExtendOp(Int8x16Ty, false, false);
+    case OpCode::I16x8__shl:
+      return compileVectorShiftOp(Int16x8Ty, llvm::Instruction::Shl);
+    case OpCode::I16x8__shr_s:
+      return compileVectorShiftOp(Int16x8Ty, llvm::Instruction::AShr);
+    case OpCode::I16x8__shr_u:
+      return compileVectorShiftOp(Int16x8Ty, llvm::Instruction::LShr);
+    case OpCode::I16x8__add:
+      return compileVectorVectorOp(
+          Int16x8Ty, [this](llvm::Value *LHS, llvm::Value *RHS) {
+            return Builder.CreateAdd(LHS, RHS);
+          });
+    case OpCode::I16x8__add_sat_s:
+      return compileVectorVectorOp(
+          Int16x8Ty, [this](llvm::Value *LHS, llvm::Value *RHS) {
+            return Builder.CreateBinaryIntrinsic(llvm::Intrinsic::sadd_sat, LHS,
+                                                 RHS);
+          });
+    case OpCode::I16x8__add_sat_u:
+      return compileVectorVectorOp(
+          Int16x8Ty, [this](llvm::Value *LHS, llvm::Value *RHS) {
+            return Builder.CreateBinaryIntrinsic(llvm::Intrinsic::uadd_sat, LHS,
+                                                 RHS);
+          });
+    case OpCode::I16x8__sub:
+      return compileVectorVectorOp(
+          Int16x8Ty, [this](llvm::Value *LHS, llvm::Value *RHS) {
+            return Builder.CreateSub(LHS, RHS);
+          });
+    case OpCode::I16x8__sub_sat_s:
+      return compileVectorVectorOp(
+          Int16x8Ty, [this](llvm::Value *LHS, llvm::Value *RHS) {
+            return Builder.CreateBinaryIntrinsic(llvm::Intrinsic::ssub_sat, LHS,
+                                                 RHS);
+          });
+    case OpCode::I16x8__sub_sat_u:
+      return compileVectorVectorOp(
+          Int16x8Ty, [this](llvm::Value *LHS, llvm::Value *RHS) {
+            return Builder.CreateBinaryIntrinsic(llvm::Intrinsic::usub_sat, LHS,
+                                                 RHS);
+          });
+    case OpCode::F64x2__nearest:
+      return compileVectorOp(Doublex2Ty, [this](llvm::Value *V) {
+        return Builder.CreateUnaryIntrinsic(llvm::Intrinsic::nearbyint, V);
+      });
+    case OpCode::I16x8__mul:
+      return compileVectorVectorOp(
+          Int16x8Ty, [this](llvm::Value *LHS, llvm::Value *RHS) {
+            return Builder.CreateMul(LHS, RHS);
+          });
+    case OpCode::I16x8__min_s:
+      return compileVectorSelectOp(Int16x8Ty, llvm::CmpInst::ICMP_SLT);
+    case OpCode::I16x8__min_u:
+      return compileVectorSelectOp(Int16x8Ty, llvm::CmpInst::ICMP_ULT);
+    case OpCode::I16x8__max_s:
+      return compileVectorSelectOp(Int16x8Ty, llvm::CmpInst::ICMP_SGT);
+    case OpCode::I16x8__max_u:
+      return compileVectorSelectOp(Int16x8Ty, llvm::CmpInst::ICMP_UGT);
+    case OpCode::I16x8__avgr_u:
+      return compileVectorAvgrOp(Int16x8Ty);
+    case OpCode::I16x8__extmul_low_i8x16_s:
+      return compileVectorExtMulOp(Int8x16Ty, true, true);
+    case OpCode::I16x8__extmul_high_i8x16_s:
+      return compileVectorExtMulOp(Int8x16Ty, true, false);
+    case OpCode::I16x8__extmul_low_i8x16_u:
+      return compileVectorExtMulOp(Int8x16Ty, false, true);
+    case OpCode::I16x8__extmul_high_i8x16_u:
+      return compileVectorExtMulOp(Int8x16Ty, false, false);
+    case OpCode::I32x4__abs:
+      return compileVectorAbsOp(Int32x4Ty);
+    case OpCode::I32x4__neg:
+      return compileVectorOp(
+          Int32x4Ty, [this](llvm::Value *V) { return Builder.CreateNeg(V); });
+    case OpCode::I32x4__all_true:
+      return compileVectorAllTrueOp(Int32x4Ty);
+    case OpCode::I32x4__bitmask:
+      return compileVectorBitMaskOp(Int32x4Ty);
+    case OpCode::I32x4__extend_low_i16x8_s:
+      return compileVectorExtendOp(Int16x8Ty, true, true);
+    case OpCode::I32x4__extend_high_i16x8_s:
+      return compileVectorExtendOp(Int16x8Ty, true, false);
+    case OpCode::I32x4__extend_low_i16x8_u:
+      return compileVectorExtendOp(Int16x8Ty, false, true);
+    case OpCode::I32x4__extend_high_i16x8_u:
+      return compileVectorExtendOp(Int16x8Ty, false, false);
+    case OpCode::I32x4__shl:
+      return compileVectorShiftOp(Int32x4Ty, llvm::Instruction::Shl);
+    case OpCode::I32x4__shr_s:
+      return compileVectorShiftOp(Int32x4Ty, llvm::Instruction::AShr);
+    case OpCode::I32x4__shr_u:
+      return compileVectorShiftOp(Int32x4Ty, llvm::Instruction::LShr);
+    case OpCode::I32x4__add:
+      return compileVectorVectorOp(
+          Int32x4Ty, [this](llvm::Value *LHS, llvm::Value *RHS) {
+            return Builder.CreateAdd(LHS, RHS);
+          });
+    case OpCode::I32x4__sub:
+      return compileVectorVectorOp(
+          Int32x4Ty, [this](llvm::Value *LHS, llvm::Value *RHS) {
+            return Builder.CreateSub(LHS, RHS);
+          });
+    case OpCode::I32x4__mul:
+      return compileVectorVectorOp(
+          Int32x4Ty, [this](llvm::Value *LHS, llvm::Value *RHS) {
+            return Builder.CreateMul(LHS, RHS);
+          });
+    case OpCode::I32x4__min_s:
+      return compileVectorSelectOp(Int32x4Ty, llvm::CmpInst::ICMP_SLT);
+    case OpCode::I32x4__min_u:
+      return compileVectorSelectOp(Int32x4Ty, llvm::CmpInst::ICMP_ULT);
+    case OpCode::I32x4__max_s:
+      return compileVectorSelectOp(Int32x4Ty, llvm::CmpInst::ICMP_SGT);
+    case OpCode::I32x4__max_u:
+      return compileVectorSelectOp(Int32x4Ty, llvm::CmpInst::ICMP_UGT);
+    case OpCode::I32x4__dot_i16x8_s:
+      return compileVectorDotOp();
+    case OpCode::I32x4__extmul_low_i16x8_s:
+      return compileVectorExtMulOp(Int16x8Ty, true, true);
+    case OpCode::I32x4__extmul_high_i16x8_s:
+      return compileVectorExtMulOp(Int16x8Ty, true, false);
+    case OpCode::I32x4__extmul_low_i16x8_u:
+      return compileVectorExtMulOp(Int16x8Ty, false, true);
+    case OpCode::I32x4__extmul_high_i16x8_u:
+      return compileVectorExtMulOp(Int16x8Ty, false, false);
+    case OpCode::I64x2__abs:
+      return compileVectorAbsOp(Int64x2Ty);
+    case OpCode::I64x2__neg:
+      return compileVectorOp(
+          Int64x2Ty, [this](llvm::Value *V) { return Builder.CreateNeg(V); });
+    case OpCode::I64x2__all_true:
+      return compileVectorAllTrueOp(Int64x2Ty);
+    case OpCode::I64x2__bitmask:
+      return compileVectorBitMaskOp(Int64x2Ty);
+    case OpCode::I64x2__extend_low_i32x4_s:
+      return compileVectorExtendOp(Int32x4Ty, true, true);
+    case OpCode::I64x2__extend_high_i32x4_s:
+      return compileVectorExtendOp(Int32x4Ty, true, false);
+    case OpCode::I64x2__extend_low_i32x4_u:
+      return compileVectorExtendOp(Int32x4Ty, false, true);
+    case OpCode::I64x2__extend_high_i32x4_u:
+      return compileVectorExtendOp(Int32x4Ty, false, false);
+    case OpCode::I64x2__shl:
+      return compileVectorShiftOp(Int64x2Ty, llvm::Instruction::Shl);
+    case OpCode::I64x2__shr_s:
+      return compileVectorShiftOp(Int64x2Ty, llvm::Instruction::AShr);
+    case OpCode::I64x2__shr_u:
+      return compileVectorShiftOp(Int64x2Ty, llvm::Instruction::LShr);
+    case OpCode::I64x2__add:
+      return compileVectorVectorOp(
+          Int64x2Ty, [this](llvm::Value *LHS, llvm::Value *RHS) {
+            return Builder.CreateAdd(LHS, RHS);
+          });
+    case OpCode::I64x2__sub:
+      return compileVectorVectorOp(
+          Int64x2Ty, [this](llvm::Value *LHS, llvm::Value *RHS) {
+            return Builder.CreateSub(LHS, RHS);
+          });
+    case OpCode::I64x2__mul:
+      return compileVectorVectorOp(
+          Int64x2Ty, [this](llvm::Value *LHS, llvm::Value *RHS) {
+            return Builder.CreateMul(LHS, RHS);
+          });
+    case OpCode::I64x2__eq:
+      return compileVectorCompareOp(Int64x2Ty, llvm::CmpInst::ICMP_EQ);
+    case OpCode::I64x2__ne:
+      return compileVectorCompareOp(Int64x2Ty, llvm::CmpInst::ICMP_NE);
+    case OpCode::I64x2__lt_s:
+      return compileVectorCompareOp(Int64x2Ty, llvm::CmpInst::ICMP_SLT);
+    case OpCode::I64x2__gt_s:
+      return compileVectorCompareOp(Int64x2Ty, llvm::CmpInst::ICMP_SGT);
+    case OpCode::I64x2__le_s:
+      return compileVectorCompareOp(Int64x2Ty, llvm::CmpInst::ICMP_SLE);
+    case OpCode::I64x2__ge_s:
+      return compileVectorCompareOp(Int64x2Ty, llvm::CmpInst::ICMP_SGE);
+    case OpCode::I64x2__extmul_low_i32x4_s:
+      return compileVectorExtMulOp(Int32x4Ty, true, true);
+    case OpCode::I64x2__extmul_high_i32x4_s:
+      return compileVectorExtMulOp(Int32x4Ty, true, false);
+    case OpCode::I64x2__extmul_low_i32x4_u:
+      return compileVectorExtMulOp(Int32x4Ty, false, true);
+    case OpCode::I64x2__extmul_high_i32x4_u:
+      return compileVectorExtMulOp(Int32x4Ty, false, false);
+    case OpCode::F32x4__abs:
+      return compileVectorOp(Floatx4Ty, [this](llvm::Value *V) {
+        return Builder.CreateUnaryIntrinsic(llvm::Intrinsic::fabs, V);
+      });
+    case OpCode::F32x4__neg:
+      return compileVectorOp(
+          Floatx4Ty, [this](llvm::Value *V) { return Builder.CreateFNeg(V); });
+    case OpCode::F32x4__sqrt:
+      return compileVectorOp(Floatx4Ty, [this](llvm::Value *V) {
+        return Builder.CreateUnaryIntrinsic(llvm::Intrinsic::sqrt, V);
+      });
+    case OpCode::F32x4__add:
+      return compileVectorVectorOp(
+          Floatx4Ty, [this](llvm::Value *LHS, llvm::Value *RHS) {
+            return Builder.CreateFAdd(LHS, RHS);
+          });
+    case OpCode::F32x4__sub:
+      return compileVectorVectorOp(
+          Floatx4Ty, [this](llvm::Value *LHS, llvm::Value *RHS) {
+            return Builder.CreateFSub(LHS, RHS);
+          });
+    case OpCode::F32x4__mul:
+      return compileVectorVectorOp(
+          Floatx4Ty, [this](llvm::Value *LHS, llvm::Value *RHS) {
+            return Builder.CreateFMul(LHS, RHS);
+          });
+    case OpCode::F32x4__div:
+      return compileVectorVectorOp(
+          Floatx4Ty, [this](llvm::Value *LHS, llvm::Value *RHS) {
+            return Builder.CreateFDiv(LHS, RHS);
+          });
+    case OpCode::F32x4__min:
+      return compileVectorFMinMaxOp(Floatx4Ty, true);
+    case OpCode::F32x4__max:
+      return compileVectorFMinMaxOp(Floatx4Ty, false);
+    case OpCode::F32x4__pmin:
+      return compileVectorPMinMaxOp(Floatx4Ty, true);
+    case OpCode::F32x4__pmax:
+      return compileVectorPMinMaxOp(Floatx4Ty, false);
+    case OpCode::F64x2__abs:
+      return compileVectorOp(Doublex2Ty, [this](llvm::Value *V) {
+        return Builder.CreateUnaryIntrinsic(llvm::Intrinsic::fabs, V);
+      });
+    case OpCode::F64x2__neg:
+      return compileVectorOp(
+          Doublex2Ty, [this](llvm::Value *V) { return Builder.CreateFNeg(V); });
+    case OpCode::F64x2__sqrt:
+      return compileVectorOp(Doublex2Ty, [this](llvm::Value *V) {
+        return Builder.CreateUnaryIntrinsic(llvm::Intrinsic::sqrt, V);
+      });
+    case OpCode::F64x2__add:
+      return compileVectorVectorOp(
+          Doublex2Ty, [this](llvm::Value *LHS, llvm::Value *RHS) {
+            return Builder.CreateFAdd(LHS, RHS);
+          });
+    case OpCode::F64x2__sub:
+      return compileVectorVectorOp(
+          Doublex2Ty, [this](llvm::Value *LHS, llvm::Value *RHS) {
+            return Builder.CreateFSub(LHS, RHS);
+          });
+    case OpCode::F64x2__mul:
+      return compileVectorVectorOp(
+          Doublex2Ty, [this](llvm::Value *LHS, llvm::Value *RHS) {
+            return Builder.CreateFMul(LHS, RHS);
+          });
+    case OpCode::F64x2__div:
+      return compileVectorVectorOp(
+          Doublex2Ty, [this](llvm::Value *LHS, llvm::Value *RHS) {
+            return Builder.CreateFDiv(LHS, RHS);
+          });
+    case OpCode::F64x2__min:
+      return compileVectorFMinMaxOp(Doublex2Ty, true);
+    case OpCode::F64x2__max:
+      return compileVectorFMinMaxOp(Doublex2Ty, false);
+    case OpCode::F64x2__pmin:
+      return compileVectorPMinMaxOp(Doublex2Ty, true);
+    case OpCode::F64x2__pmax:
+      return compileVectorPMinMaxOp(Doublex2Ty, false);
+    case OpCode::I32x4__trunc_sat_f32x4_s:
+      return compileVectorTruncSatOp(Floatx4Ty, true);
+    case OpCode::I32x4__trunc_sat_f32x4_u:
+      return compileVectorTruncSatOp(Floatx4Ty, false);
+    case OpCode::F32x4__convert_i32x4_s:
+      return compileVectorOp(Int32x4Ty, [this](llvm::Value *V) {
+        return Builder.CreateSIToFP(V, Floatx4Ty);
+      });
+    case OpCode::F32x4__convert_i32x4_u:
+      return compileVectorOp(Int32x4Ty, [this](llvm::Value *V) {
+        return Builder.CreateUIToFP(V, Floatx4Ty);
+      });
+    case OpCode::I32x4__trunc_sat_f64x2_s_zero:
+      return compileVectorTruncSatOp(Doublex2Ty, true);
+    case OpCode::I32x4__trunc_sat_f64x2_u_zero:
+      return compileVectorTruncSatOp(Doublex2Ty, false);
+    case OpCode::F64x2__convert_low_i32x4_s:
+      return compileVectorConvertLowOp(true);
+    case OpCode::F64x2__convert_low_i32x4_u:
+      return compileVectorConvertLowOp(false);
+    default:
+      __builtin_unreachable();
+    }
+  }
+  Expect<void> compile(const AST::AtomicMemoryInstruction &Instr) {
+    const unsigned Offset = Instr.getMemoryOffset();
+    switch (Instr.getOpCode()) {
+    case OpCode::Memory__atomic__notify:
+      return compileAtomicNotifyOp(Offset);
+    case OpCode::Memory__atomic__wait32:
+      return compileAtomicWaitOp(Offset, 32);
+    case OpCode::Memory__atomic__wait64:
+      return compileAtomicWaitOp(Offset, 64);
+    case OpCode::Atomic__fence:
+      Builder.CreateFence(llvm::AtomicOrdering::SequentiallyConsistent);
+      return {};
+    case OpCode::I32__atomic__load:
+      return compileAtomicLoadOp(Offset, Builder.getInt32Ty(),
+                                 Builder.getInt32Ty());
+    case OpCode::I64__atomic__load:
+      return compileAtomicLoadOp(Offset, Builder.getInt64Ty(),
+                                 Builder.getInt64Ty());
+    case OpCode::I32__atomic__load8_u:
+      return compileAtomicLoadOp(Offset, Builder.getInt32Ty(),
+                                 Builder.getInt8Ty());
+    case OpCode::I32__atomic__load16_u:
+      return compileAtomicLoadOp(Offset, Builder.getInt32Ty(),
+                                 Builder.getInt16Ty());
+    case OpCode::I64__atomic__load8_u:
+      return compileAtomicLoadOp(Offset, Builder.getInt64Ty(),
+                                 Builder.getInt8Ty());
+    case OpCode::I64__atomic__load16_u:
+      return compileAtomicLoadOp(Offset, Builder.getInt64Ty(),
+                                 Builder.getInt16Ty());
+    case OpCode::I64__atomic__load32_u:
+      return compileAtomicLoadOp(Offset, Builder.getInt64Ty(),
+                                 Builder.getInt32Ty());
+    case OpCode::I32__atomic__store:
+      return compileAtomicStoreOp(Offset, Builder.getInt32Ty());
+    case OpCode::I64__atomic__store:
+      return compileAtomicStoreOp(Offset, Builder.getInt64Ty());
+    case OpCode::I32__atomic__store8:
+      return compileAtomicStoreOp(Offset, Builder.getInt8Ty());
+    case OpCode::I32__atomic__store16:
+      return compileAtomicStoreOp(Offset, Builder.getInt16Ty());
+    case OpCode::I64__atomic__store8:
+      return compileAtomicStoreOp(Offset, Builder.getInt8Ty());
+    case OpCode::I64__atomic__store16:
+      return compileAtomicStoreOp(Offset, Builder.getInt16Ty());
+    case OpCode::I64__atomic__store32:
+      return compileAtomicStoreOp(Offset, Builder.getInt32Ty());
+    case OpCode::I32__atomic__rmw__add:
+      return compileAtomicRMWOp(Offset, llvm::AtomicRMWInst::Add,
+                                Builder.getInt32Ty(), Builder.getInt32Ty());
+    case OpCode::I64__atomic__rmw__add:
+      return compileAtomicRMWOp(Offset, llvm::AtomicRMWInst::Add,
+                                Builder.getInt64Ty(), Builder.getInt64Ty());
+    case OpCode::I32__atomic__rmw8__add_u:
+      return compileAtomicRMWOp(Offset, llvm::AtomicRMWInst::Add,
+                                Builder.getInt32Ty(), Builder.getInt8Ty());
+    case OpCode::I32__atomic__rmw16__add_u:
+      return compileAtomicRMWOp(Offset, llvm::AtomicRMWInst::Add,
+                                Builder.getInt32Ty(), Builder.getInt16Ty());
+    case OpCode::I64__atomic__rmw8__add_u:
+      return compileAtomicRMWOp(Offset, llvm::AtomicRMWInst::Add,
+                                Builder.getInt64Ty(), Builder.getInt8Ty());
+    case OpCode::I64__atomic__rmw16__add_u:
+      return compileAtomicRMWOp(Offset, llvm::AtomicRMWInst::Add,
+                                Builder.getInt64Ty(), Builder.getInt16Ty());
+    case OpCode::I64__atomic__rmw32__add_u:
+      return compileAtomicRMWOp(Offset, llvm::AtomicRMWInst::Add,
+                                Builder.getInt64Ty(), Builder.getInt32Ty());
+    case OpCode::I32__atomic__rmw__sub:
+      return compileAtomicRMWOp(Offset, llvm::AtomicRMWInst::Sub,
+                                Builder.getInt32Ty(), Builder.getInt32Ty());
+    case OpCode::I64__atomic__rmw__sub:
+      return compileAtomicRMWOp(Offset, llvm::AtomicRMWInst::Sub,
+                                Builder.getInt64Ty(), Builder.getInt64Ty());
+    case OpCode::I32__atomic__rmw8__sub_u:
+      return compileAtomicRMWOp(Offset, llvm::AtomicRMWInst::Sub,
+                                Builder.getInt32Ty(), Builder.getInt8Ty());
+    case OpCode::I32__atomic__rmw16__sub_u:
+      return compileAtomicRMWOp(Offset, llvm::AtomicRMWInst::Sub,
+                                Builder.getInt32Ty(), Builder.getInt16Ty());
+    case OpCode::I64__atomic__rmw8__sub_u:
+      return compileAtomicRMWOp(Offset, llvm::AtomicRMWInst::Sub,
+                                Builder.getInt64Ty(), Builder.getInt8Ty());
+    case OpCode::I64__atomic__rmw16__sub_u:
+      return compileAtomicRMWOp(Offset, llvm::AtomicRMWInst::Sub,
+                                Builder.getInt64Ty(), Builder.getInt16Ty());
+    case OpCode::I64__atomic__rmw32__sub_u:
+      return compileAtomicRMWOp(Offset, llvm::AtomicRMWInst::Sub,
+                                Builder.getInt64Ty(), Builder.getInt32Ty());
+    case OpCode::I32__atomic__rmw__and:
+      return compileAtomicRMWOp(Offset, llvm::AtomicRMWInst::And,
+                                Builder.getInt32Ty(), Builder.getInt32Ty());
+    case OpCode::I64__atomic__rmw__and:
+      return compileAtomicRMWOp(Offset, llvm::AtomicRMWInst::And,
+                                Builder.getInt64Ty(), Builder.getInt64Ty());
+    case OpCode::I32__atomic__rmw8__and_u:
+      return compileAtomicRMWOp(Offset, llvm::AtomicRMWInst::And,
+                                Builder.getInt32Ty(), Builder.getInt8Ty());
+    case OpCode::I32__atomic__rmw16__and_u:
+      return compileAtomicRMWOp(Offset, llvm::AtomicRMWInst::And,
+                                Builder.getInt32Ty(), Builder.getInt16Ty());
+    case OpCode::I64__atomic__rmw8__and_u:
+      return compileAtomicRMWOp(Offset, llvm::AtomicRMWInst::And,
+                                Builder.getInt64Ty(), Builder.getInt8Ty());
+    case OpCode::I64__atomic__rmw16__and_u:
+      return compileAtomicRMWOp(Offset, llvm::AtomicRMWInst::And,
+                                Builder.getInt64Ty(), Builder.getInt16Ty());
+    case OpCode::I64__atomic__rmw32__and_u:
+      return compileAtomicRMWOp(Offset, llvm::AtomicRMWInst::And,
+                                Builder.getInt64Ty(), Builder.getInt32Ty());
+    case OpCode::I32__atomic__rmw__or:
+      return compileAtomicRMWOp(Offset, llvm::AtomicRMWInst::Or,
+                                Builder.getInt32Ty(), Builder.getInt32Ty());
+    case OpCode::I64__atomic__rmw__or:
+      return compileAtomicRMWOp(Offset, llvm::AtomicRMWInst::Or,
+                                Builder.getInt64Ty(), Builder.getInt64Ty());
+    case OpCode::I32__atomic__rmw8__or_u:
+      return compileAtomicRMWOp(Offset, llvm::AtomicRMWInst::Or,
+                                Builder.getInt32Ty(), Builder.getInt8Ty());
+    case OpCode::I32__atomic__rmw16__or_u:
+      return compileAtomicRMWOp(Offset, llvm::AtomicRMWInst::Or,
+                                Builder.getInt32Ty(), Builder.getInt16Ty());
+    case OpCode::I64__atomic__rmw8__or_u:
+      return compileAtomicRMWOp(Offset, llvm::AtomicRMWInst::Or,
+                                Builder.getInt64Ty(), Builder.getInt8Ty());
+    case OpCode::I64__atomic__rmw16__or_u:
+      return compileAtomicRMWOp(Offset, llvm::AtomicRMWInst::Or,
+                                Builder.getInt64Ty(), Builder.getInt16Ty());
+    case OpCode::I64__atomic__rmw32__or_u:
+      return compileAtomicRMWOp(Offset, llvm::AtomicRMWInst::Or,
+                                Builder.getInt64Ty(), Builder.getInt32Ty());
+    case OpCode::I32__atomic__rmw__xor:
+      return compileAtomicRMWOp(Offset, llvm::AtomicRMWInst::Xor,
+                                Builder.getInt32Ty(), Builder.getInt32Ty());
+    case OpCode::I64__atomic__rmw__xor:
+      return compileAtomicRMWOp(Offset, llvm::AtomicRMWInst::Xor,
+                                Builder.getInt64Ty(), Builder.getInt64Ty());
+    case OpCode::I32__atomic__rmw8__xor_u:
+      return compileAtomicRMWOp(Offset, llvm::AtomicRMWInst::Xor,
+                                Builder.getInt32Ty(), Builder.getInt8Ty());
+    case OpCode::I32__atomic__rmw16__xor_u:
+      return compileAtomicRMWOp(Offset, llvm::AtomicRMWInst::Xor,
+                                Builder.getInt32Ty(), Builder.getInt16Ty());
+    case OpCode::I64__atomic__rmw8__xor_u:
+      return compileAtomicRMWOp(Offset, llvm::AtomicRMWInst::Xor,
+                                Builder.getInt64Ty(), Builder.getInt8Ty());
+    case OpCode::I64__atomic__rmw16__xor_u:
+      return compileAtomicRMWOp(Offset, llvm::AtomicRMWInst::Xor,
+                                Builder.getInt64Ty(), Builder.getInt16Ty());
+    case OpCode::I64__atomic__rmw32__xor_u:
+      return compileAtomicRMWOp(Offset, llvm::AtomicRMWInst::Xor,
+                                Builder.getInt64Ty(), Builder.getInt32Ty());
+    case OpCode::I32__atomic__rmw__xchg:
+      return compileAtomicRMWOp(Offset, llvm::AtomicRMWInst::Xchg,
+                                Builder.getInt32Ty(), Builder.getInt32Ty());
+    case OpCode::I64__atomic__rmw__xchg:
+      return compileAtomicRMWOp(Offset, llvm::AtomicRMWInst::Xchg,
+                                Builder.getInt64Ty(), Builder.getInt64Ty());
+    case OpCode::I32__atomic__rmw8__xchg_u:
+      return compileAtomicRMWOp(Offset, llvm::AtomicRMWInst::Xchg,
+                                Builder.getInt32Ty(), Builder.getInt8Ty());
+    case OpCode::I32__atomic__rmw16__xchg_u:
+      return compileAtomicRMWOp(Offset, llvm::AtomicRMWInst::Xchg,
+                                Builder.getInt32Ty(), Builder.getInt16Ty());
+    case OpCode::I64__atomic__rmw8__xchg_u:
+      return compileAtomicRMWOp(Offset, llvm::AtomicRMWInst::Xchg,
+                                Builder.getInt64Ty(), Builder.getInt8Ty());
+    case OpCode::I64__atomic__rmw16__xchg_u:
+      return compileAtomicRMWOp(Offset, llvm::AtomicRMWInst::Xchg,
+                                Builder.getInt64Ty(), Builder.getInt16Ty());
+    case OpCode::I64__atomic__rmw32__xchg_u:
+      return compileAtomicRMWOp(Offset, llvm::AtomicRMWInst::Xchg,
+                                Builder.getInt64Ty(), Builder.getInt32Ty());
+    case OpCode::I32__atomic__rmw__cmpxchg:
+      return compileAtomicCmpxchgOp(Offset, Builder.getInt32Ty(),
+                                    Builder.getInt32Ty());
+    case OpCode::I64__atomic__rmw__cmpxchg:
+      return compileAtomicCmpxchgOp(Offset, Builder.getInt64Ty(),
+                                    Builder.getInt64Ty());
+    case OpCode::I32__atomic__rmw8__cmpxchg_u:
+      return compileAtomicCmpxchgOp(Offset, Builder.getInt32Ty(),
+                                    Builder.getInt8Ty());
+    case OpCode::I32__atomic__rmw16__cmpxchg_u:
+      return compileAtomicCmpxchgOp(Offset, Builder.getInt32Ty(),
+                                    Builder.getInt16Ty());
+    case OpCode::I64__atomic__rmw8__cmpxchg_u:
+      return compileAtomicCmpxchgOp(Offset, Builder.getInt64Ty(),
+                                    Builder.getInt8Ty());
+    case OpCode::I64__atomic__rmw16__cmpxchg_u:
+      return compileAtomicCmpxchgOp(Offset, Builder.getInt64Ty(),
+                                    Builder.getInt16Ty());
+    case OpCode::I64__atomic__rmw32__cmpxchg_u:
+      return compileAtomicCmpxchgOp(Offset, Builder.getInt64Ty(),
+                                    Builder.getInt32Ty());
+    default:
+      __builtin_unreachable();
+    }
+  }
+
+  static llvm::Constant *evaluate(const AST::InstrVec &Instrs,
+                                  AOT::Compiler::CompileContext &Context) {
+    FunctionCompiler FC(Context, nullptr, {}, false);
+    if (auto Res = FC.compile(Instrs); !Res || FC.Stack.empty()) {
+      return nullptr;
+    }
+    return llvm::cast<llvm::Constant>(FC.Stack.back());
+  }
+
+private:
+  Expect<void> compileCallOp(const unsigned int FuncIndex) {
+    const auto &FuncType =
+        *Context.FunctionTypes[std::get<0>(Context.Functions[FuncIndex])];
+    const auto &Function = std::get<1>(Context.Functions[FuncIndex]);
+
+    if (Stack.size() < FuncType.getParamTypes().size()) {
+      return Unexpect(ErrCode::ValidationFailed);
+    }
+    auto Begin = Stack.end() - FuncType.getParamTypes().size();
+    auto End = Stack.end();
+    std::vector<llvm::Value *> Args = {Ctx};
+    Args.insert(Args.end(), Begin, End);
+
+    llvm::Value *Ret = Builder.CreateCall(Function, Args);
+    Stack.erase(Begin, End);
+    llvm::Type *Ty = Function->getReturnType();
+    if (Ty->isVoidTy()) {
+      // nothing to do
+    } else if (Ty->isStructTy()) {
+      for (auto *Val : unpackStruct(Builder, Ret)) {
+        Stack.push_back(Val);
+      }
+    } else {
+      Stack.push_back(Ret);
+    }
+
+    Builder.CreateStore(Builder.CreateLoad(Context.Mem), LocalMemPtr);
+    return {};
+  }
+
+  /// Collect the candidates of call_indirect with their switch case values.
+  /// A table resolved in compile time is switched on the element index, and
+  /// the others on the function index returned from the runtime.
+  std::vector<std::pair<uint32_t, llvm::Function *>>
+  getIndirectCallees(const bool Static, const AST::FunctionType &FuncType) {
+    std::vector<std::pair<uint32_t, llvm::Function *>> Callees;
+    auto Match = [&](const size_t FuncIdx) {
+      const auto &Type =
+          *Context.FunctionTypes[std::get<0>(Context.Functions[FuncIdx])];
+      return Type.getParamTypes() == FuncType.getParamTypes() &&
+             Type.getReturnTypes() == FuncType.getReturnTypes();
+    };
+    if (Static) {
+      for (uint32_t I = 0; I < Context.Elements.size(); ++I) {
+        const uint32_t FuncIdx = Context.Elements[I];
+        if (FuncIdx != kNullElement && Match(FuncIdx)) {
+          Callees.emplace_back(I, std::get<1>(Context.Functions[FuncIdx]));
+        }
+      }
+    } else {
+      for (uint32_t I = 0; I < Context.Functions.size(); ++I) {
+        /// Imported functions are never resolved by the runtime.
+        if (std::get<2>(Context.Functions[I]) != nullptr && Match(I)) {
+          Callees.emplace_back(I, std::get<1>(Context.Functions[I]));
+        }
+      }
+    }
+    return Callees;
+  }
+
+  /// Call the callee of call_indirect through the proxy, with the arguments
+  /// and the results passed in the ValVariant arrays. Returns the packed
+  /// results, or nullptr if there is no result.
+  llvm::Value *buildProxyIndirectCall(const uint32_t TableIndex,
+                                      const uint32_t FuncTypeIndex,
+                                      llvm::Value *Idx,
+                                      const std::vector<llvm::Value *> &Args,
+                                      const AST::FunctionType &FuncType) {
+    const auto &RetTypes = FuncType.getReturnTypes();
+    /// Allocate the arrays in the entry block, which are reused in loops.
+    llvm::IRBuilder<> EntryBuilder(&F->getEntryBlock(),
+                                   F->getEntryBlock().begin());
+    auto Alloca = [&](const size_t Count) -> llvm::Value * {
+      if (Count == 0) {
+        return llvm::ConstantPointerNull::get(Builder.getInt8PtrTy());
+      }
+      return EntryBuilder.CreateAlloca(
+          Builder.getInt8Ty(), Builder.getInt64(Count * sizeof(ValVariant)));
+    };
+    llvm::Value *RawArgs = Alloca(Args.size() - 1);
+    llvm::Value *RawRets = Alloca(RetTypes.size());
+
+    for (size_t I = 1; I < Args.size(); ++I) {
+      llvm::Value *Ptr = Builder.CreateConstInBoundsGEP1_64(
+          RawArgs, (I - 1) * sizeof(ValVariant));
+      Builder.CreateStore(
+          Args[I], Builder.CreateBitCast(
+                       Ptr, llvm::PointerType::getUnqual(Args[I]->getType())));
+    }
+
+    Context.callCallIndirect(Builder, Ctx, Builder.getInt32(TableIndex),
+                             Builder.getInt32(FuncTypeIndex), Idx, RawArgs,
+                             RawRets);
+
+    std::vector<llvm::Value *> Rets;
+    Rets.reserve(RetTypes.size());
+    for (size_t I = 0; I < RetTypes.size(); ++I) {
+      llvm::Value *Ptr =
+          Builder.CreateConstInBoundsGEP1_64(RawRets, I * sizeof(ValVariant));
+      Rets.push_back(Builder.CreateLoad(Builder.CreateBitCast(
+          Ptr, llvm::PointerType::getUnqual(
+                   toLLVMType(VMContext, RetTypes[I])))));
+    }
+    if (Rets.empty()) {
+      return nullptr;
+    } else if (Rets.size() == 1) {
+      return Rets.front();
+    }
+    return packStruct(Builder, Rets);
+  }
+
+  Expect<void> compileIndirectCallOp(const uint32_t TableIndex,
+                                     const uint32_t FuncTypeIndex) {
+    const auto &FuncType = *Context.FunctionTypes[FuncTypeIndex];
+    if (Stack.size() < FuncType.getParamTypes().size() + 1) {
+      return Unexpect(ErrCode::ValidationFailed);
+    }
+    auto Begin = Stack.end() - FuncType.getParamTypes().size() - 1;
+    auto End = Stack.end() - 1;
+    std::vector<llvm::Value *> Args = {Ctx};
+    Args.insert(Args.end(), Begin, End);
+
+    const bool Static = Context.StaticTable && TableIndex == 0;
+    llvm::Value *Idx = Stack.back();
+    llvm::Value *Selector =
+        Static ? Idx
+               : Context.callTableGetFuncIdx(Builder, Ctx,
+                                             Builder.getInt32(TableIndex),
+                                             Builder.getInt32(FuncTypeIndex),
+                                             Idx);
+    const auto Table = getIndirectCallees(Static, FuncType);
+    llvm::BasicBlock *OK =
         llvm::BasicBlock::Create(VMContext, "call_indirect.end", F);
-    llvm::BasicBlock *Error =
-        llvm::BasicBlock::Create(VMContext, "call_indirect.error", F);
+    llvm::BasicBlock *Default = llvm::BasicBlock::Create(
+        VMContext, Static ? "call_indirect.error" : "call_indirect.proxy", F);
     llvm::SwitchInst *Switch =
-        Builder.CreateSwitch(Stack.back(), Error, Table.size());
+        Builder.CreateSwitch(Selector, Default, Table.size());
 
     const bool HasReturnValue = !isVoidReturn(FuncType.getReturnTypes());
     std::vector<std::tuple<llvm::Value *, llvm::BasicBlock *>> ReturnValues;
@@ -1225,11 +2664,20 @@ private:
       }
     }
 
-    Builder.SetInsertPoint(Error);
-    updateInstrCount();
-    Context.callTrap(Builder, Ctx,
-                     Builder.getInt32(uint32_t(ErrCode::Unreachable)));
-    Builder.CreateUnreachable();
+    Builder.SetInsertPoint(Default);
+    if (Static) {
+      updateInstrCount();
+      Context.callTrap(Builder, Ctx,
+                       Builder.getInt32(uint32_t(ErrCode::Unreachable)));
+      Builder.CreateUnreachable();
+    } else {
+      llvm::Value *Ret = buildProxyIndirectCall(TableIndex, FuncTypeIndex, Idx,
+                                                Args, FuncType);
+      Builder.CreateBr(OK);
+      if (HasReturnValue) {
+        ReturnValues.emplace_back(Ret, Builder.GetInsertBlock());
+      }
+    }
 
     Stack.erase(Begin, Stack.end());
 
@@ -1242,6 +2690,136 @@ private:
     return {};
   }
 
+  /// Build a tail call and return its result. The call is marked musttail
+  /// when the callee has the same signature as the current function.
+  void buildTailCall(llvm::Function *Callee,
+                     const std::vector<llvm::Value *> &Args) {
+    llvm::CallInst *Ret = Builder.CreateCall(Callee, Args);
+    if (Callee->getFunctionType() == F->getFunctionType()) {
+      Ret->setTailCallKind(llvm::CallInst::TCK_MustTail);
+    } else {
+      Ret->setTailCallKind(llvm::CallInst::TCK_Tail);
+    }
+    if (Ret->getType()->isVoidTy()) {
+      Builder.CreateRetVoid();
+    } else {
+      Builder.CreateRet(Ret);
+    }
+  }
+
+  /// Continue in an unreachable block after the tail call.
+  void leaveTailCall(const std::string &Name) {
+    Builder.SetInsertPoint(llvm::BasicBlock::Create(VMContext, Name, F));
+    for (auto *Undef : getUndefValue(F->getReturnType())) {
+      Stack.push_back(Undef);
+    }
+  }
+
+  Expect<void> compileReturnCallOp(const unsigned int FuncIndex) {
+    const auto &FuncType =
+        *Context.FunctionTypes[std::get<0>(Context.Functions[FuncIndex])];
+    const auto &Function = std::get<1>(Context.Functions[FuncIndex]);
+
+    if (Stack.size() < FuncType.getParamTypes().size()) {
+      return Unexpect(ErrCode::ValidationFailed);
+    }
+    auto Begin = Stack.end() - FuncType.getParamTypes().size();
+    auto End = Stack.end();
+    std::vector<llvm::Value *> Args = {Ctx};
+    Args.insert(Args.end(), Begin, End);
+    Stack.erase(Begin, End);
+
+    buildTailCall(Function, Args);
+    leaveTailCall("return_call.end");
+    return {};
+  }
+
+  Expect<void> compileReturnCallIndirectOp(const uint32_t TableIndex,
+                                           const uint32_t FuncTypeIndex) {
+    const auto &FuncType = *Context.FunctionTypes[FuncTypeIndex];
+    if (Stack.size() < FuncType.getParamTypes().size() + 1) {
+      return Unexpect(ErrCode::ValidationFailed);
+    }
+    auto Begin = Stack.end() - FuncType.getParamTypes().size() - 1;
+    auto End = Stack.end() - 1;
+    std::vector<llvm::Value *> Args = {Ctx};
+    Args.insert(Args.end(), Begin, End);
+
+    const bool Static = Context.StaticTable && TableIndex == 0;
+    llvm::Value *Idx = Stack.back();
+    llvm::Value *Selector =
+        Static ? Idx
+               : Context.callTableGetFuncIdx(Builder, Ctx,
+                                             Builder.getInt32(TableIndex),
+                                             Builder.getInt32(FuncTypeIndex),
+                                             Idx);
+    const auto Table = getIndirectCallees(Static, FuncType);
+    llvm::BasicBlock *Default = llvm::BasicBlock::Create(
+        VMContext,
+        Static ? "return_call_indirect.error" : "return_call_indirect.proxy",
+        F);
+    llvm::SwitchInst *Switch =
+        Builder.CreateSwitch(Selector, Default, Table.size());
+    for (const auto &[Value, Func] : Table) {
+      llvm::BasicBlock *Entry = llvm::BasicBlock::Create(
+          VMContext, "return_call_indirect." + std::to_string(Value), F);
+      Builder.SetInsertPoint(Entry);
+      buildTailCall(Func, Args);
+      Switch->addCase(Builder.getInt32(Value), Entry);
+    }
+
+    Builder.SetInsertPoint(Default);
+    if (Static) {
+      Context.callTrap(Builder, Ctx,
+                       Builder.getInt32(uint32_t(ErrCode::Unreachable)));
+      Builder.CreateUnreachable();
+    } else {
+      /// The callee out of this module can not be called in tail position,
+      /// so its results are returned after the proxy call.
+      llvm::Value *Ret = buildProxyIndirectCall(TableIndex, FuncTypeIndex, Idx,
+                                                Args, FuncType);
+      if (Ret == nullptr) {
+        Builder.CreateRetVoid();
+      } else {
+        Builder.CreateRet(Ret);
+      }
+    }
+
+    Stack.erase(Begin, Stack.end());
+    leaveTailCall("return_call_indirect.end");
+    return {};
+  }
+
+  /// Get the pointer to memory at the i32 offset.
+  llvm::Value *getMemoryPtr(llvm::Value *Offset) {
+    return Builder.CreateInBoundsGEP(
+        Builder.CreateLoad(LocalMemPtr),
+        {Builder.CreateZExt(Offset, Builder.getInt64Ty())});
+  }
+  /// Trap when [Offset, Offset + Length) exceeds the memory size.
+  void compileMemoryBoundCheck(llvm::Value *Offset, llvm::Value *Length) {
+    llvm::Value *End =
+        Builder.CreateAdd(Builder.CreateZExt(Offset, Builder.getInt64Ty()),
+                          Builder.CreateZExt(Length, Builder.getInt64Ty()));
+    llvm::Value *Size = Builder.CreateMul(
+        Builder.CreateZExt(Context.callMemSize(Builder, Ctx),
+                           Builder.getInt64Ty()),
+        Builder.getInt64(UINT64_C(65536)));
+    llvm::BasicBlock *OK =
+        llvm::BasicBlock::Create(VMContext, "bound_check.ok", F);
+    llvm::BasicBlock *Error =
+        llvm::BasicBlock::Create(VMContext, "bound_check.error", F);
+    Builder.CreateCondBr(Builder.CreateICmpULE(End, Size), OK, Error,
+                         Context.Likely);
+
+    Builder.SetInsertPoint(Error);
+    updateInstrCount();
+    Context.callTrap(Builder, Ctx,
+                     Builder.getInt32(uint32_t(ErrCode::MemoryOutOfBounds)));
+    Builder.CreateUnreachable();
+
+    Builder.SetInsertPoint(OK);
+  }
   Expect<void> compileLoadOp(unsigned int Offset, unsigned Alignment,
                              llvm::Type *LoadTy) {
     if (Stack.empty()) {
@@ -1298,22 +2876,600 @@ private:
     StoreInst->setAlignment(Align(UINT64_C(1) << Alignment));
     return {};
   }
+  /// Get the pointer of the atomic access at the i32 base and the offset, and
+  /// trap when the address is not aligned to the accessed size.
+  llvm::Value *getAtomicPtr(llvm::Value *Base, unsigned int Offset,
+                            llvm::Type *MemTy) {
+    llvm::Value *Off = Builder.CreateZExt(Base, Builder.getInt64Ty());
+    if (Offset != 0) {
+      Off = Builder.CreateAdd(Off, Builder.getInt64(Offset));
+    }
+    const uint64_t Size = MemTy->getPrimitiveSizeInBits() / 8;
+    if (Size > 1) {
+      llvm::BasicBlock *OK =
+          llvm::BasicBlock::Create(VMContext, "atomic_align.ok", F);
+      llvm::BasicBlock *Error =
+          llvm::BasicBlock::Create(VMContext, "atomic_align.error", F);
+      Builder.CreateCondBr(
+          Builder.CreateICmpEQ(
+              Builder.CreateAnd(Off, Builder.getInt64(Size - 1)),
+              Builder.getInt64(0)),
+          OK, Error, Context.Likely);
+
+      Builder.SetInsertPoint(Error);
+      updateInstrCount();
+      Context.callTrap(
+          Builder, Ctx,
+          Builder.getInt32(uint32_t(ErrCode::UnalignedAtomicAccess)));
+      Builder.CreateUnreachable();
+
+      Builder.SetInsertPoint(OK);
+    }
+    llvm::Value *VPtr =
+        Builder.CreateInBoundsGEP(Builder.CreateLoad(LocalMemPtr), {Off});
+    return Builder.CreateBitCast(VPtr, llvm::PointerType::getUnqual(MemTy));
+  }
+  llvm::Value *createAtomicRMW(llvm::AtomicRMWInst::BinOp Op,
+                               llvm::Value *Ptr, llvm::Value *Val) {
+#if LLVM_VERSION_MAJOR >= 13
+    return Builder.CreateAtomicRMW(
+        Op, Ptr, Val, llvm::MaybeAlign(),
+        llvm::AtomicOrdering::SequentiallyConsistent);
+#else
+    return Builder.CreateAtomicRMW(
+        Op, Ptr, Val, llvm::AtomicOrdering::SequentiallyConsistent);
+#endif
+  }
+  llvm::Value *createAtomicCmpXchg(llvm::Value *Ptr, llvm::Value *Expected,
+                                   llvm::Value *Replacement) {
+#if LLVM_VERSION_MAJOR >= 13
+    return Builder.CreateAtomicCmpXchg(
+        Ptr, Expected, Replacement, llvm::MaybeAlign(),
+        llvm::AtomicOrdering::SequentiallyConsistent,
+        llvm::AtomicOrdering::SequentiallyConsistent);
+#else
+    return Builder.CreateAtomicCmpXchg(
+        Ptr, Expected, Replacement,
+        llvm::AtomicOrdering::SequentiallyConsistent,
+        llvm::AtomicOrdering::SequentiallyConsistent);
+#endif
+  }
+  Expect<void> compileAtomicLoadOp(unsigned int Offset, llvm::Type *ValTy,
+                                   llvm::Type *MemTy) {
+    if (Stack.empty()) {
+      return Unexpect(ErrCode::ValidationFailed);
+    }
+    llvm::Value *Ptr = getAtomicPtr(Stack.back(), Offset, MemTy);
+    llvm::LoadInst *LoadInst = Builder.CreateLoad(Ptr);
+    LoadInst->setAlignment(Align(MemTy->getPrimitiveSizeInBits() / 8));
+    LoadInst->setAtomic(llvm::AtomicOrdering::SequentiallyConsistent);
+    Stack.back() = Builder.CreateZExt(LoadInst, ValTy);
+    return {};
+  }
+  Expect<void> compileAtomicStoreOp(unsigned int Offset, llvm::Type *MemTy) {
+    if (Stack.size() < 2) {
+      return Unexpect(ErrCode::ValidationFailed);
+    }
+    llvm::Value *V = Builder.CreateTrunc(Stack.back(), MemTy);
+    Stack.pop_back();
+    llvm::Value *Ptr = getAtomicPtr(Stack.back(), Offset, MemTy);
+    Stack.pop_back();
+    llvm::StoreInst *StoreInst = Builder.CreateStore(V, Ptr);
+    StoreInst->setAlignment(Align(MemTy->getPrimitiveSizeInBits() / 8));
+    StoreInst->setAtomic(llvm::AtomicOrdering::SequentiallyConsistent);
+    return {};
+  }
+  Expect<void> compileAtomicRMWOp(unsigned int Offset,
+                                  llvm::AtomicRMWInst::BinOp Op,
+                                  llvm::Type *ValTy, llvm::Type *MemTy) {
+    if (Stack.size() < 2) {
+      return Unexpect(ErrCode::ValidationFailed);
+    }
+    llvm::Value *V = Builder.CreateTrunc(Stack.back(), MemTy);
+    Stack.pop_back();
+    llvm::Value *Ptr = getAtomicPtr(Stack.back(), Offset, MemTy);
+    Stack.back() = Builder.CreateZExt(createAtomicRMW(Op, Ptr, V), ValTy);
+    return {};
+  }
+  Expect<void> compileAtomicCmpxchgOp(unsigned int Offset, llvm::Type *ValTy,
+                                      llvm::Type *MemTy) {
+    if (Stack.size() < 3) {
+      return Unexpect(ErrCode::ValidationFailed);
+    }
+    llvm::Value *Replacement = Builder.CreateTrunc(Stack.back(), MemTy);
+    Stack.pop_back();
+    llvm::Value *Expected = Builder.CreateTrunc(Stack.back(), MemTy);
+    Stack.pop_back();
+    llvm::Value *Ptr = getAtomicPtr(Stack.back(), Offset, MemTy);
+    llvm::Value *Old = Builder.CreateExtractValue(
+        createAtomicCmpXchg(Ptr, Expected, Replacement), {0});
+    Stack.back() = Builder.CreateZExt(Old, ValTy);
+    return {};
+  }
+  Expect<void> compileAtomicWaitOp(unsigned int Offset, unsigned BitWidth) {
+    if (Stack.size() < 3) {
+      return Unexpect(ErrCode::ValidationFailed);
+    }
+    llvm::Value *Timeout = Stack.back();
+    Stack.pop_back();
+    llvm::Value *Expected =
+        Builder.CreateZExt(Stack.back(), Builder.getInt64Ty());
+    Stack.pop_back();
+    llvm::Value *Address = Builder.CreateAdd(
+        Builder.CreateZExt(Stack.back(), Builder.getInt64Ty()),
+        Builder.getInt64(Offset));
+    Stack.back() =
+        Context.callMemAtomicWait(Builder, Ctx, Address, Expected, Timeout,
+                                  Builder.getInt32(BitWidth));
+    return {};
+  }
+  Expect<void> compileAtomicNotifyOp(unsigned int Offset) {
+    if (Stack.size() < 2) {
+      return Unexpect(ErrCode::ValidationFailed);
+    }
+    llvm::Value *Count = Stack.back();
+    Stack.pop_back();
+    llvm::Value *Address = Builder.CreateAdd(
+        Builder.CreateZExt(Stack.back(), Builder.getInt64Ty()),
+        Builder.getInt64(Offset));
+    Stack.back() = Context.callMemAtomicNotify(Builder, Ctx, Address, Count);
+    return {};
+  }
+  /// v128 values are <2 x i64> on the stack. The SIMD helpers bitcast them to
+  /// the vector types of lanes, and cast the results back.
+  static unsigned getLaneCount(llvm::Type *VectorTy) {
+    return 128 / VectorTy->getScalarSizeInBits();
+  }
+  llvm::Value *getShuffleMask(llvm::ArrayRef<uint32_t> Mask) {
+    return llvm::ConstantDataVector::get(VMContext, Mask);
+  }
+  /// Get the low or high half of a vector with 2 * Lanes lanes.
+  llvm::Value *createVectorHalf(llvm::Value *V, unsigned Lanes, bool Low) {
+    std::vector<uint32_t> Mask(Lanes);
+    for (unsigned I = 0; I < Lanes; ++I) {
+      Mask[I] = Low ? I : I + Lanes;
+    }
+    return Builder.CreateShuffleVector(
+        V, llvm::UndefValue::get(V->getType()), getShuffleMask(Mask));
+  }
+  /// Extend the lanes to the double width.
+  llvm::Value *createVectorExtend(llvm::Value *V, unsigned Lanes,
+                                  bool Signed) {
+    llvm::Type *ExtendTy = llvm::VectorType::get(
+        Builder.getIntNTy(V->getType()->getScalarSizeInBits() * 2), Lanes);
+    return Signed ? Builder.CreateSExt(V, ExtendTy)
+                  : Builder.CreateZExt(V, ExtendTy);
+  }
+  template <typename Func>
+  Expect<void> compileVectorOp(llvm::VectorType *VectorTy, Func &&Op) {
+    llvm::Value *V = Builder.CreateBitCast(Stack.back(), VectorTy);
+    Stack.back() = Builder.CreateBitCast(Op(V), Int64x2Ty);
+    return {};
+  }
+  template <typename Func>
+  Expect<void> compileVectorVectorOp(llvm::VectorType *VectorTy, Func &&Op) {
+    llvm::Value *RHS = Builder.CreateBitCast(Stack.back(), VectorTy);
+    Stack.pop_back();
+    llvm::Value *LHS = Builder.CreateBitCast(Stack.back(), VectorTy);
+    Stack.back() = Builder.CreateBitCast(Op(LHS, RHS), Int64x2Ty);
+    return {};
+  }
+  Expect<void> compileVectorLoadOp(unsigned int Offset, unsigned Alignment,
+                                   llvm::Type *LoadTy) {
+    if (auto Ret = compileLoadOp(Offset, Alignment, LoadTy); !Ret) {
+      return Unexpect(Ret);
+    }
+    Stack.back() = Builder.CreateBitCast(Stack.back(), Int64x2Ty);
+    return {};
+  }
+  Expect<void> compileVectorLoadOp(unsigned int Offset, unsigned Alignment,
+                                   llvm::Type *LoadTy, llvm::Type *ExtendTy,
+                                   bool Signed) {
+    if (auto Ret = compileLoadOp(Offset, Alignment, LoadTy, ExtendTy, Signed);
+        !Ret) {
+      return Unexpect(Ret);
+    }
+    Stack.back() = Builder.CreateBitCast(Stack.back(), Int64x2Ty);
+    return {};
+  }
+  Expect<void> compileSplatLoadOp(unsigned int Offset, unsigned Alignment,
+                                  llvm::VectorType *VectorTy) {
+    if (auto Ret = compileLoadOp(Offset, Alignment, VectorTy->getElementType());
+        !Ret) {
+      return Unexpect(Ret);
+    }
+    return compileSplatOp(VectorTy);
+  }
+  /// Load a lane into the vector on the stack, or into a zero vector.
+  Expect<void> compileLoadLaneOp(unsigned int Offset, unsigned Alignment,
+                                 unsigned Lane, llvm::VectorType *VectorTy,
+                                 bool Zero = false) {
+    llvm::Value *Vector;
+    if (Zero) {
+      Vector = llvm::ConstantAggregateZero::get(VectorTy);
+    } else {
+      Vector = Builder.CreateBitCast(Stack.back(), VectorTy);
+      Stack.pop_back();
+    }
+    if (auto Ret = compileLoadOp(Offset, Alignment, VectorTy->getElementType());
+        !Ret) {
+      return Unexpect(Ret);
+    }
+    Stack.back() = Builder.CreateBitCast(
+        Builder.CreateInsertElement(Vector, Stack.back(), Lane), Int64x2Ty);
+    return {};
+  }
+  Expect<void> compileStoreLaneOp(unsigned int Offset, unsigned Alignment,
+                                  unsigned Lane, llvm::VectorType *VectorTy) {
+    Stack.back() = Builder.CreateExtractElement(
+        Builder.CreateBitCast(Stack.back(), VectorTy), Lane);
+    return compileStoreOp(Offset, Alignment, VectorTy->getElementType());
+  }
+  Expect<void> compileExtractLaneOp(llvm::VectorType *VectorTy, unsigned Lane,
+                                    llvm::Type *ExtendTy = nullptr,
+                                    bool Signed = false) {
+    llvm::Value *V = Builder.CreateExtractElement(
+        Builder.CreateBitCast(Stack.back(), VectorTy), Lane);
+    if (ExtendTy) {
+      V = Signed ? Builder.CreateSExt(V, ExtendTy)
+                 : Builder.CreateZExt(V, ExtendTy);
+    }
+    Stack.back() = V;
+    return {};
+  }
+  Expect<void> compileReplaceLaneOp(llvm::VectorType *VectorTy,
+                                    unsigned Lane) {
+    llvm::Value *V = Stack.back();
+    Stack.pop_back();
+    if (V->getType() != VectorTy->getElementType()) {
+      V = Builder.CreateTrunc(V, VectorTy->getElementType());
+    }
+    Stack.back() = Builder.CreateBitCast(
+        Builder.CreateInsertElement(
+            Builder.CreateBitCast(Stack.back(), VectorTy), V, Lane),
+        Int64x2Ty);
+    return {};
+  }
+  Expect<void> compileSplatOp(llvm::VectorType *VectorTy) {
+    llvm::Value *V = Stack.back();
+    if (V->getType() != VectorTy->getElementType()) {
+      V = Builder.CreateTrunc(V, VectorTy->getElementType());
+    }
+    Stack.back() = Builder.CreateBitCast(
+        Builder.CreateVectorSplat(getLaneCount(VectorTy), V), Int64x2Ty);
+    return {};
+  }
+  Expect<void> compileVectorSwizzleOp() {
+    return compileVectorVectorOp(
+        Int8x16Ty, [this](llvm::Value *LHS, llvm::Value *RHS) {
+          /// Out of range indices select zero.
+          llvm::Value *Ret = llvm::ConstantAggregateZero::get(Int8x16Ty);
+          for (unsigned I = 0; I < 16; ++I) {
+            llvm::Value *Index = Builder.CreateExtractElement(RHS, I);
+            llvm::Value *Elem = Builder.CreateExtractElement(
+                LHS, Builder.CreateAnd(Index, Builder.getInt8(15)));
+            Ret = Builder.CreateInsertElement(
+                Ret,
+                Builder.CreateSelect(
+                    Builder.CreateICmpULT(Index, Builder.getInt8(16)), Elem,
+                    Builder.getInt8(0)),
+                I);
+          }
+          return Ret;
+        });
+  }
+  /// Comparisons set all bits of the true lanes.
+  Expect<void> compileVectorCompareOp(llvm::VectorType *VectorTy,
+                                      llvm::CmpInst::Predicate Predicate) {
+    return compileVectorVectorOp(
+        VectorTy, [this, VectorTy, Predicate](llvm::Value *LHS,
+                                              llvm::Value *RHS) {
+          llvm::Value *Cmp = llvm::CmpInst::isFPPredicate(Predicate)
+                                 ? Builder.CreateFCmp(Predicate, LHS, RHS)
+                                 : Builder.CreateICmp(Predicate, LHS, RHS);
+          return Builder.CreateSExt(Cmp,
+                                    llvm::VectorType::getInteger(VectorTy));
+        });
+  }
+  /// Select the lanes of v1 where the comparison is true, else v2.
+  Expect<void> compileVectorSelectOp(llvm::VectorType *VectorTy,
+                                     llvm::CmpInst::Predicate Predicate) {
+    return compileVectorVectorOp(
+        VectorTy, [this, Predicate](llvm::Value *LHS, llvm::Value *RHS) {
+          return Builder.CreateSelect(Builder.CreateICmp(Predicate, LHS, RHS),
+                                      LHS, RHS);
+        });
+  }
+  Expect<void> compileVectorShiftOp(llvm::VectorType *VectorTy,
+                                    llvm::Instruction::BinaryOps Op) {
+    /// The shift count is modulo the lane width.
+    llvm::Value *Count = Builder.CreateAnd(
+        Stack.back(), Builder.getInt32(VectorTy->getScalarSizeInBits() - 1));
+    Stack.pop_back();
+    llvm::Value *Splat = Builder.CreateVectorSplat(
+        getLaneCount(VectorTy),
+        Builder.CreateZExtOrTrunc(Count, VectorTy->getElementType()));
+    return compileVectorOp(VectorTy, [this, Op, Splat](llvm::Value *V) {
+      return Builder.CreateBinOp(Op, V, Splat);
+    });
+  }
+  Expect<void> compileVectorAbsOp(llvm::VectorType *VectorTy) {
+    return compileVectorOp(VectorTy, [this, VectorTy](llvm::Value *V) {
+      return Builder.CreateSelect(
+          Builder.CreateICmpSLT(V, llvm::ConstantAggregateZero::get(VectorTy)),
+          Builder.CreateNeg(V), V);
+    });
+  }
+  Expect<void> compileVectorAllTrueOp(llvm::VectorType *VectorTy) {
+    llvm::Value *V = Builder.CreateBitCast(Stack.back(), VectorTy);
+    llvm::Value *Mask = Builder.CreateBitCast(
+        Builder.CreateICmpNE(V, llvm::ConstantAggregateZero::get(VectorTy)),
+        Builder.getIntNTy(getLaneCount(VectorTy)));
+    Stack.back() = Builder.CreateZExt(
+        Builder.CreateICmpEQ(Mask,
+                             llvm::Constant::getAllOnesValue(Mask->getType())),
+        Builder.getInt32Ty());
+    return {};
+  }
+  Expect<void> compileVectorBitMaskOp(llvm::VectorType *VectorTy) {
+    llvm::Value *V = Builder.CreateBitCast(Stack.back(), VectorTy);
+    llvm::Value *Mask = Builder.CreateBitCast(
+        Builder.CreateICmpSLT(V, llvm::ConstantAggregateZero::get(VectorTy)),
+        Builder.getIntNTy(getLaneCount(VectorTy)));
+    Stack.back() = Builder.CreateZExt(Mask, Builder.getInt32Ty());
+    return {};
+  }
+  /// Saturate the signed lanes of v1 and v2 to the half width.
+  Expect<void> compileVectorNarrowOp(llvm::VectorType *VectorTy, bool Signed) {
+    const unsigned Lanes = getLaneCount(VectorTy);
+    const unsigned Bits = VectorTy->getScalarSizeInBits() / 2;
+    llvm::Constant *Min = llvm::ConstantInt::get(
+        VectorTy, Signed ? -(INT64_C(1) << (Bits - 1)) : 0, true);
+    llvm::Constant *Max = llvm::ConstantInt::get(
+        VectorTy, Signed ? (INT64_C(1) << (Bits - 1)) - 1
+                         : (INT64_C(1) << Bits) - 1);
+    llvm::Type *TruncTy = llvm::VectorType::get(Builder.getIntNTy(Bits), Lanes);
+    std::vector<uint32_t> Mask(Lanes * 2);
+    for (unsigned I = 0; I < Lanes * 2; ++I) {
+      Mask[I] = I;
+    }
+    auto Clamp = [this, Min, Max, TruncTy](llvm::Value *V) {
+      V = Builder.CreateSelect(Builder.CreateICmpSLT(V, Min), Min, V);
+      V = Builder.CreateSelect(Builder.CreateICmpSGT(V, Max), Max, V);
+      return Builder.CreateTrunc(V, TruncTy);
+    };
+    return compileVectorVectorOp(
+        VectorTy, [this, &Clamp, &Mask](llvm::Value *LHS, llvm::Value *RHS) {
+          return Builder.CreateShuffleVector(Clamp(LHS), Clamp(RHS),
+                                             getShuffleMask(Mask));
+        });
+  }
+  /// Same as the scalar min and max: NaN propagates and -0.0 is less than
+  /// +0.0.
+  Expect<void> compileVectorFMinMaxOp(llvm::VectorType *VectorTy, bool IsMin) {
+    return compileVectorVectorOp(
+        VectorTy, [this, VectorTy, IsMin](llvm::Value *LHS, llvm::Value *RHS) {
+          llvm::Type *IntTy = llvm::VectorType::getInteger(VectorTy);
+          llvm::Value *UEQ = Builder.CreateFCmpUEQ(LHS, RHS);
+          llvm::Value *UNO = Builder.CreateFCmpUNO(LHS, RHS);
+
+          llvm::Value *LHSInt = Builder.CreateBitCast(LHS, IntTy);
+          llvm::Value *RHSInt = Builder.CreateBitCast(RHS, IntTy);
+          llvm::Value *EqFp = Builder.CreateBitCast(
+              IsMin ? Builder.CreateOr(LHSInt, RHSInt)
+                    : Builder.CreateAnd(LHSInt, RHSInt),
+              VectorTy);
+
+          llvm::Value *AddFp = Builder.CreateFAdd(LHS, RHS);
+
+          llvm::CallInst *MinMaxFp = Builder.CreateBinaryIntrinsic(
+              IsMin ? llvm::Intrinsic::minnum : llvm::Intrinsic::maxnum, LHS,
+              RHS);
+          MinMaxFp->setHasNoNaNs(true);
+
+          return Builder.CreateSelect(
+              UEQ, Builder.CreateSelect(UNO, AddFp, EqFp), MinMaxFp);
+        });
+  }
+  /// Pseudo-minimum is v2 < v1 ? v2 : v1, and pseudo-maximum is
+  /// v1 < v2 ? v2 : v1.
+  Expect<void> compileVectorPMinMaxOp(llvm::VectorType *VectorTy, bool IsMin) {
+    return compileVectorVectorOp(
+        VectorTy, [this, IsMin](llvm::Value *LHS, llvm::Value *RHS) {
+          llvm::Value *Cmp = IsMin ? Builder.CreateFCmpOLT(RHS, LHS)
+                                   : Builder.CreateFCmpOLT(LHS, RHS);
+          return Builder.CreateSelect(Cmp, RHS, LHS);
+        });
+  }
+  Expect<void> compileVectorAvgrOp(llvm::VectorType *VectorTy) {
+    const unsigned Lanes = getLaneCount(VectorTy);
+    return compileVectorVectorOp(
+        VectorTy,
+        [this, VectorTy, Lanes](llvm::Value *LHS, llvm::Value *RHS) {
+          llvm::Value *L = createVectorExtend(LHS, Lanes, false);
+          llvm::Value *R = createVectorExtend(RHS, Lanes, false);
+          llvm::Value *One = llvm::ConstantInt::get(L->getType(), 1);
+          llvm::Value *Sum = Builder.CreateAdd(Builder.CreateAdd(L, R), One);
+          return Builder.CreateTrunc(Builder.CreateLShr(Sum, One), VectorTy);
+        });
+  }
+  Expect<void> compileVectorExtAddPairwiseOp(llvm::VectorType *VectorTy,
+                                             bool Signed) {
+    const unsigned Lanes = getLaneCount(VectorTy) / 2;
+    std::vector<uint32_t> Even(Lanes), Odd(Lanes);
+    for (unsigned I = 0; I < Lanes; ++I) {
+      Even[I] = I * 2;
+      Odd[I] = I * 2 + 1;
+    }
+    return compileVectorOp(VectorTy, [&](llvm::Value *V) {
+      llvm::Value *Undef = llvm::UndefValue::get(VectorTy);
+      llvm::Value *L = createVectorExtend(
+          Builder.CreateShuffleVector(V, Undef, getShuffleMask(Even)), Lanes,
+          Signed);
+      llvm::Value *R = createVectorExtend(
+          Builder.CreateShuffleVector(V, Undef, getShuffleMask(Odd)), Lanes,
+          Signed);
+      return Builder.CreateAdd(L, R);
+    });
+  }
+  /// Q15 fixed-point multiplication with rounding and saturation.
+  Expect<void> compileVectorQ15MulSatOp() {
+    return compileVectorVectorOp(
+        Int16x8Ty, [this](llvm::Value *LHS, llvm::Value *RHS) {
+          llvm::Value *L = createVectorExtend(LHS, 8, true);
+          llvm::Value *R = createVectorExtend(RHS, 8, true);
+          llvm::Type *Ty = L->getType();
+          llvm::Value *Ret = Builder.CreateAShr(
+              Builder.CreateAdd(Builder.CreateMul(L, R),
+                                llvm::ConstantInt::get(Ty, 0x4000)),
+              llvm::ConstantInt::get(Ty, 15));
+          llvm::Value *Max = llvm::ConstantInt::get(Ty, 0x7FFF);
+          Ret = Builder.CreateSelect(Builder.CreateICmpSGT(Ret, Max), Max, Ret);
+          return Builder.CreateTrunc(Ret, Int16x8Ty);
+        });
+  }
+  /// Add the products of the adjacent signed 16-bit lanes.
+  Expect<void> compileVectorDotOp() {
+    return compileVectorVectorOp(
+        Int16x8Ty, [this](llvm::Value *LHS, llvm::Value *RHS) {
+          llvm::Value *Mul =
+              Builder.CreateMul(createVectorExtend(LHS, 8, true),
+                                createVectorExtend(RHS, 8, true));
+          llvm::Value *Undef = llvm::UndefValue::get(Mul->getType());
+          return Builder.CreateAdd(
+              Builder.CreateShuffleVector(Mul, Undef,
+                                          getShuffleMask({0, 2, 4, 6})),
+              Builder.CreateShuffleVector(Mul, Undef,
+                                          getShuffleMask({1, 3, 5, 7})));
+        });
+  }
+  Expect<void> compileVectorExtendOp(llvm::VectorType *VectorTy, bool Signed,
+                                     bool Low) {
+    const unsigned Lanes = getLaneCount(VectorTy) / 2;
+    return compileVectorOp(
+        VectorTy, [this, Lanes, Signed, Low](llvm::Value *V) {
+          return createVectorExtend(createVectorHalf(V, Lanes, Low), Lanes,
+                                    Signed);
+        });
+  }
+  Expect<void> compileVectorExtMulOp(llvm::VectorType *VectorTy, bool Signed,
+                                     bool Low) {
+    const unsigned Lanes = getLaneCount(VectorTy) / 2;
+    return compileVectorVectorOp(
+        VectorTy,
+        [this, Lanes, Signed, Low](llvm::Value *LHS, llvm::Value *RHS) {
+          return Builder.CreateMul(
+              createVectorExtend(createVectorHalf(LHS, Lanes, Low), Lanes,
+                                 Signed),
+              createVectorExtend(createVectorHalf(RHS, Lanes, Low), Lanes,
+                                 Signed));
+        });
+  }
+  /// Truncate to 32-bit integers with saturation, and zero the rest lanes.
+  Expect<void> compileVectorTruncSatOp(llvm::VectorType *VectorTy,
+                                       bool Signed) {
+    const unsigned Lanes = getLaneCount(VectorTy);
+    llvm::Type *IntTy = llvm::VectorType::get(Builder.getInt32Ty(), Lanes);
+    return compileVectorOp(VectorTy, [&](llvm::Value *V) {
+      /// NaN is converted to 0, and the out of range values are saturated.
+      llvm::Value *IntMin =
+          llvm::ConstantInt::get(IntTy, Signed ? uint32_t(INT32_MIN) : 0U);
+      llvm::Value *IntMax = llvm::ConstantInt::get(
+          IntTy, Signed ? uint32_t(INT32_MAX) : UINT32_MAX);
+      llvm::Value *FpMin =
+          llvm::ConstantFP::get(VectorTy, Signed ? -2147483648.0 : 0.0);
+      llvm::Value *FpMax = llvm::ConstantFP::get(
+          VectorTy, Signed ? 2147483648.0 : 4294967296.0);
+      llvm::Value *Ret = Signed ? Builder.CreateFPToSI(V, IntTy)
+                                : Builder.CreateFPToUI(V, IntTy);
+      Ret = Builder.CreateSelect(Builder.CreateFCmpOLE(V, FpMin), IntMin, Ret);
+      Ret = Builder.CreateSelect(Builder.CreateFCmpOGE(V, FpMax), IntMax, Ret);
+      Ret = Builder.CreateSelect(Builder.CreateFCmpUNO(V, V),
+                                 llvm::ConstantAggregateZero::get(IntTy), Ret);
+      if (Lanes == 2) {
+        Ret = Builder.CreateShuffleVector(
+            Ret, llvm::ConstantAggregateZero::get(IntTy),
+            getShuffleMask({0, 1, 2, 3}));
+      }
+      return Ret;
+    });
+  }
+  Expect<void> compileVectorConvertLowOp(bool Signed) {
+    return compileVectorOp(Int32x4Ty, [this, Signed](llvm::Value *V) {
+      V = createVectorHalf(V, 2, true);
+      return Signed ? Builder.CreateSIToFP(V, Doublex2Ty)
+                    : Builder.CreateUIToFP(V, Doublex2Ty);
+    });
+  }
+
+  /// Get the parameter and result types of block type.
+  std::pair<std::vector<ValType>, std::vector<ValType>>
+  resolveBlockType(const BlockType &Type) const {
+    if (const auto *Idx = std::get_if<uint32_t>(&Type)) {
+      const auto &FuncType = *Context.FunctionTypes[*Idx];
+      return {FuncType.getParamTypes(), FuncType.getReturnTypes()};
+    }
+    if (const ValType Result = std::get<ValType>(Type);
+        Result != ValType::None) {
+      return {{}, {Result}};
+    }
+    return {};
+  }
+
+  /// Get the value at the depth from the top of stack. The value is undefined
+  /// in unreachable code where the stack is not matched.
+  llvm::Value *getTopValue(size_t Depth, llvm::Type *Ty) const {
+    if (Stack.size() > Depth) {
+      if (auto *V = Stack[Stack.size() - 1 - Depth]; V->getType() == Ty) {
+        return V;
+      }
+    }
+    return llvm::UndefValue::get(Ty);
+  }
+
+  /// Get the top values of stack with the value types.
+  std::vector<llvm::Value *> getTopValues(const std::vector<ValType> &Types) {
+    std::vector<llvm::Value *> Values;
+    Values.reserve(Types.size());
+    for (size_t I = 0; I < Types.size(); ++I) {
+      Values.push_back(getTopValue(Types.size() - 1 - I,
+                                   toLLVMType(Context.Context, Types[I])));
+    }
+    return Values;
+  }
+
+  /// Replace the top values of stack with the block parameters.
+  void setParams(const std::vector<ValType> &Params) {
+    auto Args = getTopValues(Params);
+    Stack.erase(Stack.end() - std::min(Stack.size(), Params.size()),
+                Stack.end());
+    Stack.insert(Stack.end(), Args.begin(), Args.end());
+  }
+
+  /// Pack the top values of stack as the incoming value of block results.
+  llvm::Value *packValues(const std::vector<ValType> &Types) {
+    auto Values = getTopValues(Types);
+    if (Values.size() == 1) {
+      return Values.front();
+    }
+    return packStruct(Builder, Values);
+  }
 
   void enterBlock(llvm::BasicBlock *JumpTarget, bool IsForward,
-                  ValType ResultType) {
-    ControlStack.emplace_back(Stack.size(), JumpTarget, IsForward, ResultType,
-                              0);
+                  size_t ParamsSize, std::vector<ValType> Results,
+                  std::vector<llvm::PHINode *> LoopPHIs = {}) {
+    ControlStack.emplace_back(
+        Stack.size() - ParamsSize, JumpTarget, IsForward, std::move(Results),
+        std::vector<std::tuple<llvm::Value *, llvm::BasicBlock *>>(),
+        std::move(LoopPHIs));
   }
 
   std::vector<std::tuple<llvm::Value *, llvm::BasicBlock *>>
   leaveBlock(llvm::BasicBlock *NextTarget) {
     auto &Entry = ControlStack.back();
-    if (auto &Type = std::get<kReturnType>(Entry); Type != ValType::None) {
-      llvm::Value *V =
-          Stack.empty()
-              ? llvm::UndefValue::get(toLLVMType(Context.Context, Type))
-              : Stack.back();
-      std::get<kReturnPHI>(Entry).emplace_back(V, Builder.GetInsertBlock());
+    if (auto &Types = std::get<kReturnType>(Entry); !isVoidReturn(Types)) {
+      std::get<kReturnPHI>(Entry).emplace_back(packValues(Types),
+                                               Builder.GetInsertBlock());
     }
     Builder.CreateBr(NextTarget);
     Builder.SetInsertPoint(NextTarget);
@@ -1360,13 +3516,19 @@ private:
       return false;
     }
     auto &Entry = *(ControlStack.rbegin() + Index);
-    if (auto &Type = std::get<kReturnType>(Entry);
-        Type != ValType::None && std::get<kIsForward>(Entry)) {
-      llvm::Value *V =
-          Stack.empty()
-              ? llvm::UndefValue::get(toLLVMType(Context.Context, Type))
-              : Stack.back();
-      std::get<kReturnPHI>(Entry).emplace_back(V, Builder.GetInsertBlock());
+    if (std::get<kIsForward>(Entry)) {
+      if (auto &Types = std::get<kReturnType>(Entry); !isVoidReturn(Types)) {
+        std::get<kReturnPHI>(Entry).emplace_back(packValues(Types),
+                                                 Builder.GetInsertBlock());
+      }
+    } else {
+      /// Pass the loop parameters.
+      auto &PHIs = std::get<kLoopPHI>(Entry);
+      for (size_t I = 0; I < PHIs.size(); ++I) {
+        PHIs[I]->addIncoming(
+            getTopValue(PHIs.size() - 1 - I, PHIs[I]->getType()),
+            Builder.GetInsertBlock());
+      }
     }
     return true;
   }
@@ -1387,12 +3549,20 @@ private:
   static inline constexpr size_t kIsForward = 2;
   static inline constexpr size_t kReturnType = 3;
   static inline constexpr size_t kReturnPHI = 4;
+  static inline constexpr size_t kLoopPHI = 5;
   std::vector<
-      std::tuple<size_t, llvm::BasicBlock *, bool, ValType,
-                 std::vector<std::tuple<llvm::Value *, llvm::BasicBlock *>>>>
+      std::tuple<size_t, llvm::BasicBlock *, bool, std::vector<ValType>,
+                 std::vector<std::tuple<llvm::Value *, llvm::BasicBlock *>>,
+                 std::vector<llvm::PHINode *>>>
       ControlStack;
   llvm::Function *F;
   llvm::IRBuilder<> Builder;
+  llvm::VectorType *Int8x16Ty;
+  llvm::VectorType *Int16x8Ty;
+  llvm::VectorType *Int32x4Ty;
+  llvm::VectorType *Int64x2Ty;
+  llvm::VectorType *Floatx4Ty;
+  llvm::VectorType *Doublex2Ty;
 };
 
 static std::vector<llvm::Value *> getUndefValue(llvm::Type *Ty) {
@@ -1412,20 +3582,17 @@ static std::vector<llvm::Value *> getUndefValue(llvm::Type *Ty) {
   return Ret;
 }
 
-static llvm::Value *packStruct(llvm::IRBuilder<> &Builder, llvm::Value *Vals,
-                               unsigned N) {
-  llvm::Type *Ty = nullptr;
-  {
-    std::vector<llvm::Type *> Types;
-    Types.reserve(N);
-    for (unsigned I = 0; I < N; ++I) {
-      Types.push_back((Vals + I)->getType());
-    }
-    Ty = llvm::StructType::create(Types);
+static llvm::Value *packStruct(llvm::IRBuilder<> &Builder,
+                               llvm::ArrayRef<llvm::Value *> Values) {
+  std::vector<llvm::Type *> Types;
+  Types.reserve(Values.size());
+  for (auto *Val : Values) {
+    Types.push_back(Val->getType());
   }
-  llvm::Value *Ret = llvm::UndefValue::get(Ty);
-  for (unsigned I = 0; I < N; ++I) {
-    Ret = Builder.CreateInsertValue(Ret, Vals + I, {I});
+  llvm::Value *Ret =
+      llvm::UndefValue::get(llvm::StructType::get(Builder.getContext(), Types));
+  for (unsigned I = 0; I < Values.size(); ++I) {
+    Ret = Builder.CreateInsertValue(Ret, Values[I], {I});
   }
   return Ret;
 }
@@ -1441,6 +3608,66 @@ static std::vector<llvm::Value *> unpackStruct(llvm::IRBuilder<> &Builder,
   return Ret;
 }
 
+/// Check if the instructions may change the table 0.
+static bool isTableWritten(const AST::InstrVec &Instrs) {
+  using OpCode = AST::Instruction::OpCode;
+  for (const auto *Instr : Instrs) {
+    switch (Instr->getOpCode()) {
+    case OpCode::Block:
+    case OpCode::Loop:
+      if (isTableWritten(
+              static_cast<const AST::BlockControlInstruction *>(Instr)
+                  ->getBody())) {
+        return true;
+      }
+      break;
+    case OpCode::If: {
+      const auto *IfElse =
+          static_cast<const AST::IfElseControlInstruction *>(Instr);
+      if (isTableWritten(IfElse->getIfStatement()) ||
+          isTableWritten(IfElse->getElseStatement())) {
+        return true;
+      }
+      break;
+    }
+    case OpCode::Table__set:
+    case OpCode::Table__grow:
+    case OpCode::Table__fill:
+    case OpCode::Table__init:
+    case OpCode::Table__copy:
+      if (static_cast<const AST::TableInstruction *>(Instr)
+              ->getTargetIndex() == 0) {
+        return true;
+      }
+      break;
+    default:
+      break;
+    }
+  }
+  return false;
+}
+
+/// Check if the table 0 is imported or exported, which may be changed by
+/// the other modules.
+static bool isTableShared(const AST::Module &Module) {
+  if (const auto *ImportSec = Module.getImportSection()) {
+    for (const auto &ImpDesc : ImportSec->getContent()) {
+      if (ImpDesc->getExternalType() == ExternalType::Table) {
+        return true;
+      }
+    }
+  }
+  if (const auto *ExportSec = Module.getExportSection()) {
+    for (const auto &ExpDesc : ExportSec->getContent()) {
+      if (ExpDesc->getExternalType() == ExternalType::Table &&
+          ExpDesc->getExternalIndex() == 0) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 } // namespace
 
 namespace SSVM {
@@ -1509,7 +3736,21 @@ Expect<void> Compiler::compile(const Bytes &Data, const AST::Module &Module,
         /// Compile TableSection
         if (const AST::TableSection *TabSec = Module.getTableSection()) {
           if (const AST::ElementSection *ElemSec = Module.getElementSection()) {
-            return compile(*TabSec, *ElemSec);
+            if (auto Res = compile(*TabSec, *ElemSec); !Res) {
+              return Unexpect(Res);
+            }
+          }
+        }
+        /// The elements resolved in compile time are only used if the table
+        /// 0 is never changed in runtime.
+        if (isTableShared(Module)) {
+          Context->StaticTable = false;
+        }
+        if (const AST::CodeSection *CodeSec = Module.getCodeSection()) {
+          for (const auto &Code : CodeSec->getContent()) {
+            if (isTableWritten(Code->getInstrs())) {
+              Context->StaticTable = false;
+            }
           }
         }
         return {};
@@ -1545,7 +3786,22 @@ Expect<void> Compiler::compile(const Bytes &Data, const AST::Module &Module,
                 {Context->Trap->getType()->getPointerElementType(),
                  Context->Call->getType()->getPointerElementType(),
                  Context->MemGrow->getType()->getPointerElementType(),
-                 Context->MemSize->getType()->getPointerElementType()},
+                 Context->MemSize->getType()->getPointerElementType(),
+                 Context->MemInit->getType()->getPointerElementType(),
+                 Context->DataDrop->getType()->getPointerElementType(),
+                 Context->MemAtomicNotify->getType()->getPointerElementType(),
+                 Context->MemAtomicWait->getType()->getPointerElementType(),
+                 Context->TableSize->getType()->getPointerElementType(),
+                 Context->TableGrow->getType()->getPointerElementType(),
+                 Context->TableGet->getType()->getPointerElementType(),
+                 Context->TableSet->getType()->getPointerElementType(),
+                 Context->TableFill->getType()->getPointerElementType(),
+                 Context->TableInit->getType()->getPointerElementType(),
+                 Context->TableCopy->getType()->getPointerElementType(),
+                 Context->ElemDrop->getType()->getPointerElementType(),
+                 Context->RefFunc->getType()->getPointerElementType(),
+                 Context->TableGetFuncIdx->getType()->getPointerElementType(),
+                 Context->CallIndirect->getType()->getPointerElementType()},
                 false),
             llvm::GlobalValue::ExternalLinkage, "ctor", LLModule.get());
         Ctor->addFnAttr(llvm::Attribute::StrictFP);
@@ -1559,6 +3815,21 @@ Expect<void> Compiler::compile(const Bytes &Data, const AST::Module &Module,
         Builder.CreateStore(Ctor->arg_begin() + 1, Context->Call);
         Builder.CreateStore(Ctor->arg_begin() + 2, Context->MemGrow);
         Builder.CreateStore(Ctor->arg_begin() + 3, Context->MemSize);
+        Builder.CreateStore(Ctor->arg_begin() + 4, Context->MemInit);
+        Builder.CreateStore(Ctor->arg_begin() + 5, Context->DataDrop);
+        Builder.CreateStore(Ctor->arg_begin() + 6, Context->MemAtomicNotify);
+        Builder.CreateStore(Ctor->arg_begin() + 7, Context->MemAtomicWait);
+        Builder.CreateStore(Ctor->arg_begin() + 8, Context->TableSize);
+        Builder.CreateStore(Ctor->arg_begin() + 9, Context->TableGrow);
+        Builder.CreateStore(Ctor->arg_begin() + 10, Context->TableGet);
+        Builder.CreateStore(Ctor->arg_begin() + 11, Context->TableSet);
+        Builder.CreateStore(Ctor->arg_begin() + 12, Context->TableFill);
+        Builder.CreateStore(Ctor->arg_begin() + 13, Context->TableInit);
+        Builder.CreateStore(Ctor->arg_begin() + 14, Context->TableCopy);
+        Builder.CreateStore(Ctor->arg_begin() + 15, Context->ElemDrop);
+        Builder.CreateStore(Ctor->arg_begin() + 16, Context->RefFunc);
+        Builder.CreateStore(Ctor->arg_begin() + 17, Context->TableGetFuncIdx);
+        Builder.CreateStore(Ctor->arg_begin() + 18, Context->CallIndirect);
         for (auto &F : Context->Ctors) {
           Builder.CreateCall(F);
         }
@@ -1776,7 +4047,7 @@ Expect<void> Compiler::compile(const AST::ImportSection &ImportSec) {
       } else {
         Args = Builder.CreateAlloca(
             Builder.getInt8Ty(),
-            Builder.getInt64((FTy->getNumParams() - 1) * 8));
+            Builder.getInt64((FTy->getNumParams() - 1) * sizeof(ValVariant)));
       }
 
       llvm::Value *Rets;
@@ -1785,14 +4056,16 @@ Expect<void> Compiler::compile(const AST::ImportSection &ImportSec) {
       } else if (Ty->isStructTy()) {
         Rets = Builder.CreateAlloca(
             Builder.getInt8Ty(),
-            Builder.getInt64(Ty->getStructNumElements() * 8));
+            Builder.getInt64(Ty->getStructNumElements() * sizeof(ValVariant)));
       } else {
-        Rets = Builder.CreateAlloca(Builder.getInt8Ty(), Builder.getInt64(8));
+        Rets = Builder.CreateAlloca(Builder.getInt8Ty(),
+                                    Builder.getInt64(sizeof(ValVariant)));
       }
 
       unsigned I = 0;
       for (llvm::Argument *Arg = Ctx + 1; Arg != F->arg_end(); ++Arg, ++I) {
-        llvm::Value *Ptr = Builder.CreateConstInBoundsGEP1_64(Args, I * 8);
+        llvm::Value *Ptr =
+            Builder.CreateConstInBoundsGEP1_64(Args, I * sizeof(ValVariant));
         Builder.CreateStore(
             Arg, Builder.CreateBitCast(
                      Ptr, llvm::PointerType::getUnqual(Arg->getType())));
@@ -1807,7 +4080,8 @@ Expect<void> Compiler::compile(const AST::ImportSection &ImportSec) {
         std::vector<llvm::Value *> Ret;
         Ret.reserve(N);
         for (unsigned I = 0; I < N; ++I) {
-          llvm::Value *VPtr = Builder.CreateConstInBoundsGEP1_64(Rets, I);
+          llvm::Value *VPtr =
+              Builder.CreateConstInBoundsGEP1_64(Rets, I * sizeof(ValVariant));
           llvm::Value *Ptr = Builder.CreateBitCast(
               VPtr, llvm::PointerType::getUnqual(Ty->getStructElementType(I)));
           Ret.push_back(Builder.CreateLoad(Ptr));
@@ -1875,7 +4149,8 @@ Expect<void> Compiler::compile(const AST::ExportSection &ExportSec) {
       unsigned I = 0;
       for (llvm::Argument *Arg = F->arg_begin() + 1; Arg != F->arg_end();
            ++Arg, ++I) {
-        llvm::Value *VPtr = Builder.CreateConstInBoundsGEP1_64(RawArgs, I * 8);
+        llvm::Value *VPtr =
+            Builder.CreateConstInBoundsGEP1_64(RawArgs, I * sizeof(ValVariant));
         llvm::Value *Ptr = Builder.CreateBitCast(
             VPtr, llvm::PointerType::getUnqual(Arg->getType()));
         Args.push_back(Builder.CreateLoad(Ptr));
@@ -1887,8 +4162,8 @@ Expect<void> Compiler::compile(const AST::ExportSection &ExportSec) {
       } else if (Ty->isStructTy()) {
         const unsigned N = Ty->getStructNumElements();
         for (unsigned I = 0; I < N; ++I) {
-          llvm::Value *VPtr =
-              Builder.CreateConstInBoundsGEP1_64(RawRets, I * 8);
+          llvm::Value *VPtr = Builder.CreateConstInBoundsGEP1_64(
+              RawRets, I * sizeof(ValVariant));
           llvm::Value *Ptr = Builder.CreateBitCast(
               VPtr, llvm::PointerType::getUnqual(Ty->getStructElementType(I)));
           Builder.CreateStore(Builder.CreateExtractValue(Ret, {I}), Ptr);
@@ -1928,12 +4203,14 @@ Expect<void> Compiler::compile(const AST::GlobalSection &GlobalSec) {
   for (size_t I = 0; I < GlobalSec.getContent().size(); ++I) {
     const SSVM::ValType &ValType =
         GlobalSec.getContent()[I]->getGlobalType()->getValueType();
+    llvm::Constant *Init = FunctionCompiler::evaluate(
+        GlobalSec.getContent()[I]->getInstrs(), *Context);
+    if (!Init) {
+      return Unexpect(ErrCode::InstrTypeMismatch);
+    }
     llvm::GlobalVariable *G = new llvm::GlobalVariable(
         Context->Module, toLLVMType(Context->Context, ValType), false,
-        llvm::GlobalValue::InternalLinkage,
-        FunctionCompiler::evaluate(GlobalSec.getContent()[I]->getInstrs(),
-                                   *Context),
-        "g." + std::to_string(I));
+        llvm::GlobalValue::InternalLinkage, Init, "g." + std::to_string(I));
     Context->Globals.push_back(G);
   }
   return {};
@@ -1967,12 +4244,12 @@ Expect<void> Compiler::compile(const AST::MemorySection &MemorySection,
     llvm::Constant *Temp =
         FunctionCompiler::evaluate(DataSeg->getInstrs(), *Context);
     const uint64_t Offset = llvm::cast<llvm::ConstantInt>(Temp)->getZExtValue();
-    const auto &Data = DataSeg->getData();
+    const auto Data = DataSeg->getData();
 
     if (ResultData.size() < Offset + Data.size()) {
       ResultData.resize(Offset + Data.size());
     }
-    std::copy(Data.cbegin(), Data.cend(), ResultData.begin() + Offset);
+    std::copy(Data.begin(), Data.end(), ResultData.begin() + Offset);
   }
   llvm::Function *Ctor = llvm::Function::Create(
       llvm::FunctionType::get(llvm::Type::getVoidTy(VMContext), false),
@@ -2003,13 +4280,47 @@ Expect<void> Compiler::compile(const AST::MemorySection &MemorySection,
 Expect<void> Compiler::compile(const AST::TableSection &TableSection,
                                const AST::ElementSection &ElementSection) {
   auto &Elements = Context->Elements;
+  Context->StaticTable = true;
   for (const auto &Element : ElementSection.getContent()) {
-    llvm::Constant *Temp =
-        FunctionCompiler::evaluate(Element->getInstrs(), *Context);
-    const uint64_t Offset = llvm::cast<llvm::ConstantInt>(Temp)->getZExtValue();
-    const auto &FuncIdxes = Element->getFuncIdxes();
+    /// Only active segments initialize the table. The table 0 is the only
+    /// table resolved in compile time.
+    if (Element->getMode() != AST::SegmentMode::Active ||
+        Element->getIdx() != 0) {
+      continue;
+    }
+    /// The offset from an imported global is only known in runtime.
+    auto *Temp = llvm::dyn_cast_or_null<llvm::ConstantInt>(
+        FunctionCompiler::evaluate(Element->getInstrs(), *Context));
+    if (Temp == nullptr) {
+      Context->StaticTable = false;
+      return {};
+    }
+    const uint64_t Offset = Temp->getZExtValue();
+    std::vector<uint32_t> FuncIdxes = Element->getFuncIdxes();
+    for (const auto &InitExpr : Element->getInitExprs()) {
+      /// Null references are left uninitialized, and the others are resolved
+      /// in runtime.
+      const auto &Instrs = InitExpr->getInstrs();
+      if (Instrs.size() != 1) {
+        Context->StaticTable = false;
+        return {};
+      }
+      switch (Instrs.front()->getOpCode()) {
+      case AST::Instruction::OpCode::Ref__func:
+        FuncIdxes.push_back(
+            static_cast<const AST::ReferenceInstruction *>(Instrs.front())
+                ->getFuncIndex());
+        break;
+      case AST::Instruction::OpCode::Ref__null:
+        FuncIdxes.push_back(kNullElement);
+        break;
+      default:
+        Context->StaticTable = false;
+        return {};
+      }
+    }
     if (Elements.size() < Offset + FuncIdxes.size()) {
-      Elements.resize(Offset + FuncIdxes.size());
+      Elements.resize(Offset + FuncIdxes.size(), kNullElement);
     }
     std::copy(FuncIdxes.cbegin(), FuncIdxes.cend(), Elements.begin() + Offset);
   }
@@ -1,153 +1,98 @@
 // SPDX-License-Identifier: Apache-2.0
 #include "common/ast/instruction.h"
 
+#include <cstring>
+#include <vector>
+
 namespace SSVM {
 namespace AST {
 
-/// Copy construtor. See "include/common/ast/instruction.h".
-BlockControlInstruction::BlockControlInstruction(
-    const BlockControlInstruction &Instr)
-    : Instruction(Instr.Code), BlockType(Instr.BlockType) {
-  for (auto &It : Instr.Body) {
-    if (auto Res = makeInstructionNode(*It.get())) {
-      Body.push_back(std::move(*Res));
+namespace {
+
+/// Nodes of the instruction sequences being loaded by this thread. A sequence
+/// is copied into the arena when it ends, so nested sequences share the stack.
+std::vector<Instruction *> &getSeqStack() {
+  thread_local std::vector<Instruction *> Stack;
+  return Stack;
+}
+
+/// Read and check the block type, which is a value type or a function type
+/// index in signed 33-bit LEB128.
+Expect<BlockType> loadBlockType(FileMgr &Mgr) {
+  int64_t Code;
+  if (auto Res = Mgr.readS64()) {
+    Code = *Res;
+  } else {
+    return Unexpect(Res);
+  }
+  if (Code >= 0) {
+    if (Code > INT64_C(0xFFFFFFFF)) {
+      return Unexpect(ErrCode::InvalidGrammar);
     }
+    return BlockType(static_cast<uint32_t>(Code));
+  }
+  if (Code < -0x40) {
+    return Unexpect(ErrCode::InvalidGrammar);
+  }
+  const ValType Type = static_cast<ValType>(Code & 0x7F);
+  switch (Type) {
+  case ValType::I32:
+  case ValType::I64:
+  case ValType::F32:
+  case ValType::F64:
+  case ValType::V128:
+  case ValType::FuncRef:
+  case ValType::ExternRef:
+  case ValType::None:
+    return BlockType(Type);
+  default:
+    return Unexpect(ErrCode::InvalidGrammar);
   }
 }
 
+} // namespace
+
 /// Load binary of block instructions. See "include/common/ast/instruction.h".
-Expect<void> BlockControlInstruction::loadBinary(FileMgr &Mgr) {
+Expect<void> BlockControlInstruction::loadBinary(FileMgr &Mgr, Arena &Pool) {
   /// Read the block return type.
-  if (auto Res = Mgr.readByte()) {
-    BlockType = static_cast<ValType>(*Res);
-    switch (BlockType) {
-    case ValType::I32:
-    case ValType::I64:
-    case ValType::F32:
-    case ValType::F64:
-    case ValType::None:
-      break;
-    default:
-      return Unexpect(ErrCode::InvalidGrammar);
-    }
+  if (auto Res = loadBlockType(Mgr)) {
+    ResType = *Res;
   } else {
     return Unexpect(Res);
   }
 
   /// Read instructions and make nodes until Opcode::End.
-  while (true) {
-    OpCode Code;
-
-    /// Read the opcode and check if error.
-    if (auto Res = Mgr.readByte()) {
-      Code = static_cast<Instruction::OpCode>(*Res);
-    } else {
-      return Unexpect(Res);
-    }
-
-    /// When reach end, this block is ended.
-    if (Code == Instruction::OpCode::End) {
-      break;
-    }
-
-    /// Create the instruction node and load contents.
-    std::unique_ptr<Instruction> NewInst;
-    if (auto Res = makeInstructionNode(Code)) {
-      NewInst = std::move(*Res);
-    } else {
-      return Unexpect(Res);
-    }
-    if (auto Res = NewInst->loadBinary(Mgr)) {
-      Body.push_back(std::move(NewInst));
-    } else {
-      return Unexpect(Res);
-    }
+  if (auto Res = loadInstrSeq(Mgr, Pool, Body); !Res) {
+    return Unexpect(Res);
   }
-
   return {};
 }
 
-/// Copy construtor. See "include/common/ast/instruction.h".
-IfElseControlInstruction::IfElseControlInstruction(
-    const IfElseControlInstruction &Instr)
-    : Instruction(Instr.Code), BlockType(Instr.BlockType) {
-  for (auto &It : Instr.IfStatement) {
-    if (auto Res = makeInstructionNode(*It.get())) {
-      IfStatement.push_back(std::move(*Res));
-    }
-  }
-  for (auto &It : Instr.ElseStatement) {
-    if (auto Res = makeInstructionNode(*It.get())) {
-      ElseStatement.push_back(std::move(*Res));
-    }
-  }
-}
-
 /// Load binary of if-else instructions. See "include/common/ast/instruction.h".
-Expect<void> IfElseControlInstruction::loadBinary(FileMgr &Mgr) {
+Expect<void> IfElseControlInstruction::loadBinary(FileMgr &Mgr, Arena &Pool) {
   /// Read the block return type.
-  if (auto Res = Mgr.readByte()) {
-    BlockType = static_cast<ValType>(*Res);
-    switch (BlockType) {
-    case ValType::I32:
-    case ValType::I64:
-    case ValType::F32:
-    case ValType::F64:
-    case ValType::None:
-      break;
-    default:
-      return Unexpect(ErrCode::InvalidGrammar);
-    }
+  if (auto Res = loadBlockType(Mgr)) {
+    ResType = *Res;
   } else {
     return Unexpect(Res);
   }
 
-  /// Read instructions and make nodes until OpCode::End.
-  bool IsElseStatement = false;
-  while (true) {
-    OpCode Code;
-
-    /// Read the opcode and check if error.
-    if (auto Res = Mgr.readByte()) {
-      Code = static_cast<Instruction::OpCode>(*Res);
-    } else {
-      return Unexpect(Res);
-    }
-
-    /// When reach end, this if-else block is ended.
-    if (Code == OpCode::End) {
-      break;
-    }
-
-    /// If an OpCode::Else read, switch to Else statement.
-    if (Code == OpCode::Else) {
-      IsElseStatement = true;
-      continue;
-    }
-
-    /// Create the instruction node and load contents.
-    std::unique_ptr<Instruction> NewInst;
-    if (auto Res = makeInstructionNode(Code)) {
-      NewInst = std::move(*Res);
-    } else {
-      return Unexpect(Res);
-    }
-    if (auto Res = NewInst->loadBinary(Mgr)) {
-      if (IsElseStatement) {
-        ElseStatement.push_back(std::move(NewInst));
-      } else {
-        IfStatement.push_back(std::move(NewInst));
+  /// Read instructions and make nodes until OpCode::End. If an OpCode::Else
+  /// read, switch to Else statement.
+  if (auto Res = loadInstrSeq(Mgr, Pool, IfStatement, true)) {
+    if (*Res == OpCode::Else) {
+      if (auto Res = loadInstrSeq(Mgr, Pool, ElseStatement); !Res) {
+        return Unexpect(Res);
       }
-    } else {
-      return Unexpect(Res);
     }
+  } else {
+    return Unexpect(Res);
   }
-
   return {};
 }
 
 /// Load binary of branch instructions. See "include/common/ast/instruction.h".
-Expect<void> BrControlInstruction::loadBinary(FileMgr &Mgr) {
+Expect<void> BrControlInstruction::loadBinary(FileMgr &Mgr, Arena &) {
   if (auto Res = Mgr.readU32()) {
     LabelIdx = *Res;
   } else {
@@ -157,7 +102,8 @@ Expect<void> BrControlInstruction::loadBinary(FileMgr &Mgr) {
 }
 
 /// Load branch table instructions. See "include/common/ast/instruction.h".
-Expect<void> BrTableControlInstruction::loadBinary(FileMgr &Mgr) {
+Expect<void> BrTableControlInstruction::loadBinary(FileMgr &Mgr,
+                                                   Arena &Pool) {
   uint32_t VecCnt = 0;
 
   /// Read the vector of labels.
@@ -166,13 +112,18 @@ Expect<void> BrTableControlInstruction::loadBinary(FileMgr &Mgr) {
   } else {
     return Unexpect(Res);
   }
+  /// Collect labels before copying them into the arena, because the count is
+  /// not checked against the remaining bytes.
+  thread_local std::vector<uint32_t> Labels;
+  Labels.clear();
   for (uint32_t i = 0; i < VecCnt; ++i) {
     if (auto Res = Mgr.readU32()) {
-      LabelTable.push_back(*Res);
+      Labels.push_back(*Res);
     } else {
       return Unexpect(Res);
     }
   }
+  LabelTable = Pool.copy(Span<const uint32_t>(Labels));
 
   /// Read default label.
   if (auto Res = Mgr.readU32()) {
@@ -184,7 +135,7 @@ Expect<void> BrTableControlInstruction::loadBinary(FileMgr &Mgr) {
 }
 
 /// Load binary of call instructions. See "include/common/ast/instruction.h".
-Expect<void> CallControlInstruction::loadBinary(FileMgr &Mgr) {
+Expect<void> CallControlInstruction::loadBinary(FileMgr &Mgr, Arena &) {
   /// Read function index.
   if (auto Res = Mgr.readU32()) {
     FuncIdx = *Res;
@@ -192,12 +143,10 @@ Expect<void> CallControlInstruction::loadBinary(FileMgr &Mgr) {
     return Unexpect(Res);
   }
 
-  /// Read the 0x00 checking code in indirect_call case.
-  if (Code == OpCode::Call_indirect) {
-    if (auto Res = Mgr.readByte()) {
-      if (*Res != 0x00) {
-        return Unexpect(ErrCode::InvalidGrammar);
-      }
+  /// Read the table index in indirect_call case.
+  if (Code == OpCode::Call_indirect || Code == OpCode::Return_call_indirect) {
+    if (auto Res = Mgr.readU32()) {
+      TableIdx = *Res;
     } else {
       return Unexpect(Res);
     }
@@ -206,8 +155,42 @@ Expect<void> CallControlInstruction::loadBinary(FileMgr &Mgr) {
   return {};
 }
 
+/// Load binary of parametric instructions. See
+/// "include/common/ast/instruction.h".
+Expect<void> ParametricInstruction::loadBinary(FileMgr &Mgr, Arena &) {
+  if (Code != OpCode::Select_t) {
+    return {};
+  }
+
+  /// Read the vector of value types, which has exactly one type.
+  if (auto Res = Mgr.readU32()) {
+    if (*Res != 1) {
+      return Unexpect(ErrCode::InvalidGrammar);
+    }
+  } else {
+    return Unexpect(Res);
+  }
+  if (auto Res = Mgr.readByte()) {
+    Type = static_cast<ValType>(*Res);
+  } else {
+    return Unexpect(Res);
+  }
+  switch (Type) {
+  case ValType::I32:
+  case ValType::I64:
+  case ValType::F32:
+  case ValType::F64:
+  case ValType::V128:
+  case ValType::FuncRef:
+  case ValType::ExternRef:
+    return {};
+  default:
+    return Unexpect(ErrCode::InvalidGrammar);
+  }
+}
+
 /// Load variable instructions. See "include/common/ast/instruction.h".
-Expect<void> VariableInstruction::loadBinary(FileMgr &Mgr) {
+Expect<void> VariableInstruction::loadBinary(FileMgr &Mgr, Arena &) {
   if (auto Res = Mgr.readU32()) {
     VarIdx = *Res;
   } else {
@@ -217,7 +200,43 @@ Expect<void> VariableInstruction::loadBinary(FileMgr &Mgr) {
 }
 
 /// Load binary of memory instructions. See "include/common/ast/instruction.h".
-Expect<void> MemoryInstruction::loadBinary(FileMgr &Mgr) {
+Expect<void> MemoryInstruction::loadBinary(FileMgr &Mgr, Arena &) {
+  /// Read the 0x00 checking code of the memory index.
+  auto ReadCheckZero = [&Mgr]() -> Expect<void> {
+    if (auto Res = Mgr.readByte()) {
+      if (*Res != 0x00) {
+        return Unexpect(ErrCode::InvalidGrammar);
+      }
+      return {};
+    } else {
+      return Unexpect(Res);
+    }
+  };
+
+  /// Read the data index and memory indices in bulk memory cases.
+  switch (Code) {
+  case Instruction::OpCode::Memory__init:
+  case Instruction::OpCode::Data__drop:
+    if (auto Res = Mgr.readU32()) {
+      DataIdx = *Res;
+    } else {
+      return Unexpect(Res);
+    }
+    if (Code == Instruction::OpCode::Memory__init) {
+      return ReadCheckZero();
+    }
+    return {};
+  case Instruction::OpCode::Memory__copy:
+    if (auto Res = ReadCheckZero(); !Res) {
+      return Unexpect(Res);
+    }
+    return ReadCheckZero();
+  case Instruction::OpCode::Memory__fill:
+    return ReadCheckZero();
+  default:
+    break;
+  }
+
   /// Read the 0x00 checking code in memory.grow and memory.size cases.
   if (Code == Instruction::OpCode::Memory__grow ||
       Code == Instruction::OpCode::Memory__size) {
@@ -244,8 +263,67 @@ Expect<void> MemoryInstruction::loadBinary(FileMgr &Mgr) {
   return {};
 }
 
+/// Load table instructions. See "include/common/ast/instruction.h".
+Expect<void> TableInstruction::loadBinary(FileMgr &Mgr, Arena &) {
+  /// Read the element segment index in table.init and elem.drop cases.
+  if (Code == Instruction::OpCode::Table__init ||
+      Code == Instruction::OpCode::Elem__drop) {
+    if (auto Res = Mgr.readU32()) {
+      ElemIdx = *Res;
+    } else {
+      return Unexpect(Res);
+    }
+  }
+
+  /// Read the destination table index in the other cases.
+  if (Code != Instruction::OpCode::Elem__drop) {
+    if (auto Res = Mgr.readU32()) {
+      TargetIdx = *Res;
+    } else {
+      return Unexpect(Res);
+    }
+  }
+
+  /// Read the source table index in table.copy case.
+  if (Code == Instruction::OpCode::Table__copy) {
+    if (auto Res = Mgr.readU32()) {
+      SourceIdx = *Res;
+    } else {
+      return Unexpect(Res);
+    }
+  }
+  return {};
+}
+
+/// Load reference instructions. See "include/common/ast/instruction.h".
+Expect<void> ReferenceInstruction::loadBinary(FileMgr &Mgr, Arena &) {
+  switch (Code) {
+  case OpCode::Ref__null:
+    /// Read the reference type.
+    if (auto Res = Mgr.readByte()) {
+      Type = static_cast<ValType>(*Res);
+    } else {
+      return Unexpect(Res);
+    }
+    if (!isRefType(Type)) {
+      return Unexpect(ErrCode::InvalidGrammar);
+    }
+    return {};
+  case OpCode::Ref__func:
+    /// Read the function index.
+    if (auto Res = Mgr.readU32()) {
+      FuncIdx = *Res;
+    } else {
+      return Unexpect(Res);
+    }
+    return {};
+  default:
+    return {};
+  }
+}
+
 /// Load const numeric instructions. See "include/common/ast/instruction.h".
-Expect<void> ConstInstruction::loadBinary(FileMgr &Mgr) {
+Expect<void> ConstInstruction::loadBinary(FileMgr &Mgr, Arena &) {
   /// Read the const number of corresbonding value type.
   switch (Code) {
   case Instruction::OpCode::I32__const:
@@ -276,6 +354,15 @@ Expect<void> ConstInstruction::loadBinary(FileMgr &Mgr) {
       return Unexpect(Res);
     }
     break;
+  case Instruction::OpCode::V128__const:
+    if (auto Res = Mgr.readBytes(16)) {
+      uint128_t Value;
+      std::memcpy(&Value, Res->data(), sizeof(Value));
+      Num = Value;
+    } else {
+      return Unexpect(Res);
+    }
+    break;
   default:
     return Unexpect(ErrCode::InvalidGrammar);
   }
@@ -283,40 +370,166 @@ Expect<void> ConstInstruction::loadBinary(FileMgr &Mgr) {
   return {};
 }
 
+/// Load binary of SIMD memory instructions. See
+/// "include/common/ast/instruction.h".
+Expect<void> SIMDMemoryInstruction::loadBinary(FileMgr &Mgr, Arena &) {
+  /// Read memory arguments.
+  if (auto Res = Mgr.readU32()) {
+    Align = *Res;
+  } else {
+    return Unexpect(Res);
+  }
+  if (auto Res = Mgr.readU32()) {
+    Offset = *Res;
+  } else {
+    return Unexpect(Res);
+  }
+
+  /// Read the lane index in load lane and store lane cases.
+  switch (Code) {
+  case OpCode::V128__load8_lane:
+  case OpCode::V128__load16_lane:
+  case OpCode::V128__load32_lane:
+  case OpCode::V128__load64_lane:
+  case OpCode::V128__store8_lane:
+  case OpCode::V128__store16_lane:
+  case OpCode::V128__store32_lane:
+  case OpCode::V128__store64_lane:
+    if (auto Res = Mgr.readByte()) {
+      Lane = *Res;
+    } else {
+      return Unexpect(Res);
+    }
+    break;
+  default:
+    break;
+  }
+  return {};
+}
+
+/// Load binary of atomic memory instructions. See
+/// "include/common/ast/instruction.h".
+Expect<void> AtomicMemoryInstruction::loadBinary(FileMgr &Mgr, Arena &) {
+  /// Read the reserved byte in the fence case.
+  if (Code == OpCode::Atomic__fence) {
+    if (auto Res = Mgr.readByte()) {
+      if (*Res != 0x00) {
+        return Unexpect(ErrCode::InvalidGrammar);
+      }
+    } else {
+      return Unexpect(Res);
+    }
+    return {};
+  }
+
+  /// Read memory arguments.
+  if (auto Res = Mgr.readU32()) {
+    Align = *Res;
+  } else {
+    return Unexpect(Res);
+  }
+  if (auto Res = Mgr.readU32()) {
+    Offset = *Res;
+  } else {
+    return Unexpect(Res);
+  }
+  return {};
+}
+
+/// Load binary of SIMD lane instructions. See
+/// "include/common/ast/instruction.h".
+Expect<void> SIMDLaneInstruction::loadBinary(FileMgr &Mgr, Arena &) {
+  if (auto Res = Mgr.readByte()) {
+    Lane = *Res;
+  } else {
+    return Unexpect(Res);
+  }
+  return {};
+}
+
+/// Load binary of SIMD shuffle instructions. See
+/// "include/common/ast/instruction.h".
+Expect<void> SIMDShuffleInstruction::loadBinary(FileMgr &Mgr, Arena &) {
+  for (auto &Lane : Lanes) {
+    if (auto Res = Mgr.readByte()) {
+      Lane = *Res;
+    } else {
+      return Unexpect(Res);
+    }
+  }
+  return {};
+}
+
 /// Instruction node maker. See "include/common/ast/instruction.h".
-Expect<std::unique_ptr<Instruction>>
-makeInstructionNode(const Instruction::OpCode &Code) {
+Expect<Instruction *> makeInstructionNode(const Instruction::OpCode &Code,
+                                          Arena &Pool) {
   return dispatchInstruction(
-      Code, [&Code](auto &&Arg) -> Expect<std::unique_ptr<Instruction>> {
+      Code, [&Code, &Pool](auto &&Arg) -> Expect<Instruction *> {
         if constexpr (std::is_void_v<
                           typename std::decay_t<decltype(Arg)>::type>) {
           /// If the Code not matched, return null pointer.
           return Unexpect(ErrCode::InvalidGrammar);
         } else {
           /// Make the instruction node according to Code.
-          return std::make_unique<typename std::decay_t<decltype(Arg)>::type>(
-              Code);
+          return Pool.make<typename std::decay_t<decltype(Arg)>::type>(Code);
         }
       });
 }
 
-/// Instruction node duplicater. See "include/common/ast/instruction.h".
-Expect<std::unique_ptr<Instruction>>
-makeInstructionNode(const Instruction &Instr) {
-  return dispatchInstruction(
-      Instr.getOpCode(),
-      [&Instr](auto &&Arg) -> Expect<std::unique_ptr<Instruction>> {
-        if constexpr (std::is_void_v<
-                          typename std::decay_t<decltype(Arg)>::type>) {
-          /// If the Code not matched, return null pointer.
-          return Unexpect(ErrCode::InvalidGrammar);
+/// Load instruction sequence. See "include/common/ast/instruction.h".
+Expect<Instruction::OpCode> loadInstrSeq(FileMgr &Mgr, Arena &Pool,
+                                         InstrVec &Seq, const bool AllowElse) {
+  auto &Stack = getSeqStack();
+  const size_t Base = Stack.size();
+  auto Status = [&]() -> Expect<Instruction::OpCode> {
+    while (true) {
+      Instruction::OpCode Code;
+
+      /// Read the opcode and check if error.
+      if (auto Res = Mgr.readByte()) {
+        Code = static_cast<Instruction::OpCode>(*Res);
+      } else {
+        return Unexpect(Res);
+      }
+
+      /// Read the sub-opcode of prefixed instructions.
+      if (const uint16_t Prefix = static_cast<uint16_t>(Code);
+          Prefix == 0xFCU || Prefix == 0xFDU || Prefix == 0xFEU) {
+        if (auto Res = Mgr.readU32()) {
+          if (*Res > 0xFFU) {
+            return Unexpect(ErrCode::InvalidGrammar);
+          }
+          Code = static_cast<Instruction::OpCode>((Prefix << 8) | *Res);
         } else {
-          /// Make the instruction node according to Code.
-          return std::make_unique<typename std::decay_t<decltype(Arg)>::type>(
-              static_cast<const typename std::decay_t<decltype(Arg)>::type &>(
-                  Instr));
+          return Unexpect(Res);
         }
-      });
+      }
+
+      /// When reach end, this sequence is ended.
+      if (Code == Instruction::OpCode::End ||
+          (AllowElse && Code == Instruction::OpCode::Else)) {
+        return Code;
+      }
+
+      /// Create the instruction node and load contents.
+      Instruction *NewInst = nullptr;
+      if (auto Res = makeInstructionNode(Code, Pool)) {
+        NewInst = *Res;
+      } else {
+        return Unexpect(Res);
+      }
+      if (auto Res = NewInst->loadBinary(Mgr, Pool)) {
+        Stack.push_back(NewInst);
+      } else {
+        return Unexpect(Res);
+      }
+    }
+  }();
+  if (Status) {
+    Seq = Pool.copy(InstrVec(Stack.data() + Base, Stack.size() - Base));
+  }
+  Stack.resize(Base);
+  return Status;
 }
 
 } // namespace AST
@@ -1,5 +1,9 @@
 // SPDX-License-Identifier: Apache-2.0
 #include "common/ast/section.h"
+#include "support/threadpool.h"
+
+#include <algorithm>
+#include <atomic>
 
 namespace SSVM {
 namespace AST {
@@ -26,8 +30,8 @@ Expect<void> Section::loadSize(FileMgr &Mgr) {
 /// Load content of custom section. See "include/ast/section.h".
 Expect<void> CustomSection::loadContent(FileMgr &Mgr) {
   /// Read all raw bytes.
-  if (auto Res = Mgr.readBytes(ContentSize)) {
-    Content = *Res;
+  if (auto Res = Mgr.readSharedBytes(ContentSize)) {
+    Content = std::move(*Res);
   } else {
     return Unexpect(Res);
   }
@@ -93,6 +97,16 @@ Expect<void> StartSection::loadContent(FileMgr &Mgr) {
   return {};
 }
 
+/// Load content of data count section. See "include/ast/section.h".
+Expect<void> DataCountSection::loadContent(FileMgr &Mgr) {
+  if (auto Res = Mgr.readU32()) {
+    Content = *Res;
+  } else {
+    return Unexpect(Res);
+  }
+  return {};
+}
+
 /// Load vector of element section. See "include/ast/section.h".
 Expect<void> ElementSection::loadContent(FileMgr &Mgr) {
   return Section::loadToVector(Mgr, Content);
@@ -100,7 +114,82 @@ Expect<void> ElementSection::loadContent(FileMgr &Mgr) {
 
 /// Load vector of code section. See "include/ast/section.h".
 Expect<void> CodeSection::loadContent(FileMgr &Mgr) {
-  return Section::loadToVector(Mgr, Content);
+  uint32_t VecCnt = 0;
+  if (auto Res = Mgr.readU32()) {
+    VecCnt = *Res;
+  } else {
+    return Unexpect(Res);
+  }
+
+  /// Scan the segment boundaries first. Every segment takes at least one byte,
+  /// so do not trust a count larger than the section.
+  std::vector<std::unique_ptr<CodeSegment>> Segs;
+  std::vector<SharedBytes> Bodies;
+  Segs.reserve(std::min(VecCnt, ContentSize));
+  Bodies.reserve(std::min(VecCnt, ContentSize));
+  for (uint32_t I = 0; I < VecCnt; ++I) {
+    auto NewContent = std::make_unique<CodeSegment>();
+    if (auto Res = NewContent->loadSize(Mgr)) {
+      Bodies.push_back(std::move(*Res));
+      Segs.push_back(std::move(NewContent));
+    } else {
+      return Unexpect(Res);
+    }
+  }
+  return loadSegments(std::move(Segs), std::move(Bodies));
+}
+
+/// Load bodies of code segments. See "include/ast/section.h".
+Expect<void> CodeSection::loadSegments(
+    std::vector<std::unique_ptr<CodeSegment>> Segs,
+    std::vector<SharedBytes> Bodies) {
+  const size_t Count = Segs.size();
+  const size_t Offset = Content.size();
+  Content.reserve(Offset + Count);
+  for (auto &Seg : Segs) {
+    Content.push_back(std::move(Seg));
+  }
+
+  /// Lazy loading: keep the bodies to be decoded on demand.
+  if (IsLazy) {
+    for (size_t I = 0; I < Count; ++I) {
+      Content[Offset + I]->deferBody(std::move(Bodies[I]));
+    }
+    return {};
+  }
+
+  /// Parse the bodies, on the thread pool if they are large enough to pay for
+  /// it. Report the error of the first failing segment, and skip the segments
+  /// after a known failure.
+  size_t TotalSize = 0;
+  for (auto &Body : Bodies) {
+    TotalSize += Body.size();
+  }
+  std::vector<ErrCode> Errors(Count, ErrCode::Success);
+  std::atomic<size_t> FirstFailure = Count;
+  const auto LoadBody = [&](size_t I) {
+    if (I > FirstFailure.load(std::memory_order_relaxed)) {
+      return;
+    }
+    if (auto Res = Content[Offset + I]->loadBody(std::move(Bodies[I])); !Res) {
+      Errors[I] = Res.error();
+      size_t Expected = FirstFailure.load(std::memory_order_relaxed);
+      while (I < Expected && !FirstFailure.compare_exchange_weak(
+                                 Expected, I, std::memory_order_relaxed)) {
+      }
+    }
+  };
+  if (TotalSize >= kParallelLoadSize) {
+    ThreadPool::getDefault().parallelFor(Count, LoadBody);
+  } else {
+    for (size_t I = 0; I < Count && FirstFailure == Count; ++I) {
+      LoadBody(I);
+    }
+  }
+  if (FirstFailure < Count) {
+    return Unexpect(Errors[FirstFailure]);
+  }
+  return {};
 }
 
 /// Load vector of data section. See "include/ast/section.h".
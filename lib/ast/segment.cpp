@@ -23,20 +23,57 @@ Expect<void> GlobalSegment::loadBinary(FileMgr &Mgr) {
 
 /// Load binary of ElementSegment node. See "include/common/ast/segment.h".
 Expect<void> ElementSegment::loadBinary(FileMgr &Mgr) {
-  /// Read the table index.
+  /// Read the segment flags. Bit 0 is set in passive and declarative cases,
+  /// bit 1 is the explicit table index in active case or declarative, and
+  /// bit 2 is set when the elements are expressions.
+  uint32_t Flags = 0;
   if (auto Res = Mgr.readU32()) {
-    TableIdx = *Res;
+    Flags = *Res;
   } else {
     return Unexpect(Res);
   }
+  if (Flags > 0x07U) {
+    return Unexpect(ErrCode::InvalidGrammar);
+  }
+
+  if (Flags & 0x01U) {
+    /// Passive or declarative segment has empty offset expression.
+    Mode = (Flags & 0x02U) ? SegmentMode::Declarative : SegmentMode::Passive;
+    Expr = std::make_unique<Expression>();
+  } else {
+    /// Read the table index.
+    if (Flags & 0x02U) {
+      if (auto Res = Mgr.readU32()) {
+        TableIdx = *Res;
+      } else {
+        return Unexpect(Res);
+      }
+    }
+
+    /// Read the expression.
+    if (auto Res = Segment::loadExpression(Mgr); !Res) {
+      return Unexpect(Res);
+    }
+  }
 
-  /// Read the expression.
-  auto Expr = Segment::loadExpression(Mgr);
-  if (!Expr) {
-    return Unexpect(Expr);
+  /// Read the element kind, which should be funcref, or the reference type
+  /// of element expressions.
+  if (Flags & 0x03U) {
+    if (auto Res = Mgr.readByte()) {
+      if (Flags & 0x04U) {
+        RefType = static_cast<ElemType>(*Res);
+        if (RefType != ElemType::FuncRef && RefType != ElemType::ExternRef) {
+          return Unexpect(ErrCode::InvalidGrammar);
+        }
+      } else if (*Res != 0x00U) {
+        return Unexpect(ErrCode::InvalidGrammar);
+      }
+    } else {
+      return Unexpect(Res);
+    }
   }
 
-  /// Read the function indices.
+  /// Read the function indices or the element expressions.
   uint32_t VecCnt = 0;
   if (auto Res = Mgr.readU32()) {
     VecCnt = *Res;
@@ -44,7 +81,13 @@ Expect<void> ElementSegment::loadBinary(FileMgr &Mgr) {
     return Unexpect(Res);
   }
   for (uint32_t i = 0; i < VecCnt; ++i) {
-    if (auto Res = Mgr.readU32()) {
+    if (Flags & 0x04U) {
+      auto InitExpr = std::make_unique<Expression>();
+      if (auto Res = InitExpr->loadBinary(Mgr); !Res) {
+        return Unexpect(Res);
+      }
+      InitExprs.push_back(std::move(InitExpr));
+    } else if (auto Res = Mgr.readU32()) {
       FuncIdxes.push_back(*Res);
     } else {
       return Unexpect(Res);
@@ -56,12 +99,30 @@ Expect<void> ElementSegment::loadBinary(FileMgr &Mgr) {
 
 /// Load binary of CodeSegment node. See "include/common/ast/segment.h".
 Expect<void> CodeSegment::loadBinary(FileMgr &Mgr) {
+  if (auto Res = loadSize(Mgr)) {
+    return loadBody(std::move(*Res));
+  } else {
+    return Unexpect(Res);
+  }
+}
+
+/// Load size and raw bytes of CodeSegment. See "include/common/ast/segment.h".
+Expect<SharedBytes> CodeSegment::loadSize(FileMgr &Mgr) {
   /// Read the code segment size.
   if (auto Res = Mgr.readU32()) {
     SegSize = *Res;
   } else {
     return Unexpect(Res);
   }
+  return Mgr.readSharedBytes(SegSize);
+}
+
+/// Load body of CodeSegment node. See "include/common/ast/segment.h".
+Expect<void> CodeSegment::loadBody(SharedBytes Body) {
+  FileMgrVector Mgr;
+  if (auto Res = Mgr.setCode(std::move(Body)); !Res) {
+    return Unexpect(Res);
+  }
 
   /// Read the vector of local variable counts and types.
   uint32_t VecCnt = 0;
@@ -86,23 +147,51 @@ Expect<void> CodeSegment::loadBinary(FileMgr &Mgr) {
     Locals.push_back(std::make_pair(LocalCnt, LocalType));
   }
 
-  /// Read function body.
-  return Segment::loadExpression(Mgr);
+  /// Read function body, which should end at the end of segment.
+  if (auto Res = Segment::loadExpression(Mgr); !Res) {
+    return Unexpect(Res);
+  }
+  if (Mgr.getRemainSize() != 0) {
+    return Unexpect(ErrCode::InvalidGrammar);
+  }
+  IsLoaded = true;
+  Deferred = SharedBytes();
+  return {};
 }
 
 /// Load binary of DataSegment node. See "include/common/ast/segment.h".
 Expect<void> DataSegment::loadBinary(FileMgr &Mgr) {
-  /// Read target memory index.
+  /// Read the segment flags. 0x01 is passive segment, and 0x02 is active
+  /// segment with explicit memory index.
+  uint32_t Flags = 0;
   if (auto Res = Mgr.readU32()) {
-    MemoryIdx = *Res;
+    Flags = *Res;
   } else {
     return Unexpect(Res);
   }
+  switch (Flags) {
+  case 0x00U:
+    break;
+  case 0x01U:
+    Mode = SegmentMode::Passive;
+    break;
+  case 0x02U:
+    /// Read target memory index.
+    if (auto Res = Mgr.readU32()) {
+      MemoryIdx = *Res;
+    } else {
+      return Unexpect(Res);
+    }
+    break;
+  default:
+    return Unexpect(ErrCode::InvalidGrammar);
+  }
 
-  /// Read the offset expression.
-  auto Expr = Segment::loadExpression(Mgr);
-  if (!Expr) {
-    return Unexpect(Expr);
+  /// Read the offset expression of active segment.
+  if (Mode == SegmentMode::Passive) {
+    Expr = std::make_unique<Expression>();
+  } else if (auto Res = Segment::loadExpression(Mgr); !Res) {
+    return Unexpect(Res);
   }
 
   /// Read initialization data.
@@ -112,8 +201,8 @@ Expect<void> DataSegment::loadBinary(FileMgr &Mgr) {
   } else {
     return Unexpect(Res);
   }
-  if (auto Res = Mgr.readBytes(VecCnt)) {
-    Data = *Res;
+  if (auto Res = Mgr.readSharedBytes(VecCnt)) {
+    Data = std::move(*Res);
   } else {
     return Unexpect(Res);
   }
@@ -13,7 +13,12 @@ Expect<void> Limit::loadBinary(FileMgr &Mgr) {
   } else {
     return Unexpect(Res);
   }
-  if (Type != LimitType::HasMin && Type != LimitType::HasMinMax) {
+  switch (Type) {
+  case LimitType::HasMin:
+  case LimitType::HasMinMax:
+  case LimitType::Shared:
+    break;
+  default:
     return Unexpect(ErrCode::InvalidGrammar);
   }
 
@@ -23,7 +28,7 @@ Expect<void> Limit::loadBinary(FileMgr &Mgr) {
   } else {
     return Unexpect(Res);
   }
-  if (Type == LimitType::HasMinMax) {
+  if (hasMax()) {
     if (auto Res = Mgr.readU32()) {
       Max = *Res;
     } else {
@@ -60,6 +65,9 @@ Expect<void> FunctionType::loadBinary(FileMgr &Mgr) {
       case ValType::I64:
       case ValType::F32:
       case ValType::F64:
+      case ValType::V128:
+      case ValType::FuncRef:
+      case ValType::ExternRef:
         break;
       default:
         return Unexpect(ErrCode::InvalidGrammar);
@@ -84,6 +92,9 @@ Expect<void> FunctionType::loadBinary(FileMgr &Mgr) {
       case ValType::I64:
       case ValType::F32:
       case ValType::F64:
+      case ValType::V128:
+      case ValType::FuncRef:
+      case ValType::ExternRef:
         break;
       default:
         return Unexpect(ErrCode::InvalidGrammar);
@@ -111,7 +122,7 @@ Expect<void> TableType::loadBinary(FileMgr &Mgr) {
   } else {
     return Unexpect(Res);
   }
-  if (Type != ElemType::FuncRef) {
+  if (Type != ElemType::FuncRef && Type != ElemType::ExternRef) {
     return Unexpect(ErrCode::InvalidGrammar);
   }
 
@@ -142,6 +153,9 @@ Expect<void> GlobalType::loadBinary(FileMgr &Mgr) {
   case ValType::I64:
   case ValType::F32:
   case ValType::F64:
+  case ValType::V128:
+  case ValType::FuncRef:
+  case ValType::ExternRef:
     break;
   default:
     return Unexpect(ErrCode::InvalidGrammar);
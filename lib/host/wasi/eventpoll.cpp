@@ -0,0 +1,147 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "host/wasi/eventpoll.h"
+
+#include <cerrno>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+namespace {
+static inline constexpr const int kMaxEvents = 64;
+} // namespace
+
+namespace SSVM {
+namespace Host {
+
+EventPoll::EventPoll() noexcept {
+  EPollFd = epoll_create1(EPOLL_CLOEXEC);
+  if (EPollFd < 0) {
+    return;
+  }
+  TimerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  if (TimerFd < 0) {
+    return;
+  }
+  epoll_event Event{};
+  Event.events = EPOLLIN;
+  Event.data.fd = TimerFd;
+  if (epoll_ctl(EPollFd, EPOLL_CTL_ADD, TimerFd, &Event) != 0) {
+    close(TimerFd);
+    TimerFd = -1;
+  }
+}
+
+EventPoll::~EventPoll() noexcept {
+  if (TimerFd >= 0) {
+    close(TimerFd);
+  }
+  if (EPollFd >= 0) {
+    close(EPollFd);
+  }
+}
+
+bool EventPoll::watch(int Fd, uint32_t Events) noexcept {
+  std::unique_lock Lock(InterestMutex);
+  if (static_cast<size_t>(Fd) >= Interests.size()) {
+    Interests.resize(Fd + 1);
+    Wanted.resize(Fd + 1);
+    WantedGeneration.resize(Fd + 1);
+  }
+  /// Both reading and writing may be polled on one descriptor.
+  if (WantedGeneration[Fd] == Generation) {
+    Events |= Wanted[Fd];
+  }
+  Wanted[Fd] = Events;
+  WantedGeneration[Fd] = Generation;
+  if (Interests[Fd] == Events) {
+    return true;
+  }
+
+  epoll_event Event{};
+  Event.events = Events;
+  Event.data.fd = Fd;
+  int Op = Interests[Fd] == 0 ? EPOLL_CTL_ADD : EPOLL_CTL_MOD;
+  int Res = epoll_ctl(EPollFd, Op, Fd, &Event);
+  /// The descriptor may have been closed and reopened behind our back.
+  if (Res != 0 && Op == EPOLL_CTL_ADD && errno == EEXIST) {
+    Res = epoll_ctl(EPollFd, EPOLL_CTL_MOD, Fd, &Event);
+  } else if (Res != 0 && Op == EPOLL_CTL_MOD && errno == ENOENT) {
+    Res = epoll_ctl(EPollFd, EPOLL_CTL_ADD, Fd, &Event);
+  }
+  if (Res != 0) {
+    Interests[Fd] = 0;
+    return false;
+  }
+  Interests[Fd] = Events;
+  return true;
+}
+
+void EventPoll::forget(int Fd) noexcept {
+  std::unique_lock Lock(InterestMutex);
+  if (static_cast<size_t>(Fd) < Interests.size() && Interests[Fd] != 0) {
+    epoll_ctl(EPollFd, EPOLL_CTL_DEL, Fd, nullptr);
+    Interests[Fd] = 0;
+  }
+}
+
+bool EventPoll::wait(int64_t Deadline, int64_t Now,
+                     std::vector<epoll_event> &Events) noexcept {
+  Events.clear();
+  /// An expired deadline only checks the descriptors without blocking.
+  const bool Expired = Deadline >= 0 && Deadline <= Now;
+  if (!Expired && Deadline != ArmedDeadline && !armTimer(Deadline)) {
+    return false;
+  }
+
+  epoll_event Buffer[kMaxEvents];
+  while (true) {
+    const int Count = epoll_wait(EPollFd, Buffer, kMaxEvents, Expired ? 0 : -1);
+    if (Count < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    bool TimedOut = Expired;
+    std::unique_lock Lock(InterestMutex);
+    for (int I = 0; I < Count; ++I) {
+      const int Fd = Buffer[I].data.fd;
+      if (Fd == TimerFd) {
+        uint64_t Expirations;
+        while (read(TimerFd, &Expirations, sizeof(Expirations)) > 0) {
+        }
+        ArmedDeadline = -1;
+        TimedOut = true;
+        continue;
+      }
+      /// Quiet the descriptors which are left from the former polls.
+      if (static_cast<size_t>(Fd) >= WantedGeneration.size() ||
+          WantedGeneration[Fd] != Generation) {
+        epoll_ctl(EPollFd, EPOLL_CTL_DEL, Fd, nullptr);
+        if (static_cast<size_t>(Fd) < Interests.size()) {
+          Interests[Fd] = 0;
+        }
+        continue;
+      }
+      Events.push_back(Buffer[I]);
+    }
+    if (!Events.empty() || TimedOut) {
+      return true;
+    }
+  }
+}
+
+bool EventPoll::armTimer(int64_t Deadline) noexcept {
+  itimerspec Spec{};
+  if (Deadline >= 0) {
+    Spec.it_value.tv_sec = Deadline / 1000000000;
+    Spec.it_value.tv_nsec = Deadline % 1000000000;
+  }
+  if (timerfd_settime(TimerFd, TFD_TIMER_ABSTIME, &Spec, nullptr) != 0) {
+    return false;
+  }
+  ArmedDeadline = Deadline;
+  return true;
+}
+
+} // namespace Host
+} // namespace SSVM
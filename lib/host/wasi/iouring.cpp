@@ -0,0 +1,300 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "host/wasi/iouring.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+/// The kernel limits a registered buffer to 1 GiB, so a larger linear memory
+/// is registered in several chunks.
+static inline constexpr const size_t kChunkShift = 30;
+static inline constexpr const size_t kChunkSize = size_t(1) << kChunkShift;
+static inline constexpr const uint32_t kMaxChunks = 4;
+/// Maximum count of the linked operations in one batch.
+static inline constexpr const uint32_t kMaxBatch = 64;
+
+inline int ioUringSetup(uint32_t Entries, io_uring_params *Params) noexcept {
+  return static_cast<int>(syscall(__NR_io_uring_setup, Entries, Params));
+}
+
+inline int ioUringEnter(int Fd, uint32_t ToSubmit, uint32_t MinComplete,
+                        uint32_t Flags) noexcept {
+  return static_cast<int>(syscall(__NR_io_uring_enter, Fd, ToSubmit,
+                                  MinComplete, Flags, nullptr, 0));
+}
+
+inline int ioUringRegister(int Fd, uint32_t Opcode, const void *Arg,
+                           uint32_t NrArgs) noexcept {
+  return static_cast<int>(
+      syscall(__NR_io_uring_register, Fd, Opcode, Arg, NrArgs));
+}
+
+template <typename T> inline T *ringField(void *Ring, uint32_t Offset) {
+  return reinterpret_cast<T *>(static_cast<uint8_t *>(Ring) + Offset);
+}
+
+} // namespace
+
+namespace SSVM {
+namespace Host {
+
+IOUring::IOUring(uint32_t RequestedEntries) noexcept {
+  io_uring_params Params;
+  std::memset(&Params, 0, sizeof(Params));
+  const int Fd = ioUringSetup(RequestedEntries, &Params);
+  if (Fd < 0) {
+    return;
+  }
+  /// Offsets of -1 meaning the file position need the kernel 5.6 feature.
+  if (!(Params.features & IORING_FEAT_RW_CUR_POS)) {
+    close(Fd);
+    return;
+  }
+
+  SQRingSize = Params.sq_off.array + Params.sq_entries * sizeof(uint32_t);
+  CQRingSize = Params.cq_off.cqes + Params.cq_entries * sizeof(io_uring_cqe);
+  const bool SingleMmap = Params.features & IORING_FEAT_SINGLE_MMAP;
+  if (SingleMmap) {
+    SQRingSize = CQRingSize = std::max(SQRingSize, CQRingSize);
+  }
+  SQRing = mmap(nullptr, SQRingSize, PROT_READ | PROT_WRITE,
+                MAP_SHARED | MAP_POPULATE, Fd, IORING_OFF_SQ_RING);
+  if (SQRing == MAP_FAILED) {
+    SQRing = nullptr;
+    close(Fd);
+    return;
+  }
+  if (SingleMmap) {
+    CQRing = SQRing;
+  } else {
+    CQRing = mmap(nullptr, CQRingSize, PROT_READ | PROT_WRITE,
+                  MAP_SHARED | MAP_POPULATE, Fd, IORING_OFF_CQ_RING);
+    if (CQRing == MAP_FAILED) {
+      CQRing = nullptr;
+      munmap(SQRing, SQRingSize);
+      SQRing = nullptr;
+      close(Fd);
+      return;
+    }
+  }
+  SQEsSize = Params.sq_entries * sizeof(io_uring_sqe);
+  void *const SQEsMap = mmap(nullptr, SQEsSize, PROT_READ | PROT_WRITE,
+                             MAP_SHARED | MAP_POPULATE, Fd, IORING_OFF_SQES);
+  if (SQEsMap == MAP_FAILED) {
+    if (CQRing != SQRing) {
+      munmap(CQRing, CQRingSize);
+    }
+    munmap(SQRing, SQRingSize);
+    SQRing = CQRing = nullptr;
+    close(Fd);
+    return;
+  }
+  SQEs = static_cast<io_uring_sqe *>(SQEsMap);
+
+  SQHead = ringField<uint32_t>(SQRing, Params.sq_off.head);
+  SQTail = ringField<uint32_t>(SQRing, Params.sq_off.tail);
+  SQMask = *ringField<uint32_t>(SQRing, Params.sq_off.ring_mask);
+  SQArray = ringField<uint32_t>(SQRing, Params.sq_off.array);
+  CQHead = ringField<uint32_t>(CQRing, Params.cq_off.head);
+  CQTail = ringField<uint32_t>(CQRing, Params.cq_off.tail);
+  CQMask = *ringField<uint32_t>(CQRing, Params.cq_off.ring_mask);
+  CQEs = ringField<io_uring_cqe>(CQRing, Params.cq_off.cqes);
+  Entries = Params.sq_entries;
+  RingFd = Fd;
+}
+
+IOUring::~IOUring() noexcept {
+  if (RingFd < 0) {
+    return;
+  }
+  munmap(SQEs, SQEsSize);
+  if (CQRing != SQRing) {
+    munmap(CQRing, CQRingSize);
+  }
+  munmap(SQRing, SQRingSize);
+  close(RingFd);
+}
+
+int64_t IOUring::readv(int Fd, const iovec *IOVS, uint32_t Count,
+                       int64_t Offset, uint8_t *Memory,
+                       size_t MemorySize) noexcept {
+  if (RingFd < 0) {
+    const ssize_t Res = Offset < 0 ? ::readv(Fd, IOVS, Count)
+                                   : ::preadv(Fd, IOVS, Count, Offset);
+    return Res < 0 ? -errno : Res;
+  }
+  return transfer(false, Fd, IOVS, Count, Offset, Memory, MemorySize);
+}
+
+int64_t IOUring::writev(int Fd, const iovec *IOVS, uint32_t Count,
+                        int64_t Offset, uint8_t *Memory,
+                        size_t MemorySize) noexcept {
+  if (RingFd < 0) {
+    const ssize_t Res = Offset < 0 ? ::writev(Fd, IOVS, Count)
+                                   : ::pwritev(Fd, IOVS, Count, Offset);
+    return Res < 0 ? -errno : Res;
+  }
+  return transfer(true, Fd, IOVS, Count, Offset, Memory, MemorySize);
+}
+
+int64_t IOUring::transfer(bool IsWrite, int Fd, const iovec *IOVS,
+                          uint32_t Count, int64_t Offset, uint8_t *Memory,
+                          size_t MemorySize) noexcept {
+  std::unique_lock Lock(Mutex);
+  const uint64_t FileOffset = Offset < 0 ? UINT64_MAX : Offset;
+
+  /// Use the fixed buffers only when every iovec lies in one registered
+  /// chunk, and the whole batch fits in the submission queue.
+  bool UseFixed = Count > 0 && Count <= std::min(Entries, kMaxBatch) &&
+                  registerMemory(Memory, MemorySize);
+  for (uint32_t I = 0; UseFixed && I < Count; ++I) {
+    const uint8_t *const Base = static_cast<uint8_t *>(IOVS[I].iov_base);
+    const size_t Begin = Base - Memory;
+    UseFixed = Base >= Memory && Begin + IOVS[I].iov_len <= MemorySize &&
+               (IOVS[I].iov_len == 0 ||
+                (Begin >> kChunkShift) ==
+                    ((Begin + IOVS[I].iov_len - 1) >> kChunkShift));
+  }
+
+  if (!UseFixed) {
+    io_uring_sqe *const SQE = getSqe();
+    SQE->opcode = IsWrite ? IORING_OP_WRITEV : IORING_OP_READV;
+    SQE->fd = Fd;
+    SQE->off = FileOffset;
+    SQE->addr = reinterpret_cast<uintptr_t>(IOVS);
+    SQE->len = Count;
+    SQE->user_data = 0;
+    int64_t Result;
+    if (const int64_t Err = submitAndWait(1, &Result); Err < 0) {
+      return Err;
+    }
+    return Result;
+  }
+
+  /// Link the operations so that they run in order, and a short transfer
+  /// cancels the rest of the batch like the vectored system calls stop.
+  uint64_t NextOffset = FileOffset;
+  for (uint32_t I = 0; I < Count; ++I) {
+    const uint8_t *const Base = static_cast<uint8_t *>(IOVS[I].iov_base);
+    io_uring_sqe *const SQE = getSqe();
+    SQE->opcode = IsWrite ? IORING_OP_WRITE_FIXED : IORING_OP_READ_FIXED;
+    SQE->flags = I + 1 < Count ? IOSQE_IO_LINK : 0;
+    SQE->fd = Fd;
+    SQE->off = NextOffset;
+    SQE->addr = reinterpret_cast<uintptr_t>(Base);
+    SQE->len = static_cast<uint32_t>(IOVS[I].iov_len);
+    SQE->buf_index = static_cast<uint16_t>((Base - Memory) >> kChunkShift);
+    SQE->user_data = I;
+    if (Offset >= 0) {
+      NextOffset += IOVS[I].iov_len;
+    }
+  }
+  int64_t Results[kMaxBatch];
+  if (const int64_t Err = submitAndWait(Count, Results); Err < 0) {
+    return Err;
+  }
+  int64_t Total = 0;
+  for (uint32_t I = 0; I < Count; ++I) {
+    if (Results[I] < 0) {
+      return I == 0 ? Results[I] : Total;
+    }
+    Total += Results[I];
+    if (static_cast<size_t>(Results[I]) < IOVS[I].iov_len) {
+      break;
+    }
+  }
+  return Total;
+}
+
+bool IOUring::registerMemory(uint8_t *Memory, size_t MemorySize) noexcept {
+  if (!CanRegister || Memory == nullptr || MemorySize == 0) {
+    return false;
+  }
+  if (Memory == RegisteredBase && MemorySize == RegisteredSize) {
+    return true;
+  }
+  if (MemorySize > kChunkSize * kMaxChunks) {
+    return false;
+  }
+  if (RegisteredBase != nullptr) {
+    ioUringRegister(RingFd, IORING_UNREGISTER_BUFFERS, nullptr, 0);
+    RegisteredBase = nullptr;
+    RegisteredSize = 0;
+  }
+  iovec Chunks[kMaxChunks];
+  uint32_t ChunkCount = 0;
+  for (size_t Begin = 0; Begin < MemorySize; Begin += kChunkSize) {
+    Chunks[ChunkCount].iov_base = Memory + Begin;
+    Chunks[ChunkCount].iov_len = std::min(kChunkSize, MemorySize - Begin);
+    ++ChunkCount;
+  }
+  if (ioUringRegister(RingFd, IORING_REGISTER_BUFFERS, Chunks, ChunkCount) <
+      0) {
+    /// Pinning fails for good when the memory lock limit is too low.
+    CanRegister = errno != ENOMEM && errno != EPERM;
+    return false;
+  }
+  RegisteredBase = Memory;
+  RegisteredSize = MemorySize;
+  return true;
+}
+
+io_uring_sqe *IOUring::getSqe() noexcept {
+  const uint32_t Tail = *SQTail;
+  const uint32_t Index = Tail & SQMask;
+  io_uring_sqe *const SQE = &SQEs[Index];
+  std::memset(SQE, 0, sizeof(io_uring_sqe));
+  SQArray[Index] = Index;
+  __atomic_store_n(SQTail, Tail + 1, __ATOMIC_RELEASE);
+  return SQE;
+}
+
+int64_t IOUring::submitAndWait(uint32_t Count, int64_t *Results) noexcept {
+  /// Submit the batch with one system call, and reap the completions from
+  /// the ring directly.
+  uint32_t Submitted = 0;
+  while (Submitted < Count) {
+    const int Res = ioUringEnter(RingFd, Count - Submitted, Count - Submitted,
+                                 IORING_ENTER_GETEVENTS);
+    if (Res < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (Submitted == 0) {
+        /// Drop the entries which the kernel did not take.
+        __atomic_store_n(SQTail, *SQTail - Count, __ATOMIC_RELEASE);
+        return -errno;
+      }
+      __atomic_store_n(SQTail, *SQTail - (Count - Submitted),
+                       __ATOMIC_RELEASE);
+      break;
+    }
+    Submitted += Res;
+  }
+  std::fill(Results, Results + Count, -ECANCELED);
+
+  uint32_t Reaped = 0;
+  while (Reaped < Submitted) {
+    const uint32_t Head = *CQHead;
+    if (Head == __atomic_load_n(CQTail, __ATOMIC_ACQUIRE)) {
+      ioUringEnter(RingFd, 0, 1, IORING_ENTER_GETEVENTS);
+      continue;
+    }
+    const io_uring_cqe &CQE = CQEs[Head & CQMask];
+    if (CQE.user_data < Count) {
+      Results[CQE.user_data] = CQE.res;
+    }
+    __atomic_store_n(CQHead, Head + 1, __ATOMIC_RELEASE);
+    ++Reaped;
+  }
+  return 0;
+}
+
+} // namespace Host
+} // namespace SSVM
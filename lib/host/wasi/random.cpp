@@ -0,0 +1,190 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "host/wasi/random.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <pthread.h>
+#include <sys/random.h>
+#include <unistd.h>
+
+namespace {
+
+static inline constexpr const size_t kBlockSize = 64;
+
+/// Bumped in the child process after fork, to reseed the inherited states.
+std::atomic<uint64_t> ForkCounter{0};
+std::once_flag ForkHandlerFlag;
+
+inline constexpr uint32_t rotl(uint32_t X, int N) noexcept {
+  return (X << N) | (X >> (32 - N));
+}
+
+inline void quarterRound(uint32_t &A, uint32_t &B, uint32_t &C,
+                         uint32_t &D) noexcept {
+  A += B;
+  D = rotl(D ^ A, 16);
+  C += D;
+  B = rotl(B ^ C, 12);
+  A += B;
+  D = rotl(D ^ A, 8);
+  C += D;
+  B = rotl(B ^ C, 7);
+}
+
+inline void store32(uint8_t *Out, uint32_t X) noexcept {
+  Out[0] = static_cast<uint8_t>(X);
+  Out[1] = static_cast<uint8_t>(X >> 8);
+  Out[2] = static_cast<uint8_t>(X >> 16);
+  Out[3] = static_cast<uint8_t>(X >> 24);
+}
+
+inline uint32_t load32(const uint8_t *In) noexcept {
+  return static_cast<uint32_t>(In[0]) | static_cast<uint32_t>(In[1]) << 8 |
+         static_cast<uint32_t>(In[2]) << 16 |
+         static_cast<uint32_t>(In[3]) << 24;
+}
+
+/// Read the system entropy.
+bool getEntropy(uint8_t *Buf, size_t Len) noexcept {
+  while (Len > 0) {
+#ifdef __APPLE__
+    const size_t Size = std::min<size_t>(Len, 256);
+    if (getentropy(Buf, Size) != 0) {
+      return false;
+    }
+    const ssize_t Res = Size;
+#else
+    const ssize_t Res = getrandom(Buf, Len, 0);
+    if (Res < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+#endif
+    Buf += Res;
+    Len -= Res;
+  }
+  return true;
+}
+
+} // namespace
+
+namespace SSVM {
+namespace Host {
+
+RandomGenerator::RandomGenerator() noexcept {
+  std::call_once(ForkHandlerFlag, [] {
+    pthread_atfork(nullptr, nullptr,
+                   [] { ForkCounter.fetch_add(1, std::memory_order_relaxed); });
+  });
+}
+
+RandomGenerator::~RandomGenerator() noexcept {
+  std::fill(Key.begin(), Key.end(), 0);
+}
+
+void RandomGenerator::setReseedInterval(uint64_t Bytes) noexcept {
+  std::unique_lock Lock(Mutex);
+  ReseedInterval = Bytes;
+}
+
+uint64_t RandomGenerator::getReseedInterval() noexcept {
+  std::unique_lock Lock(Mutex);
+  return ReseedInterval;
+}
+
+bool RandomGenerator::generate(uint8_t *Buf, size_t Len) noexcept {
+  std::unique_lock Lock(Mutex);
+  if (!Seeded || Generated >= ReseedInterval ||
+      ForkGeneration != ForkCounter.load(std::memory_order_relaxed)) {
+    if (!reseed()) {
+      return false;
+    }
+  }
+
+  Generated += Len;
+  /// Fill the whole blocks directly into the buffer.
+  while (Len >= kBlockSize) {
+    nextBlock(Buf);
+    Buf += kBlockSize;
+    Len -= kBlockSize;
+  }
+  uint8_t Block[kBlockSize];
+  if (Len > 0) {
+    nextBlock(Block);
+    std::copy_n(Block, Len, Buf);
+  }
+  /// Replace the key with the next keystream block, so that the output can
+  /// not be reproduced from the state left behind.
+  nextBlock(Block);
+  for (size_t I = 0; I < 8; ++I) {
+    Key[I] = load32(Block + I * 4);
+  }
+  Counter = 0;
+  std::memset(Block, 0, sizeof(Block));
+  return true;
+}
+
+bool RandomGenerator::reseed() noexcept {
+  uint8_t Seed[32];
+  if (!getEntropy(Seed, sizeof(Seed))) {
+    return false;
+  }
+  for (size_t I = 0; I < 8; ++I) {
+    Key[I] = load32(Seed + I * 4);
+  }
+  std::memset(Seed, 0, sizeof(Seed));
+  Counter = 0;
+  Generated = 0;
+  ForkGeneration = ForkCounter.load(std::memory_order_relaxed);
+  Seeded = true;
+  return true;
+}
+
+void RandomGenerator::nextBlock(uint8_t *Out) noexcept {
+  /// The nonce is always zero, because every key is used only once.
+  block(Key, Counter, 0, Out);
+  ++Counter;
+}
+
+void RandomGenerator::block(const std::array<uint32_t, 8> &BlockKey,
+                            uint64_t BlockCounter, uint64_t Nonce,
+                            uint8_t *Out) noexcept {
+  const std::array<uint32_t, 16> Input = {
+      0x61707865U,
+      0x3320646eU,
+      0x79622d32U,
+      0x6b206574U,
+      BlockKey[0],
+      BlockKey[1],
+      BlockKey[2],
+      BlockKey[3],
+      BlockKey[4],
+      BlockKey[5],
+      BlockKey[6],
+      BlockKey[7],
+      static_cast<uint32_t>(BlockCounter),
+      static_cast<uint32_t>(BlockCounter >> 32),
+      static_cast<uint32_t>(Nonce),
+      static_cast<uint32_t>(Nonce >> 32)};
+  std::array<uint32_t, 16> X = Input;
+  for (int I = 0; I < 10; ++I) {
+    quarterRound(X[0], X[4], X[8], X[12]);
+    quarterRound(X[1], X[5], X[9], X[13]);
+    quarterRound(X[2], X[6], X[10], X[14]);
+    quarterRound(X[3], X[7], X[11], X[15]);
+    quarterRound(X[0], X[5], X[10], X[15]);
+    quarterRound(X[1], X[6], X[11], X[12]);
+    quarterRound(X[2], X[7], X[8], X[13]);
+    quarterRound(X[3], X[4], X[9], X[14]);
+  }
+  for (size_t I = 0; I < 16; ++I) {
+    store32(Out + I * 4, X[I] + Input[I]);
+  }
+}
+
+} // namespace Host
+} // namespace SSVM
@@ -0,0 +1,15 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "host/wasi/ssvmiomodule.h"
+#include "host/wasi/wasifunc.h"
+
+#include <memory>
+
+namespace SSVM {
+namespace Host {
+
+SSVMIOModule::SSVMIOModule(WasiEnvironment &Env) : ImportObject("ssvm_io") {
+  addHostFunc("fd_copy", std::make_unique<WasiFdCopy>(Env));
+}
+
+} // namespace Host
+} // namespace SSVM
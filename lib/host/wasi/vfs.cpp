@@ -0,0 +1,518 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "host/wasi/vfs.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <dirent.h>
+#include <fcntl.h>
+#include <limits>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+using namespace SSVM::Host;
+
+std::atomic<uint64_t> NextIno{1};
+
+__wasi_timestamp_t now() noexcept {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+/// Split the path into its non-empty components.
+std::vector<std::string_view> splitPath(std::string_view Path) {
+  std::vector<std::string_view> Components;
+  while (!Path.empty()) {
+    const size_t Pos = std::min(Path.find('/'), Path.size());
+    if (Pos > 0) {
+      Components.push_back(Path.substr(0, Pos));
+    }
+    Path.remove_prefix(std::min(Pos + 1, Path.size()));
+  }
+  return Components;
+}
+
+/// Walk the components from the directory. The stack keeps the visited
+/// directories for "..", and its bottom is the directory to stay in.
+__wasi_errno_t walk(std::vector<std::shared_ptr<VFSNode>> &Stack,
+                    const std::string_view *Begin,
+                    const std::string_view *End) {
+  for (auto It = Begin; It != End; ++It) {
+    if (*It == ".") {
+      continue;
+    }
+    if (*It == "..") {
+      if (Stack.size() == 1) {
+        return __WASI_ENOTCAPABLE;
+      }
+      Stack.pop_back();
+      continue;
+    }
+    if (Stack.back()->getType() != __WASI_FILETYPE_DIRECTORY) {
+      return __WASI_ENOTDIR;
+    }
+    std::shared_ptr<VFSNode> Next;
+    if (const auto Err = Stack.back()->lookup(*It, Next);
+        Err != __WASI_ESUCCESS) {
+      return Err;
+    }
+    Stack.push_back(std::move(Next));
+  }
+  return __WASI_ESUCCESS;
+}
+
+/// Read the whole host file.
+bool readHostFile(const std::string &Path, std::vector<uint8_t> &Content) {
+  const int Fd = open(Path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (Fd < 0) {
+    return false;
+  }
+  Content.clear();
+  uint8_t Buffer[4096];
+  while (true) {
+    const ssize_t Res = read(Fd, Buffer, sizeof(Buffer));
+    if (Res < 0 && errno == EINTR) {
+      continue;
+    }
+    if (Res <= 0) {
+      close(Fd);
+      return Res == 0;
+    }
+    Content.insert(Content.end(), Buffer, Buffer + Res);
+  }
+}
+
+size_t copyIOVS(const iovec *IOVS, int Count, const uint8_t *Data,
+                size_t Size) noexcept {
+  size_t Copied = 0;
+  for (int I = 0; I < Count && Copied < Size; ++I) {
+    const size_t Len = std::min(IOVS[I].iov_len, Size - Copied);
+    std::copy(Data + Copied, Data + Copied + Len,
+              static_cast<uint8_t *>(IOVS[I].iov_base));
+    Copied += Len;
+  }
+  return Copied;
+}
+
+} // namespace
+
+namespace SSVM {
+namespace Host {
+
+__wasi_errno_t resolvePath(std::shared_ptr<VFSNode> Dir, std::string_view Path,
+                           std::shared_ptr<VFSNode> &Node) {
+  if (!Path.empty() && Path.front() == '/') {
+    return __WASI_ENOTCAPABLE;
+  }
+  const auto Components = splitPath(Path);
+  std::vector<std::shared_ptr<VFSNode>> Stack{std::move(Dir)};
+  if (const auto Err = walk(Stack, Components.data(),
+                            Components.data() + Components.size());
+      Err != __WASI_ESUCCESS) {
+    return Err;
+  }
+  Node = std::move(Stack.back());
+  return __WASI_ESUCCESS;
+}
+
+__wasi_errno_t resolveParent(std::shared_ptr<VFSNode> Dir,
+                             std::string_view Path,
+                             std::shared_ptr<VFSNode> &Parent,
+                             std::string &Name) {
+  if (!Path.empty() && Path.front() == '/') {
+    return __WASI_ENOTCAPABLE;
+  }
+  const auto Components = splitPath(Path);
+  if (Components.empty()) {
+    return __WASI_ENOENT;
+  }
+  if (Components.back() == "." || Components.back() == "..") {
+    return __WASI_EINVAL;
+  }
+  std::vector<std::shared_ptr<VFSNode>> Stack{std::move(Dir)};
+  if (const auto Err = walk(Stack, Components.data(),
+                            Components.data() + Components.size() - 1);
+      Err != __WASI_ESUCCESS) {
+    return Err;
+  }
+  if (Stack.back()->getType() != __WASI_FILETYPE_DIRECTORY) {
+    return __WASI_ENOTDIR;
+  }
+  Parent = std::move(Stack.back());
+  Name = Components.back();
+  return __WASI_ESUCCESS;
+}
+
+MemoryNode::MemoryNode(__wasi_filetype_t T)
+    : Type(T), Ino(NextIno.fetch_add(1, std::memory_order_relaxed)),
+      ATim(now()), MTim(ATim), CTim(ATim) {}
+
+MemoryNode::MemoryNode(std::shared_ptr<const MemoryNode> L)
+    : Type(L->Type), Ino(L->Ino), ATim(L->ATim), MTim(L->MTim),
+      CTim(L->CTim), Content(L->Content), SharedContent(true) {
+  if (Type == __WASI_FILETYPE_DIRECTORY) {
+    Lower = std::move(L);
+  }
+}
+
+void MemoryNode::stat(__wasi_filestat_t &Stat) const noexcept {
+  Stat.st_dev = 0;
+  Stat.st_ino = Ino;
+  Stat.st_filetype = Type;
+  Stat.st_nlink = 1;
+  Stat.st_size = Content ? Content->size() : 0;
+  Stat.st_atim = ATim;
+  Stat.st_mtim = MTim;
+  Stat.st_ctim = CTim;
+}
+
+__wasi_errno_t MemoryNode::read(const iovec *IOVS, int Count, uint64_t Offset,
+                                uint64_t &NRead) noexcept {
+  if (Type == __WASI_FILETYPE_DIRECTORY) {
+    return __WASI_EISDIR;
+  }
+  NRead = 0;
+  if (Content && Offset < Content->size()) {
+    NRead = copyIOVS(IOVS, Count, Content->data() + Offset,
+                     Content->size() - Offset);
+  }
+  return __WASI_ESUCCESS;
+}
+
+__wasi_errno_t MemoryNode::write(const iovec *IOVS, int Count,
+                                 uint64_t Offset,
+                                 uint64_t &NWritten) noexcept {
+  if (Type == __WASI_FILETYPE_DIRECTORY) {
+    return __WASI_EISDIR;
+  }
+  uint64_t Size = 0;
+  for (int I = 0; I < Count; ++I) {
+    Size += IOVS[I].iov_len;
+  }
+  if (Offset > std::numeric_limits<uint32_t>::max() ||
+      Size > std::numeric_limits<uint32_t>::max()) {
+    return __WASI_EFBIG;
+  }
+  try {
+    auto &Data = getMutableContent();
+    if (Offset + Size > Data.size()) {
+      Data.resize(Offset + Size);
+    }
+    uint64_t Pos = Offset;
+    for (int I = 0; I < Count; ++I) {
+      const auto *const Begin = static_cast<const uint8_t *>(IOVS[I].iov_base);
+      std::copy(Begin, Begin + IOVS[I].iov_len, Data.begin() + Pos);
+      Pos += IOVS[I].iov_len;
+    }
+  } catch (const std::bad_alloc &) {
+    return __WASI_ENOSPC;
+  }
+  NWritten = Size;
+  touch();
+  return __WASI_ESUCCESS;
+}
+
+__wasi_errno_t MemoryNode::truncate(uint64_t Size) noexcept {
+  if (Type == __WASI_FILETYPE_DIRECTORY) {
+    return __WASI_EISDIR;
+  }
+  if (Size > std::numeric_limits<uint32_t>::max()) {
+    return __WASI_EFBIG;
+  }
+  try {
+    getMutableContent().resize(Size);
+  } catch (const std::bad_alloc &) {
+    return __WASI_ENOSPC;
+  }
+  touch();
+  return __WASI_ESUCCESS;
+}
+
+__wasi_errno_t MemoryNode::lookup(std::string_view Name,
+                                  std::shared_ptr<VFSNode> &Node) noexcept {
+  if (Type != __WASI_FILETYPE_DIRECTORY) {
+    return __WASI_ENOTDIR;
+  }
+  if (const auto Err = materialize(); Err != __WASI_ESUCCESS) {
+    return Err;
+  }
+  if (auto It = Children.find(Name); It != Children.end()) {
+    Node = It->second;
+    return __WASI_ESUCCESS;
+  }
+  return __WASI_ENOENT;
+}
+
+__wasi_errno_t MemoryNode::create(std::string_view Name, __wasi_filetype_t T,
+                                  std::shared_ptr<VFSNode> &Node) noexcept {
+  if (Type != __WASI_FILETYPE_DIRECTORY) {
+    return __WASI_ENOTDIR;
+  }
+  if (const auto Err = materialize(); Err != __WASI_ESUCCESS) {
+    return Err;
+  }
+  if (Children.find(Name) != Children.end()) {
+    return __WASI_EEXIST;
+  }
+  try {
+    auto Child = std::make_shared<MemoryNode>(T);
+    Children.emplace(std::string(Name), Child);
+    Node = std::move(Child);
+  } catch (const std::bad_alloc &) {
+    return __WASI_ENOMEM;
+  }
+  touch();
+  return __WASI_ESUCCESS;
+}
+
+__wasi_errno_t MemoryNode::remove(std::string_view Name,
+                                  bool Directory) noexcept {
+  if (Type != __WASI_FILETYPE_DIRECTORY) {
+    return __WASI_ENOTDIR;
+  }
+  if (const auto Err = materialize(); Err != __WASI_ESUCCESS) {
+    return Err;
+  }
+  auto It = Children.find(Name);
+  if (It == Children.end()) {
+    return __WASI_ENOENT;
+  }
+  auto &Child = *It->second;
+  if (Directory && Child.Type != __WASI_FILETYPE_DIRECTORY) {
+    return __WASI_ENOTDIR;
+  }
+  if (!Directory && Child.Type == __WASI_FILETYPE_DIRECTORY) {
+    return __WASI_EISDIR;
+  }
+  if (Directory) {
+    if (const auto Err = Child.materialize(); Err != __WASI_ESUCCESS) {
+      return Err;
+    }
+    if (!Child.Children.empty()) {
+      return __WASI_ENOTEMPTY;
+    }
+  }
+  Children.erase(It);
+  touch();
+  return __WASI_ESUCCESS;
+}
+
+__wasi_errno_t MemoryNode::rename(std::string_view Name, VFSNode &NewDir,
+                                  std::string_view NewName) noexcept {
+  auto *const Target = dynamic_cast<MemoryNode *>(&NewDir);
+  if (Target == nullptr) {
+    return __WASI_EXDEV;
+  }
+  if (Type != __WASI_FILETYPE_DIRECTORY ||
+      Target->Type != __WASI_FILETYPE_DIRECTORY) {
+    return __WASI_ENOTDIR;
+  }
+  if (const auto Err = materialize(); Err != __WASI_ESUCCESS) {
+    return Err;
+  }
+  if (const auto Err = Target->materialize(); Err != __WASI_ESUCCESS) {
+    return Err;
+  }
+  auto It = Children.find(Name);
+  if (It == Children.end()) {
+    return __WASI_ENOENT;
+  }
+  /// A directory can not be moved into itself or its subtree.
+  if (It->second->contains(*Target)) {
+    return __WASI_EINVAL;
+  }
+  if (auto Dst = Target->Children.find(NewName);
+      Dst != Target->Children.end()) {
+    if (Dst->second == It->second) {
+      return __WASI_ESUCCESS;
+    }
+    const bool SrcIsDir = It->second->Type == __WASI_FILETYPE_DIRECTORY;
+    auto &Existing = *Dst->second;
+    if (SrcIsDir && Existing.Type != __WASI_FILETYPE_DIRECTORY) {
+      return __WASI_ENOTDIR;
+    }
+    if (!SrcIsDir && Existing.Type == __WASI_FILETYPE_DIRECTORY) {
+      return __WASI_EISDIR;
+    }
+    if (SrcIsDir) {
+      if (const auto Err = Existing.materialize(); Err != __WASI_ESUCCESS) {
+        return Err;
+      }
+      if (!Existing.Children.empty()) {
+        return __WASI_ENOTEMPTY;
+      }
+    }
+  }
+  try {
+    /// Insert first, so that a failure leaves the source entry untouched.
+    auto Node = It->second;
+    Target->Children.insert_or_assign(std::string(NewName), std::move(Node));
+  } catch (const std::bad_alloc &) {
+    return __WASI_ENOMEM;
+  }
+  Children.erase(It);
+  touch();
+  Target->touch();
+  return __WASI_ESUCCESS;
+}
+
+__wasi_errno_t MemoryNode::list(
+    std::vector<std::pair<std::string, std::shared_ptr<VFSNode>>>
+        &Entries) noexcept {
+  if (Type != __WASI_FILETYPE_DIRECTORY) {
+    return __WASI_ENOTDIR;
+  }
+  if (const auto Err = materialize(); Err != __WASI_ESUCCESS) {
+    return Err;
+  }
+  Entries.clear();
+  try {
+    Entries.reserve(Children.size());
+    for (const auto &[Name, Child] : Children) {
+      Entries.emplace_back(Name, Child);
+    }
+  } catch (const std::bad_alloc &) {
+    return __WASI_ENOMEM;
+  }
+  return __WASI_ESUCCESS;
+}
+
+__wasi_errno_t MemoryNode::materialize() noexcept {
+  if (!Lower) {
+    return __WASI_ESUCCESS;
+  }
+  try {
+    /// The entries copied before a failure are kept, and skipped in the
+    /// retry.
+    for (const auto &[Name, Child] : Lower->Children) {
+      if (Children.find(Name) == Children.end()) {
+        Children.emplace(Name, std::make_shared<MemoryNode>(Child));
+      }
+    }
+  } catch (const std::bad_alloc &) {
+    return __WASI_ENOMEM;
+  }
+  Lower.reset();
+  return __WASI_ESUCCESS;
+}
+
+bool MemoryNode::contains(const MemoryNode &Node) const noexcept {
+  if (this == &Node) {
+    return true;
+  }
+  /// Only the materialized entries can be the node, because the others are
+  /// not created yet.
+  for (const auto &[Name, Child] : Children) {
+    if (Child->Type == __WASI_FILETYPE_DIRECTORY && Child->contains(Node)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::vector<uint8_t> &MemoryNode::getMutableContent() {
+  if (!Content) {
+    Content = std::make_shared<std::vector<uint8_t>>();
+  } else if (SharedContent) {
+    Content = std::make_shared<std::vector<uint8_t>>(*Content);
+  }
+  SharedContent = false;
+  return *Content;
+}
+
+void MemoryNode::touch() noexcept { MTim = CTim = now(); }
+
+MemoryImage::MemoryImage()
+    : Root(std::make_shared<MemoryNode>(__WASI_FILETYPE_DIRECTORY)) {}
+
+bool MemoryImage::addDirectory(std::string_view Path) {
+  return getDirectory(Path) != nullptr;
+}
+
+bool MemoryImage::addFile(std::string_view Path,
+                          std::vector<uint8_t> Content) {
+  const size_t Pos = Path.rfind('/');
+  const auto Name =
+      Pos == std::string_view::npos ? Path : Path.substr(Pos + 1);
+  if (Name.empty() || Name == "." || Name == "..") {
+    return false;
+  }
+  auto Dir =
+      getDirectory(Pos == std::string_view::npos ? "" : Path.substr(0, Pos));
+  if (!Dir) {
+    return false;
+  }
+  auto &Child = Dir->Children[std::string(Name)];
+  if (!Child) {
+    Child = std::make_shared<MemoryNode>(__WASI_FILETYPE_REGULAR_FILE);
+  } else if (Child->Type != __WASI_FILETYPE_REGULAR_FILE) {
+    return false;
+  }
+  Child->Content = std::make_shared<std::vector<uint8_t>>(std::move(Content));
+  return true;
+}
+
+bool MemoryImage::addHostDirectory(std::string_view Path,
+                                   const std::string &HostPath) {
+  if (!addDirectory(Path)) {
+    return false;
+  }
+  DIR *Dir = opendir(HostPath.c_str());
+  if (Dir == nullptr) {
+    return false;
+  }
+  bool Success = true;
+  while (Success) {
+    const dirent *Entry = readdir(Dir);
+    if (Entry == nullptr) {
+      break;
+    }
+    const std::string_view Name = Entry->d_name;
+    if (Name == "." || Name == "..") {
+      continue;
+    }
+    const std::string ChildPath = std::string(Path) + '/' + Entry->d_name;
+    const std::string ChildHostPath = HostPath + '/' + Entry->d_name;
+    struct stat Stat;
+    if (lstat(ChildHostPath.c_str(), &Stat) != 0) {
+      Success = false;
+    } else if (S_ISDIR(Stat.st_mode)) {
+      Success = addHostDirectory(ChildPath, ChildHostPath);
+    } else if (S_ISREG(Stat.st_mode)) {
+      std::vector<uint8_t> Content;
+      Success = readHostFile(ChildHostPath, Content) &&
+                addFile(ChildPath, std::move(Content));
+    }
+  }
+  closedir(Dir);
+  return Success;
+}
+
+std::shared_ptr<VFSNode> MemoryImage::mount() const {
+  return std::make_shared<MemoryNode>(
+      std::shared_ptr<const MemoryNode>(Root));
+}
+
+std::shared_ptr<MemoryNode> MemoryImage::getDirectory(std::string_view Path) {
+  auto Dir = Root;
+  for (const auto Component : splitPath(Path)) {
+    if (Component == "." || Component == "..") {
+      return nullptr;
+    }
+    auto &Child = Dir->Children[std::string(Component)];
+    if (!Child) {
+      Child = std::make_shared<MemoryNode>(__WASI_FILETYPE_DIRECTORY);
+    } else if (Child->Type != __WASI_FILETYPE_DIRECTORY) {
+      return nullptr;
+    }
+    Dir = Child;
+  }
+  return Dir;
+}
+
+} // namespace Host
+} // namespace SSVM
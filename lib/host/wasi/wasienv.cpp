@@ -1,6 +1,10 @@
 // SPDX-License-Identifier: Apache-2.0
 #include "host/wasi/wasienv.h"
 
+#include <algorithm>
+#include <cerrno>
+#include <time.h>
+
 extern char **environ;
 
 namespace {
@@ -39,12 +43,13 @@ namespace Host {
 
 WasiEnvironment::WasiEnvironment() {
   using namespace std::string_view_literals;
-  FileArray.emplace_back(STDIN_FILENO, kStdInRights, 0, "/dev/stdin"sv);
-  FileArray.emplace_back(STDOUT_FILENO, kStdOutRights, 0, "/dev/stdout"sv);
-  FileArray.emplace_back(STDERR_FILENO, kStdErrRights, 0, "/dev/stderr"sv);
+  emplaceFile(STDIN_FILENO, kStdInRights, 0, "/dev/stdin"sv);
+  emplaceFile(STDOUT_FILENO, kStdOutRights, 0, "/dev/stdout"sv);
+  emplaceFile(STDERR_FILENO, kStdErrRights, 0, "/dev/stderr"sv);
   /// Open dir for WASI environment.
-  FileArray.emplace_back(open(".", O_RDONLY | O_DIRECTORY), kDirectoryRights,
-                         kInheritingDirectoryRights, "."sv);
+  if (const int Fd = open(".", O_RDONLY | O_DIRECTORY); Fd >= 0) {
+    emplaceFile(Fd, kDirectoryRights, kInheritingDirectoryRights, "."sv);
+  }
 
   for (size_t I = 0; environ[I] != nullptr; ++I) {
     Environs.emplace_back(environ[I]);
@@ -53,12 +58,138 @@ WasiEnvironment::WasiEnvironment() {
 }
 
 WasiEnvironment::~WasiEnvironment() noexcept {
-  for (const auto &File : FileArray) {
-    if (File.Fd != STDIN_FILENO && File.Fd != STDOUT_FILENO &&
-        File.Fd != STDERR_FILENO) {
-      close(File.Fd);
+  flushWriteBuffer();
+  for (const auto &File : FileTable) {
+    if (File && File->Fd != STDIN_FILENO && File->Fd != STDOUT_FILENO &&
+        File->Fd != STDERR_FILENO) {
+      close(File->Fd);
+    }
+  }
+}
+
+int32_t WasiEnvironment::preopenVirtual(std::string_view Path,
+                                        std::shared_ptr<VFSNode> Root) {
+  return openVirtual(std::move(Root), kDirectoryRights,
+                     kInheritingDirectoryRights, Path);
+}
+
+int32_t WasiEnvironment::openVirtual(std::shared_ptr<VFSNode> Node,
+                                     __wasi_rights_t Rights,
+                                     __wasi_rights_t InheritingRights,
+                                     std::string_view Path) {
+  /// Guest file descriptors are host ones, so a virtual file holds a host
+  /// descriptor of /dev/null to reserve its number.
+  const int Fd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+  if (Fd < 0) {
+    return -1;
+  }
+  emplaceFile(Fd, Rights, InheritingRights, Path)->Node = std::move(Node);
+  return Fd;
+}
+
+void WasiEnvironment::setFrozenClock(bool Enable) noexcept {
+  FrozenClock = Enable;
+  freezeClocks();
+}
+
+void WasiEnvironment::freezeClocks() noexcept {
+  if (!FrozenClock) {
+    return;
+  }
+  auto Now = [](clockid_t SysClockId) -> __wasi_timestamp_t {
+    timespec SysTimespec;
+    clock_gettime(SysClockId, &SysTimespec);
+    return static_cast<__wasi_timestamp_t>(SysTimespec.tv_sec) * 1000000000 +
+           SysTimespec.tv_nsec;
+  };
+  FrozenRealtime.store(Now(CLOCK_REALTIME), std::memory_order_relaxed);
+  FrozenMonotonic.store(Now(CLOCK_MONOTONIC), std::memory_order_relaxed);
+}
+
+void WasiEnvironment::setWriteBuffer(WriteBufferMode Mode, size_t Capacity,
+                                     bool IncludeFiles) {
+  std::unique_lock Lock(WriteBufferMutex);
+  flushWriteBufferLocked();
+  BufferMode = Mode;
+  BufferCapacity = Capacity;
+  BufferFiles = IncludeFiles;
+  WriteBuffer.clear();
+  WriteBuffer.shrink_to_fit();
+  if (Mode != WriteBufferMode::None) {
+    WriteBuffer.reserve(Capacity);
+  }
+}
+
+ssize_t WasiEnvironment::bufferWrite(__wasi_fd_t Fd, const iovec *IOVS,
+                                     int Count) noexcept {
+  std::unique_lock Lock(WriteBufferMutex);
+  /// Write out the data of the other file first to keep the order.
+  if (BufferFd.load(std::memory_order_relaxed) != Fd) {
+    if (!flushWriteBufferLocked()) {
+      return -1;
+    }
+  }
+
+  size_t Size = 0;
+  for (int I = 0; I < Count; ++I) {
+    Size += IOVS[I].iov_len;
+  }
+  if (WriteBuffer.size() + Size > BufferCapacity) {
+    if (!flushWriteBufferLocked()) {
+      return -1;
+    }
+    /// Large writes bypass the buffer.
+    if (Size >= BufferCapacity) {
+      return writev(Fd, IOVS, Count);
+    }
+  }
+
+  bool HasNewLine = false;
+  for (int I = 0; I < Count; ++I) {
+    const auto *const Begin = static_cast<const uint8_t *>(IOVS[I].iov_base);
+    const auto *const End = Begin + IOVS[I].iov_len;
+    WriteBuffer.insert(WriteBuffer.end(), Begin, End);
+    HasNewLine = HasNewLine || std::find(Begin, End, '\n') != End;
+  }
+  if (!WriteBuffer.empty()) {
+    BufferFd.store(Fd, std::memory_order_relaxed);
+  }
+  if ((BufferMode == WriteBufferMode::Line && HasNewLine) ||
+      WriteBuffer.size() >= BufferCapacity) {
+    if (!flushWriteBufferLocked()) {
+      return -1;
+    }
+  }
+  return static_cast<ssize_t>(Size);
+}
+
+bool WasiEnvironment::flushWriteBuffer() noexcept {
+  std::unique_lock Lock(WriteBufferMutex);
+  return flushWriteBufferLocked();
+}
+
+bool WasiEnvironment::flushWriteBufferLocked() noexcept {
+  const int64_t Fd = BufferFd.load(std::memory_order_relaxed);
+  if (Fd < 0) {
+    return true;
+  }
+  BufferFd.store(-1, std::memory_order_relaxed);
+  size_t Written = 0;
+  while (Written < WriteBuffer.size()) {
+    const ssize_t Res = write(Fd, WriteBuffer.data() + Written,
+                              WriteBuffer.size() - Written);
+    if (Res < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      /// The pending data is dropped, as a failed write of stdio does.
+      WriteBuffer.clear();
+      return false;
     }
+    Written += Res;
   }
+  WriteBuffer.clear();
+  return true;
 }
 
 } // namespace Host
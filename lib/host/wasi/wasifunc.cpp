@@ -8,7 +8,7 @@
 #include <fcntl.h>
 #include <limits>
 #include <numeric>
-#include <random>
+#include <optional>
 #include <string_view>
 #include <sys/ioctl.h>
 #include <sys/socket.h>
@@ -21,7 +21,7 @@
 
 #ifndef __APPLE__
 #include <sys/epoll.h>
-#include <sys/signalfd.h>
+#include <sys/sendfile.h>
 #endif
 
 namespace {
@@ -328,6 +328,177 @@ constexpr const int32_t kIOVSMax = IOV_MAX;
 constexpr const int32_t kIOVSMax = 1024;
 #endif
 
+/// Vectored read at the offset, or at the file position when the offset is
+/// negative. Returns -1 and sets errno when failed, like the system calls.
+ssize_t readIOVS([[maybe_unused]] SSVM::Host::WasiEnvironment &Env,
+                 [[maybe_unused]] SSVM::Runtime::Instance::MemoryInstance &Mem,
+                 int Fd, const iovec *IOVS, int Count, int64_t Offset) {
+#ifdef SSVM_WASI_IO_URING
+  const int64_t Res = Env.getIOUring().readv(
+      Fd, IOVS, Count, Offset, Mem.getPointer<uint8_t *>(0),
+      Mem.getDataPageSize() * Mem.kPageSize);
+  if (Res < 0) {
+    errno = static_cast<int>(-Res);
+    return -1;
+  }
+  return Res;
+#else
+  return Offset < 0 ? readv(Fd, IOVS, Count) : preadv(Fd, IOVS, Count, Offset);
+#endif
+}
+
+/// Vectored write at the offset, or at the file position when the offset is
+/// negative. Returns -1 and sets errno when failed, like the system calls.
+ssize_t writeIOVS([[maybe_unused]] SSVM::Host::WasiEnvironment &Env,
+                  [[maybe_unused]] SSVM::Runtime::Instance::MemoryInstance &Mem,
+                  int Fd, const iovec *IOVS, int Count, int64_t Offset) {
+#ifdef SSVM_WASI_IO_URING
+  const int64_t Res = Env.getIOUring().writev(
+      Fd, IOVS, Count, Offset, Mem.getPointer<uint8_t *>(0),
+      Mem.getDataPageSize() * Mem.kPageSize);
+  if (Res < 0) {
+    errno = static_cast<int>(-Res);
+    return -1;
+  }
+  return Res;
+#else
+  return Offset < 0 ? writev(Fd, IOVS, Count)
+                    : pwritev(Fd, IOVS, Count, Offset);
+#endif
+}
+
+/// Ways of fd_copy to move the data between two files.
+enum class CopyMethod : uint8_t {
+  /// In-kernel copy between two regular files, which may share the extents.
+  CopyFileRange,
+  /// Move the pages from or to a pipe.
+  Splice,
+  /// Copy from a regular file to any file.
+  SendFile,
+  /// Read and write through a host buffer.
+  Buffer
+};
+
+/// Choose the fastest way to copy between two host files.
+CopyMethod selectCopyMethod(int Src, int Dst) noexcept {
+#ifndef __APPLE__
+  struct stat SrcStat, DstStat;
+  if (fstat(Src, &SrcStat) != 0 || fstat(Dst, &DstStat) != 0) {
+    return CopyMethod::Buffer;
+  }
+  if (S_ISFIFO(SrcStat.st_mode) || S_ISFIFO(DstStat.st_mode)) {
+    return CopyMethod::Splice;
+  }
+  if (S_ISREG(SrcStat.st_mode)) {
+    return S_ISREG(DstStat.st_mode) ? CopyMethod::CopyFileRange
+                                    : CopyMethod::SendFile;
+  }
+#endif
+  return CopyMethod::Buffer;
+}
+
+/// Copy a chunk between two host files in the kernel. Returns -1 and sets
+/// errno when failed, like the system calls.
+ssize_t copyInKernel(CopyMethod Method, int Src, int Dst, size_t Len) noexcept {
+  switch (Method) {
+#ifndef __APPLE__
+  case CopyMethod::CopyFileRange:
+    return copy_file_range(Src, nullptr, Dst, nullptr, Len, 0);
+  case CopyMethod::Splice:
+    return splice(Src, nullptr, Dst, nullptr, Len, SPLICE_F_MOVE);
+  case CopyMethod::SendFile:
+    return sendfile(Dst, Src, nullptr, Len);
+#endif
+  default:
+    errno = ENOSYS;
+    return -1;
+  }
+}
+
+/// Read from the current position of a host or virtual file.
+__wasi_errno_t readFile(SSVM::Host::WasiEnvironment::File &Entry,
+                        uint8_t *Buf, size_t Len, uint64_t &NRead) noexcept {
+  if (Entry.isVirtual()) {
+    const iovec SysIOV = {Buf, Len};
+    if (const auto Error = Entry.Node->read(&SysIOV, 1, Entry.Offset, NRead);
+        Error != __WASI_ESUCCESS) {
+      return Error;
+    }
+    Entry.Offset += NRead;
+    return __WASI_ESUCCESS;
+  }
+  const ssize_t Res = read(Entry.Fd, Buf, Len);
+  if (Res < 0) {
+    return convertErrNo(errno);
+  }
+  NRead = Res;
+  return __WASI_ESUCCESS;
+}
+
+/// Write at the current position of a host or virtual file.
+__wasi_errno_t writeFile(SSVM::Host::WasiEnvironment::File &Entry,
+                         uint8_t *Buf, size_t Len,
+                         uint64_t &NWritten) noexcept {
+  if (Entry.isVirtual()) {
+    if (Entry.Append) {
+      __wasi_filestat_t Stat;
+      Entry.Node->stat(Stat);
+      Entry.Offset = Stat.st_size;
+    }
+    const iovec SysIOV = {Buf, Len};
+    if (const auto Error =
+            Entry.Node->write(&SysIOV, 1, Entry.Offset, NWritten);
+        Error != __WASI_ESUCCESS) {
+      return Error;
+    }
+    Entry.Offset += NWritten;
+    return __WASI_ESUCCESS;
+  }
+  const ssize_t Res = write(Entry.Fd, Buf, Len);
+  if (Res < 0) {
+    return convertErrNo(errno);
+  }
+  NWritten = Res;
+  return __WASI_ESUCCESS;
+}
+
+/// Move the current position of a host or virtual file back by Len, to give
+/// back the data read but not consumed. Unseekable files keep the position.
+void unreadFile(SSVM::Host::WasiEnvironment::File &Entry,
+                uint64_t Len) noexcept {
+  if (Entry.isVirtual()) {
+    Entry.Offset -= Len;
+    return;
+  }
+  lseek(Entry.Fd, -static_cast<off_t>(Len), SEEK_CUR);
+}
+
+/// Get the coarse version of the clock if its resolution satisfies the
+/// precision, or the clock itself otherwise.
+static clockid_t coarseClock(clockid_t SysClockId,
+                             __wasi_timestamp_t Precision) noexcept {
+#if defined(CLOCK_REALTIME_COARSE) && defined(CLOCK_MONOTONIC_COARSE)
+  auto Resolution = [](clockid_t CoarseClockId) -> __wasi_timestamp_t {
+    timespec SysTimespec;
+    if (clock_getres(CoarseClockId, &SysTimespec) != 0) {
+      return std::numeric_limits<__wasi_timestamp_t>::max();
+    }
+    return timespec2Timestamp(SysTimespec);
+  };
+  static const __wasi_timestamp_t RealtimeCoarse =
+      Resolution(CLOCK_REALTIME_COARSE);
+  static const __wasi_timestamp_t MonotonicCoarse =
+      Resolution(CLOCK_MONOTONIC_COARSE);
+  if (SysClockId == CLOCK_REALTIME && Precision >= RealtimeCoarse) {
+    return CLOCK_REALTIME_COARSE;
+  }
+  if (SysClockId == CLOCK_MONOTONIC && Precision >= MonotonicCoarse) {
+    return CLOCK_MONOTONIC_COARSE;
+  }
+#endif
+  return SysClockId;
+}
+
 } // namespace
 
 namespace SSVM {
@@ -513,7 +684,17 @@ WasiClockTimeGet::body(Runtime::Instance::MemoryInstance &MemInst,
     return __WASI_EFAULT;
   }
 
-  timespec SysTimespec = timestamp2Timespec(Precision);
+  if (Env.getFrozenTime(ClockId, *Time)) {
+    return __WASI_ESUCCESS;
+  }
+
+  /// The coarse clocks are read from the vDSO page without the hardware
+  /// counter. Use them when the requested precision allows.
+  if (Precision > 0) {
+    SysClockId = coarseClock(SysClockId, Precision);
+  }
+
+  timespec SysTimespec;
   if (unlikely(clock_gettime(SysClockId, &SysTimespec) != 0)) {
     return convertErrNo(errno);
   }
@@ -550,7 +731,7 @@ Expect<uint32_t> WasiFdAdvise::body(Runtime::Instance::MemoryInstance &MemInst,
   }
 
   const auto Entry = Env.getFile(Fd);
-  if (unlikely(Entry == Env.getFileEnd())) {
+  if (unlikely(Entry == nullptr)) {
     return __WASI_EBADF;
   }
 
@@ -558,6 +739,10 @@ Expect<uint32_t> WasiFdAdvise::body(Runtime::Instance::MemoryInstance &MemInst,
     return __WASI_ENOTCAPABLE;
   }
 
+  if (Entry->isVirtual()) {
+    return __WASI_ESUCCESS;
+  }
+
   if (unlikely(posix_fadvise(Fd, Offset, Len, SysAdvise) != 0)) {
     return convertErrNo(errno);
   }
@@ -569,7 +754,7 @@ Expect<uint32_t>
 WasiFdAllocate::body(Runtime::Instance::MemoryInstance &MemInst, int32_t Fd,
                      uint64_t Offset, uint64_t Len) {
   const auto Entry = Env.getFile(Fd);
-  if (unlikely(Entry == Env.getFileEnd())) {
+  if (unlikely(Entry == nullptr)) {
     return __WASI_EBADF;
   }
 
@@ -577,6 +762,15 @@ WasiFdAllocate::body(Runtime::Instance::MemoryInstance &MemInst, int32_t Fd,
     return __WASI_ENOTCAPABLE;
   }
 
+  if (Entry->isVirtual()) {
+    __wasi_filestat_t Stat;
+    Entry->Node->stat(Stat);
+    if (Offset + Len > Stat.st_size) {
+      return Entry->Node->truncate(Offset + Len);
+    }
+    return __WASI_ESUCCESS;
+  }
+
   if (unlikely(posix_fallocate(Fd, Offset, Len) != 0)) {
     return convertErrNo(errno);
   }
@@ -587,22 +781,23 @@ WasiFdAllocate::body(Runtime::Instance::MemoryInstance &MemInst, int32_t Fd,
 Expect<uint32_t> WasiFdClose::body(Runtime::Instance::MemoryInstance &MemInst,
                                    int32_t Fd) {
   const auto Entry = Env.getFile(Fd);
-  if (unlikely(Entry == Env.getFileEnd())) {
+  if (unlikely(Entry == nullptr)) {
     return __WASI_EBADF;
   }
 
+  Env.getEventPoll().forget(Fd);
   if (unlikely(close(Fd) != 0)) {
     return convertErrNo(errno);
   }
 
-  Env.eraseFile(Entry);
+  Env.eraseFile(Fd);
   return __WASI_ESUCCESS;
 }
 
 Expect<uint32_t>
 WasiFdDatasync::body(Runtime::Instance::MemoryInstance &MemInst, int32_t Fd) {
   const auto Entry = Env.getFile(Fd);
-  if (unlikely(Entry == Env.getFileEnd())) {
+  if (unlikely(Entry == nullptr)) {
     return __WASI_EBADF;
   }
 
@@ -610,6 +805,10 @@ WasiFdDatasync::body(Runtime::Instance::MemoryInstance &MemInst, int32_t Fd) {
     return __WASI_ENOTCAPABLE;
   }
 
+  if (Entry->isVirtual()) {
+    return __WASI_ESUCCESS;
+  }
+
   if (unlikely(fdatasync(Fd) != 0)) {
     return convertErrNo(errno);
   }
@@ -621,7 +820,7 @@ Expect<uint32_t>
 WasiFdFdstatGet::body(Runtime::Instance::MemoryInstance &MemInst, int32_t Fd,
                       uint32_t FdStatPtr) {
   const auto Entry = Env.getFile(Fd);
-  if (unlikely(Entry == Env.getFileEnd())) {
+  if (unlikely(Entry == nullptr)) {
     return __WASI_EBADF;
   }
 
@@ -631,6 +830,14 @@ WasiFdFdstatGet::body(Runtime::Instance::MemoryInstance &MemInst, int32_t Fd,
     return __WASI_EFAULT;
   }
 
+  if (Entry->isVirtual()) {
+    FdStat->fs_filetype = Entry->Node->getType();
+    FdStat->fs_flags = Entry->Append ? __WASI_FDFLAG_APPEND : 0;
+    FdStat->fs_rights_base = Entry->Rights;
+    FdStat->fs_rights_inheriting = Entry->InheritingRights;
+    return __WASI_ESUCCESS;
+  }
+
   /// 1. __wasi_fdstat_t.fs_filetype
   {
     struct stat SysFStat;
@@ -667,7 +874,7 @@ Expect<uint32_t>
 WasiFdFdstatSetFlags::body(Runtime::Instance::MemoryInstance &MemInst,
                            int32_t Fd, uint32_t FsFlags) {
   const auto Entry = Env.getFile(Fd);
-  if (unlikely(Entry == Env.getFileEnd())) {
+  if (unlikely(Entry == nullptr)) {
     return __WASI_EBADF;
   }
 
@@ -698,6 +905,12 @@ WasiFdFdstatSetFlags::body(Runtime::Instance::MemoryInstance &MemInst,
     return __WASI_ENOTCAPABLE;
   }
 
+  /// Virtual files are always synchronized and never block.
+  if (Entry->isVirtual()) {
+    Entry->Append = (FsFlags & __WASI_FDFLAG_APPEND) != 0;
+    return __WASI_ESUCCESS;
+  }
+
   if (unlikely(fcntl(Fd, F_SETFL, SysFlag) != 0)) {
     return convertErrNo(errno);
   }
@@ -710,7 +923,7 @@ WasiFdFdstatSetRights::body(Runtime::Instance::MemoryInstance &MemInst,
                             int32_t Fd, uint64_t FsRightsBase,
                             uint64_t FsRightsInheriting) {
   const auto Entry = Env.getFile(Fd);
-  if (unlikely(Entry == Env.getFileEnd())) {
+  if (unlikely(Entry == nullptr)) {
     return __WASI_EBADF;
   }
 
@@ -727,7 +940,7 @@ Expect<uint32_t>
 WasiFdFilestatGet::body(Runtime::Instance::MemoryInstance &MemInst, int32_t Fd,
                         uint32_t FilestatPtr) {
   const auto Entry = Env.getFile(Fd);
-  if (unlikely(Entry == Env.getFileEnd())) {
+  if (unlikely(Entry == nullptr)) {
     return __WASI_EBADF;
   }
 
@@ -740,6 +953,11 @@ WasiFdFilestatGet::body(Runtime::Instance::MemoryInstance &MemInst, int32_t Fd,
     return __WASI_EFAULT;
   }
 
+  if (Entry->isVirtual()) {
+    Entry->Node->stat(*Filestat);
+    return __WASI_ESUCCESS;
+  }
+
   struct stat SysFStat;
   if (unlikely(fstat(Fd, &SysFStat) != 0)) {
     return convertErrNo(errno);
@@ -764,7 +982,7 @@ Expect<uint32_t>
 WasiFdFilestatSetSize::body(Runtime::Instance::MemoryInstance &MemInst,
                             int32_t Fd, uint64_t FileSize) {
   const auto Entry = Env.getFile(Fd);
-  if (unlikely(Entry == Env.getFileEnd())) {
+  if (unlikely(Entry == nullptr)) {
     return __WASI_EBADF;
   }
 
@@ -772,6 +990,10 @@ WasiFdFilestatSetSize::body(Runtime::Instance::MemoryInstance &MemInst,
     return __WASI_ENOTCAPABLE;
   }
 
+  if (Entry->isVirtual()) {
+    return Entry->Node->truncate(FileSize);
+  }
+
   if (unlikely(ftruncate(Fd, FileSize) == -1)) {
     return convertErrNo(errno);
   }
@@ -784,7 +1006,7 @@ WasiFdFilestatSetTimes::body(Runtime::Instance::MemoryInstance &MemInst,
                              int32_t Fd, uint64_t ATim, uint64_t MTim,
                              uint32_t FstFlags) {
   const auto Entry = Env.getFile(Fd);
-  if (unlikely(Entry == Env.getFileEnd())) {
+  if (unlikely(Entry == nullptr)) {
     return __WASI_EBADF;
   }
 
@@ -792,6 +1014,10 @@ WasiFdFilestatSetTimes::body(Runtime::Instance::MemoryInstance &MemInst,
     return __WASI_ENOTCAPABLE;
   }
 
+  if (unlikely(Entry->isVirtual())) {
+    return __WASI_ENOTSUP;
+  }
+
   timespec SysTimespec[2];
   if (FstFlags & __WASI_FILESTAT_SET_ATIM) {
     SysTimespec[0] = timestamp2Timespec(ATim);
@@ -820,7 +1046,7 @@ Expect<uint32_t> WasiFdPread::body(Runtime::Instance::MemoryInstance &MemInst,
                                    int32_t IOVSLen, uint64_t Offset,
                                    uint32_t NReadPtr) {
   const auto Entry = Env.getFile(Fd);
-  if (unlikely(Entry == Env.getFileEnd())) {
+  if (unlikely(Entry == nullptr)) {
     return __WASI_EBADF;
   }
 
@@ -829,7 +1055,8 @@ Expect<uint32_t> WasiFdPread::body(Runtime::Instance::MemoryInstance &MemInst,
     return __WASI_ENOTCAPABLE;
   }
 
-  if (unlikely(IOVSLen < 0 || IOVSLen > kIOVSMax)) {
+  if (unlikely(IOVSLen < 0 || IOVSLen > kIOVSMax ||
+               Offset > std::numeric_limits<int64_t>::max())) {
     return __WASI_EINVAL;
   }
 
@@ -867,12 +1094,21 @@ Expect<uint32_t> WasiFdPread::body(Runtime::Instance::MemoryInstance &MemInst,
     SysIOVS[I].iov_len = IOVS.buf_len;
   }
 
-  /// Store read bytes length.
-  *NRead = preadv(Fd, SysIOVS, IOVSLen, Offset);
+  if (Entry->isVirtual()) {
+    uint64_t Size = 0;
+    const auto Err = Entry->Node->read(SysIOVS, IOVSLen, Offset, Size);
+    *NRead = Size;
+    Stats.addBytesIn(Size);
+    return Err;
+  }
 
-  if (unlikely(*NRead < 0)) {
+  /// Store read bytes length.
+  const ssize_t Res = readIOVS(Env, MemInst, Fd, SysIOVS, IOVSLen, Offset);
+  if (unlikely(Res < 0)) {
     return convertErrNo(errno);
   }
+  *NRead = Res;
+  Stats.addBytesIn(Res);
 
   return __WASI_ESUCCESS;
 }
@@ -881,7 +1117,7 @@ Expect<uint32_t>
 WasiFdPrestatDirName::body(Runtime::Instance::MemoryInstance &MemInst,
                            int32_t Fd, uint32_t PathBufPtr, uint32_t PathLen) {
   const auto Entry = Env.getFile(Fd);
-  if (unlikely(Entry == Env.getFileEnd())) {
+  if (unlikely(Entry == nullptr)) {
     return __WASI_EBADF;
   }
 
@@ -905,7 +1141,7 @@ Expect<uint32_t>
 WasiFdPrestatGet::body(Runtime::Instance::MemoryInstance &MemInst, int32_t Fd,
                        uint32_t PreStatPtr) {
   const auto Entry = Env.getFile(Fd);
-  if (unlikely(Entry == Env.getFileEnd())) {
+  if (unlikely(Entry == nullptr)) {
     return __WASI_EBADF;
   }
 
@@ -926,7 +1162,7 @@ Expect<uint32_t> WasiFdPwrite::body(Runtime::Instance::MemoryInstance &MemInst,
                                     int32_t IOVSLen, uint64_t Offset,
                                     uint32_t NWrittenPtr) {
   const auto Entry = Env.getFile(Fd);
-  if (unlikely(Entry == Env.getFileEnd())) {
+  if (unlikely(Entry == nullptr)) {
     return __WASI_EBADF;
   }
 
@@ -935,7 +1171,8 @@ Expect<uint32_t> WasiFdPwrite::body(Runtime::Instance::MemoryInstance &MemInst,
     return __WASI_ENOTCAPABLE;
   }
 
-  if (unlikely(IOVSLen < 0 || IOVSLen > kIOVSMax)) {
+  if (unlikely(IOVSLen < 0 || IOVSLen > kIOVSMax ||
+               Offset > std::numeric_limits<int64_t>::max())) {
     return __WASI_EINVAL;
   }
 
@@ -974,11 +1211,20 @@ Expect<uint32_t> WasiFdPwrite::body(Runtime::Instance::MemoryInstance &MemInst,
     SysIOVS[I].iov_len = IOVS.buf_len;
   }
 
-  *NWritten = pwritev(Fd, SysIOVS, IOVSLen, Offset);
+  if (Entry->isVirtual()) {
+    uint64_t Size = 0;
+    const auto Err = Entry->Node->write(SysIOVS, IOVSLen, Offset, Size);
+    *NWritten = Size;
+    Stats.addBytesOut(Size);
+    return Err;
+  }
 
-  if (unlikely(*NWritten < 0)) {
+  const ssize_t Res = writeIOVS(Env, MemInst, Fd, SysIOVS, IOVSLen, Offset);
+  if (unlikely(Res < 0)) {
     return convertErrNo(errno);
   }
+  *NWritten = Res;
+  Stats.addBytesOut(Res);
 
   return __WASI_ESUCCESS;
 }
@@ -987,7 +1233,7 @@ Expect<uint32_t> WasiFdRead::body(Runtime::Instance::MemoryInstance &MemInst,
                                   int32_t Fd, uint32_t IOVSPtr, int32_t IOVSLen,
                                   uint32_t NReadPtr) {
   const auto Entry = Env.getFile(Fd);
-  if (unlikely(Entry == Env.getFileEnd())) {
+  if (unlikely(Entry == nullptr)) {
     return __WASI_EBADF;
   }
 
@@ -1032,12 +1278,23 @@ Expect<uint32_t> WasiFdRead::body(Runtime::Instance::MemoryInstance &MemInst,
     SysIOVS[I].iov_len = IOVS.buf_len;
   }
 
-  /// Store read bytes length.
-  *NRead = readv(Fd, SysIOVS, IOVSLen);
+  if (Entry->isVirtual()) {
+    uint64_t Size = 0;
+    const auto Err =
+        Entry->Node->read(SysIOVS, IOVSLen, Entry->Offset, Size);
+    Entry->Offset += Size;
+    *NRead = Size;
+    Stats.addBytesIn(Size);
+    return Err;
+  }
 
-  if (unlikely(*NRead < 0)) {
+  /// Store read bytes length.
+  const ssize_t Res = readIOVS(Env, MemInst, Fd, SysIOVS, IOVSLen, -1);
+  if (unlikely(Res < 0)) {
     return convertErrNo(errno);
   }
+  *NRead = Res;
+  Stats.addBytesIn(Res);
 
   return __WASI_ESUCCESS;
 }
@@ -1047,7 +1304,7 @@ Expect<uint32_t> WasiFdReadDir::body(Runtime::Instance::MemoryInstance &MemInst,
                                      uint32_t BufLen, uint64_t Cookie,
                                      uint32_t BufUsedSizePtr) {
   const auto Entry = Env.getFile(Fd);
-  if (unlikely(Entry == Env.getFileEnd())) {
+  if (unlikely(Entry == nullptr)) {
     return __WASI_EBADF;
   }
 
@@ -1070,6 +1327,44 @@ Expect<uint32_t> WasiFdReadDir::body(Runtime::Instance::MemoryInstance &MemInst,
     return __WASI_EFAULT;
   }
 
+  if (Entry->isVirtual()) {
+    std::vector<std::pair<std::string, std::shared_ptr<VFSNode>>> Entries;
+    if (const auto Err = Entry->Node->list(Entries); Err != __WASI_ESUCCESS) {
+      return Err;
+    }
+    /// The cookie is the index of the next entry, counting "." and "..".
+    *BufUsedSize = 0;
+    for (uint64_t I = Cookie; I < Entries.size() + 2 && BufLen > 0; ++I) {
+      using namespace std::literals;
+      const std::string_view Name =
+          I == 0 ? "."sv : (I == 1 ? ".."sv : Entries[I - 2].first);
+      __wasi_filestat_t Stat{};
+      if (I >= 2) {
+        Entries[I - 2].second->stat(Stat);
+      } else {
+        Entry->Node->stat(Stat);
+      }
+      __wasi_dirent_t Dirent{};
+      Dirent.d_next = I + 1;
+      Dirent.d_ino = Stat.st_ino;
+      Dirent.d_namlen = Name.size();
+      Dirent.d_type = Stat.st_filetype;
+
+      /// The last entry is truncated when the buffer is full.
+      const auto *const DirentBytes = reinterpret_cast<uint8_t *>(&Dirent);
+      const uint32_t HeadSize =
+          std::min<uint32_t>(BufLen, sizeof(__wasi_dirent_t));
+      std::copy(DirentBytes, DirentBytes + HeadSize, Buf);
+      const uint32_t NameSize =
+          std::min<uint32_t>(BufLen - HeadSize, Name.size());
+      std::copy(Name.begin(), Name.begin() + NameSize, Buf + HeadSize);
+      Buf += HeadSize + NameSize;
+      BufLen -= HeadSize + NameSize;
+      *BufUsedSize += HeadSize + NameSize;
+    }
+    return __WASI_ESUCCESS;
+  }
+
   if (unlikely(!Entry->Dir)) {
     DIR *D = fdopendir(Fd);
     if (D == nullptr) {
@@ -1128,7 +1423,12 @@ Expect<uint32_t>
 WasiFdRenumber::body(Runtime::Instance::MemoryInstance &MemInst, int32_t Fd,
                      int32_t ToFd) {
   const auto Entry = Env.getFile(Fd);
-  if (unlikely(Entry == Env.getFileEnd())) {
+  if (unlikely(Entry == nullptr)) {
+    return __WASI_EBADF;
+  }
+
+  /// The target must be an opened file descriptor.
+  if (unlikely(Env.getFile(ToFd) == nullptr)) {
     return __WASI_EBADF;
   }
 
@@ -1137,6 +1437,12 @@ WasiFdRenumber::body(Runtime::Instance::MemoryInstance &MemInst, int32_t Fd,
                Fd == STDERR_FILENO)) {
     return __WASI_ENOTSUP;
   }
+  if (Fd == ToFd) {
+    return __WASI_ESUCCESS;
+  }
+
+  Env.getEventPoll().forget(Fd);
+  Env.getEventPoll().forget(ToFd);
 
   /// Duplicate file descriptor
   if (unlikely(dup2(Fd, ToFd) == -1)) {
@@ -1147,10 +1453,11 @@ WasiFdRenumber::body(Runtime::Instance::MemoryInstance &MemInst, int32_t Fd,
   if (unlikely(close(Fd) != 0)) {
     const int error = errno;
     close(ToFd);
+    Env.eraseFile(ToFd);
     return convertErrNo(error);
   }
 
-  Entry->Fd = ToFd;
+  Env.renumberFile(Fd, ToFd);
 
   return __WASI_ESUCCESS;
 }
@@ -1159,7 +1466,7 @@ Expect<int32_t> WasiFdSeek::body(Runtime::Instance::MemoryInstance &MemInst,
                                  int32_t Fd, int64_t Offset, uint32_t Whence,
                                  uint32_t NewOffsetPtr) {
   const auto Entry = Env.getFile(Fd);
-  if (unlikely(Entry == Env.getFileEnd())) {
+  if (unlikely(Entry == nullptr)) {
     return __WASI_EBADF;
   }
 
@@ -1190,6 +1497,23 @@ Expect<int32_t> WasiFdSeek::body(Runtime::Instance::MemoryInstance &MemInst,
     return __WASI_EFAULT;
   }
 
+  if (Entry->isVirtual()) {
+    int64_t Base = 0;
+    if (SysWhence == SEEK_CUR) {
+      Base = Entry->Offset;
+    } else if (SysWhence == SEEK_END) {
+      __wasi_filestat_t Stat;
+      Entry->Node->stat(Stat);
+      Base = Stat.st_size;
+    }
+    if (unlikely(Offset < -Base)) {
+      return __WASI_EINVAL;
+    }
+    Entry->Offset = Base + Offset;
+    *NewOffset = Entry->Offset;
+    return __WASI_ESUCCESS;
+  }
+
   /// Do lseek.
   *NewOffset = lseek(Fd, Offset, SysWhence);
   if (unlikely(*NewOffset < 0)) {
@@ -1202,7 +1526,7 @@ Expect<int32_t> WasiFdSeek::body(Runtime::Instance::MemoryInstance &MemInst,
 Expect<uint32_t> WasiFdSync::body(Runtime::Instance::MemoryInstance &MemInst,
                                   int32_t Fd) {
   const auto Entry = Env.getFile(Fd);
-  if (unlikely(Entry == Env.getFileEnd())) {
+  if (unlikely(Entry == nullptr)) {
     return __WASI_EBADF;
   }
 
@@ -1210,6 +1534,10 @@ Expect<uint32_t> WasiFdSync::body(Runtime::Instance::MemoryInstance &MemInst,
     return __WASI_ENOTCAPABLE;
   }
 
+  if (Entry->isVirtual()) {
+    return __WASI_ESUCCESS;
+  }
+
   if (unlikely(fsync(Fd) != 0)) {
     return convertErrNo(errno);
   }
@@ -1219,7 +1547,7 @@ Expect<uint32_t> WasiFdSync::body(Runtime::Instance::MemoryInstance &MemInst,
 Expect<uint32_t> WasiFdTell::body(Runtime::Instance::MemoryInstance &MemInst,
                                   int32_t Fd, int32_t OffsetPtr) {
   const auto Entry = Env.getFile(Fd);
-  if (unlikely(Entry == Env.getFileEnd())) {
+  if (unlikely(Entry == nullptr)) {
     return __WASI_EBADF;
   }
 
@@ -1234,6 +1562,11 @@ Expect<uint32_t> WasiFdTell::body(Runtime::Instance::MemoryInstance &MemInst,
     return __WASI_EFAULT;
   }
 
+  if (Entry->isVirtual()) {
+    *Offset = Entry->Offset;
+    return __WASI_ESUCCESS;
+  }
+
   /// Do lseek.
   *Offset = lseek(Fd, 0, SEEK_CUR);
   if (unlikely(*Offset < 0)) {
@@ -1246,8 +1579,8 @@ Expect<uint32_t> WasiFdTell::body(Runtime::Instance::MemoryInstance &MemInst,
 Expect<uint32_t> WasiFdWrite::body(Runtime::Instance::MemoryInstance &MemInst,
                                    int32_t Fd, uint32_t IOVSPtr,
                                    int32_t IOVSLen, uint32_t NWrittenPtr) {
-  const auto Entry = Env.getFile(Fd);
-  if (unlikely(Entry == Env.getFileEnd())) {
+  const auto Entry = Env.getFileForWrite(Fd);
+  if (unlikely(Entry == nullptr)) {
     return __WASI_EBADF;
   }
 
@@ -1294,11 +1627,29 @@ Expect<uint32_t> WasiFdWrite::body(Runtime::Instance::MemoryInstance &MemInst,
     SysIOVS[I].iov_len = IOVS.buf_len;
   }
 
-  *NWritten = writev(Fd, SysIOVS, IOVSLen);
-
-  if (unlikely(*NWritten < 0)) {
+  if (Entry->isVirtual()) {
+    if (Entry->Append) {
+      __wasi_filestat_t Stat;
+      Entry->Node->stat(Stat);
+      Entry->Offset = Stat.st_size;
+    }
+    uint64_t Size = 0;
+    const auto Err =
+        Entry->Node->write(SysIOVS, IOVSLen, Entry->Offset, Size);
+    Entry->Offset += Size;
+    *NWritten = Size;
+    Stats.addBytesOut(Size);
+    return Err;
+  }
+
+  const ssize_t Res = Env.isWriteBuffered(Fd)
+                          ? Env.bufferWrite(Fd, SysIOVS, IOVSLen)
+                          : writeIOVS(Env, MemInst, Fd, SysIOVS, IOVSLen, -1);
+  if (unlikely(Res < 0)) {
     return convertErrNo(errno);
   }
+  *NWritten = Res;
+  Stats.addBytesOut(Res);
 
   return __WASI_ESUCCESS;
 }
@@ -1307,7 +1658,7 @@ Expect<uint32_t>
 WasiPathCreateDirectory::body(Runtime::Instance::MemoryInstance &MemInst,
                               int32_t Fd, uint32_t PathPtr, uint32_t PathLen) {
   const auto Entry = Env.getFile(Fd);
-  if (unlikely(Entry == Env.getFileEnd())) {
+  if (unlikely(Entry == nullptr)) {
     return __WASI_EBADF;
   }
 
@@ -1321,6 +1672,16 @@ WasiPathCreateDirectory::body(Runtime::Instance::MemoryInstance &MemInst,
   }
   std::string PathStr(Path, PathLen);
 
+  if (Entry->isVirtual()) {
+    std::shared_ptr<VFSNode> Parent, Node;
+    std::string Name;
+    if (const auto Err = resolveParent(Entry->Node, PathStr, Parent, Name);
+        Err != __WASI_ESUCCESS) {
+      return Err;
+    }
+    return Parent->create(Name, __WASI_FILETYPE_DIRECTORY, Node);
+  }
+
   if (unlikely(mkdirat(Fd, PathStr.c_str(), 0755) != 0)) {
     return convertErrNo(errno);
   }
@@ -1333,7 +1694,7 @@ WasiPathFilestatGet::body(Runtime::Instance::MemoryInstance &MemInst,
                           int32_t Fd, uint32_t Flags, uint32_t PathPtr,
                           uint32_t PathLen, uint32_t FilestatPtr) {
   const auto Entry = Env.getFile(Fd);
-  if (unlikely(Entry == Env.getFileEnd())) {
+  if (unlikely(Entry == nullptr)) {
     return __WASI_EBADF;
   }
 
@@ -1353,6 +1714,16 @@ WasiPathFilestatGet::body(Runtime::Instance::MemoryInstance &MemInst,
   }
   std::string PathStr(Path, PathLen);
 
+  if (Entry->isVirtual()) {
+    std::shared_ptr<VFSNode> Node;
+    if (const auto Err = resolvePath(Entry->Node, PathStr, Node);
+        Err != __WASI_ESUCCESS) {
+      return Err;
+    }
+    Node->stat(*Filestat);
+    return __WASI_ESUCCESS;
+  }
+
   struct stat SysFStat;
 
   int Result;
@@ -1385,7 +1756,7 @@ WasiPathFilestatSetTimes::body(Runtime::Instance::MemoryInstance &MemInst,
                                uint32_t PathLen, uint32_t ATim, uint32_t MTim,
                                uint32_t FstFlags) {
   const auto Entry = Env.getFile(Fd);
-  if (unlikely(Entry == Env.getFileEnd())) {
+  if (unlikely(Entry == nullptr)) {
     return __WASI_EBADF;
   }
 
@@ -1393,6 +1764,10 @@ WasiPathFilestatSetTimes::body(Runtime::Instance::MemoryInstance &MemInst,
     return __WASI_ENOTCAPABLE;
   }
 
+  if (unlikely(Entry->isVirtual())) {
+    return __WASI_ENOTSUP;
+  }
+
   /// Get file path.
   char *const Path = MemInst.getPointer<char *>(PathPtr, PathLen);
   if (unlikely(Path == nullptr)) {
@@ -1434,12 +1809,12 @@ Expect<uint32_t> WasiPathLink::body(Runtime::Instance::MemoryInstance &MemInst,
                                     int32_t NewFd, uint32_t NewPathPtr,
                                     uint32_t NewPathLen) {
   const auto OldEntry = Env.getFile(OldFd);
-  if (unlikely(OldEntry == Env.getFileEnd())) {
+  if (unlikely(OldEntry == nullptr)) {
     return __WASI_EBADF;
   }
 
   const auto NewEntry = OldFd == NewFd ? OldEntry : Env.getFile(NewFd);
-  if (unlikely(NewEntry == Env.getFileEnd())) {
+  if (unlikely(NewEntry == nullptr)) {
     return __WASI_EBADF;
   }
 
@@ -1451,6 +1826,10 @@ Expect<uint32_t> WasiPathLink::body(Runtime::Instance::MemoryInstance &MemInst,
     return __WASI_ENOTCAPABLE;
   }
 
+  if (unlikely(OldEntry->isVirtual() || NewEntry->isVirtual())) {
+    return __WASI_ENOTSUP;
+  }
+
   const char *const OldPath =
       MemInst.getPointer<const char *>(OldPathPtr, OldPathLen);
   if (unlikely(OldPath == nullptr)) {
@@ -1484,7 +1863,7 @@ Expect<uint32_t> WasiPathOpen::body(Runtime::Instance::MemoryInstance &MemInst,
                                     uint64_t FsRightsInheriting,
                                     uint32_t FsFlags, uint32_t FdPtr) {
   const auto Entry = Env.getFile(DirFd);
-  if (unlikely(Entry == Env.getFileEnd())) {
+  if (unlikely(Entry == nullptr)) {
     return __WASI_EBADF;
   }
 
@@ -1556,6 +1935,47 @@ Expect<uint32_t> WasiPathOpen::body(Runtime::Instance::MemoryInstance &MemInst,
     return __WASI_ENOTCAPABLE;
   }
 
+  if (Entry->isVirtual()) {
+    std::shared_ptr<VFSNode> Node;
+    if (OFlags & __WASI_O_CREAT) {
+      std::shared_ptr<VFSNode> Parent;
+      std::string Name;
+      if (const auto Err = resolveParent(Entry->Node, PathStr, Parent, Name);
+          Err != __WASI_ESUCCESS) {
+        return Err;
+      }
+      if (Parent->lookup(Name, Node) == __WASI_ESUCCESS) {
+        if (OFlags & __WASI_O_EXCL) {
+          return __WASI_EEXIST;
+        }
+      } else if (const auto Err = Parent->create(
+                     Name, __WASI_FILETYPE_REGULAR_FILE, Node);
+                 Err != __WASI_ESUCCESS) {
+        return Err;
+      }
+    } else if (const auto Err = resolvePath(Entry->Node, PathStr, Node);
+               Err != __WASI_ESUCCESS) {
+      return Err;
+    }
+    if ((OFlags & __WASI_O_DIRECTORY) &&
+        Node->getType() != __WASI_FILETYPE_DIRECTORY) {
+      return __WASI_ENOTDIR;
+    }
+    if (OFlags & __WASI_O_TRUNC) {
+      if (const auto Err = Node->truncate(0); Err != __WASI_ESUCCESS) {
+        return Err;
+      }
+    }
+    const int32_t NewFd = Env.openVirtual(std::move(Node), FsRightsBase,
+                                          FsRightsInheriting, PathStr);
+    if (unlikely(NewFd < 0)) {
+      return convertErrNo(errno);
+    }
+    Env.getFile(NewFd)->Append = (FsFlags & __WASI_FDFLAG_APPEND) != 0;
+    *Fd = NewFd;
+    return __WASI_ESUCCESS;
+  }
+
   /// Open file and store Fd.
   *Fd = open(PathStr.c_str(), Flags, 0644);
   if (unlikely(*Fd < 0)) {
@@ -1571,7 +1991,7 @@ WasiPathReadLink::body(Runtime::Instance::MemoryInstance &MemInst, int32_t Fd,
                        uint32_t PathPtr, uint32_t PathLen, uint32_t BufPtr,
                        uint32_t BufLen) {
   const auto Entry = Env.getFile(Fd);
-  if (unlikely(Entry == Env.getFileEnd())) {
+  if (unlikely(Entry == nullptr)) {
     return __WASI_EBADF;
   }
 
@@ -1579,6 +1999,10 @@ WasiPathReadLink::body(Runtime::Instance::MemoryInstance &MemInst, int32_t Fd,
     return __WASI_ENOTCAPABLE;
   }
 
+  if (unlikely(Entry->isVirtual())) {
+    return __WASI_EINVAL;
+  }
+
   char *const Path = MemInst.getPointer<char *>(PathPtr, PathLen);
   if (unlikely(Path == nullptr)) {
     return __WASI_EFAULT;
@@ -1601,7 +2025,7 @@ Expect<uint32_t>
 WasiPathRemoveDirectory::body(Runtime::Instance::MemoryInstance &MemInst,
                               int32_t Fd, uint32_t PathPtr, uint32_t PathLen) {
   const auto Entry = Env.getFile(Fd);
-  if (unlikely(Entry == Env.getFileEnd())) {
+  if (unlikely(Entry == nullptr)) {
     return __WASI_EBADF;
   }
 
@@ -1615,6 +2039,16 @@ WasiPathRemoveDirectory::body(Runtime::Instance::MemoryInstance &MemInst,
   }
   std::string PathStr(Path, PathLen);
 
+  if (Entry->isVirtual()) {
+    std::shared_ptr<VFSNode> Parent;
+    std::string Name;
+    if (const auto Err = resolveParent(Entry->Node, PathStr, Parent, Name);
+        Err != __WASI_ESUCCESS) {
+      return Err;
+    }
+    return Parent->remove(Name, true);
+  }
+
   if (unlinkat(Fd, PathStr.c_str(), AT_REMOVEDIR) < 0) {
     return convertErrNo(errno);
   }
@@ -1627,7 +2061,7 @@ WasiPathRename::body(Runtime::Instance::MemoryInstance &MemInst, int32_t Fd,
                      uint32_t OldPathPtr, uint32_t OldPathLen, int32_t NewFd,
                      uint32_t NewPathPtr, uint32_t NewPathLen) {
   const auto Entry = Env.getFile(Fd);
-  if (unlikely(Entry == Env.getFileEnd())) {
+  if (unlikely(Entry == nullptr)) {
     return __WASI_EBADF;
   }
 
@@ -1636,7 +2070,7 @@ WasiPathRename::body(Runtime::Instance::MemoryInstance &MemInst, int32_t Fd,
   }
 
   const auto NewEntry = NewFd == Fd ? Entry : Env.getFile(NewFd);
-  if (unlikely(NewEntry == Env.getFileEnd())) {
+  if (unlikely(NewEntry == nullptr)) {
     return __WASI_EBADF;
   }
 
@@ -1655,6 +2089,25 @@ WasiPathRename::body(Runtime::Instance::MemoryInstance &MemInst, int32_t Fd,
   std::string OldPathStr(OldPath, OldPathLen);
   std::string NewPathStr(NewPath, NewPathLen);
 
+  if (Entry->isVirtual() || NewEntry->isVirtual()) {
+    if (unlikely(!Entry->isVirtual() || !NewEntry->isVirtual())) {
+      return __WASI_EXDEV;
+    }
+    std::shared_ptr<VFSNode> OldParent, NewParent;
+    std::string OldName, NewName;
+    if (const auto Err =
+            resolveParent(Entry->Node, OldPathStr, OldParent, OldName);
+        Err != __WASI_ESUCCESS) {
+      return Err;
+    }
+    if (const auto Err =
+            resolveParent(NewEntry->Node, NewPathStr, NewParent, NewName);
+        Err != __WASI_ESUCCESS) {
+      return Err;
+    }
+    return OldParent->rename(OldName, *NewParent, NewName);
+  }
+
   if (unlikely(renameat(Fd, OldPathStr.c_str(), NewFd, NewPathStr.c_str()) !=
                0)) {
     return convertErrNo(errno);
@@ -1668,7 +2121,7 @@ WasiPathSymlink::body(Runtime::Instance::MemoryInstance &MemInst,
                       uint32_t OldPathPtr, uint32_t OldPathLen, int32_t Fd,
                       uint32_t NewPathPtr, uint32_t NewPathLen) {
   const auto Entry = Env.getFile(Fd);
-  if (unlikely(Entry == Env.getFileEnd())) {
+  if (unlikely(Entry == nullptr)) {
     return __WASI_EBADF;
   }
 
@@ -1676,6 +2129,10 @@ WasiPathSymlink::body(Runtime::Instance::MemoryInstance &MemInst,
     return __WASI_ENOTCAPABLE;
   }
 
+  if (unlikely(Entry->isVirtual())) {
+    return __WASI_ENOTSUP;
+  }
+
   char *const OldPath = MemInst.getPointer<char *>(OldPathPtr, OldPathLen);
   if (unlikely(OldPath == nullptr)) {
     return __WASI_EFAULT;
@@ -1698,7 +2155,7 @@ Expect<uint32_t>
 WasiPathUnlinkFile::body(Runtime::Instance::MemoryInstance &MemInst, int32_t Fd,
                          uint32_t PathPtr, uint32_t PathLen) {
   const auto Entry = Env.getFile(Fd);
-  if (unlikely(Entry == Env.getFileEnd())) {
+  if (unlikely(Entry == nullptr)) {
     return __WASI_EBADF;
   }
 
@@ -1712,6 +2169,16 @@ WasiPathUnlinkFile::body(Runtime::Instance::MemoryInstance &MemInst, int32_t Fd,
   }
   std::string PathStr(Path, PathLen);
 
+  if (Entry->isVirtual()) {
+    std::shared_ptr<VFSNode> Parent;
+    std::string Name;
+    if (const auto Err = resolveParent(Entry->Node, PathStr, Parent, Name);
+        Err != __WASI_ESUCCESS) {
+      return Err;
+    }
+    return Parent->remove(Name, false);
+  }
+
   if (unlinkat(Fd, PathStr.c_str(), 0) < 0) {
     return convertErrNo(errno);
   }
@@ -1723,106 +2190,8 @@ Expect<uint32_t>
 WasiPollOneoff::body(Runtime::Instance::MemoryInstance &MemInst, uint32_t InPtr,
                      uint32_t OutPtr, uint32_t NSubscriptions,
                      uint32_t NEventsPtr) {
-  struct EventPoll {
-    EventPoll(uint32_t MaxEvent) : Events(MaxEvent) {}
-    ~EventPoll() noexcept {
-      for (timer_t Timer : Timers) {
-        timer_delete(Timer);
-      }
-      if (SignalFd >= 0) {
-        close(SignalFd);
-
-        sigset_t Mask{};
-        sigemptyset(&Mask);
-        sigaddset(&Mask, SIGRTMIN);
-        sigprocmask(SIG_UNBLOCK, &Mask, nullptr);
-      }
-    }
-    bool Create() noexcept {
-      if (EPollFd >= 0) {
-        return true;
-      }
-      EPollFd = epoll_create1(EPOLL_CLOEXEC);
-      return likely(EPollFd >= 0);
-    }
-    bool MonitorSignal() noexcept {
-      if (likely(SignalFd >= 0)) {
-        return true;
-      }
-      sigset_t Mask{};
-      sigemptyset(&Mask);
-      sigaddset(&Mask, SIGRTMIN);
-
-      if (unlikely(sigprocmask(SIG_BLOCK, &Mask, nullptr) < 0)) {
-        return false;
-      }
-
-      SignalFd = signalfd(-1, &Mask, SFD_NONBLOCK | SFD_CLOEXEC);
-      if (unlikely(SignalFd < 0)) {
-        return false;
-      }
-      epoll_event Event{};
-      Event.events = EPOLLIN;
-      Event.data.u32 = -1;
-      if (unlikely(epoll_ctl(EPollFd, EPOLL_CTL_ADD, SignalFd, &Event) < 0)) {
-        return false;
-      }
-      return true;
-    }
-    bool AddFd(int Fd, const __wasi_subscription_t *Pointer,
-               bool IsRead) noexcept {
-      epoll_event Event;
-      Event.events = (IsRead ? EPOLLIN : EPOLLOUT) | EPOLLRDHUP;
-      Event.data.ptr = const_cast<__wasi_subscription_t *>(Pointer);
-      if (unlikely(epoll_ctl(EPollFd, EPOLL_CTL_ADD, Fd, &Event) < 0)) {
-        return false;
-      }
-      return true;
-    }
-    bool AddTimer(clockid_t ClockId, const __wasi_subscription_t *Pointer,
-                  int flags, __wasi_timestamp_t Timestamp) noexcept {
-      sigevent Event;
-      Event.sigev_notify = SIGEV_SIGNAL;
-      Event.sigev_signo = SIGRTMIN;
-      Event.sigev_value.sival_ptr =
-          const_cast<__wasi_subscription_t *>(Pointer);
-      timer_t TimerId;
-      if (unlikely(timer_create(ClockId, &Event, &TimerId) < 0)) {
-        return false;
-      }
-
-      Timers.push_back(std::move(TimerId));
-
-      itimerspec ITimerSpec{timestamp2Timespec(0),
-                            timestamp2Timespec(Timestamp)};
-      if (unlikely(timer_settime(TimerId, 0, &ITimerSpec, nullptr) < 0)) {
-        return false;
-      }
-
-      return true;
-    }
-    bool Wait() noexcept {
-      sigset_t Mask;
-      sigfillset(&Mask);
-      sigdelset(&Mask, SIGRTMIN);
-      const int Count =
-          epoll_pwait(EPollFd, Events.data(), Events.size(), -1, &Mask);
-      if (unlikely(Count < 0)) {
-        return false;
-      }
-      Events.resize(Count);
-      return true;
-    }
-
-    int EPollFd = -1;
-    int SignalFd = -1;
-    std::vector<timer_t> Timers;
-    std::vector<epoll_event> Events;
-  };
-
-  EventPoll Event(NSubscriptions);
-  if (unlikely(!Event.Create())) {
-    return convertErrNo(errno);
+  if (unlikely(NSubscriptions == 0)) {
+    return __WASI_EINVAL;
   }
 
   const __wasi_subscription_t *const SubscriptionArray =
@@ -1832,7 +2201,7 @@ WasiPollOneoff::body(Runtime::Instance::MemoryInstance &MemInst, uint32_t InPtr,
   }
 
   __wasi_event_t *const EventArray =
-      MemInst.getPointer<__wasi_event_t *>(NEventsPtr, NSubscriptions);
+      MemInst.getPointer<__wasi_event_t *>(OutPtr, NSubscriptions);
   if (unlikely(EventArray == nullptr)) {
     return __WASI_EFAULT;
   }
@@ -1842,47 +2211,6 @@ WasiPollOneoff::body(Runtime::Instance::MemoryInstance &MemInst, uint32_t InPtr,
     return __WASI_EFAULT;
   }
 
-  *NEvents = 0;
-
-  auto RecordClockError = [&EventArray,
-                           &NEvents](const __wasi_subscription_t &Subscription,
-                                     __wasi_errno_t error) {
-    EventArray[*NEvents].userdata = Subscription.userdata;
-    EventArray[*NEvents].error = error;
-    EventArray[*NEvents].type = Subscription.type;
-    ++*NEvents;
-  };
-
-  auto RecordFdError = [&EventArray,
-                        &NEvents](const __wasi_subscription_t &Subscription,
-                                  __wasi_errno_t error) {
-    EventArray[*NEvents].userdata = Subscription.userdata;
-    EventArray[*NEvents].error = error;
-    EventArray[*NEvents].type = Subscription.type;
-    EventArray[*NEvents].u.fd_readwrite.nbytes = 0;
-    EventArray[*NEvents].u.fd_readwrite.flags = 0;
-    ++*NEvents;
-  };
-
-  auto RecordClock = [&EventArray,
-                      &NEvents](const __wasi_subscription_t &Subscription) {
-    EventArray[*NEvents].userdata = Subscription.userdata;
-    EventArray[*NEvents].error = __WASI_ESUCCESS;
-    EventArray[*NEvents].type = Subscription.type;
-    ++*NEvents;
-  };
-
-  auto RecordFd = [&EventArray, &NEvents](
-                      const __wasi_subscription_t &Subscription,
-                      __wasi_filesize_t nbytes, __wasi_eventrwflags_t flags) {
-    EventArray[*NEvents].userdata = Subscription.userdata;
-    EventArray[*NEvents].error = __WASI_ESUCCESS;
-    EventArray[*NEvents].type = Subscription.type;
-    EventArray[*NEvents].u.fd_readwrite.nbytes = nbytes;
-    EventArray[*NEvents].u.fd_readwrite.flags = flags;
-    ++*NEvents;
-  };
-
   /// Validate types
   for (uint32_t I = 0; I < NSubscriptions; ++I) {
     const __wasi_subscription_t &Subscription = SubscriptionArray[I];
@@ -1896,6 +2224,52 @@ WasiPollOneoff::body(Runtime::Instance::MemoryInstance &MemInst, uint32_t InPtr,
     }
   }
 
+  *NEvents = 0;
+  /// Each subscription is reported at most once, so the events never exceed
+  /// the subscriptions, e.g. when a failed subscription shares its fd with a
+  /// watched one.
+  std::vector<bool> Recorded(NSubscriptions, false);
+  auto Record = [&EventArray, &NEvents, &Recorded, &SubscriptionArray](
+                    uint32_t Idx, __wasi_errno_t Error,
+                    __wasi_filesize_t NBytes = 0,
+                    __wasi_eventrwflags_t Flags = 0) {
+    if (Recorded[Idx]) {
+      return;
+    }
+    Recorded[Idx] = true;
+    const __wasi_subscription_t &Subscription = SubscriptionArray[Idx];
+    __wasi_event_t &Event = EventArray[(*NEvents)++];
+    Event.userdata = Subscription.userdata;
+    Event.error = Error;
+    Event.type = Subscription.type;
+    if (Subscription.type != __WASI_EVENTTYPE_CLOCK) {
+      Event.u.fd_readwrite.nbytes = NBytes;
+      Event.u.fd_readwrite.flags = Flags;
+    }
+  };
+
+  /// Another guest thread may be waiting on the environment's instance, then
+  /// this poll falls back to a temporary one.
+  std::unique_lock Lock(Env.getEventPoll().getMutex(), std::try_to_lock);
+  std::optional<EventPoll> LocalPoll;
+  EventPoll *Poll = &Env.getEventPoll();
+  if (unlikely(!Lock.owns_lock())) {
+    Poll = &LocalPoll.emplace();
+  }
+  if (unlikely(!Poll->isAvailable())) {
+    return convertErrNo(errno);
+  }
+  Poll->beginPoll();
+
+  timespec SysNow;
+  clock_gettime(CLOCK_MONOTONIC, &SysNow);
+  const int64_t Now = timespec2Timestamp(SysNow);
+  constexpr const int64_t kNoDeadline = -1;
+  int64_t Deadline = kNoDeadline;
+  bool HasFd = false;
+  /// Deadlines of the clock subscriptions on CLOCK_MONOTONIC.
+  std::vector<int64_t> ClockDeadlines(NSubscriptions, kNoDeadline);
+
   for (uint32_t I = 0; I < NSubscriptions; ++I) {
     const __wasi_subscription_t &Subscription = SubscriptionArray[I];
     switch (Subscription.type) {
@@ -1915,60 +2289,67 @@ WasiPollOneoff::body(Runtime::Instance::MemoryInstance &MemInst, uint32_t InPtr,
         SysClockId = CLOCK_THREAD_CPUTIME_ID;
         break;
       default:
-        RecordClockError(Subscription, __WASI_EINVAL);
-        continue;
-      }
-
-      if (unlikely(!Event.MonitorSignal())) {
-        RecordClockError(Subscription, convertErrNo(errno));
+        Record(I, __WASI_EINVAL);
         continue;
       }
 
-      int flags = 0;
+      /// Map the timeout to the monotonic clock.
+      const int64_t Timeout = std::min<__wasi_timestamp_t>(
+          Subscription.u.clock.timeout, std::numeric_limits<int64_t>::max());
+      int64_t Remain = Timeout;
       if (Subscription.u.clock.flags & __WASI_SUBSCRIPTION_CLOCK_ABSTIME) {
-        flags |= TIMER_ABSTIME;
+        timespec SysClockNow;
+        if (unlikely(clock_gettime(SysClockId, &SysClockNow) != 0)) {
+          Record(I, convertErrNo(errno));
+          continue;
+        }
+        Remain = Timeout - timespec2Timestamp(SysClockNow);
       }
-      if (unlikely(!Event.AddTimer(SysClockId, &Subscription, flags,
-                                   Subscription.u.clock.timeout))) {
-        RecordClockError(Subscription, convertErrNo(errno));
-        continue;
+      Remain = std::max<int64_t>(Remain, 0);
+      ClockDeadlines[I] = Remain > std::numeric_limits<int64_t>::max() - Now
+                              ? std::numeric_limits<int64_t>::max()
+                              : Now + Remain;
+      if (Deadline == kNoDeadline || ClockDeadlines[I] < Deadline) {
+        Deadline = ClockDeadlines[I];
       }
       continue;
     }
-    case __WASI_EVENTTYPE_FD_READ: {
+    case __WASI_EVENTTYPE_FD_READ:
+    case __WASI_EVENTTYPE_FD_WRITE: {
+      const bool IsRead = Subscription.type == __WASI_EVENTTYPE_FD_READ;
       const int Fd = Subscription.u.fd_readwrite.fd;
       const auto Entry = Env.getFile(Fd);
-      if (unlikely(Entry == Env.getFileEnd())) {
-        RecordFdError(Subscription, __WASI_EBADF);
+      if (unlikely(Entry == nullptr)) {
+        Record(I, __WASI_EBADF);
         continue;
       }
-      if (unlikely(!Entry->checkRights(__WASI_RIGHT_POLL_FD_READWRITE |
-                                       __WASI_RIGHT_FD_READ))) {
-        RecordFdError(Subscription, __WASI_ENOTCAPABLE);
+      if (unlikely(!Entry->checkRights(
+              __WASI_RIGHT_POLL_FD_READWRITE |
+              (IsRead ? __WASI_RIGHT_FD_READ : __WASI_RIGHT_FD_WRITE)))) {
+        Record(I, __WASI_ENOTCAPABLE);
         continue;
       }
-      if (unlikely(!Event.AddFd(Fd, &Subscription, true))) {
-        RecordFdError(Subscription, convertErrNo(errno));
+      /// Virtual files are always ready.
+      if (Entry->isVirtual()) {
+        __wasi_filestat_t Stat;
+        Entry->Node->stat(Stat);
+        Record(I, __WASI_ESUCCESS,
+               IsRead && Stat.st_size > Entry->Offset
+                   ? Stat.st_size - Entry->Offset
+                   : 0);
         continue;
       }
-      continue;
-    }
-    case __WASI_EVENTTYPE_FD_WRITE: {
-      const int Fd = Subscription.u.fd_readwrite.fd;
-      const auto Entry = Env.getFile(Fd);
-      if (unlikely(Entry == Env.getFileEnd())) {
-        RecordFdError(Subscription, __WASI_EBADF);
-        continue;
-      }
-      if (unlikely(!Entry->checkRights(__WASI_RIGHT_POLL_FD_READWRITE |
-                                       __WASI_RIGHT_FD_WRITE))) {
-        RecordFdError(Subscription, __WASI_ENOTCAPABLE);
-        continue;
-      }
-      if (unlikely(!Event.AddFd(Fd, &Subscription, false))) {
-        RecordFdError(Subscription, convertErrNo(errno));
+      if (unlikely(!Poll->watch(Fd, (IsRead ? EPOLLIN : EPOLLOUT) |
+                                        EPOLLRDHUP))) {
+        /// Regular files can not be polled, and are always ready.
+        if (errno == EPERM) {
+          Record(I, __WASI_ESUCCESS);
+        } else {
+          Record(I, convertErrNo(errno));
+        }
         continue;
       }
+      HasFd = true;
       continue;
     }
     default:
@@ -1976,30 +2357,55 @@ WasiPollOneoff::body(Runtime::Instance::MemoryInstance &MemInst, uint32_t InPtr,
     }
   }
 
-  if (unlikely(!Event.Wait())) {
-    return convertErrNo(errno);
+  /// Do not block if there are already events to report.
+  if (*NEvents > 0) {
+    Deadline = Now;
   }
 
-  for (const epoll_event &SysEvent : Event.Events) {
-    if (SysEvent.data.ptr) {
-      const __wasi_subscription_t &Subscription =
-          *static_cast<__wasi_subscription_t *>(SysEvent.data.ptr);
-
-      __wasi_eventrwflags_t flags = 0;
-      if (SysEvent.events & EPOLLHUP) {
-        flags |= __WASI_EVENT_FD_READWRITE_HANGUP;
-      }
+  static thread_local std::vector<epoll_event> SysEvents;
+  if (HasFd) {
+    if (unlikely(!Poll->wait(Deadline, Now, SysEvents))) {
+      return convertErrNo(errno);
+    }
+  } else if (Deadline > Now) {
+    /// Only clocks are polled, so simply sleep until the nearest deadline.
+    const timespec SysDeadline = timestamp2Timespec(Deadline);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &SysDeadline,
+                           nullptr) == EINTR) {
+    }
+    SysEvents.clear();
+  } else {
+    SysEvents.clear();
+  }
 
-      int NBytes = 0;
-      ioctl(Subscription.u.fd_readwrite.fd, FIONREAD, &NBytes);
+  clock_gettime(CLOCK_MONOTONIC, &SysNow);
+  const int64_t End = timespec2Timestamp(SysNow);
+  for (uint32_t I = 0; I < NSubscriptions; ++I) {
+    if (ClockDeadlines[I] != kNoDeadline && ClockDeadlines[I] <= End) {
+      Record(I, __WASI_ESUCCESS);
+    }
+  }
 
-      RecordFd(Subscription, NBytes, flags);
-    } else {
-      signalfd_siginfo SigInfo;
-      while (read(Event.SignalFd, &SigInfo, sizeof(SigInfo)) > 0) {
-        const __wasi_subscription_t &Subscription =
-            *reinterpret_cast<__wasi_subscription_t *>(SigInfo.ssi_ptr);
-        RecordClock(Subscription);
+  for (const epoll_event &SysEvent : SysEvents) {
+    __wasi_eventrwflags_t Flags = 0;
+    if (SysEvent.events & (EPOLLHUP | EPOLLRDHUP)) {
+      Flags |= __WASI_EVENT_FD_READWRITE_HANGUP;
+    }
+    const bool Readable = SysEvent.events & (EPOLLIN | EPOLLHUP | EPOLLERR);
+    const bool Writable = SysEvent.events & (EPOLLOUT | EPOLLHUP | EPOLLERR);
+    for (uint32_t I = 0; I < NSubscriptions; ++I) {
+      const __wasi_subscription_t &Subscription = SubscriptionArray[I];
+      if (Recorded[I] || Subscription.type == __WASI_EVENTTYPE_CLOCK ||
+          Subscription.u.fd_readwrite.fd !=
+              static_cast<__wasi_fd_t>(SysEvent.data.fd)) {
+        continue;
+      }
+      if (Subscription.type == __WASI_EVENTTYPE_FD_READ && Readable) {
+        int NBytes = 0;
+        ioctl(SysEvent.data.fd, FIONREAD, &NBytes);
+        Record(I, __WASI_ESUCCESS, NBytes, Flags);
+      } else if (Subscription.type == __WASI_EVENTTYPE_FD_WRITE && Writable) {
+        Record(I, __WASI_ESUCCESS, 0, Flags);
       }
     }
   }
@@ -2009,6 +2415,7 @@ WasiPollOneoff::body(Runtime::Instance::MemoryInstance &MemInst, uint32_t InPtr,
 
 Expect<void> WasiProcExit::body(Runtime::Instance::MemoryInstance &MemInst,
                                 int32_t Status) {
+  Env.flushWriteBuffer();
   Env.setStatus(Status);
   return Unexpect(ErrCode::Terminated);
 }
@@ -2029,16 +2436,10 @@ Expect<uint32_t> WasiRandomGet::body(Runtime::Instance::MemoryInstance &MemInst,
   if (unlikely(Buf == nullptr)) {
     return __WASI_EFAULT;
   }
-  Span<uint8_t> BufSpan(Buf, BufLen);
-
-  /// Use uniform distribution to generate random bytes array
-  std::random_device RandomDevice;
-  std::mt19937 Generator(RandomDevice());
-  std::uniform_int_distribution<> Distribution(
-      std::numeric_limits<uint8_t>::min(), std::numeric_limits<uint8_t>::max());
-  std::generate(BufSpan.begin(), BufSpan.end(), [&Generator, &Distribution] {
-    return Distribution(Generator);
-  });
+  if (unlikely(!Env.getRandom().generate(Buf, BufLen))) {
+    return convertErrNo(errno);
+  }
+  Stats.addBytesIn(BufLen);
 
   return __WASI_ESUCCESS;
 }
@@ -2071,7 +2472,7 @@ Expect<uint32_t> WasiSockRecv::body(Runtime::Instance::MemoryInstance &MemInst,
   }
 
   const auto Entry = Env.getFile(Fd);
-  if (unlikely(Entry == Env.getFileEnd())) {
+  if (unlikely(Entry == nullptr)) {
     return __WASI_EBADF;
   }
 
@@ -2143,6 +2544,7 @@ Expect<uint32_t> WasiSockRecv::body(Runtime::Instance::MemoryInstance &MemInst,
   if (unlikely(*RoDataLen < 0)) {
     return convertErrNo(errno);
   }
+  Stats.addBytesIn(*RoDataLen);
 
   return __WASI_ESUCCESS;
 }
@@ -2157,7 +2559,7 @@ Expect<uint32_t> WasiSockSend::body(Runtime::Instance::MemoryInstance &MemInst,
   }
 
   const auto Entry = Env.getFile(Fd);
-  if (unlikely(Entry == Env.getFileEnd())) {
+  if (unlikely(Entry == nullptr)) {
     return __WASI_EBADF;
   }
 
@@ -2214,6 +2616,7 @@ Expect<uint32_t> WasiSockSend::body(Runtime::Instance::MemoryInstance &MemInst,
   if (unlikely(*SoDataLen < 0)) {
     return convertErrNo(errno);
   }
+  Stats.addBytesOut(*SoDataLen);
 
   return __WASI_ESUCCESS;
 }
@@ -2237,7 +2640,7 @@ WasiSockShutdown::body(Runtime::Instance::MemoryInstance &MemInst, int32_t Fd,
   }
 
   const auto Entry = Env.getFile(Fd);
-  if (unlikely(Entry == Env.getFileEnd())) {
+  if (unlikely(Entry == nullptr)) {
     return __WASI_EBADF;
   }
 
@@ -2252,5 +2655,112 @@ WasiSockShutdown::body(Runtime::Instance::MemoryInstance &MemInst, int32_t Fd,
   return __WASI_ESUCCESS;
 }
 
+Expect<uint32_t> WasiFdCopy::body(Runtime::Instance::MemoryInstance &MemInst,
+                                  int32_t Src, int32_t Dst, uint64_t Len,
+                                  uint32_t NCopiedPtr) {
+  const auto SrcEntry = Env.getFile(Src);
+  const auto DstEntry = Env.getFile(Dst);
+  if (unlikely(SrcEntry == nullptr || DstEntry == nullptr)) {
+    return __WASI_EBADF;
+  }
+
+  if (unlikely(!SrcEntry->checkRights(__WASI_RIGHT_FD_READ) ||
+               !DstEntry->checkRights(__WASI_RIGHT_FD_WRITE))) {
+    return __WASI_ENOTCAPABLE;
+  }
+
+  __wasi_filesize_t *const NCopied =
+      MemInst.getPointer<__wasi_filesize_t *>(NCopiedPtr);
+  if (unlikely(NCopied == nullptr)) {
+    return __WASI_EFAULT;
+  }
+
+  /// Keep the order with the buffered output.
+  if (Env.isWriteBuffered(Dst) && unlikely(!Env.flushWriteBuffer())) {
+    return convertErrNo(errno);
+  }
+
+  CopyMethod Method = CopyMethod::Buffer;
+  if (!SrcEntry->isVirtual() && !DstEntry->isVirtual()) {
+    Method = selectCopyMethod(Src, Dst);
+  }
+
+  /// Large enough to be cheap per byte, and small enough for the stack.
+  constexpr const size_t kBufferSize = 16384;
+  constexpr const size_t kChunkSize = 1 << 30;
+  uint8_t Buffer[kBufferSize];
+  uint64_t Copied = 0;
+  while (Copied < Len) {
+    if (Method != CopyMethod::Buffer) {
+      const size_t Chunk = std::min<uint64_t>(Len - Copied, kChunkSize);
+      const ssize_t Res = copyInKernel(Method, Src, Dst, Chunk);
+      if (unlikely(Res < 0)) {
+        if (errno == EINTR) {
+          continue;
+        }
+        /// The pair of files is not supported by this way, try the next one.
+        /// copy_file_range also fails with EBADF on an append-only
+        /// destination, which the plain writes support.
+        if (errno == EINVAL || errno == ENOSYS || errno == EXDEV ||
+            errno == EOPNOTSUPP || errno == EBADF) {
+          Method = Method == CopyMethod::CopyFileRange ? CopyMethod::SendFile
+                                                       : CopyMethod::Buffer;
+          continue;
+        }
+        if (Copied > 0) {
+          break;
+        }
+        return convertErrNo(errno);
+      }
+      Copied += Res;
+      if (static_cast<size_t>(Res) < Chunk) {
+        break;
+      }
+      continue;
+    }
+
+    const size_t Chunk = std::min<uint64_t>(Len - Copied, kBufferSize);
+    uint64_t NRead = 0;
+    if (const auto Error = readFile(*SrcEntry, Buffer, Chunk, NRead);
+        unlikely(Error != __WASI_ESUCCESS)) {
+      if (Copied > 0) {
+        break;
+      }
+      return Error;
+    }
+    /// The data is already consumed from the source, so write all of it, and
+    /// stop when the destination makes no progress.
+    uint64_t Written = 0;
+    __wasi_errno_t Error = __WASI_ESUCCESS;
+    while (Written < NRead) {
+      uint64_t NWritten = 0;
+      Error = writeFile(*DstEntry, Buffer + Written, NRead - Written, NWritten);
+      if (unlikely(Error == __WASI_EINTR)) {
+        continue;
+      }
+      if (unlikely(Error != __WASI_ESUCCESS || NWritten == 0)) {
+        break;
+      }
+      Written += NWritten;
+    }
+    Copied += Written;
+    if (unlikely(Written < NRead)) {
+      /// Give the unwritten data back to the source, and report the copied
+      /// part.
+      unreadFile(*SrcEntry, NRead - Written);
+      if (Copied == 0 && Error != __WASI_ESUCCESS) {
+        return Error;
+      }
+      break;
+    }
+    if (NRead < Chunk) {
+      break;
+    }
+  }
+
+  *NCopied = Copied;
+  return __WASI_ESUCCESS;
+}
+
 } // namespace Host
 } // namespace SSVM
@@ -0,0 +1,26 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "host/wasi/wasithreadsmodule.h"
+
+#include <memory>
+
+namespace SSVM {
+namespace Host {
+
+Expect<int32_t>
+WasiThreadSpawn::body(Runtime::Instance::MemoryInstance &MemInst,
+                      uint32_t StartArg) {
+  if (!Spawner || !MemInst.isShared()) {
+    return -1;
+  }
+  if (auto Res = Spawner(StartArg); Res && *Res <= INT32_MAX) {
+    return static_cast<int32_t>(*Res);
+  }
+  return -1;
+}
+
+WasiThreadsModule::WasiThreadsModule() : ImportObject("wasi") {
+  addHostFunc("thread-spawn", std::make_unique<WasiThreadSpawn>(Spawner));
+}
+
+} // namespace Host
+} // namespace SSVM
@@ -8,41 +8,41 @@ namespace SSVM {
 namespace Interpreter {
 
 Expect<void>
-Interpreter::runBlockOp(const AST::BlockControlInstruction &Instr) {
-  /// Get result type for arity.
-  const ValType ResultType = Instr.getResultType();
-  uint32_t Arity = (ResultType == ValType::None) ? 0 : 1;
+Interpreter::runBlockOp(Runtime::StoreManager &StoreMgr,
+                        const AST::BlockControlInstruction &Instr) {
+  /// Get block type for arity.
+  const auto [Arity, Coarity] = getBlockArity(StoreMgr, Instr.getBlockType());
 
   /// Create Label{ nothing } and push.
-  return enterBlock(Arity, nullptr, Instr.getBody());
+  return enterBlock(Arity, Coarity, nullptr, Instr.getBody());
 }
 
-Expect<void> Interpreter::runLoopOp(const AST::BlockControlInstruction &Instr) {
-  /// Get result type for arity.
-  const ValType ResultType = Instr.getResultType();
-  uint32_t Arity = (ResultType == ValType::None) ? 0 : 1;
+Expect<void> Interpreter::runLoopOp(Runtime::StoreManager &StoreMgr,
+                                    const AST::BlockControlInstruction &Instr) {
+  /// Get block type for arity. Branching to loop passes the parameters.
+  const uint32_t Arity = getBlockArity(StoreMgr, Instr.getBlockType()).first;
 
   /// Create Label{ loop-instruction } and push.
-  return enterBlock(Arity, &Instr, Instr.getBody());
+  return enterBlock(Arity, Arity, &Instr, Instr.getBody());
 }
 
 Expect<void>
-Interpreter::runIfElseOp(const AST::IfElseControlInstruction &Instr) {
-  /// Get condition and result type for arity.
+Interpreter::runIfElseOp(Runtime::StoreManager &StoreMgr,
+                         const AST::IfElseControlInstruction &Instr) {
+  /// Get condition and block type for arity.
   ValVariant Cond = StackMgr.pop();
-  ValType ResultType = Instr.getResultType();
-  uint32_t Arity = (ResultType == ValType::None) ? 0 : 1;
+  const auto [Arity, Coarity] = getBlockArity(StoreMgr, Instr.getBlockType());
 
   /// If non-zero, run if-statement; else, run else-statement.
   if (retrieveValue<uint32_t>(Cond) != 0) {
     const auto &IfStatement = Instr.getIfStatement();
     if (!IfStatement.empty()) {
-      return enterBlock(Arity, nullptr, IfStatement);
+      return enterBlock(Arity, Coarity, nullptr, IfStatement);
     }
   } else {
     const auto &ElseStatement = Instr.getElseStatement();
     if (!ElseStatement.empty()) {
-      return enterBlock(Arity, nullptr, ElseStatement);
+      return enterBlock(Arity, Coarity, nullptr, ElseStatement);
     }
   }
   return {};
@@ -81,6 +81,9 @@ Expect<void> Interpreter::runCallOp(Runtime::StoreManager &StoreMgr,
   const auto *ModInst = *StoreMgr.getModule(StackMgr.getModuleAddr());
   const uint32_t FuncAddr = *ModInst->getFuncAddr(Instr.getFuncIndex());
   const auto *FuncInst = *StoreMgr.getFunction(FuncAddr);
+  if (Instr.getOpCode() == OpCode::Return_call) {
+    return tailCallFunction(StoreMgr, *FuncInst);
+  }
   return enterFunction(StoreMgr, *FuncInst);
 }
 
@@ -88,7 +91,7 @@ Expect<void>
 Interpreter::runCallIndirectOp(Runtime::StoreManager &StoreMgr,
                                const AST::CallControlInstruction &Instr) {
   /// Get Table Instance
-  const auto *TabInst = getTabInstByIdx(StoreMgr, 0);
+  const auto *TabInst = getTabInstByIdx(StoreMgr, Instr.getTableIndex());
 
   /// Get function type at index x.
   const auto *ModInst = *StoreMgr.getModule(StackMgr.getModuleAddr());
@@ -112,6 +115,9 @@ Interpreter::runCallIndirectOp(Runtime::StoreManager &StoreMgr,
       TargetFuncType->Returns != FuncType.Returns) {
     return Unexpect(ErrCode::IndirectCallTypeMismatch);
   }
+  if (Instr.getOpCode() == OpCode::Return_call_indirect) {
+    return tailCallFunction(StoreMgr, *FuncInst);
+  }
   return enterFunction(StoreMgr, *FuncInst);
 }
 
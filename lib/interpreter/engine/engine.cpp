@@ -6,6 +6,9 @@
 #include "support/log.h"
 #include "support/measure.h"
 
+#include <atomic>
+#include <chrono>
+
 namespace SSVM {
 namespace Interpreter {
 
@@ -26,6 +29,92 @@ uint32_t Interpreter::memSizeProxy(Interpreter *This) {
   return This->memSize();
 }
 
+void Interpreter::memInitProxy(Interpreter *This, const uint32_t DataIdx,
+                               const uint32_t Dst, const uint32_t Src,
+                               const uint32_t Len) {
+  This->memInit(DataIdx, Dst, Src, Len);
+}
+
+void Interpreter::dataDropProxy(Interpreter *This, const uint32_t DataIdx) {
+  This->dataDrop(DataIdx);
+}
+
+uint32_t Interpreter::tableSizeProxy(Interpreter *This,
+                                     const uint32_t TableIdx) {
+  return This->tableSize(TableIdx);
+}
+
+uint32_t Interpreter::tableGrowProxy(Interpreter *This,
+                                     const uint32_t TableIdx,
+                                     const uint64_t Ref, const uint32_t Count) {
+  return This->tableGrow(TableIdx, Ref, Count);
+}
+
+uint64_t Interpreter::tableGetProxy(Interpreter *This, const uint32_t TableIdx,
+                                    const uint32_t Idx) {
+  return This->tableGet(TableIdx, Idx);
+}
+
+void Interpreter::tableSetProxy(Interpreter *This, const uint32_t TableIdx,
+                                const uint32_t Idx, const uint64_t Ref) {
+  This->tableSet(TableIdx, Idx, Ref);
+}
+
+void Interpreter::tableFillProxy(Interpreter *This, const uint32_t TableIdx,
+                                 const uint32_t Off, const uint64_t Ref,
+                                 const uint32_t Len) {
+  This->tableFill(TableIdx, Off, Ref, Len);
+}
+
+void Interpreter::tableInitProxy(Interpreter *This, const uint32_t TableIdx,
+                                 const uint32_t ElemIdx, const uint32_t Dst,
+                                 const uint32_t Src, const uint32_t Len) {
+  This->tableInit(TableIdx, ElemIdx, Dst, Src, Len);
+}
+
+void Interpreter::tableCopyProxy(Interpreter *This, const uint32_t TableIdxDst,
+                                 const uint32_t TableIdxSrc,
+                                 const uint32_t Dst, const uint32_t Src,
+                                 const uint32_t Len) {
+  This->tableCopy(TableIdxDst, TableIdxSrc, Dst, Src, Len);
+}
+
+void Interpreter::elemDropProxy(Interpreter *This, const uint32_t ElemIdx) {
+  This->elemDrop(ElemIdx);
+}
+
+uint64_t Interpreter::refFuncProxy(Interpreter *This, const uint32_t FuncIdx) {
+  return This->refFunc(FuncIdx);
+}
+
+uint32_t Interpreter::tableGetFuncIdxProxy(Interpreter *This,
+                                           const uint32_t TableIdx,
+                                           const uint32_t FuncTypeIdx,
+                                           const uint32_t Idx) {
+  return This->tableGetFuncIdx(TableIdx, FuncTypeIdx, Idx);
+}
+
+void Interpreter::callIndirectProxy(Interpreter *This, const uint32_t TableIdx,
+                                    const uint32_t FuncTypeIdx,
+                                    const uint32_t Idx, const ValVariant *Args,
+                                    ValVariant *Rets) {
+  This->callIndirect(TableIdx, FuncTypeIdx, Idx, Args, Rets);
+}
+
+uint32_t Interpreter::memAtomicNotifyProxy(Interpreter *This,
+                                           const uint64_t Address,
+                                           const uint32_t Count) {
+  return This->memAtomicNotify(Address, Count);
+}
+
+uint32_t Interpreter::memAtomicWaitProxy(Interpreter *This,
+                                         const uint64_t Address,
+                                         const uint64_t Expected,
+                                         const int64_t Timeout,
+                                         const uint32_t BitWidth) {
+  return This->memAtomicWait(Address, Expected, Timeout, BitWidth);
+}
+
 void Interpreter::trap(uint32_t Status) { std::longjmp(TrapJump, Status); }
 
 void Interpreter::call(const uint32_t FuncIndex, const ValVariant *Args,
@@ -64,6 +153,198 @@ uint32_t Interpreter::memSize() {
   return MemInst.getDataPageSize();
 }
 
+void Interpreter::memInit(const uint32_t DataIdx, const uint32_t Dst,
+                          const uint32_t Src, const uint32_t Len) {
+  auto &MemInst = *getMemInstByIdx(*CurrentStore, 0);
+  const auto *ModInst = *CurrentStore->getModule(StackMgr.getModuleAddr());
+  const auto Data = *ModInst->getData(DataIdx);
+  if (auto Res = MemInst.setBytes(Data, Dst, Src, Len); !Res) {
+    std::longjmp(TrapJump, uint32_t(Res.error()));
+  }
+}
+
+void Interpreter::dataDrop(const uint32_t DataIdx) {
+  auto *ModInst = *CurrentStore->getModule(StackMgr.getModuleAddr());
+  ModInst->dropData(DataIdx);
+}
+
+uint32_t Interpreter::tableSize(const uint32_t TableIdx) {
+  return getTabInstByIdx(*CurrentStore, TableIdx)->getSize();
+}
+
+uint32_t Interpreter::tableGrow(const uint32_t TableIdx, const uint64_t Ref,
+                                const uint32_t Count) {
+  auto &TabInst = *getTabInstByIdx(*CurrentStore, TableIdx);
+  const uint32_t OldSize = TabInst.getSize();
+  if (TabInst.growTable(Count, UnknownRef{Ref})) {
+    return OldSize;
+  } else {
+    return -1;
+  }
+}
+
+uint64_t Interpreter::tableGet(const uint32_t TableIdx, const uint32_t Idx) {
+  auto &TabInst = *getTabInstByIdx(*CurrentStore, TableIdx);
+  if (auto Res = TabInst.getRef(Idx)) {
+    return retrieveValue<UnknownRef>(*Res).Value;
+  } else {
+    std::longjmp(TrapJump, uint32_t(Res.error()));
+  }
+}
+
+void Interpreter::tableSet(const uint32_t TableIdx, const uint32_t Idx,
+                           const uint64_t Ref) {
+  auto &TabInst = *getTabInstByIdx(*CurrentStore, TableIdx);
+  if (auto Res = TabInst.setRef(Idx, UnknownRef{Ref}); !Res) {
+    std::longjmp(TrapJump, uint32_t(Res.error()));
+  }
+}
+
+void Interpreter::tableFill(const uint32_t TableIdx, const uint32_t Off,
+                            const uint64_t Ref, const uint32_t Len) {
+  auto &TabInst = *getTabInstByIdx(*CurrentStore, TableIdx);
+  if (auto Res = TabInst.fillElems(Off, UnknownRef{Ref}, Len); !Res) {
+    std::longjmp(TrapJump, uint32_t(Res.error()));
+  }
+}
+
+void Interpreter::tableInit(const uint32_t TableIdx, const uint32_t ElemIdx,
+                            const uint32_t Dst, const uint32_t Src,
+                            const uint32_t Len) {
+  auto &TabInst = *getTabInstByIdx(*CurrentStore, TableIdx);
+  const auto *ModInst = *CurrentStore->getModule(StackMgr.getModuleAddr());
+  const auto Elem = *ModInst->getElem(ElemIdx);
+  if (auto Res = TabInst.setElems(Dst, Elem, Src, Len); !Res) {
+    std::longjmp(TrapJump, uint32_t(Res.error()));
+  }
+}
+
+void Interpreter::tableCopy(const uint32_t TableIdxDst,
+                            const uint32_t TableIdxSrc, const uint32_t Dst,
+                            const uint32_t Src, const uint32_t Len) {
+  auto &TabInstDst = *getTabInstByIdx(*CurrentStore, TableIdxDst);
+  const auto &TabInstSrc = *getTabInstByIdx(*CurrentStore, TableIdxSrc);
+  if (auto Res = TabInstDst.copyElems(Dst, TabInstSrc, Src, Len); !Res) {
+    std::longjmp(TrapJump, uint32_t(Res.error()));
+  }
+}
+
+void Interpreter::elemDrop(const uint32_t ElemIdx) {
+  auto *ModInst = *CurrentStore->getModule(StackMgr.getModuleAddr());
+  ModInst->dropElem(ElemIdx);
+}
+
+uint64_t Interpreter::refFunc(const uint32_t FuncIdx) {
+  const auto *ModInst = *CurrentStore->getModule(StackMgr.getModuleAddr());
+  const ValVariant Ref = genFuncRef(*ModInst->getFuncAddr(FuncIdx));
+  return retrieveValue<UnknownRef>(Ref).Value;
+}
+
+uint32_t Interpreter::getIndirectFuncAddr(const uint32_t TableIdx,
+                                          const uint32_t FuncTypeIdx,
+                                          const uint32_t Idx) {
+  const auto *TabInst = getTabInstByIdx(*CurrentStore, TableIdx);
+  const auto *ModInst = *CurrentStore->getModule(StackMgr.getModuleAddr());
+  uint32_t FuncAddr;
+  if (auto Res = TabInst->getElemAddr(Idx)) {
+    FuncAddr = *Res;
+  } else {
+    std::longjmp(TrapJump, uint32_t(Res.error()));
+  }
+  const auto *TargetFuncType = *ModInst->getFuncType(FuncTypeIdx);
+  const auto &FuncType = (*CurrentStore->getFunction(FuncAddr))->getFuncType();
+  if (TargetFuncType->Params != FuncType.Params ||
+      TargetFuncType->Returns != FuncType.Returns) {
+    std::longjmp(TrapJump, uint32_t(ErrCode::IndirectCallTypeMismatch));
+  }
+  return FuncAddr;
+}
+
+uint32_t Interpreter::tableGetFuncIdx(const uint32_t TableIdx,
+                                      const uint32_t FuncTypeIdx,
+                                      const uint32_t Idx) {
+  const uint32_t FuncAddr = getIndirectFuncAddr(TableIdx, FuncTypeIdx, Idx);
+  const auto *ModInst = *CurrentStore->getModule(StackMgr.getModuleAddr());
+  const auto *FuncInst = *CurrentStore->getFunction(FuncAddr);
+  if (!FuncInst->isHostFunction() &&
+      FuncInst->getModuleAddr() == ModInst->Addr) {
+    if (auto FuncIdx = ModInst->getDefinedFuncIdx(FuncAddr)) {
+      return *FuncIdx;
+    }
+  }
+  return UINT32_MAX;
+}
+
+void Interpreter::callIndirect(const uint32_t TableIdx,
+                               const uint32_t FuncTypeIdx, const uint32_t Idx,
+                               const ValVariant *Args, ValVariant *Rets) {
+  const uint32_t FuncAddr = getIndirectFuncAddr(TableIdx, FuncTypeIdx, Idx);
+  const auto *FuncInst = *CurrentStore->getFunction(FuncAddr);
+  const auto &FuncType = FuncInst->getFuncType();
+  const unsigned ParamsSize = FuncType.Params.size();
+  const unsigned ReturnsSize = FuncType.Returns.size();
+
+  ErrCode Status = ErrCode::Success;
+  if (FuncInst->isHostFunction()) {
+    /// Host functions access the memory of the calling module.
+    for (unsigned I = 0; I < ParamsSize; ++I) {
+      StackMgr.push(Args[I]);
+    }
+    if (auto Res = enterFunction(*CurrentStore, *FuncInst)) {
+      for (unsigned I = 0; I < ReturnsSize; ++I) {
+        Rets[ReturnsSize - 1 - I] = StackMgr.pop();
+      }
+    } else {
+      Status = Res.error();
+    }
+  } else {
+    /// A function of another module runs on a nested engine, which executes
+    /// its body regardless of being compiled or not.
+    Interpreter Engine;
+    if (auto Res = Engine.invoke(*CurrentStore, FuncAddr,
+                                 std::vector<ValVariant>(Args,
+                                                         Args + ParamsSize))) {
+      std::copy_n(Res->begin(), ReturnsSize, Rets);
+    } else {
+      Status = Res.error();
+    }
+  }
+  if (Status != ErrCode::Success) {
+    std::longjmp(TrapJump, uint32_t(Status));
+  }
+}
+
+uint32_t Interpreter::memAtomicNotify(const uint64_t Address,
+                                      const uint32_t Count) {
+  auto &MemInst = *getMemInstByIdx(*CurrentStore, 0);
+  if (Address > UINT32_MAX) {
+    std::longjmp(TrapJump, uint32_t(ErrCode::MemoryOutOfBounds));
+  }
+  if (auto Res = MemInst.atomicNotify(Address, Count)) {
+    return *Res;
+  } else {
+    std::longjmp(TrapJump, uint32_t(Res.error()));
+  }
+}
+
+uint32_t Interpreter::memAtomicWait(const uint64_t Address,
+                                    const uint64_t Expected,
+                                    const int64_t Timeout,
+                                    const uint32_t BitWidth) {
+  auto &MemInst = *getMemInstByIdx(*CurrentStore, 0);
+  if (Address > UINT32_MAX) {
+    std::longjmp(TrapJump, uint32_t(ErrCode::MemoryOutOfBounds));
+  }
+  auto Res = (BitWidth == 64)
+                 ? MemInst.atomicWait<uint64_t>(Address, Expected, Timeout)
+                 : MemInst.atomicWait<uint32_t>(
+                       Address, static_cast<uint32_t>(Expected), Timeout);
+  if (!Res) {
+    std::longjmp(TrapJump, uint32_t(Res.error()));
+  }
+  return *Res;
+}
+
 Expect<void> Interpreter::runExpression(Runtime::StoreManager &StoreMgr,
                                         const AST::InstrVec &Instrs) {
   /// Set instruction vector to instruction provider.
@@ -151,9 +432,9 @@ Expect<void> Interpreter::execute(Runtime::StoreManager &StoreMgr,
                                   const AST::BlockControlInstruction &Instr) {
   switch (Instr.getOpCode()) {
   case OpCode::Block:
-    return runBlockOp(Instr);
+    return runBlockOp(StoreMgr, Instr);
   case OpCode::Loop:
-    return runLoopOp(Instr);
+    return runLoopOp(StoreMgr, Instr);
   default:
     return Unexpect(ErrCode::InstrTypeMismatch);
   }
@@ -163,7 +444,7 @@ Expect<void> Interpreter::execute(Runtime::StoreManager &StoreMgr,
                                   const AST::IfElseControlInstruction &Instr) {
   switch (Instr.getOpCode()) {
   case OpCode::If:
-    return runIfElseOp(Instr);
+    return runIfElseOp(StoreMgr, Instr);
   default:
     return Unexpect(ErrCode::InstrTypeMismatch);
   }
@@ -195,8 +476,10 @@ Expect<void> Interpreter::execute(Runtime::StoreManager &StoreMgr,
                                   const AST::CallControlInstruction &Instr) {
   switch (Instr.getOpCode()) {
   case OpCode::Call:
+  case OpCode::Return_call:
     return runCallOp(StoreMgr, Instr);
   case OpCode::Call_indirect:
+  case OpCode::Return_call_indirect:
     return runCallIndirectOp(StoreMgr, Instr);
   default:
     return Unexpect(ErrCode::InstrTypeMismatch);
@@ -209,7 +492,8 @@ Expect<void> Interpreter::execute(Runtime::StoreManager &StoreMgr,
   case OpCode::Drop:
     StackMgr.pop();
     return {};
-  case OpCode::Select: {
+  case OpCode::Select:
+  case OpCode::Select_t: {
     /// Pop the i32 value and select values from stack.
     ValVariant CondVal = StackMgr.pop();
     ValVariant Val2 = StackMgr.pop();
@@ -304,6 +588,61 @@ Expect<void> Interpreter::execute(Runtime::StoreManager &StoreMgr,
     return runMemoryGrowOp(*MemInst);
   case OpCode::Memory__size:
     return runMemorySizeOp(*MemInst);
+  case OpCode::Memory__init:
+    return runMemoryInitOp(StoreMgr, *MemInst, Instr);
+  case OpCode::Data__drop:
+    return runDataDropOp(StoreMgr, Instr);
+  case OpCode::Memory__copy:
+    return runMemoryCopyOp(*MemInst);
+  case OpCode::Memory__fill:
+    return runMemoryFillOp(*MemInst);
+  default:
+    return Unexpect(ErrCode::InstrTypeMismatch);
+  }
+}
+
+Expect<void> Interpreter::execute(Runtime::StoreManager &StoreMgr,
+                                  const AST::TableInstruction &Instr) {
+  switch (Instr.getOpCode()) {
+  case OpCode::Table__init:
+    return runTableInitOp(
+        StoreMgr, *getTabInstByIdx(StoreMgr, Instr.getTargetIndex()), Instr);
+  case OpCode::Elem__drop:
+    return runElemDropOp(StoreMgr, Instr);
+  case OpCode::Table__copy:
+    return runTableCopyOp(*getTabInstByIdx(StoreMgr, Instr.getTargetIndex()),
+                          *getTabInstByIdx(StoreMgr, Instr.getSourceIndex()));
+  case OpCode::Table__get:
+    return runTableGetOp(*getTabInstByIdx(StoreMgr, Instr.getTargetIndex()));
+  case OpCode::Table__set:
+    return runTableSetOp(*getTabInstByIdx(StoreMgr, Instr.getTargetIndex()));
+  case OpCode::Table__grow:
+    return runTableGrowOp(*getTabInstByIdx(StoreMgr, Instr.getTargetIndex()));
+  case OpCode::Table__size:
+    return runTableSizeOp(*getTabInstByIdx(StoreMgr, Instr.getTargetIndex()));
+  case OpCode::Table__fill:
+    return runTableFillOp(*getTabInstByIdx(StoreMgr, Instr.getTargetIndex()));
+  default:
+    return Unexpect(ErrCode::InstrTypeMismatch);
+  }
+}
+
+Expect<void> Interpreter::execute(Runtime::StoreManager &StoreMgr,
+                                  const AST::ReferenceInstruction &Instr) {
+  switch (Instr.getOpCode()) {
+  case OpCode::Ref__null:
+    StackMgr.push(genNullRef());
+    return {};
+  case OpCode::Ref__is_null: {
+    ValVariant &Val = StackMgr.getTop();
+    Val = uint32_t(isNullRef(Val) ? 1U : 0U);
+    return {};
+  }
+  case OpCode::Ref__func: {
+    const auto *ModInst = *StoreMgr.getModule(StackMgr.getModuleAddr());
+    StackMgr.push(genFuncRef(*ModInst->getFuncAddr(Instr.getFuncIndex())));
+    return {};
+  }
   default:
     return Unexpect(ErrCode::InstrTypeMismatch);
   }
@@ -581,6 +920,531 @@ Expect<void> Interpreter::execute(Runtime::StoreManager &StoreMgr,
   }
 }
 
+Expect<void> Interpreter::execute(Runtime::StoreManager &StoreMgr,
+                                  const AST::SIMDMemoryInstruction &Instr) {
+  auto *MemInst = getMemInstByIdx(StoreMgr, 0);
+  switch (Instr.getOpCode()) {
+  case OpCode::V128__load:
+    return runLoadZeroOp<uint128_t>(*MemInst, Instr);
+  case OpCode::V128__load8x8_s:
+    return runLoadExpandOp<int8_t, int16_t>(*MemInst, Instr);
+  case OpCode::V128__load8x8_u:
+    return runLoadExpandOp<uint8_t, uint16_t>(*MemInst, Instr);
+  case OpCode::V128__load16x4_s:
+    return runLoadExpandOp<int16_t, int32_t>(*MemInst, Instr);
+  case OpCode::V128__load16x4_u:
+    return runLoadExpandOp<uint16_t, uint32_t>(*MemInst, Instr);
+  case OpCode::V128__load32x2_s:
+    return runLoadExpandOp<int32_t, int64_t>(*MemInst, Instr);
+  case OpCode::V128__load32x2_u:
+    return runLoadExpandOp<uint32_t, uint64_t>(*MemInst, Instr);
+  case OpCode::V128__load8_splat:
+    return runLoadSplatOp<uint8_t>(*MemInst, Instr);
+  case OpCode::V128__load16_splat:
+    return runLoadSplatOp<uint16_t>(*MemInst, Instr);
+  case OpCode::V128__load32_splat:
+    return runLoadSplatOp<uint32_t>(*MemInst, Instr);
+  case OpCode::V128__load64_splat:
+    return runLoadSplatOp<uint64_t>(*MemInst, Instr);
+  case OpCode::V128__store:
+    return runStoreLaneOp<uint128_t>(*MemInst, Instr);
+  case OpCode::V128__load8_lane:
+    return runLoadLaneOp<uint8_t>(*MemInst, Instr);
+  case OpCode::V128__load16_lane:
+    return runLoadLaneOp<uint16_t>(*MemInst, Instr);
+  case OpCode::V128__load32_lane:
+    return runLoadLaneOp<uint32_t>(*MemInst, Instr);
+  case OpCode::V128__load64_lane:
+    return runLoadLaneOp<uint64_t>(*MemInst, Instr);
+  case OpCode::V128__store8_lane:
+    return runStoreLaneOp<uint8_t>(*MemInst, Instr);
+  case OpCode::V128__store16_lane:
+    return runStoreLaneOp<uint16_t>(*MemInst, Instr);
+  case OpCode::V128__store32_lane:
+    return runStoreLaneOp<uint32_t>(*MemInst, Instr);
+  case OpCode::V128__store64_lane:
+    return runStoreLaneOp<uint64_t>(*MemInst, Instr);
+  case OpCode::V128__load32_zero:
+    return runLoadZeroOp<uint32_t>(*MemInst, Instr);
+  case OpCode::V128__load64_zero:
+    return runLoadZeroOp<uint64_t>(*MemInst, Instr);
+  default:
+    return Unexpect(ErrCode::InstrTypeMismatch);
+  }
+}
+
+Expect<void> Interpreter::execute(Runtime::StoreManager &StoreMgr,
+                                  const AST::SIMDLaneInstruction &Instr) {
+  const uint8_t Index = Instr.getLaneIndex();
+  /// Extract lane instructions.
+  ValVariant &Val = StackMgr.getTop();
+  switch (Instr.getOpCode()) {
+  case OpCode::I8x16__extract_lane_s:
+    return runExtractLaneOp<int8_t, uint32_t>(Val, Index);
+  case OpCode::I8x16__extract_lane_u:
+    return runExtractLaneOp<uint8_t, uint32_t>(Val, Index);
+  case OpCode::I16x8__extract_lane_s:
+    return runExtractLaneOp<int16_t, uint32_t>(Val, Index);
+  case OpCode::I16x8__extract_lane_u:
+    return runExtractLaneOp<uint16_t, uint32_t>(Val, Index);
+  case OpCode::I32x4__extract_lane:
+    return runExtractLaneOp<uint32_t, uint32_t>(Val, Index);
+  case OpCode::I64x2__extract_lane:
+    return runExtractLaneOp<uint64_t, uint64_t>(Val, Index);
+  case OpCode::F32x4__extract_lane:
+    return runExtractLaneOp<float, float>(Val, Index);
+  case OpCode::F64x2__extract_lane:
+    return runExtractLaneOp<double, double>(Val, Index);
+  default:
+    break;
+  }
+
+  /// Replace lane instructions.
+  ValVariant Val2 = StackMgr.pop();
+  ValVariant &Val1 = StackMgr.getTop();
+  switch (Instr.getOpCode()) {
+  case OpCode::I8x16__replace_lane:
+    return runReplaceLaneOp<uint32_t, uint8_t>(Val1, Val2, Index);
+  case OpCode::I16x8__replace_lane:
+    return runReplaceLaneOp<uint32_t, uint16_t>(Val1, Val2, Index);
+  case OpCode::I32x4__replace_lane:
+    return runReplaceLaneOp<uint32_t, uint32_t>(Val1, Val2, Index);
+  case OpCode::I64x2__replace_lane:
+    return runReplaceLaneOp<uint64_t, uint64_t>(Val1, Val2, Index);
+  case OpCode::F32x4__replace_lane:
+    return runReplaceLaneOp<float, float>(Val1, Val2, Index);
+  case OpCode::F64x2__replace_lane:
+    return runReplaceLaneOp<double, double>(Val1, Val2, Index);
+  default:
+    return Unexpect(ErrCode::InstrTypeMismatch);
+  }
+}
+
+Expect<void> Interpreter::execute(Runtime::StoreManager &StoreMgr,
+                                  const AST::SIMDShuffleInstruction &Instr) {
+  ValVariant Val2 = StackMgr.pop();
+  ValVariant &Val1 = StackMgr.getTop();
+  return runShuffleOp(Val1, Val2, Instr.getShuffleLanes());
+}
+
+Expect<void> Interpreter::execute(Runtime::StoreManager &StoreMgr,
+                                  const AST::SIMDNumericInstruction &Instr) {
+  /// Unary and ternary instructions.
+  ValVariant &Val = StackMgr.getTop();
+  switch (Instr.getOpCode()) {
+  case OpCode::I8x16__splat:
+    return runSplatOp<uint32_t, uint8_t>(Val);
+  case OpCode::I16x8__splat:
+    return runSplatOp<uint32_t, uint16_t>(Val);
+  case OpCode::I32x4__splat:
+    return runSplatOp<uint32_t, uint32_t>(Val);
+  case OpCode::I64x2__splat:
+    return runSplatOp<uint64_t, uint64_t>(Val);
+  case OpCode::F32x4__splat:
+    return runSplatOp<float, float>(Val);
+  case OpCode::F64x2__splat:
+    return runSplatOp<double, double>(Val);
+  case OpCode::V128__not:
+    return runVectorNotOp(Val);
+  case OpCode::V128__any_true:
+    return runVectorAnyTrueOp(Val);
+  case OpCode::F32x4__demote_f64x2_zero:
+    return runVectorConvertOp<double, float>(Val);
+  case OpCode::F64x2__promote_low_f32x4:
+    return runVectorConvertOp<float, double>(Val);
+  case OpCode::I8x16__abs:
+    return runVectorAbsOp<int8_t>(Val);
+  case OpCode::I8x16__neg:
+    return runVectorNegOp<int8_t>(Val);
+  case OpCode::I8x16__popcnt:
+    return runVectorPopcntOp(Val);
+  case OpCode::I8x16__all_true:
+    return runVectorAllTrueOp<uint8_t>(Val);
+  case OpCode::I8x16__bitmask:
+    return runVectorBitMaskOp<int8_t>(Val);
+  case OpCode::F32x4__ceil:
+    return runVectorCeilOp<float>(Val);
+  case OpCode::F32x4__floor:
+    return runVectorFloorOp<float>(Val);
+  case OpCode::F32x4__trunc:
+    return runVectorTruncOp<float>(Val);
+  case OpCode::F32x4__nearest:
+    return runVectorNearestOp<float>(Val);
+  case OpCode::F64x2__ceil:
+    return runVectorCeilOp<double>(Val);
+  case OpCode::F64x2__floor:
+    return runVectorFloorOp<double>(Val);
+  case OpCode::F64x2__trunc:
+    return runVectorTruncOp<double>(Val);
+  case OpCode::I16x8__extadd_pairwise_i8x16_s:
+    return runVectorExtAddPairwiseOp<int8_t, int16_t>(Val);
+  case OpCode::I16x8__extadd_pairwise_i8x16_u:
+    return runVectorExtAddPairwiseOp<uint8_t, uint16_t>(Val);
+  case OpCode::I32x4__extadd_pairwise_i16x8_s:
+    return runVectorExtAddPairwiseOp<int16_t, int32_t>(Val);
+  case OpCode::I32x4__extadd_pairwise_i16x8_u:
+    return runVectorExtAddPairwiseOp<uint16_t, uint32_t>(Val);
+  case OpCode::I16x8__abs:
+    return runVectorAbsOp<int16_t>(Val);
+  case OpCode::I16x8__neg:
+    return runVectorNegOp<int16_t>(Val);
+  case OpCode::I16x8__all_true:
+    return runVectorAllTrueOp<uint16_t>(Val);
+  case OpCode::I16x8__bitmask:
+    return runVectorBitMaskOp<int16_t>(Val);
+  case OpCode::I16x8__extend_low_i8x16_s:
+    return runVectorConvertOp<int8_t, int16_t>(Val);
+  case OpCode::I16x8__extend_high_i8x16_s:
+    return runVectorExtendHighOp<int8_t, int16_t>(Val);
+  case OpCode::I16x8__extend_low_i8x16_u:
+    return runVectorConvertOp<uint8_t, uint16_t>(Val);
+  case OpCode::I16x8__extend_high_i8x16_u:
+    return runVectorExtendHighOp<uint8_t, uint16_t>(Val);
+  case OpCode::F64x2__nearest:
+    return runVectorNearestOp<double>(Val);
+  case OpCode::I32x4__abs:
+    return runVectorAbsOp<int32_t>(Val);
+  case OpCode::I32x4__neg:
+    return runVectorNegOp<int32_t>(Val);
+  case OpCode::I32x4__all_true:
+    return runVectorAllTrueOp<uint32_t>(Val);
+  case OpCode::I32x4__bitmask:
+    return runVectorBitMaskOp<int32_t>(Val);
+  case OpCode::I32x4__extend_low_i16x8_s:
+    return runVectorConvertOp<int16_t, int32_t>(Val);
+  case OpCode::I32x4__extend_high_i16x8_s:
+    return runVectorExtendHighOp<int16_t, int32_t>(Val);
+  case OpCode::I32x4__extend_low_i16x8_u:
+    return runVectorConvertOp<uint16_t, uint32_t>(Val);
+  case OpCode::I32x4__extend_high_i16x8_u:
+    return runVectorExtendHighOp<uint16_t, uint32_t>(Val);
+  case OpCode::I64x2__abs:
+    return runVectorAbsOp<int64_t>(Val);
+  case OpCode::I64x2__neg:
+    return runVectorNegOp<int64_t>(Val);
+  case OpCode::I64x2__all_true:
+    return runVectorAllTrueOp<uint64_t>(Val);
+  case OpCode::I64x2__bitmask:
+    return runVectorBitMaskOp<int64_t>(Val);
+  case OpCode::I64x2__extend_low_i32x4_s:
+    return runVectorConvertOp<int32_t, int64_t>(Val);
+  case OpCode::I64x2__extend_high_i32x4_s:
+    return runVectorExtendHighOp<int32_t, int64_t>(Val);
+  case OpCode::I64x2__extend_low_i32x4_u:
+    return runVectorConvertOp<uint32_t, uint64_t>(Val);
+  case OpCode::I64x2__extend_high_i32x4_u:
+    return runVectorExtendHighOp<uint32_t, uint64_t>(Val);
+  case OpCode::F32x4__abs:
+    return runVectorAbsOp<float>(Val);
+  case OpCode::F32x4__neg:
+    return runVectorNegOp<float>(Val);
+  case OpCode::F32x4__sqrt:
+    return runVectorSqrtOp<float>(Val);
+  case OpCode::F64x2__abs:
+    return runVectorAbsOp<double>(Val);
+  case OpCode::F64x2__neg:
+    return runVectorNegOp<double>(Val);
+  case OpCode::F64x2__sqrt:
+    return runVectorSqrtOp<double>(Val);
+  case OpCode::I32x4__trunc_sat_f32x4_s:
+    return runVectorTruncSatOp<float, int32_t>(Val);
+  case OpCode::I32x4__trunc_sat_f32x4_u:
+    return runVectorTruncSatOp<float, uint32_t>(Val);
+  case OpCode::F32x4__convert_i32x4_s:
+    return runVectorConvertOp<int32_t, float>(Val);
+  case OpCode::F32x4__convert_i32x4_u:
+    return runVectorConvertOp<uint32_t, float>(Val);
+  case OpCode::I32x4__trunc_sat_f64x2_s_zero:
+    return runVectorTruncSatOp<double, int32_t>(Val);
+  case OpCode::I32x4__trunc_sat_f64x2_u_zero:
+    return runVectorTruncSatOp<double, uint32_t>(Val);
+  case OpCode::F64x2__convert_low_i32x4_s:
+    return runVectorConvertOp<int32_t, double>(Val);
+  case OpCode::F64x2__convert_low_i32x4_u:
+    return runVectorConvertOp<uint32_t, double>(Val);
+  case OpCode::V128__bitselect: {
+    ValVariant Val3 = StackMgr.pop();
+    ValVariant Val2 = StackMgr.pop();
+    return runVectorBitSelectOp(StackMgr.getTop(), Val2, Val3);
+  }
+  default:
+    break;
+  }
+
+  /// Binary instructions.
+  ValVariant Val2 = StackMgr.pop();
+  ValVariant &Val1 = StackMgr.getTop();
+  switch (Instr.getOpCode()) {
+  case OpCode::I8x16__swizzle:
+    return runSwizzleOp(Val1, Val2);
+  case OpCode::I8x16__eq:
+    return runVectorEqOp<uint8_t>(Val1, Val2);
+  case OpCode::I8x16__ne:
+    return runVectorNeOp<uint8_t>(Val1, Val2);
+  case OpCode::I8x16__lt_s:
+    return runVectorLtOp<int8_t>(Val1, Val2);
+  case OpCode::I8x16__lt_u:
+    return runVectorLtOp<uint8_t>(Val1, Val2);
+  case OpCode::I8x16__gt_s:
+    return runVectorGtOp<int8_t>(Val1, Val2);
+  case OpCode::I8x16__gt_u:
+    return runVectorGtOp<uint8_t>(Val1, Val2);
+  case OpCode::I8x16__le_s:
+    return runVectorLeOp<int8_t>(Val1, Val2);
+  case OpCode::I8x16__le_u:
+    return runVectorLeOp<uint8_t>(Val1, Val2);
+  case OpCode::I8x16__ge_s:
+    return runVectorGeOp<int8_t>(Val1, Val2);
+  case OpCode::I8x16__ge_u:
+    return runVectorGeOp<uint8_t>(Val1, Val2);
+  case OpCode::I16x8__eq:
+    return runVectorEqOp<uint16_t>(Val1, Val2);
+  case OpCode::I16x8__ne:
+    return runVectorNeOp<uint16_t>(Val1, Val2);
+  case OpCode::I16x8__lt_s:
+    return runVectorLtOp<int16_t>(Val1, Val2);
+  case OpCode::I16x8__lt_u:
+    return runVectorLtOp<uint16_t>(Val1, Val2);
+  case OpCode::I16x8__gt_s:
+    return runVectorGtOp<int16_t>(Val1, Val2);
+  case OpCode::I16x8__gt_u:
+    return runVectorGtOp<uint16_t>(Val1, Val2);
+  case OpCode::I16x8__le_s:
+    return runVectorLeOp<int16_t>(Val1, Val2);
+  case OpCode::I16x8__le_u:
+    return runVectorLeOp<uint16_t>(Val1, Val2);
+  case OpCode::I16x8__ge_s:
+    return runVectorGeOp<int16_t>(Val1, Val2);
+  case OpCode::I16x8__ge_u:
+    return runVectorGeOp<uint16_t>(Val1, Val2);
+  case OpCode::I32x4__eq:
+    return runVectorEqOp<uint32_t>(Val1, Val2);
+  case OpCode::I32x4__ne:
+    return runVectorNeOp<uint32_t>(Val1, Val2);
+  case OpCode::I32x4__lt_s:
+    return runVectorLtOp<int32_t>(Val1, Val2);
+  case OpCode::I32x4__lt_u:
+    return runVectorLtOp<uint32_t>(Val1, Val2);
+  case OpCode::I32x4__gt_s:
+    return runVectorGtOp<int32_t>(Val1, Val2);
+  case OpCode::I32x4__gt_u:
+    return runVectorGtOp<uint32_t>(Val1, Val2);
+  case OpCode::I32x4__le_s:
+    return runVectorLeOp<int32_t>(Val1, Val2);
+  case OpCode::I32x4__le_u:
+    return runVectorLeOp<uint32_t>(Val1, Val2);
+  case OpCode::I32x4__ge_s:
+    return runVectorGeOp<int32_t>(Val1, Val2);
+  case OpCode::I32x4__ge_u:
+    return runVectorGeOp<uint32_t>(Val1, Val2);
+  case OpCode::F32x4__eq:
+    return runVectorEqOp<float>(Val1, Val2);
+  case OpCode::F32x4__ne:
+    return runVectorNeOp<float>(Val1, Val2);
+  case OpCode::F32x4__lt:
+    return runVectorLtOp<float>(Val1, Val2);
+  case OpCode::F32x4__gt:
+    return runVectorGtOp<float>(Val1, Val2);
+  case OpCode::F32x4__le:
+    return runVectorLeOp<float>(Val1, Val2);
+  case OpCode::F32x4__ge:
+    return runVectorGeOp<float>(Val1, Val2);
+  case OpCode::F64x2__eq:
+    return runVectorEqOp<double>(Val1, Val2);
+  case OpCode::F64x2__ne:
+    return runVectorNeOp<double>(Val1, Val2);
+  case OpCode::F64x2__lt:
+    return runVectorLtOp<double>(Val1, Val2);
+  case OpCode::F64x2__gt:
+    return runVectorGtOp<double>(Val1, Val2);
+  case OpCode::F64x2__le:
+    return runVectorLeOp<double>(Val1, Val2);
+  case OpCode::F64x2__ge:
+    return runVectorGeOp<double>(Val1, Val2);
+  case OpCode::V128__and:
+    return runVectorAndOp(Val1, Val2);
+  case OpCode::V128__andnot:
+    return runVectorAndNotOp(Val1, Val2);
+  case OpCode::V128__or:
+    return runVectorOrOp(Val1, Val2);
+  case OpCode::V128__xor:
+    return runVectorXorOp(Val1, Val2);
+  case OpCode::I8x16__narrow_i16x8_s:
+    return runVectorNarrowOp<int16_t, int8_t>(Val1, Val2);
+  case OpCode::I8x16__narrow_i16x8_u:
+    return runVectorNarrowOp<int16_t, uint8_t>(Val1, Val2);
+  case OpCode::I8x16__shl:
+    return runVectorShlOp<uint8_t>(Val1, Val2);
+  case OpCode::I8x16__shr_s:
+    return runVectorShrOp<int8_t>(Val1, Val2);
+  case OpCode::I8x16__shr_u:
+    return runVectorShrOp<uint8_t>(Val1, Val2);
+  case OpCode::I8x16__add:
+    return runVectorAddOp<uint8_t>(Val1, Val2);
+  case OpCode::I8x16__add_sat_s:
+    return runVectorAddSatOp<int8_t>(Val1, Val2);
+  case OpCode::I8x16__add_sat_u:
+    return runVectorAddSatOp<uint8_t>(Val1, Val2);
+  case OpCode::I8x16__sub:
+    return runVectorSubOp<uint8_t>(Val1, Val2);
+  case OpCode::I8x16__sub_sat_s:
+    return runVectorSubSatOp<int8_t>(Val1, Val2);
+  case OpCode::I8x16__sub_sat_u:
+    return runVectorSubSatOp<uint8_t>(Val1, Val2);
+  case OpCode::I8x16__min_s:
+    return runVectorMinOp<int8_t>(Val1, Val2);
+  case OpCode::I8x16__min_u:
+    return runVectorMinOp<uint8_t>(Val1, Val2);
+  case OpCode::I8x16__max_s:
+    return runVectorMaxOp<int8_t>(Val1, Val2);
+  case OpCode::I8x16__max_u:
+    return runVectorMaxOp<uint8_t>(Val1, Val2);
+  case OpCode::I8x16__avgr_u:
+    return runVectorAvgrOp<uint8_t>(Val1, Val2);
+  case OpCode::I16x8__q15mulr_sat_s:
+    return runVectorQ15MulSatOp(Val1, Val2);
+  case OpCode::I16x8__narrow_i32x4_s:
+    return runVectorNarrowOp<int32_t, int16_t>(Val1, Val2);
+  case OpCode::I16x8__narrow_i32x4_u:
+    return runVectorNarrowOp<int32_t, uint16_t>(Val1, Val2);
+  case OpCode::I16x8__shl:
+    return runVectorShlOp<uint16_t>(Val1, Val2);
+  case OpCode::I16x8__shr_s:
+    return runVectorShrOp<int16_t>(Val1, Val2);
+  case OpCode::I16x8__shr_u:
+    return runVectorShrOp<uint16_t>(Val1, Val2);
+  case OpCode::I16x8__add:
+    return runVectorAddOp<uint16_t>(Val1, Val2);
+  case OpCode::I16x8__add_sat_s:
+    return runVectorAddSatOp<int16_t>(Val1, Val2);
+  case OpCode::I16x8__add_sat_u:
+    return runVectorAddSatOp<uint16_t>(Val1, Val2);
+  case OpCode::I16x8__sub:
+    return runVectorSubOp<uint16_t>(Val1, Val2);
+  case OpCode::I16x8__sub_sat_s:
+    return runVectorSubSatOp<int16_t>(Val1, Val2);
+  case OpCode::I16x8__sub_sat_u:
+    return runVectorSubSatOp<uint16_t>(Val1, Val2);
+  case OpCode::I16x8__mul:
+    return runVectorMulOp<uint16_t>(Val1, Val2);
+  case OpCode::I16x8__min_s:
+    return runVectorMinOp<int16_t>(Val1, Val2);
+  case OpCode::I16x8__min_u:
+    return runVectorMinOp<uint16_t>(Val1, Val2);
+  case OpCode::I16x8__max_s:
+    return runVectorMaxOp<int16_t>(Val1, Val2);
+  case OpCode::I16x8__max_u:
+    return runVectorMaxOp<uint16_t>(Val1, Val2);
+  case OpCode::I16x8__avgr_u:
+    return runVectorAvgrOp<uint16_t>(Val1, Val2);
+  case OpCode::I16x8__extmul_low_i8x16_s:
+    return runVectorExtMulLowOp<int8_t, int16_t>(Val1, Val2);
+  case OpCode::I16x8__extmul_high_i8x16_s:
+    return runVectorExtMulHighOp<int8_t, int16_t>(Val1, Val2);
+  case OpCode::I16x8__extmul_low_i8x16_u:
+    return runVectorExtMulLowOp<uint8_t, uint16_t>(Val1, Val2);
+  case OpCode::I16x8__extmul_high_i8x16_u:
+    return runVectorExtMulHighOp<uint8_t, uint16_t>(Val1, Val2);
+  case OpCode::I32x4__shl:
+    return runVectorShlOp<uint32_t>(Val1, Val2);
+  case OpCode::I32x4__shr_s:
+    return runVectorShrOp<int32_t>(Val1, Val2);
+  case OpCode::I32x4__shr_u:
+    return runVectorShrOp<uint32_t>(Val1, Val2);
+  case OpCode::I32x4__add:
+    return runVectorAddOp<uint32_t>(Val1, Val2);
+  case OpCode::I32x4__sub:
+    return runVectorSubOp<uint32_t>(Val1, Val2);
+  case OpCode::I32x4__mul:
+    return runVectorMulOp<uint32_t>(Val1, Val2);
+  case OpCode::I32x4__min_s:
+    return runVectorMinOp<int32_t>(Val1, Val2);
+  case OpCode::I32x4__min_u:
+    return runVectorMinOp<uint32_t>(Val1, Val2);
+  case OpCode::I32x4__max_s:
+    return runVectorMaxOp<int32_t>(Val1, Val2);
+  case OpCode::I32x4__max_u:
+    return runVectorMaxOp<uint32_t>(Val1, Val2);
+  case OpCode::I32x4__dot_i16x8_s:
+    return runVectorDotOp(Val1, Val2);
+  case OpCode::I32x4__extmul_low_i16x8_s:
+    return runVectorExtMulLowOp<int16_t, int32_t>(Val1, Val2);
+  case OpCode::I32x4__extmul_high_i16x8_s:
+    return runVectorExtMulHighOp<int16_t, int32_t>(Val1, Val2);
+  case OpCode::I32x4__extmul_low_i16x8_u:
+    return runVectorExtMulLowOp<uint16_t, uint32_t>(Val1, Val2);
+  case OpCode::I32x4__extmul_high_i16x8_u:
+    return runVectorExtMulHighOp<uint16_t, uint32_t>(Val1, Val2);
+  case OpCode::I64x2__shl:
+    return runVectorShlOp<uint64_t>(Val1, Val2);
+  case OpCode::I64x2__shr_s:
+    return runVectorShrOp<int64_t>(Val1, Val2);
+  case OpCode::I64x2__shr_u:
+    return runVectorShrOp<uint64_t>(Val1, Val2);
+  case OpCode::I64x2__add:
+    return runVectorAddOp<uint64_t>(Val1, Val2);
+  case OpCode::I64x2__sub:
+    return runVectorSubOp<uint64_t>(Val1, Val2);
+  case OpCode::I64x2__mul:
+    return runVectorMulOp<uint64_t>(Val1, Val2);
+  case OpCode::I64x2__eq:
+    return runVectorEqOp<uint64_t>(Val1, Val2);
+  case OpCode::I64x2__ne:
+    return runVectorNeOp<uint64_t>(Val1, Val2);
+  case OpCode::I64x2__lt_s:
+    return runVectorLtOp<int64_t>(Val1, Val2);
+  case OpCode::I64x2__gt_s:
+    return runVectorGtOp<int64_t>(Val1, Val2);
+  case OpCode::I64x2__le_s:
+    return runVectorLeOp<int64_t>(Val1, Val2);
+  case OpCode::I64x2__ge_s:
+    return runVectorGeOp<int64_t>(Val1, Val2);
+  case OpCode::I64x2__extmul_low_i32x4_s:
+    return runVectorExtMulLowOp<int32_t, int64_t>(Val1, Val2);
+  case OpCode::I64x2__extmul_high_i32x4_s:
+    return runVectorExtMulHighOp<int32_t, int64_t>(Val1, Val2);
+  case OpCode::I64x2__extmul_low_i32x4_u:
+    return runVectorExtMulLowOp<uint32_t, uint64_t>(Val1, Val2);
+  case OpCode::I64x2__extmul_high_i32x4_u:
+    return runVectorExtMulHighOp<uint32_t, uint64_t>(Val1, Val2);
+  case OpCode::F32x4__add:
+    return runVectorAddOp<float>(Val1, Val2);
+  case OpCode::F32x4__sub:
+    return runVectorSubOp<float>(Val1, Val2);
+  case OpCode::F32x4__mul:
+    return runVectorMulOp<float>(Val1, Val2);
+  case OpCode::F32x4__div:
+    return runVectorDivOp<float>(Val1, Val2);
+  case OpCode::F32x4__min:
+    return runVectorMinOp<float>(Val1, Val2);
+  case OpCode::F32x4__max:
+    return runVectorMaxOp<float>(Val1, Val2);
+  case OpCode::F32x4__pmin:
+    return runVectorPMinOp<float>(Val1, Val2);
+  case OpCode::F32x4__pmax:
+    return runVectorPMaxOp<float>(Val1, Val2);
+  case OpCode::F64x2__add:
+    return runVectorAddOp<double>(Val1, Val2);
+  case OpCode::F64x2__sub:
+    return runVectorSubOp<double>(Val1, Val2);
+  case OpCode::F64x2__mul:
+    return runVectorMulOp<double>(Val1, Val2);
+  case OpCode::F64x2__div:
+    return runVectorDivOp<double>(Val1, Val2);
+  case OpCode::F64x2__min:
+    return runVectorMinOp<double>(Val1, Val2);
+  case OpCode::F64x2__max:
+    return runVectorMaxOp<double>(Val1, Val2);
+  case OpCode::F64x2__pmin:
+    return runVectorPMinOp<double>(Val1, Val2);
+  case OpCode::F64x2__pmax:
+    return runVectorPMaxOp<double>(Val1, Val2);
+  default:
+    return Unexpect(ErrCode::InstrTypeMismatch);
+  }
+}
+
+
 Expect<void> Interpreter::execute(Runtime::StoreManager &StoreMgr) {
   /// Run instructions until end.
   while (InstrPdr.getScopeSize() > 0) {
@@ -631,11 +1495,157 @@ Expect<void> Interpreter::execute(Runtime::StoreManager &StoreMgr) {
   return {};
 }
 
+Expect<void> Interpreter::execute(Runtime::StoreManager &StoreMgr,
+                                  const AST::AtomicMemoryInstruction &Instr) {
+  if (Instr.getOpCode() == OpCode::Atomic__fence) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return {};
+  }
+  auto *MemInst = getMemInstByIdx(StoreMgr, 0);
+  switch (Instr.getOpCode()) {
+  case OpCode::Memory__atomic__notify:
+    return runAtomicNotifyOp(*MemInst, Instr);
+  case OpCode::Memory__atomic__wait32:
+    return runAtomicWaitOp<uint32_t>(*MemInst, Instr);
+  case OpCode::Memory__atomic__wait64:
+    return runAtomicWaitOp<uint64_t>(*MemInst, Instr);
+  case OpCode::I32__atomic__load:
+    return runAtomicLoadOp<uint32_t, uint32_t>(*MemInst, Instr);
+  case OpCode::I64__atomic__load:
+    return runAtomicLoadOp<uint64_t, uint64_t>(*MemInst, Instr);
+  case OpCode::I32__atomic__load8_u:
+    return runAtomicLoadOp<uint32_t, uint8_t>(*MemInst, Instr);
+  case OpCode::I32__atomic__load16_u:
+    return runAtomicLoadOp<uint32_t, uint16_t>(*MemInst, Instr);
+  case OpCode::I64__atomic__load8_u:
+    return runAtomicLoadOp<uint64_t, uint8_t>(*MemInst, Instr);
+  case OpCode::I64__atomic__load16_u:
+    return runAtomicLoadOp<uint64_t, uint16_t>(*MemInst, Instr);
+  case OpCode::I64__atomic__load32_u:
+    return runAtomicLoadOp<uint64_t, uint32_t>(*MemInst, Instr);
+  case OpCode::I32__atomic__store:
+    return runAtomicStoreOp<uint32_t, uint32_t>(*MemInst, Instr);
+  case OpCode::I64__atomic__store:
+    return runAtomicStoreOp<uint64_t, uint64_t>(*MemInst, Instr);
+  case OpCode::I32__atomic__store8:
+    return runAtomicStoreOp<uint32_t, uint8_t>(*MemInst, Instr);
+  case OpCode::I32__atomic__store16:
+    return runAtomicStoreOp<uint32_t, uint16_t>(*MemInst, Instr);
+  case OpCode::I64__atomic__store8:
+    return runAtomicStoreOp<uint64_t, uint8_t>(*MemInst, Instr);
+  case OpCode::I64__atomic__store16:
+    return runAtomicStoreOp<uint64_t, uint16_t>(*MemInst, Instr);
+  case OpCode::I64__atomic__store32:
+    return runAtomicStoreOp<uint64_t, uint32_t>(*MemInst, Instr);
+  case OpCode::I32__atomic__rmw__add:
+    return runAtomicRMWOp<uint32_t, uint32_t, AtomicAdd>(*MemInst, Instr);
+  case OpCode::I64__atomic__rmw__add:
+    return runAtomicRMWOp<uint64_t, uint64_t, AtomicAdd>(*MemInst, Instr);
+  case OpCode::I32__atomic__rmw8__add_u:
+    return runAtomicRMWOp<uint32_t, uint8_t, AtomicAdd>(*MemInst, Instr);
+  case OpCode::I32__atomic__rmw16__add_u:
+    return runAtomicRMWOp<uint32_t, uint16_t, AtomicAdd>(*MemInst, Instr);
+  case OpCode::I64__atomic__rmw8__add_u:
+    return runAtomicRMWOp<uint64_t, uint8_t, AtomicAdd>(*MemInst, Instr);
+  case OpCode::I64__atomic__rmw16__add_u:
+    return runAtomicRMWOp<uint64_t, uint16_t, AtomicAdd>(*MemInst, Instr);
+  case OpCode::I64__atomic__rmw32__add_u:
+    return runAtomicRMWOp<uint64_t, uint32_t, AtomicAdd>(*MemInst, Instr);
+  case OpCode::I32__atomic__rmw__sub:
+    return runAtomicRMWOp<uint32_t, uint32_t, AtomicSub>(*MemInst, Instr);
+  case OpCode::I64__atomic__rmw__sub:
+    return runAtomicRMWOp<uint64_t, uint64_t, AtomicSub>(*MemInst, Instr);
+  case OpCode::I32__atomic__rmw8__sub_u:
+    return runAtomicRMWOp<uint32_t, uint8_t, AtomicSub>(*MemInst, Instr);
+  case OpCode::I32__atomic__rmw16__sub_u:
+    return runAtomicRMWOp<uint32_t, uint16_t, AtomicSub>(*MemInst, Instr);
+  case OpCode::I64__atomic__rmw8__sub_u:
+    return runAtomicRMWOp<uint64_t, uint8_t, AtomicSub>(*MemInst, Instr);
+  case OpCode::I64__atomic__rmw16__sub_u:
+    return runAtomicRMWOp<uint64_t, uint16_t, AtomicSub>(*MemInst, Instr);
+  case OpCode::I64__atomic__rmw32__sub_u:
+    return runAtomicRMWOp<uint64_t, uint32_t, AtomicSub>(*MemInst, Instr);
+  case OpCode::I32__atomic__rmw__and:
+    return runAtomicRMWOp<uint32_t, uint32_t, AtomicAnd>(*MemInst, Instr);
+  case OpCode::I64__atomic__rmw__and:
+    return runAtomicRMWOp<uint64_t, uint64_t, AtomicAnd>(*MemInst, Instr);
+  case OpCode::I32__atomic__rmw8__and_u:
+    return runAtomicRMWOp<uint32_t, uint8_t, AtomicAnd>(*MemInst, Instr);
+  case OpCode::I32__atomic__rmw16__and_u:
+    return runAtomicRMWOp<uint32_t, uint16_t, AtomicAnd>(*MemInst, Instr);
+  case OpCode::I64__atomic__rmw8__and_u:
+    return runAtomicRMWOp<uint64_t, uint8_t, AtomicAnd>(*MemInst, Instr);
+  case OpCode::I64__atomic__rmw16__and_u:
+    return runAtomicRMWOp<uint64_t, uint16_t, AtomicAnd>(*MemInst, Instr);
+  case OpCode::I64__atomic__rmw32__and_u:
+    return runAtomicRMWOp<uint64_t, uint32_t, AtomicAnd>(*MemInst, Instr);
+  case OpCode::I32__atomic__rmw__or:
+    return runAtomicRMWOp<uint32_t, uint32_t, AtomicOr>(*MemInst, Instr);
+  case OpCode::I64__atomic__rmw__or:
+    return runAtomicRMWOp<uint64_t, uint64_t, AtomicOr>(*MemInst, Instr);
+  case OpCode::I32__atomic__rmw8__or_u:
+    return runAtomicRMWOp<uint32_t, uint8_t, AtomicOr>(*MemInst, Instr);
+  case OpCode::I32__atomic__rmw16__or_u:
+    return runAtomicRMWOp<uint32_t, uint16_t, AtomicOr>(*MemInst, Instr);
+  case OpCode::I64__atomic__rmw8__or_u:
+    return runAtomicRMWOp<uint64_t, uint8_t, AtomicOr>(*MemInst, Instr);
+  case OpCode::I64__atomic__rmw16__or_u:
+    return runAtomicRMWOp<uint64_t, uint16_t, AtomicOr>(*MemInst, Instr);
+  case OpCode::I64__atomic__rmw32__or_u:
+    return runAtomicRMWOp<uint64_t, uint32_t, AtomicOr>(*MemInst, Instr);
+  case OpCode::I32__atomic__rmw__xor:
+    return runAtomicRMWOp<uint32_t, uint32_t, AtomicXor>(*MemInst, Instr);
+  case OpCode::I64__atomic__rmw__xor:
+    return runAtomicRMWOp<uint64_t, uint64_t, AtomicXor>(*MemInst, Instr);
+  case OpCode::I32__atomic__rmw8__xor_u:
+    return runAtomicRMWOp<uint32_t, uint8_t, AtomicXor>(*MemInst, Instr);
+  case OpCode::I32__atomic__rmw16__xor_u:
+    return runAtomicRMWOp<uint32_t, uint16_t, AtomicXor>(*MemInst, Instr);
+  case OpCode::I64__atomic__rmw8__xor_u:
+    return runAtomicRMWOp<uint64_t, uint8_t, AtomicXor>(*MemInst, Instr);
+  case OpCode::I64__atomic__rmw16__xor_u:
+    return runAtomicRMWOp<uint64_t, uint16_t, AtomicXor>(*MemInst, Instr);
+  case OpCode::I64__atomic__rmw32__xor_u:
+    return runAtomicRMWOp<uint64_t, uint32_t, AtomicXor>(*MemInst, Instr);
+  case OpCode::I32__atomic__rmw__xchg:
+    return runAtomicRMWOp<uint32_t, uint32_t, AtomicXchg>(*MemInst, Instr);
+  case OpCode::I64__atomic__rmw__xchg:
+    return runAtomicRMWOp<uint64_t, uint64_t, AtomicXchg>(*MemInst, Instr);
+  case OpCode::I32__atomic__rmw8__xchg_u:
+    return runAtomicRMWOp<uint32_t, uint8_t, AtomicXchg>(*MemInst, Instr);
+  case OpCode::I32__atomic__rmw16__xchg_u:
+    return runAtomicRMWOp<uint32_t, uint16_t, AtomicXchg>(*MemInst, Instr);
+  case OpCode::I64__atomic__rmw8__xchg_u:
+    return runAtomicRMWOp<uint64_t, uint8_t, AtomicXchg>(*MemInst, Instr);
+  case OpCode::I64__atomic__rmw16__xchg_u:
+    return runAtomicRMWOp<uint64_t, uint16_t, AtomicXchg>(*MemInst, Instr);
+  case OpCode::I64__atomic__rmw32__xchg_u:
+    return runAtomicRMWOp<uint64_t, uint32_t, AtomicXchg>(*MemInst, Instr);
+  case OpCode::I32__atomic__rmw__cmpxchg:
+    return runAtomicCmpxchgOp<uint32_t, uint32_t>(*MemInst, Instr);
+  case OpCode::I64__atomic__rmw__cmpxchg:
+    return runAtomicCmpxchgOp<uint64_t, uint64_t>(*MemInst, Instr);
+  case OpCode::I32__atomic__rmw8__cmpxchg_u:
+    return runAtomicCmpxchgOp<uint32_t, uint8_t>(*MemInst, Instr);
+  case OpCode::I32__atomic__rmw16__cmpxchg_u:
+    return runAtomicCmpxchgOp<uint32_t, uint16_t>(*MemInst, Instr);
+  case OpCode::I64__atomic__rmw8__cmpxchg_u:
+    return runAtomicCmpxchgOp<uint64_t, uint8_t>(*MemInst, Instr);
+  case OpCode::I64__atomic__rmw16__cmpxchg_u:
+    return runAtomicCmpxchgOp<uint64_t, uint16_t>(*MemInst, Instr);
+  case OpCode::I64__atomic__rmw32__cmpxchg_u:
+    return runAtomicCmpxchgOp<uint64_t, uint32_t>(*MemInst, Instr);
+  default:
+    return Unexpect(ErrCode::InstrTypeMismatch);
+  }
+}
+
 Expect<void> Interpreter::enterBlock(const uint32_t Arity,
+                                     const uint32_t Coarity,
                                      const AST::BlockControlInstruction *Instr,
                                      const AST::InstrVec &Seq) {
   /// Create label for block and push.
-  StackMgr.pushLabel(Arity, Instr);
+  StackMgr.pushLabel(Arity, Coarity, Instr);
 
   /// Jump to block body.
   InstrPdr.pushInstrs(InstrProvider::SeqType::Block, Seq);
@@ -644,11 +1654,23 @@ Expect<void> Interpreter::enterBlock(const uint32_t Arity,
 
 Expect<void> Interpreter::leaveBlock() {
   /// Pop label entry and the corresponding instruction sequence.
-  StackMgr.popLabel();
+  StackMgr.leaveLabel();
   InstrPdr.popInstrs();
   return {};
 }
 
+std::pair<uint32_t, uint32_t>
+Interpreter::getBlockArity(Runtime::StoreManager &StoreMgr,
+                           const BlockType &Type) {
+  if (const auto *Idx = std::get_if<uint32_t>(&Type)) {
+    /// Get the parameter and result counts from the function type.
+    const auto *ModInst = *StoreMgr.getModule(StackMgr.getModuleAddr());
+    const auto *FuncType = *ModInst->getFuncType(*Idx);
+    return {FuncType->Params.size(), FuncType->Returns.size()};
+  }
+  return {0, (std::get<ValType>(Type) == ValType::None) ? 0 : 1};
+}
+
 Expect<void>
 Interpreter::enterFunction(Runtime::StoreManager &StoreMgr,
                            const Runtime::Instance::FunctionInstance &Func) {
@@ -685,7 +1707,17 @@ Interpreter::enterFunction(Runtime::StoreManager &StoreMgr,
     std::vector<ValVariant> Rets(RetsN);
 
     /// FIXME: Pass memory instance pointer instead of reference and nullable.
+    auto &Stats = HostFunc.getStats();
+    std::chrono::steady_clock::time_point Start;
+    if (Stats.isEnabled()) {
+      Start = std::chrono::steady_clock::now();
+    }
     auto Ret = HostFunc.run(*MemoryInst, std::move(Args), Rets);
+    if (Stats.isEnabled()) {
+      Stats.recordCall(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           std::chrono::steady_clock::now() - Start)
+                           .count());
+    }
 
     for (size_t I = 0; I < ArgsN; ++I) {
       StackMgr.pop();
@@ -735,6 +1767,12 @@ Interpreter::enterFunction(Runtime::StoreManager &StoreMgr,
     StackMgr.popFrame();
     return {};
   } else {
+    /// Decode and validate the function body on the first call in lazy
+    /// loading.
+    if (auto Res = Func.loadBody(); !Res) {
+      return Unexpect(Res);
+    }
+
     /// Native function case: Push frame with locals and args.
     StackMgr.pushFrame(Func.getModuleAddr(),   /// Module address
                        FuncType.Params.size(), /// Arity
@@ -752,10 +1790,49 @@ Interpreter::enterFunction(Runtime::StoreManager &StoreMgr,
     InstrPdr.pushInstrs(InstrProvider::SeqType::FunctionCall);
 
     /// Enter function block.
-    return enterBlock(FuncType.Returns.size(), nullptr, Func.getInstrs());
+    return enterBlock(0, FuncType.Returns.size(), nullptr,
+                      Func.getInstrs());
   }
 }
 
+Expect<void>
+Interpreter::tailCallFunction(Runtime::StoreManager &StoreMgr,
+                              const Runtime::Instance::FunctionInstance &Func) {
+  if (Func.isHostFunction() || Func.getSymbol()) {
+    /// Host and compiled functions return in enterFunction, so call them and
+    /// then return from the current function.
+    if (auto Res = enterFunction(StoreMgr, Func); !Res) {
+      return Unexpect(Res);
+    }
+    return leaveFunction();
+  }
+
+  /// Decode and validate the function body on the first call in lazy
+  /// loading.
+  if (auto Res = Func.loadBody(); !Res) {
+    return Unexpect(Res);
+  }
+
+  /// Reuse the current frame. The coarity is the same as the callee's one
+  /// according to validation.
+  const auto &FuncType = Func.getFuncType();
+  const uint32_t LabelPoped =
+      StackMgr.reuseFrame(Func.getModuleAddr(), FuncType.Params.size());
+  for (uint32_t I = 0; I < LabelPoped; ++I) {
+    InstrPdr.popInstrs();
+  }
+
+  /// Push local variables to stack.
+  for (auto &Def : Func.getLocals()) {
+    for (uint32_t i = 0; i < Def.first; i++) {
+      StackMgr.push(ValueFromType(Def.second));
+    }
+  }
+
+  /// Enter function block in the function call sequence of current frame.
+  return enterBlock(0, FuncType.Returns.size(), nullptr, Func.getInstrs());
+}
+
 Expect<void> Interpreter::leaveFunction() {
   /// Pop the frame entry from the Stack.
   const uint32_t LabelPoped = StackMgr.popFrame();
@@ -770,6 +1847,7 @@ Expect<void> Interpreter::branchToLabel(const uint32_t Cnt) {
   /// Get the L-th label from top of stack and the continuation instruction.
   auto &L = StackMgr.getLabelWithCount(Cnt);
   const AST::BlockControlInstruction *ContInstr = L.Target;
+  const uint32_t Coarity = L.Coarity;
 
   /// Pop L + 1 labels.
   StackMgr.popLabel(Cnt + 1);
@@ -780,9 +1858,10 @@ Expect<void> Interpreter::branchToLabel(const uint32_t Cnt) {
     InstrPdr.popInstrs();
   }
 
-  /// Jump to the continuation of Label
+  /// Jump to the continuation of Label. The kept values are the loop
+  /// parameters.
   if (ContInstr != nullptr) {
-    return runLoopOp(*ContInstr);
+    return enterBlock(Coarity, Coarity, ContInstr, ContInstr->getBody());
   }
   return {};
 }
@@ -811,6 +1890,12 @@ Interpreter::getGlobInstByIdx(Runtime::StoreManager &StoreMgr,
   /// FIXME: Return nullptr when top frame is dummy frame.
   const auto *ModInst = *StoreMgr.getModule(StackMgr.getModuleAddr());
   const uint32_t GlobAddr = *ModInst->getGlobalAddr(Idx);
+  if (!ThreadGlobInsts.empty()) {
+    if (auto It = ThreadGlobInsts.find(GlobAddr);
+        It != ThreadGlobInsts.end()) {
+      return It->second.get();
+    }
+  }
   return *StoreMgr.getGlobal(GlobAddr);
 }
 
@@ -27,5 +27,71 @@ Interpreter::runMemoryGrowOp(Runtime::Instance::MemoryInstance &MemInst) {
   return {};
 }
 
+Expect<void>
+Interpreter::runMemoryInitOp(Runtime::StoreManager &StoreMgr,
+                             Runtime::Instance::MemoryInstance &MemInst,
+                             const AST::MemoryInstruction &Instr) {
+  /// Pop the length, source offset in data segment, and destination offset.
+  const uint32_t Len = retrieveValue<uint32_t>(StackMgr.pop());
+  const uint32_t Src = retrieveValue<uint32_t>(StackMgr.pop());
+  const uint32_t Dst = retrieveValue<uint32_t>(StackMgr.pop());
+
+  /// Copy the data segment to memory.
+  const auto *ModInst = *StoreMgr.getModule(StackMgr.getModuleAddr());
+  if (auto Data = ModInst->getData(Instr.getDataIndex())) {
+    return MemInst.setBytes(*Data, Dst, Src, Len);
+  } else {
+    return Unexpect(Data);
+  }
+}
+
+Expect<void> Interpreter::runDataDropOp(Runtime::StoreManager &StoreMgr,
+                                        const AST::MemoryInstruction &Instr) {
+  auto *ModInst = *StoreMgr.getModule(StackMgr.getModuleAddr());
+  ModInst->dropData(Instr.getDataIndex());
+  return {};
+}
+
+Expect<void>
+Interpreter::runMemoryCopyOp(Runtime::Instance::MemoryInstance &MemInst) {
+  /// Pop the length, source offset, and destination offset.
+  const uint32_t Len = retrieveValue<uint32_t>(StackMgr.pop());
+  const uint32_t Src = retrieveValue<uint32_t>(StackMgr.pop());
+  const uint32_t Dst = retrieveValue<uint32_t>(StackMgr.pop());
+  return MemInst.copyBytes(Dst, Src, Len);
+}
+
+Expect<void>
+Interpreter::runMemoryFillOp(Runtime::Instance::MemoryInstance &MemInst) {
+  /// Pop the length, byte value, and destination offset.
+  const uint32_t Len = retrieveValue<uint32_t>(StackMgr.pop());
+  const uint8_t Val = retrieveValue<uint32_t>(StackMgr.pop());
+  const uint32_t Dst = retrieveValue<uint32_t>(StackMgr.pop());
+  return MemInst.fillBytes(Dst, Val, Len);
+}
+
+Expect<void>
+Interpreter::runAtomicNotifyOp(Runtime::Instance::MemoryInstance &MemInst,
+                               const AST::AtomicMemoryInstruction &Instr) {
+  /// Pop the count of threads to wake.
+  const uint32_t Count = retrieveValue<uint32_t>(StackMgr.pop());
+
+  /// Calculate EA = i + offset
+  ValVariant &Val = StackMgr.getTop();
+  if (retrieveValue<uint32_t>(Val) >
+      std::numeric_limits<uint32_t>::max() - Instr.getMemoryOffset()) {
+    return Unexpect(ErrCode::MemoryOutOfBounds);
+  }
+  uint32_t EA = retrieveValue<uint32_t>(Val) + Instr.getMemoryOffset();
+
+  /// Return the number of woken threads.
+  if (auto Res = MemInst.atomicNotify(EA, Count)) {
+    Val = *Res;
+  } else {
+    return Unexpect(Res);
+  }
+  return {};
+}
+
 } // namespace Interpreter
 } // namespace SSVM
@@ -17,7 +17,7 @@ const AST::Instruction *InstrProvider::getNextInstr() {
   }
 
   /// Get instruction.
-  const AST::Instruction *Instr = (*Iters.back().Curr).get();
+  const AST::Instruction *Instr = *Iters.back().Curr;
   (Iters.back().Curr)++;
   return Instr;
 }
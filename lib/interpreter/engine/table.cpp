@@ -0,0 +1,95 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "common/value.h"
+#include "interpreter/interpreter.h"
+
+namespace SSVM {
+namespace Interpreter {
+
+Expect<void>
+Interpreter::runTableInitOp(Runtime::StoreManager &StoreMgr,
+                            Runtime::Instance::TableInstance &TabInst,
+                            const AST::TableInstruction &Instr) {
+  /// Pop the length, source offset in element segment, and destination
+  /// offset.
+  const uint32_t Len = retrieveValue<uint32_t>(StackMgr.pop());
+  const uint32_t Src = retrieveValue<uint32_t>(StackMgr.pop());
+  const uint32_t Dst = retrieveValue<uint32_t>(StackMgr.pop());
+
+  /// Copy the function addresses of element segment to table.
+  const auto *ModInst = *StoreMgr.getModule(StackMgr.getModuleAddr());
+  if (auto Elem = ModInst->getElem(Instr.getElemIndex())) {
+    return TabInst.setElems(Dst, *Elem, Src, Len);
+  } else {
+    return Unexpect(Elem);
+  }
+}
+
+Expect<void> Interpreter::runElemDropOp(Runtime::StoreManager &StoreMgr,
+                                        const AST::TableInstruction &Instr) {
+  auto *ModInst = *StoreMgr.getModule(StackMgr.getModuleAddr());
+  ModInst->dropElem(Instr.getElemIndex());
+  return {};
+}
+
+Expect<void>
+Interpreter::runTableCopyOp(Runtime::Instance::TableInstance &TabInstDst,
+                            Runtime::Instance::TableInstance &TabInstSrc) {
+  /// Pop the length, source offset, and destination offset.
+  const uint32_t Len = retrieveValue<uint32_t>(StackMgr.pop());
+  const uint32_t Src = retrieveValue<uint32_t>(StackMgr.pop());
+  const uint32_t Dst = retrieveValue<uint32_t>(StackMgr.pop());
+  return TabInstDst.copyElems(Dst, TabInstSrc, Src, Len);
+}
+
+Expect<void>
+Interpreter::runTableGetOp(Runtime::Instance::TableInstance &TabInst) {
+  /// Replace the index on the top of stack with the reference.
+  ValVariant &Val = StackMgr.getTop();
+  if (auto Res = TabInst.getRef(retrieveValue<uint32_t>(Val))) {
+    Val = *Res;
+    return {};
+  } else {
+    return Unexpect(Res);
+  }
+}
+
+Expect<void>
+Interpreter::runTableSetOp(Runtime::Instance::TableInstance &TabInst) {
+  /// Pop the reference and the index.
+  const ValVariant Ref = StackMgr.pop();
+  const uint32_t Idx = retrieveValue<uint32_t>(StackMgr.pop());
+  return TabInst.setRef(Idx, Ref);
+}
+
+Expect<void>
+Interpreter::runTableGrowOp(Runtime::Instance::TableInstance &TabInst) {
+  /// Pop the growing count and replace the initial reference with the old
+  /// size, or -1 if failed.
+  const uint32_t Count = retrieveValue<uint32_t>(StackMgr.pop());
+  ValVariant &Val = StackMgr.getTop();
+  const uint32_t OldSize = TabInst.getSize();
+  if (TabInst.growTable(Count, Val)) {
+    Val = OldSize;
+  } else {
+    Val = static_cast<uint32_t>(-1);
+  }
+  return {};
+}
+
+Expect<void>
+Interpreter::runTableSizeOp(Runtime::Instance::TableInstance &TabInst) {
+  StackMgr.push(TabInst.getSize());
+  return {};
+}
+
+Expect<void>
+Interpreter::runTableFillOp(Runtime::Instance::TableInstance &TabInst) {
+  /// Pop the length, the reference, and the offset.
+  const uint32_t Len = retrieveValue<uint32_t>(StackMgr.pop());
+  const ValVariant Ref = StackMgr.pop();
+  const uint32_t Off = retrieveValue<uint32_t>(StackMgr.pop());
+  return TabInst.fillElems(Off, Ref, Len);
+}
+
+} // namespace Interpreter
+} // namespace SSVM
@@ -15,6 +15,11 @@ Interpreter::resolveExpression(Runtime::StoreManager &StoreMgr,
   std::vector<uint32_t> Offsets;
   /// Iterate and evaluate offsets.
   for (const auto &DataSeg : DataSec.getContent()) {
+    /// Only active segments have offsets.
+    if (DataSeg->getMode() != AST::SegmentMode::Active) {
+      continue;
+    }
+
     /// Run initialize expression.
     if (auto Res = runExpression(StoreMgr, DataSeg->getInstrs()); !Res) {
       return Unexpect(Res);
@@ -41,20 +46,24 @@ Interpreter::resolveExpression(Runtime::StoreManager &StoreMgr,
 Expect<void> Interpreter::instantiate(
     Runtime::StoreManager &StoreMgr, Runtime::Instance::ModuleInstance &ModInst,
     const AST::DataSection &DataSec, const std::vector<uint32_t> &Offsets) {
-  auto ItDataSeg = DataSec.getContent().cbegin();
   auto ItOffset = Offsets.cbegin();
-  while (ItOffset != Offsets.cend()) {
+  for (const auto &DataSeg : DataSec.getContent()) {
+    /// Keep passive segment for memory.init.
+    const auto Data = DataSeg->getData();
+    if (DataSeg->getMode() != AST::SegmentMode::Active) {
+      ModInst.addData(DataSeg->getSharedData());
+      continue;
+    }
+
     /// Get memory instance.
-    uint32_t MemAddr = *ModInst.getMemAddr((*ItDataSeg)->getIdx());
+    uint32_t MemAddr = *ModInst.getMemAddr(DataSeg->getIdx());
     auto *MemInst = *StoreMgr.getMemory(MemAddr);
 
-    /// Copy data to memory instance.
-    const auto &Data = (*ItDataSeg)->getData();
+    /// Copy data to memory instance, and drop the active segment.
     if (auto Res = MemInst->setBytes(Data, *ItOffset, 0, Data.size()); !Res) {
       return Unexpect(ErrCode::DataSegDoesNotFit);
     }
-
-    ++ItDataSeg;
+    ModInst.addData({});
     ++ItOffset;
   }
   return {};
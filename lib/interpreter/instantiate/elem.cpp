@@ -15,6 +15,11 @@ Interpreter::resolveExpression(Runtime::StoreManager &StoreMgr,
   std::vector<uint32_t> Offsets;
   /// Iterate and evaluate offsets.
   for (const auto &ElemSeg : ElemSec.getContent()) {
+    /// Only active segments have offsets.
+    if (ElemSeg->getMode() != AST::SegmentMode::Active) {
+      continue;
+    }
+
     /// Run initialize expression.
     if (auto Res = runExpression(StoreMgr, ElemSeg->getInstrs()); !Res) {
       return Unexpect(Res);
@@ -29,7 +34,9 @@ Interpreter::resolveExpression(Runtime::StoreManager &StoreMgr,
     auto *TabInst = *StoreMgr.getTable(TabAddr);
 
     /// Check offset bound.
-    if (!TabInst->checkAccessBound(Offset + ElemSeg->getFuncIdxes().size())) {
+    const size_t Size =
+        ElemSeg->getFuncIdxes().size() + ElemSeg->getInitExprs().size();
+    if (!TabInst->checkAccessBound(static_cast<uint64_t>(Offset) + Size)) {
       return Unexpect(ErrCode::ElemSegDoesNotFit);
     }
     Offsets.push_back(Offset);
@@ -41,24 +48,45 @@ Interpreter::resolveExpression(Runtime::StoreManager &StoreMgr,
 Expect<void> Interpreter::instantiate(
     Runtime::StoreManager &StoreMgr, Runtime::Instance::ModuleInstance &ModInst,
     const AST::ElementSection &ElemSec, const std::vector<uint32_t> &Offsets) {
-  auto ItElemSeg = ElemSec.getContent().cbegin();
   auto ItOffset = Offsets.cbegin();
-  while (ItOffset != Offsets.cend()) {
-    /// Get table instance.
-    uint32_t TabAddr = *ModInst.getTableAddr((*ItElemSeg)->getIdx());
-    auto *TabInst = *StoreMgr.getTable(TabAddr);
+  for (const auto &ElemSeg : ElemSec.getContent()) {
+    /// Transfer function indices to references.
+    std::vector<ValVariant> Refs;
+    Refs.reserve(ElemSeg->getFuncIdxes().size() +
+                 ElemSeg->getInitExprs().size());
+    for (const auto Idx : ElemSeg->getFuncIdxes()) {
+      Refs.push_back(genFuncRef(*ModInst.getFuncAddr(Idx)));
+    }
 
-    /// Transfer function index to address and copy data to table instance.
-    auto FuncIdxList = (*ItElemSeg)->getFuncIdxes();
-    for (auto &Idx : FuncIdxList) {
-      uint32_t FuncAddr = *ModInst.getFuncAddr(Idx);
-      Idx = FuncAddr;
+    /// Evaluate element expressions in the frame of this module.
+    if (!ElemSeg->getInitExprs().empty()) {
+      StackMgr.pushFrame(ModInst.Addr, 0, 0);
+      for (const auto &InitExpr : ElemSeg->getInitExprs()) {
+        if (auto Res = runExpression(StoreMgr, InitExpr->getInstrs()); !Res) {
+          return Unexpect(Res);
+        }
+        Refs.push_back(StackMgr.pop());
+      }
+      StackMgr.popFrame();
     }
-    if (auto Res = TabInst->setInitList(*ItOffset, FuncIdxList); !Res) {
-      return Unexpect(Res);
+
+    /// Keep passive segment for table.init. Others are dropped.
+    if (ElemSeg->getMode() != AST::SegmentMode::Active) {
+      if (ElemSeg->getMode() == AST::SegmentMode::Passive) {
+        ModInst.addElem(std::move(Refs));
+      } else {
+        ModInst.addElem({});
+      }
+      continue;
     }
 
-    ++ItElemSeg;
+    /// Get table instance and copy data to table instance.
+    uint32_t TabAddr = *ModInst.getTableAddr(ElemSeg->getIdx());
+    auto *TabInst = *StoreMgr.getTable(TabAddr);
+    if (auto Res = TabInst->setInitList(*ItOffset, Refs); !Res) {
+      return Unexpect(Res);
+    }
+    ModInst.addElem({});
     ++ItOffset;
   }
   return {};
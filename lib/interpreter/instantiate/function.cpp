@@ -16,13 +16,30 @@ Expect<void> Interpreter::instantiate(
   auto &TypeIdxs = FuncSec.getContent();
   auto &CodeSegs = CodeSec.getContent();
 
+  /// Validation shared by the function bodies decoded on their first call.
+  std::shared_ptr<const AST::CodeValidator> Validator;
+
   /// Iterate through code segments to make function instances.
   for (uint32_t I = 0; I < CodeSegs.size(); ++I) {
     /// Make a new function instance.
     auto *FuncType = *ModInst.getFuncType(TypeIdxs[I]);
-    auto NewFuncInst = std::make_unique<Runtime::Instance::FunctionInstance>(
-        ModInst.Addr, *FuncType, CodeSegs[I]->getLocals(),
-        CodeSegs[I]->getInstrs());
+    std::unique_ptr<Runtime::Instance::FunctionInstance> NewFuncInst;
+    if (CodeSegs[I]->isLoaded()) {
+      NewFuncInst = std::make_unique<Runtime::Instance::FunctionInstance>(
+          ModInst.Addr, *FuncType, CodeSegs[I]->getLocals(),
+          CodeSegs[I]->getInstrs(), CodeSegs[I]->getArena());
+    } else {
+      if (!CodeValidator) {
+        /// The module is not validated for lazy loading.
+        return Unexpect(ErrCode::ValidationFailed);
+      }
+      if (!Validator) {
+        Validator = std::make_shared<const AST::CodeValidator>(CodeValidator);
+      }
+      NewFuncInst = std::make_unique<Runtime::Instance::FunctionInstance>(
+          ModInst.Addr, *FuncType, TypeIdxs[I],
+          CodeSegs[I]->getDeferredBody(), Validator);
+    }
 
     /// Insert function instance to store manager.
     uint32_t NewFuncInstAddr;
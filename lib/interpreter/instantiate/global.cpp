@@ -12,11 +12,15 @@ Expect<void>
 Interpreter::instantiate(Runtime::StoreManager &StoreMgr,
                          Runtime::Instance::ModuleInstance &ModInst,
                          const AST::GlobalSection &GlobSec) {
-  /// Add a temp module to Store with only imported globals for initialization.
+  /// Add a temp module to Store with only imported globals and functions for
+  /// initialization.
   auto TmpMod = std::make_unique<Runtime::Instance::ModuleInstance>("");
   for (uint32_t I = 0; I < ModInst.getGlobalNum(); ++I) {
     TmpMod->addGlobalAddr(*ModInst.getGlobalAddr(I));
   }
+  for (uint32_t I = 0; I < ModInst.getFuncNum(); ++I) {
+    TmpMod->addFuncAddr(*ModInst.getFuncAddr(I));
+  }
 
   /// Insert the temp. module instance to Store.
   uint32_t TmpModInstAddr = StoreMgr.pushModule(TmpMod);
@@ -106,7 +106,7 @@ Interpreter::instantiate(Runtime::StoreManager &StoreMgr,
         return Unexpect(ErrCode::IncompatibleImportType);
       }
       /// Set the matched function address to module instance.
-      ModInst.addFuncAddr(TargetAddr);
+      ModInst.addImportedFuncAddr(TargetAddr);
       break;
     }
     case ExternalType::Table: {
@@ -116,7 +116,7 @@ Interpreter::instantiate(Runtime::StoreManager &StoreMgr,
       const auto *TargetInst = *StoreMgr.getTable(TargetAddr);
       const auto *TabLim = TabType->getLimit();
       if (TargetInst->getElementType() != TabType->getElementType() ||
-          !isLimitMatched(TargetInst->getHasMax(), TargetInst->getMin(),
+          !isLimitMatched(TargetInst->getHasMax(), TargetInst->getSize(),
                           TargetInst->getMax(), TabLim->hasMax(),
                           TabLim->getMin(), TabLim->getMax())) {
         return Unexpect(ErrCode::IncompatibleImportType);
@@ -132,7 +132,8 @@ Interpreter::instantiate(Runtime::StoreManager &StoreMgr,
       /// Import matching.
       const auto *TargetInst = *StoreMgr.getMemory(TargetAddr);
       const auto *MemLim = MemType->getLimit();
-      if (!isLimitMatched(TargetInst->getHasMax(), TargetInst->getMin(),
+      if (TargetInst->isShared() != MemLim->isShared() ||
+          !isLimitMatched(TargetInst->getHasMax(), TargetInst->getMin(),
                           TargetInst->getMax(), MemLim->hasMax(),
                           MemLim->getMin(), MemLim->getMax())) {
         return Unexpect(ErrCode::IncompatibleImportType);
@@ -152,7 +153,7 @@ Interpreter::instantiate(Runtime::StoreManager &StoreMgr,
         return Unexpect(ErrCode::IncompatibleImportType);
       }
       /// Set the matched global address to module instance.
-      ModInst.addGlobalAddr(TargetAddr);
+      ModInst.addImportedGlobalAddr(TargetAddr);
       break;
     }
     default:
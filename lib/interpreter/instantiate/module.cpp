@@ -141,7 +141,16 @@ Expect<void> Interpreter::instantiate(Runtime::StoreManager &StoreMgr,
   /// Call Ctor for compiled module
   if (auto CtorFunc = Mod.getCtor(); CtorFunc != nullptr) {
     CtorFunc(Interpreter::trapProxy, Interpreter::callProxy,
-             Interpreter::memGrowProxy, Interpreter::memSizeProxy);
+             Interpreter::memGrowProxy, Interpreter::memSizeProxy,
+             Interpreter::memInitProxy, Interpreter::dataDropProxy,
+             Interpreter::memAtomicNotifyProxy,
+             Interpreter::memAtomicWaitProxy, Interpreter::tableSizeProxy,
+             Interpreter::tableGrowProxy, Interpreter::tableGetProxy,
+             Interpreter::tableSetProxy, Interpreter::tableFillProxy,
+             Interpreter::tableInitProxy, Interpreter::tableCopyProxy,
+             Interpreter::elemDropProxy, Interpreter::refFuncProxy,
+             Interpreter::tableGetFuncIdxProxy,
+             Interpreter::callIndirectProxy);
   }
 
   /// Instantiate StartSection (StartSec)
@@ -105,5 +105,25 @@ Interpreter::invoke(Runtime::StoreManager &StoreMgr, const uint32_t FuncAddr,
   return Returns;
 }
 
+/// Copy thread-local globals. See "include/interpreter/interpreter.h".
+Expect<void> Interpreter::setThreadGlobals(Runtime::StoreManager &StoreMgr,
+                                           const uint32_t ModAddr) {
+  const auto *ModInst = *StoreMgr.getModule(ModAddr);
+  ThreadGlobInsts.clear();
+  for (uint32_t I = ModInst->getImportedGlobalNum();
+       I < ModInst->getGlobalNum(); ++I) {
+    const uint32_t GlobAddr = *ModInst->getGlobalAddr(I);
+    const auto *GlobInst = *StoreMgr.getGlobal(GlobAddr);
+    if (GlobInst->getValMut() != ValMut::Var) {
+      continue;
+    }
+    ThreadGlobInsts.emplace(
+        GlobAddr, std::make_unique<Runtime::Instance::GlobalInstance>(
+                      GlobInst->getValType(), ValMut::Var,
+                      GlobInst->getValue()));
+  }
+  return {};
+}
+
 } // namespace Interpreter
 } // namespace SSVM
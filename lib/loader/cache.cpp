@@ -0,0 +1,110 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "loader/cache.h"
+#include "common/version.h"
+#include "support/hash.h"
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include <unistd.h>
+
+namespace SSVM {
+namespace Loader {
+
+namespace {
+
+constexpr uint8_t kCacheMagic[8] = {0x00U, 0x73U, 0x73U, 0x76U,
+                                    0x6DU, 0x63U, 0x0DU, 0x0AU};
+constexpr uint32_t kCacheFormat = 1;
+
+uint64_t checksum(const CacheHeader &Header) {
+  return hash64(Span<const uint8_t>(reinterpret_cast<const uint8_t *>(&Header),
+                                    offsetof(CacheHeader, Checksum)));
+}
+
+} // namespace
+
+/// Check module cache magic. See "include/loader/cache.h".
+bool isModuleCache(Span<const Byte> Data) {
+  return Data.size() >= sizeof(kCacheMagic) &&
+         std::memcmp(Data.data(), kCacheMagic, sizeof(kCacheMagic)) == 0;
+}
+
+/// Read module cache header. See "include/loader/cache.h".
+Expect<CacheHeader> readCacheHeader(Span<const Byte> Data) {
+  if (Data.size() < sizeof(CacheHeader) || !isModuleCache(Data)) {
+    return Unexpect(ErrCode::InvalidGrammar);
+  }
+  CacheHeader Header;
+  std::memcpy(&Header, Data.data(), sizeof(Header));
+  if (Header.Checksum != checksum(Header)) {
+    return Unexpect(ErrCode::InvalidGrammar);
+  }
+  if (Header.Format != kCacheFormat || Header.BuildVersion != kVersion ||
+      !(Header.Flags & kCacheValidated)) {
+    return Unexpect(ErrCode::InvalidVersion);
+  }
+  return Header;
+}
+
+/// Read module cache. See "include/loader/cache.h".
+Expect<SharedBytes> readModuleCache(const SharedBytes &Data) {
+  auto Header = readCacheHeader(Data.getSpan());
+  if (!Header) {
+    return Unexpect(Header);
+  }
+  if (Header->ModuleSize != Data.size() - sizeof(CacheHeader)) {
+    return Unexpect(ErrCode::EndOfFile);
+  }
+  auto Wasm = Data.slice(sizeof(CacheHeader), Header->ModuleSize);
+  if (hash64(Wasm.getSpan()) != Header->ModuleHash) {
+    return Unexpect(ErrCode::InvalidGrammar);
+  }
+  return Wasm;
+}
+
+/// Write module cache. See "include/loader/cache.h".
+Expect<void> writeModuleCache(const std::string &Path, Span<const Byte> Wasm) {
+  CacheHeader Header;
+  std::memcpy(Header.Magic, kCacheMagic, sizeof(kCacheMagic));
+  Header.Format = kCacheFormat;
+  Header.Flags = kCacheValidated;
+  Header.BuildVersion = kVersion;
+  Header.ModuleHash = hash64(Wasm);
+  Header.ModuleSize = Wasm.size();
+  Header.Checksum = checksum(Header);
+
+  /// Write to a temporary file first, so readers never see a partial file.
+  const std::string TmpPath = Path + '.' + std::to_string(getpid());
+  {
+    std::ofstream Fout(TmpPath, std::ios::out | std::ios::binary);
+    if (!Fout) {
+      return Unexpect(ErrCode::InvalidPath);
+    }
+    Fout.write(reinterpret_cast<const char *>(&Header), sizeof(Header));
+    Fout.write(reinterpret_cast<const char *>(Wasm.data()), Wasm.size());
+    if (!Fout.flush()) {
+      Fout.close();
+      std::remove(TmpPath.c_str());
+      return Unexpect(ErrCode::InvalidPath);
+    }
+  }
+  if (std::rename(TmpPath.c_str(), Path.c_str()) != 0) {
+    std::remove(TmpPath.c_str());
+    return Unexpect(ErrCode::InvalidPath);
+  }
+  return {};
+}
+
+/// Get path of cache file. See "include/loader/cache.h".
+std::string getModuleCachePath(const std::string &Dir, uint64_t ModuleHash) {
+  char Name[32];
+  std::snprintf(Name, sizeof(Name), "%016llx.ssvmc",
+                static_cast<unsigned long long>(ModuleHash));
+  return Dir + '/' + Name;
+}
+
+} // namespace Loader
+} // namespace SSVM
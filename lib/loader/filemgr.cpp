@@ -1,11 +1,27 @@
 // SPDX-License-Identifier: Apache-2.0
 #include "loader/filemgr.h"
+#include "loader/leb128.h"
 
 #include <algorithm>
+#include <cstring>
 #include <iterator>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 namespace SSVM {
 
+/// Read number of bytes with shared ownership. See "include/loader/filemgr.h".
+Expect<SharedBytes> FileMgr::readSharedBytes(size_t SizeToRead) {
+  if (auto Res = readBytes(SizeToRead)) {
+    return SharedBytes(std::move(*Res));
+  } else {
+    return Unexpect(Res);
+  }
+}
+
 /// Destructor of file manager. See "include/loader/filemgr.h".
 FileMgrFStream::~FileMgrFStream() noexcept {
   if (Fin.is_open()) {
@@ -212,8 +228,13 @@ Expect<std::string> FileMgrFStream::readName() {
 }
 
 /// Set code data. See "include/loader/filemgr.h".
-Expect<void> FileMgrVector::setCode(const std::vector<uint8_t> &CodeData) {
-  Code = CodeData;
+Expect<void> FileMgrVector::setCode(const Bytes &CodeData) {
+  return setCode(SharedBytes(Bytes(CodeData)));
+}
+
+/// Set shared code data. See "include/loader/filemgr.h".
+Expect<void> FileMgrVector::setCode(SharedBytes CodeData) {
+  Code = std::move(CodeData);
   Pos = 0;
   if (Code.size() == 0) {
     Status = ErrCode::EndOfFile;
@@ -229,7 +250,7 @@ Expect<Byte> FileMgrVector::readByte() {
     Status = ErrCode::EndOfFile;
     return Unexpect(Status);
   }
-  return Code[Pos++];
+  return Code.data()[Pos++];
 }
 
 /// Read number of bytes. See "include/loader/filemgr.h".
@@ -247,78 +268,60 @@ Expect<Bytes> FileMgrVector::readBytes(size_t SizeToRead) {
   return Buf;
 }
 
+/// Read number of bytes in place. See "include/loader/filemgr.h".
+Expect<SharedBytes> FileMgrVector::readSharedBytes(size_t SizeToRead) {
+  if (Pos + SizeToRead > Code.size()) {
+    Pos = Code.size();
+    Status = ErrCode::EndOfFile;
+    return Unexpect(Status);
+  }
+  SharedBytes Buf = Code.slice(Pos, SizeToRead);
+  Pos += SizeToRead;
+  return Buf;
+}
+
 /// Decode and read an unsigned int. See "include/loader/filemgr.h".
 Expect<uint32_t> FileMgrVector::readU32() {
-  uint32_t Result = 0;
-  uint32_t Offset = 0;
-  uint8_t Byte = 0x80;
-  while (Byte & 0x80) {
-    if (Pos >= Code.size()) {
-      Status = ErrCode::EndOfFile;
-      return Unexpect(Status);
-    }
-    Byte = Code[Pos++];
-    Result |= (Byte & 0x7F) << (Offset);
-    Offset += 7;
+  const Byte *Ptr = Code.data() + Pos;
+  auto Res = LEB128::readU32(Ptr, Code.data() + Code.size());
+  Pos = Ptr - Code.data();
+  if (!Res) {
+    Status = Res.error();
   }
-  return Result;
+  return Res;
 }
 
 /// Decode and read an unsigned long long int. See "include/loader/filemgr.h".
 Expect<uint64_t> FileMgrVector::readU64() {
-  uint64_t Result = 0;
-  uint64_t Offset = 0;
-  uint8_t Byte = 0x80;
-  while (Byte & 0x80) {
-    if (Pos >= Code.size()) {
-      Status = ErrCode::EndOfFile;
-      return Unexpect(Status);
-    }
-    Byte = Code[Pos++];
-    Result |= static_cast<uint64_t>(Byte & 0x7F) << (Offset);
-    Offset += 7;
+  const Byte *Ptr = Code.data() + Pos;
+  auto Res = LEB128::readU64(Ptr, Code.data() + Code.size());
+  Pos = Ptr - Code.data();
+  if (!Res) {
+    Status = Res.error();
   }
-  return Result;
+  return Res;
 }
 
 /// Decode and read a signed int. See "include/loader/filemgr.h".
 Expect<int32_t> FileMgrVector::readS32() {
-  int32_t Result = 0;
-  uint32_t Offset = 0;
-  uint8_t Byte = 0x80;
-  while (Byte & 0x80) {
-    if (Pos >= Code.size()) {
-      Status = ErrCode::EndOfFile;
-      return Unexpect(Status);
-    }
-    Byte = Code[Pos++];
-    Result |= (Byte & UINT32_C(0x7F)) << Offset;
-    Offset += 7;
-  }
-  if (Byte & 0x40 && Offset < 32) {
-    Result |= 0xFFFFFFFF << Offset;
+  const Byte *Ptr = Code.data() + Pos;
+  auto Res = LEB128::readS32(Ptr, Code.data() + Code.size());
+  Pos = Ptr - Code.data();
+  if (!Res) {
+    Status = Res.error();
   }
-  return Result;
+  return Res;
 }
 
 /// Decode and read a signed long long int. See "include/loader/filemgr.h".
 Expect<int64_t> FileMgrVector::readS64() {
-  int64_t Result = 0;
-  uint64_t Offset = 0;
-  uint8_t Byte = 0x80;
-  while (Byte & 0x80) {
-    if (Pos >= Code.size()) {
-      Status = ErrCode::EndOfFile;
-      return Unexpect(Status);
-    }
-    Byte = Code[Pos++];
-    Result |= (Byte & UINT64_C(0x7F)) << Offset;
-    Offset += 7;
-  }
-  if (Byte & 0x40 && Offset < 64) {
-    Result |= 0xFFFFFFFFFFFFFFFFULL << Offset;
+  const Byte *Ptr = Code.data() + Pos;
+  auto Res = LEB128::readS64(Ptr, Code.data() + Code.size());
+  Pos = Ptr - Code.data();
+  if (!Res) {
+    Status = Res.error();
   }
-  return Result;
+  return Res;
 }
 
 /// Copy bytes to a float. See "include/loader/filemgr.h".
@@ -334,7 +337,7 @@ Expect<float> FileMgrVector::readF32() {
   } Val;
   Val.U = 0;
   for (int i = 0; i < 4; i++) {
-    Val.U |= (Code[Pos++] & 0xFF) << (i * 8);
+    Val.U |= (Code.data()[Pos++] & 0xFF) << (i * 8);
   }
   return Val.F;
 }
@@ -352,7 +355,7 @@ Expect<double> FileMgrVector::readF64() {
   } Val;
   Val.U = 0;
   for (int i = 0; i < 8; i++) {
-    Val.U |= static_cast<uint64_t>(Code[Pos++] & 0xFF) << (i * 8);
+    Val.U |= static_cast<uint64_t>(Code.data()[Pos++] & 0xFF) << (i * 8);
   }
   return Val.D;
 }
@@ -376,4 +379,177 @@ Expect<std::string> FileMgrVector::readName() {
   return Str;
 }
 
+/// Map file read-only. See "include/loader/filemgr.h".
+Expect<void> FileMgrMmap::setPath(const std::string &FilePath) {
+  clearBuffer();
+  const int Fd = open(FilePath.c_str(), O_RDONLY | O_CLOEXEC);
+  if (Fd < 0) {
+    return Unexpect(Status);
+  }
+  struct stat Stat;
+  if (fstat(Fd, &Stat) != 0 || !S_ISREG(Stat.st_mode)) {
+    close(Fd);
+    return Unexpect(Status);
+  }
+  Size = static_cast<size_t>(Stat.st_size);
+  if (Size > 0) {
+    void *Addr = mmap(nullptr, Size, PROT_READ, MAP_PRIVATE, Fd, 0);
+    if (Addr == MAP_FAILED) {
+      close(Fd);
+      Size = 0;
+      Status = ErrCode::ReadError;
+      return Unexpect(Status);
+    }
+    /// Sections are decoded front to back.
+    madvise(Addr, Size, MADV_SEQUENTIAL);
+    Data = static_cast<const Byte *>(Addr);
+    Map = std::shared_ptr<const Byte>(
+        Data, [MapSize = Size](const Byte *Ptr) {
+          munmap(const_cast<Byte *>(Ptr), MapSize);
+        });
+  }
+  close(Fd);
+  Status = ErrCode::Success;
+  return {};
+}
+
+/// Check remaining size. See "include/loader/filemgr.h".
+Expect<void> FileMgrMmap::checkRead(size_t SizeToRead) {
+  if (Status != ErrCode::Success) {
+    return Unexpect(Status);
+  }
+  if (SizeToRead > Size - Pos) {
+    Pos = Size;
+    Status = ErrCode::EndOfFile;
+    return Unexpect(Status);
+  }
+  return {};
+}
+
+/// Read one byte. See "include/loader/filemgr.h".
+Expect<Byte> FileMgrMmap::readByte() {
+  if (auto Res = checkRead(1); !Res) {
+    return Unexpect(Res);
+  }
+  return Data[Pos++];
+}
+
+/// Read number of bytes. See "include/loader/filemgr.h".
+Expect<Bytes> FileMgrMmap::readBytes(size_t SizeToRead) {
+  if (auto Res = checkRead(SizeToRead); !Res) {
+    return Unexpect(Res);
+  }
+  Bytes Buf(Data + Pos, Data + Pos + SizeToRead);
+  Pos += SizeToRead;
+  return Buf;
+}
+
+/// Read number of bytes in place. See "include/loader/filemgr.h".
+Expect<SharedBytes> FileMgrMmap::readSharedBytes(size_t SizeToRead) {
+  if (auto Res = checkRead(SizeToRead); !Res) {
+    return Unexpect(Res);
+  }
+  SharedBytes Buf(Map, Span<const Byte>(Data + Pos, SizeToRead));
+  Pos += SizeToRead;
+  return Buf;
+}
+
+/// Decode and read an unsigned int. See "include/loader/filemgr.h".
+Expect<uint32_t> FileMgrMmap::readU32() {
+  if (Status != ErrCode::Success) {
+    return Unexpect(Status);
+  }
+  const Byte *Ptr = Data + Pos;
+  auto Res = LEB128::readU32(Ptr, Data + Size);
+  Pos = Ptr - Data;
+  if (!Res) {
+    Status = Res.error();
+  }
+  return Res;
+}
+
+/// Decode and read an unsigned long long int. See "include/loader/filemgr.h".
+Expect<uint64_t> FileMgrMmap::readU64() {
+  if (Status != ErrCode::Success) {
+    return Unexpect(Status);
+  }
+  const Byte *Ptr = Data + Pos;
+  auto Res = LEB128::readU64(Ptr, Data + Size);
+  Pos = Ptr - Data;
+  if (!Res) {
+    Status = Res.error();
+  }
+  return Res;
+}
+
+/// Decode and read a signed int. See "include/loader/filemgr.h".
+Expect<int32_t> FileMgrMmap::readS32() {
+  if (Status != ErrCode::Success) {
+    return Unexpect(Status);
+  }
+  const Byte *Ptr = Data + Pos;
+  auto Res = LEB128::readS32(Ptr, Data + Size);
+  Pos = Ptr - Data;
+  if (!Res) {
+    Status = Res.error();
+  }
+  return Res;
+}
+
+/// Decode and read a signed long long int. See "include/loader/filemgr.h".
+Expect<int64_t> FileMgrMmap::readS64() {
+  if (Status != ErrCode::Success) {
+    return Unexpect(Status);
+  }
+  const Byte *Ptr = Data + Pos;
+  auto Res = LEB128::readS64(Ptr, Data + Size);
+  Pos = Ptr - Data;
+  if (!Res) {
+    Status = Res.error();
+  }
+  return Res;
+}
+
+/// Copy bytes to a float. See "include/loader/filemgr.h".
+Expect<float> FileMgrMmap::readF32() {
+  if (auto Res = checkRead(4); !Res) {
+    return Unexpect(Res);
+  }
+  uint32_t U = 0;
+  for (int I = 0; I < 4; I++) {
+    U |= static_cast<uint32_t>(Data[Pos++]) << (I * 8);
+  }
+  float F;
+  std::memcpy(&F, &U, sizeof(F));
+  return F;
+}
+
+/// Copy bytes to a double. See "include/loader/filemgr.h".
+Expect<double> FileMgrMmap::readF64() {
+  if (auto Res = checkRead(8); !Res) {
+    return Unexpect(Res);
+  }
+  uint64_t U = 0;
+  for (int I = 0; I < 8; I++) {
+    U |= static_cast<uint64_t>(Data[Pos++]) << (I * 8);
+  }
+  double D;
+  std::memcpy(&D, &U, sizeof(D));
+  return D;
+}
+
+/// Read a vector of bytes. See "include/loader/filemgr.h".
+Expect<std::string> FileMgrMmap::readName() {
+  Expect<uint32_t> NameSize = readU32();
+  if (!NameSize) {
+    return Unexpect(NameSize);
+  }
+  if (auto Res = checkRead(*NameSize); !Res) {
+    return Unexpect(Res);
+  }
+  std::string Str(reinterpret_cast<const char *>(Data + Pos), *NameSize);
+  Pos += *NameSize;
+  return Str;
+}
+
 } // namespace SSVM
@@ -1,10 +1,18 @@
 // SPDX-License-Identifier: Apache-2.0
 #include "loader/loader.h"
 #include "common/version.h"
+#include "loader/cache.h"
+#include "loader/stream.h"
+#include "support/hash.h"
 #include "support/log.h"
 
+#include <cerrno>
 #include <string_view>
 
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 namespace SSVM {
 namespace Loader {
 
@@ -83,25 +91,136 @@ Loader::parseModule(const std::string &FilePath) {
       return Unexpect(Res);
     }
   } else {
-    auto Mod = std::make_unique<AST::Module>();
-    if (auto Res = FSMgr.setPath(FilePath); !Res) {
+    /// Pipes, sockets, and character devices cannot be mapped. Parse them
+    /// while the bytes are arriving instead.
+    struct stat Stat;
+    if (stat(FilePath.c_str(), &Stat) == 0 && !S_ISREG(Stat.st_mode) &&
+        !S_ISDIR(Stat.st_mode)) {
+      const int Fd = open(FilePath.c_str(), O_RDONLY | O_CLOEXEC);
+      if (Fd < 0) {
+        Log::loggingError(ErrCode::InvalidPath);
+        return Unexpect(ErrCode::InvalidPath);
+      }
+      auto Res = parseModule(Fd);
+      close(Fd);
+      return Res;
+    }
+
+    if (auto Res = FMMgr.setPath(FilePath); !Res) {
       Log::loggingError(Res.error());
       return Unexpect(Res);
     }
-    if (auto Res = Mod->loadBinary(FSMgr)) {
-      return std::move(Mod);
+    SharedBytes Data;
+    if (auto Res = FMMgr.readSharedBytes(FMMgr.getRemainSize())) {
+      Data = std::move(*Res);
     } else {
       Log::loggingError(Res.error());
       return Unexpect(Res);
     }
+    /// A cache file given by path is run as its module. It is not trusted
+    /// since it does not come from the cache directory, so the bodies are
+    /// validated on their first call as in lazy loading.
+    if (isModuleCache(Data.getSpan())) {
+      if (auto Res = readModuleCache(Data)) {
+        Data = std::move(*Res);
+      } else {
+        Log::loggingError(Res.error());
+        return Unexpect(Res);
+      }
+      return parseBinary(std::move(Data), true);
+    }
+    return parseBinary(std::move(Data), IsLazyCode);
+  }
+}
+
+/// Parse module from file descriptor. See "include/loader/loader.h".
+Expect<std::unique_ptr<AST::Module>> Loader::parseModule(const int Fd) {
+  StreamLoader Stream;
+  Stream.setLazyCode(IsLazyCode);
+  Bytes Chunk(kStreamChunkSize);
+  while (true) {
+    const ssize_t Size = read(Fd, Chunk.data(), Chunk.size());
+    if (Size < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      Log::loggingError(ErrCode::ReadError);
+      return Unexpect(ErrCode::ReadError);
+    }
+    if (Size == 0) {
+      break;
+    }
+    if (auto Res = Stream.feed(Span<const Byte>(Chunk.data(), Size)); !Res) {
+      Log::loggingError(Res.error());
+      return Unexpect(Res);
+    }
+  }
+  if (auto Res = Stream.finish()) {
+    return std::move(*Res);
+  } else {
+    Log::loggingError(Res.error());
+    return Unexpect(Res);
   }
 }
 
 /// Parse module from byte code. See "include/loader/loader.h".
 Expect<std::unique_ptr<AST::Module>>
 Loader::parseModule(const std::vector<uint8_t> &Code) {
+  return parseBinary(SharedBytes(Bytes(Code)), IsLazyCode);
+}
+
+/// Store module cache. See "include/loader/loader.h".
+Expect<void> Loader::saveCache(const AST::Module &Mod) {
+  const auto &Source = Mod.getSource();
+  if (CacheDir.empty() || Mod.isValidated() || Source.empty()) {
+    return {};
+  }
+  /// Function bodies skipped in lazy loading are not validated yet.
+  if (const auto *CodeSec = Mod.getCodeSection()) {
+    for (const auto &CodeSeg : CodeSec->getContent()) {
+      if (!CodeSeg->isLoaded()) {
+        return {};
+      }
+    }
+  }
+  mkdir(CacheDir.c_str(), 0700);
+  return writeModuleCache(getModuleCachePath(CacheDir, hash64(Source.getSpan())),
+                          Source.getSpan());
+}
+
+/// Parse module from binary. See "include/loader/loader.h".
+Expect<std::unique_ptr<AST::Module>>
+Loader::parseBinary(SharedBytes Data, const bool LazyCode) {
   auto Mod = std::make_unique<AST::Module>();
-  if (auto Res = FVMgr.setCode(Code); !Res) {
+  Mod->setLazyCode(LazyCode);
+  bool Validated = false;
+  if (!CacheDir.empty()) {
+    /// Look up the cache keyed by module hash. Only a cache in the directory
+    /// is trusted, and it records the validation of the module with the same
+    /// hash and size, so only its header is read. Any failure is a cache
+    /// miss.
+    const auto Hash = hash64(Data.getSpan());
+    std::ifstream Fin(getModuleCachePath(CacheDir, Hash),
+                      std::ios::in | std::ios::binary);
+    Byte Head[sizeof(CacheHeader)];
+    if (Fin.read(reinterpret_cast<char *>(Head), sizeof(Head))) {
+      if (auto Header = readCacheHeader(Span<const Byte>(Head))) {
+        Validated =
+            Header->ModuleHash == Hash && Header->ModuleSize == Data.size();
+      }
+    }
+    if (!Validated) {
+      Mod->setSource(Data);
+    }
+  }
+  if (Validated) {
+    /// The module is validated, so function bodies are decoded on demand and
+    /// not validated again.
+    Mod->setLazyCode(true);
+    Mod->setValidated(true);
+  }
+
+  if (auto Res = FVMgr.setCode(std::move(Data)); !Res) {
     Log::loggingError(Res.error());
     return Unexpect(Res);
   }
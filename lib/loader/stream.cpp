@@ -0,0 +1,235 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "loader/stream.h"
+#include "loader/filemgr.h"
+#include "loader/leb128.h"
+
+#include <algorithm>
+
+namespace SSVM {
+namespace Loader {
+
+namespace {
+
+/// Copy the range of buffer into a new shared buffer.
+SharedBytes copyRange(const Bytes &Buffer, size_t Begin, size_t End) {
+  return SharedBytes(Bytes(Buffer.begin() + Begin, Buffer.begin() + End));
+}
+
+} // namespace
+
+/// Constructor of streaming loader. See "include/loader/stream.h".
+StreamLoader::StreamLoader() : Mod(std::make_unique<AST::Module>()) {}
+
+/// Append bytes and parse. See "include/loader/stream.h".
+Expect<void> StreamLoader::feed(Span<const Byte> Chunk) {
+  if (Status != ErrCode::Success) {
+    return Unexpect(Status);
+  }
+  /// Drop the parsed bytes before appending, if they are the majority.
+  if (Pos > 0 && Pos * 2 >= Buffer.size()) {
+    Buffer.erase(Buffer.begin(), Buffer.begin() + Pos);
+    CodeEnd -= std::min(CodeEnd, Pos);
+    Pos = 0;
+  }
+  Buffer.insert(Buffer.end(), Chunk.begin(), Chunk.end());
+
+  if (auto Res = parse(); !Res) {
+    Status = Res.error();
+    return Unexpect(Res);
+  }
+  /// Parse the received function bodies before waiting for more bytes.
+  if (auto Res = flushCode(); !Res) {
+    Status = Res.error();
+    return Unexpect(Res);
+  }
+  return {};
+}
+
+/// Finish loading. See "include/loader/stream.h".
+Expect<std::unique_ptr<AST::Module>> StreamLoader::finish() {
+  if (Status != ErrCode::Success) {
+    return Unexpect(Status);
+  }
+  /// The module should end between sections.
+  if (St != State::Section || Pos != Buffer.size()) {
+    Status = ErrCode::EndOfFile;
+    return Unexpect(Status);
+  }
+  return std::move(Mod);
+}
+
+/// Parse the completed parts of buffer. See "include/loader/stream.h".
+Expect<void> StreamLoader::parse() {
+  while (true) {
+    switch (St) {
+    case State::Header: {
+      /// Magic and Version sequences.
+      if (Buffer.size() - Pos < 8) {
+        return {};
+      }
+      FileMgrVector Mgr;
+      Mgr.setCode(copyRange(Buffer, Pos, Pos + 8));
+      if (auto Res = Mod->loadHeader(Mgr); !Res) {
+        return Unexpect(Res);
+      }
+      Pos += 8;
+      St = State::Section;
+      break;
+    }
+    case State::Section: {
+      /// Wait for the section ID and the content size.
+      if (Pos == Buffer.size()) {
+        return {};
+      }
+      const uint8_t Id = Buffer[Pos];
+      const Byte *Ptr = Buffer.data() + Pos + 1;
+      const Byte *End = Buffer.data() + Buffer.size();
+      uint32_t Size = 0;
+      if (auto Res = LEB128::readU32(Ptr, End)) {
+        Size = *Res;
+      } else if (Res.error() == ErrCode::EndOfFile) {
+        return {};
+      } else {
+        return Unexpect(Res);
+      }
+      const size_t Begin = Ptr - Buffer.data();
+      if (Id == 0x0AU) {
+        /// Code section: read segments one by one.
+        Mod->initCodeSection();
+        Pos = Begin;
+        CodeEnd = Begin + Size;
+        St = State::CodeCount;
+        break;
+      }
+      /// Other sections: wait for the whole content.
+      if (static_cast<size_t>(End - Ptr) < Size) {
+        return {};
+      }
+      FileMgrVector Mgr;
+      Mgr.setCode(copyRange(Buffer, Pos + 1, Begin + Size));
+      if (auto Res = Mod->loadSection(Id, Mgr); !Res) {
+        return Unexpect(Res);
+      }
+      if (Mgr.getRemainSize() != 0) {
+        return Unexpect(ErrCode::InvalidGrammar);
+      }
+      Pos = Begin + Size;
+      break;
+    }
+    case State::CodeCount:
+    case State::CodeBody:
+      if (auto Res = parseCode()) {
+        if (!*Res) {
+          return {};
+        }
+      } else {
+        return Unexpect(Res);
+      }
+      break;
+    default:
+      return Unexpect(ErrCode::InvalidGrammar);
+    }
+  }
+}
+
+/// Parse the completed parts of code section. See "include/loader/stream.h".
+Expect<bool> StreamLoader::parseCode() {
+  const size_t Limit = std::min(Buffer.size(), CodeEnd);
+  const Byte *End = Buffer.data() + Limit;
+  /// Truncated number is an error only if the code section has all arrived.
+  const auto Truncated = [&](ErrCode Code) -> Expect<bool> {
+    if (Code == ErrCode::EndOfFile && Limit < CodeEnd) {
+      return false;
+    }
+    return Unexpect(Code);
+  };
+
+  if (St == State::CodeCount) {
+    const Byte *Ptr = Buffer.data() + Pos;
+    if (auto Res = LEB128::readU32(Ptr, End)) {
+      CodeLeft = *Res;
+    } else {
+      return Truncated(Res.error());
+    }
+    Pos = Ptr - Buffer.data();
+    St = State::CodeBody;
+  }
+
+  /// Find the arrived segments, and copy them out of buffer at once.
+  std::vector<std::pair<size_t, size_t>> Ranges;
+  bool Waiting = false;
+  while (CodeLeft > Ranges.size()) {
+    const size_t Begin = Ranges.empty() ? Pos : Ranges.back().second;
+    const Byte *Ptr = Buffer.data() + Begin;
+    uint32_t Size = 0;
+    if (auto Res = LEB128::readU32(Ptr, End)) {
+      Size = *Res;
+    } else if (auto Wait = Truncated(Res.error())) {
+      Waiting = true;
+      break;
+    } else {
+      return Unexpect(Wait);
+    }
+    if (static_cast<size_t>(End - Ptr) < Size) {
+      if (Limit < CodeEnd) {
+        Waiting = true;
+        break;
+      }
+      return Unexpect(ErrCode::EndOfFile);
+    }
+    Ranges.emplace_back(Begin, (Ptr - Buffer.data()) + Size);
+  }
+  if (!Ranges.empty()) {
+    const size_t First = Ranges.front().first;
+    const SharedBytes Chunk = copyRange(Buffer, First, Ranges.back().second);
+    for (const auto &[Begin, Stop] : Ranges) {
+      FileMgrVector Mgr;
+      Mgr.setCode(Chunk.slice(Begin - First, Stop - Begin));
+      auto NewSeg = std::make_unique<AST::CodeSegment>();
+      if (auto Res = NewSeg->loadSize(Mgr)) {
+        BodySize += Res->size();
+        Bodies.push_back(std::move(*Res));
+        Segs.push_back(std::move(NewSeg));
+      } else {
+        return Unexpect(Res);
+      }
+    }
+    Pos = Ranges.back().second;
+    CodeLeft -= Ranges.size();
+    if (BodySize >= kFlushSize) {
+      if (auto Res = flushCode(); !Res) {
+        return Unexpect(Res);
+      }
+    }
+  }
+  if (Waiting) {
+    return false;
+  }
+
+  /// All segments are read, which should end at the end of section.
+  if (Pos != CodeEnd) {
+    return Unexpect(ErrCode::InvalidGrammar);
+  }
+  if (auto Res = flushCode(); !Res) {
+    return Unexpect(Res);
+  }
+  St = State::Section;
+  return true;
+}
+
+/// Parse the batched code segments. See "include/loader/stream.h".
+Expect<void> StreamLoader::flushCode() {
+  if (Segs.empty()) {
+    return {};
+  }
+  auto NewSegs = std::move(Segs);
+  auto NewBodies = std::move(Bodies);
+  Segs.clear();
+  Bodies.clear();
+  BodySize = 0;
+  return Mod->initCodeSection().loadSegments(std::move(NewSegs),
+                                             std::move(NewBodies));
+}
+
+} // namespace Loader
+} // namespace SSVM
@@ -0,0 +1,31 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "support/arena.h"
+
+#include <algorithm>
+
+namespace SSVM {
+
+/// Destructor of arena. See "include/support/arena.h".
+Arena::~Arena() noexcept {
+  while (Head) {
+    Block *Prev = Head->Prev;
+    ::operator delete(Head);
+    Head = Prev;
+  }
+}
+
+/// Allocate in a new block. See "include/support/arena.h".
+void *Arena::allocateSlow(size_t Size, size_t Align) {
+  const size_t BlockSize =
+      std::max(NextSize, sizeof(Block) + Size + Align - 1);
+  auto *NewBlock = static_cast<Block *>(::operator new(BlockSize));
+  NewBlock->Prev = Head;
+  Head = NewBlock;
+  ++BlockCount;
+  NextSize = std::min(NextSize * 2, kMaxBlockSize);
+  Curr = reinterpret_cast<std::byte *>(NewBlock + 1);
+  End = reinterpret_cast<std::byte *>(NewBlock) + BlockSize;
+  return allocate(Size, Align);
+}
+
+} // namespace SSVM
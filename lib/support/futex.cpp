@@ -0,0 +1,39 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "support/futex.h"
+
+#include <cerrno>
+#include <climits>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace SSVM {
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t));
+
+/// Sleep on the word. See "include/support/futex.h".
+bool futexWait(std::atomic<uint32_t> &Word, uint32_t Expected,
+               int64_t Timeout) {
+  struct timespec Spec;
+  struct timespec *SpecPtr = nullptr;
+  if (Timeout >= 0) {
+    Spec.tv_sec = Timeout / 1000000000;
+    Spec.tv_nsec = Timeout % 1000000000;
+    SpecPtr = &Spec;
+  }
+  if (syscall(SYS_futex, reinterpret_cast<uint32_t *>(&Word),
+              FUTEX_WAIT_PRIVATE, Expected, SpecPtr, nullptr, 0) != 0) {
+    return errno != ETIMEDOUT;
+  }
+  return true;
+}
+
+/// Wake the sleeping threads. See "include/support/futex.h".
+void futexWake(std::atomic<uint32_t> &Word, uint32_t Count) {
+  syscall(SYS_futex, reinterpret_cast<uint32_t *>(&Word), FUTEX_WAKE_PRIVATE,
+          static_cast<int>(Count > INT_MAX ? INT_MAX : Count), nullptr,
+          nullptr, 0);
+}
+
+} // namespace SSVM
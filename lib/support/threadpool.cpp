@@ -0,0 +1,101 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "support/threadpool.h"
+
+#include <unistd.h>
+
+namespace SSVM {
+
+/// Constructor of thread pool. See "include/support/threadpool.h".
+ThreadPool::ThreadPool(uint32_t WorkerCount) : Owner(getpid()) {
+  Workers.reserve(WorkerCount);
+  for (uint32_t I = 0; I < WorkerCount; ++I) {
+    Workers.emplace_back(&ThreadPool::workerLoop, this);
+  }
+}
+
+/// Destructor of thread pool. See "include/support/threadpool.h".
+ThreadPool::~ThreadPool() {
+  {
+    std::unique_lock Lock(Mutex);
+    Stop = true;
+  }
+  WakeUp.notify_all();
+  for (auto &Worker : Workers) {
+    if (getpid() == Owner) {
+      Worker.join();
+    } else {
+      Worker.detach();
+    }
+  }
+}
+
+/// Get the default thread pool. See "include/support/threadpool.h".
+ThreadPool &ThreadPool::getDefault() {
+  static ThreadPool Pool([]() -> uint32_t {
+    const uint32_t Concurrency = std::thread::hardware_concurrency();
+    return Concurrency > 1 ? Concurrency - 1 : 0;
+  }());
+  return Pool;
+}
+
+/// Run tasks of a loop. See "include/support/threadpool.h".
+void ThreadPool::parallelFor(size_t N, const std::function<void(size_t)> &Func) {
+  std::unique_lock LoopLock(LoopMutex, std::try_to_lock);
+  if (N <= 1 || Workers.empty() || !LoopLock.owns_lock() ||
+      getpid() != Owner) {
+    for (size_t I = 0; I < N; ++I) {
+      Func(I);
+    }
+    return;
+  }
+
+  {
+    std::unique_lock Lock(Mutex);
+    Task = &Func;
+    TaskCount = N;
+    NextTask.store(0, std::memory_order_relaxed);
+    Running = Workers.size();
+    ++Generation;
+  }
+  WakeUp.notify_all();
+  runTasks();
+
+  std::unique_lock Lock(Mutex);
+  Finished.wait(Lock, [this]() { return Running == 0; });
+  Task = nullptr;
+}
+
+/// Take tasks of the current loop. See "include/support/threadpool.h".
+void ThreadPool::runTasks() {
+  while (true) {
+    const size_t I = NextTask.fetch_add(1, std::memory_order_relaxed);
+    if (I >= TaskCount) {
+      break;
+    }
+    (*Task)(I);
+  }
+}
+
+/// Worker thread body. See "include/support/threadpool.h".
+void ThreadPool::workerLoop() {
+  uint64_t Seen = 0;
+  while (true) {
+    {
+      std::unique_lock Lock(Mutex);
+      WakeUp.wait(Lock, [&]() { return Stop || Generation != Seen; });
+      if (Stop) {
+        return;
+      }
+      Seen = Generation;
+    }
+    runTasks();
+    {
+      std::unique_lock Lock(Mutex);
+      if (--Running == 0) {
+        Finished.notify_one();
+      }
+    }
+  }
+}
+
+} // namespace SSVM
@@ -12,12 +12,8 @@ void FormChecker::reset(bool CleanGlobal) {
   Returns.clear();
 
   if (CleanGlobal) {
-    Types.clear();
-    Funcs.clear();
-    Tables.clear();
-    Mems.clear();
-    Globals.clear();
-    NumImportGlobals = 0;
+    Owned = std::make_shared<FormContext>();
+    Context = Owned;
   }
 }
 
@@ -47,38 +43,61 @@ void FormChecker::addType(const AST::FunctionType &Func) {
   for (auto Val : Func.getReturnTypes()) {
     Ret.emplace_back(ASTToVType(Val));
   }
-  Types.emplace_back(Param, Ret);
+  getMutableContext().Types.emplace_back(Param, Ret);
 }
 
 void FormChecker::addFunc(const uint32_t &TypeIdx) {
-  if (Types.size() > TypeIdx) {
-    Funcs.emplace_back(TypeIdx);
+  if (getTypes().size() > TypeIdx) {
+    getMutableContext().Funcs.emplace_back(TypeIdx);
   }
 }
 
 void FormChecker::addTable(const AST::TableType &Tab) {
-  Tables.emplace_back(Tab.getElementType());
+  getMutableContext().Tables.emplace_back(Tab.getElementType());
 }
 
 void FormChecker::addMemory(const AST::MemoryType &Mem) {
+  auto &Mems = getMutableContext().Mems;
   Mems.emplace_back(Mems.size());
 }
 
 void FormChecker::addGlobal(const AST::GlobalType &Glob, const bool IsImport) {
   /// Type in global is comfirmed in loading phase.
-  Globals.emplace_back(ASTToVType(Glob.getValueType()),
-                       Glob.getValueMutation());
+  auto &Ctx = getMutableContext();
+  Ctx.Globals.emplace_back(ASTToVType(Glob.getValueType()),
+                           Glob.getValueMutation());
   if (IsImport) {
-    NumImportGlobals++;
+    Ctx.NumImportGlobals++;
   }
 }
 
+void FormChecker::addElem(const AST::ElementSegment &Elem) {
+  getMutableContext().Elems.emplace_back(Elem.getRefType());
+}
+
+void FormChecker::setDataCount(const uint32_t Count) {
+  getMutableContext().NumDatas = Count;
+}
+
+void FormChecker::addRef(const uint32_t FuncIdx) {
+  getMutableContext().Refs.insert(FuncIdx);
+}
+
 void FormChecker::addLocal(const ValType &V) {
   Locals.emplace_back(ASTToVType(V));
 }
 
 void FormChecker::addLocal(const VType &V) { Locals.emplace_back(V); }
 
+FormContext &FormChecker::getMutableContext() {
+  /// Copy on write after the contexts are frozen.
+  if (!Owned) {
+    Owned = std::make_shared<FormContext>(*Context);
+    Context = Owned;
+  }
+  return *Owned;
+}
+
 VType FormChecker::ASTToVType(const ValType &V) {
   switch (V) {
   case ValType::I32:
@@ -89,11 +108,34 @@ VType FormChecker::ASTToVType(const ValType &V) {
     return VType::F32;
   case ValType::F64:
     return VType::F64;
+  case ValType::V128:
+    return VType::V128;
+  case ValType::FuncRef:
+    return VType::FuncRef;
+  case ValType::ExternRef:
+    return VType::ExternRef;
   default:
     return VType::Unknown;
   }
 }
 
+Expect<std::pair<std::vector<VType>, std::vector<VType>>>
+FormChecker::resolveBlockType(const BlockType &Type) {
+  using ReturnType = std::pair<std::vector<VType>, std::vector<VType>>;
+  if (const auto *Idx = std::get_if<uint32_t>(&Type)) {
+    /// Function type index as block type.
+    if (*Idx >= Context->Types.size()) {
+      return Unexpect(ErrCode::ValidationFailed);
+    }
+    return Context->Types[*Idx];
+  }
+  const ValType Result = std::get<ValType>(Type);
+  if (Result == ValType::None) {
+    return ReturnType{};
+  }
+  return ReturnType{{}, {ASTToVType(Result)}};
+}
+
 Expect<void> FormChecker::checkInstrs(const AST::InstrVec &Instrs) {
   for (auto &Instr : Instrs) {
     OpCode Code = Instr->getOpCode();
@@ -107,7 +149,7 @@ Expect<void> FormChecker::checkInstrs(const AST::InstrVec &Instrs) {
             /// Check the corresponding instruction.
             return checkInstr(
                 *static_cast<typename std::decay_t<decltype(Arg)>::type *>(
-                    Instr.get()));
+                    Instr));
           }
         });
     if (!Res) {
@@ -136,25 +178,31 @@ Expect<void> FormChecker::checkInstr(const AST::ControlInstruction &Instr) {
 
 Expect<void>
 FormChecker::checkInstr(const AST::BlockControlInstruction &Instr) {
-  /// Get blocktype [t*]
-  std::vector<VType> ResVec;
-  if (Instr.getResultType() != ValType::None) {
-    ResVec.emplace_back(ASTToVType(Instr.getResultType()));
+  /// Get blocktype [t1*] -> [t2*]
+  std::vector<VType> Params, Results;
+  if (auto Res = resolveBlockType(Instr.getBlockType())) {
+    std::tie(Params, Results) = std::move(*Res);
+  } else {
+    return Unexpect(Res);
+  }
+  if (auto Res = popTypes(Params); !Res) {
+    return Unexpect(Res);
   }
   switch (Instr.getOpCode()) {
   case OpCode::Block: {
-    /// Push ctrl frame ([t*], [t*])
-    pushCtrl(ResVec, ResVec);
+    /// Push ctrl frame ([t2*], [t2*])
+    pushCtrl(Results, Results);
     break;
   }
   case OpCode::Loop: {
-    /// Push ctrl frame ([], [t*])
-    pushCtrl({}, ResVec);
+    /// Push ctrl frame ([t1*], [t2*])
+    pushCtrl(Params, Results);
     break;
   }
   default:
     return Unexpect(ErrCode::ValidationFailed);
   }
+  pushTypes(Params);
   /// Check block body
   if (auto Res = checkInstrs(Instr.getBody()); !Res) {
     return Unexpect(Res);
@@ -171,28 +219,40 @@ Expect<void>
 FormChecker::checkInstr(const AST::IfElseControlInstruction &Instr) {
   switch (Instr.getOpCode()) {
   case OpCode::If: {
-    /// Get blocktype [t*]
-    std::vector<VType> ResVec;
-    if (Instr.getResultType() != ValType::None) {
-      ResVec.emplace_back(ASTToVType(Instr.getResultType()));
-    }
-    /// Pop I32
-    popType(VType::I32);
-    /// Push ctrl frame ([t*], [t*]) and check body
-    pushCtrl(ResVec, ResVec);
+    /// Get blocktype [t1*] -> [t2*]
+    std::vector<VType> Params, Results;
+    if (auto Res = resolveBlockType(Instr.getBlockType())) {
+      std::tie(Params, Results) = std::move(*Res);
+    } else {
+      return Unexpect(Res);
+    }
+    /// Pop I32 and [t1*]
+    if (auto Res = popType(VType::I32); !Res) {
+      return Unexpect(Res);
+    }
+    if (auto Res = popTypes(Params); !Res) {
+      return Unexpect(Res);
+    }
+    /// Push ctrl frame ([t2*], [t2*]) and check body
+    pushCtrl(Results, Results);
+    pushTypes(Params);
     if (auto Res = checkInstrs(Instr.getIfStatement()); !Res) {
       return Unexpect(Res);
     }
-    /// Else case, push ctrl frame (Results, Results) and check body
+    /// Else case, push ctrl frame (Results, Results) and check body. Without
+    /// else statement, the parameters are passed through as results.
     if (Instr.getElseStatement().size() > 0) {
       if (auto Results = popCtrl()) {
         pushCtrl(*Results, *Results);
+        pushTypes(Params);
         if (auto Res = checkInstrs(Instr.getElseStatement()); !Res) {
           return Unexpect(Res);
         }
       } else {
         return Unexpect(Results);
       }
+    } else if (Params != Results) {
+      return Unexpect(ErrCode::ValidationFailed);
     }
     if (auto Res = popCtrl()) {
       pushTypes(*Res);
@@ -272,6 +332,9 @@ FormChecker::checkInstr(const AST::BrTableControlInstruction &Instr) {
 }
 
 Expect<void> FormChecker::checkInstr(const AST::CallControlInstruction &Instr) {
+  const auto &Types = Context->Types;
+  const auto &Funcs = Context->Funcs;
+  const auto &Tables = Context->Tables;
   auto N = Instr.getFuncIndex();
   switch (Instr.getOpCode()) {
   case OpCode::Call: {
@@ -282,20 +345,55 @@ Expect<void> FormChecker::checkInstr(const AST::CallControlInstruction &Instr) {
     return StackTrans({Types[Funcs[N]].first}, {Types[Funcs[N]].second});
   }
   case OpCode::Call_indirect: {
-    if (Tables.size() == 0) {
+    /// Table must exist and be a function reference table.
+    if (Instr.getTableIndex() >= Tables.size() ||
+        Tables[Instr.getTableIndex()] != ElemType::FuncRef) {
+      return Unexpect(ErrCode::ValidationFailed);
+    }
+    if (Types.size() <= N) {
+      /// Function type index out of range
+      return Unexpect(ErrCode::ValidationFailed);
+    }
+    if (auto Res = popType(VType::I32); !Res) {
+      return Unexpect(Res);
+    }
+    return StackTrans({Types[N].first}, {Types[N].second});
+  }
+  case OpCode::Return_call: {
+    if (Funcs.size() <= N) {
+      /// Call function index out of range
+      return Unexpect(ErrCode::ValidationFailed);
+    }
+    /// The callee results must match the results of the current function.
+    if (Types[Funcs[N]].second != Returns) {
       return Unexpect(ErrCode::ValidationFailed);
     }
-    if (Tables[0] != ElemType::FuncRef) {
+    if (auto Res = popTypes(Types[Funcs[N]].first); !Res) {
+      return Unexpect(Res);
+    }
+    return unreachable();
+  }
+  case OpCode::Return_call_indirect: {
+    /// Table must exist and be a function reference table.
+    if (Instr.getTableIndex() >= Tables.size() ||
+        Tables[Instr.getTableIndex()] != ElemType::FuncRef) {
       return Unexpect(ErrCode::ValidationFailed);
     }
     if (Types.size() <= N) {
       /// Function type index out of range
       return Unexpect(ErrCode::ValidationFailed);
     }
+    /// The callee results must match the results of the current function.
+    if (Types[N].second != Returns) {
+      return Unexpect(ErrCode::ValidationFailed);
+    }
     if (auto Res = popType(VType::I32); !Res) {
       return Unexpect(Res);
     }
-    return StackTrans({Types[N].first}, {Types[N].second});
+    if (auto Res = popTypes(Types[N].first); !Res) {
+      return Unexpect(Res);
+    }
+    return unreachable();
   }
   default:
     break;
@@ -322,9 +420,17 @@ Expect<void> FormChecker::checkInstr(const AST::ParametricInstruction &Instr) {
     } else {
       return Unexpect(Res);
     }
+    /// Untyped select only accepts numeric and vector operands.
+    if (T2 == VType::FuncRef || T2 == VType::ExternRef) {
+      return Unexpect(ErrCode::ValidationFailed);
+    }
     pushType(T2);
     return {};
   }
+  case OpCode::Select_t: {
+    const VType T = ASTToVType(Instr.getValType());
+    return StackTrans({T, T, VType::I32}, {T});
+  }
   default:
     break;
   }
@@ -346,11 +452,11 @@ Expect<void> FormChecker::checkInstr(const AST::VariableInstruction &Instr) {
     break;
   case OpCode::Global__get:
   case OpCode::Global__set:
-    if (Instr.getVariableIndex() >= Globals.size()) {
+    if (Instr.getVariableIndex() >= Context->Globals.size()) {
       /// Global index out of range
       return Unexpect(ErrCode::ValidationFailed);
     }
-    TExpect = Globals[Instr.getVariableIndex()].first;
+    TExpect = Context->Globals[Instr.getVariableIndex()].first;
     break;
   default:
     return Unexpect(ErrCode::ValidationFailed);
@@ -360,7 +466,7 @@ Expect<void> FormChecker::checkInstr(const AST::VariableInstruction &Instr) {
   switch (Instr.getOpCode()) {
   case OpCode::Global__set:
     /// Global case, check mutation.
-    if (Globals[Instr.getVariableIndex()].second != ValMut::Var) {
+    if (Context->Globals[Instr.getVariableIndex()].second != ValMut::Var) {
       /// Global is immutable
       return Unexpect(ErrCode::ValidationFailed);
     }
@@ -388,8 +494,8 @@ Expect<void> FormChecker::checkInstr(const AST::VariableInstruction &Instr) {
 }
 
 Expect<void> FormChecker::checkInstr(const AST::MemoryInstruction &Instr) {
-  /// Memory[0] must exist
-  if (Mems.size() == 0) {
+  /// Memory[0] must exist except data.drop
+  if (Context->Mems.size() == 0 && Instr.getOpCode() != OpCode::Data__drop) {
     return Unexpect(ErrCode::ValidationFailed);
   }
 
@@ -439,6 +545,15 @@ Expect<void> FormChecker::checkInstr(const AST::MemoryInstruction &Instr) {
     break;
   case OpCode::Memory__size:
   case OpCode::Memory__grow:
+  case OpCode::Memory__copy:
+  case OpCode::Memory__fill:
+    break;
+  case OpCode::Memory__init:
+  case OpCode::Data__drop:
+    /// Data segment must be declared in data count section.
+    if (Instr.getDataIndex() >= Context->NumDatas) {
+      return Unexpect(ErrCode::ValidationFailed);
+    }
     break;
   default:
     return Unexpect(ErrCode::ValidationFailed);
@@ -481,6 +596,94 @@ Expect<void> FormChecker::checkInstr(const AST::MemoryInstruction &Instr) {
     return StackTrans({}, {VType::I32});
   case OpCode::Memory__grow:
     return StackTrans({VType::I32}, {VType::I32});
+  case OpCode::Memory__init:
+  case OpCode::Memory__copy:
+  case OpCode::Memory__fill:
+    return StackTrans({VType::I32, VType::I32, VType::I32}, {});
+  case OpCode::Data__drop:
+    return StackTrans({}, {});
+  default:
+    break;
+  }
+  return Unexpect(ErrCode::ValidationFailed);
+}
+
+Expect<void> FormChecker::checkInstr(const AST::TableInstruction &Instr) {
+  const auto &Tables = Context->Tables;
+  const auto &Elems = Context->Elems;
+  switch (Instr.getOpCode()) {
+  case OpCode::Table__init:
+    /// Table and element segment must exist, and their types must match.
+    if (Instr.getTargetIndex() >= Tables.size() ||
+        Instr.getElemIndex() >= Elems.size() ||
+        Tables[Instr.getTargetIndex()] != Elems[Instr.getElemIndex()]) {
+      return Unexpect(ErrCode::ValidationFailed);
+    }
+    return StackTrans({VType::I32, VType::I32, VType::I32}, {});
+  case OpCode::Elem__drop:
+    /// Element segment must exist.
+    if (Instr.getElemIndex() >= Elems.size()) {
+      return Unexpect(ErrCode::ValidationFailed);
+    }
+    return StackTrans({}, {});
+  case OpCode::Table__copy:
+    /// Tables must exist and their types must match.
+    if (Instr.getTargetIndex() >= Tables.size() ||
+        Instr.getSourceIndex() >= Tables.size() ||
+        Tables[Instr.getTargetIndex()] != Tables[Instr.getSourceIndex()]) {
+      return Unexpect(ErrCode::ValidationFailed);
+    }
+    return StackTrans({VType::I32, VType::I32, VType::I32}, {});
+  default:
+    break;
+  }
+
+  /// Table must exist in the other cases.
+  if (Instr.getTargetIndex() >= Tables.size()) {
+    return Unexpect(ErrCode::ValidationFailed);
+  }
+  const VType T =
+      ASTToVType(static_cast<ValType>(Tables[Instr.getTargetIndex()]));
+  switch (Instr.getOpCode()) {
+  case OpCode::Table__get:
+    return StackTrans({VType::I32}, {T});
+  case OpCode::Table__set:
+    return StackTrans({VType::I32, T}, {});
+  case OpCode::Table__grow:
+    return StackTrans({T, VType::I32}, {VType::I32});
+  case OpCode::Table__size:
+    return StackTrans({}, {VType::I32});
+  case OpCode::Table__fill:
+    return StackTrans({VType::I32, T, VType::I32}, {});
+  default:
+    break;
+  }
+  return Unexpect(ErrCode::ValidationFailed);
+}
+
+Expect<void> FormChecker::checkInstr(const AST::ReferenceInstruction &Instr) {
+  switch (Instr.getOpCode()) {
+  case OpCode::Ref__null:
+    return StackTrans({}, {ASTToVType(Instr.getReferenceType())});
+  case OpCode::Ref__is_null:
+    /// Operand must be a reference.
+    if (auto Res = popType()) {
+      if (*Res != VType::Unknown && *Res != VType::FuncRef &&
+          *Res != VType::ExternRef) {
+        return Unexpect(ErrCode::ValidationFailed);
+      }
+    } else {
+      return Unexpect(Res);
+    }
+    pushType(VType::I32);
+    return {};
+  case OpCode::Ref__func:
+    /// Function must exist and be declared outside of function bodies.
+    if (Instr.getFuncIndex() >= Context->Funcs.size() ||
+        Context->Refs.count(Instr.getFuncIndex()) == 0) {
+      return Unexpect(ErrCode::ValidationFailed);
+    }
+    return StackTrans({}, {VType::FuncRef});
   default:
     break;
   }
@@ -497,6 +700,8 @@ Expect<void> FormChecker::checkInstr(const AST::ConstInstruction &Instr) {
     return StackTrans({}, {VType::F32});
   case OpCode::F64__const:
     return StackTrans({}, {VType::F64});
+  case OpCode::V128__const:
+    return StackTrans({}, {VType::V128});
   default:
     break;
   }
@@ -675,6 +880,557 @@ FormChecker::checkInstr(const AST::BinaryNumericInstruction &Instr) {
   return Unexpect(ErrCode::ValidationFailed);
 }
 
+Expect<void> FormChecker::checkInstr(const AST::SIMDMemoryInstruction &Instr) {
+  /// Memory[0] must exist
+  if (Context->Mems.size() == 0) {
+    return Unexpect(ErrCode::ValidationFailed);
+  }
+
+  /// Get accessed bytes, and lane count in lane cases.
+  uint32_t N = 0, Lanes = 0;
+  switch (Instr.getOpCode()) {
+  case OpCode::V128__load:
+  case OpCode::V128__store:
+    N = 16;
+    break;
+  case OpCode::V128__load8x8_s:
+  case OpCode::V128__load8x8_u:
+  case OpCode::V128__load16x4_s:
+  case OpCode::V128__load16x4_u:
+  case OpCode::V128__load32x2_s:
+  case OpCode::V128__load32x2_u:
+  case OpCode::V128__load64_splat:
+  case OpCode::V128__load64_zero:
+    N = 8;
+    break;
+  case OpCode::V128__load32_splat:
+  case OpCode::V128__load32_zero:
+    N = 4;
+    break;
+  case OpCode::V128__load16_splat:
+    N = 2;
+    break;
+  case OpCode::V128__load8_splat:
+    N = 1;
+    break;
+  case OpCode::V128__load8_lane:
+  case OpCode::V128__store8_lane:
+    N = 1;
+    Lanes = 16;
+    break;
+  case OpCode::V128__load16_lane:
+  case OpCode::V128__store16_lane:
+    N = 2;
+    Lanes = 8;
+    break;
+  case OpCode::V128__load32_lane:
+  case OpCode::V128__store32_lane:
+    N = 4;
+    Lanes = 4;
+    break;
+  case OpCode::V128__load64_lane:
+  case OpCode::V128__store64_lane:
+    N = 8;
+    Lanes = 2;
+    break;
+  default:
+    return Unexpect(ErrCode::ValidationFailed);
+  }
+  if (Instr.getMemoryAlign() > 31 || (1UL << Instr.getMemoryAlign()) > N) {
+    /// 2 ^ align needs to <= N
+    return Unexpect(ErrCode::ValidationFailed);
+  }
+  if (Lanes > 0 && Instr.getLaneIndex() >= Lanes) {
+    /// Lane index out of range
+    return Unexpect(ErrCode::ValidationFailed);
+  }
+
+  switch (Instr.getOpCode()) {
+  case OpCode::V128__store:
+    return StackTrans({VType::I32, VType::V128}, {});
+  case OpCode::V128__load8_lane:
+  case OpCode::V128__load16_lane:
+  case OpCode::V128__load32_lane:
+  case OpCode::V128__load64_lane:
+    return StackTrans({VType::I32, VType::V128}, {VType::V128});
+  case OpCode::V128__store8_lane:
+  case OpCode::V128__store16_lane:
+  case OpCode::V128__store32_lane:
+  case OpCode::V128__store64_lane:
+    return StackTrans({VType::I32, VType::V128}, {});
+  default:
+    return StackTrans({VType::I32}, {VType::V128});
+  }
+}
+
+Expect<void> FormChecker::checkInstr(const AST::SIMDLaneInstruction &Instr) {
+  /// Get lane count and the scalar type.
+  uint32_t Lanes = 0;
+  VType T = VType::I32;
+  switch (Instr.getOpCode()) {
+  case OpCode::I8x16__extract_lane_s:
+  case OpCode::I8x16__extract_lane_u:
+  case OpCode::I8x16__replace_lane:
+    Lanes = 16;
+    break;
+  case OpCode::I16x8__extract_lane_s:
+  case OpCode::I16x8__extract_lane_u:
+  case OpCode::I16x8__replace_lane:
+    Lanes = 8;
+    break;
+  case OpCode::I32x4__extract_lane:
+  case OpCode::I32x4__replace_lane:
+    Lanes = 4;
+    break;
+  case OpCode::I64x2__extract_lane:
+  case OpCode::I64x2__replace_lane:
+    Lanes = 2;
+    T = VType::I64;
+    break;
+  case OpCode::F32x4__extract_lane:
+  case OpCode::F32x4__replace_lane:
+    Lanes = 4;
+    T = VType::F32;
+    break;
+  case OpCode::F64x2__extract_lane:
+  case OpCode::F64x2__replace_lane:
+    Lanes = 2;
+    T = VType::F64;
+    break;
+  default:
+    return Unexpect(ErrCode::ValidationFailed);
+  }
+  if (Instr.getLaneIndex() >= Lanes) {
+    /// Lane index out of range
+    return Unexpect(ErrCode::ValidationFailed);
+  }
+
+  switch (Instr.getOpCode()) {
+  case OpCode::I8x16__replace_lane:
+  case OpCode::I16x8__replace_lane:
+  case OpCode::I32x4__replace_lane:
+  case OpCode::I64x2__replace_lane:
+  case OpCode::F32x4__replace_lane:
+  case OpCode::F64x2__replace_lane:
+    return StackTrans({VType::V128, T}, {VType::V128});
+  default:
+    return StackTrans({VType::V128}, {T});
+  }
+}
+
+Expect<void>
+FormChecker::checkInstr(const AST::SIMDShuffleInstruction &Instr) {
+  switch (Instr.getOpCode()) {
+  case OpCode::I8x16__shuffle:
+    for (const auto Lane : Instr.getShuffleLanes()) {
+      if (Lane >= 32) {
+        /// Lane index out of range
+        return Unexpect(ErrCode::ValidationFailed);
+      }
+    }
+    return StackTrans({VType::V128, VType::V128}, {VType::V128});
+  default:
+    break;
+  }
+  return Unexpect(ErrCode::ValidationFailed);
+}
+
+Expect<void>
+FormChecker::checkInstr(const AST::SIMDNumericInstruction &Instr) {
+  switch (Instr.getOpCode()) {
+  case OpCode::I8x16__swizzle:
+  case OpCode::I8x16__eq:
+  case OpCode::I8x16__ne:
+  case OpCode::I8x16__lt_s:
+  case OpCode::I8x16__lt_u:
+  case OpCode::I8x16__gt_s:
+  case OpCode::I8x16__gt_u:
+  case OpCode::I8x16__le_s:
+  case OpCode::I8x16__le_u:
+  case OpCode::I8x16__ge_s:
+  case OpCode::I8x16__ge_u:
+  case OpCode::I16x8__eq:
+  case OpCode::I16x8__ne:
+  case OpCode::I16x8__lt_s:
+  case OpCode::I16x8__lt_u:
+  case OpCode::I16x8__gt_s:
+  case OpCode::I16x8__gt_u:
+  case OpCode::I16x8__le_s:
+  case OpCode::I16x8__le_u:
+  case OpCode::I16x8__ge_s:
+  case OpCode::I16x8__ge_u:
+  case OpCode::I32x4__eq:
+  case OpCode::I32x4__ne:
+  case OpCode::I32x4__lt_s:
+  case OpCode::I32x4__lt_u:
+  case OpCode::I32x4__gt_s:
+  case OpCode::I32x4__gt_u:
+  case OpCode::I32x4__le_s:
+  case OpCode::I32x4__le_u:
+  case OpCode::I32x4__ge_s:
+  case OpCode::I32x4__ge_u:
+  case OpCode::F32x4__eq:
+  case OpCode::F32x4__ne:
+  case OpCode::F32x4__lt:
+  case OpCode::F32x4__gt:
+  case OpCode::F32x4__le:
+  case OpCode::F32x4__ge:
+  case OpCode::F64x2__eq:
+  case OpCode::F64x2__ne:
+  case OpCode::F64x2__lt:
+  case OpCode::F64x2__gt:
+  case OpCode::F64x2__le:
+  case OpCode::F64x2__ge:
+  case OpCode::V128__and:
+  case OpCode::V128__andnot:
+  case OpCode::V128__or:
+  case OpCode::V128__xor:
+  case OpCode::I8x16__narrow_i16x8_s:
+  case OpCode::I8x16__narrow_i16x8_u:
+  case OpCode::I8x16__add:
+  case OpCode::I8x16__add_sat_s:
+  case OpCode::I8x16__add_sat_u:
+  case OpCode::I8x16__sub:
+  case OpCode::I8x16__sub_sat_s:
+  case OpCode::I8x16__sub_sat_u:
+  case OpCode::I8x16__min_s:
+  case OpCode::I8x16__min_u:
+  case OpCode::I8x16__max_s:
+  case OpCode::I8x16__max_u:
+  case OpCode::I8x16__avgr_u:
+  case OpCode::I16x8__q15mulr_sat_s:
+  case OpCode::I16x8__narrow_i32x4_s:
+  case OpCode::I16x8__narrow_i32x4_u:
+  case OpCode::I16x8__add:
+  case OpCode::I16x8__add_sat_s:
+  case OpCode::I16x8__add_sat_u:
+  case OpCode::I16x8__sub:
+  case OpCode::I16x8__sub_sat_s:
+  case OpCode::I16x8__sub_sat_u:
+  case OpCode::I16x8__mul:
+  case OpCode::I16x8__min_s:
+  case OpCode::I16x8__min_u:
+  case OpCode::I16x8__max_s:
+  case OpCode::I16x8__max_u:
+  case OpCode::I16x8__avgr_u:
+  case OpCode::I16x8__extmul_low_i8x16_s:
+  case OpCode::I16x8__extmul_high_i8x16_s:
+  case OpCode::I16x8__extmul_low_i8x16_u:
+  case OpCode::I16x8__extmul_high_i8x16_u:
+  case OpCode::I32x4__add:
+  case OpCode::I32x4__sub:
+  case OpCode::I32x4__mul:
+  case OpCode::I32x4__min_s:
+  case OpCode::I32x4__min_u:
+  case OpCode::I32x4__max_s:
+  case OpCode::I32x4__max_u:
+  case OpCode::I32x4__dot_i16x8_s:
+  case OpCode::I32x4__extmul_low_i16x8_s:
+  case OpCode::I32x4__extmul_high_i16x8_s:
+  case OpCode::I32x4__extmul_low_i16x8_u:
+  case OpCode::I32x4__extmul_high_i16x8_u:
+  case OpCode::I64x2__add:
+  case OpCode::I64x2__sub:
+  case OpCode::I64x2__mul:
+  case OpCode::I64x2__eq:
+  case OpCode::I64x2__ne:
+  case OpCode::I64x2__lt_s:
+  case OpCode::I64x2__gt_s:
+  case OpCode::I64x2__le_s:
+  case OpCode::I64x2__ge_s:
+  case OpCode::I64x2__extmul_low_i32x4_s:
+  case OpCode::I64x2__extmul_high_i32x4_s:
+  case OpCode::I64x2__extmul_low_i32x4_u:
+  case OpCode::I64x2__extmul_high_i32x4_u:
+  case OpCode::F32x4__add:
+  case OpCode::F32x4__sub:
+  case OpCode::F32x4__mul:
+  case OpCode::F32x4__div:
+  case OpCode::F32x4__min:
+  case OpCode::F32x4__max:
+  case OpCode::F32x4__pmin:
+  case OpCode::F32x4__pmax:
+  case OpCode::F64x2__add:
+  case OpCode::F64x2__sub:
+  case OpCode::F64x2__mul:
+  case OpCode::F64x2__div:
+  case OpCode::F64x2__min:
+  case OpCode::F64x2__max:
+  case OpCode::F64x2__pmin:
+  case OpCode::F64x2__pmax:
+    return StackTrans({VType::V128, VType::V128}, {VType::V128});
+  case OpCode::I8x16__splat:
+  case OpCode::I16x8__splat:
+  case OpCode::I32x4__splat:
+    return StackTrans({VType::I32}, {VType::V128});
+  case OpCode::I64x2__splat:
+    return StackTrans({VType::I64}, {VType::V128});
+  case OpCode::F32x4__splat:
+    return StackTrans({VType::F32}, {VType::V128});
+  case OpCode::F64x2__splat:
+    return StackTrans({VType::F64}, {VType::V128});
+  case OpCode::V128__not:
+  case OpCode::F32x4__demote_f64x2_zero:
+  case OpCode::F64x2__promote_low_f32x4:
+  case OpCode::I8x16__abs:
+  case OpCode::I8x16__neg:
+  case OpCode::I8x16__popcnt:
+  case OpCode::F32x4__ceil:
+  case OpCode::F32x4__floor:
+  case OpCode::F32x4__trunc:
+  case OpCode::F32x4__nearest:
+  case OpCode::F64x2__ceil:
+  case OpCode::F64x2__floor:
+  case OpCode::F64x2__trunc:
+  case OpCode::I16x8__extadd_pairwise_i8x16_s:
+  case OpCode::I16x8__extadd_pairwise_i8x16_u:
+  case OpCode::I32x4__extadd_pairwise_i16x8_s:
+  case OpCode::I32x4__extadd_pairwise_i16x8_u:
+  case OpCode::I16x8__abs:
+  case OpCode::I16x8__neg:
+  case OpCode::I16x8__extend_low_i8x16_s:
+  case OpCode::I16x8__extend_high_i8x16_s:
+  case OpCode::I16x8__extend_low_i8x16_u:
+  case OpCode::I16x8__extend_high_i8x16_u:
+  case OpCode::F64x2__nearest:
+  case OpCode::I32x4__abs:
+  case OpCode::I32x4__neg:
+  case OpCode::I32x4__extend_low_i16x8_s:
+  case OpCode::I32x4__extend_high_i16x8_s:
+  case OpCode::I32x4__extend_low_i16x8_u:
+  case OpCode::I32x4__extend_high_i16x8_u:
+  case OpCode::I64x2__abs:
+  case OpCode::I64x2__neg:
+  case OpCode::I64x2__extend_low_i32x4_s:
+  case OpCode::I64x2__extend_high_i32x4_s:
+  case OpCode::I64x2__extend_low_i32x4_u:
+  case OpCode::I64x2__extend_high_i32x4_u:
+  case OpCode::F32x4__abs:
+  case OpCode::F32x4__neg:
+  case OpCode::F32x4__sqrt:
+  case OpCode::F64x2__abs:
+  case OpCode::F64x2__neg:
+  case OpCode::F64x2__sqrt:
+  case OpCode::I32x4__trunc_sat_f32x4_s:
+  case OpCode::I32x4__trunc_sat_f32x4_u:
+  case OpCode::F32x4__convert_i32x4_s:
+  case OpCode::F32x4__convert_i32x4_u:
+  case OpCode::I32x4__trunc_sat_f64x2_s_zero:
+  case OpCode::I32x4__trunc_sat_f64x2_u_zero:
+  case OpCode::F64x2__convert_low_i32x4_s:
+  case OpCode::F64x2__convert_low_i32x4_u:
+    return StackTrans({VType::V128}, {VType::V128});
+  case OpCode::V128__bitselect:
+    return StackTrans({VType::V128, VType::V128, VType::V128}, {VType::V128});
+  case OpCode::V128__any_true:
+  case OpCode::I8x16__all_true:
+  case OpCode::I8x16__bitmask:
+  case OpCode::I16x8__all_true:
+  case OpCode::I16x8__bitmask:
+  case OpCode::I32x4__all_true:
+  case OpCode::I32x4__bitmask:
+  case OpCode::I64x2__all_true:
+  case OpCode::I64x2__bitmask:
+    return StackTrans({VType::V128}, {VType::I32});
+  case OpCode::I8x16__shl:
+  case OpCode::I8x16__shr_s:
+  case OpCode::I8x16__shr_u:
+  case OpCode::I16x8__shl:
+  case OpCode::I16x8__shr_s:
+  case OpCode::I16x8__shr_u:
+  case OpCode::I32x4__shl:
+  case OpCode::I32x4__shr_s:
+  case OpCode::I32x4__shr_u:
+  case OpCode::I64x2__shl:
+  case OpCode::I64x2__shr_s:
+  case OpCode::I64x2__shr_u:
+    return StackTrans({VType::V128, VType::I32}, {VType::V128});
+  default:
+    break;
+  }
+  return Unexpect(ErrCode::ValidationFailed);
+}
+
+Expect<void>
+FormChecker::checkInstr(const AST::AtomicMemoryInstruction &Instr) {
+  /// Fence needs no memory.
+  if (Instr.getOpCode() == OpCode::Atomic__fence) {
+    return {};
+  }
+
+  /// Memory[0] must exist
+  if (Context->Mems.size() == 0) {
+    return Unexpect(ErrCode::ValidationFailed);
+  }
+
+  /// Get accessed bytes.
+  uint32_t N = 0;
+  switch (Instr.getOpCode()) {
+  case OpCode::Memory__atomic__wait64:
+  case OpCode::I64__atomic__load:
+  case OpCode::I64__atomic__store:
+  case OpCode::I64__atomic__rmw__add:
+  case OpCode::I64__atomic__rmw__sub:
+  case OpCode::I64__atomic__rmw__and:
+  case OpCode::I64__atomic__rmw__or:
+  case OpCode::I64__atomic__rmw__xor:
+  case OpCode::I64__atomic__rmw__xchg:
+  case OpCode::I64__atomic__rmw__cmpxchg:
+    N = 8;
+    break;
+  case OpCode::Memory__atomic__notify:
+  case OpCode::Memory__atomic__wait32:
+  case OpCode::I32__atomic__load:
+  case OpCode::I64__atomic__load32_u:
+  case OpCode::I32__atomic__store:
+  case OpCode::I64__atomic__store32:
+  case OpCode::I32__atomic__rmw__add:
+  case OpCode::I64__atomic__rmw32__add_u:
+  case OpCode::I32__atomic__rmw__sub:
+  case OpCode::I64__atomic__rmw32__sub_u:
+  case OpCode::I32__atomic__rmw__and:
+  case OpCode::I64__atomic__rmw32__and_u:
+  case OpCode::I32__atomic__rmw__or:
+  case OpCode::I64__atomic__rmw32__or_u:
+  case OpCode::I32__atomic__rmw__xor:
+  case OpCode::I64__atomic__rmw32__xor_u:
+  case OpCode::I32__atomic__rmw__xchg:
+  case OpCode::I64__atomic__rmw32__xchg_u:
+  case OpCode::I32__atomic__rmw__cmpxchg:
+  case OpCode::I64__atomic__rmw32__cmpxchg_u:
+    N = 4;
+    break;
+  case OpCode::I32__atomic__load16_u:
+  case OpCode::I64__atomic__load16_u:
+  case OpCode::I32__atomic__store16:
+  case OpCode::I64__atomic__store16:
+  case OpCode::I32__atomic__rmw16__add_u:
+  case OpCode::I64__atomic__rmw16__add_u:
+  case OpCode::I32__atomic__rmw16__sub_u:
+  case OpCode::I64__atomic__rmw16__sub_u:
+  case OpCode::I32__atomic__rmw16__and_u:
+  case OpCode::I64__atomic__rmw16__and_u:
+  case OpCode::I32__atomic__rmw16__or_u:
+  case OpCode::I64__atomic__rmw16__or_u:
+  case OpCode::I32__atomic__rmw16__xor_u:
+  case OpCode::I64__atomic__rmw16__xor_u:
+  case OpCode::I32__atomic__rmw16__xchg_u:
+  case OpCode::I64__atomic__rmw16__xchg_u:
+  case OpCode::I32__atomic__rmw16__cmpxchg_u:
+  case OpCode::I64__atomic__rmw16__cmpxchg_u:
+    N = 2;
+    break;
+  case OpCode::I32__atomic__load8_u:
+  case OpCode::I64__atomic__load8_u:
+  case OpCode::I32__atomic__store8:
+  case OpCode::I64__atomic__store8:
+  case OpCode::I32__atomic__rmw8__add_u:
+  case OpCode::I64__atomic__rmw8__add_u:
+  case OpCode::I32__atomic__rmw8__sub_u:
+  case OpCode::I64__atomic__rmw8__sub_u:
+  case OpCode::I32__atomic__rmw8__and_u:
+  case OpCode::I64__atomic__rmw8__and_u:
+  case OpCode::I32__atomic__rmw8__or_u:
+  case OpCode::I64__atomic__rmw8__or_u:
+  case OpCode::I32__atomic__rmw8__xor_u:
+  case OpCode::I64__atomic__rmw8__xor_u:
+  case OpCode::I32__atomic__rmw8__xchg_u:
+  case OpCode::I64__atomic__rmw8__xchg_u:
+  case OpCode::I32__atomic__rmw8__cmpxchg_u:
+  case OpCode::I64__atomic__rmw8__cmpxchg_u:
+    N = 1;
+    break;
+  default:
+    return Unexpect(ErrCode::ValidationFailed);
+  }
+  if (Instr.getMemoryAlign() > 31 || (1UL << Instr.getMemoryAlign()) != N) {
+    /// 2 ^ align needs to be N
+    return Unexpect(ErrCode::ValidationFailed);
+  }
+
+  switch (Instr.getOpCode()) {
+  case OpCode::Memory__atomic__notify:
+    return StackTrans({VType::I32, VType::I32}, {VType::I32});
+  case OpCode::Memory__atomic__wait32:
+    return StackTrans({VType::I32, VType::I32, VType::I64}, {VType::I32});
+  case OpCode::Memory__atomic__wait64:
+    return StackTrans({VType::I32, VType::I64, VType::I64}, {VType::I32});
+  case OpCode::I32__atomic__load:
+  case OpCode::I32__atomic__load8_u:
+  case OpCode::I32__atomic__load16_u:
+    return StackTrans({VType::I32}, {VType::I32});
+  case OpCode::I64__atomic__load:
+  case OpCode::I64__atomic__load8_u:
+  case OpCode::I64__atomic__load16_u:
+  case OpCode::I64__atomic__load32_u:
+    return StackTrans({VType::I32}, {VType::I64});
+  case OpCode::I32__atomic__store:
+  case OpCode::I32__atomic__store8:
+  case OpCode::I32__atomic__store16:
+    return StackTrans({VType::I32, VType::I32}, {});
+  case OpCode::I64__atomic__store:
+  case OpCode::I64__atomic__store8:
+  case OpCode::I64__atomic__store16:
+  case OpCode::I64__atomic__store32:
+    return StackTrans({VType::I32, VType::I64}, {});
+  case OpCode::I32__atomic__rmw__add:
+  case OpCode::I32__atomic__rmw8__add_u:
+  case OpCode::I32__atomic__rmw16__add_u:
+  case OpCode::I32__atomic__rmw__sub:
+  case OpCode::I32__atomic__rmw8__sub_u:
+  case OpCode::I32__atomic__rmw16__sub_u:
+  case OpCode::I32__atomic__rmw__and:
+  case OpCode::I32__atomic__rmw8__and_u:
+  case OpCode::I32__atomic__rmw16__and_u:
+  case OpCode::I32__atomic__rmw__or:
+  case OpCode::I32__atomic__rmw8__or_u:
+  case OpCode::I32__atomic__rmw16__or_u:
+  case OpCode::I32__atomic__rmw__xor:
+  case OpCode::I32__atomic__rmw8__xor_u:
+  case OpCode::I32__atomic__rmw16__xor_u:
+  case OpCode::I32__atomic__rmw__xchg:
+  case OpCode::I32__atomic__rmw8__xchg_u:
+  case OpCode::I32__atomic__rmw16__xchg_u:
+    return StackTrans({VType::I32, VType::I32}, {VType::I32});
+  case OpCode::I64__atomic__rmw__add:
+  case OpCode::I64__atomic__rmw8__add_u:
+  case OpCode::I64__atomic__rmw16__add_u:
+  case OpCode::I64__atomic__rmw32__add_u:
+  case OpCode::I64__atomic__rmw__sub:
+  case OpCode::I64__atomic__rmw8__sub_u:
+  case OpCode::I64__atomic__rmw16__sub_u:
+  case OpCode::I64__atomic__rmw32__sub_u:
+  case OpCode::I64__atomic__rmw__and:
+  case OpCode::I64__atomic__rmw8__and_u:
+  case OpCode::I64__atomic__rmw16__and_u:
+  case OpCode::I64__atomic__rmw32__and_u:
+  case OpCode::I64__atomic__rmw__or:
+  case OpCode::I64__atomic__rmw8__or_u:
+  case OpCode::I64__atomic__rmw16__or_u:
+  case OpCode::I64__atomic__rmw32__or_u:
+  case OpCode::I64__atomic__rmw__xor:
+  case OpCode::I64__atomic__rmw8__xor_u:
+  case OpCode::I64__atomic__rmw16__xor_u:
+  case OpCode::I64__atomic__rmw32__xor_u:
+  case OpCode::I64__atomic__rmw__xchg:
+  case OpCode::I64__atomic__rmw8__xchg_u:
+  case OpCode::I64__atomic__rmw16__xchg_u:
+  case OpCode::I64__atomic__rmw32__xchg_u:
+    return StackTrans({VType::I32, VType::I64}, {VType::I64});
+  case OpCode::I32__atomic__rmw__cmpxchg:
+  case OpCode::I32__atomic__rmw8__cmpxchg_u:
+  case OpCode::I32__atomic__rmw16__cmpxchg_u:
+    return StackTrans({VType::I32, VType::I32, VType::I32}, {VType::I32});
+  case OpCode::I64__atomic__rmw__cmpxchg:
+  case OpCode::I64__atomic__rmw8__cmpxchg_u:
+  case OpCode::I64__atomic__rmw16__cmpxchg_u:
+  case OpCode::I64__atomic__rmw32__cmpxchg_u:
+    return StackTrans({VType::I32, VType::I64, VType::I64}, {VType::I64});
+  default:
+    return Unexpect(ErrCode::ValidationFailed);
+  }
+}
+
 void FormChecker::pushType(VType V) { ValStack.emplace_front(V); }
 
 void FormChecker::pushTypes(const std::vector<VType> &Input) {
@@ -2,17 +2,55 @@
 #include "validator/validator.h"
 #include "common/ast/module.h"
 #include "support/log.h"
+#include "support/threadpool.h"
 
+#include <atomic>
 #include <string>
 #include <unordered_set>
 
 namespace SSVM {
 namespace Validator {
 
+namespace {
+
+/// Validate function body in the context of checker.
+Expect<void> validateCode(FormChecker &Checker, const AST::CodeSegment &CodeSeg,
+                          const uint32_t TypeIdx) {
+  /// Reset stack in FormChecker.
+  Checker.reset();
+  /// Add parameters into this frame.
+  for (auto Val : Checker.getTypes()[TypeIdx].first) {
+    Checker.addLocal(Val);
+  }
+  /// Add locals into this frame.
+  for (auto Val : CodeSeg.getLocals()) {
+    for (uint32_t Cnt = 0; Cnt < Val.first; ++Cnt) {
+      Checker.addLocal(Val.second);
+    }
+  }
+  /// Validate function body expression.
+  return Checker.validate(CodeSeg.getInstrs(),
+                          Checker.getTypes()[TypeIdx].second);
+}
+
+/// Declare the functions referred by ref.func in the expression.
+void addRefs(FormChecker &Checker, const AST::InstrVec &Instrs) {
+  for (auto &Instr : Instrs) {
+    if (Instr->getOpCode() == OpCode::Ref__func) {
+      auto RefInstr = static_cast<const AST::ReferenceInstruction *>(Instr);
+      Checker.addRef(RefInstr->getFuncIndex());
+    }
+  }
+}
+
+} // namespace
+
 /// Validate Module. See "include/validator/validator.h".
 Expect<void> Validator::validate(const AST::Module &Mod) {
   /// https://webassembly.github.io/spec/core/valid/modules.html
   Checker.reset(true);
+  DeferredContext.reset();
+  IsTrusted = Mod.isValidated();
 
   /// Register type definitions into FormChecker.
   if (Mod.getTypeSection()) {
@@ -29,6 +67,39 @@ Expect<void> Validator::validate(const AST::Module &Mod) {
     }
   }
 
+  /// Register functions into FormChecker, which can be referred by the
+  /// constant expressions. Their type indices are checked with the bodies.
+  if (Mod.getFunctionSection() != nullptr) {
+    for (auto TypeIdx : Mod.getFunctionSection()->getContent()) {
+      Checker.addFunc(TypeIdx);
+    }
+  }
+
+  /// Declare the functions referred outside of function bodies, which are
+  /// in element segments, exports, and global initializations.
+  if (Mod.getElementSection() != nullptr) {
+    for (auto &ElemSeg : Mod.getElementSection()->getContent()) {
+      for (auto FuncIdx : ElemSeg->getFuncIdxes()) {
+        Checker.addRef(FuncIdx);
+      }
+      for (auto &InitExpr : ElemSeg->getInitExprs()) {
+        addRefs(Checker, InitExpr->getInstrs());
+      }
+    }
+  }
+  if (Mod.getExportSection() != nullptr) {
+    for (auto &ExportDesc : Mod.getExportSection()->getContent()) {
+      if (ExportDesc->getExternalType() == ExternalType::Function) {
+        Checker.addRef(ExportDesc->getExternalIndex());
+      }
+    }
+  }
+  if (Mod.getGlobalSection() != nullptr) {
+    for (auto &GlobSeg : Mod.getGlobalSection()->getContent()) {
+      addRefs(Checker, GlobSeg->getInstrs());
+    }
+  }
+
   /// Validate table section and register tables into FormChecker.
   if (Mod.getTableSection() != nullptr) {
     if (auto Res = validate(*Mod.getTableSection()); !Res) {
@@ -53,6 +124,26 @@ Expect<void> Validator::validate(const AST::Module &Mod) {
     }
   }
 
+  /// Register element segments and data count into FormChecker, which are
+  /// used by the bulk memory instructions in function bodies.
+  if (Mod.getElementSection() != nullptr) {
+    for (auto &ElemSeg : Mod.getElementSection()->getContent()) {
+      Checker.addElem(*ElemSeg.get());
+    }
+  }
+  if (Mod.getDataCountSection() != nullptr) {
+    /// Data count must match the count of data segments.
+    const uint32_t DataCount = Mod.getDataCountSection()->getContent();
+    const size_t DataSize = Mod.getDataSection() != nullptr
+                                ? Mod.getDataSection()->getContent().size()
+                                : 0;
+    if (DataCount != DataSize) {
+      Log::loggingError(ErrCode::ValidationFailed);
+      return Unexpect(ErrCode::ValidationFailed);
+    }
+    Checker.setDataCount(DataCount);
+  }
+
   /// Validate function section and code section.
   if ((Mod.getFunctionSection() && !Mod.getCodeSection()) ||
       (!Mod.getFunctionSection() && Mod.getCodeSection())) {
@@ -99,14 +190,47 @@ Expect<void> Validator::validate(const AST::Module &Mod) {
     }
   }
 
-  /// In current version, memory and table must be <= 1.
-  if (Checker.getMemories().size() > 1 || Checker.getTables().size() > 1) {
+  /// In current version, memory must be <= 1.
+  if (Checker.getMemories().size() > 1) {
     Log::loggingError(ErrCode::ValidationFailed);
     return Unexpect(ErrCode::ValidationFailed);
   }
+
+  /// Keep the context for the function bodies skipped in lazy loading.
+  if (Mod.getCodeSection() != nullptr) {
+    for (auto &CodeSeg : Mod.getCodeSection()->getContent()) {
+      if (!CodeSeg->isLoaded()) {
+        DeferredContext = Checker.freeze();
+        break;
+      }
+    }
+  }
   return {};
 }
 
+/// Get validation of lazy loaded bodies. See "include/validator/validator.h".
+AST::CodeValidator Validator::getCodeValidator() const {
+  if (!DeferredContext) {
+    return {};
+  }
+  if (IsTrusted) {
+    /// Function bodies of a module loaded from cache were validated when the
+    /// cache was written.
+    return [](const AST::CodeSegment &, const uint32_t) -> Expect<void> {
+      return {};
+    };
+  }
+  return [Context = DeferredContext](const AST::CodeSegment &CodeSeg,
+                                     const uint32_t TypeIdx) -> Expect<void> {
+    FormChecker BodyChecker(Context);
+    if (auto Res = validateCode(BodyChecker, CodeSeg, TypeIdx); !Res) {
+      Log::loggingError(Res.error());
+      return Unexpect(Res);
+    }
+    return {};
+  };
+}
+
 /// Validate Limit type. See "include/validator/validator.h".
 Expect<void> Validator::validate(const AST::Limit &Lim, uint32_t K) {
   bool Cond1 = Lim.getMin() <= K;
@@ -118,18 +242,12 @@ Expect<void> Validator::validate(const AST::Limit &Lim, uint32_t K) {
   return {};
 }
 
-/// Validate Function type. See "include/validator/validator.h".
-Expect<void> Validator::validate(const AST::FunctionType &Func) {
-  /// The restriction to at most one result may be removed in future versions of
-  /// WebAssembly.
-  if (Func.getReturnTypes().size() > 1) {
-    return Unexpect(ErrCode::ValidationFailed);
-  }
-  return {};
-}
-
 /// Validate Table type. See "include/validator/validator.h".
 Expect<void> Validator::validate(const AST::TableType &Tab) {
+  /// Tables cannot be shared.
+  if (Tab.getLimit()->isShared()) {
+    return Unexpect(ErrCode::ValidationFailed);
+  }
   /// Validate table limits.
   return validate(*Tab.getLimit(), LIMIT_TABLETYPE);
 }
@@ -149,19 +267,30 @@ Expect<void> Validator::validate(const AST::GlobalSegment &GlobSeg) {
 
 /// Validate Element segment. See "include/validator/validator.h".
 Expect<void> Validator::validate(const AST::ElementSegment &ElemSeg) {
-  /// Check table index and element type in context.
-  const auto &TableVec = Checker.getTables();
-  const auto &FuncVec = Checker.getFunctions();
-  if (ElemSeg.getIdx() >= TableVec.size() ||
-      TableVec[ElemSeg.getIdx()] != ElemType::FuncRef) {
-    return Unexpect(ErrCode::ValidationFailed);
-  }
   /// Check function indices exist in context.
+  const auto &FuncVec = Checker.getFunctions();
   for (auto &Idx : ElemSeg.getFuncIdxes()) {
     if (Idx >= FuncVec.size()) {
       return Unexpect(ErrCode::ValidationFailed);
     }
   }
+  /// Check element expressions are const expressions of the reference type.
+  const ValType RefType = static_cast<ValType>(ElemSeg.getRefType());
+  for (auto &InitExpr : ElemSeg.getInitExprs()) {
+    if (auto Res = validateConstExpr(InitExpr->getInstrs(), {RefType}); !Res) {
+      return Unexpect(Res);
+    }
+  }
+  /// Passive and declarative segments have no table and offset.
+  if (ElemSeg.getMode() != AST::SegmentMode::Active) {
+    return {};
+  }
+  /// Check table index and element type in context.
+  const auto &TableVec = Checker.getTables();
+  if (ElemSeg.getIdx() >= TableVec.size() ||
+      TableVec[ElemSeg.getIdx()] != ElemSeg.getRefType()) {
+    return Unexpect(ErrCode::ValidationFailed);
+  }
   /// Check table initialization is const expression.
   return validateConstExpr(ElemSeg.getInstrs(), {ValType::I32});
 }
@@ -169,25 +298,19 @@ Expect<void> Validator::validate(const AST::ElementSegment &ElemSeg) {
 /// Validate Code segment. See "include/validator/validator.h".
 Expect<void> Validator::validate(const AST::CodeSegment &CodeSeg,
                                  const uint32_t TypeIdx) {
-  /// Reset stack in FormChecker.
-  Checker.reset();
-  /// Add parameters into this frame.
-  for (auto Val : Checker.getTypes()[TypeIdx].first) {
-    Checker.addLocal(Val);
+  /// Function bodies in lazy loading are validated on their first call.
+  if (!CodeSeg.isLoaded()) {
+    return {};
   }
-  /// Add locals into this frame.
-  for (auto Val : CodeSeg.getLocals()) {
-    for (uint32_t Cnt = 0; Cnt < Val.first; ++Cnt) {
-      Checker.addLocal(Val.second);
-    }
-  }
-  /// Validate function body expression.
-  return Checker.validate(CodeSeg.getInstrs(),
-                          Checker.getTypes()[TypeIdx].second);
+  return validateCode(Checker, CodeSeg, TypeIdx);
 }
 
 /// Validate Data segment. See "include/validator/validator.h".
 Expect<void> Validator::validate(const AST::DataSegment &DataSeg) {
+  /// Passive segments have no memory and offset.
+  if (DataSeg.getMode() != AST::SegmentMode::Active) {
+    return {};
+  }
   /// Check memory index in context.
   const auto &MemVec = Checker.getMemories();
   if (DataSeg.getIdx() >= MemVec.size()) {
@@ -301,21 +424,54 @@ Expect<void> Validator::validate(const AST::FunctionSection &FuncSec,
   const auto &CodeVec = CodeSec.getContent();
   const auto &TypeVec = Checker.getTypes();
 
-  /// Check if type id of function is valid in context.
+  /// Check if type id of function is valid in context. The functions are
+  /// registered before validating the other sections.
   for (size_t Id = 0; Id < FuncVec.size(); ++Id) {
     uint32_t TId = FuncVec[Id];
     if (TId >= TypeVec.size()) {
       return Unexpect(ErrCode::ValidationFailed);
     }
-    Checker.addFunc(TId);
   }
 
-  /// Validate function body.
-  for (size_t Id = 0; Id < FuncVec.size(); ++Id) {
-    uint32_t TId = FuncVec[Id];
-    if (auto Res = validate(*CodeVec[Id].get(), TId); !Res) {
-      return Unexpect(Res);
+  /// Validate function bodies, on the thread pool with a checker per body if
+  /// there are enough instructions to pay for it. Report the error of the
+  /// first failing body, and skip the bodies after a known failure.
+  size_t TotalSize = 0;
+  for (auto &CodeSeg : CodeVec) {
+    if (CodeSeg->isLoaded()) {
+      TotalSize += CodeSeg->getInstrs().size();
+    }
+  }
+  if (TotalSize < kParallelValidateSize) {
+    for (size_t Id = 0; Id < FuncVec.size(); ++Id) {
+      uint32_t TId = FuncVec[Id];
+      if (auto Res = validate(*CodeVec[Id].get(), TId); !Res) {
+        return Unexpect(Res);
+      }
+    }
+    return {};
+  }
+
+  const auto Context = Checker.freeze();
+  std::vector<ErrCode> Errors(FuncVec.size(), ErrCode::Success);
+  std::atomic<size_t> FirstFailure = FuncVec.size();
+  ThreadPool::getDefault().parallelFor(FuncVec.size(), [&](size_t Id) {
+    if (Id > FirstFailure.load(std::memory_order_relaxed) ||
+        !CodeVec[Id]->isLoaded()) {
+      return;
+    }
+    FormChecker BodyChecker(Context);
+    if (auto Res = validateCode(BodyChecker, *CodeVec[Id].get(), FuncVec[Id]);
+        !Res) {
+      Errors[Id] = Res.error();
+      size_t Expected = FirstFailure.load(std::memory_order_relaxed);
+      while (Id < Expected && !FirstFailure.compare_exchange_weak(
+                                  Expected, Id, std::memory_order_relaxed)) {
+      }
     }
+  });
+  if (FirstFailure < FuncVec.size()) {
+    return Unexpect(Errors[FirstFailure]);
   }
   return {};
 }
@@ -412,13 +568,13 @@ Expect<void> Validator::validateConstExpr(const AST::InstrVec &Instrs,
                                           const std::vector<ValType> &Returns,
                                           const bool RestrictGlobal) {
   for (auto &Instr : Instrs) {
-    /// Only these 5 instructions are constant.
+    /// Only these 8 instructions are constant.
     switch (Instr->getOpCode()) {
     case OpCode::Global__get:
       /// For global initialization case, global indices must be imported
       /// globals.
       if (RestrictGlobal) {
-        auto GlobInstr = static_cast<AST::VariableInstruction *>(Instr.get());
+        auto GlobInstr = static_cast<AST::VariableInstruction *>(Instr);
         if (GlobInstr->getVariableIndex() >= Checker.getNumImportGlobals()) {
           return Unexpect(ErrCode::ValidationFailed);
         }
@@ -427,6 +583,9 @@ Expect<void> Validator::validateConstExpr(const AST::InstrVec &Instrs,
     case OpCode::I64__const:
     case OpCode::F32__const:
     case OpCode::F64__const:
+    case OpCode::V128__const:
+    case OpCode::Ref__null:
+    case OpCode::Ref__func:
       break;
     default:
       return Unexpect(ErrCode::ValidationFailed);
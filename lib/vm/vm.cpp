@@ -1,8 +1,15 @@
 // SPDX-License-Identifier: Apache-2.0
 #include "vm/vm.h"
+#include "host/wasi/ssvmiomodule.h"
 #include "host/wasi/wasimodule.h"
+#include "host/wasi/wasithreadsmodule.h"
 #include "support/log.h"
 
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <ostream>
+
 namespace SSVM {
 namespace VM {
 
@@ -19,17 +26,62 @@ VM::VM(Configure &InputConfig, Runtime::StoreManager &S)
 }
 
 void VM::initVM() {
+  LoaderEngine.setLazyCode(Config.isLazyLoading());
+  LoaderEngine.setCacheDir(Config.getCacheDir());
   /// Set cost table and create import modules from configure.
   CostTab.setCostTable(Configure::VMType::Wasm);
   Measure.setCostTable(CostTab.getCostTable(Configure::VMType::Wasm));
   if (Config.hasVMType(Configure::VMType::Wasi)) {
     /// 2nd priority of cost table: Wasi
-    std::unique_ptr<Runtime::ImportObject> WasiMod =
+    std::unique_ptr<Host::WasiModule> WasiMod =
         std::make_unique<Host::WasiModule>();
+    for (const auto &[Path, Image] : Config.getMemoryPreopens()) {
+      if (WasiMod->getEnv().preopenVirtual(Path, Image->mount()) < 0) {
+        LOG(ERROR) << "Failed to preopen the in-memory directory " << Path;
+      }
+    }
+    switch (Config.getWriteBufferMode()) {
+    case Configure::WriteBufferMode::Line:
+      WasiMod->getEnv().setWriteBuffer(
+          Host::WasiEnvironment::WriteBufferMode::Line,
+          Config.getWriteBufferCapacity());
+      break;
+    case Configure::WriteBufferMode::Full:
+      WasiMod->getEnv().setWriteBuffer(
+          Host::WasiEnvironment::WriteBufferMode::Full,
+          Config.getWriteBufferCapacity());
+      break;
+    default:
+      break;
+    }
+    if (Config.isFrozenClock()) {
+      WasiMod->getEnv().setFrozenClock(true);
+    }
+    WasiMod->getEnv().getRandom().setReseedInterval(
+        Config.getRandomReseedInterval());
     InterpreterEngine.registerModule(StoreRef, *WasiMod.get());
+    addHostModule(*WasiMod.get());
+    /// ssvm_io: extensions on the file descriptors of the WASI module.
+    IOMod = std::make_unique<Host::SSVMIOModule>(WasiMod->getEnv());
+    InterpreterEngine.registerModule(StoreRef, *IOMod.get());
+    addHostModule(*IOMod.get());
     ImpObjs.insert({Configure::VMType::Wasi, std::move(WasiMod)});
     CostTab.setCostTable(Configure::VMType::Wasi);
     Measure.setCostTable(CostTab.getCostTable(Configure::VMType::Wasi));
+    /// wasi-threads: start `wasi_thread_start(tid, arg)` in a new thread.
+    std::unique_ptr<Host::WasiThreadsModule> WasiThreadsMod =
+        std::make_unique<Host::WasiThreadsModule>();
+    WasiThreadsMod->setSpawner([this](uint32_t StartArg) -> Expect<uint32_t> {
+      const uint32_t ThreadId = NextThreadId++;
+      if (auto Res = spawnThread("wasi_thread_start", {ThreadId, StartArg});
+          !Res) {
+        return Unexpect(Res);
+      }
+      return ThreadId;
+    });
+    InterpreterEngine.registerModule(StoreRef, *WasiThreadsMod.get());
+    addHostModule(*WasiThreadsMod.get());
+    ThreadsMod = std::move(WasiThreadsMod);
   }
 }
 
@@ -69,7 +121,11 @@ Expect<void> VM::registerModule(const Runtime::ImportObject &Obj) {
     /// Therefore the instantiation should restart.
     Stage = VMStage::Validated;
   }
-  return InterpreterEngine.registerModule(StoreRef, Obj);
+  if (auto Res = InterpreterEngine.registerModule(StoreRef, Obj); !Res) {
+    return Unexpect(Res);
+  }
+  addHostModule(Obj);
+  return {};
 }
 
 Expect<void> VM::registerModule(const std::string &Name,
@@ -78,6 +134,9 @@ Expect<void> VM::registerModule(const std::string &Name,
   if (auto Res = ValidatorEngine.validate(Module); !Res) {
     return Unexpect(Res);
   }
+  InterpreterEngine.setCodeValidator(ValidatorEngine.getCodeValidator());
+  /// Module cache is best-effort.
+  LoaderEngine.saveCache(Module);
   return InterpreterEngine.registerModule(StoreRef, Module, Name);
 }
 
@@ -119,6 +178,9 @@ VM::runWasmFile(const AST::Module &Module, const std::string &Func,
   if (auto Res = ValidatorEngine.validate(Module); !Res) {
     return Unexpect(Res);
   }
+  InterpreterEngine.setCodeValidator(ValidatorEngine.getCodeValidator());
+  /// Module cache is best-effort.
+  LoaderEngine.saveCache(Module);
   if (auto Res = InterpreterEngine.instantiateModule(StoreRef, Module); !Res) {
     return Unexpect(Res);
   }
@@ -127,12 +189,7 @@ VM::runWasmFile(const AST::Module &Module, const std::string &Func,
     Log::loggingError(ErrCode::FuncNotFound);
     return Unexpect(ErrCode::FuncNotFound);
   }
-  if (auto Res = InterpreterEngine.invoke(StoreRef, FuncExp.find(Func)->second,
-                                          Params)) {
-    return *Res;
-  } else {
-    return Unexpect(Res);
-  }
+  return invoke(FuncExp.find(Func)->second, Params);
 }
 
 Expect<void> VM::loadWasm(const std::string &Path) {
@@ -164,6 +221,9 @@ Expect<void> VM::validate() {
     return Unexpect(ErrCode::WrongVMWorkflow);
   }
   if (auto Res = ValidatorEngine.validate(*Mod.get())) {
+    ModCodeValidator = ValidatorEngine.getCodeValidator();
+    /// Module cache is best-effort.
+    LoaderEngine.saveCache(*Mod.get());
     Stage = VMStage::Validated;
     return {};
   } else {
@@ -177,6 +237,7 @@ Expect<void> VM::instantiate() {
     Log::loggingError(ErrCode::WrongVMWorkflow);
     return Unexpect(ErrCode::WrongVMWorkflow);
   }
+  InterpreterEngine.setCodeValidator(ModCodeValidator);
   if (auto Res =
           InterpreterEngine.instantiateModule(StoreRef, *Mod.get(), "")) {
     Stage = VMStage::Instantiated;
@@ -194,7 +255,7 @@ VM::execute(const std::string &Func, const std::vector<ValVariant> &Params) {
     Log::loggingError(ErrCode::FuncNotFound);
     return Unexpect(ErrCode::FuncNotFound);
   }
-  return InterpreterEngine.invoke(StoreRef, FuncExp.find(Func)->second, Params);
+  return invoke(FuncExp.find(Func)->second, Params);
 }
 
 Expect<std::vector<ValVariant>>
@@ -214,10 +275,72 @@ VM::execute(const std::string &Mod, const std::string &Func,
     Log::loggingError(ErrCode::FuncNotFound);
     return Unexpect(ErrCode::FuncNotFound);
   }
-  return InterpreterEngine.invoke(StoreRef, FuncExp.find(Func)->second, Params);
+  return invoke(FuncExp.find(Func)->second, Params);
+}
+
+Expect<std::vector<ValVariant>>
+VM::invoke(uint32_t FuncAddr, const std::vector<ValVariant> &Params) {
+  /// Take the time for the frozen WASI clocks of this invocation.
+  if (auto *WasiMod = dynamic_cast<Host::WasiModule *>(
+          getImportModule(Configure::VMType::Wasi))) {
+    WasiMod->getEnv().freezeClocks();
+  }
+  auto Res = InterpreterEngine.invoke(StoreRef, FuncAddr, Params);
+  joinThreads();
+  return Res;
+}
+
+Expect<void> VM::spawnThread(const std::string &Func,
+                             std::vector<ValVariant> Params) {
+  const auto FuncExp = StoreRef.getFuncExports();
+  if (FuncExp.find(Func) == FuncExp.cend()) {
+    Log::loggingError(ErrCode::FuncNotFound);
+    return Unexpect(ErrCode::FuncNotFound);
+  }
+  const uint32_t FuncAddr = FuncExp.find(Func)->second;
+  /// Each guest thread runs on its own engine for the stack and the trap
+  /// handling. The engine also holds the thread's own copies of the mutable
+  /// globals, such as the stack pointer and the TLS base, which are taken
+  /// here before the spawning thread goes on.
+  auto Engine = std::make_shared<Interpreter::Interpreter>();
+  const auto *FuncInst = *StoreRef.getFunction(FuncAddr);
+  if (auto Res = Engine->setThreadGlobals(StoreRef, FuncInst->getModuleAddr());
+      !Res) {
+    return Unexpect(Res);
+  }
+  std::unique_lock Lock(ThreadsMutex);
+  Threads.emplace_back([this, Engine = std::move(Engine), FuncAddr,
+                        Params = std::move(Params)]() {
+    /// The errors are logged in invoking.
+    Engine->invoke(StoreRef, FuncAddr, Params);
+  });
+  return {};
+}
+
+void VM::joinThreads() {
+  /// Threads may spawn more threads while being joined.
+  while (true) {
+    std::vector<std::thread> Joining;
+    {
+      std::unique_lock Lock(ThreadsMutex);
+      Joining.swap(Threads);
+    }
+    if (Joining.empty()) {
+      break;
+    }
+    for (auto &Thread : Joining) {
+      Thread.join();
+    }
+  }
+  /// The guest is done, so write out its buffered WASI output.
+  if (auto *WasiMod = dynamic_cast<Host::WasiModule *>(
+          getImportModule(Configure::VMType::Wasi))) {
+    WasiMod->getEnv().flushWriteBuffer();
+  }
 }
 
 void VM::cleanup() {
+  joinThreads();
   Mod.reset();
   StoreRef.reset();
   Measure.clear();
@@ -242,5 +365,72 @@ Runtime::ImportObject *VM::getImportModule(const Configure::VMType Type) {
   return nullptr;
 }
 
+void VM::addHostModule(const Runtime::ImportObject &Obj) {
+  if (Config.isHostFuncStats()) {
+    for (auto &Func : Obj.getFuncs()) {
+      Func.second->getHostFunc().getStats().setEnabled(true);
+    }
+  }
+  HostModules.push_back(&Obj);
+}
+
+std::vector<std::pair<std::string, const Runtime::HostFuncStats *>>
+VM::getHostFuncStats() const {
+  std::vector<std::pair<std::string, const Runtime::HostFuncStats *>> Res;
+  for (const auto *Obj : HostModules) {
+    for (auto &Func : Obj->getFuncs()) {
+      Res.emplace_back(Obj->getModuleName() + "." + Func.first,
+                       &Func.second->getHostFunc().getStats());
+    }
+  }
+  return Res;
+}
+
+void VM::dumpHostFuncStats(std::ostream &OS) const {
+  auto Stats = getHostFuncStats();
+  Stats.erase(std::remove_if(Stats.begin(), Stats.end(),
+                             [](const auto &S) {
+                               return S.second->getCalls() == 0;
+                             }),
+              Stats.end());
+  std::stable_sort(Stats.begin(), Stats.end(),
+                   [](const auto &L, const auto &R) {
+                     return L.second->getTotalTime() >
+                            R.second->getTotalTime();
+                   });
+  uint64_t TotalTime = 0, TotalCalls = 0, TotalIn = 0, TotalOut = 0;
+  for (const auto &S : Stats) {
+    TotalTime += S.second->getTotalTime();
+    TotalCalls += S.second->getCalls();
+    TotalIn += S.second->getBytesIn();
+    TotalOut += S.second->getBytesOut();
+  }
+
+  char Line[256];
+  const char *const Separator =
+      "------ ----------- ----------- --------- ---------- ---------- "
+      "---------- ---------- ----------------\n";
+  OS << "% time     seconds  usecs/call     calls   bytes in  bytes out "
+        "    p50 ns     p99 ns function\n"
+     << Separator;
+  for (const auto &[Name, S] : Stats) {
+    std::snprintf(Line, sizeof(Line),
+                  "%6.2f %11.6f %11" PRIu64 " %9" PRIu64 " %10" PRIu64
+                  " %10" PRIu64 " %10" PRIu64 " %10" PRIu64 " %s\n",
+                  TotalTime ? 100.0 * S->getTotalTime() / TotalTime : 0.0,
+                  S->getTotalTime() / 1e9,
+                  S->getTotalTime() / S->getCalls() / 1000,
+                  S->getCalls(), S->getBytesIn(), S->getBytesOut(),
+                  S->getPercentile(50), S->getPercentile(99), Name.c_str());
+    OS << Line;
+  }
+  std::snprintf(Line, sizeof(Line),
+                "%6.2f %11.6f %11s %9" PRIu64 " %10" PRIu64 " %10" PRIu64
+                " %10s %10s total\n",
+                TotalTime ? 100.0 : 0.0, TotalTime / 1e9, "", TotalCalls,
+                TotalIn, TotalOut, "", "");
+  OS << Separator << Line;
+}
+
 } // namespace VM
 } // namespace SSVM
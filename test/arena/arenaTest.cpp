@@ -0,0 +1,69 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/test/arena/arenaTest.cpp - arena unit tests ------------------===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of the Arena class.
+///
+//===----------------------------------------------------------------------===//
+
+#include "support/arena.h"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+struct Node {
+  Node(uint32_t V) : Value(V) {}
+  uint32_t Value;
+  uint64_t Padding = 0;
+};
+
+TEST(ArenaTest, Make) {
+  /// 1. Test objects are aligned, distinct, and kept across blocks.
+  SSVM::Arena Pool;
+  EXPECT_EQ(0U, Pool.getBlockCount());
+  std::vector<Node *> Nodes;
+  for (uint32_t I = 0; I < 10000; ++I) {
+    auto *Ptr = Pool.make<Node>(I);
+    EXPECT_EQ(0U, reinterpret_cast<uintptr_t>(Ptr) % alignof(Node));
+    Nodes.push_back(Ptr);
+  }
+  for (uint32_t I = 0; I < 10000; ++I) {
+    EXPECT_EQ(I, Nodes[I]->Value);
+  }
+  /// Blocks grow, so the count is far less than the objects.
+  EXPECT_LT(Pool.getBlockCount(), 16U);
+}
+
+TEST(ArenaTest, Copy) {
+  /// 2. Test copying arrays, including one larger than the maximum block.
+  SSVM::Arena Pool;
+  EXPECT_TRUE(Pool.copy(SSVM::Span<const uint32_t>()).empty());
+  Pool.make<uint8_t>(0);
+  for (size_t N : {1, 3, 100000}) {
+    std::vector<uint32_t> Vec(N);
+    for (size_t I = 0; I < N; ++I) {
+      Vec[I] = I * 7;
+    }
+    auto Copied = Pool.copy(SSVM::Span<const uint32_t>(Vec));
+    ASSERT_EQ(N, Copied.size());
+    EXPECT_NE(Vec.data(), Copied.data());
+    EXPECT_EQ(0U,
+              reinterpret_cast<uintptr_t>(Copied.data()) % alignof(uint32_t));
+    EXPECT_TRUE(std::equal(Vec.begin(), Vec.end(), Copied.begin()));
+  }
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -17,6 +17,7 @@
 namespace {
 
 SSVM::FileMgrVector Mgr;
+SSVM::Arena Pool;
 
 TEST(InstructionTest, LoadBlockControlInstruction) {
   /// 1. Test load block control instruction.
@@ -30,10 +31,10 @@ TEST(InstructionTest, LoadBlockControlInstruction) {
 
   Mgr.clearBuffer();
   SSVM::AST::BlockControlInstruction Ins1(Op1);
-  EXPECT_FALSE(Ins1.loadBinary(Mgr));
+  EXPECT_FALSE(Ins1.loadBinary(Mgr, Pool));
   Mgr.clearBuffer();
   SSVM::AST::BlockControlInstruction Ins2(Op2);
-  EXPECT_FALSE(Ins2.loadBinary(Mgr));
+  EXPECT_FALSE(Ins2.loadBinary(Mgr, Pool));
 
   Mgr.clearBuffer();
   std::vector<unsigned char> Vec2 = {
@@ -42,11 +43,11 @@ TEST(InstructionTest, LoadBlockControlInstruction) {
   };
   Mgr.setCode(Vec2);
   SSVM::AST::BlockControlInstruction Ins3(Op1);
-  EXPECT_TRUE(Ins3.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+  EXPECT_TRUE(Ins3.loadBinary(Mgr, Pool) && Mgr.getRemainSize() == 0);
   Mgr.clearBuffer();
   Mgr.setCode(Vec2);
   SSVM::AST::BlockControlInstruction Ins4(Op2);
-  EXPECT_TRUE(Ins4.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+  EXPECT_TRUE(Ins4.loadBinary(Mgr, Pool) && Mgr.getRemainSize() == 0);
 
   Mgr.clearBuffer();
   std::vector<unsigned char> Vec3 = {
@@ -57,11 +58,11 @@ TEST(InstructionTest, LoadBlockControlInstruction) {
   };
   Mgr.setCode(Vec3);
   SSVM::AST::BlockControlInstruction Ins5(Op1);
-  EXPECT_FALSE(Ins5.loadBinary(Mgr));
+  EXPECT_FALSE(Ins5.loadBinary(Mgr, Pool));
   Mgr.clearBuffer();
   Mgr.setCode(Vec3);
   SSVM::AST::BlockControlInstruction Ins6(Op2);
-  EXPECT_FALSE(Ins6.loadBinary(Mgr));
+  EXPECT_FALSE(Ins6.loadBinary(Mgr, Pool));
 
   Mgr.clearBuffer();
   std::vector<unsigned char> Vec4 = {
@@ -71,11 +72,11 @@ TEST(InstructionTest, LoadBlockControlInstruction) {
   };
   Mgr.setCode(Vec4);
   SSVM::AST::BlockControlInstruction Ins7(Op1);
-  EXPECT_TRUE(Ins7.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+  EXPECT_TRUE(Ins7.loadBinary(Mgr, Pool) && Mgr.getRemainSize() == 0);
   Mgr.clearBuffer();
   Mgr.setCode(Vec4);
   SSVM::AST::BlockControlInstruction Ins8(Op2);
-  EXPECT_TRUE(Ins8.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+  EXPECT_TRUE(Ins8.loadBinary(Mgr, Pool) && Mgr.getRemainSize() == 0);
 }
 
 TEST(InstructionTest, LoadIfElseControlInstruction) {
@@ -92,7 +93,7 @@ TEST(InstructionTest, LoadIfElseControlInstruction) {
 
   Mgr.clearBuffer();
   SSVM::AST::IfElseControlInstruction Ins1(Op);
-  EXPECT_FALSE(Ins1.loadBinary(Mgr));
+  EXPECT_FALSE(Ins1.loadBinary(Mgr, Pool));
 
   Mgr.clearBuffer();
   std::vector<unsigned char> Vec2 = {
@@ -101,7 +102,7 @@ TEST(InstructionTest, LoadIfElseControlInstruction) {
   };
   Mgr.setCode(Vec2);
   SSVM::AST::IfElseControlInstruction Ins2(Op);
-  EXPECT_TRUE(Ins2.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+  EXPECT_TRUE(Ins2.loadBinary(Mgr, Pool) && Mgr.getRemainSize() == 0);
 
   Mgr.clearBuffer();
   std::vector<unsigned char> Vec3 = {
@@ -111,7 +112,7 @@ TEST(InstructionTest, LoadIfElseControlInstruction) {
   };
   Mgr.setCode(Vec3);
   SSVM::AST::IfElseControlInstruction Ins3(Op);
-  EXPECT_TRUE(Ins3.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+  EXPECT_TRUE(Ins3.loadBinary(Mgr, Pool) && Mgr.getRemainSize() == 0);
 
   Mgr.clearBuffer();
   std::vector<unsigned char> Vec4 = {
@@ -121,7 +122,7 @@ TEST(InstructionTest, LoadIfElseControlInstruction) {
   };
   Mgr.setCode(Vec4);
   SSVM::AST::IfElseControlInstruction Ins4(Op);
-  EXPECT_FALSE(Ins4.loadBinary(Mgr));
+  EXPECT_FALSE(Ins4.loadBinary(Mgr, Pool));
 
   Mgr.clearBuffer();
   std::vector<unsigned char> Vec5 = {
@@ -133,7 +134,7 @@ TEST(InstructionTest, LoadIfElseControlInstruction) {
   };
   Mgr.setCode(Vec5);
   SSVM::AST::IfElseControlInstruction Ins5(Op);
-  EXPECT_FALSE(Ins5.loadBinary(Mgr));
+  EXPECT_FALSE(Ins5.loadBinary(Mgr, Pool));
 
   Mgr.clearBuffer();
   std::vector<unsigned char> Vec6 = {
@@ -143,7 +144,7 @@ TEST(InstructionTest, LoadIfElseControlInstruction) {
   };
   Mgr.setCode(Vec6);
   SSVM::AST::IfElseControlInstruction Ins6(Op);
-  EXPECT_TRUE(Ins6.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+  EXPECT_TRUE(Ins6.loadBinary(Mgr, Pool) && Mgr.getRemainSize() == 0);
 
   Mgr.clearBuffer();
   std::vector<unsigned char> Vec7 = {
@@ -155,7 +156,7 @@ TEST(InstructionTest, LoadIfElseControlInstruction) {
   };
   Mgr.setCode(Vec7);
   SSVM::AST::IfElseControlInstruction Ins7(Op);
-  EXPECT_TRUE(Ins7.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+  EXPECT_TRUE(Ins7.loadBinary(Mgr, Pool) && Mgr.getRemainSize() == 0);
 }
 
 TEST(InstructionTest, LoadBrControlInstruction) {
@@ -168,10 +169,10 @@ TEST(InstructionTest, LoadBrControlInstruction) {
 
   Mgr.clearBuffer();
   SSVM::AST::BrControlInstruction Ins1(Op1);
-  EXPECT_FALSE(Ins1.loadBinary(Mgr));
+  EXPECT_FALSE(Ins1.loadBinary(Mgr, Pool));
   Mgr.clearBuffer();
   SSVM::AST::BrControlInstruction Ins2(Op2);
-  EXPECT_FALSE(Ins2.loadBinary(Mgr));
+  EXPECT_FALSE(Ins2.loadBinary(Mgr, Pool));
 
   Mgr.clearBuffer();
   std::vector<unsigned char> Vec2 = {
@@ -179,11 +180,11 @@ TEST(InstructionTest, LoadBrControlInstruction) {
   };
   Mgr.setCode(Vec2);
   SSVM::AST::BrControlInstruction Ins3(Op1);
-  EXPECT_TRUE(Ins3.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+  EXPECT_TRUE(Ins3.loadBinary(Mgr, Pool) && Mgr.getRemainSize() == 0);
   Mgr.clearBuffer();
   Mgr.setCode(Vec2);
   SSVM::AST::BrControlInstruction Ins4(Op2);
-  EXPECT_TRUE(Ins4.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+  EXPECT_TRUE(Ins4.loadBinary(Mgr, Pool) && Mgr.getRemainSize() == 0);
 }
 
 TEST(InstructionTest, LoadBrTableControlInstruction) {
@@ -196,7 +197,7 @@ TEST(InstructionTest, LoadBrTableControlInstruction) {
 
   Mgr.clearBuffer();
   SSVM::AST::BrTableControlInstruction Ins1(Op);
-  EXPECT_FALSE(Ins1.loadBinary(Mgr));
+  EXPECT_FALSE(Ins1.loadBinary(Mgr, Pool));
 
   Mgr.clearBuffer();
   std::vector<unsigned char> Vec2 = {
@@ -205,7 +206,7 @@ TEST(InstructionTest, LoadBrTableControlInstruction) {
   };
   Mgr.setCode(Vec2);
   SSVM::AST::BrTableControlInstruction Ins2(Op);
-  EXPECT_TRUE(Ins2.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+  EXPECT_TRUE(Ins2.loadBinary(Mgr, Pool) && Mgr.getRemainSize() == 0);
 
   Mgr.clearBuffer();
   std::vector<unsigned char> Vec3 = {
@@ -217,7 +218,7 @@ TEST(InstructionTest, LoadBrTableControlInstruction) {
   };
   Mgr.setCode(Vec3);
   SSVM::AST::BrTableControlInstruction Ins3(Op);
-  EXPECT_TRUE(Ins3.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+  EXPECT_TRUE(Ins3.loadBinary(Mgr, Pool) && Mgr.getRemainSize() == 0);
 }
 
 TEST(InstructionTest, LoadCallControlInstruction) {
@@ -232,10 +233,10 @@ TEST(InstructionTest, LoadCallControlInstruction) {
 
   Mgr.clearBuffer();
   SSVM::AST::CallControlInstruction Ins1(Op1);
-  EXPECT_FALSE(Ins1.loadBinary(Mgr));
+  EXPECT_FALSE(Ins1.loadBinary(Mgr, Pool));
   Mgr.clearBuffer();
   SSVM::AST::CallControlInstruction Ins2(Op2);
-  EXPECT_FALSE(Ins2.loadBinary(Mgr));
+  EXPECT_FALSE(Ins2.loadBinary(Mgr, Pool));
 
   Mgr.clearBuffer();
   std::vector<unsigned char> Vec2 = {
@@ -243,7 +244,7 @@ TEST(InstructionTest, LoadCallControlInstruction) {
   };
   Mgr.setCode(Vec2);
   SSVM::AST::CallControlInstruction Ins3(Op1);
-  EXPECT_TRUE(Ins3.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+  EXPECT_TRUE(Ins3.loadBinary(Mgr, Pool) && Mgr.getRemainSize() == 0);
 
   Mgr.clearBuffer();
   std::vector<unsigned char> Vec3 = {
@@ -252,7 +253,7 @@ TEST(InstructionTest, LoadCallControlInstruction) {
   };
   Mgr.setCode(Vec3);
   SSVM::AST::CallControlInstruction Ins4(Op2);
-  EXPECT_TRUE(Ins4.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+  EXPECT_TRUE(Ins4.loadBinary(Mgr, Pool) && Mgr.getRemainSize() == 0);
 }
 
 TEST(InstructionTest, LoadVariableInstruction) {
@@ -265,7 +266,7 @@ TEST(InstructionTest, LoadVariableInstruction) {
 
   Mgr.clearBuffer();
   SSVM::AST::VariableInstruction Ins1(Op);
-  EXPECT_FALSE(Ins1.loadBinary(Mgr));
+  EXPECT_FALSE(Ins1.loadBinary(Mgr, Pool));
 
   Mgr.clearBuffer();
   std::vector<unsigned char> Vec2 = {
@@ -273,7 +274,7 @@ TEST(InstructionTest, LoadVariableInstruction) {
   };
   Mgr.setCode(Vec2);
   SSVM::AST::VariableInstruction Ins2(Op);
-  EXPECT_TRUE(Ins2.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+  EXPECT_TRUE(Ins2.loadBinary(Mgr, Pool) && Mgr.getRemainSize() == 0);
 }
 
 TEST(InstructionTest, LoadMemoryInstruction) {
@@ -290,10 +291,10 @@ TEST(InstructionTest, LoadMemoryInstruction) {
 
   Mgr.clearBuffer();
   SSVM::AST::MemoryInstruction Ins1(Op1);
-  EXPECT_FALSE(Ins1.loadBinary(Mgr));
+  EXPECT_FALSE(Ins1.loadBinary(Mgr, Pool));
   Mgr.clearBuffer();
   SSVM::AST::MemoryInstruction Ins2(Op2);
-  EXPECT_FALSE(Ins2.loadBinary(Mgr));
+  EXPECT_FALSE(Ins2.loadBinary(Mgr, Pool));
 
   Mgr.clearBuffer();
   std::vector<unsigned char> Vec2 = {
@@ -301,7 +302,7 @@ TEST(InstructionTest, LoadMemoryInstruction) {
   };
   Mgr.setCode(Vec2);
   SSVM::AST::MemoryInstruction Ins3(Op2);
-  EXPECT_FALSE(Ins3.loadBinary(Mgr));
+  EXPECT_FALSE(Ins3.loadBinary(Mgr, Pool));
 
   Mgr.clearBuffer();
   std::vector<unsigned char> Vec3 = {
@@ -310,7 +311,7 @@ TEST(InstructionTest, LoadMemoryInstruction) {
   };
   Mgr.setCode(Vec3);
   SSVM::AST::MemoryInstruction Ins4(Op1);
-  EXPECT_TRUE(Ins4.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+  EXPECT_TRUE(Ins4.loadBinary(Mgr, Pool) && Mgr.getRemainSize() == 0);
 
   Mgr.clearBuffer();
   std::vector<unsigned char> Vec4 = {
@@ -318,7 +319,7 @@ TEST(InstructionTest, LoadMemoryInstruction) {
   };
   Mgr.setCode(Vec4);
   SSVM::AST::MemoryInstruction Ins5(Op2);
-  EXPECT_TRUE(Ins5.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+  EXPECT_TRUE(Ins5.loadBinary(Mgr, Pool) && Mgr.getRemainSize() == 0);
 }
 
 TEST(InstructionTest, LoadConstInstruction) {
@@ -340,7 +341,7 @@ TEST(InstructionTest, LoadConstInstruction) {
 
   Mgr.clearBuffer();
   SSVM::AST::ConstInstruction Ins1(Op1);
-  EXPECT_FALSE(Ins1.loadBinary(Mgr));
+  EXPECT_FALSE(Ins1.loadBinary(Mgr, Pool));
 
   Mgr.clearBuffer();
   std::vector<unsigned char> Vec2 = {
@@ -348,7 +349,7 @@ TEST(InstructionTest, LoadConstInstruction) {
   };
   Mgr.setCode(Vec2);
   SSVM::AST::ConstInstruction Ins2(Op1);
-  EXPECT_TRUE(Ins2.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+  EXPECT_TRUE(Ins2.loadBinary(Mgr, Pool) && Mgr.getRemainSize() == 0);
 
   Mgr.clearBuffer();
   std::vector<unsigned char> Vec3 = {
@@ -356,7 +357,7 @@ TEST(InstructionTest, LoadConstInstruction) {
   };
   Mgr.setCode(Vec3);
   SSVM::AST::ConstInstruction Ins3(Op2);
-  EXPECT_TRUE(Ins3.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+  EXPECT_TRUE(Ins3.loadBinary(Mgr, Pool) && Mgr.getRemainSize() == 0);
 
   Mgr.clearBuffer();
   std::vector<unsigned char> Vec4 = {
@@ -364,7 +365,7 @@ TEST(InstructionTest, LoadConstInstruction) {
   };
   Mgr.setCode(Vec4);
   SSVM::AST::ConstInstruction Ins4(Op3);
-  EXPECT_TRUE(Ins4.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+  EXPECT_TRUE(Ins4.loadBinary(Mgr, Pool) && Mgr.getRemainSize() == 0);
 
   Mgr.clearBuffer();
   std::vector<unsigned char> Vec5 = {
@@ -372,7 +373,353 @@ TEST(InstructionTest, LoadConstInstruction) {
   };
   Mgr.setCode(Vec5);
   SSVM::AST::ConstInstruction Ins5(Op4);
-  EXPECT_TRUE(Ins5.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+  EXPECT_TRUE(Ins5.loadBinary(Mgr, Pool) && Mgr.getRemainSize() == 0);
+}
+
+TEST(InstructionTest, LoadSIMDInstruction) {
+  /// 9. Test SIMD instructions.
+  ///
+  ///   1.  Load V128 const instruction.
+  ///   2.  Load SIMD memory instruction with lane index.
+  ///   3.  Load shuffle instruction.
+  ///   4.  Load block with valid and invalid prefixed OpCodes.
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec1 = {
+      0x01U, 0x00U, 0x00U, 0x00U, 0x02U, 0x00U, 0x00U, 0x00U,
+      0x03U, 0x00U, 0x00U, 0x00U, 0x04U, 0x00U, 0x00U, 0x00U /// I32x4 1 2 3 4
+  };
+  Mgr.setCode(Vec1);
+  SSVM::AST::ConstInstruction Ins1(
+      SSVM::AST::Instruction::OpCode::V128__const);
+  EXPECT_TRUE(Ins1.loadBinary(Mgr, Pool) && Mgr.getRemainSize() == 0);
+  EXPECT_TRUE(std::get<SSVM::uint128_t>(Ins1.getConstValue()) ==
+              ((SSVM::uint128_t(0x0000000400000003U) << 64) |
+               0x0000000200000001U));
+
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec2 = {
+      0x00U, /// Align.
+      0x10U, /// Offset.
+      0x07U  /// Lane index.
+  };
+  Mgr.setCode(Vec2);
+  SSVM::AST::SIMDMemoryInstruction Ins2(
+      SSVM::AST::Instruction::OpCode::V128__load8_lane);
+  EXPECT_TRUE(Ins2.loadBinary(Mgr, Pool) && Mgr.getRemainSize() == 0);
+  EXPECT_EQ(0x10U, Ins2.getMemoryOffset());
+  EXPECT_EQ(0x07U, Ins2.getLaneIndex());
+
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec3(16);
+  for (size_t I = 0; I < Vec3.size(); ++I) {
+    Vec3[I] = static_cast<unsigned char>(31 - I);
+  }
+  Mgr.setCode(Vec3);
+  SSVM::AST::SIMDShuffleInstruction Ins3(
+      SSVM::AST::Instruction::OpCode::I8x16__shuffle);
+  EXPECT_TRUE(Ins3.loadBinary(Mgr, Pool) && Mgr.getRemainSize() == 0);
+  EXPECT_EQ(31U, Ins3.getShuffleLanes()[0]);
+
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec4 = {
+      0x40U,               /// Block type.
+      0xFDU, 0x62U,        /// I8x16 popcnt.
+      0xFDU, 0xAEU, 0x01U, /// I32x4 add.
+      0x0BU                /// OpCode End.
+  };
+  Mgr.setCode(Vec4);
+  SSVM::AST::BlockControlInstruction Ins4(
+      SSVM::AST::Instruction::OpCode::Block);
+  EXPECT_TRUE(Ins4.loadBinary(Mgr, Pool) && Mgr.getRemainSize() == 0);
+  EXPECT_EQ(SSVM::AST::Instruction::OpCode::I32x4__add,
+            Ins4.getBody()[1]->getOpCode());
+
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec5 = {
+      0x40U,               /// Block type.
+      0xFDU, 0x9AU, 0x01U, /// Invalid SIMD OpCode.
+      0x0BU                /// OpCode End.
+  };
+  Mgr.setCode(Vec5);
+  SSVM::AST::BlockControlInstruction Ins5(
+      SSVM::AST::Instruction::OpCode::Block);
+  EXPECT_FALSE(Ins5.loadBinary(Mgr, Pool));
+}
+
+TEST(InstructionTest, LoadBulkMemoryInstruction) {
+  /// 10. Test bulk memory instructions.
+  ///
+  ///   1.  Load memory.init instruction with data index.
+  ///   2.  Load invalid memory.copy instruction with non-zero memory index.
+  ///   3.  Load table.copy instruction with table indices.
+  ///   4.  Load block with prefixed OpCodes.
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec1 = {
+      0x03U, /// Data index.
+      0x00U  /// Memory index.
+  };
+  Mgr.setCode(Vec1);
+  SSVM::AST::MemoryInstruction Ins1(
+      SSVM::AST::Instruction::OpCode::Memory__init);
+  EXPECT_TRUE(Ins1.loadBinary(Mgr, Pool) && Mgr.getRemainSize() == 0);
+  EXPECT_EQ(0x03U, Ins1.getDataIndex());
+
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec2 = {
+      0x00U, /// Destination memory index.
+      0x01U  /// Invalid source memory index.
+  };
+  Mgr.setCode(Vec2);
+  SSVM::AST::MemoryInstruction Ins2(
+      SSVM::AST::Instruction::OpCode::Memory__copy);
+  EXPECT_FALSE(Ins2.loadBinary(Mgr, Pool));
+
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec3 = {
+      0x01U, /// Destination table index.
+      0x02U  /// Source table index.
+  };
+  Mgr.setCode(Vec3);
+  SSVM::AST::TableInstruction Ins3(
+      SSVM::AST::Instruction::OpCode::Table__copy);
+  EXPECT_TRUE(Ins3.loadBinary(Mgr, Pool) && Mgr.getRemainSize() == 0);
+  EXPECT_EQ(0x01U, Ins3.getTargetIndex());
+  EXPECT_EQ(0x02U, Ins3.getSourceIndex());
+
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec4 = {
+      0x40U,               /// Block type.
+      0xFCU, 0x0BU, 0x00U, /// Memory fill.
+      0xFCU, 0x0DU, 0x00U, /// Elem drop.
+      0x0BU                /// OpCode End.
+  };
+  Mgr.setCode(Vec4);
+  SSVM::AST::BlockControlInstruction Ins4(
+      SSVM::AST::Instruction::OpCode::Block);
+  EXPECT_TRUE(Ins4.loadBinary(Mgr, Pool) && Mgr.getRemainSize() == 0);
+  EXPECT_EQ(SSVM::AST::Instruction::OpCode::Memory__fill,
+            Ins4.getBody()[0]->getOpCode());
+  EXPECT_EQ(SSVM::AST::Instruction::OpCode::Elem__drop,
+            Ins4.getBody()[1]->getOpCode());
+}
+
+
+TEST(InstructionTest, LoadAtomicMemoryInstruction) {
+  /// 11. Test atomic memory instructions.
+  ///
+  ///   1.  Load atomic rmw instruction with align and offset.
+  ///   2.  Load invalid atomic.fence instruction with non-zero byte.
+  ///   3.  Load block with atomic OpCodes.
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec1 = {
+      0x02U, /// Align.
+      0x10U  /// Offset.
+  };
+  Mgr.setCode(Vec1);
+  SSVM::AST::AtomicMemoryInstruction Ins1(
+      SSVM::AST::Instruction::OpCode::I32__atomic__rmw__add);
+  EXPECT_TRUE(Ins1.loadBinary(Mgr, Pool) && Mgr.getRemainSize() == 0);
+  EXPECT_EQ(0x02U, Ins1.getMemoryAlign());
+  EXPECT_EQ(0x10U, Ins1.getMemoryOffset());
+
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec2 = {
+      0x01U /// Invalid reserved byte.
+  };
+  Mgr.setCode(Vec2);
+  SSVM::AST::AtomicMemoryInstruction Ins2(
+      SSVM::AST::Instruction::OpCode::Atomic__fence);
+  EXPECT_FALSE(Ins2.loadBinary(Mgr, Pool));
+
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec3 = {
+      0x40U,                      /// Block type.
+      0xFEU, 0x03U, 0x00U,        /// Atomic fence.
+      0xFEU, 0x49U, 0x03U, 0x00U, /// I64 atomic cmpxchg.
+      0x0BU                       /// OpCode End.
+  };
+  Mgr.setCode(Vec3);
+  SSVM::AST::BlockControlInstruction Ins3(
+      SSVM::AST::Instruction::OpCode::Block);
+  EXPECT_TRUE(Ins3.loadBinary(Mgr, Pool) && Mgr.getRemainSize() == 0);
+  EXPECT_EQ(SSVM::AST::Instruction::OpCode::Atomic__fence,
+            Ins3.getBody()[0]->getOpCode());
+  EXPECT_EQ(SSVM::AST::Instruction::OpCode::I64__atomic__rmw__cmpxchg,
+            Ins3.getBody()[1]->getOpCode());
+}
+
+TEST(InstructionTest, LoadReferenceInstruction) {
+  /// 12. Test reference and table instructions.
+  ///
+  ///   1.  Load ref.null instruction with reference type.
+  ///   2.  Load invalid ref.null instruction with number type.
+  ///   3.  Load typed select instruction.
+  ///   4.  Load invalid typed select instruction with two types.
+  ///   5.  Load call_indirect instruction with table index.
+  ///   6.  Load block with reference and table OpCodes.
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec1 = {
+      0x6FU /// Reference type.
+  };
+  Mgr.setCode(Vec1);
+  SSVM::AST::ReferenceInstruction Ins1(
+      SSVM::AST::Instruction::OpCode::Ref__null);
+  EXPECT_TRUE(Ins1.loadBinary(Mgr, Pool) && Mgr.getRemainSize() == 0);
+  EXPECT_EQ(SSVM::ValType::ExternRef, Ins1.getReferenceType());
+
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec2 = {
+      0x7FU /// Invalid reference type.
+  };
+  Mgr.setCode(Vec2);
+  SSVM::AST::ReferenceInstruction Ins2(
+      SSVM::AST::Instruction::OpCode::Ref__null);
+  EXPECT_FALSE(Ins2.loadBinary(Mgr, Pool));
+
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec3 = {
+      0x01U, /// Vector length = 1.
+      0x70U  /// Value type.
+  };
+  Mgr.setCode(Vec3);
+  SSVM::AST::ParametricInstruction Ins3(
+      SSVM::AST::Instruction::OpCode::Select_t);
+  EXPECT_TRUE(Ins3.loadBinary(Mgr, Pool) && Mgr.getRemainSize() == 0);
+  EXPECT_EQ(SSVM::ValType::FuncRef, Ins3.getValType());
+
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec4 = {
+      0x02U,       /// Vector length = 2.
+      0x7FU, 0x7FU /// Value types.
+  };
+  Mgr.setCode(Vec4);
+  SSVM::AST::ParametricInstruction Ins4(
+      SSVM::AST::Instruction::OpCode::Select_t);
+  EXPECT_FALSE(Ins4.loadBinary(Mgr, Pool));
+
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec5 = {
+      0x01U, /// Type index.
+      0x02U  /// Table index.
+  };
+  Mgr.setCode(Vec5);
+  SSVM::AST::CallControlInstruction Ins5(
+      SSVM::AST::Instruction::OpCode::Call_indirect);
+  EXPECT_TRUE(Ins5.loadBinary(Mgr, Pool) && Mgr.getRemainSize() == 0);
+  EXPECT_EQ(0x01U, Ins5.getFuncIndex());
+  EXPECT_EQ(0x02U, Ins5.getTableIndex());
+
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec6 = {
+      0x40U,               /// Block type.
+      0xD2U, 0x03U,        /// Ref func.
+      0xD1U,               /// Ref is_null.
+      0x25U, 0x01U,        /// Table get.
+      0xFCU, 0x0FU, 0x01U, /// Table grow.
+      0x0BU                /// OpCode End.
+  };
+  Mgr.setCode(Vec6);
+  SSVM::AST::BlockControlInstruction Ins6(
+      SSVM::AST::Instruction::OpCode::Block);
+  EXPECT_TRUE(Ins6.loadBinary(Mgr, Pool) && Mgr.getRemainSize() == 0);
+  ASSERT_EQ(4U, Ins6.getBody().size());
+  EXPECT_EQ(3U, static_cast<const SSVM::AST::ReferenceInstruction *>(
+                    Ins6.getBody()[0])
+                    ->getFuncIndex());
+  EXPECT_EQ(SSVM::AST::Instruction::OpCode::Ref__is_null,
+            Ins6.getBody()[1]->getOpCode());
+  EXPECT_EQ(SSVM::AST::Instruction::OpCode::Table__get,
+            Ins6.getBody()[2]->getOpCode());
+  EXPECT_EQ(1U, static_cast<const SSVM::AST::TableInstruction *>(
+                    Ins6.getBody()[3])
+                    ->getTargetIndex());
+}
+
+TEST(InstructionTest, LoadTailCallInstruction) {
+  /// 13. Test tail call instructions.
+  ///
+  ///   1.  Load return_call instruction.
+  ///   2.  Load return_call_indirect instruction with table index.
+  ///   3.  Load block with tail call OpCodes.
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec1 = {
+      0x05U /// Function index.
+  };
+  Mgr.setCode(Vec1);
+  SSVM::AST::CallControlInstruction Ins1(
+      SSVM::AST::Instruction::OpCode::Return_call);
+  EXPECT_TRUE(Ins1.loadBinary(Mgr, Pool) && Mgr.getRemainSize() == 0);
+  EXPECT_EQ(0x05U, Ins1.getFuncIndex());
+
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec2 = {
+      0x01U, /// Type index.
+      0x02U  /// Table index.
+  };
+  Mgr.setCode(Vec2);
+  SSVM::AST::CallControlInstruction Ins2(
+      SSVM::AST::Instruction::OpCode::Return_call_indirect);
+  EXPECT_TRUE(Ins2.loadBinary(Mgr, Pool) && Mgr.getRemainSize() == 0);
+  EXPECT_EQ(0x01U, Ins2.getFuncIndex());
+  EXPECT_EQ(0x02U, Ins2.getTableIndex());
+
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec3 = {
+      0x40U,               /// Block type.
+      0x12U, 0x00U,        /// Return call.
+      0x13U, 0x00U, 0x00U, /// Return call indirect.
+      0x0BU                /// OpCode End.
+  };
+  Mgr.setCode(Vec3);
+  SSVM::AST::BlockControlInstruction Ins3(
+      SSVM::AST::Instruction::OpCode::Block);
+  EXPECT_TRUE(Ins3.loadBinary(Mgr, Pool) && Mgr.getRemainSize() == 0);
+  ASSERT_EQ(2U, Ins3.getBody().size());
+  EXPECT_EQ(SSVM::AST::Instruction::OpCode::Return_call,
+            Ins3.getBody()[0]->getOpCode());
+  EXPECT_EQ(SSVM::AST::Instruction::OpCode::Return_call_indirect,
+            Ins3.getBody()[1]->getOpCode());
+}
+
+TEST(InstructionTest, LoadMultiValueBlock) {
+  /// 14. Test block instructions with function type indices.
+  ///
+  ///   1.  Load block with type index.
+  ///   2.  Load if-else with type index.
+  ///   3.  Load invalid block with type index out of 32-bit range.
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec1 = {
+      0x81U, 0x01U, /// Block type index 129.
+      0x0BU         /// OpCode End.
+  };
+  Mgr.setCode(Vec1);
+  SSVM::AST::BlockControlInstruction Ins1(
+      SSVM::AST::Instruction::OpCode::Block);
+  EXPECT_TRUE(Ins1.loadBinary(Mgr, Pool) && Mgr.getRemainSize() == 0);
+  EXPECT_EQ(SSVM::BlockType(129U), Ins1.getBlockType());
+
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec2 = {
+      0x02U, /// Block type index 2.
+      0x6AU, /// OpCode I32__add.
+      0x05U, /// OpCode Else.
+      0x6BU, /// OpCode I32__sub.
+      0x0BU  /// OpCode End.
+  };
+  Mgr.setCode(Vec2);
+  SSVM::AST::IfElseControlInstruction Ins2(SSVM::AST::Instruction::OpCode::If);
+  EXPECT_TRUE(Ins2.loadBinary(Mgr, Pool) && Mgr.getRemainSize() == 0);
+  EXPECT_EQ(SSVM::BlockType(2U), Ins2.getBlockType());
+
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec3 = {
+      0x80U, 0x80U, 0x80U, 0x80U, 0x10U, /// Block type index 2^32.
+      0x0BU                              /// OpCode End.
+  };
+  Mgr.setCode(Vec3);
+  SSVM::AST::BlockControlInstruction Ins3(
+      SSVM::AST::Instruction::OpCode::Block);
+  EXPECT_FALSE(Ins3.loadBinary(Mgr, Pool));
 }
 
 } // namespace
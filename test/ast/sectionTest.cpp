@@ -406,19 +406,25 @@ TEST(SectionTest, LoadElementSection) {
 
   Mgr.clearBuffer();
   std::vector<unsigned char> Vec4 = {
-      0xA8U, 0x80U, 0x80U, 0x80U, 0x00U, /// Content size = 40
+      0xAEU, 0x80U, 0x80U, 0x80U, 0x00U, /// Content size = 46
       0x03U,                             /// Vector length = 3
       /// vec[0]
+      0x02U,                             /// Flags
       0xFFU, 0xFFU, 0xFFU, 0xFFU, 0x0FU, /// Table index
       0x45U, 0x46U, 0x47U, 0x0BU,        /// Expression
+      0x00U,                             /// Element kind
       0x03U, 0x00U, 0x0AU, 0x0FU,        /// Vec(3)
       /// vec[1]
+      0x02U,                             /// Flags
       0xF0U, 0xFFU, 0xFFU, 0xFFU, 0x0FU, /// Table index
       0x45U, 0x46U, 0x47U, 0x0BU,        /// Expression
+      0x00U,                             /// Element kind
       0x03U, 0x0AU, 0x0BU, 0x0CU,        /// Vec(3)
       /// vec[2]
+      0x02U,                             /// Flags
       0x99U, 0xFFU, 0xFFU, 0xFFU, 0x0FU, /// Table index
       0x45U, 0x46U, 0x47U, 0x0BU,        /// Expression
+      0x00U,                             /// Element kind
       0x03U, 0x03U, 0x06U, 0x09U         /// Vec(3)
   };
   Mgr.setCode(Vec4);
@@ -476,8 +482,87 @@ TEST(SectionTest, LoadCodeSection) {
   EXPECT_TRUE(Sec4.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
 }
 
+TEST(SectionTest, LoadLargeCodeSection) {
+  /// 12. Test load code section large enough to be parsed in parallel.
+  ///
+  ///   1.  Load code section with 8000 segments.
+  ///   2.  Load code section with a segment without End operation and a later
+  ///       segment with trailing bytes.
+  ///   3.  Load code section with only the segment with trailing bytes.
+  ///   4.  Lazily load code section with the segment with trailing bytes,
+  ///       which fails when decoding that segment only.
+  constexpr uint32_t kCount = 8000;
+  const auto MakeSection = [](uint32_t NoEnd, uint32_t Trailing) {
+    std::vector<unsigned char> Content = {
+        0x80U, 0x80U, 0x80U, 0x80U, 0x00U /// Vector length = 8000
+    };
+    for (uint32_t I = 0, N = kCount; I < 5; ++I, N >>= 7) {
+      Content[I] |= N & 0x7FU;
+    }
+    for (uint32_t I = 0; I < kCount; ++I) {
+      Content.insert(Content.end(), {
+                                        0x09U,               /// Segment size
+                                        0x02U, 0x01U, 0x7CU, /// Local vec(2)
+                                        0x02U, 0x7DU,        ///
+                                        0x45U, 0x46U, 0x47U, /// Expression
+                                        0x0BU                ///
+                                    });
+      if (I == NoEnd) {
+        Content.back() = 0x45U;
+      } else if (I == Trailing) {
+        Content[Content.size() - 10] = 0x0AU;
+        Content.push_back(0x00U);
+      }
+    }
+    std::vector<unsigned char> Vec = {0x80U, 0x80U, 0x80U, 0x80U, 0x00U};
+    for (uint32_t I = 0, N = Content.size(); I < 5; ++I, N >>= 7) {
+      Vec[I] |= N & 0x7FU;
+    }
+    Vec.insert(Vec.end(), Content.begin(), Content.end());
+    return Vec;
+  };
+
+  Mgr.clearBuffer();
+  Mgr.setCode(MakeSection(kCount, kCount));
+  SSVM::AST::CodeSection Sec1;
+  EXPECT_TRUE(Sec1.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+  EXPECT_EQ(kCount, Sec1.getContent().size());
+
+  Mgr.clearBuffer();
+  Mgr.setCode(MakeSection(3000, 5000));
+  SSVM::AST::CodeSection Sec2;
+  auto Res2 = Sec2.loadBinary(Mgr);
+  ASSERT_FALSE(Res2);
+  EXPECT_EQ(SSVM::ErrCode::EndOfFile, Res2.error());
+
+  Mgr.clearBuffer();
+  Mgr.setCode(MakeSection(kCount, 5000));
+  SSVM::AST::CodeSection Sec3;
+  auto Res3 = Sec3.loadBinary(Mgr);
+  ASSERT_FALSE(Res3);
+  EXPECT_EQ(SSVM::ErrCode::InvalidGrammar, Res3.error());
+
+  Mgr.clearBuffer();
+  Mgr.setCode(MakeSection(kCount, 5000));
+  SSVM::AST::CodeSection Sec4;
+  Sec4.setLazy(true);
+  EXPECT_TRUE(Sec4.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+  ASSERT_EQ(kCount, Sec4.getContent().size());
+  auto &Seg4 = *Sec4.getContent()[0];
+  EXPECT_FALSE(Seg4.isLoaded());
+  EXPECT_EQ(9U, Seg4.getDeferredBody().size());
+  EXPECT_TRUE(Seg4.loadBody(Seg4.getDeferredBody()));
+  EXPECT_TRUE(Seg4.isLoaded());
+  EXPECT_EQ(2U, Seg4.getLocals().size());
+  EXPECT_EQ(3U, Seg4.getInstrs().size());
+  auto &Seg4Trailing = *Sec4.getContent()[5000];
+  auto Res4 = Seg4Trailing.loadBody(Seg4Trailing.getDeferredBody());
+  ASSERT_FALSE(Res4);
+  EXPECT_EQ(SSVM::ErrCode::InvalidGrammar, Res4.error());
+}
+
 TEST(SectionTest, LoadDataSection) {
-  /// 12. Test load data section.
+  /// 13. Test load data section.
   ///
   ///   1.  Load invalid empty section.
   ///   2.  Load data section without contents.
@@ -506,17 +591,20 @@ TEST(SectionTest, LoadDataSection) {
 
   Mgr.clearBuffer();
   std::vector<unsigned char> Vec4 = {
-      0xABU, 0x80U, 0x80U, 0x80U, 0x00U, /// Content size = 43
+      0xAEU, 0x80U, 0x80U, 0x80U, 0x00U, /// Content size = 46
       0x03U,                             /// Vector length = 3
       /// vec[0]
+      0x02U,                             /// Flags
       0xFFU, 0xFFU, 0xFFU, 0xFFU, 0x0FU, /// Memory index
       0x45U, 0x46U, 0x47U, 0x0BU,        /// Expression
       0x04U, 0x74U, 0x65U, 0x73U, 0x74U, /// Vector length = 4, "test"
       /// vec[1]
+      0x02U,                             /// Flags
       0xF9U, 0xFFU, 0xFFU, 0xFFU, 0x0FU, /// Memory index
       0x45U, 0x46U, 0x47U, 0x0BU,        /// Expression
       0x04U, 0x74U, 0x65U, 0x73U, 0x74U, /// Vector length = 4, "test"
       /// vec[2]
+      0x02U,                             /// Flags
       0xF0U, 0xFFU, 0xFFU, 0xFFU, 0x0FU, /// Memory index
       0x45U, 0x46U, 0x47U, 0x0BU,        /// Expression
       0x04U, 0x74U, 0x65U, 0x73U, 0x74U  /// Vector length = 4, "test"
@@ -55,14 +55,19 @@ TEST(SegmentTest, LoadElementSegment) {
   ///   2.  Load element segment with expression of only End operation and empty
   ///       function indices list.
   ///   3.  Load element segment with expression and function indices list.
+  ///   4.  Load passive element segment with function indices list.
+  ///   5.  Load passive element segment with element expressions.
+  ///   6.  Load invalid element segment with unknown reference type.
   Mgr.clearBuffer();
   SSVM::AST::ElementSegment Seg1;
   EXPECT_FALSE(Seg1.loadBinary(Mgr));
 
   Mgr.clearBuffer();
   std::vector<unsigned char> Vec2 = {
+      0x02U,                             /// Flags
       0xFFU, 0xFFU, 0xFFU, 0xFFU, 0x0FU, /// Table index
       0x0BU,                             /// Expression
+      0x00U,                             /// Element kind
       0x00U                              /// Function indices list
   };
   Mgr.setCode(Vec2);
@@ -71,8 +76,10 @@ TEST(SegmentTest, LoadElementSegment) {
 
   Mgr.clearBuffer();
   std::vector<unsigned char> Vec3 = {
+      0x02U,                             /// Flags
       0xFFU, 0xFFU, 0xFFU, 0xFFU, 0x0FU, /// Table index
       0x45U, 0x46U, 0x47U, 0x0BU,        /// Expression
+      0x00U,                             /// Element kind
       0x03U,                             /// Vector length = 3
       0xFFU, 0xFFU, 0xFFU, 0xFFU, 0x0FU, /// vec[0]
       0x00U,                             /// vec[1]
@@ -81,6 +88,42 @@ TEST(SegmentTest, LoadElementSegment) {
   Mgr.setCode(Vec3);
   SSVM::AST::ElementSegment Seg3;
   EXPECT_TRUE(Seg3.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec4 = {
+      0x01U,              /// Flags
+      0x00U,              /// Element kind
+      0x02U, 0x01U, 0x02U /// Vector length = 2
+  };
+  Mgr.setCode(Vec4);
+  SSVM::AST::ElementSegment Seg4;
+  EXPECT_TRUE(Seg4.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+  EXPECT_EQ(Seg4.getMode(), SSVM::AST::SegmentMode::Passive);
+
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec5 = {
+      0x05U,               /// Flags
+      0x70U,               /// Reference type
+      0x02U,               /// Vector length = 2
+      0xD2U, 0x00U, 0x0BU, /// ref.func 0
+      0xD0U, 0x70U, 0x0BU  /// ref.null funcref
+  };
+  Mgr.setCode(Vec5);
+  SSVM::AST::ElementSegment Seg5;
+  EXPECT_TRUE(Seg5.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+  EXPECT_EQ(Seg5.getMode(), SSVM::AST::SegmentMode::Passive);
+  EXPECT_EQ(Seg5.getRefType(), SSVM::ElemType::FuncRef);
+  EXPECT_EQ(Seg5.getInitExprs().size(), 2U);
+
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec6 = {
+      0x05U, /// Flags
+      0x7FU, /// Unknown reference type
+      0x00U  /// Vector length = 0
+  };
+  Mgr.setCode(Vec6);
+  SSVM::AST::ElementSegment Seg6;
+  EXPECT_FALSE(Seg6.loadBinary(Mgr));
 }
 
 TEST(SegmentTest, LoadCodeSegment) {
@@ -135,12 +178,14 @@ TEST(SegmentTest, LoadDataSegment) {
   ///   2.  Load data segment of expression with only End operation and empty
   ///       initialization data.
   ///   3.  Load data segment with expression and initialization data.
+  ///   4.  Load passive data segment with initialization data.
   Mgr.clearBuffer();
   SSVM::AST::DataSegment Seg1;
   EXPECT_FALSE(Seg1.loadBinary(Mgr));
 
   Mgr.clearBuffer();
   std::vector<unsigned char> Vec2 = {
+      0x02U,                             /// Flags
       0xFFU, 0xFFU, 0xFFU, 0xFFU, 0x0FU, /// Memory index
       0x0BU,                             /// Expression
       0x00U                              /// Vector length = 0
@@ -151,6 +196,7 @@ TEST(SegmentTest, LoadDataSegment) {
 
   Mgr.clearBuffer();
   std::vector<unsigned char> Vec3 = {
+      0x02U,                             /// Flags
       0xFFU, 0xFFU, 0xFFU, 0xFFU, 0x0FU, /// Memory index
       0x45U, 0x46U, 0x47U, 0x0BU,        /// Expression
       0x04U, 0x74U, 0x65U, 0x73U, 0x74U  /// Vector length = 4, "test"
@@ -158,6 +204,17 @@ TEST(SegmentTest, LoadDataSegment) {
   Mgr.setCode(Vec3);
   SSVM::AST::DataSegment Seg3;
   EXPECT_TRUE(Seg3.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec4 = {
+      0x01U,                            /// Flags
+      0x04U, 0x74U, 0x65U, 0x73U, 0x74U /// Vector length = 4, "test"
+  };
+  Mgr.setCode(Vec4);
+  SSVM::AST::DataSegment Seg4;
+  EXPECT_TRUE(Seg4.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+  EXPECT_EQ(Seg4.getMode(), SSVM::AST::SegmentMode::Passive);
+  EXPECT_EQ(Seg4.getData().size(), 4U);
 }
 
 } // namespace
@@ -26,6 +26,7 @@ TEST(TypeTest, LoadLimit) {
   ///   3.  Load limit with only min.
   ///   4.  Load invalid limit with fail of loading max.
   ///   5.  Load limit with min and max.
+  ///   6.  Load shared limit with min and max.
   Mgr.clearBuffer();
   SSVM::AST::Limit Lim1;
   EXPECT_FALSE(Lim1.loadBinary(Mgr));
@@ -66,6 +67,17 @@ TEST(TypeTest, LoadLimit) {
   Mgr.setCode(Vec5);
   SSVM::AST::Limit Lim5;
   EXPECT_TRUE(Lim5.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec6 = {
+      0x03U, /// Shared with min and max
+      0x01U, /// Min = 1
+      0x02U  /// Max = 2
+  };
+  Mgr.setCode(Vec6);
+  SSVM::AST::Limit Lim6;
+  EXPECT_TRUE(Lim6.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+  EXPECT_TRUE(Lim6.isShared() && Lim6.hasMax() && Lim6.getMax() == 2);
 }
 
 TEST(TypeTest, LoadFunctionType) {
@@ -192,6 +204,7 @@ TEST(TypeTest, LoadTableType) {
   ///   4.  Load limit with only min.
   ///   5.  Load invalid limit with fail of loading max.
   ///   6.  Load limit with min and max.
+  ///   7.  Load externref table type.
   Mgr.clearBuffer();
   SSVM::AST::TableType Tab1;
   EXPECT_FALSE(Tab1.loadBinary(Mgr));
@@ -246,6 +259,17 @@ TEST(TypeTest, LoadTableType) {
   Mgr.setCode(Vec6);
   SSVM::AST::TableType Tab6;
   EXPECT_TRUE(Tab6.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec7 = {
+      0x6FU, /// Element type
+      0x00U, /// Only has min
+      0x02U  /// Min = 2
+  };
+  Mgr.setCode(Vec7);
+  SSVM::AST::TableType Tab7;
+  EXPECT_TRUE(Tab7.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+  EXPECT_EQ(SSVM::ElemType::ExternRef, Tab7.getElementType());
 }
 
 TEST(TypeTest, LoadGlobalType) {
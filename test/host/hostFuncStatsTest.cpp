@@ -0,0 +1,141 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/test/host/hostFuncStatsTest.cpp - Host function stats tests --===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of the call statistics of host functions.
+///
+//===----------------------------------------------------------------------===//
+
+#include "runtime/hostfunc.h"
+#include "support/log.h"
+#include "vm/configure.h"
+#include "vm/vm.h"
+#include "gtest/gtest.h"
+
+#include <sstream>
+#include <string>
+#include <string_view>
+
+namespace {
+
+using SSVM::Bytes;
+using SSVM::Runtime::HostFuncStats;
+
+/// The module exporting "f", which calls random_get twice on 16 bytes.
+Bytes makeModule() {
+  Bytes Module = {0x00, 0x61, 0x73, 0x6D, 0x01, 0x00, 0x00, 0x00};
+  auto AppendSection = [&Module](uint8_t Id, const Bytes &Content) {
+    Module.push_back(Id);
+    Module.push_back(static_cast<uint8_t>(Content.size()));
+    Module.insert(Module.end(), Content.begin(), Content.end());
+  };
+  auto AppendName = [](Bytes &Content, std::string_view Name) {
+    Content.push_back(static_cast<uint8_t>(Name.size()));
+    Content.insert(Content.end(), Name.begin(), Name.end());
+  };
+  AppendSection(0x01, {0x02, 0x60, 0x02, 0x7F, 0x7F, 0x01, 0x7F, 0x60, 0x00,
+                       0x00});
+  Bytes Import = {0x01};
+  AppendName(Import, "wasi_snapshot_preview1");
+  AppendName(Import, "random_get");
+  Import.insert(Import.end(), {0x00, 0x00});
+  AppendSection(0x02, Import);
+  AppendSection(0x03, {0x01, 0x01});
+  AppendSection(0x05, {0x01, 0x00, 0x01});
+  AppendSection(0x07, {0x01, 0x01, 'f', 0x00, 0x01});
+  AppendSection(0x0A, {0x01, 0x10, 0x00, 0x41, 0x00, 0x41, 0x10, 0x10, 0x00,
+                       0x1A, 0x41, 0x00, 0x41, 0x10, 0x10, 0x00, 0x1A, 0x0B});
+  return Module;
+}
+
+/// Find the statistics of the host function.
+const HostFuncStats *findStats(const SSVM::VM::VM &VM,
+                               std::string_view Name) {
+  for (const auto &[FuncName, Stats] : VM.getHostFuncStats()) {
+    if (FuncName == Name) {
+      return Stats;
+    }
+  }
+  return nullptr;
+}
+
+TEST(HostFuncStatsTest, Counters) {
+  HostFuncStats Stats;
+  /// The bytes are counted only when enabled.
+  Stats.addBytesIn(10);
+  Stats.addBytesOut(10);
+  EXPECT_EQ(0U, Stats.getBytesIn());
+  EXPECT_EQ(0U, Stats.getBytesOut());
+  Stats.setEnabled(true);
+  Stats.addBytesIn(10);
+  Stats.addBytesOut(20);
+  EXPECT_EQ(10U, Stats.getBytesIn());
+  EXPECT_EQ(20U, Stats.getBytesOut());
+
+  Stats.recordCall(0);
+  Stats.recordCall(1);
+  Stats.recordCall(1000);
+  Stats.recordCall(UINT64_C(1) << 50);
+  EXPECT_EQ(4U, Stats.getCalls());
+  EXPECT_EQ(1001U + (UINT64_C(1) << 50), Stats.getTotalTime());
+  EXPECT_EQ(1U, Stats.getHistogram(0));
+  EXPECT_EQ(1U, Stats.getHistogram(1));
+  EXPECT_EQ(1U, Stats.getHistogram(10));
+  EXPECT_EQ(1U, Stats.getHistogram(HostFuncStats::kHistogramSize - 1));
+  EXPECT_EQ(1024U, Stats.getPercentile(50));
+  EXPECT_EQ(UINT64_C(1) << (HostFuncStats::kHistogramSize - 1),
+            Stats.getPercentile(99));
+
+  Stats.reset();
+  EXPECT_EQ(0U, Stats.getCalls());
+  EXPECT_EQ(0U, Stats.getTotalTime());
+  EXPECT_EQ(0U, Stats.getBytesIn());
+  EXPECT_EQ(0U, Stats.getBytesOut());
+  EXPECT_EQ(0U, Stats.getHistogram(10));
+}
+
+TEST(HostFuncStatsTest, Disabled) {
+  SSVM::VM::Configure Conf;
+  Conf.addVMType(SSVM::VM::Configure::VMType::Wasi);
+  SSVM::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.runWasmFile(makeModule(), "f"));
+  const auto *Stats = findStats(VM, "wasi_snapshot_preview1.random_get");
+  ASSERT_NE(nullptr, Stats);
+  EXPECT_FALSE(Stats->isEnabled());
+  EXPECT_EQ(0U, Stats->getCalls());
+  EXPECT_EQ(0U, Stats->getBytesIn());
+}
+
+TEST(HostFuncStatsTest, Enabled) {
+  SSVM::VM::Configure Conf;
+  Conf.addVMType(SSVM::VM::Configure::VMType::Wasi);
+  Conf.setHostFuncStats(true);
+  SSVM::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.runWasmFile(makeModule(), "f"));
+  const auto *Stats = findStats(VM, "wasi_snapshot_preview1.random_get");
+  ASSERT_NE(nullptr, Stats);
+  EXPECT_EQ(2U, Stats->getCalls());
+  EXPECT_EQ(32U, Stats->getBytesIn());
+  EXPECT_EQ(0U, Stats->getBytesOut());
+  EXPECT_EQ(0U, findStats(VM, "wasi_snapshot_preview1.args_get")->getCalls());
+
+  /// The summary lists only the called functions.
+  std::ostringstream OS;
+  VM.dumpHostFuncStats(OS);
+  const std::string Summary = OS.str();
+  EXPECT_NE(std::string::npos,
+            Summary.find("wasi_snapshot_preview1.random_get"));
+  EXPECT_EQ(std::string::npos, Summary.find("args_get"));
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  SSVM::Log::setErrorLoggingLevel();
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,127 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/test/host/wasiClockTest.cpp - WASI clock unit tests ----------===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of the WASI clock_time_get host function in
+/// the live and the frozen clock modes.
+///
+//===----------------------------------------------------------------------===//
+
+#include "host/wasi/wasienv.h"
+#include "host/wasi/wasifunc.h"
+#include "host/wasi/wasimodule.h"
+#include "support/log.h"
+#include "vm/configure.h"
+#include "vm/vm.h"
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <thread>
+
+namespace {
+
+constexpr const uint32_t kTimePtr = 0;
+
+using SSVM::Host::WasiEnvironment;
+using SSVM::Runtime::Instance::MemoryInstance;
+
+/// Read the clock through clock_time_get.
+__wasi_timestamp_t getTime(SSVM::Host::WasiClockTimeGet &ClockTimeGet,
+                           MemoryInstance &MemInst,
+                           __wasi_clockid_t ClockId) {
+  auto Res = ClockTimeGet.body(MemInst, ClockId, 1, kTimePtr);
+  EXPECT_TRUE(Res);
+  EXPECT_EQ(__WASI_ESUCCESS, Res ? *Res : __WASI_EIO);
+  return *MemInst.getPointer<__wasi_timestamp_t *>(kTimePtr);
+}
+
+void sleep() { std::this_thread::sleep_for(std::chrono::milliseconds(2)); }
+
+TEST(WasiClockTest, Live) {
+  WasiEnvironment Env;
+  SSVM::Host::WasiClockTimeGet ClockTimeGet(Env);
+  MemoryInstance MemInst(SSVM::AST::Limit(1));
+  __wasi_timestamp_t Time;
+  EXPECT_FALSE(Env.getFrozenTime(__WASI_CLOCK_MONOTONIC, Time));
+
+  for (const auto ClockId : {__WASI_CLOCK_REALTIME, __WASI_CLOCK_MONOTONIC}) {
+    const auto Before = getTime(ClockTimeGet, MemInst, ClockId);
+    sleep();
+    EXPECT_GT(getTime(ClockTimeGet, MemInst, ClockId), Before);
+  }
+}
+
+TEST(WasiClockTest, Frozen) {
+  WasiEnvironment Env;
+  SSVM::Host::WasiClockTimeGet ClockTimeGet(Env);
+  MemoryInstance MemInst(SSVM::AST::Limit(1));
+  Env.setFrozenClock(true);
+
+  const auto Realtime = getTime(ClockTimeGet, MemInst, __WASI_CLOCK_REALTIME);
+  const auto Monotonic =
+      getTime(ClockTimeGet, MemInst, __WASI_CLOCK_MONOTONIC);
+  EXPECT_GT(Realtime, 0U);
+  EXPECT_GT(Monotonic, 0U);
+  sleep();
+  EXPECT_EQ(Realtime, getTime(ClockTimeGet, MemInst, __WASI_CLOCK_REALTIME));
+  EXPECT_EQ(Monotonic,
+            getTime(ClockTimeGet, MemInst, __WASI_CLOCK_MONOTONIC));
+
+  /// The times move on at the next invocation.
+  Env.freezeClocks();
+  EXPECT_GT(getTime(ClockTimeGet, MemInst, __WASI_CLOCK_REALTIME), Realtime);
+  EXPECT_GT(getTime(ClockTimeGet, MemInst, __WASI_CLOCK_MONOTONIC),
+            Monotonic);
+
+  /// The CPU time clocks stay live.
+  __wasi_timestamp_t Time;
+  EXPECT_FALSE(Env.getFrozenTime(__WASI_CLOCK_PROCESS_CPUTIME_ID, Time));
+
+  /// Thawed clocks are live again.
+  Env.setFrozenClock(false);
+  EXPECT_FALSE(Env.getFrozenTime(__WASI_CLOCK_MONOTONIC, Time));
+}
+
+TEST(WasiClockTest, Configure) {
+  /// The module exporting the empty function "f".
+  const SSVM::Bytes Module = {0x00, 0x61, 0x73, 0x6D, 0x01, 0x00, 0x00, 0x00,
+                              0x01, 0x04, 0x01, 0x60, 0x00, 0x00, 0x03, 0x02,
+                              0x01, 0x00, 0x07, 0x05, 0x01, 0x01, 'f',  0x00,
+                              0x00, 0x0A, 0x04, 0x01, 0x02, 0x00, 0x0B};
+  SSVM::VM::Configure Conf;
+  Conf.addVMType(SSVM::VM::Configure::VMType::Wasi);
+  __wasi_timestamp_t Time;
+  {
+    SSVM::VM::VM VM(Conf);
+    auto &Env = dynamic_cast<SSVM::Host::WasiModule *>(
+                    VM.getImportModule(SSVM::VM::Configure::VMType::Wasi))
+                    ->getEnv();
+    EXPECT_FALSE(Env.getFrozenTime(__WASI_CLOCK_MONOTONIC, Time));
+  }
+
+  Conf.setFrozenClock(true);
+  SSVM::VM::VM VM(Conf);
+  auto &Env = dynamic_cast<SSVM::Host::WasiModule *>(
+                  VM.getImportModule(SSVM::VM::Configure::VMType::Wasi))
+                  ->getEnv();
+  ASSERT_TRUE(Env.getFrozenTime(__WASI_CLOCK_MONOTONIC, Time));
+  const auto Created = Time;
+
+  /// Every invocation takes the time again.
+  sleep();
+  ASSERT_TRUE(VM.runWasmFile(Module, "f"));
+  ASSERT_TRUE(Env.getFrozenTime(__WASI_CLOCK_MONOTONIC, Time));
+  EXPECT_GT(Time, Created);
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  SSVM::Log::setErrorLoggingLevel();
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,289 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/test/host/wasiFdCopyTest.cpp - ssvm_io fd_copy unit tests ----===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of the fd_copy host function of the ssvm_io
+/// extension.
+///
+//===----------------------------------------------------------------------===//
+
+#include "host/wasi/vfs.h"
+#include "host/wasi/wasienv.h"
+#include "host/wasi/wasifunc.h"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fcntl.h>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr const uint32_t kNCopiedPtr = 0;
+
+constexpr const __wasi_rights_t kRights =
+    __WASI_RIGHT_FD_READ | __WASI_RIGHT_FD_WRITE;
+
+using SSVM::Host::WasiEnvironment;
+using SSVM::Runtime::Instance::MemoryInstance;
+
+/// Temporary host file with the content, removed when destroyed.
+class TempFile {
+public:
+  TempFile(std::string_view Content) {
+    char Template[] = "/tmp/ssvmFdCopyTest.XXXXXX";
+    Fd = mkstemp(Template);
+    EXPECT_GE(Fd, 0);
+    Path = Template;
+    EXPECT_EQ(static_cast<ssize_t>(Content.size()),
+              ::write(Fd, Content.data(), Content.size()));
+    lseek(Fd, 0, SEEK_SET);
+  }
+  ~TempFile() { unlink(Path.c_str()); }
+  /// Take the file descriptor, which is closed by the WASI environment.
+  int release(WasiEnvironment &Env, __wasi_rights_t Rights) {
+    Env.emplaceFile(Fd, Rights, 0, Path);
+    return Fd;
+  }
+  /// Take the file opened again with the flags, e.g. O_APPEND.
+  int reopen(WasiEnvironment &Env, __wasi_rights_t Rights, int Flags) {
+    close(Fd);
+    Fd = open(Path.c_str(), Flags);
+    EXPECT_GE(Fd, 0);
+    return release(Env, Rights);
+  }
+  std::string content() const {
+    std::string Data;
+    char Buf[256];
+    const int ReadFd = open(Path.c_str(), O_RDONLY);
+    ssize_t Size;
+    while ((Size = read(ReadFd, Buf, sizeof(Buf))) > 0) {
+      Data.append(Buf, Size);
+    }
+    close(ReadFd);
+    return Data;
+  }
+
+private:
+  int Fd;
+  std::string Path;
+};
+
+/// Virtual file which accepts Capacity bytes, and then fails with Error, or
+/// writes nothing if Error is ESUCCESS.
+class LimitedNode final : public SSVM::Host::VFSNode {
+public:
+  LimitedNode(uint64_t C, __wasi_errno_t E) : Capacity(C), Error(E) {}
+
+  __wasi_filetype_t getType() const noexcept override {
+    return __WASI_FILETYPE_REGULAR_FILE;
+  }
+  void stat(__wasi_filestat_t &Stat) const noexcept override {
+    Stat = __wasi_filestat_t{};
+    Stat.st_filetype = __WASI_FILETYPE_REGULAR_FILE;
+    Stat.st_size = Data.size();
+  }
+  __wasi_errno_t read(const iovec *, int, uint64_t,
+                      uint64_t &NRead) noexcept override {
+    NRead = 0;
+    return __WASI_ESUCCESS;
+  }
+  __wasi_errno_t write(const iovec *IOVS, int Count, uint64_t,
+                       uint64_t &NWritten) noexcept override {
+    NWritten = 0;
+    for (int I = 0; I < Count && Data.size() < Capacity; ++I) {
+      const auto *Base = static_cast<const char *>(IOVS[I].iov_base);
+      const size_t Size =
+          std::min<uint64_t>(IOVS[I].iov_len, Capacity - Data.size());
+      Data.append(Base, Size);
+      NWritten += Size;
+    }
+    return NWritten == 0 ? Error : __WASI_ESUCCESS;
+  }
+  __wasi_errno_t truncate(uint64_t) noexcept override { return __WASI_EINVAL; }
+  __wasi_errno_t lookup(std::string_view,
+                        std::shared_ptr<VFSNode> &) noexcept override {
+    return __WASI_ENOTDIR;
+  }
+  __wasi_errno_t create(std::string_view, __wasi_filetype_t,
+                        std::shared_ptr<VFSNode> &) noexcept override {
+    return __WASI_ENOTDIR;
+  }
+  __wasi_errno_t remove(std::string_view, bool) noexcept override {
+    return __WASI_ENOTDIR;
+  }
+  __wasi_errno_t rename(std::string_view, VFSNode &,
+                        std::string_view) noexcept override {
+    return __WASI_ENOTDIR;
+  }
+  __wasi_errno_t
+  list(std::vector<std::pair<std::string, std::shared_ptr<VFSNode>>> &)
+      noexcept override {
+    return __WASI_ENOTDIR;
+  }
+
+  std::string Data;
+
+private:
+  uint64_t Capacity;
+  __wasi_errno_t Error;
+};
+
+uint64_t getNCopied(MemoryInstance &MemInst) {
+  return *MemInst.getPointer<__wasi_filesize_t *>(kNCopiedPtr);
+}
+
+TEST(WasiFdCopyTest, Rights) {
+  WasiEnvironment Env;
+  SSVM::Host::WasiFdCopy FdCopy(Env);
+  MemoryInstance MemInst(SSVM::AST::Limit(1));
+  TempFile Src("data"), Dst("");
+  const int SrcFd = Src.release(Env, __WASI_RIGHT_FD_WRITE);
+  const int DstFd = Dst.release(Env, __WASI_RIGHT_FD_READ);
+  TempFile Other(""), Other2("");
+  const int RwFd = Other.release(Env, kRights);
+  const int RwFd2 = Other2.release(Env, kRights);
+
+  /// The source needs fd_read, and the destination needs fd_write.
+  auto Res = FdCopy.body(MemInst, SrcFd, RwFd, 4, kNCopiedPtr);
+  ASSERT_TRUE(Res);
+  EXPECT_EQ(__WASI_ENOTCAPABLE, *Res);
+  Res = FdCopy.body(MemInst, RwFd, DstFd, 4, kNCopiedPtr);
+  ASSERT_TRUE(Res);
+  EXPECT_EQ(__WASI_ENOTCAPABLE, *Res);
+
+  /// Both file descriptors must be opened.
+  Res = FdCopy.body(MemInst, 1000, RwFd, 4, kNCopiedPtr);
+  ASSERT_TRUE(Res);
+  EXPECT_EQ(__WASI_EBADF, *Res);
+  Res = FdCopy.body(MemInst, RwFd, 1000, 4, kNCopiedPtr);
+  ASSERT_TRUE(Res);
+  EXPECT_EQ(__WASI_EBADF, *Res);
+
+  /// The result pointer is checked.
+  Res = FdCopy.body(MemInst, RwFd, RwFd2, 4, 65536);
+  ASSERT_TRUE(Res);
+  EXPECT_EQ(__WASI_EFAULT, *Res);
+
+  /// Nothing is copied on the failures.
+  EXPECT_EQ("", Other.content());
+  EXPECT_EQ("", Other2.content());
+}
+
+TEST(WasiFdCopyTest, FileToFile) {
+  WasiEnvironment Env;
+  SSVM::Host::WasiFdCopy FdCopy(Env);
+  MemoryInstance MemInst(SSVM::AST::Limit(1));
+  TempFile Src("hello, world"), Dst("");
+  const int SrcFd = Src.release(Env, __WASI_RIGHT_FD_READ);
+  const int DstFd = Dst.release(Env, __WASI_RIGHT_FD_WRITE);
+
+  auto Res = FdCopy.body(MemInst, SrcFd, DstFd, 5, kNCopiedPtr);
+  ASSERT_TRUE(Res);
+  EXPECT_EQ(__WASI_ESUCCESS, *Res);
+  EXPECT_EQ(5U, getNCopied(MemInst));
+  EXPECT_EQ("hello", Dst.content());
+
+  /// The copy goes on from the current positions, and stops at the end.
+  Res = FdCopy.body(MemInst, SrcFd, DstFd, 100, kNCopiedPtr);
+  ASSERT_TRUE(Res);
+  EXPECT_EQ(__WASI_ESUCCESS, *Res);
+  EXPECT_EQ(7U, getNCopied(MemInst));
+  EXPECT_EQ("hello, world", Dst.content());
+
+  Res = FdCopy.body(MemInst, SrcFd, DstFd, 100, kNCopiedPtr);
+  ASSERT_TRUE(Res);
+  EXPECT_EQ(__WASI_ESUCCESS, *Res);
+  EXPECT_EQ(0U, getNCopied(MemInst));
+}
+
+TEST(WasiFdCopyTest, FileToPipe) {
+  WasiEnvironment Env;
+  SSVM::Host::WasiFdCopy FdCopy(Env);
+  MemoryInstance MemInst(SSVM::AST::Limit(1));
+  TempFile Src("piped");
+  const int SrcFd = Src.release(Env, __WASI_RIGHT_FD_READ);
+  int Fds[2];
+  ASSERT_EQ(0, pipe(Fds));
+  Env.emplaceFile(Fds[0], kRights, 0, "pipe.r");
+  Env.emplaceFile(Fds[1], kRights, 0, "pipe.w");
+
+  auto Res = FdCopy.body(MemInst, SrcFd, Fds[1], 100, kNCopiedPtr);
+  ASSERT_TRUE(Res);
+  EXPECT_EQ(__WASI_ESUCCESS, *Res);
+  EXPECT_EQ(5U, getNCopied(MemInst));
+  char Buf[5];
+  ASSERT_EQ(5, read(Fds[0], Buf, 5));
+  EXPECT_EQ("piped", std::string_view(Buf, 5));
+}
+
+TEST(WasiFdCopyTest, AppendDestination) {
+  WasiEnvironment Env;
+  SSVM::Host::WasiFdCopy FdCopy(Env);
+  MemoryInstance MemInst(SSVM::AST::Limit(1));
+  TempFile Src("tail"), Dst("head ");
+  const int SrcFd = Src.release(Env, __WASI_RIGHT_FD_READ);
+  const int DstFd =
+      Dst.reopen(Env, __WASI_RIGHT_FD_WRITE, O_WRONLY | O_APPEND);
+
+  /// The kernel copy refuses the append-only file, and the plain writes
+  /// take over.
+  auto Res = FdCopy.body(MemInst, SrcFd, DstFd, 100, kNCopiedPtr);
+  ASSERT_TRUE(Res);
+  EXPECT_EQ(__WASI_ESUCCESS, *Res);
+  EXPECT_EQ(4U, getNCopied(MemInst));
+  EXPECT_EQ("head tail", Dst.content());
+}
+
+TEST(WasiFdCopyTest, ShortWrite) {
+  WasiEnvironment Env;
+  SSVM::Host::WasiFdCopy FdCopy(Env);
+  MemoryInstance MemInst(SSVM::AST::Limit(1));
+  TempFile Src("0123456789");
+  const int SrcFd = Src.release(Env, __WASI_RIGHT_FD_READ);
+
+  /// The destination stops taking the data, and the copy reports the
+  /// written part. The rest is given back to the source.
+  auto Full = std::make_shared<LimitedNode>(4, __WASI_ESUCCESS);
+  const int FullFd = Env.openVirtual(Full, kRights, 0, "full");
+  ASSERT_GE(FullFd, 0);
+  auto Res = FdCopy.body(MemInst, SrcFd, FullFd, 100, kNCopiedPtr);
+  ASSERT_TRUE(Res);
+  EXPECT_EQ(__WASI_ESUCCESS, *Res);
+  EXPECT_EQ(4U, getNCopied(MemInst));
+  EXPECT_EQ("0123", Full->Data);
+  EXPECT_EQ(4, lseek(SrcFd, 0, SEEK_CUR));
+
+  /// The destination fails after a part.
+  auto Failing = std::make_shared<LimitedNode>(3, __WASI_ENOSPC);
+  const int FailingFd = Env.openVirtual(Failing, kRights, 0, "failing");
+  ASSERT_GE(FailingFd, 0);
+  Res = FdCopy.body(MemInst, SrcFd, FailingFd, 100, kNCopiedPtr);
+  ASSERT_TRUE(Res);
+  EXPECT_EQ(__WASI_ESUCCESS, *Res);
+  EXPECT_EQ(3U, getNCopied(MemInst));
+  EXPECT_EQ("456", Failing->Data);
+  EXPECT_EQ(7, lseek(SrcFd, 0, SEEK_CUR));
+
+  /// The error is returned when nothing is written.
+  Res = FdCopy.body(MemInst, SrcFd, FailingFd, 100, kNCopiedPtr);
+  ASSERT_TRUE(Res);
+  EXPECT_EQ(__WASI_ENOSPC, *Res);
+  EXPECT_EQ(7, lseek(SrcFd, 0, SEEK_CUR));
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
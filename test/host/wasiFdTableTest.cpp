@@ -0,0 +1,151 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/test/host/wasiFdTableTest.cpp - WASI file table unit tests ---===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of allocating, closing, and renumbering the
+/// file descriptors in the WASI file table.
+///
+//===----------------------------------------------------------------------===//
+
+#include "host/wasi/wasienv.h"
+#include "host/wasi/wasifunc.h"
+#include "gtest/gtest.h"
+
+#include <string_view>
+#include <unistd.h>
+
+namespace {
+
+constexpr const __wasi_rights_t kPipeRights =
+    __WASI_RIGHT_FD_READ | __WASI_RIGHT_FD_WRITE;
+
+SSVM::Runtime::Instance::MemoryInstance makeMemory() {
+  return SSVM::Runtime::Instance::MemoryInstance(SSVM::AST::Limit(1));
+}
+
+/// Open a pipe and register both ends.
+void openPipe(SSVM::Host::WasiEnvironment &Env, int Fds[2]) {
+  ASSERT_EQ(0, pipe(Fds));
+  Env.emplaceFile(Fds[0], kPipeRights, 0, "pipe.r");
+  Env.emplaceFile(Fds[1], kPipeRights, 0, "pipe.w");
+}
+
+TEST(WasiFdTableTest, Allocate) {
+  SSVM::Host::WasiEnvironment Env;
+  ASSERT_NE(nullptr, Env.getFile(STDIN_FILENO));
+  ASSERT_NE(nullptr, Env.getFile(STDOUT_FILENO));
+  ASSERT_NE(nullptr, Env.getFile(STDERR_FILENO));
+  EXPECT_EQ(nullptr, Env.getFile(1000));
+
+  int Fds[2];
+  openPipe(Env, Fds);
+  const auto Read = Env.getFile(Fds[0]);
+  const auto Write = Env.getFile(Fds[1]);
+  ASSERT_NE(nullptr, Read);
+  ASSERT_NE(nullptr, Write);
+  EXPECT_EQ(static_cast<__wasi_fd_t>(Fds[0]), Read->Fd);
+  EXPECT_EQ("pipe.r", Read->Path);
+  EXPECT_EQ(static_cast<__wasi_fd_t>(Fds[1]), Write->Fd);
+  EXPECT_EQ("pipe.w", Write->Path);
+
+  /// The entries stay the same while the table grows.
+  int More[2][2];
+  openPipe(Env, More[0]);
+  openPipe(Env, More[1]);
+  EXPECT_EQ(Read, Env.getFile(Fds[0]));
+  EXPECT_EQ(Write, Env.getFile(Fds[1]));
+
+  /// Virtual files take file descriptors from the same table.
+  const int32_t VirtualFd = Env.openVirtual(
+      SSVM::Host::MemoryImage().mount(), kPipeRights, 0, "virtual");
+  ASSERT_GE(VirtualFd, 0);
+  ASSERT_NE(nullptr, Env.getFile(VirtualFd));
+  EXPECT_TRUE(Env.getFile(VirtualFd)->isVirtual());
+}
+
+TEST(WasiFdTableTest, Close) {
+  SSVM::Host::WasiEnvironment Env;
+  SSVM::Host::WasiFdClose FdClose(Env);
+  auto MemInst = makeMemory();
+  int Fds[2];
+  openPipe(Env, Fds);
+
+  auto Res = FdClose.body(MemInst, Fds[0]);
+  ASSERT_TRUE(Res);
+  EXPECT_EQ(__WASI_ESUCCESS, *Res);
+  EXPECT_EQ(nullptr, Env.getFile(Fds[0]));
+  EXPECT_NE(nullptr, Env.getFile(Fds[1]));
+
+  Res = FdClose.body(MemInst, Fds[0]);
+  ASSERT_TRUE(Res);
+  EXPECT_EQ(__WASI_EBADF, *Res);
+  Res = FdClose.body(MemInst, 1000);
+  ASSERT_TRUE(Res);
+  EXPECT_EQ(__WASI_EBADF, *Res);
+
+  /// The freed slot is reused by the next file.
+  int Next[2];
+  openPipe(Env, Next);
+  EXPECT_EQ(Fds[0], Next[0]);
+  ASSERT_NE(nullptr, Env.getFile(Fds[0]));
+  EXPECT_EQ(static_cast<__wasi_fd_t>(Next[0]), Env.getFile(Fds[0])->Fd);
+
+  /// An entry still held, e.g. by another guest thread, outlives the close.
+  const auto Held = Env.getFile(Fds[1]);
+  Res = FdClose.body(MemInst, Fds[1]);
+  ASSERT_TRUE(Res);
+  EXPECT_EQ(__WASI_ESUCCESS, *Res);
+  EXPECT_EQ(nullptr, Env.getFile(Fds[1]));
+  EXPECT_EQ("pipe.w", Held->Path);
+}
+
+TEST(WasiFdTableTest, Renumber) {
+  SSVM::Host::WasiEnvironment Env;
+  SSVM::Host::WasiFdRenumber FdRenumber(Env);
+  auto MemInst = makeMemory();
+  int First[2], Second[2];
+  openPipe(Env, First);
+  openPipe(Env, Second);
+  const auto Entry = Env.getFile(First[1]);
+
+  /// Move the write end of the first pipe over the second one.
+  auto Res = FdRenumber.body(MemInst, First[1], Second[1]);
+  ASSERT_TRUE(Res);
+  EXPECT_EQ(__WASI_ESUCCESS, *Res);
+  EXPECT_EQ(nullptr, Env.getFile(First[1]));
+  ASSERT_EQ(Entry, Env.getFile(Second[1]));
+  EXPECT_EQ(static_cast<__wasi_fd_t>(Second[1]), Entry->Fd);
+  EXPECT_EQ("pipe.w", Entry->Path);
+
+  /// The renumbered descriptor writes into the first pipe.
+  ASSERT_EQ(3, write(Second[1], "abc", 3));
+  char Buf[3];
+  ASSERT_EQ(3, read(First[0], Buf, 3));
+  EXPECT_EQ(0, std::string_view(Buf, 3).compare("abc"));
+
+  /// The source and the target must be opened, and stdio never moves.
+  Res = FdRenumber.body(MemInst, First[1], Second[1]);
+  ASSERT_TRUE(Res);
+  EXPECT_EQ(__WASI_EBADF, *Res);
+  Res = FdRenumber.body(MemInst, Second[1], 1000);
+  ASSERT_TRUE(Res);
+  EXPECT_EQ(__WASI_EBADF, *Res);
+  Res = FdRenumber.body(MemInst, STDOUT_FILENO, Second[1]);
+  ASSERT_TRUE(Res);
+  EXPECT_EQ(__WASI_ENOTSUP, *Res);
+  Res = FdRenumber.body(MemInst, Second[1], Second[1]);
+  ASSERT_TRUE(Res);
+  EXPECT_EQ(__WASI_ESUCCESS, *Res);
+  EXPECT_EQ(Entry, Env.getFile(Second[1]));
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,189 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/test/host/wasiPollTest.cpp - WASI poll_oneoff unit tests -----===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of the WASI poll_oneoff host function.
+///
+//===----------------------------------------------------------------------===//
+
+#include "host/wasi/wasienv.h"
+#include "host/wasi/wasifunc.h"
+#include "gtest/gtest.h"
+
+#include <cstring>
+#include <unistd.h>
+
+namespace {
+
+constexpr const uint32_t kSubPtr = 0;
+constexpr const uint32_t kEventPtr = 1024;
+constexpr const uint32_t kNEventsPtr = 2048;
+
+constexpr const __wasi_rights_t kPipeRights = __WASI_RIGHT_FD_READ |
+                                              __WASI_RIGHT_FD_WRITE |
+                                              __WASI_RIGHT_POLL_FD_READWRITE;
+
+SSVM::Runtime::Instance::MemoryInstance makeMemory() {
+  return SSVM::Runtime::Instance::MemoryInstance(SSVM::AST::Limit(1));
+}
+
+void setClock(SSVM::Runtime::Instance::MemoryInstance &MemInst, uint32_t Idx,
+              __wasi_userdata_t UserData, __wasi_timestamp_t Timeout) {
+  auto *Sub = MemInst.getPointer<__wasi_subscription_t *>(
+      kSubPtr + Idx * sizeof(__wasi_subscription_t));
+  *Sub = __wasi_subscription_t{};
+  Sub->userdata = UserData;
+  Sub->type = __WASI_EVENTTYPE_CLOCK;
+  Sub->u.clock.clock_id = __WASI_CLOCK_MONOTONIC;
+  Sub->u.clock.timeout = Timeout;
+}
+
+void setFd(SSVM::Runtime::Instance::MemoryInstance &MemInst, uint32_t Idx,
+           __wasi_userdata_t UserData, __wasi_eventtype_t Type,
+           __wasi_fd_t Fd) {
+  auto *Sub = MemInst.getPointer<__wasi_subscription_t *>(
+      kSubPtr + Idx * sizeof(__wasi_subscription_t));
+  *Sub = __wasi_subscription_t{};
+  Sub->userdata = UserData;
+  Sub->type = Type;
+  Sub->u.fd_readwrite.fd = Fd;
+}
+
+const __wasi_event_t &getEvent(SSVM::Runtime::Instance::MemoryInstance &MemInst,
+                               uint32_t Idx) {
+  return *MemInst.getPointer<__wasi_event_t *>(
+      kEventPtr + Idx * sizeof(__wasi_event_t));
+}
+
+uint32_t getNEvents(SSVM::Runtime::Instance::MemoryInstance &MemInst) {
+  return *MemInst.getPointer<uint32_t *>(kNEventsPtr);
+}
+
+/// Find the event of the user data, or null if not reported.
+const __wasi_event_t *
+findEvent(SSVM::Runtime::Instance::MemoryInstance &MemInst,
+          __wasi_userdata_t UserData) {
+  for (uint32_t I = 0; I < getNEvents(MemInst); ++I) {
+    if (getEvent(MemInst, I).userdata == UserData) {
+      return &getEvent(MemInst, I);
+    }
+  }
+  return nullptr;
+}
+
+TEST(WasiPollTest, ClockOnly) {
+  SSVM::Host::WasiEnvironment Env;
+  SSVM::Host::WasiPollOneoff PollOneoff(Env);
+  auto MemInst = makeMemory();
+  setClock(MemInst, 0, 1, 1000000);
+  setClock(MemInst, 1, 2, UINT64_C(60000000000));
+  auto Res = PollOneoff.body(MemInst, kSubPtr, kEventPtr, 2, kNEventsPtr);
+  ASSERT_TRUE(Res);
+  EXPECT_EQ(__WASI_ESUCCESS, *Res);
+  ASSERT_EQ(1U, getNEvents(MemInst));
+  EXPECT_EQ(1U, getEvent(MemInst, 0).userdata);
+  EXPECT_EQ(__WASI_EVENTTYPE_CLOCK, getEvent(MemInst, 0).type);
+}
+
+TEST(WasiPollTest, MixedClockAndFd) {
+  SSVM::Host::WasiEnvironment Env;
+  SSVM::Host::WasiPollOneoff PollOneoff(Env);
+  auto MemInst = makeMemory();
+  int Fds[2];
+  ASSERT_EQ(0, pipe(Fds));
+  Env.emplaceFile(Fds[0], kPipeRights, 0, "pipe");
+  Env.emplaceFile(Fds[1], kPipeRights, 0, "pipe");
+
+  /// Nothing to read, so only the clock fires.
+  setFd(MemInst, 0, 1, __WASI_EVENTTYPE_FD_READ, Fds[0]);
+  setClock(MemInst, 1, 2, 1000000);
+  auto Res = PollOneoff.body(MemInst, kSubPtr, kEventPtr, 2, kNEventsPtr);
+  ASSERT_TRUE(Res);
+  EXPECT_EQ(__WASI_ESUCCESS, *Res);
+  ASSERT_EQ(1U, getNEvents(MemInst));
+  EXPECT_EQ(2U, getEvent(MemInst, 0).userdata);
+
+  /// The readable pipe is reported without waiting for the clock.
+  ASSERT_EQ(3, write(Fds[1], "abc", 3));
+  setClock(MemInst, 1, 2, UINT64_C(60000000000));
+  setFd(MemInst, 2, 3, __WASI_EVENTTYPE_FD_WRITE, Fds[1]);
+  Res = PollOneoff.body(MemInst, kSubPtr, kEventPtr, 3, kNEventsPtr);
+  ASSERT_TRUE(Res);
+  EXPECT_EQ(__WASI_ESUCCESS, *Res);
+  EXPECT_EQ(2U, getNEvents(MemInst));
+  const __wasi_event_t *Read = findEvent(MemInst, 1);
+  ASSERT_NE(nullptr, Read);
+  EXPECT_EQ(__WASI_ESUCCESS, Read->error);
+  EXPECT_EQ(__WASI_EVENTTYPE_FD_READ, Read->type);
+  EXPECT_EQ(3U, Read->u.fd_readwrite.nbytes);
+  const __wasi_event_t *Write = findEvent(MemInst, 3);
+  ASSERT_NE(nullptr, Write);
+  EXPECT_EQ(__WASI_EVENTTYPE_FD_WRITE, Write->type);
+  EXPECT_EQ(nullptr, findEvent(MemInst, 2));
+
+  Env.eraseFile(Fds[0]);
+  Env.eraseFile(Fds[1]);
+  close(Fds[0]);
+  close(Fds[1]);
+}
+
+TEST(WasiPollTest, BadFd) {
+  SSVM::Host::WasiEnvironment Env;
+  SSVM::Host::WasiPollOneoff PollOneoff(Env);
+  auto MemInst = makeMemory();
+  setFd(MemInst, 0, 1, __WASI_EVENTTYPE_FD_READ, 1000);
+  setClock(MemInst, 1, 2, UINT64_C(60000000000));
+  auto Res = PollOneoff.body(MemInst, kSubPtr, kEventPtr, 2, kNEventsPtr);
+  ASSERT_TRUE(Res);
+  ASSERT_EQ(1U, getNEvents(MemInst));
+  EXPECT_EQ(1U, getEvent(MemInst, 0).userdata);
+  EXPECT_EQ(__WASI_EBADF, getEvent(MemInst, 0).error);
+}
+
+/// A hangup makes the fd both readable and writable. The subscription which
+/// failed on the same fd must not be reported again, or the events overflow
+/// the output array.
+TEST(WasiPollTest, RecordOnce) {
+  SSVM::Host::WasiEnvironment Env;
+  SSVM::Host::WasiPollOneoff PollOneoff(Env);
+  auto MemInst = makeMemory();
+  int Fds[2];
+  ASSERT_EQ(0, pipe(Fds));
+  close(Fds[1]);
+  Env.emplaceFile(Fds[0],
+                  __WASI_RIGHT_FD_WRITE | __WASI_RIGHT_POLL_FD_READWRITE, 0,
+                  "pipe");
+  /// The guard event right after the output array must stay untouched.
+  auto *Guard = MemInst.getPointer<__wasi_event_t *>(
+      kEventPtr + 2 * sizeof(__wasi_event_t));
+  std::memset(Guard, 0xA5, sizeof(*Guard));
+  const __wasi_event_t Expected = *Guard;
+
+  setFd(MemInst, 0, 1, __WASI_EVENTTYPE_FD_READ, Fds[0]);
+  setFd(MemInst, 1, 2, __WASI_EVENTTYPE_FD_WRITE, Fds[0]);
+  auto Res = PollOneoff.body(MemInst, kSubPtr, kEventPtr, 2, kNEventsPtr);
+  ASSERT_TRUE(Res);
+  EXPECT_EQ(__WASI_ESUCCESS, *Res);
+  ASSERT_EQ(2U, getNEvents(MemInst));
+  const __wasi_event_t *Read = findEvent(MemInst, 1);
+  ASSERT_NE(nullptr, Read);
+  EXPECT_EQ(__WASI_ENOTCAPABLE, Read->error);
+  const __wasi_event_t *Write = findEvent(MemInst, 2);
+  ASSERT_NE(nullptr, Write);
+  EXPECT_EQ(__WASI_ESUCCESS, Write->error);
+  EXPECT_EQ(0, std::memcmp(&Expected, Guard, sizeof(Expected)));
+
+  Env.eraseFile(Fds[0]);
+  close(Fds[0]);
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
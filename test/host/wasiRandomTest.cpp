@@ -0,0 +1,89 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/test/host/wasiRandomTest.cpp - WASI random unit tests --------===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of the ChaCha20 generator of the WASI
+/// random_get host function.
+///
+//===----------------------------------------------------------------------===//
+
+#include "host/wasi/random.h"
+#include "host/wasi/wasimodule.h"
+#include "support/log.h"
+#include "vm/configure.h"
+#include "vm/vm.h"
+#include "gtest/gtest.h"
+
+#include <array>
+#include <cstdint>
+
+namespace {
+
+using SSVM::Host::RandomGenerator;
+
+TEST(WasiRandomTest, BlockKnownAnswer) {
+  /// The test vector of RFC 7539 section 2.3.2. Its block counter 1 and the
+  /// nonce 00:00:00:09:00:00:00:4a:00:00:00:00 are the state words 12 to 15,
+  /// which are the 64-bit counter 0x0900000000000001 and the 64-bit nonce
+  /// 0x4a000000 here.
+  std::array<uint32_t, 8> Key;
+  for (uint32_t I = 0; I < 8; ++I) {
+    Key[I] = (I * 4) | (I * 4 + 1) << 8 | (I * 4 + 2) << 16 |
+             (I * 4 + 3) << 24;
+  }
+  std::array<uint8_t, 64> Block;
+  RandomGenerator::block(Key, 0x0900000000000001ULL, 0x4a000000ULL,
+                         Block.data());
+  const std::array<uint8_t, 64> Expected = {
+      0x10, 0xf1, 0xe7, 0xe4, 0xd1, 0x3b, 0x59, 0x15, 0x50, 0x0f, 0xdd,
+      0x1f, 0xa3, 0x20, 0x71, 0xc4, 0xc7, 0xd1, 0xf4, 0xc7, 0x33, 0xc0,
+      0x68, 0x03, 0x04, 0x22, 0xaa, 0x9a, 0xc3, 0xd4, 0x6c, 0x4e, 0xd2,
+      0x82, 0x64, 0x46, 0x07, 0x9f, 0xaa, 0x09, 0x14, 0xc2, 0xd7, 0x05,
+      0xd9, 0x8b, 0x02, 0xa2, 0xb5, 0x12, 0x9c, 0xd1, 0xde, 0x16, 0x4e,
+      0xb9, 0xcb, 0xd0, 0x83, 0xe8, 0xa2, 0x50, 0x3c, 0x4e};
+  EXPECT_EQ(Expected, Block);
+}
+
+TEST(WasiRandomTest, Generate) {
+  RandomGenerator Random;
+  std::array<uint8_t, 100> First = {}, Second = {};
+  ASSERT_TRUE(Random.generate(First.data(), First.size()));
+  ASSERT_TRUE(Random.generate(Second.data(), Second.size()));
+  EXPECT_NE(First, Second);
+
+  /// Reseeding at every request keeps producing the output.
+  Random.setReseedInterval(0);
+  ASSERT_TRUE(Random.generate(First.data(), First.size()));
+  EXPECT_NE(First, Second);
+}
+
+TEST(WasiRandomTest, Configure) {
+  auto GetRandom = [](SSVM::VM::VM &VM) -> RandomGenerator & {
+    return dynamic_cast<SSVM::Host::WasiModule *>(
+               VM.getImportModule(SSVM::VM::Configure::VMType::Wasi))
+        ->getEnv()
+        .getRandom();
+  };
+  SSVM::VM::Configure Conf;
+  Conf.addVMType(SSVM::VM::Configure::VMType::Wasi);
+  {
+    SSVM::VM::VM VM(Conf);
+    EXPECT_EQ(RandomGenerator::kDefaultReseedInterval,
+              GetRandom(VM).getReseedInterval());
+  }
+  Conf.setRandomReseedInterval(0);
+  SSVM::VM::VM VM(Conf);
+  EXPECT_EQ(0U, GetRandom(VM).getReseedInterval());
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  SSVM::Log::setErrorLoggingLevel();
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
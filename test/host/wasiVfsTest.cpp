@@ -0,0 +1,274 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/test/host/wasiVfsTest.cpp - WASI in-memory filesystem tests --===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of the WASI functions on the in-memory
+/// preopened directories.
+///
+//===----------------------------------------------------------------------===//
+
+#include "host/wasi/vfs.h"
+#include "host/wasi/wasienv.h"
+#include "host/wasi/wasifunc.h"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+constexpr const uint32_t kPathPtr = 0;
+constexpr const uint32_t kNewPathPtr = 256;
+constexpr const uint32_t kIOVSPtr = 512;
+constexpr const uint32_t kFdPtr = 520;
+constexpr const uint32_t kSizePtr = 524;
+constexpr const uint32_t kDataPtr = 1024;
+constexpr const uint32_t kDataLen = 1024;
+constexpr const uint32_t kDirPtr = 4096;
+constexpr const uint32_t kDirLen = 1024;
+
+constexpr const __wasi_rights_t kRights =
+    __WASI_RIGHT_FD_READ | __WASI_RIGHT_FD_WRITE | __WASI_RIGHT_FD_READDIR |
+    __WASI_RIGHT_FD_SEEK | __WASI_RIGHT_FD_TELL;
+
+using SSVM::Runtime::Instance::MemoryInstance;
+
+/// Image of "a.txt" and an empty directory "sub".
+std::shared_ptr<const SSVM::Host::MemoryImage> makeImage() {
+  auto Image = std::make_shared<SSVM::Host::MemoryImage>();
+  const std::string_view Content = "hello";
+  EXPECT_TRUE(
+      Image->addFile("a.txt", std::vector<uint8_t>(Content.begin(),
+                                                   Content.end())));
+  EXPECT_TRUE(Image->addDirectory("sub"));
+  return Image;
+}
+
+/// Host functions on a WASI environment with the image preopened as /data.
+class Guest {
+public:
+  Guest(std::shared_ptr<const SSVM::Host::MemoryImage> Image)
+      : MemInst(SSVM::AST::Limit(1)), PathOpen(Env), FdClose(Env),
+        FdRead(Env), FdWrite(Env), FdReadDir(Env), PathCreateDirectory(Env),
+        PathRename(Env), PathUnlinkFile(Env) {
+    DirFd = Env.preopenVirtual("/data", Image->mount());
+    EXPECT_GE(DirFd, 0);
+  }
+
+  uint32_t open(std::string_view Path, uint32_t OFlags, int32_t &Fd) {
+    setPath(kPathPtr, Path);
+    auto Res = PathOpen.body(MemInst, DirFd, 0, kPathPtr, Path.size(), OFlags,
+                             kRights, kRights, 0, kFdPtr);
+    EXPECT_TRUE(Res);
+    Fd = *MemInst.getPointer<int32_t *>(kFdPtr);
+    return *Res;
+  }
+
+  std::string read(std::string_view Path) {
+    int32_t Fd;
+    if (open(Path, 0, Fd) != __WASI_ESUCCESS) {
+      return "<error>";
+    }
+    setIOVS(kDataLen);
+    auto Res = FdRead.body(MemInst, Fd, kIOVSPtr, 1, kSizePtr);
+    EXPECT_TRUE(Res);
+    EXPECT_EQ(__WASI_ESUCCESS, *Res);
+    const uint32_t Size = *MemInst.getPointer<uint32_t *>(kSizePtr);
+    const auto *Data = MemInst.getPointer<char *>(kDataPtr, Size);
+    close(Fd);
+    return std::string(Data, Size);
+  }
+
+  uint32_t write(std::string_view Path, std::string_view Content) {
+    int32_t Fd;
+    if (const uint32_t Err =
+            open(Path, __WASI_O_CREAT | __WASI_O_TRUNC, Fd);
+        Err != __WASI_ESUCCESS) {
+      return Err;
+    }
+    std::copy(Content.begin(), Content.end(),
+              MemInst.getPointer<char *>(kDataPtr, Content.size()));
+    setIOVS(Content.size());
+    auto Res = FdWrite.body(MemInst, Fd, kIOVSPtr, 1, kSizePtr);
+    EXPECT_TRUE(Res);
+    EXPECT_EQ(Content.size(), *MemInst.getPointer<uint32_t *>(kSizePtr));
+    close(Fd);
+    return *Res;
+  }
+
+  /// List the entry names of the directory, including "." and "..".
+  std::vector<std::string> list(std::string_view Path) {
+    int32_t Fd;
+    if (open(Path, __WASI_O_DIRECTORY, Fd) != __WASI_ESUCCESS) {
+      return {};
+    }
+    auto Res = FdReadDir.body(MemInst, Fd, kDirPtr, kDirLen, 0, kSizePtr);
+    EXPECT_TRUE(Res);
+    EXPECT_EQ(__WASI_ESUCCESS, *Res);
+    const uint32_t Size = *MemInst.getPointer<uint32_t *>(kSizePtr);
+    EXPECT_LT(Size, kDirLen);
+    std::vector<std::string> Names;
+    for (uint32_t Pos = 0; Pos < Size;) {
+      const auto &Dirent =
+          *MemInst.getPointer<__wasi_dirent_t *>(kDirPtr + Pos);
+      const auto *Name = MemInst.getPointer<char *>(
+          kDirPtr + Pos + sizeof(__wasi_dirent_t), Dirent.d_namlen);
+      Names.emplace_back(Name, Dirent.d_namlen);
+      Pos += sizeof(__wasi_dirent_t) + Dirent.d_namlen;
+    }
+    close(Fd);
+    return Names;
+  }
+
+  uint32_t mkdir(std::string_view Path) {
+    setPath(kPathPtr, Path);
+    auto Res = PathCreateDirectory.body(MemInst, DirFd, kPathPtr, Path.size());
+    EXPECT_TRUE(Res);
+    return *Res;
+  }
+
+  uint32_t rename(std::string_view OldPath, std::string_view NewPath) {
+    setPath(kPathPtr, OldPath);
+    setPath(kNewPathPtr, NewPath);
+    auto Res = PathRename.body(MemInst, DirFd, kPathPtr, OldPath.size(), DirFd,
+                               kNewPathPtr, NewPath.size());
+    EXPECT_TRUE(Res);
+    return *Res;
+  }
+
+  uint32_t unlink(std::string_view Path) {
+    setPath(kPathPtr, Path);
+    auto Res = PathUnlinkFile.body(MemInst, DirFd, kPathPtr, Path.size());
+    EXPECT_TRUE(Res);
+    return *Res;
+  }
+
+private:
+  void setPath(uint32_t Ptr, std::string_view Path) {
+    std::copy(Path.begin(), Path.end(),
+              MemInst.getPointer<char *>(Ptr, Path.size()));
+  }
+  void setIOVS(uint32_t Len) {
+    auto *IOVS = MemInst.getPointer<__wasi_iovec_t *>(kIOVSPtr);
+    IOVS->buf = kDataPtr;
+    IOVS->buf_len = Len;
+  }
+  void close(int32_t Fd) {
+    auto Res = FdClose.body(MemInst, Fd);
+    EXPECT_TRUE(Res);
+    EXPECT_EQ(__WASI_ESUCCESS, *Res);
+  }
+
+  SSVM::Host::WasiEnvironment Env;
+  MemoryInstance MemInst;
+  SSVM::Host::WasiPathOpen PathOpen;
+  SSVM::Host::WasiFdClose FdClose;
+  SSVM::Host::WasiFdRead FdRead;
+  SSVM::Host::WasiFdWrite FdWrite;
+  SSVM::Host::WasiFdReadDir FdReadDir;
+  SSVM::Host::WasiPathCreateDirectory PathCreateDirectory;
+  SSVM::Host::WasiPathRename PathRename;
+  SSVM::Host::WasiPathUnlinkFile PathUnlinkFile;
+  int32_t DirFd = -1;
+};
+
+TEST(WasiVfsTest, OpenReadWrite) {
+  Guest G(makeImage());
+  EXPECT_EQ("hello", G.read("a.txt"));
+  EXPECT_EQ("hello", G.read("sub/../a.txt"));
+
+  EXPECT_EQ(__WASI_ESUCCESS, G.write("b.txt", "abc"));
+  EXPECT_EQ("abc", G.read("b.txt"));
+  EXPECT_EQ(__WASI_ESUCCESS, G.write("sub/c.txt", "nested"));
+  EXPECT_EQ("nested", G.read("sub/c.txt"));
+
+  int32_t Fd;
+  EXPECT_EQ(__WASI_ENOENT, G.open("missing.txt", 0, Fd));
+  EXPECT_EQ(__WASI_ENOTCAPABLE, G.open("../a.txt", 0, Fd));
+  EXPECT_EQ(__WASI_ENOTCAPABLE, G.open("/a.txt", 0, Fd));
+  EXPECT_EQ(__WASI_ENOTDIR, G.open("a.txt", __WASI_O_DIRECTORY, Fd));
+  EXPECT_EQ(__WASI_EEXIST,
+            G.open("a.txt", __WASI_O_CREAT | __WASI_O_EXCL, Fd));
+}
+
+TEST(WasiVfsTest, ReadDir) {
+  Guest G(makeImage());
+  EXPECT_EQ((std::vector<std::string>{".", "..", "a.txt", "sub"}),
+            G.list("."));
+  EXPECT_EQ((std::vector<std::string>{".", ".."}), G.list("sub"));
+
+  EXPECT_EQ(__WASI_ESUCCESS, G.mkdir("sub/dir"));
+  EXPECT_EQ(__WASI_ESUCCESS, G.write("sub/b.txt", "b"));
+  EXPECT_EQ((std::vector<std::string>{".", "..", "b.txt", "dir"}),
+            G.list("sub"));
+}
+
+TEST(WasiVfsTest, CopyOnWrite) {
+  const auto Image = makeImage();
+  Guest G1(Image);
+  Guest G2(Image);
+
+  /// The writes of one mount are private to it.
+  EXPECT_EQ(__WASI_ESUCCESS, G1.write("a.txt", "changed"));
+  EXPECT_EQ(__WASI_ESUCCESS, G1.write("sub/new.txt", "new"));
+  EXPECT_EQ("changed", G1.read("a.txt"));
+  EXPECT_EQ("hello", G2.read("a.txt"));
+  EXPECT_EQ((std::vector<std::string>{".", ".."}), G2.list("sub"));
+
+  /// The image is never changed.
+  Guest G3(Image);
+  EXPECT_EQ("hello", G3.read("a.txt"));
+  EXPECT_EQ((std::vector<std::string>{".", "..", "a.txt", "sub"}),
+            G3.list("."));
+}
+
+TEST(WasiVfsTest, Rename) {
+  const auto Image = makeImage();
+  Guest G(Image);
+  EXPECT_EQ(__WASI_ESUCCESS, G.rename("a.txt", "sub/b.txt"));
+  int32_t Fd;
+  EXPECT_EQ(__WASI_ENOENT, G.open("a.txt", 0, Fd));
+  EXPECT_EQ("hello", G.read("sub/b.txt"));
+
+  /// A directory can not be moved into itself or its subtree.
+  EXPECT_EQ(__WASI_ESUCCESS, G.mkdir("sub/inner"));
+  EXPECT_EQ(__WASI_EINVAL, G.rename("sub", "sub/moved"));
+  EXPECT_EQ(__WASI_EINVAL, G.rename("sub", "sub/inner/moved"));
+  EXPECT_EQ("hello", G.read("sub/b.txt"));
+
+  EXPECT_EQ(__WASI_ESUCCESS, G.rename("sub", "dir"));
+  EXPECT_EQ("hello", G.read("dir/b.txt"));
+  EXPECT_EQ((std::vector<std::string>{".", "..", "dir"}), G.list("."));
+
+  /// Renaming in one mount is not seen by another.
+  Guest Other(Image);
+  EXPECT_EQ("hello", Other.read("a.txt"));
+}
+
+TEST(WasiVfsTest, Unlink) {
+  const auto Image = makeImage();
+  Guest G(Image);
+  EXPECT_EQ(__WASI_ESUCCESS, G.unlink("a.txt"));
+  int32_t Fd;
+  EXPECT_EQ(__WASI_ENOENT, G.open("a.txt", 0, Fd));
+  EXPECT_EQ(__WASI_ENOENT, G.unlink("a.txt"));
+  EXPECT_EQ(__WASI_EISDIR, G.unlink("sub"));
+  EXPECT_EQ((std::vector<std::string>{".", "..", "sub"}), G.list("."));
+
+  Guest Other(Image);
+  EXPECT_EQ("hello", Other.read("a.txt"));
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
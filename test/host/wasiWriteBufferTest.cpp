@@ -0,0 +1,218 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/test/host/wasiWriteBufferTest.cpp - WASI write buffer tests --===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of the write combining buffer of the WASI
+/// stdout and stderr.
+///
+//===----------------------------------------------------------------------===//
+
+#include "host/wasi/wasienv.h"
+#include "host/wasi/wasifunc.h"
+#include "host/wasi/wasimodule.h"
+#include "vm/configure.h"
+#include "vm/vm.h"
+#include "gtest/gtest.h"
+
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <string_view>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+constexpr const uint32_t kIOVSPtr = 0;
+constexpr const uint32_t kNWrittenPtr = 8;
+constexpr const uint32_t kDataPtr = 1024;
+
+using SSVM::Host::WasiEnvironment;
+using SSVM::Runtime::Instance::MemoryInstance;
+
+/// Redirect stdout and stderr into one pipe while alive.
+class CaptureStdio {
+public:
+  CaptureStdio() {
+    EXPECT_EQ(0, pipe(Fds));
+    fcntl(Fds[0], F_SETFL, O_NONBLOCK);
+    SavedOut = dup(STDOUT_FILENO);
+    SavedErr = dup(STDERR_FILENO);
+    dup2(Fds[1], STDOUT_FILENO);
+    dup2(Fds[1], STDERR_FILENO);
+  }
+  ~CaptureStdio() {
+    dup2(SavedOut, STDOUT_FILENO);
+    dup2(SavedErr, STDERR_FILENO);
+    close(SavedOut);
+    close(SavedErr);
+    close(Fds[0]);
+    close(Fds[1]);
+  }
+  /// Read the data written so far.
+  std::string drain() {
+    std::string Data;
+    char Buf[256];
+    ssize_t Size;
+    while ((Size = read(Fds[0], Buf, sizeof(Buf))) > 0) {
+      Data.append(Buf, Size);
+    }
+    return Data;
+  }
+
+private:
+  int Fds[2];
+  int SavedOut;
+  int SavedErr;
+};
+
+/// Call fd_write with the data in one iovec.
+uint32_t write(SSVM::Host::WasiFdWrite &FdWrite, MemoryInstance &MemInst,
+               int32_t Fd, std::string_view Data) {
+  std::memcpy(MemInst.getPointer<char *>(kDataPtr, Data.size()), Data.data(),
+              Data.size());
+  auto *IOVS = MemInst.getPointer<__wasi_iovec_t *>(kIOVSPtr);
+  IOVS->buf = kDataPtr;
+  IOVS->buf_len = Data.size();
+  auto Res = FdWrite.body(MemInst, Fd, kIOVSPtr, 1, kNWrittenPtr);
+  EXPECT_TRUE(Res);
+  EXPECT_EQ(Data.size(), *MemInst.getPointer<uint32_t *>(kNWrittenPtr));
+  return Res ? *Res : __WASI_EIO;
+}
+
+TEST(WasiWriteBufferTest, StdioOrder) {
+  WasiEnvironment Env;
+  SSVM::Host::WasiFdWrite FdWrite(Env);
+  MemoryInstance MemInst(SSVM::AST::Limit(1));
+  Env.setWriteBuffer(WasiEnvironment::WriteBufferMode::Full);
+  ASSERT_TRUE(Env.isWriteBuffered(STDOUT_FILENO));
+  ASSERT_TRUE(Env.isWriteBuffered(STDERR_FILENO));
+
+  std::vector<uint32_t> Errs;
+  std::vector<std::string> Outputs;
+  {
+    CaptureStdio Capture;
+    /// Switching the stream writes out the pending data of the other one.
+    Errs.push_back(write(FdWrite, MemInst, STDOUT_FILENO, "out1 "));
+    Outputs.push_back(Capture.drain());
+    Errs.push_back(write(FdWrite, MemInst, STDERR_FILENO, "err "));
+    Outputs.push_back(Capture.drain());
+    Errs.push_back(write(FdWrite, MemInst, STDOUT_FILENO, "out2"));
+    Outputs.push_back(Capture.drain());
+    Env.flushWriteBuffer();
+    Outputs.push_back(Capture.drain());
+  }
+  EXPECT_EQ(std::vector<uint32_t>(3, __WASI_ESUCCESS), Errs);
+  EXPECT_EQ((std::vector<std::string>{"", "out1 ", "err ", "out2"}), Outputs);
+}
+
+TEST(WasiWriteBufferTest, LineMode) {
+  WasiEnvironment Env;
+  SSVM::Host::WasiFdWrite FdWrite(Env);
+  MemoryInstance MemInst(SSVM::AST::Limit(1));
+  Env.setWriteBuffer(WasiEnvironment::WriteBufferMode::Line);
+
+  std::vector<std::string> Outputs;
+  {
+    CaptureStdio Capture;
+    write(FdWrite, MemInst, STDOUT_FILENO, "ab");
+    Outputs.push_back(Capture.drain());
+    write(FdWrite, MemInst, STDOUT_FILENO, "c\nd");
+    Outputs.push_back(Capture.drain());
+    Env.flushWriteBuffer();
+    Outputs.push_back(Capture.drain());
+  }
+  EXPECT_EQ((std::vector<std::string>{"", "abc\nd", ""}), Outputs);
+}
+
+TEST(WasiWriteBufferTest, Capacity) {
+  WasiEnvironment Env;
+  SSVM::Host::WasiFdWrite FdWrite(Env);
+  MemoryInstance MemInst(SSVM::AST::Limit(1));
+  Env.setWriteBuffer(WasiEnvironment::WriteBufferMode::Full, 8);
+
+  std::vector<std::string> Outputs;
+  {
+    CaptureStdio Capture;
+    write(FdWrite, MemInst, STDOUT_FILENO, "12345");
+    Outputs.push_back(Capture.drain());
+    /// The data over the capacity writes out the pending data first.
+    write(FdWrite, MemInst, STDOUT_FILENO, "6789");
+    Outputs.push_back(Capture.drain());
+    /// The writes larger than the buffer go through directly.
+    write(FdWrite, MemInst, STDOUT_FILENO, "abcdefghij");
+    Outputs.push_back(Capture.drain());
+  }
+  EXPECT_EQ((std::vector<std::string>{"", "12345", "6789abcdefghij"}),
+            Outputs);
+}
+
+TEST(WasiWriteBufferTest, FlushOnSync) {
+  WasiEnvironment Env;
+  SSVM::Host::WasiFdWrite FdWrite(Env);
+  SSVM::Host::WasiFdSync FdSync(Env);
+  MemoryInstance MemInst(SSVM::AST::Limit(1));
+  Env.setWriteBuffer(WasiEnvironment::WriteBufferMode::Full);
+
+  std::vector<std::string> Outputs;
+  {
+    CaptureStdio Capture;
+    write(FdWrite, MemInst, STDERR_FILENO, "pending");
+    Outputs.push_back(Capture.drain());
+    /// The result of syncing a pipe does not matter here.
+    EXPECT_TRUE(FdSync.body(MemInst, STDERR_FILENO));
+    Outputs.push_back(Capture.drain());
+  }
+  EXPECT_EQ((std::vector<std::string>{"", "pending"}), Outputs);
+}
+
+TEST(WasiWriteBufferTest, FlushOnExit) {
+  WasiEnvironment Env;
+  SSVM::Host::WasiFdWrite FdWrite(Env);
+  SSVM::Host::WasiProcExit ProcExit(Env);
+  MemoryInstance MemInst(SSVM::AST::Limit(1));
+  Env.setWriteBuffer(WasiEnvironment::WriteBufferMode::Full);
+
+  std::vector<std::string> Outputs;
+  {
+    CaptureStdio Capture;
+    write(FdWrite, MemInst, STDOUT_FILENO, "bye");
+    Outputs.push_back(Capture.drain());
+    EXPECT_FALSE(ProcExit.body(MemInst, 3));
+    Outputs.push_back(Capture.drain());
+  }
+  EXPECT_EQ((std::vector<std::string>{"", "bye"}), Outputs);
+  EXPECT_EQ(3, Env.getStatus());
+}
+
+TEST(WasiWriteBufferTest, Configure) {
+  auto GetEnv = [](SSVM::VM::VM &VM) -> WasiEnvironment & {
+    return dynamic_cast<SSVM::Host::WasiModule *>(
+               VM.getImportModule(SSVM::VM::Configure::VMType::Wasi))
+        ->getEnv();
+  };
+  SSVM::VM::Configure Conf;
+  Conf.addVMType(SSVM::VM::Configure::VMType::Wasi);
+  {
+    SSVM::VM::VM VM(Conf);
+    EXPECT_FALSE(GetEnv(VM).isWriteBuffered(STDOUT_FILENO));
+  }
+  Conf.setWriteBuffer(SSVM::VM::Configure::WriteBufferMode::Line);
+  {
+    SSVM::VM::VM VM(Conf);
+    EXPECT_TRUE(GetEnv(VM).isWriteBuffered(STDOUT_FILENO));
+    EXPECT_TRUE(GetEnv(VM).isWriteBuffered(STDERR_FILENO));
+    EXPECT_FALSE(GetEnv(VM).isWriteBuffered(STDERR_FILENO + 1));
+  }
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,222 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/test/interpreter/atomicTest.cpp - Atomics execution tests ----===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of executing the atomic instructions on the
+/// shared memory: the read-modify-write operations, and the wait and notify
+/// between the guest threads.
+///
+//===----------------------------------------------------------------------===//
+
+#include "common/value.h"
+#include "support/log.h"
+#include "vm/configure.h"
+#include "vm/vm.h"
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using SSVM::Bytes;
+
+void appendULEB(Bytes &Out, uint32_t Value) {
+  do {
+    uint8_t Byte = Value & 0x7F;
+    Value >>= 7;
+    if (Value != 0) {
+      Byte |= 0x80;
+    }
+    Out.push_back(Byte);
+  } while (Value != 0);
+}
+
+void appendSection(Bytes &Module, uint8_t Id, const Bytes &Content) {
+  Module.push_back(Id);
+  appendULEB(Module, Content.size());
+  Module.insert(Module.end(), Content.begin(), Content.end());
+}
+
+/// Module of a shared memory of 1 to 4 pages, and the functions:
+///   add, sub, and, or, xor, xchg, add8(a, v) -> i32: i32.atomic.rmw.* and
+///   i32.atomic.rmw8.add_u, which return the old value.
+///   cmpxchg(a, e, r) -> i32: i32.atomic.rmw.cmpxchg.
+///   load(a) -> i32, store(a, v): i32.atomic.load and i32.atomic.store.
+///   wait(a, e, t) -> i32: memory.atomic.wait32 with the timeout in ns.
+///   notify(a, n) -> i32: memory.atomic.notify.
+///   grow(n) -> i32: memory.grow.
+///   waiter(a): wait on a for 0 without timeout, and store the result at
+///   a + 4.
+///   notifier(a): grow the memory by 1 page, and notify a until a waiter is
+///   woken.
+Bytes makeModule() {
+  auto RMW = [](uint8_t Op, uint8_t Align) -> Bytes {
+    return {0x20, 0x00, 0x20, 0x01, 0xFE, Op, Align, 0x00};
+  };
+  const std::vector<std::pair<std::string_view, Bytes>> Funcs = {
+      {"add", RMW(0x1E, 0x02)},
+      {"sub", RMW(0x25, 0x02)},
+      {"and", RMW(0x2C, 0x02)},
+      {"or", RMW(0x33, 0x02)},
+      {"xor", RMW(0x3A, 0x02)},
+      {"xchg", RMW(0x41, 0x02)},
+      {"add8", RMW(0x20, 0x00)},
+      {"cmpxchg",
+       {0x20, 0x00, 0x20, 0x01, 0x20, 0x02, 0xFE, 0x48, 0x02, 0x00}},
+      {"load", {0x20, 0x00, 0xFE, 0x10, 0x02, 0x00}},
+      {"store", {0x20, 0x00, 0x20, 0x01, 0xFE, 0x17, 0x02, 0x00}},
+      {"wait",
+       {0x20, 0x00, 0x20, 0x01, 0x20, 0x02, 0xFE, 0x01, 0x02, 0x00}},
+      {"notify", RMW(0x00, 0x02)},
+      {"grow", {0x20, 0x00, 0x40, 0x00}},
+      {"waiter",
+       {0x20, 0x00, 0x20, 0x00, 0x41, 0x00, 0x42, 0x7F, 0xFE, 0x01, 0x02,
+        0x00, 0xFE, 0x17, 0x02, 0x04}},
+      {"notifier",
+       {0x41, 0x01, 0x40, 0x00, 0x1A, 0x03, 0x40, 0x20, 0x00, 0x41, 0x01,
+        0xFE, 0x00, 0x02, 0x00, 0x45, 0x0D, 0x00, 0x0B}}};
+  /// Types: (i32 i32) -> i32, (i32 i32 i32) -> i32, (i32) -> i32,
+  /// (i32 i32) -> (), (i32 i32 i64) -> i32, (i32) -> ().
+  const Bytes FuncTypes = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                           0x01, 0x02, 0x03, 0x04, 0x00, 0x02, 0x05, 0x05};
+
+  Bytes Module = {0x00, 0x61, 0x73, 0x6D, 0x01, 0x00, 0x00, 0x00};
+  appendSection(Module, 0x01,
+                {0x06, 0x60, 0x02, 0x7F, 0x7F, 0x01, 0x7F, 0x60, 0x03,
+                 0x7F, 0x7F, 0x7F, 0x01, 0x7F, 0x60, 0x01, 0x7F, 0x01,
+                 0x7F, 0x60, 0x02, 0x7F, 0x7F, 0x00, 0x60, 0x03, 0x7F,
+                 0x7F, 0x7E, 0x01, 0x7F, 0x60, 0x01, 0x7F, 0x00});
+  Bytes FuncSec = {static_cast<uint8_t>(FuncTypes.size())};
+  FuncSec.insert(FuncSec.end(), FuncTypes.begin(), FuncTypes.end());
+  appendSection(Module, 0x03, FuncSec);
+  appendSection(Module, 0x05, {0x01, 0x03, 0x01, 0x04});
+  Bytes ExportSec;
+  appendULEB(ExportSec, Funcs.size());
+  for (uint32_t I = 0; I < Funcs.size(); ++I) {
+    appendULEB(ExportSec, Funcs[I].first.size());
+    ExportSec.insert(ExportSec.end(), Funcs[I].first.begin(),
+                     Funcs[I].first.end());
+    ExportSec.push_back(0x00);
+    appendULEB(ExportSec, I);
+  }
+  appendSection(Module, 0x07, ExportSec);
+  Bytes CodeSec;
+  appendULEB(CodeSec, Funcs.size());
+  for (const auto &Func : Funcs) {
+    appendULEB(CodeSec, Func.second.size() + 2);
+    CodeSec.push_back(0x00);
+    CodeSec.insert(CodeSec.end(), Func.second.begin(), Func.second.end());
+    CodeSec.push_back(0x0B);
+  }
+  appendSection(Module, 0x0A, CodeSec);
+  return Module;
+}
+
+class AtomicTest : public testing::Test {
+protected:
+  void SetUp() override {
+    ASSERT_TRUE(VM.loadWasm(makeModule()));
+    ASSERT_TRUE(VM.validate());
+    ASSERT_TRUE(VM.instantiate());
+  }
+
+  /// Run the function, and get the i32 result or the error if trapped.
+  SSVM::Expect<uint32_t> run(const std::string &Func,
+                             std::vector<SSVM::ValVariant> Params) {
+    auto Res = VM.execute(Func, Params);
+    if (!Res) {
+      return SSVM::Unexpect(Res);
+    }
+    return Res->empty() ? 0U : SSVM::retrieveValue<uint32_t>(Res->front());
+  }
+
+  SSVM::VM::Configure Conf;
+  SSVM::VM::VM VM{Conf};
+};
+
+TEST_F(AtomicTest, ReadModifyWrite) {
+  ASSERT_TRUE(run("store", {0U, 10U}));
+  EXPECT_EQ(10U, *run("add", {0U, 5U}));
+  EXPECT_EQ(15U, *run("sub", {0U, 3U}));
+  EXPECT_EQ(12U, *run("and", {0U, 0xAU}));
+  EXPECT_EQ(8U, *run("or", {0U, 1U}));
+  EXPECT_EQ(9U, *run("xor", {0U, 0xFU}));
+  EXPECT_EQ(6U, *run("xchg", {0U, 100U}));
+  EXPECT_EQ(100U, *run("load", {0U}));
+
+  /// The exchange only happens on the expected value.
+  EXPECT_EQ(100U, *run("cmpxchg", {0U, 1U, 7U}));
+  EXPECT_EQ(100U, *run("load", {0U}));
+  EXPECT_EQ(100U, *run("cmpxchg", {0U, 100U, 7U}));
+  EXPECT_EQ(7U, *run("load", {0U}));
+
+  /// The operations wrap around, and the narrow ones keep the other bytes.
+  ASSERT_TRUE(run("store", {0U, 0xFFFFFFFFU}));
+  EXPECT_EQ(0xFFFFFFFFU, *run("add", {0U, 2U}));
+  EXPECT_EQ(1U, *run("load", {0U}));
+  ASSERT_TRUE(run("store", {4U, 0x1FFU}));
+  EXPECT_EQ(0xFFU, *run("add8", {4U, 1U}));
+  EXPECT_EQ(0x100U, *run("load", {4U}));
+
+  /// The address must be aligned and in bounds.
+  auto Res = run("add", {2U, 1U});
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(SSVM::ErrCode::UnalignedAtomicAccess, Res.error());
+  Res = run("add", {65536U, 1U});
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(SSVM::ErrCode::MemoryOutOfBounds, Res.error());
+}
+
+TEST_F(AtomicTest, WaitTimeout) {
+  /// Waiting for another value returns at once.
+  EXPECT_EQ(1U, *run("wait", {0U, 1U, uint64_t(-1)}));
+
+  /// Nobody notifies, so the wait times out after the timeout.
+  const auto Start = std::chrono::steady_clock::now();
+  EXPECT_EQ(2U, *run("wait", {0U, 0U, uint64_t(5000000)}));
+  EXPECT_GE(std::chrono::steady_clock::now() - Start,
+            std::chrono::milliseconds(5));
+  EXPECT_EQ(2U, *run("wait", {0U, 0U, uint64_t(0)}));
+
+  /// The timed out waiter is not woken by a later notify.
+  EXPECT_EQ(0U, *run("notify", {0U, 1U}));
+}
+
+TEST_F(AtomicTest, NotifyAcrossGrow) {
+  /// The executions join the spawned threads when done, so both the waiter
+  /// and the notifier run as the guest threads.
+  ASSERT_TRUE(run("store", {12U, 0xFFU}));
+  ASSERT_TRUE(VM.spawnThread("waiter", {8U}));
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  ASSERT_TRUE(VM.spawnThread("notifier", {8U}));
+  VM.joinThreads();
+  EXPECT_EQ(0U, *run("load", {12U}));
+  EXPECT_EQ(2U, *run("grow", {0U}));
+
+  /// A thread waits on the grown page.
+  constexpr uint32_t kAddress = 65536 + 16;
+  ASSERT_TRUE(run("store", {kAddress + 4, 0xFFU}));
+  ASSERT_TRUE(VM.spawnThread("waiter", {kAddress}));
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  ASSERT_TRUE(VM.spawnThread("notifier", {kAddress}));
+  VM.joinThreads();
+  EXPECT_EQ(0U, *run("load", {kAddress + 4}));
+  EXPECT_EQ(3U, *run("grow", {0U}));
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  SSVM::Log::setErrorLoggingLevel();
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
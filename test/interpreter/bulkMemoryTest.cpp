@@ -0,0 +1,233 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/test/interpreter/bulkMemoryTest.cpp - Bulk memory unit tests -===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of executing the bulk memory instructions:
+/// the overlapping copies, the bounds checks, and the dropped segments.
+///
+//===----------------------------------------------------------------------===//
+
+#include "common/value.h"
+#include "support/log.h"
+#include "vm/configure.h"
+#include "vm/vm.h"
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+using SSVM::Bytes;
+
+void appendULEB(Bytes &Out, uint32_t Value) {
+  do {
+    uint8_t Byte = Value & 0x7F;
+    Value >>= 7;
+    if (Value != 0) {
+      Byte |= 0x80;
+    }
+    Out.push_back(Byte);
+  } while (Value != 0);
+}
+
+void appendSection(Bytes &Module, uint8_t Id, const Bytes &Content) {
+  Module.push_back(Id);
+  appendULEB(Module, Content.size());
+  Module.insert(Module.end(), Content.begin(), Content.end());
+}
+
+/// Module of the functions:
+///   copy(d, s, n), fill(d, v, n): memory.copy and memory.fill.
+///   init(d, s, n), init_active(d, s, n): memory.init of the passive data
+///   segment "hello" and the active one "abcdefgh" at 0.
+///   drop(): data.drop of the passive data segment.
+///   load(a) -> i32: i32.load8_u.
+///   tinit(d, s, n), edrop(): table.init and elem.drop of the passive element
+///   segment of the functions one and two.
+///   call(i) -> i32: call_indirect of the table with type () -> i32.
+Bytes makeModule() {
+  const std::vector<std::pair<std::string_view, Bytes>> Funcs = {
+      {"copy", {0x20, 0x00, 0x20, 0x01, 0x20, 0x02, 0xFC, 0x0A, 0x00, 0x00}},
+      {"fill", {0x20, 0x00, 0x20, 0x01, 0x20, 0x02, 0xFC, 0x0B, 0x00}},
+      {"init", {0x20, 0x00, 0x20, 0x01, 0x20, 0x02, 0xFC, 0x08, 0x00, 0x00}},
+      {"init_active",
+       {0x20, 0x00, 0x20, 0x01, 0x20, 0x02, 0xFC, 0x08, 0x01, 0x00}},
+      {"drop", {0xFC, 0x09, 0x00}},
+      {"load", {0x20, 0x00, 0x2D, 0x00, 0x00}},
+      {"tinit", {0x20, 0x00, 0x20, 0x01, 0x20, 0x02, 0xFC, 0x0C, 0x00, 0x00}},
+      {"edrop", {0xFC, 0x0D, 0x00}},
+      {"call", {0x20, 0x00, 0x11, 0x03, 0x00}},
+      {"one", {0x41, 0x01}},
+      {"two", {0x41, 0x02}}};
+  /// Types: (i32 i32 i32) -> (), (i32) -> i32, () -> (), () -> i32.
+  const Bytes FuncTypes = {0x00, 0x00, 0x00, 0x00, 0x02, 0x01,
+                           0x00, 0x02, 0x01, 0x03, 0x03};
+
+  Bytes Module = {0x00, 0x61, 0x73, 0x6D, 0x01, 0x00, 0x00, 0x00};
+  appendSection(Module, 0x01,
+                {0x04, 0x60, 0x03, 0x7F, 0x7F, 0x7F, 0x00, 0x60, 0x01, 0x7F,
+                 0x01, 0x7F, 0x60, 0x00, 0x00, 0x60, 0x00, 0x01, 0x7F});
+  Bytes FuncSec = {static_cast<uint8_t>(FuncTypes.size())};
+  FuncSec.insert(FuncSec.end(), FuncTypes.begin(), FuncTypes.end());
+  appendSection(Module, 0x03, FuncSec);
+  appendSection(Module, 0x04, {0x01, 0x70, 0x00, 0x04});
+  appendSection(Module, 0x05, {0x01, 0x00, 0x01});
+  Bytes ExportSec;
+  appendULEB(ExportSec, Funcs.size());
+  for (uint32_t I = 0; I < Funcs.size(); ++I) {
+    appendULEB(ExportSec, Funcs[I].first.size());
+    ExportSec.insert(ExportSec.end(), Funcs[I].first.begin(),
+                     Funcs[I].first.end());
+    ExportSec.push_back(0x00);
+    appendULEB(ExportSec, I);
+  }
+  appendSection(Module, 0x07, ExportSec);
+  /// Passive element segment of the function indices 9 and 10.
+  appendSection(Module, 0x09, {0x01, 0x01, 0x00, 0x02, 0x09, 0x0A});
+  appendSection(Module, 0x0C, {0x02});
+  Bytes CodeSec;
+  appendULEB(CodeSec, Funcs.size());
+  for (const auto &Func : Funcs) {
+    appendULEB(CodeSec, Func.second.size() + 2);
+    CodeSec.push_back(0x00);
+    CodeSec.insert(CodeSec.end(), Func.second.begin(), Func.second.end());
+    CodeSec.push_back(0x0B);
+  }
+  appendSection(Module, 0x0A, CodeSec);
+  appendSection(Module, 0x0B,
+                {0x02, 0x01, 0x05, 'h', 'e', 'l', 'l', 'o', 0x00, 0x41, 0x00,
+                 0x0B, 0x08, 'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h'});
+  return Module;
+}
+
+class BulkMemoryTest : public testing::Test {
+protected:
+  void SetUp() override {
+    ASSERT_TRUE(VM.loadWasm(makeModule()));
+    ASSERT_TRUE(VM.validate());
+    ASSERT_TRUE(VM.instantiate());
+  }
+
+  /// Run the function on the i32 arguments, and get the error if trapped.
+  SSVM::ErrCode run(const std::string &Func,
+                    const std::vector<uint32_t> &Args = {}) {
+    std::vector<SSVM::ValVariant> Params(Args.begin(), Args.end());
+    auto Res = VM.execute(Func, Params);
+    return Res ? SSVM::ErrCode::Success : Res.error();
+  }
+
+  /// Run the function returning an i32.
+  uint32_t get(const std::string &Func, uint32_t Arg) {
+    auto Res = VM.execute(Func, std::vector<SSVM::ValVariant>{Arg});
+    EXPECT_TRUE(Res);
+    if (!Res || Res->size() != 1) {
+      return UINT32_MAX;
+    }
+    return SSVM::retrieveValue<uint32_t>(Res->front());
+  }
+
+  /// Read the bytes of the memory.
+  std::string read(uint32_t Offset, uint32_t Length) {
+    std::string Data;
+    for (uint32_t I = 0; I < Length; ++I) {
+      Data.push_back(static_cast<char>(get("load", Offset + I)));
+    }
+    return Data;
+  }
+
+  SSVM::VM::Configure Conf;
+  SSVM::VM::VM VM{Conf};
+};
+
+TEST_F(BulkMemoryTest, CopyOverlap) {
+  /// The copy moves the bytes as if through a temporary buffer, in both
+  /// directions.
+  EXPECT_EQ(SSVM::ErrCode::Success, run("copy", {2, 0, 5}));
+  EXPECT_EQ("ababcdeh", read(0, 8));
+  EXPECT_EQ(SSVM::ErrCode::Success, run("copy", {0, 3, 5}));
+  EXPECT_EQ("bcdehdeh", read(0, 8));
+  EXPECT_EQ(SSVM::ErrCode::Success, run("copy", {4, 4, 4}));
+  EXPECT_EQ("bcdehdeh", read(0, 8));
+}
+
+TEST_F(BulkMemoryTest, CopyOutOfBounds) {
+  /// Both ranges are checked before any byte is written.
+  EXPECT_EQ(SSVM::ErrCode::MemoryOutOfBounds, run("copy", {65530, 0, 10}));
+  EXPECT_EQ(std::string(6, '\0'), read(65530, 6));
+  EXPECT_EQ(SSVM::ErrCode::MemoryOutOfBounds, run("copy", {0, 65530, 10}));
+  EXPECT_EQ("abcdefgh", read(0, 8));
+  EXPECT_EQ(SSVM::ErrCode::MemoryOutOfBounds,
+            run("copy", {0, 0xFFFFFFFF, 2}));
+
+  /// The empty ranges may end at the end of the memory.
+  EXPECT_EQ(SSVM::ErrCode::Success, run("copy", {65536, 65536, 0}));
+  EXPECT_EQ(SSVM::ErrCode::MemoryOutOfBounds, run("copy", {65537, 0, 0}));
+  EXPECT_EQ(SSVM::ErrCode::MemoryOutOfBounds, run("copy", {0, 65537, 0}));
+}
+
+TEST_F(BulkMemoryTest, Fill) {
+  EXPECT_EQ(SSVM::ErrCode::Success, run("fill", {1, 'x', 3}));
+  EXPECT_EQ("axxxefgh", read(0, 8));
+  /// The value is truncated to a byte.
+  EXPECT_EQ(SSVM::ErrCode::Success, run("fill", {6, 0x17A, 2}));
+  EXPECT_EQ("axxxefzz", read(0, 8));
+
+  EXPECT_EQ(SSVM::ErrCode::MemoryOutOfBounds, run("fill", {65535, 1, 2}));
+  EXPECT_EQ(std::string(1, '\0'), read(65535, 1));
+  EXPECT_EQ(SSVM::ErrCode::Success, run("fill", {65536, 1, 0}));
+  EXPECT_EQ(SSVM::ErrCode::MemoryOutOfBounds, run("fill", {65537, 1, 0}));
+}
+
+TEST_F(BulkMemoryTest, InitAndDrop) {
+  /// The passive segment stays alive after the instantiation.
+  EXPECT_EQ(SSVM::ErrCode::Success, run("init", {100, 1, 3}));
+  EXPECT_EQ("ell", read(100, 3));
+  EXPECT_EQ(SSVM::ErrCode::MemoryOutOfBounds, run("init", {200, 3, 5}));
+  EXPECT_EQ(std::string(5, '\0'), read(200, 5));
+  EXPECT_EQ(SSVM::ErrCode::MemoryOutOfBounds, run("init", {65534, 0, 5}));
+  EXPECT_EQ(SSVM::ErrCode::Success, run("init", {65536, 5, 0}));
+
+  /// The dropped segment is empty, and dropping it again is allowed.
+  EXPECT_EQ(SSVM::ErrCode::Success, run("drop"));
+  EXPECT_EQ(SSVM::ErrCode::Success, run("init", {100, 0, 0}));
+  EXPECT_EQ(SSVM::ErrCode::MemoryOutOfBounds, run("init", {300, 0, 1}));
+  EXPECT_EQ(std::string(1, '\0'), read(300, 1));
+  EXPECT_EQ(SSVM::ErrCode::Success, run("drop"));
+
+  /// The active segment is dropped by the instantiation.
+  EXPECT_EQ(SSVM::ErrCode::Success, run("init_active", {0, 0, 0}));
+  EXPECT_EQ(SSVM::ErrCode::MemoryOutOfBounds,
+            run("init_active", {0, 0, 1}));
+}
+
+TEST_F(BulkMemoryTest, ElemDrop) {
+  EXPECT_EQ(SSVM::ErrCode::UninitializedElement, run("call", {0}));
+  EXPECT_EQ(SSVM::ErrCode::Success, run("tinit", {1, 0, 2}));
+  EXPECT_EQ(1U, get("call", 1));
+  EXPECT_EQ(2U, get("call", 2));
+  EXPECT_EQ(SSVM::ErrCode::TableOutOfBounds, run("tinit", {3, 0, 2}));
+  EXPECT_EQ(SSVM::ErrCode::UninitializedElement, run("call", {3}));
+  EXPECT_EQ(SSVM::ErrCode::TableOutOfBounds, run("tinit", {0, 1, 2}));
+
+  /// The dropped segment is empty, and the table keeps its elements.
+  EXPECT_EQ(SSVM::ErrCode::Success, run("edrop"));
+  EXPECT_EQ(SSVM::ErrCode::Success, run("tinit", {0, 0, 0}));
+  EXPECT_EQ(SSVM::ErrCode::TableOutOfBounds, run("tinit", {0, 0, 1}));
+  EXPECT_EQ(SSVM::ErrCode::UninitializedElement, run("call", {0}));
+  EXPECT_EQ(2U, get("call", 2));
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  SSVM::Log::setErrorLoggingLevel();
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,176 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/test/interpreter/multiValueTest.cpp - Multi-value unit tests -===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of executing the multi-value functions and
+/// blocks: the block parameters and results, and the branches carrying
+/// several values.
+///
+//===----------------------------------------------------------------------===//
+
+#include "common/value.h"
+#include "support/log.h"
+#include "vm/configure.h"
+#include "vm/vm.h"
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+using SSVM::Bytes;
+
+void appendULEB(Bytes &Out, uint32_t Value) {
+  do {
+    uint8_t Byte = Value & 0x7F;
+    Value >>= 7;
+    if (Value != 0) {
+      Byte |= 0x80;
+    }
+    Out.push_back(Byte);
+  } while (Value != 0);
+}
+
+void appendSection(Bytes &Module, uint8_t Id, const Bytes &Content) {
+  Module.push_back(Id);
+  appendULEB(Module, Content.size());
+  Module.insert(Module.end(), Content.begin(), Content.end());
+}
+
+/// Module of the functions, whose blocks are typed by the type indices:
+///   swap(a, b) -> (b, a).
+///   block_sub(a, b) -> i32: a - b in a block of type (i32 i32) -> i32.
+///   loop_sum(n) -> i32: n + ... + 1 in a loop of type (i32 i32) -> i32 on
+///   the sum and the counter, which branches back with both.
+///   if_op(c, a, b) -> (i32 i32): (a + b, 1) if c, or (a - b, 2), in an if of
+///   type (i32 i32) -> (i32 i32).
+///   br_multi() -> (i32 i32): br out of a nested block with (11, 12) above
+///   the values 9 and 10.
+///   br_table_multi(i) -> (i32 i32): br_table with (1, 2) to the block adding
+///   10 to the second value if i is 0, or past it.
+///   call_swap(a, b) -> i32: b - a through the results of swap.
+Bytes makeModule() {
+  const std::vector<std::pair<std::string_view, Bytes>> Funcs = {
+      {"swap", {0x20, 0x01, 0x20, 0x00}},
+      {"block_sub", {0x20, 0x00, 0x20, 0x01, 0x02, 0x01, 0x6B, 0x0B}},
+      {"loop_sum",
+       {0x41, 0x00, 0x20, 0x00, 0x03, 0x01, 0x22, 0x00, 0x6A, 0x20, 0x00,
+        0x41, 0x01, 0x6B, 0x20, 0x00, 0x41, 0x01, 0x4B, 0x0D, 0x00, 0x1A,
+        0x0B}},
+      {"if_op",
+       {0x20, 0x01, 0x20, 0x02, 0x20, 0x00, 0x04, 0x00, 0x6A, 0x41, 0x01,
+        0x05, 0x6B, 0x41, 0x02, 0x0B}},
+      {"br_multi",
+       {0x02, 0x04, 0x41, 0x09, 0x02, 0x40, 0x41, 0x0A, 0x41, 0x0B, 0x41,
+        0x0C, 0x0C, 0x01, 0x0B, 0x00, 0x0B}},
+      {"br_table_multi",
+       {0x02, 0x04, 0x02, 0x04, 0x41, 0x01, 0x41, 0x02, 0x20, 0x00, 0x0E,
+        0x01, 0x00, 0x01, 0x0B, 0x41, 0x0A, 0x6A, 0x0B}},
+      {"call_swap", {0x20, 0x00, 0x20, 0x01, 0x10, 0x00, 0x6B}}};
+  /// Types: (i32 i32) -> (i32 i32), (i32 i32) -> i32, (i32) -> i32,
+  /// (i32 i32 i32) -> (i32 i32), () -> (i32 i32), (i32) -> (i32 i32).
+  const Bytes FuncTypes = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x01};
+
+  Bytes Module = {0x00, 0x61, 0x73, 0x6D, 0x01, 0x00, 0x00, 0x00};
+  appendSection(Module, 0x01,
+                {0x06, 0x60, 0x02, 0x7F, 0x7F, 0x02, 0x7F, 0x7F, 0x60, 0x02,
+                 0x7F, 0x7F, 0x01, 0x7F, 0x60, 0x01, 0x7F, 0x01, 0x7F, 0x60,
+                 0x03, 0x7F, 0x7F, 0x7F, 0x02, 0x7F, 0x7F, 0x60, 0x00, 0x02,
+                 0x7F, 0x7F, 0x60, 0x01, 0x7F, 0x02, 0x7F, 0x7F});
+  Bytes FuncSec = {static_cast<uint8_t>(FuncTypes.size())};
+  FuncSec.insert(FuncSec.end(), FuncTypes.begin(), FuncTypes.end());
+  appendSection(Module, 0x03, FuncSec);
+  Bytes ExportSec;
+  appendULEB(ExportSec, Funcs.size());
+  for (uint32_t I = 0; I < Funcs.size(); ++I) {
+    appendULEB(ExportSec, Funcs[I].first.size());
+    ExportSec.insert(ExportSec.end(), Funcs[I].first.begin(),
+                     Funcs[I].first.end());
+    ExportSec.push_back(0x00);
+    appendULEB(ExportSec, I);
+  }
+  appendSection(Module, 0x07, ExportSec);
+  Bytes CodeSec;
+  appendULEB(CodeSec, Funcs.size());
+  for (const auto &Func : Funcs) {
+    appendULEB(CodeSec, Func.second.size() + 2);
+    CodeSec.push_back(0x00);
+    CodeSec.insert(CodeSec.end(), Func.second.begin(), Func.second.end());
+    CodeSec.push_back(0x0B);
+  }
+  appendSection(Module, 0x0A, CodeSec);
+  return Module;
+}
+
+class MultiValueTest : public testing::Test {
+protected:
+  void SetUp() override {
+    ASSERT_TRUE(VM.loadWasm(makeModule()));
+    ASSERT_TRUE(VM.validate());
+    ASSERT_TRUE(VM.instantiate());
+  }
+
+  /// Run the function on the i32 arguments, and get the i32 results.
+  std::vector<uint32_t> run(const std::string &Func,
+                            const std::vector<uint32_t> &Args = {}) {
+    std::vector<SSVM::ValVariant> Params(Args.begin(), Args.end());
+    auto Res = VM.execute(Func, Params);
+    EXPECT_TRUE(Res);
+    std::vector<uint32_t> Rets;
+    if (Res) {
+      for (const auto &Val : *Res) {
+        Rets.push_back(SSVM::retrieveValue<uint32_t>(Val));
+      }
+    }
+    return Rets;
+  }
+
+  SSVM::VM::Configure Conf;
+  SSVM::VM::VM VM{Conf};
+};
+
+using Results = std::vector<uint32_t>;
+
+TEST_F(MultiValueTest, FunctionResults) {
+  EXPECT_EQ((Results{2, 1}), run("swap", {1, 2}));
+  EXPECT_EQ((Results{7}), run("call_swap", {3, 10}));
+}
+
+TEST_F(MultiValueTest, BlockParams) {
+  EXPECT_EQ((Results{7}), run("block_sub", {10, 3}));
+  EXPECT_EQ((Results{UINT32_MAX}), run("block_sub", {3, 4}));
+}
+
+TEST_F(MultiValueTest, LoopParams) {
+  EXPECT_EQ((Results{55}), run("loop_sum", {10}));
+  EXPECT_EQ((Results{1}), run("loop_sum", {1}));
+  EXPECT_EQ((Results{500500}), run("loop_sum", {1000}));
+}
+
+TEST_F(MultiValueTest, IfParams) {
+  EXPECT_EQ((Results{12, 1}), run("if_op", {1, 7, 5}));
+  EXPECT_EQ((Results{2, 2}), run("if_op", {0, 7, 5}));
+}
+
+TEST_F(MultiValueTest, BranchValues) {
+  /// The branches keep only the top values of the label arity.
+  EXPECT_EQ((Results{11, 12}), run("br_multi"));
+  EXPECT_EQ((Results{1, 12}), run("br_table_multi", {0}));
+  EXPECT_EQ((Results{1, 2}), run("br_table_multi", {1}));
+  EXPECT_EQ((Results{1, 2}), run("br_table_multi", {5}));
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  SSVM::Log::setErrorLoggingLevel();
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
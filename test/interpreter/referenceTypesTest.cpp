@@ -0,0 +1,225 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/test/interpreter/referenceTypesTest.cpp - Reference tests ----===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of executing the reference types
+/// instructions: the table accesses, the null references, and the external
+/// references passed in and out of the module.
+///
+//===----------------------------------------------------------------------===//
+
+#include "common/value.h"
+#include "support/log.h"
+#include "vm/configure.h"
+#include "vm/vm.h"
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+using SSVM::Bytes;
+
+void appendULEB(Bytes &Out, uint32_t Value) {
+  do {
+    uint8_t Byte = Value & 0x7F;
+    Value >>= 7;
+    if (Value != 0) {
+      Byte |= 0x80;
+    }
+    Out.push_back(Byte);
+  } while (Value != 0);
+}
+
+void appendSection(Bytes &Module, uint8_t Id, const Bytes &Content) {
+  Module.push_back(Id);
+  appendULEB(Module, Content.size());
+  Module.insert(Module.end(), Content.begin(), Content.end());
+}
+
+/// Module of the funcref table of 2 to 8 elements initialized to [one, null],
+/// the empty externref table of at most 4 elements, and the functions:
+///   is_null(i) -> i32: ref.is_null of table.get on the funcref table.
+///   call(i) -> i32: call_indirect of the funcref table with type () -> i32.
+///   set_null(i), set_one(i): table.set of ref.null and ref.func of one.
+///   grow(n) -> i32: table.grow of the funcref table with ref.null.
+///   size() -> i32: table.size of the funcref table.
+///   fill(i, n): table.fill of the funcref table with ref.func of one.
+///   ext_set(i, r), ext_get(i) -> r: table.set and table.get on the externref
+///   table.
+///   ext_grow(r, n) -> i32: table.grow of the externref table with r.
+///   ext_id(r) -> r, ext_is_null(r) -> i32: pass and check the externref.
+///   one() -> i32.
+Bytes makeModule() {
+  const std::vector<std::pair<std::string_view, Bytes>> Funcs = {
+      {"is_null", {0x20, 0x00, 0x25, 0x00, 0xD1}},
+      {"call", {0x20, 0x00, 0x11, 0x02, 0x00}},
+      {"set_null", {0x20, 0x00, 0xD0, 0x70, 0x26, 0x00}},
+      {"set_one", {0x20, 0x00, 0xD2, 0x0C, 0x26, 0x00}},
+      {"grow", {0xD0, 0x70, 0x20, 0x00, 0xFC, 0x0F, 0x00}},
+      {"size", {0xFC, 0x10, 0x00}},
+      {"fill", {0x20, 0x00, 0xD2, 0x0C, 0x20, 0x01, 0xFC, 0x11, 0x00}},
+      {"ext_set", {0x20, 0x00, 0x20, 0x01, 0x26, 0x01}},
+      {"ext_get", {0x20, 0x00, 0x25, 0x01}},
+      {"ext_grow", {0x20, 0x00, 0x20, 0x01, 0xFC, 0x0F, 0x01}},
+      {"ext_id", {0x20, 0x00}},
+      {"ext_is_null", {0x20, 0x00, 0xD1}},
+      {"one", {0x41, 0x01}}};
+  /// Types: (i32) -> i32, (i32) -> (), () -> i32, (i32 i32) -> (),
+  /// (i32 externref) -> (), (i32) -> externref, (externref i32) -> i32,
+  /// (externref) -> externref, (externref) -> i32.
+  const Bytes FuncTypes = {0x00, 0x00, 0x01, 0x01, 0x00, 0x02, 0x03,
+                           0x04, 0x05, 0x06, 0x07, 0x08, 0x02};
+
+  Bytes Module = {0x00, 0x61, 0x73, 0x6D, 0x01, 0x00, 0x00, 0x00};
+  appendSection(Module, 0x01,
+                {0x09, 0x60, 0x01, 0x7F, 0x01, 0x7F, 0x60, 0x01, 0x7F, 0x00,
+                 0x60, 0x00, 0x01, 0x7F, 0x60, 0x02, 0x7F, 0x7F, 0x00, 0x60,
+                 0x02, 0x7F, 0x6F, 0x00, 0x60, 0x01, 0x7F, 0x01, 0x6F, 0x60,
+                 0x02, 0x6F, 0x7F, 0x01, 0x7F, 0x60, 0x01, 0x6F, 0x01, 0x6F,
+                 0x60, 0x01, 0x6F, 0x01, 0x7F});
+  Bytes FuncSec = {static_cast<uint8_t>(FuncTypes.size())};
+  FuncSec.insert(FuncSec.end(), FuncTypes.begin(), FuncTypes.end());
+  appendSection(Module, 0x03, FuncSec);
+  appendSection(Module, 0x04,
+                {0x02, 0x70, 0x01, 0x02, 0x08, 0x6F, 0x01, 0x00, 0x04});
+  Bytes ExportSec;
+  appendULEB(ExportSec, Funcs.size());
+  for (uint32_t I = 0; I < Funcs.size(); ++I) {
+    appendULEB(ExportSec, Funcs[I].first.size());
+    ExportSec.insert(ExportSec.end(), Funcs[I].first.begin(),
+                     Funcs[I].first.end());
+    ExportSec.push_back(0x00);
+    appendULEB(ExportSec, I);
+  }
+  appendSection(Module, 0x07, ExportSec);
+  /// Active element segment of the function index 12 at 0.
+  appendSection(Module, 0x09, {0x01, 0x00, 0x41, 0x00, 0x0B, 0x01, 0x0C});
+  Bytes CodeSec;
+  appendULEB(CodeSec, Funcs.size());
+  for (const auto &Func : Funcs) {
+    appendULEB(CodeSec, Func.second.size() + 2);
+    CodeSec.push_back(0x00);
+    CodeSec.insert(CodeSec.end(), Func.second.begin(), Func.second.end());
+    CodeSec.push_back(0x0B);
+  }
+  appendSection(Module, 0x0A, CodeSec);
+  return Module;
+}
+
+class ReferenceTypesTest : public testing::Test {
+protected:
+  void SetUp() override {
+    ASSERT_TRUE(VM.loadWasm(makeModule()));
+    ASSERT_TRUE(VM.validate());
+    ASSERT_TRUE(VM.instantiate());
+  }
+
+  /// Run the function, and get the error if trapped.
+  SSVM::ErrCode run(const std::string &Func,
+                    std::vector<SSVM::ValVariant> Params) {
+    auto Res = VM.execute(Func, Params);
+    return Res ? SSVM::ErrCode::Success : Res.error();
+  }
+
+  /// Run the function returning a value.
+  SSVM::ValVariant get(const std::string &Func,
+                       std::vector<SSVM::ValVariant> Params) {
+    auto Res = VM.execute(Func, Params);
+    EXPECT_TRUE(Res);
+    if (!Res || Res->size() != 1) {
+      return UINT32_MAX;
+    }
+    return Res->front();
+  }
+
+  /// Run the function returning an i32.
+  uint32_t getI32(const std::string &Func,
+                  std::vector<SSVM::ValVariant> Params) {
+    return SSVM::retrieveValue<uint32_t>(get(Func, std::move(Params)));
+  }
+
+  SSVM::VM::Configure Conf;
+  SSVM::VM::VM VM{Conf};
+};
+
+TEST_F(ReferenceTypesTest, TableGetSet) {
+  EXPECT_EQ(0U, getI32("is_null", {0U}));
+  EXPECT_EQ(1U, getI32("is_null", {1U}));
+  EXPECT_EQ(1U, getI32("call", {0U}));
+  EXPECT_EQ(SSVM::ErrCode::UninitializedElement, run("call", {1U}));
+
+  EXPECT_EQ(SSVM::ErrCode::Success, run("set_null", {0U}));
+  EXPECT_EQ(1U, getI32("is_null", {0U}));
+  EXPECT_EQ(SSVM::ErrCode::UninitializedElement, run("call", {0U}));
+  EXPECT_EQ(SSVM::ErrCode::Success, run("set_one", {1U}));
+  EXPECT_EQ(0U, getI32("is_null", {1U}));
+  EXPECT_EQ(1U, getI32("call", {1U}));
+
+  EXPECT_EQ(SSVM::ErrCode::TableOutOfBounds, run("is_null", {2U}));
+  EXPECT_EQ(SSVM::ErrCode::TableOutOfBounds, run("set_one", {2U}));
+}
+
+TEST_F(ReferenceTypesTest, TableGrowFill) {
+  /// The grown elements are initialized, and the growth beyond the maximum
+  /// fails with -1.
+  EXPECT_EQ(2U, getI32("size", {}));
+  EXPECT_EQ(2U, getI32("grow", {3U}));
+  EXPECT_EQ(5U, getI32("size", {}));
+  EXPECT_EQ(1U, getI32("is_null", {4U}));
+  EXPECT_EQ(UINT32_MAX, getI32("grow", {4U}));
+  EXPECT_EQ(5U, getI32("size", {}));
+  EXPECT_EQ(5U, getI32("grow", {0U}));
+
+  EXPECT_EQ(SSVM::ErrCode::Success, run("fill", {2U, 3U}));
+  EXPECT_EQ(1U, getI32("is_null", {1U}));
+  for (uint32_t I = 2; I < 5; ++I) {
+    EXPECT_EQ(1U, getI32("call", {I}));
+  }
+
+  /// The range is checked before any element is written.
+  EXPECT_EQ(SSVM::ErrCode::Success, run("set_null", {4U}));
+  EXPECT_EQ(SSVM::ErrCode::TableOutOfBounds, run("fill", {4U, 2U}));
+  EXPECT_EQ(1U, getI32("is_null", {4U}));
+  EXPECT_EQ(SSVM::ErrCode::Success, run("fill", {5U, 0U}));
+  EXPECT_EQ(SSVM::ErrCode::TableOutOfBounds, run("fill", {6U, 0U}));
+}
+
+TEST_F(ReferenceTypesTest, ExternRef) {
+  int Obj = 0, Other = 0;
+  const auto ObjRef = SSVM::genExternRef(&Obj);
+  const auto OtherRef = SSVM::genExternRef(&Other);
+
+  /// The references pass through the module unchanged.
+  EXPECT_EQ(&Obj, SSVM::retrieveExternRef<int>(get("ext_id", {ObjRef})));
+  EXPECT_TRUE(SSVM::isNullRef(get("ext_id", {SSVM::genNullRef()})));
+  EXPECT_EQ(0U, getI32("ext_is_null", {ObjRef}));
+  EXPECT_EQ(1U, getI32("ext_is_null", {SSVM::genNullRef()}));
+
+  /// The references are stored in the externref table.
+  EXPECT_EQ(SSVM::ErrCode::TableOutOfBounds, run("ext_get", {0U}));
+  EXPECT_EQ(0U, getI32("ext_grow", {ObjRef, 2U}));
+  EXPECT_EQ(&Obj, SSVM::retrieveExternRef<int>(get("ext_get", {1U})));
+  EXPECT_EQ(SSVM::ErrCode::Success, run("ext_set", {0U, OtherRef}));
+  EXPECT_EQ(&Other, SSVM::retrieveExternRef<int>(get("ext_get", {0U})));
+  EXPECT_EQ(&Obj, SSVM::retrieveExternRef<int>(get("ext_get", {1U})));
+  EXPECT_EQ(SSVM::ErrCode::Success, run("ext_set", {1U, SSVM::genNullRef()}));
+  EXPECT_TRUE(SSVM::isNullRef(get("ext_get", {1U})));
+  EXPECT_EQ(UINT32_MAX, getI32("ext_grow", {ObjRef, 3U}));
+  EXPECT_EQ(SSVM::ErrCode::TableOutOfBounds, run("ext_set", {2U, ObjRef}));
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  SSVM::Log::setErrorLoggingLevel();
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,251 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/test/interpreter/simdTest.cpp - SIMD execution unit tests ----===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of executing the SIMD instructions, for the
+/// lanes where the results are not a plain lane-wise operation.
+///
+//===----------------------------------------------------------------------===//
+
+#include "common/value.h"
+#include "support/log.h"
+#include "vm/configure.h"
+#include "vm/vm.h"
+#include "gtest/gtest.h"
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+using SSVM::Bytes;
+
+/// Sub-opcodes after the 0xFD prefix.
+constexpr const uint32_t kV128Const = 0x0C;
+constexpr const uint32_t kShuffle = 0x0D;
+constexpr const uint32_t kSwizzle = 0x0E;
+constexpr const uint32_t kI8x16NarrowS = 0x65;
+constexpr const uint32_t kI8x16NarrowU = 0x66;
+constexpr const uint32_t kI16x8NarrowS = 0x85;
+constexpr const uint32_t kI16x8NarrowU = 0x86;
+constexpr const uint32_t kF32x4Min = 0xE8;
+constexpr const uint32_t kF32x4Max = 0xE9;
+constexpr const uint32_t kF64x2Min = 0xF4;
+constexpr const uint32_t kF64x2Max = 0xF5;
+constexpr const uint32_t kI32x4TruncSatF32x4S = 0xF8;
+constexpr const uint32_t kI32x4TruncSatF32x4U = 0xF9;
+constexpr const uint32_t kI32x4TruncSatF64x2SZero = 0xFC;
+constexpr const uint32_t kI32x4TruncSatF64x2UZero = 0xFD;
+
+void appendULEB(Bytes &Out, uint32_t Value) {
+  do {
+    uint8_t Byte = Value & 0x7F;
+    Value >>= 7;
+    if (Value != 0) {
+      Byte |= 0x80;
+    }
+    Out.push_back(Byte);
+  } while (Value != 0);
+}
+
+/// Append the SIMD instruction.
+void appendOp(Bytes &Body, uint32_t Op) {
+  Body.push_back(0xFD);
+  appendULEB(Body, Op);
+}
+
+/// Append v128.const of the lanes.
+template <typename T, size_t N>
+void appendConst(Bytes &Body, const std::array<T, N> &Lanes) {
+  static_assert(sizeof(T) * N == 16);
+  appendOp(Body, kV128Const);
+  const auto *Raw = reinterpret_cast<const uint8_t *>(Lanes.data());
+  Body.insert(Body.end(), Raw, Raw + 16);
+}
+
+/// Module exporting the function "f" of the body, which returns a v128.
+Bytes makeModule(const Bytes &Body) {
+  Bytes Code = {0x00};
+  Code.insert(Code.end(), Body.begin(), Body.end());
+  Code.push_back(0x0B);
+
+  Bytes Module = {0x00, 0x61, 0x73, 0x6D, 0x01, 0x00, 0x00, 0x00};
+  auto AppendSection = [&Module](uint8_t Id, const Bytes &Content) {
+    Module.push_back(Id);
+    appendULEB(Module, Content.size());
+    Module.insert(Module.end(), Content.begin(), Content.end());
+  };
+  AppendSection(0x01, {0x01, 0x60, 0x00, 0x01, 0x7B});
+  AppendSection(0x03, {0x01, 0x00});
+  AppendSection(0x07, {0x01, 0x01, 'f', 0x00, 0x00});
+  Bytes CodeSec = {0x01};
+  appendULEB(CodeSec, Code.size());
+  CodeSec.insert(CodeSec.end(), Code.begin(), Code.end());
+  AppendSection(0x0A, CodeSec);
+  return Module;
+}
+
+/// Run the body and get the lanes of the result.
+template <typename T> std::array<T, 16 / sizeof(T)> run(const Bytes &Body) {
+  SSVM::VM::Configure Conf;
+  SSVM::VM::VM VM(Conf);
+  std::array<T, 16 / sizeof(T)> Lanes{};
+  auto Res = VM.runWasmFile(makeModule(Body), "f");
+  EXPECT_TRUE(Res);
+  if (Res && Res->size() == 1) {
+    const auto Value = SSVM::retrieveValue<SSVM::uint128_t>(Res->front());
+    std::memcpy(Lanes.data(), &Value, 16);
+  }
+  return Lanes;
+}
+
+/// Run the binary operation on the lanes.
+template <typename R, typename T, size_t N>
+std::array<R, 16 / sizeof(R)> runBinary(uint32_t Op,
+                                        const std::array<T, N> &LHS,
+                                        const std::array<T, N> &RHS) {
+  Bytes Body;
+  appendConst(Body, LHS);
+  appendConst(Body, RHS);
+  appendOp(Body, Op);
+  return run<R>(Body);
+}
+
+/// Run the unary operation on the lanes.
+template <typename R, typename T, size_t N>
+std::array<R, 16 / sizeof(R)> runUnary(uint32_t Op,
+                                       const std::array<T, N> &Operand) {
+  Bytes Body;
+  appendConst(Body, Operand);
+  appendOp(Body, Op);
+  return run<R>(Body);
+}
+
+TEST(SIMDTest, F32x4MinMaxNaN) {
+  constexpr float NaN = std::numeric_limits<float>::quiet_NaN();
+  const std::array<float, 4> LHS = {NaN, -0.0f, 1.0f, 5.0f};
+  const std::array<float, 4> RHS = {1.0f, 0.0f, NaN, 2.0f};
+
+  /// NaN in either operand propagates, and -0 is less than +0.
+  const auto Min = runBinary<float>(kF32x4Min, LHS, RHS);
+  EXPECT_TRUE(std::isnan(Min[0]));
+  EXPECT_EQ(0.0f, Min[1]);
+  EXPECT_TRUE(std::signbit(Min[1]));
+  EXPECT_TRUE(std::isnan(Min[2]));
+  EXPECT_EQ(2.0f, Min[3]);
+
+  const auto Max = runBinary<float>(kF32x4Max, LHS, RHS);
+  EXPECT_TRUE(std::isnan(Max[0]));
+  EXPECT_EQ(0.0f, Max[1]);
+  EXPECT_FALSE(std::signbit(Max[1]));
+  EXPECT_TRUE(std::isnan(Max[2]));
+  EXPECT_EQ(5.0f, Max[3]);
+
+  /// The operand order does not matter for the signed zeros.
+  const auto Swapped = runBinary<float>(kF32x4Min, RHS, LHS);
+  EXPECT_TRUE(std::signbit(Swapped[1]));
+}
+
+TEST(SIMDTest, F64x2MinMaxNaN) {
+  constexpr double NaN = std::numeric_limits<double>::quiet_NaN();
+  const std::array<double, 2> LHS = {1.0, 0.0};
+  const std::array<double, 2> RHS = {NaN, -0.0};
+
+  const auto Min = runBinary<double>(kF64x2Min, LHS, RHS);
+  EXPECT_TRUE(std::isnan(Min[0]));
+  EXPECT_TRUE(std::signbit(Min[1]));
+
+  const auto Max = runBinary<double>(kF64x2Max, LHS, RHS);
+  EXPECT_TRUE(std::isnan(Max[0]));
+  EXPECT_FALSE(std::signbit(Max[1]));
+}
+
+TEST(SIMDTest, NarrowSaturates) {
+  const std::array<int16_t, 8> LHS16 = {300, -300, 127, -128,
+                                        0,   1,    -1,  32767};
+  const std::array<int16_t, 8> RHS16 = {255, 256, -32768, 128,
+                                        -129, 42, 0,      200};
+  EXPECT_EQ((std::array<int8_t, 16>{127, -128, 127, -128, 0, 1, -1, 127, 127,
+                                    127, -128, 127, -128, 42, 0, 127}),
+            runBinary<int8_t>(kI8x16NarrowS, LHS16, RHS16));
+  /// The unsigned narrowing takes the inputs as signed.
+  EXPECT_EQ((std::array<uint8_t, 16>{255, 0, 127, 0, 0, 1, 0, 255, 255, 255,
+                                     0, 128, 0, 42, 0, 200}),
+            runBinary<uint8_t>(kI8x16NarrowU, LHS16, RHS16));
+
+  const std::array<int32_t, 4> LHS32 = {70000, -70000, 5, -5};
+  const std::array<int32_t, 4> RHS32 = {32768, -32769, 65535, 65536};
+  EXPECT_EQ((std::array<int16_t, 8>{32767, -32768, 5, -5, 32767, -32768,
+                                    32767, 32767}),
+            runBinary<int16_t>(kI16x8NarrowS, LHS32, RHS32));
+  EXPECT_EQ(
+      (std::array<uint16_t, 8>{65535, 0, 5, 0, 32768, 0, 65535, 65535}),
+      runBinary<uint16_t>(kI16x8NarrowU, LHS32, RHS32));
+}
+
+TEST(SIMDTest, TruncSat) {
+  constexpr float NaN = std::numeric_limits<float>::quiet_NaN();
+  constexpr float Inf = std::numeric_limits<float>::infinity();
+  EXPECT_EQ((std::array<int32_t, 4>{0, INT32_MAX, INT32_MIN, -1}),
+            runUnary<int32_t>(kI32x4TruncSatF32x4S,
+                              std::array<float, 4>{NaN, 3e9f, -Inf, -1.5f}));
+  EXPECT_EQ((std::array<uint32_t, 4>{0, UINT32_MAX, 0, 3}),
+            runUnary<uint32_t>(kI32x4TruncSatF32x4U,
+                               std::array<float, 4>{NaN, Inf, -1.5f, 3.7f}));
+
+  /// The f64x2 variants zero the upper lanes.
+  constexpr double DNaN = std::numeric_limits<double>::quiet_NaN();
+  EXPECT_EQ((std::array<int32_t, 4>{0, INT32_MIN, 0, 0}),
+            runUnary<int32_t>(kI32x4TruncSatF64x2SZero,
+                              std::array<double, 2>{DNaN, -1e10}));
+  EXPECT_EQ((std::array<uint32_t, 4>{UINT32_MAX, 2, 0, 0}),
+            runUnary<uint32_t>(kI32x4TruncSatF64x2UZero,
+                               std::array<double, 2>{1e10, 2.9}));
+}
+
+TEST(SIMDTest, SwizzleOutOfRange) {
+  std::array<uint8_t, 16> Data;
+  for (uint8_t I = 0; I < 16; ++I) {
+    Data[I] = 0x10 + I;
+  }
+  /// The indices out of the 16 lanes select zero.
+  const std::array<uint8_t, 16> Indices = {0,  15, 16, 255, 1,  0x80, 2, 17,
+                                           32, 3,  14, 128, 64, 4,    5, 6};
+  EXPECT_EQ((std::array<uint8_t, 16>{0x10, 0x1F, 0, 0, 0x11, 0, 0x12, 0, 0,
+                                     0x13, 0x1E, 0, 0, 0x14, 0x15, 0x16}),
+            runBinary<uint8_t>(kSwizzle, Data, Indices));
+}
+
+TEST(SIMDTest, Shuffle) {
+  std::array<uint8_t, 16> LHS, RHS;
+  for (uint8_t I = 0; I < 16; ++I) {
+    LHS[I] = I;
+    RHS[I] = 0x80 + I;
+  }
+  /// The lane indices 16 to 31 select the second operand.
+  const std::array<uint8_t, 16> Lanes = {0,  31, 16, 15, 1, 17, 30, 2,
+                                         29, 3,  28, 4,  5, 5,  20, 21};
+  Bytes Body;
+  appendConst(Body, LHS);
+  appendConst(Body, RHS);
+  appendOp(Body, kShuffle);
+  Body.insert(Body.end(), Lanes.begin(), Lanes.end());
+  EXPECT_EQ((std::array<uint8_t, 16>{0, 0x8F, 0x80, 15, 1, 0x81, 0x8E, 2,
+                                     0x8D, 3, 0x8C, 4, 5, 5, 0x84, 0x85}),
+            run<uint8_t>(Body));
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  SSVM::Log::setErrorLoggingLevel();
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
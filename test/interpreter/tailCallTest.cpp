@@ -0,0 +1,158 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/test/interpreter/tailCallTest.cpp - Tail call unit tests -----===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of executing the tail call instructions: the
+/// deep mutual recursion runs in the constant stack.
+///
+//===----------------------------------------------------------------------===//
+
+#include "common/value.h"
+#include "runtime/hostfunc.h"
+#include "runtime/importobj.h"
+#include "support/log.h"
+#include "vm/configure.h"
+#include "vm/vm.h"
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+using SSVM::Bytes;
+
+void appendULEB(Bytes &Out, uint32_t Value) {
+  do {
+    uint8_t Byte = Value & 0x7F;
+    Value >>= 7;
+    if (Value != 0) {
+      Byte |= 0x80;
+    }
+    Out.push_back(Byte);
+  } while (Value != 0);
+}
+
+void appendSection(Bytes &Module, uint8_t Id, const Bytes &Content) {
+  Module.push_back(Id);
+  appendULEB(Module, Content.size());
+  Module.insert(Module.end(), Content.begin(), Content.end());
+}
+
+/// Host function recording the position of its argument on the value stack.
+class Probe : public SSVM::Runtime::HostFunctionBase {
+public:
+  Probe(const SSVM::ValVariant *&Top) : HostFunctionBase(0), Top(Top) {
+    FuncType.Params = {SSVM::ValType::I32};
+  }
+
+  SSVM::Expect<void> run(SSVM::Runtime::Instance::MemoryInstance &,
+                         SSVM::Span<SSVM::ValVariant> Args,
+                         SSVM::Span<SSVM::ValVariant>) override {
+    Top = Args.data();
+    return {};
+  }
+
+private:
+  const SSVM::ValVariant *&Top;
+};
+
+/// Module of the imported probe, the table of even, a memory for the host
+/// call, and the functions:
+///   even(n) -> i32: call the probe and return 1 if n is 0, or return_call
+///   odd(n - 1).
+///   odd(n) -> i32: call the probe and return 0 if n is 0, or
+///   return_call_indirect even(n - 1) through the table.
+Bytes makeModule() {
+  const Bytes Even = {0x20, 0x00, 0x45, 0x04, 0x40, 0x20, 0x00, 0x10,
+                      0x00, 0x41, 0x01, 0x0F, 0x0B, 0x20, 0x00, 0x41,
+                      0x01, 0x6B, 0x12, 0x02};
+  const Bytes Odd = {0x20, 0x00, 0x45, 0x04, 0x40, 0x20, 0x00, 0x10,
+                     0x00, 0x41, 0x00, 0x0F, 0x0B, 0x20, 0x00, 0x41,
+                     0x01, 0x6B, 0x41, 0x00, 0x13, 0x01, 0x00};
+
+  Bytes Module = {0x00, 0x61, 0x73, 0x6D, 0x01, 0x00, 0x00, 0x00};
+  /// Types: (i32) -> (), (i32) -> i32.
+  appendSection(Module, 0x01,
+                {0x02, 0x60, 0x01, 0x7F, 0x00, 0x60, 0x01, 0x7F, 0x01, 0x7F});
+  appendSection(Module, 0x02,
+                {0x01, 0x04, 't', 'e', 's', 't', 0x05, 'p', 'r', 'o', 'b',
+                 'e', 0x00, 0x00});
+  appendSection(Module, 0x03, {0x02, 0x01, 0x01});
+  appendSection(Module, 0x04, {0x01, 0x70, 0x01, 0x01, 0x01});
+  appendSection(Module, 0x05, {0x01, 0x00, 0x01});
+  appendSection(Module, 0x07,
+                {0x02, 0x04, 'e', 'v', 'e', 'n', 0x00, 0x01, 0x03, 'o', 'd',
+                 'd', 0x00, 0x02});
+  appendSection(Module, 0x09, {0x01, 0x00, 0x41, 0x00, 0x0B, 0x01, 0x01});
+  Bytes CodeSec = {0x02};
+  for (const auto &Body : {Even, Odd}) {
+    appendULEB(CodeSec, Body.size() + 2);
+    CodeSec.push_back(0x00);
+    CodeSec.insert(CodeSec.end(), Body.begin(), Body.end());
+    CodeSec.push_back(0x0B);
+  }
+  appendSection(Module, 0x0A, CodeSec);
+  return Module;
+}
+
+class TailCallTest : public testing::Test {
+protected:
+  void SetUp() override {
+    ImpObj.addHostFunc("probe", std::make_unique<Probe>(Top));
+    ASSERT_TRUE(VM.registerModule(ImpObj));
+    ASSERT_TRUE(VM.loadWasm(makeModule()));
+    ASSERT_TRUE(VM.validate());
+    ASSERT_TRUE(VM.instantiate());
+  }
+
+  /// Run the function, and get the i32 result.
+  uint32_t get(const std::string &Func, uint32_t Arg) {
+    auto Res = VM.execute(Func, std::vector<SSVM::ValVariant>{Arg});
+    EXPECT_TRUE(Res);
+    if (!Res || Res->size() != 1) {
+      return UINT32_MAX;
+    }
+    return SSVM::retrieveValue<uint32_t>(Res->front());
+  }
+
+  const SSVM::ValVariant *Top = nullptr;
+  SSVM::Runtime::ImportObject ImpObj{"test"};
+  SSVM::VM::Configure Conf;
+  SSVM::VM::VM VM{Conf};
+};
+
+TEST_F(TailCallTest, ConstantStack) {
+  /// The probe in the base case is called at the same stack height after any
+  /// number of tail calls.
+  EXPECT_EQ(1U, get("even", 0));
+  const auto *Base = Top;
+  ASSERT_NE(nullptr, Base);
+
+  Top = nullptr;
+  EXPECT_EQ(1U, get("even", 1000000));
+  EXPECT_EQ(Base, Top);
+  Top = nullptr;
+  EXPECT_EQ(0U, get("even", 1000001));
+  EXPECT_EQ(Base, Top);
+  Top = nullptr;
+  EXPECT_EQ(1U, get("odd", 999999));
+  EXPECT_EQ(Base, Top);
+  Top = nullptr;
+  EXPECT_EQ(0U, get("odd", 1000000));
+  EXPECT_EQ(Base, Top);
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  SSVM::Log::setErrorLoggingLevel();
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
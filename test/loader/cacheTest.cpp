@@ -0,0 +1,185 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/test/loader/cacheTest.cpp - Module cache unit tests ----------===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of writing and loading module cache.
+///
+//===----------------------------------------------------------------------===//
+
+#include "loader/cache.h"
+#include "loader/loader.h"
+#include "support/hash.h"
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+namespace {
+
+SSVM::Loader::Loader Loader;
+
+/// Create an empty directory for cache files.
+std::string makeCacheDir() {
+  char Template[] = "/tmp/ssvmCacheTest.XXXXXX";
+  const char *Dir = mkdtemp(Template);
+  return Dir ? Dir : "";
+}
+
+void writeFile(const std::string &Path, const SSVM::Bytes &Data) {
+  std::ofstream File(Path, std::ios::binary | std::ios::trunc);
+  File.write(reinterpret_cast<const char *>(Data.data()), Data.size());
+}
+
+void expectLazyModule(const SSVM::AST::Module &Mod, const size_t Funcs) {
+  ASSERT_NE(nullptr, Mod.getCodeSection());
+  auto &Segs = Mod.getCodeSection()->getContent();
+  EXPECT_EQ(Funcs, Segs.size());
+  for (auto &Seg : Segs) {
+    EXPECT_FALSE(Seg->isLoaded());
+  }
+}
+
+void expectCachedModule(const SSVM::AST::Module &Mod, const size_t Funcs) {
+  EXPECT_TRUE(Mod.isValidated());
+  expectLazyModule(Mod, Funcs);
+}
+
+TEST(CacheTest, WriteAndLoad) {
+  /// 1. Test writing module cache and loading it as a module.
+  const std::string Dir = makeCacheDir();
+  ASSERT_FALSE(Dir.empty());
+  auto Code = Loader.loadFile("wagonTestData/block.wasm");
+  ASSERT_TRUE(Code);
+  auto Expected = Loader.parseModule(*Code);
+  ASSERT_TRUE(Expected);
+  ASSERT_NE(nullptr, (*Expected)->getCodeSection());
+  EXPECT_FALSE((*Expected)->isValidated());
+
+  const std::string Path = SSVM::Loader::getModuleCachePath(
+      Dir, SSVM::hash64(SSVM::Span<const SSVM::Byte>(*Code)));
+  ASSERT_TRUE(SSVM::Loader::writeModuleCache(Path, *Code));
+  auto Cache = Loader.loadFile(Path);
+  ASSERT_TRUE(Cache);
+  EXPECT_TRUE(SSVM::Loader::isModuleCache(*Cache));
+  EXPECT_FALSE(SSVM::Loader::isModuleCache(*Code));
+  auto Payload =
+      SSVM::Loader::readModuleCache(SSVM::SharedBytes(SSVM::Bytes(*Cache)));
+  ASSERT_TRUE(Payload);
+  EXPECT_TRUE(std::equal(Payload->begin(), Payload->end(), Code->begin(),
+                         Code->end()));
+
+  /// A cache file given by path is loaded lazily, but is not trusted.
+  const size_t Funcs = (*Expected)->getCodeSection()->getContent().size();
+  auto Mod = Loader.parseModule(Path);
+  ASSERT_TRUE(Mod);
+  expectLazyModule(**Mod, Funcs);
+  EXPECT_FALSE((*Mod)->isValidated());
+
+  /// Bytes are never recognized as a cache.
+  Mod = Loader.parseModule(*Cache);
+  ASSERT_FALSE(Mod);
+  std::remove(Path.c_str());
+  std::remove(Dir.c_str());
+}
+
+TEST(CacheTest, LoadCorrupted) {
+  /// 2. Test rejecting damaged module cache.
+  const std::string Dir = makeCacheDir();
+  ASSERT_FALSE(Dir.empty());
+  auto Code = Loader.loadFile("wagonTestData/block.wasm");
+  ASSERT_TRUE(Code);
+  const std::string Path = Dir + "/block.ssvmc";
+  ASSERT_TRUE(SSVM::Loader::writeModuleCache(Path, *Code));
+  auto Cache = Loader.loadFile(Path);
+  ASSERT_TRUE(Cache);
+  const SSVM::Bytes Origin = *Cache;
+
+  /// Damaged header.
+  (*Cache)[offsetof(SSVM::Loader::CacheHeader, ModuleSize)] ^= 0x01U;
+  writeFile(Path, *Cache);
+  auto Mod = Loader.parseModule(Path);
+  ASSERT_FALSE(Mod);
+  EXPECT_EQ(SSVM::ErrCode::InvalidGrammar, Mod.error());
+
+  /// Damaged payload.
+  *Cache = Origin;
+  Cache->back() ^= 0x01U;
+  writeFile(Path, *Cache);
+  Mod = Loader.parseModule(Path);
+  ASSERT_FALSE(Mod);
+  EXPECT_EQ(SSVM::ErrCode::InvalidGrammar, Mod.error());
+
+  /// Truncated payload.
+  *Cache = Origin;
+  Cache->pop_back();
+  writeFile(Path, *Cache);
+  Mod = Loader.parseModule(Path);
+  ASSERT_FALSE(Mod);
+  EXPECT_EQ(SSVM::ErrCode::EndOfFile, Mod.error());
+  std::remove(Path.c_str());
+  std::remove(Dir.c_str());
+}
+
+TEST(CacheTest, CacheDirectory) {
+  /// 3. Test looking up modules in cache directory by their hash.
+  const std::string Dir = makeCacheDir();
+  ASSERT_FALSE(Dir.empty());
+  SSVM::Loader::Loader CacheLoader;
+  CacheLoader.setCacheDir(Dir);
+
+  auto Mod = CacheLoader.parseModule("wagonTestData/block.wasm");
+  ASSERT_TRUE(Mod);
+  EXPECT_FALSE((*Mod)->isValidated());
+  const size_t Funcs = (*Mod)->getCodeSection()->getContent().size();
+  ASSERT_TRUE(CacheLoader.saveCache(**Mod));
+
+  Mod = CacheLoader.parseModule("wagonTestData/block.wasm");
+  ASSERT_TRUE(Mod);
+  expectCachedModule(**Mod, Funcs);
+
+  /// The cache is not shared by other modules.
+  Mod = CacheLoader.parseModule("wagonTestData/address.wasm");
+  ASSERT_TRUE(Mod);
+  EXPECT_FALSE((*Mod)->isValidated());
+
+  /// A forged cache outside the directory is not trusted, even if it holds
+  /// the same module.
+  auto Code = Loader.loadFile("wagonTestData/block.wasm");
+  ASSERT_TRUE(Code);
+  const std::string Forged = Dir + "/forged.ssvmc";
+  ASSERT_TRUE(SSVM::Loader::writeModuleCache(Forged, *Code));
+  SSVM::Loader::Loader PlainLoader;
+  Mod = PlainLoader.parseModule(Forged);
+  ASSERT_TRUE(Mod);
+  EXPECT_FALSE((*Mod)->isValidated());
+  std::remove(Forged.c_str());
+
+  /// A cache in the directory records the module of its hash and size, and
+  /// does not apply to another module stored under the same name.
+  const std::string Path = SSVM::Loader::getModuleCachePath(
+      Dir, SSVM::hash64(SSVM::Span<const SSVM::Byte>(*Code)));
+  auto Other = Loader.loadFile("wagonTestData/address.wasm");
+  ASSERT_TRUE(Other);
+  ASSERT_TRUE(SSVM::Loader::writeModuleCache(Path, *Other));
+  Mod = CacheLoader.parseModule("wagonTestData/block.wasm");
+  ASSERT_TRUE(Mod);
+  EXPECT_FALSE((*Mod)->isValidated());
+  std::remove(Path.c_str());
+  const std::string OtherPath = SSVM::Loader::getModuleCachePath(
+      Dir, SSVM::hash64(SSVM::Span<const SSVM::Byte>(*Other)));
+  std::remove(OtherPath.c_str());
+  std::remove(Dir.c_str());
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
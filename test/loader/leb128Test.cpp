@@ -0,0 +1,141 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/test/loader/leb128Test.cpp - LEB128 decoding unit tests ------===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of LEB128 decoding on raw byte ranges.
+///
+//===----------------------------------------------------------------------===//
+
+#include "loader/leb128.h"
+#include "gtest/gtest.h"
+
+#include <vector>
+
+namespace {
+
+/// Padding after the encoded number to take the range-checked-once path.
+const std::vector<uint8_t> Padding(8, 0xFFU);
+
+template <typename T>
+std::vector<SSVM::Expect<T>> decode(std::vector<uint8_t> Vec,
+                                    SSVM::Expect<T> (*Read)(const uint8_t *&,
+                                                            const uint8_t *),
+                                    size_t &Length) {
+  /// Decode both without and with padding.
+  std::vector<SSVM::Expect<T>> Results;
+  const size_t Size = Vec.size();
+  const uint8_t *Ptr = Vec.data();
+  Results.push_back(Read(Ptr, Vec.data() + Vec.size()));
+  Length = Ptr - Vec.data();
+  Vec.insert(Vec.end(), Padding.begin(), Padding.end());
+  Ptr = Vec.data();
+  Results.push_back(Read(Ptr, Vec.data() + Vec.size()));
+  if (Results.back() && static_cast<size_t>(Ptr - Vec.data()) != Size) {
+    Length = SIZE_MAX;
+  }
+  return Results;
+}
+
+TEST(LEB128Test, ReadUnsigned32) {
+  /// 1. Test unsigned 32bit integer decoding on both paths.
+  size_t Length = 0;
+  for (const auto &[Code, Expected] :
+       std::vector<std::pair<std::vector<uint8_t>, uint32_t>>{
+           {{0x00U}, 0U},
+           {{0x7FU}, 127U},
+           {{0x80U, 0x01U}, 128U},
+           {{0xE5U, 0x8EU, 0x26U}, 624485U},
+           {{0x80U, 0x80U, 0x80U, 0x80U, 0x00U}, 0U},
+           {{0xFFU, 0xFFU, 0xFFU, 0xFFU, 0x0FU}, UINT32_MAX}}) {
+    for (const auto &Res : decode(Code, SSVM::LEB128::readU32, Length)) {
+      ASSERT_TRUE(Res);
+      EXPECT_EQ(Expected, *Res);
+    }
+    EXPECT_EQ(Code.size(), Length);
+  }
+}
+
+TEST(LEB128Test, ReadSigned32) {
+  /// 2. Test signed 32bit integer decoding and sign extension.
+  size_t Length = 0;
+  for (const auto &[Code, Expected] :
+       std::vector<std::pair<std::vector<uint8_t>, int32_t>>{
+           {{0x00U}, 0},
+           {{0x7FU}, -1},
+           {{0x3FU}, 63},
+           {{0x40U}, -64},
+           {{0xC0U, 0xBBU, 0x78U}, -123456},
+           {{0xFFU, 0xFFU, 0xFFU, 0xFFU, 0x07U}, INT32_MAX},
+           {{0x80U, 0x80U, 0x80U, 0x80U, 0x78U}, INT32_MIN}}) {
+    for (const auto &Res : decode(Code, SSVM::LEB128::readS32, Length)) {
+      ASSERT_TRUE(Res);
+      EXPECT_EQ(Expected, *Res);
+    }
+    EXPECT_EQ(Code.size(), Length);
+  }
+}
+
+TEST(LEB128Test, ReadUnsigned64) {
+  /// 3. Test unsigned 64bit integer decoding, including encodings longer than
+  /// the 8-byte window.
+  size_t Length = 0;
+  for (const auto &[Code, Expected] :
+       std::vector<std::pair<std::vector<uint8_t>, uint64_t>>{
+           {{0x00U}, 0U},
+           {{0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0x7FU},
+            (UINT64_C(1) << 56) - 1},
+           {{0x80U, 0x80U, 0x80U, 0x80U, 0x80U, 0x80U, 0x80U, 0x80U, 0x01U},
+            UINT64_C(1) << 56},
+           {{0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU,
+             0x01U},
+            UINT64_MAX}}) {
+    for (const auto &Res : decode(Code, SSVM::LEB128::readU64, Length)) {
+      ASSERT_TRUE(Res);
+      EXPECT_EQ(Expected, *Res);
+    }
+    EXPECT_EQ(Code.size(), Length);
+  }
+}
+
+TEST(LEB128Test, ReadSigned64) {
+  /// 4. Test signed 64bit integer decoding and sign extension.
+  size_t Length = 0;
+  for (const auto &[Code, Expected] :
+       std::vector<std::pair<std::vector<uint8_t>, int64_t>>{
+           {{0x7FU}, -1},
+           {{0x80U, 0x80U, 0x80U, 0x80U, 0x80U, 0x80U, 0x80U, 0x40U},
+            -(INT64_C(1) << 55)},
+           {{0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU,
+             0x00U},
+            INT64_MAX},
+           {{0x80U, 0x80U, 0x80U, 0x80U, 0x80U, 0x80U, 0x80U, 0x80U, 0x80U,
+             0x7FU},
+            INT64_MIN}}) {
+    for (const auto &Res : decode(Code, SSVM::LEB128::readS64, Length)) {
+      ASSERT_TRUE(Res);
+      EXPECT_EQ(Expected, *Res);
+    }
+    EXPECT_EQ(Code.size(), Length);
+  }
+}
+
+TEST(LEB128Test, Truncated) {
+  /// 5. Test reading a number cut off by the end of range.
+  const std::vector<uint8_t> Code = {0x80U, 0x80U, 0x80U};
+  const uint8_t *Ptr = Code.data();
+  auto Res = SSVM::LEB128::readU32(Ptr, Code.data() + Code.size());
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(SSVM::ErrCode::EndOfFile, Res.error());
+  EXPECT_EQ(Code.data() + Code.size(), Ptr);
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,121 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/test/loader/streamTest.cpp - Streaming loading unit tests ----===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of loading WASM from byte chunks.
+///
+//===----------------------------------------------------------------------===//
+
+#include "loader/loader.h"
+#include "loader/stream.h"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+namespace {
+
+SSVM::Loader::Loader Loader;
+
+/// Feed the module by chunks of given size.
+SSVM::Expect<std::unique_ptr<SSVM::AST::Module>>
+streamModule(const SSVM::Bytes &Code, size_t ChunkSize) {
+  SSVM::Loader::StreamLoader Stream;
+  for (size_t I = 0; I < Code.size(); I += ChunkSize) {
+    const size_t Size = std::min(ChunkSize, Code.size() - I);
+    if (auto Res = Stream.feed(SSVM::Span<const SSVM::Byte>(&Code[I], Size));
+        !Res) {
+      return SSVM::Unexpect(Res);
+    }
+  }
+  return Stream.finish();
+}
+
+/// Compare the numbers of nodes of modules.
+void expectSameModule(const SSVM::AST::Module &Expected,
+                      const SSVM::AST::Module &Mod) {
+  const auto Count = [](const auto *Sec) -> size_t {
+    return Sec ? Sec->getContent().size() : SIZE_MAX;
+  };
+  EXPECT_EQ(Count(Expected.getTypeSection()), Count(Mod.getTypeSection()));
+  EXPECT_EQ(Count(Expected.getImportSection()), Count(Mod.getImportSection()));
+  EXPECT_EQ(Count(Expected.getFunctionSection()),
+            Count(Mod.getFunctionSection()));
+  EXPECT_EQ(Count(Expected.getExportSection()), Count(Mod.getExportSection()));
+  EXPECT_EQ(Count(Expected.getDataSection()), Count(Mod.getDataSection()));
+  ASSERT_EQ(Count(Expected.getCodeSection()), Count(Mod.getCodeSection()));
+  if (Expected.getCodeSection()) {
+    auto &ExpectedSegs = Expected.getCodeSection()->getContent();
+    auto &Segs = Mod.getCodeSection()->getContent();
+    for (size_t I = 0; I < Segs.size(); ++I) {
+      EXPECT_EQ(ExpectedSegs[I]->getLocals().size(),
+                Segs[I]->getLocals().size());
+      EXPECT_EQ(ExpectedSegs[I]->getInstrs().size(),
+                Segs[I]->getInstrs().size());
+    }
+  }
+}
+
+TEST(StreamTest, LoadByChunks) {
+  /// 1. Test load modules by chunks of different sizes.
+  for (const std::string Name :
+       {"add-ex-main", "address", "block", "br_table", "call_indirect"}) {
+    auto Code = Loader.loadFile("wagonTestData/" + Name + ".wasm");
+    ASSERT_TRUE(Code);
+    auto Expected = Loader.parseModule(*Code);
+    ASSERT_TRUE(Expected);
+    for (const size_t ChunkSize : {size_t(1), size_t(7), Code->size()}) {
+      auto Mod = streamModule(*Code, ChunkSize);
+      ASSERT_TRUE(Mod) << Name << " by " << ChunkSize;
+      expectSameModule(**Expected, **Mod);
+    }
+  }
+}
+
+TEST(StreamTest, LoadTruncated) {
+  /// 2. Test load truncated modules.
+  auto Code = Loader.loadFile("wagonTestData/br_table.wasm");
+  ASSERT_TRUE(Code);
+  for (const size_t Size : {size_t(0), size_t(4), Code->size() - 1}) {
+    SSVM::Bytes Truncated(Code->begin(), Code->begin() + Size);
+    auto Mod = streamModule(Truncated, 3);
+    ASSERT_FALSE(Mod);
+    EXPECT_EQ(SSVM::ErrCode::EndOfFile, Mod.error());
+  }
+  SSVM::Bytes Invalid = *Code;
+  Invalid[0] = 0x01U;
+  auto Mod = streamModule(Invalid, 3);
+  ASSERT_FALSE(Mod);
+  EXPECT_EQ(SSVM::ErrCode::InvalidGrammar, Mod.error());
+}
+
+TEST(StreamTest, LoadFromPipe) {
+  /// 3. Test load module from pipe.
+  auto Code = Loader.loadFile("wagonTestData/call_indirect.wasm");
+  ASSERT_TRUE(Code);
+  int Fds[2];
+  ASSERT_EQ(0, pipe(Fds));
+  ASSERT_EQ(static_cast<ssize_t>(Code->size()),
+            write(Fds[1], Code->data(), Code->size()));
+  close(Fds[1]);
+  auto Mod = Loader.parseModule(Fds[0]);
+  close(Fds[0]);
+  ASSERT_TRUE(Mod);
+  auto Expected = Loader.parseModule(*Code);
+  ASSERT_TRUE(Expected);
+  expectSameModule(**Expected, **Mod);
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
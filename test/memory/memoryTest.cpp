@@ -0,0 +1,96 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/test/memory/memoryTest.cpp - shared memory unit tests --------===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of the shared memory instances.
+///
+//===----------------------------------------------------------------------===//
+
+#include "runtime/instance/memory.h"
+#include "gtest/gtest.h"
+
+#include <thread>
+#include <vector>
+
+namespace {
+
+using MemoryInstance = SSVM::Runtime::Instance::MemoryInstance;
+
+TEST(MemoryTest, SharedGrow) {
+  /// 1. Test shared memory never moves on growing.
+  MemoryInstance Mem(SSVM::AST::Limit(1, 4, true));
+  EXPECT_TRUE(Mem.isShared());
+  uint8_t *Ptr = Mem.getPointer<uint8_t *>(0);
+  EXPECT_TRUE(Mem.growPage(3));
+  EXPECT_EQ(4U, Mem.getDataPageSize());
+  EXPECT_EQ(Ptr, Mem.getPointer<uint8_t *>(0));
+  EXPECT_FALSE(Mem.growPage(1));
+}
+
+TEST(MemoryTest, AtomicAccess) {
+  /// 2. Test the bounds and the alignment of atomic accesses.
+  MemoryInstance Mem(SSVM::AST::Limit(1, 1, true));
+  EXPECT_TRUE(Mem.getAtomicPointer<uint32_t>(65532));
+  EXPECT_EQ(SSVM::ErrCode::UnalignedAtomicAccess,
+            Mem.getAtomicPointer<uint32_t>(2).error());
+  EXPECT_EQ(SSVM::ErrCode::MemoryOutOfBounds,
+            Mem.getAtomicPointer<uint64_t>(65536).error());
+
+  /// Waiting on unshared memory traps.
+  MemoryInstance Unshared(SSVM::AST::Limit(1));
+  EXPECT_EQ(SSVM::ErrCode::ExpectSharedMemory,
+            Unshared.atomicWait<uint32_t>(0, 0, 0).error());
+  EXPECT_EQ(0U, *Unshared.atomicNotify(0, 1));
+}
+
+TEST(MemoryTest, WaitNotify) {
+  /// 3. Test wait and notify.
+  ///
+  ///   1.  Wait returns 1 when the value is not equal.
+  ///   2.  Wait returns 2 when timed out.
+  ///   3.  Notify wakes the given count of waiters.
+  MemoryInstance Mem(SSVM::AST::Limit(1, 1, true));
+  EXPECT_EQ(1U, *Mem.atomicWait<uint32_t>(0, 1, -1));
+  EXPECT_EQ(2U, *Mem.atomicWait<uint64_t>(8, 0, 1000000));
+  EXPECT_EQ(0U, *Mem.atomicNotify(8, 1));
+
+  constexpr uint32_t N = 4;
+  std::atomic<uint32_t> Waiting = 0;
+  std::vector<std::thread> Threads;
+  std::vector<uint32_t> Results(N, UINT32_MAX);
+  for (uint32_t I = 0; I < N; ++I) {
+    Threads.emplace_back([&, I]() {
+      ++Waiting;
+      Results[I] = *Mem.atomicWait<uint32_t>(16, 0, -1);
+    });
+  }
+  /// Notify until all threads are woken, as they may not wait yet.
+  uint32_t Woken = 0;
+  while (Waiting.load() < N) {
+    std::this_thread::yield();
+  }
+  while (Woken < N) {
+    const uint32_t Count = *Mem.atomicNotify(16, 2);
+    EXPECT_LE(Count, 2U);
+    Woken += Count;
+    std::this_thread::yield();
+  }
+  for (auto &Thread : Threads) {
+    Thread.join();
+  }
+  EXPECT_EQ(N, Woken);
+  for (uint32_t I = 0; I < N; ++I) {
+    EXPECT_EQ(0U, Results[I]);
+  }
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
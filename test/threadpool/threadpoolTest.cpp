@@ -0,0 +1,58 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/test/threadpool/threadpoolTest.cpp - thread pool unit tests --===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of the ThreadPool class.
+///
+//===----------------------------------------------------------------------===//
+
+#include "support/threadpool.h"
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <vector>
+
+namespace {
+
+SSVM::ThreadPool Pool(3);
+
+TEST(ThreadPoolTest, ParallelFor) {
+  /// 1. Test every task runs exactly once, for repeated loops.
+  EXPECT_EQ(4U, Pool.getConcurrency());
+  for (size_t N : {0, 1, 2, 7, 1000}) {
+    std::vector<std::atomic<uint32_t>> Counts(N);
+    Pool.parallelFor(N, [&](size_t I) { ++Counts[I]; });
+    for (size_t I = 0; I < N; ++I) {
+      EXPECT_EQ(1U, Counts[I].load());
+    }
+  }
+}
+
+TEST(ThreadPoolTest, NestedParallelFor) {
+  /// 2. Test nested loops run serially instead of dead locking.
+  std::atomic<uint32_t> Count = 0;
+  Pool.parallelFor(16, [&](size_t) {
+    Pool.parallelFor(16, [&](size_t) { ++Count; });
+  });
+  EXPECT_EQ(256U, Count.load());
+}
+
+TEST(ThreadPoolTest, SerialPool) {
+  /// 3. Test pool without workers.
+  SSVM::ThreadPool Serial(0);
+  EXPECT_EQ(1U, Serial.getConcurrency());
+  uint32_t Sum = 0;
+  Serial.parallelFor(10, [&](size_t I) { Sum += I; });
+  EXPECT_EQ(45U, Sum);
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
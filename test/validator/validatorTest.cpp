@@ -0,0 +1,250 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/test/validator/validatorTest.cpp - Validator unit tests ------===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of validating function bodies of modules.
+///
+//===----------------------------------------------------------------------===//
+
+#include "common/ast/module.h"
+#include "loader/filemgr.h"
+#include "validator/validator.h"
+#include "gtest/gtest.h"
+
+#include <vector>
+
+namespace {
+
+SSVM::FileMgrVector Mgr;
+
+/// Number of functions, which is large enough to be validated in parallel.
+constexpr uint32_t kCount = 20000;
+
+void appendU32(std::vector<unsigned char> &Vec, uint32_t N) {
+  do {
+    unsigned char Byte = N & 0x7FU;
+    N >>= 7;
+    Vec.push_back(N ? (Byte | 0x80U) : Byte);
+  } while (N);
+}
+
+void appendSection(std::vector<unsigned char> &Vec, unsigned char Id,
+                   const std::vector<unsigned char> &Content) {
+  Vec.push_back(Id);
+  appendU32(Vec, Content.size());
+  Vec.insert(Vec.end(), Content.begin(), Content.end());
+}
+
+/// Make module with functions returning i32, one of them reads an undefined
+/// local instead.
+std::vector<unsigned char> makeModule(uint32_t Invalid) {
+  std::vector<unsigned char> Vec = {
+      0x00U, 0x61U, 0x73U, 0x6DU, /// Magic
+      0x01U, 0x00U, 0x00U, 0x00U  /// Version
+  };
+  appendSection(Vec, 0x01U, {0x01U, 0x60U, 0x00U, 0x01U, 0x7FU});
+  std::vector<unsigned char> Funcs, Codes;
+  appendU32(Funcs, kCount);
+  appendU32(Codes, kCount);
+  for (uint32_t I = 0; I < kCount; ++I) {
+    Funcs.push_back(0x00U);
+    Codes.insert(Codes.end(), {
+                                  0x04U,        /// Segment size
+                                  0x00U,        /// Local vec(0)
+                                  0x41U, 0x00U, /// i32.const 0
+                                  0x0BU         /// End
+                              });
+    if (I == Invalid) {
+      Codes[Codes.size() - 3] = 0x20U; /// local.get 0
+    }
+  }
+  appendSection(Vec, 0x03U, Funcs);
+  appendSection(Vec, 0x0AU, Codes);
+  return Vec;
+}
+
+TEST(ValidatorTest, ValidateFunctionBodies) {
+  /// 1. Test validate many function bodies.
+  ///
+  ///   1.  Validate module with valid function bodies.
+  ///   2.  Validate module with an invalid function body.
+  SSVM::Validator::Validator Valid;
+
+  Mgr.setCode(makeModule(kCount));
+  SSVM::AST::Module Mod1;
+  ASSERT_TRUE(Mod1.loadBinary(Mgr));
+  EXPECT_TRUE(Valid.validate(Mod1));
+  EXPECT_FALSE(Valid.getCodeValidator());
+
+  Mgr.setCode(makeModule(15000));
+  SSVM::AST::Module Mod2;
+  ASSERT_TRUE(Mod2.loadBinary(Mgr));
+  auto Res2 = Valid.validate(Mod2);
+  ASSERT_FALSE(Res2);
+  EXPECT_EQ(SSVM::ErrCode::ValidationFailed, Res2.error());
+
+  /// The validator is reusable after a failure.
+  EXPECT_TRUE(Valid.validate(Mod1));
+}
+
+TEST(ValidatorTest, ValidateLazyFunctionBodies) {
+  /// 2. Test validate function bodies decoded after module validation.
+  ///
+  ///   1.  Validate lazily loaded module with an invalid function body.
+  ///   2.  Validate the decoded valid and invalid function bodies.
+  SSVM::Validator::Validator Valid;
+
+  Mgr.setCode(makeModule(15000));
+  SSVM::AST::Module Mod;
+  Mod.setLazyCode(true);
+  ASSERT_TRUE(Mod.loadBinary(Mgr));
+  EXPECT_TRUE(Valid.validate(Mod));
+  const auto CodeValidator = Valid.getCodeValidator();
+  ASSERT_TRUE(CodeValidator);
+
+  auto &Segs = Mod.getCodeSection()->getContent();
+  ASSERT_TRUE(Segs[0]->loadBody(Segs[0]->getDeferredBody()));
+  EXPECT_TRUE(CodeValidator(*Segs[0], 0));
+  ASSERT_TRUE(Segs[15000]->loadBody(Segs[15000]->getDeferredBody()));
+  EXPECT_FALSE(CodeValidator(*Segs[15000], 0));
+}
+
+/// Make module with a funcref table and an externref table, and a function
+/// which returns ref.func of itself.
+std::vector<unsigned char> makeRefModule(bool Declared) {
+  std::vector<unsigned char> Vec = {
+      0x00U, 0x61U, 0x73U, 0x6DU, /// Magic
+      0x01U, 0x00U, 0x00U, 0x00U  /// Version
+  };
+  appendSection(Vec, 0x01U, {0x01U, 0x60U, 0x00U, 0x01U, 0x70U});
+  appendSection(Vec, 0x03U, {0x01U, 0x00U});
+  appendSection(Vec, 0x04U, {0x02U, 0x70U, 0x00U, 0x01U, 0x6FU, 0x00U, 0x00U});
+  if (Declared) {
+    /// Declarative element segment of function 0.
+    appendSection(Vec, 0x09U, {0x01U, 0x03U, 0x00U, 0x01U, 0x00U});
+  }
+  appendSection(Vec, 0x0AU, {
+                                0x01U,        /// Vector length = 1
+                                0x04U,        /// Segment size
+                                0x00U,        /// Local vec(0)
+                                0xD2U, 0x00U, /// ref.func 0
+                                0x0BU         /// End
+                            });
+  return Vec;
+}
+
+TEST(ValidatorTest, ValidateReferenceTypes) {
+  /// 3. Test validate reference types and multiple tables.
+  ///
+  ///   1.  Validate module with ref.func of a declared function.
+  ///   2.  Validate module with ref.func of an undeclared function.
+  SSVM::Validator::Validator Valid;
+
+  Mgr.setCode(makeRefModule(true));
+  SSVM::AST::Module Mod1;
+  ASSERT_TRUE(Mod1.loadBinary(Mgr));
+  EXPECT_TRUE(Valid.validate(Mod1));
+
+  Mgr.setCode(makeRefModule(false));
+  SSVM::AST::Module Mod2;
+  ASSERT_TRUE(Mod2.loadBinary(Mgr));
+  EXPECT_FALSE(Valid.validate(Mod2));
+}
+
+std::vector<unsigned char> makeTailCallModule(unsigned char CalleeResult) {
+  /// i32.const or i64.const of the callee result.
+  const unsigned char CalleeConst = CalleeResult == 0x7FU ? 0x41U : 0x42U;
+  std::vector<unsigned char> Vec = {
+      0x00U, 0x61U, 0x73U, 0x6DU, /// Magic
+      0x01U, 0x00U, 0x00U, 0x00U  /// Version
+  };
+  appendSection(Vec, 0x01U,
+                {0x02U, 0x60U, 0x00U, 0x01U, 0x7FU, 0x60U, 0x00U, 0x01U,
+                 CalleeResult});
+  appendSection(Vec, 0x03U, {0x02U, 0x00U, 0x01U});
+  appendSection(Vec, 0x0AU, {
+                                0x02U,        /// Vector length = 2
+                                0x04U,        /// Segment size
+                                0x00U,        /// Local vec(0)
+                                0x12U, 0x01U, /// return_call 1
+                                0x0BU,        /// End
+                                0x04U,        /// Segment size
+                                0x00U,        /// Local vec(0)
+                                CalleeConst,  /// i32.const or i64.const
+                                0x00U,        /// 0
+                                0x0BU /// End
+                            });
+  return Vec;
+}
+
+TEST(ValidatorTest, ValidateTailCalls) {
+  /// 4. Test validate tail calls.
+  ///
+  ///   1.  Validate return_call of a function with the same results.
+  ///   2.  Validate return_call of a function with different results.
+  SSVM::Validator::Validator Valid;
+
+  Mgr.setCode(makeTailCallModule(0x7FU));
+  SSVM::AST::Module Mod1;
+  ASSERT_TRUE(Mod1.loadBinary(Mgr));
+  EXPECT_TRUE(Valid.validate(Mod1));
+
+  Mgr.setCode(makeTailCallModule(0x7EU));
+  SSVM::AST::Module Mod2;
+  ASSERT_TRUE(Mod2.loadBinary(Mgr));
+  EXPECT_FALSE(Valid.validate(Mod2));
+}
+
+std::vector<unsigned char> makeMultiValueModule(unsigned char TypeIdx) {
+  std::vector<unsigned char> Vec = {
+      0x00U, 0x61U, 0x73U, 0x6DU, /// Magic
+      0x01U, 0x00U, 0x00U, 0x00U  /// Version
+  };
+  /// Types: [] -> [i32 i32], [i32 i32] -> [i32].
+  appendSection(Vec, 0x01U,
+                {0x02U, 0x60U, 0x00U, 0x02U, 0x7FU, 0x7FU, 0x60U, 0x02U, 0x7FU,
+                 0x7FU, 0x01U, 0x7FU});
+  appendSection(Vec, 0x03U, {0x01U, 0x00U});
+  appendSection(Vec, 0x0AU, {
+                                0x01U,          /// Vector length = 1
+                                0x0CU,          /// Segment size
+                                0x00U,          /// Local vec(0)
+                                0x41U, 0x01U,   /// i32.const 1
+                                0x41U, 0x02U,   /// i32.const 2
+                                0x02U, TypeIdx, /// block with type index
+                                0x6AU,          /// i32.add
+                                0x0BU,          /// End of block
+                                0x41U, 0x03U,   /// i32.const 3
+                                0x0BU           /// End
+                            });
+  return Vec;
+}
+
+TEST(ValidatorTest, ValidateMultiValue) {
+  /// 5. Test validate multi-value functions and blocks.
+  ///
+  ///   1.  Validate block with parameters from type index.
+  ///   2.  Validate block with type index out of range.
+  SSVM::Validator::Validator Valid;
+
+  Mgr.setCode(makeMultiValueModule(0x01U));
+  SSVM::AST::Module Mod1;
+  ASSERT_TRUE(Mod1.loadBinary(Mgr));
+  EXPECT_TRUE(Valid.validate(Mod1));
+
+  Mgr.setCode(makeMultiValueModule(0x02U));
+  SSVM::AST::Module Mod2;
+  ASSERT_TRUE(Mod2.loadBinary(Mgr));
+  EXPECT_FALSE(Valid.validate(Mod2));
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
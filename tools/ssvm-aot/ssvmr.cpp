@@ -1,31 +1,98 @@
 // SPDX-License-Identifier: Apache-2.0
 #include "common/value.h"
+#include "host/wasi/vfs.h"
 #include "host/wasi/wasimodule.h"
 #include "support/filesystem.h"
 #include "vm/configure.h"
 #include "vm/vm.h"
 #include <cstdlib>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
 
 int main(int Argc, char *Argv[]) {
-  if (Argc < 2) {
+  SSVM::VM::Configure Conf;
+  Conf.addVMType(SSVM::VM::Configure::VMType::Wasi);
+  int ArgBase = 1;
+  while (ArgBase < Argc) {
+    const std::string_view Option(Argv[ArgBase]);
+    if (Option == "--mem-dir" && ArgBase + 1 < Argc) {
+      /// Preopen GUEST_DIR in memory, with a copy of HOST_DIR if given. The
+      /// writes of the guest never reach the host.
+      const std::string_view Spec(Argv[ArgBase + 1]);
+      const size_t Pos = Spec.find(':');
+      auto Image = std::make_shared<SSVM::Host::MemoryImage>();
+      if (Pos != std::string_view::npos &&
+          !Image->addHostDirectory("", std::string(Spec.substr(Pos + 1)))) {
+        std::cerr << "Failed to load the directory " << Spec.substr(Pos + 1)
+                  << std::endl;
+        return EXIT_FAILURE;
+      }
+      Conf.addMemoryPreopen(std::string(Spec.substr(0, Pos)),
+                            std::move(Image));
+      ArgBase += 2;
+    } else if (Option == "--write-buffer" && ArgBase + 1 < Argc) {
+      /// Buffer the writes of stdout and stderr, flushed on every newline
+      /// for "line" or when SIZE bytes are pending for "full".
+      const std::string_view Spec(Argv[ArgBase + 1]);
+      const size_t Pos = Spec.find(':');
+      const std::string_view Mode = Spec.substr(0, Pos);
+      size_t Capacity = 4096;
+      if (Pos != std::string_view::npos) {
+        Capacity = std::strtoull(std::string(Spec.substr(Pos + 1)).c_str(),
+                                 nullptr, 10);
+      }
+      if (Mode == "line" && Capacity > 0) {
+        Conf.setWriteBuffer(SSVM::VM::Configure::WriteBufferMode::Line,
+                            Capacity);
+      } else if (Mode == "full" && Capacity > 0) {
+        Conf.setWriteBuffer(SSVM::VM::Configure::WriteBufferMode::Full,
+                            Capacity);
+      } else {
+        std::cerr << "Invalid write buffer " << Spec << std::endl;
+        return EXIT_FAILURE;
+      }
+      ArgBase += 2;
+    } else if (Option == "--frozen-clock") {
+      /// Read the same realtime and monotonic time during the whole run.
+      Conf.setFrozenClock(true);
+      ArgBase += 1;
+    } else if (Option == "--random-reseed" && ArgBase + 1 < Argc) {
+      /// Take a fresh random_get key from the system every BYTES bytes, or
+      /// at every call for 0.
+      const std::string Spec(Argv[ArgBase + 1]);
+      char *End = nullptr;
+      const uint64_t Bytes = std::strtoull(Spec.c_str(), &End, 10);
+      if (Spec.empty() || *End != '\0') {
+        std::cerr << "Invalid random reseed interval " << Spec << std::endl;
+        return EXIT_FAILURE;
+      }
+      Conf.setRandomReseedInterval(Bytes);
+      ArgBase += 2;
+    } else {
+      break;
+    }
+  }
+  if (Argc < ArgBase + 1) {
     /// Arg0: ./ssvmr
     /// Arg1: so file
     /// Arg2...: inputs
-    std::cout << "Usage: ./ssvmr wasm_so.so [args...]" << std::endl;
+    std::cout << "Usage: ./ssvmr [--mem-dir GUEST_DIR[:HOST_DIR]] "
+                 "[--write-buffer line|full[:SIZE]] [--frozen-clock] "
+                 "[--random-reseed BYTES] wasm_so.so [args...]"
+              << std::endl;
     return 0;
   }
 
-  std::string InputPath = std::filesystem::absolute(Argv[1]).string();
-  SSVM::VM::Configure Conf;
-  Conf.addVMType(SSVM::VM::Configure::VMType::Wasi);
+  std::string InputPath = std::filesystem::absolute(Argv[ArgBase]).string();
   SSVM::VM::VM VM(Conf);
 
   SSVM::Host::WasiModule *WasiMod = dynamic_cast<SSVM::Host::WasiModule *>(
       VM.getImportModule(SSVM::VM::Configure::VMType::Wasi));
 
   std::vector<std::string> &CmdArgsVec = WasiMod->getEnv().getCmdArgs();
-  for (int I = 1; I < Argc; I++) {
+  for (int I = ArgBase; I < Argc; I++) {
     CmdArgsVec.push_back(std::string(Argv[I]));
   }
   for (auto It = CmdArgsVec.begin(); It != CmdArgsVec.end(); It++) {
@@ -0,0 +1,77 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "bench.h"
+#include "support/filesystem.h"
+
+#ifdef SSVM_BENCH_AOT
+#include "aot/compiler.h"
+#include "loader/loader.h"
+#endif
+
+#include <algorithm>
+#include <cmath>
+
+namespace SSVM {
+namespace Bench {
+
+/// Summarize samples. See "tools/ssvm-bench/bench.h".
+Stats computeStats(const std::vector<double> &Samples) {
+  Stats S;
+  if (Samples.empty()) {
+    return S;
+  }
+  double Sum = 0.0;
+  for (const double V : Samples) {
+    Sum += V;
+  }
+  S.Mean = Sum / Samples.size();
+  double SqSum = 0.0;
+  for (const double V : Samples) {
+    SqSum += (V - S.Mean) * (V - S.Mean);
+  }
+  S.Stddev = Samples.size() > 1 ? std::sqrt(SqSum / (Samples.size() - 1)) : 0.0;
+  const auto [Min, Max] = std::minmax_element(Samples.begin(), Samples.end());
+  S.Min = *Min;
+  S.Max = *Max;
+  return S;
+}
+
+/// Compile wasm into shared library. See "tools/ssvm-bench/bench.h".
+Expect<std::string> compileAOT(const Bytes &Wasm, const std::string &Name) {
+#ifdef SSVM_BENCH_AOT
+  Loader::Loader LoaderEngine;
+  std::unique_ptr<AST::Module> Module;
+  if (auto Res = LoaderEngine.parseModule(Wasm)) {
+    Module = std::move(*Res);
+  } else {
+    return Unexpect(Res);
+  }
+  const std::string Path = (std::filesystem::temp_directory_path() /
+                            ("ssvm-bench-" + Name + ".so"))
+                               .string();
+  AOT::Compiler Compiler;
+  if (auto Res = Compiler.compile(Wasm, *Module, Path); !Res) {
+    return Unexpect(Res);
+  }
+  return Path;
+#else
+  return Unexpect(ErrCode::InvalidPath);
+#endif
+}
+
+/// Compile wasm file into shared library. See "tools/ssvm-bench/bench.h".
+Expect<std::string> compileAOT(const std::string &Path,
+                               const std::string &Name) {
+#ifdef SSVM_BENCH_AOT
+  Loader::Loader LoaderEngine;
+  if (auto Res = LoaderEngine.loadFile(Path)) {
+    return compileAOT(*Res, Name);
+  } else {
+    return Unexpect(Res);
+  }
+#else
+  return Unexpect(ErrCode::InvalidPath);
+#endif
+}
+
+} // namespace Bench
+} // namespace SSVM
@@ -0,0 +1,93 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/tools/ssvm-bench/bench.h - Benchmark harness definitions -----===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the declarations shared by the micro benchmark, macro
+/// benchmark, and result comparison modes of ssvm-bench.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "common/errcode.h"
+#include "common/value.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace SSVM {
+namespace Bench {
+
+/// Execution modes.
+enum class RunMode : uint8_t { Interpreter, AOT };
+
+inline std::string_view toString(RunMode Mode) {
+  return Mode == RunMode::Interpreter ? "interpreter" : "aot";
+}
+
+/// Command line options.
+struct Options {
+  bool RunInterpreter = true;
+  bool RunAOT = false;
+  /// Micro benchmark: loop iterations per sample.
+  uint32_t Iterations = 100000;
+  /// Micro benchmark: samples per kernel. Macro benchmark: runs per guest.
+  uint32_t Samples = 10;
+  std::string Filter;
+  std::string OutputPath;
+  std::string WatDir;
+  bool List = false;
+  /// Macro benchmark mode and the optional manifest of external guests.
+  bool Macro = false;
+  std::string Manifest;
+  /// Macro benchmark: decode function bodies on their first call.
+  bool Lazy = false;
+  /// Loader benchmark mode: directory of modules to parse.
+  std::string LoaderDir;
+  /// Comparison mode: baseline and new result files.
+  std::string CompareBase;
+  std::string CompareNew;
+  /// Comparison mode: allowed slowdown in percent.
+  double Threshold = 5.0;
+
+  std::vector<RunMode> getModes() const {
+    std::vector<RunMode> Modes;
+    if (RunInterpreter) {
+      Modes.push_back(RunMode::Interpreter);
+    }
+    if (RunAOT) {
+      Modes.push_back(RunMode::AOT);
+    }
+    return Modes;
+  }
+};
+
+/// Summary of samples.
+struct Stats {
+  double Mean = 0.0;
+  double Stddev = 0.0;
+  double Min = 0.0;
+  double Max = 0.0;
+};
+
+/// Summarize samples with mean, sample standard deviation, min, and max.
+Stats computeStats(const std::vector<double> &Samples);
+
+/// Compile wasm into a shared library and return its path. Only available
+/// when built with the AOT runtime.
+Expect<std::string> compileAOT(const Bytes &Wasm, const std::string &Name);
+Expect<std::string> compileAOT(const std::string &Path, const std::string &Name);
+
+/// Entries of the benchmark modes. Return the process exit code.
+int runMicro(const Options &Opt);
+int runMacro(const Options &Opt);
+int runLoader(const Options &Opt);
+int runCompare(const Options &Opt);
+
+} // namespace Bench
+} // namespace SSVM
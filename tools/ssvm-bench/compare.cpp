@@ -0,0 +1,126 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "bench.h"
+#include "json.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <utility>
+
+namespace SSVM {
+namespace Bench {
+
+namespace {
+
+using Metrics = std::vector<std::pair<std::string, double>>;
+
+std::optional<JSONValue> readResult(const std::string &Path) {
+  std::ifstream Fin(Path);
+  if (!Fin) {
+    std::cerr << "Failed to open " << Path << std::endl;
+    return std::nullopt;
+  }
+  std::stringstream Buf;
+  Buf << Fin.rdbuf();
+  auto Doc = JSONValue::parse(Buf.str());
+  if (!Doc || Doc->getKind() != JSONValue::Kind::Object) {
+    std::cerr << "Malformed result file " << Path << std::endl;
+    return std::nullopt;
+  }
+  return Doc;
+}
+
+/// Flatten result file into lower-is-better metrics keyed by workload, mode,
+/// and metric name.
+Metrics collectMetrics(const JSONValue &Doc) {
+  Metrics M;
+  const JSONValue *Results = Doc.get("results");
+  if (!Results || Results->getKind() != JSONValue::Kind::Array) {
+    return M;
+  }
+  const std::string Format = Doc.getString("format");
+  const bool IsMacro = Format == "ssvm-bench-macro";
+  const bool IsLoader = Format == "ssvm-bench-loader";
+  for (const auto &R : Results->getElements()) {
+    const std::string Prefix =
+        IsLoader ? R.getString("manager")
+                 : R.getString(IsMacro ? "guest" : "kernel") + "/" +
+                       R.getString("mode");
+    const auto AddMean = [&](std::string_view Name) {
+      if (const auto *S = R.get(Name)) {
+        if (auto Mean = S->getNumber("mean")) {
+          M.emplace_back(Prefix + "/" + std::string(Name), *Mean);
+        }
+      }
+    };
+    if (IsMacro) {
+      AddMean("load_us");
+      AddMean("validate_us");
+      AddMean("instantiate_us");
+      AddMean("execute_us");
+      if (auto RSS = R.getNumber("peak_rss_kib")) {
+        M.emplace_back(Prefix + "/peak_rss_kib", *RSS);
+      }
+    } else if (IsLoader) {
+      AddMean("ns_per_byte");
+      AddMean("free_ns_per_byte");
+      if (auto Allocs = R.getNumber("allocs_per_module")) {
+        M.emplace_back(Prefix + "/allocs_per_module", *Allocs);
+      }
+    } else {
+      AddMean("ns_per_op");
+    }
+  }
+  return M;
+}
+
+} // namespace
+
+/// Compare result files. See "tools/ssvm-bench/bench.h".
+int runCompare(const Options &Opt) {
+  const auto Base = readResult(Opt.CompareBase);
+  const auto New = readResult(Opt.CompareNew);
+  if (!Base || !New) {
+    return EXIT_FAILURE;
+  }
+  if (Base->getString("format") != New->getString("format")) {
+    std::cerr << "Result files have different formats." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const Metrics BaseM = collectMetrics(*Base);
+  const Metrics NewM = collectMetrics(*New);
+  uint32_t Regressions = 0;
+  std::cout << std::fixed << std::setprecision(3);
+  for (const auto &[Key, BaseVal] : BaseM) {
+    auto It = std::find_if(NewM.begin(), NewM.end(),
+                           [&Key = Key](const auto &P) { return P.first == Key; });
+    if (It == NewM.end()) {
+      std::cout << Key << ": missing in " << Opt.CompareNew << std::endl;
+      continue;
+    }
+    const double NewVal = It->second;
+    const double Delta =
+        BaseVal > 0.0 ? (NewVal - BaseVal) / BaseVal * 100.0 : 0.0;
+    const bool Regressed = Delta > Opt.Threshold;
+    if (Regressed) {
+      ++Regressions;
+    }
+    std::cout << Key << ": " << BaseVal << " -> " << NewVal << " ("
+              << std::showpos << Delta << std::noshowpos << "%)"
+              << (Regressed ? " REGRESSION" : "") << std::endl;
+  }
+
+  if (Regressions > 0) {
+    std::cout << Regressions << " metric(s) regressed more than "
+              << Opt.Threshold << "%." << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+} // namespace Bench
+} // namespace SSVM
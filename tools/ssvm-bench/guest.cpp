@@ -0,0 +1,691 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "guest.h"
+#include "kernel.h"
+
+#include "support/filesystem.h"
+
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+
+namespace SSVM {
+namespace Bench {
+
+namespace {
+
+/// Local indices shared by the kernel skeleton. See "tools/ssvm-bench/kernel.h".
+constexpr uint32_t kLocalI64 = 2;
+
+FuncBuilder &get(FuncBuilder &B, uint32_t Local) {
+  return B.index("local.get", 0x20, Local);
+}
+FuncBuilder &set(FuncBuilder &B, uint32_t Local) {
+  return B.index("local.set", 0x21, Local);
+}
+/// Push `rotr(Local, N)`.
+FuncBuilder &rotr(FuncBuilder &B, uint32_t Local, uint32_t N) {
+  return get(B, Local).i32Const(N).op("i32.rotr", 0x78);
+}
+/// Emit `Local += Step; br_if 0 (Local < End)` closing a do-while loop.
+FuncBuilder &next(FuncBuilder &B, uint32_t Local, uint32_t Step,
+                  uint32_t End) {
+  get(B, Local).i32Const(Step).op("i32.add", 0x6A);
+  B.index("local.tee", 0x22, Local).i32Const(End).op("i32.lt_u", 0x49);
+  return B.index("br_if", 0x0D, 0).end();
+}
+
+template <typename T> void append(Bytes &Buf, T Val) {
+  uint8_t Raw[sizeof(T)];
+  std::memcpy(Raw, &Val, sizeof(T));
+  Buf.insert(Buf.end(), Raw, Raw + sizeof(T));
+}
+
+/// Dense 16x16 f64 matrix multiplication: C = A * B, hashing the bits of C
+/// into the i64 accumulator.
+Guest makeMatmul() {
+  constexpr uint32_t N = 16;
+  constexpr uint32_t Row = N * 8;
+  constexpr uint32_t OffB = N * Row;
+  constexpr uint32_t OffC = OffB * 2;
+  /// Extra locals: row offset I, column offset J, inner offset K, and sum.
+  constexpr uint32_t I = 5, J = 6, K = 7, Sum = 8;
+
+  FuncBuilder B;
+  B.i32Const(0);
+  set(B, I).block("loop", 0x03);
+  B.i32Const(0);
+  set(B, J).block("loop", 0x03);
+  B.f64Const(0.0);
+  set(B, Sum).i32Const(0);
+  set(B, K).block("loop", 0x03);
+  get(B, Sum);
+  get(B, I);
+  get(B, K).op("i32.add", 0x6A).mem("f64.load", 0x2B, 3, 0);
+  get(B, K).i32Const(4).op("i32.shl", 0x74);
+  get(B, J).op("i32.add", 0x6A).mem("f64.load", 0x2B, 3, OffB);
+  B.op("f64.mul", 0xA2).op("f64.add", 0xA0);
+  set(B, Sum);
+  next(B, K, 8, Row);
+  get(B, I);
+  get(B, J).op("i32.add", 0x6A);
+  get(B, Sum).mem("f64.store", 0x39, 3, OffC);
+  get(B, kLocalI64).i64Const(7).op("i64.rotl", 0x89);
+  get(B, Sum).op("i64.reinterpret_f64", 0xBD).op("i64.add", 0x7C);
+  set(B, kLocalI64);
+  next(B, J, 8, Row);
+  next(B, I, Row, N * Row);
+  /// Result: the folded hash.
+  get(B, kLocalI64);
+  get(B, kLocalI64).i64Const(32).op("i64.shr_u", 0x88).op("i64.xor", 0x85);
+  B.op("i32.wrap_i64", 0xA7);
+  set(B, 1);
+
+  DataSegment A{0, {}}, BMat{OffB, {}};
+  for (uint32_t Idx = 0; Idx < N * N; ++Idx) {
+    append(A.Data, ((Idx * 3) % 7) * 0.125);
+    append(BMat.Data, ((Idx / N + 2 * (Idx % N)) % 5) * 0.25);
+  }
+
+  Guest G;
+  G.Name = "matmul";
+  G.Wasm = makeKernel("matmul", "macro", B, 0,
+                      {ValType::I32, ValType::I32, ValType::I32, ValType::F64},
+                      {A, BMat})
+               .Wasm;
+  G.Arg = 200;
+  G.Expected = UINT32_C(1999035144);
+  return G;
+}
+
+/// SHA-256 compression function applied repeatedly to one 64-byte block. The
+/// result is the first word of the chained hash state.
+Guest makeSHA256() {
+  constexpr uint32_t OffK = 0, OffW = 256, OffH = 512, OffMsg = 1024;
+  /// Extra locals: working variables a to h, t1, t2, and the offset P.
+  constexpr uint32_t VA = 5, T1 = 13, T2 = 14, P = 15;
+  const auto Var = [](char C) -> uint32_t { return VA + (C - 'a'); };
+
+  FuncBuilder B;
+  /// W[0..15] from the big-endian message words.
+  B.i32Const(0);
+  set(B, P).block("loop", 0x03);
+  get(B, P);
+  get(B, P).mem("i32.load8_u", 0x2D, 0, OffMsg);
+  B.i32Const(24).op("i32.shl", 0x74);
+  get(B, P).mem("i32.load8_u", 0x2D, 0, OffMsg + 1);
+  B.i32Const(16).op("i32.shl", 0x74).op("i32.or", 0x72);
+  get(B, P).mem("i32.load8_u", 0x2D, 0, OffMsg + 2);
+  B.i32Const(8).op("i32.shl", 0x74).op("i32.or", 0x72);
+  get(B, P).mem("i32.load8_u", 0x2D, 0, OffMsg + 3);
+  B.op("i32.or", 0x72).mem("i32.store", 0x36, 2, OffW);
+  next(B, P, 4, 64);
+
+  /// W[16..63]. P is the offset of W[i-16].
+  B.i32Const(0);
+  set(B, P).block("loop", 0x03);
+  get(B, P);
+  get(B, P).mem("i32.load", 0x28, 2, OffW);
+  for (const auto &[Off, R1, R2, S] :
+       {std::tuple<uint32_t, uint32_t, uint32_t, uint32_t>{4, 7, 18, 3},
+        std::tuple<uint32_t, uint32_t, uint32_t, uint32_t>{56, 17, 19, 10}}) {
+    get(B, P).mem("i32.load", 0x28, 2, OffW + Off);
+    set(B, T1);
+    rotr(B, T1, R1);
+    rotr(B, T1, R2).op("i32.xor", 0x73);
+    get(B, T1).i32Const(S).op("i32.shr_u", 0x76).op("i32.xor", 0x73);
+    B.op("i32.add", 0x6A);
+    if (Off == 4) {
+      get(B, P).mem("i32.load", 0x28, 2, OffW + 36);
+      B.op("i32.add", 0x6A);
+    }
+  }
+  B.mem("i32.store", 0x36, 2, OffW + 64);
+  next(B, P, 4, 192);
+
+  /// Load the hash state.
+  for (char C = 'a'; C <= 'h'; ++C) {
+    B.i32Const(0).mem("i32.load", 0x28, 2, OffH + (C - 'a') * 4);
+    set(B, Var(C));
+  }
+
+  /// 64 rounds.
+  B.i32Const(0);
+  set(B, P).block("loop", 0x03);
+  get(B, Var('h'));
+  rotr(B, Var('e'), 6);
+  rotr(B, Var('e'), 11).op("i32.xor", 0x73);
+  rotr(B, Var('e'), 25).op("i32.xor", 0x73).op("i32.add", 0x6A);
+  get(B, Var('e'));
+  get(B, Var('f')).op("i32.and", 0x71);
+  get(B, Var('e')).i32Const(-1).op("i32.xor", 0x73);
+  get(B, Var('g')).op("i32.and", 0x71).op("i32.xor", 0x73);
+  B.op("i32.add", 0x6A);
+  get(B, P).mem("i32.load", 0x28, 2, OffK).op("i32.add", 0x6A);
+  get(B, P).mem("i32.load", 0x28, 2, OffW).op("i32.add", 0x6A);
+  set(B, T1);
+  rotr(B, Var('a'), 2);
+  rotr(B, Var('a'), 13).op("i32.xor", 0x73);
+  rotr(B, Var('a'), 22).op("i32.xor", 0x73);
+  get(B, Var('a'));
+  get(B, Var('b')).op("i32.and", 0x71);
+  get(B, Var('a'));
+  get(B, Var('c')).op("i32.and", 0x71).op("i32.xor", 0x73);
+  get(B, Var('b'));
+  get(B, Var('c')).op("i32.and", 0x71).op("i32.xor", 0x73);
+  B.op("i32.add", 0x6A);
+  set(B, T2);
+  for (const char *Move : {"hg", "gf", "fe"}) {
+    get(B, Var(Move[1]));
+    set(B, Var(Move[0]));
+  }
+  get(B, Var('d'));
+  get(B, T1).op("i32.add", 0x6A);
+  set(B, Var('e'));
+  for (const char *Move : {"dc", "cb", "ba"}) {
+    get(B, Var(Move[1]));
+    set(B, Var(Move[0]));
+  }
+  get(B, T1);
+  get(B, T2).op("i32.add", 0x6A);
+  set(B, Var('a'));
+  next(B, P, 4, 256);
+
+  /// Add the working variables into the hash state.
+  for (char C = 'a'; C <= 'h'; ++C) {
+    const uint32_t Off = OffH + (C - 'a') * 4;
+    B.i32Const(0).i32Const(0).mem("i32.load", 0x28, 2, Off);
+    get(B, Var(C)).op("i32.add", 0x6A).mem("i32.store", 0x36, 2, Off);
+  }
+  /// Result: H[0].
+  B.i32Const(0).mem("i32.load", 0x28, 2, OffH);
+  set(B, 1);
+
+  static const uint32_t KTab[64] = {
+      0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+      0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+      0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+      0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+      0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+      0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+      0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+      0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+      0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+      0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+      0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+  static const uint32_t HInit[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372,
+                                    0xa54ff53a, 0x510e527f, 0x9b05688c,
+                                    0x1f83d9ab, 0x5be0cd19};
+  DataSegment K{OffK, {}}, H{OffH, {}}, Msg{OffMsg, {}};
+  for (const auto Val : KTab) {
+    append(K.Data, Val);
+  }
+  for (const auto Val : HInit) {
+    append(H.Data, Val);
+  }
+  for (uint32_t Idx = 0; Idx < 64; ++Idx) {
+    Msg.Data.push_back(static_cast<uint8_t>(Idx * 7 + 3));
+  }
+
+  std::vector<ValType> Locals(11, ValType::I32);
+  Guest G;
+  G.Name = "sha256";
+  G.Wasm = makeKernel("sha256", "macro", B, 0, Locals, {K, H, Msg}).Wasm;
+  G.Arg = 2000;
+  G.Expected = UINT32_C(1299193993);
+  return G;
+}
+
+/// JSON scanner over a generated document of nested records. The bytes are
+/// dispatched with br_table on a character class table, as table-driven
+/// parsers do. Strings with escapes are skipped and hashed, digit runs are
+/// parsed and summed, and the nesting depth is tracked.
+Guest makeJSON() {
+  constexpr uint32_t OffClass = 0, OffDoc = 256;
+  enum : uint8_t { Other = 0, Open, Close, Quote, Digit };
+  /// Extra locals: offset P, current byte, depth, string hash, number sum,
+  /// and the number being parsed.
+  constexpr uint32_t P = 5, Byte = 6, Depth = 7, Hash = 8, Sum = 9, Num = 10;
+
+  std::string Doc = "[";
+  for (uint32_t I = 0; I < 40; ++I) {
+    Doc += I == 0 ? "\n" : ",\n";
+    Doc += "  {\"id\": " + std::to_string(I * 37 + 1) +
+           ", \"name\": \"item \\\"" + std::to_string(I) +
+           "\\\"\", \"price\": -" +
+           std::to_string(I % 13) + "." + std::to_string(I % 7) +
+           "5e2, \"ok\": " + (I % 3 == 0 ? "true" : "false") +
+           ", \"tags\": [\"t" + std::to_string(I % 5) +
+           "\", null], \"pos\": {\"x\": " + std::to_string(I * I) +
+           ", \"y\": [" + std::to_string(I) + ", " + std::to_string(I + 1) +
+           "]}}";
+  }
+  Doc += "\n]\n";
+  const uint32_t Len = static_cast<uint32_t>(Doc.size());
+
+  FuncBuilder B;
+  B.i32Const(0);
+  set(B, Hash).i32Const(0);
+  set(B, Sum).i32Const(0);
+  set(B, Depth).i32Const(0);
+  set(B, P).block("loop", 0x03);
+  B.block("block", 0x02).block("block", 0x02).block("block", 0x02);
+  B.block("block", 0x02).block("block", 0x02).block("block", 0x02);
+  get(B, P).mem("i32.load8_u", 0x2D, 0, OffDoc);
+  B.index("local.tee", 0x22, Byte).mem("i32.load8_u", 0x2D, 0, OffClass);
+  B.brTable({Other, Open, Close, Quote, Digit}, Other).end();
+  /// Other: whitespace, separators, and literals.
+  B.index("br", 0x0C, 4).end();
+  /// Open: '{' and '['.
+  get(B, Depth).i32Const(1).op("i32.add", 0x6A);
+  B.index("local.tee", 0x22, Depth);
+  get(B, Hash).i32Const(31).op("i32.mul", 0x6C).op("i32.add", 0x6A);
+  set(B, Hash).index("br", 0x0C, 3).end();
+  /// Close: '}' and ']'.
+  get(B, Depth).i32Const(1).op("i32.sub", 0x6B);
+  set(B, Depth).index("br", 0x0C, 2).end();
+  /// Quote: hash the string up to the closing quote, skipping escapes.
+  B.block("loop", 0x03);
+  get(B, P).i32Const(1).op("i32.add", 0x6A);
+  B.index("local.tee", 0x22, P).mem("i32.load8_u", 0x2D, 0, OffDoc);
+  B.index("local.tee", 0x22, Byte);
+  get(B, Hash).i32Const(5).op("i32.rotl", 0x77).op("i32.xor", 0x73);
+  set(B, Hash);
+  get(B, Byte).i32Const('\\').op("i32.eq", 0x46).block("if", 0x04);
+  get(B, P).i32Const(1).op("i32.add", 0x6A);
+  set(B, P).end();
+  get(B, Byte).i32Const('"').op("i32.ne", 0x47).index("br_if", 0x0D, 0);
+  B.end().index("br", 0x0C, 1).end();
+  /// Digit: parse the digit run.
+  B.i32Const(0);
+  set(B, Num).block("loop", 0x03);
+  get(B, Num).i32Const(10).op("i32.mul", 0x6C);
+  get(B, Byte).op("i32.add", 0x6A).i32Const('0').op("i32.sub", 0x6B);
+  set(B, Num);
+  get(B, P).i32Const(1).op("i32.add", 0x6A);
+  B.index("local.tee", 0x22, P).mem("i32.load8_u", 0x2D, 0, OffDoc);
+  B.index("local.tee", 0x22, Byte).mem("i32.load8_u", 0x2D, 0, OffClass);
+  B.i32Const(Digit).op("i32.eq", 0x46).index("br_if", 0x0D, 0).end();
+  get(B, Sum);
+  get(B, Num).op("i32.add", 0x6A);
+  set(B, Sum);
+  get(B, P).i32Const(1).op("i32.sub", 0x6B);
+  set(B, P).end();
+  next(B, P, 1, Len);
+  /// Result: fold the document checksum into the i32 accumulator.
+  get(B, 1).i32Const(7).op("i32.rotl", 0x77);
+  get(B, Hash);
+  get(B, Sum).op("i32.xor", 0x73).op("i32.add", 0x6A);
+  get(B, Depth).op("i32.add", 0x6A);
+  set(B, 1);
+
+  DataSegment Class{OffClass, Bytes(256, Other)},
+      Text{OffDoc, Bytes(Doc.begin(), Doc.end())};
+  Class.Data['{'] = Class.Data['['] = Open;
+  Class.Data['}'] = Class.Data[']'] = Close;
+  Class.Data['"'] = Quote;
+  for (char C = '0'; C <= '9'; ++C) {
+    Class.Data[static_cast<uint8_t>(C)] = Digit;
+  }
+
+  std::vector<ValType> Locals(6, ValType::I32);
+  Guest G;
+  G.Name = "json";
+  G.Wasm = makeKernel("json", "macro", B, 0, Locals, {Class, Text}).Wasm;
+  G.Arg = 200;
+  G.Expected = UINT32_C(3016197848);
+  return G;
+}
+
+/// Regular expression search of `[a-z][a-z0-9._]*@[a-z]+\.(com|org|net)` over
+/// a generated text. The pattern is compiled into its Glushkov automaton, and
+/// the engine runs the bit-parallel NFA simulation, with the follow sets of
+/// the active positions looked up a byte of states at a time.
+Guest makeRegex() {
+  constexpr uint32_t OffChar = 0, OffFollow0 = 1024, OffFollow1 = 2048,
+                     OffText = 3072;
+  /// Extra locals: offset P, active states D, match count, and state hash.
+  constexpr uint32_t P = 5, D = 6, Count = 7, Hash = 8;
+
+  /// Positions of the pattern with their characters and follow sets.
+  struct Position {
+    std::string_view Chars;
+    uint32_t Follow;
+  };
+  static const Position Positions[] = {
+      /// [a-z][a-z0-9._]*@
+      {"a-z", 0x0006},
+      {"a-z0-9._", 0x0006},
+      {"@", 0x0008},
+      /// [a-z]+\.
+      {"a-z", 0x0018},
+      {".", 0x0920},
+      /// com|org|net
+      {"c", 0x0040},
+      {"o", 0x0080},
+      {"m", 0x0000},
+      {"o", 0x0200},
+      {"r", 0x0400},
+      {"g", 0x0000},
+      {"n", 0x1000},
+      {"e", 0x2000},
+      {"t", 0x0000}};
+  constexpr uint32_t First = 0x0001, Final = 0x2480;
+
+  std::array<uint32_t, 256> CharMask = {}, Follow0 = {}, Follow1 = {};
+  for (uint32_t I = 0; I < std::size(Positions); ++I) {
+    const auto Chars = Positions[I].Chars;
+    for (size_t J = 0; J < Chars.size(); ++J) {
+      uint8_t Lo = Chars[J], Hi = Chars[J];
+      if (J + 2 < Chars.size() && Chars[J + 1] == '-') {
+        Hi = Chars[J + 2];
+        J += 2;
+      }
+      for (uint32_t C = Lo; C <= Hi; ++C) {
+        CharMask[C] |= UINT32_C(1) << I;
+      }
+    }
+    for (uint32_t S = 0; S < 256; ++S) {
+      if (I < 8 && (S >> I) & 1) {
+        Follow0[S] |= Positions[I].Follow;
+      } else if (I >= 8 && (S >> (I - 8)) & 1) {
+        Follow1[S] |= Positions[I].Follow;
+      }
+    }
+  }
+
+  /// Words of the text, with the matching and the almost matching addresses.
+  static const char *const Words[] = {
+      "lorem", "ipsum", "dolor@", "sit.", "amet,", "consectetur",
+      "alice@example.com", "bob.smith@mail.org", "c_3@host.net",
+      "bad@host.c0m", "@nobody.com", "x@y.comx", "Mixed@Host.org",
+      "a.b@c.d.net"};
+  std::string Str;
+  uint32_t Seed = 1;
+  while (Str.size() < 3000) {
+    Seed = Seed * 1103515245U + 12345U;
+    Str += Words[(Seed >> 16) % std::size(Words)];
+    Str += ' ';
+  }
+  const uint32_t Len = static_cast<uint32_t>(Str.size());
+
+  FuncBuilder B;
+  B.i32Const(0);
+  set(B, D).i32Const(0);
+  set(B, Count).i32Const(0);
+  set(B, Hash).i32Const(0);
+  set(B, P).block("loop", 0x03);
+  /// D = (follow(D) | first) & chars(text[P])
+  get(B, P).mem("i32.load8_u", 0x2D, 0, OffText);
+  B.i32Const(2).op("i32.shl", 0x74).mem("i32.load", 0x28, 2, OffChar);
+  get(B, D).i32Const(255).op("i32.and", 0x71);
+  B.i32Const(2).op("i32.shl", 0x74).mem("i32.load", 0x28, 2, OffFollow0);
+  get(B, D).i32Const(8).op("i32.shr_u", 0x76);
+  B.i32Const(2).op("i32.shl", 0x74).mem("i32.load", 0x28, 2, OffFollow1);
+  B.op("i32.or", 0x72).i32Const(First).op("i32.or", 0x72);
+  B.op("i32.and", 0x71).index("local.tee", 0x22, D);
+  /// Count the positions where a match ends.
+  B.i32Const(Final).op("i32.and", 0x71).i32Const(0).op("i32.ne", 0x47);
+  get(B, Count).op("i32.add", 0x6A);
+  set(B, Count);
+  get(B, Hash).i32Const(3).op("i32.rotl", 0x77);
+  get(B, D).op("i32.xor", 0x73);
+  set(B, Hash);
+  next(B, P, 1, Len);
+  /// Result: fold the match count and the state hash.
+  get(B, 1).i32Const(7).op("i32.rotl", 0x77);
+  get(B, Count).op("i32.add", 0x6A);
+  get(B, Hash).op("i32.add", 0x6A);
+  set(B, 1);
+
+  DataSegment Chars{OffChar, {}}, F0{OffFollow0, {}}, F1{OffFollow1, {}},
+      Text{OffText, Bytes(Str.begin(), Str.end())};
+  for (uint32_t C = 0; C < 256; ++C) {
+    append(Chars.Data, CharMask[C]);
+    append(F0.Data, Follow0[C]);
+    append(F1.Data, Follow1[C]);
+  }
+
+  std::vector<ValType> Locals(4, ValType::I32);
+  Guest G;
+  G.Name = "regex";
+  G.Wasm =
+      makeKernel("regex", "macro", B, 0, Locals, {Chars, F0, F1, Text}).Wasm;
+  G.Arg = 150;
+  G.Expected = UINT32_C(740187594);
+  return G;
+}
+
+/// Stack-based bytecode interpreter running a program which sums the Collatz
+/// step counts of 1 to 100. The opcodes are dispatched with br_table, and the
+/// operand stack and the registers live in the linear memory.
+Guest makeInterp() {
+  constexpr uint32_t OffProg = 0, OffReg = 1024, OffStack = 2048;
+  /// Extra locals: program counter, stack pointer to the top value, and the
+  /// value at halt.
+  constexpr uint32_t PC = 5, SP = 6, Ret = 7;
+  /// Bytecode opcodes. The ones with an immediate take two words.
+  enum : uint32_t {
+    Halt = 0,
+    Push,
+    Load,
+    Store,
+    Add,
+    Sub,
+    Mul,
+    DivU,
+    RemU,
+    LtU,
+    Jz,
+    Jmp,
+    OpCount
+  };
+
+  /// Assemble the program. Jump targets are byte offsets of the words.
+  enum Label { Outer, Inner, Even, Cont, Next, Done, LabelCount };
+  enum Reg : uint32_t { N, X, Total };
+  std::vector<uint32_t> Prog;
+  std::array<uint32_t, LabelCount> Labels = {};
+  std::vector<std::pair<size_t, Label>> Fixups;
+  const auto Emit = [&Prog](uint32_t Op) { Prog.push_back(Op); };
+  const auto EmitImm = [&Prog](uint32_t Op, uint32_t Imm) {
+    Prog.push_back(Op);
+    Prog.push_back(Imm);
+  };
+  const auto Jump = [&Prog, &Fixups](uint32_t Op, Label L) {
+    Prog.push_back(Op);
+    Fixups.emplace_back(Prog.size(), L);
+    Prog.push_back(0);
+  };
+  const auto Bind = [&Prog, &Labels](Label L) {
+    Labels[L] = OffProg + static_cast<uint32_t>(Prog.size()) * 4;
+  };
+  EmitImm(Push, 0);
+  EmitImm(Store, Total);
+  EmitImm(Push, 100);
+  EmitImm(Store, N);
+  Bind(Outer);
+  EmitImm(Load, N);
+  Jump(Jz, Done);
+  EmitImm(Load, N);
+  EmitImm(Store, X);
+  Bind(Inner);
+  EmitImm(Push, 1);
+  EmitImm(Load, X);
+  Emit(LtU);
+  Jump(Jz, Next);
+  EmitImm(Load, X);
+  EmitImm(Push, 2);
+  Emit(RemU);
+  Jump(Jz, Even);
+  EmitImm(Load, X);
+  EmitImm(Push, 3);
+  Emit(Mul);
+  EmitImm(Push, 1);
+  Emit(Add);
+  EmitImm(Store, X);
+  Jump(Jmp, Cont);
+  Bind(Even);
+  EmitImm(Load, X);
+  EmitImm(Push, 2);
+  Emit(DivU);
+  EmitImm(Store, X);
+  Bind(Cont);
+  EmitImm(Load, Total);
+  EmitImm(Push, 1);
+  Emit(Add);
+  EmitImm(Store, Total);
+  Jump(Jmp, Inner);
+  Bind(Next);
+  EmitImm(Load, N);
+  EmitImm(Push, 1);
+  Emit(Sub);
+  EmitImm(Store, N);
+  Jump(Jmp, Outer);
+  Bind(Done);
+  EmitImm(Load, Total);
+  Emit(Halt);
+  for (const auto &[Pos, L] : Fixups) {
+    Prog[Pos] = Labels[L];
+  }
+
+  /// Branch depth from the handler of the opcode to the dispatch loop.
+  const auto Dispatch = [](uint32_t Op) { return OpCount - 1 - Op; };
+  /// PC += Size; br $dispatch
+  const auto Advance = [&Dispatch](FuncBuilder &B, uint32_t Op,
+                                   uint32_t Size) -> FuncBuilder & {
+    get(B, PC).i32Const(Size).op("i32.add", 0x6A);
+    return set(B, PC).index("br", 0x0C, Dispatch(Op));
+  };
+
+  FuncBuilder B;
+  B.i32Const(OffProg);
+  set(B, PC).i32Const(OffStack - 4);
+  set(B, SP).block("block", 0x02).block("loop", 0x03);
+  for (uint32_t Op = 0; Op < OpCount; ++Op) {
+    B.block("block", 0x02);
+  }
+  get(B, PC).mem("i32.load", 0x28, 2, OffProg);
+  std::vector<uint32_t> Targets(OpCount);
+  for (uint32_t Op = 0; Op < OpCount; ++Op) {
+    Targets[Op] = Op;
+  }
+  B.brTable(Targets, Halt).end();
+  /// Halt: take the top value and leave.
+  get(B, SP).mem("i32.load", 0x28, 2, 0);
+  set(B, Ret).index("br", 0x0C, Dispatch(Halt) + 1).end();
+  /// Push imm.
+  get(B, SP).i32Const(4).op("i32.add", 0x6A);
+  B.index("local.tee", 0x22, SP);
+  get(B, PC).mem("i32.load", 0x28, 2, OffProg + 4);
+  B.mem("i32.store", 0x36, 2, 0);
+  Advance(B, Push, 8).end();
+  /// Load reg.
+  get(B, SP).i32Const(4).op("i32.add", 0x6A);
+  B.index("local.tee", 0x22, SP);
+  get(B, PC).mem("i32.load", 0x28, 2, OffProg + 4);
+  B.i32Const(2).op("i32.shl", 0x74).mem("i32.load", 0x28, 2, OffReg);
+  B.mem("i32.store", 0x36, 2, 0);
+  Advance(B, Load, 8).end();
+  /// Store reg.
+  get(B, PC).mem("i32.load", 0x28, 2, OffProg + 4);
+  B.i32Const(2).op("i32.shl", 0x74);
+  get(B, SP).mem("i32.load", 0x28, 2, 0).mem("i32.store", 0x36, 2, OffReg);
+  get(B, SP).i32Const(4).op("i32.sub", 0x6B);
+  set(B, SP);
+  Advance(B, Store, 8).end();
+  /// Binary operators on the two top values.
+  for (const auto &[Op, Name, Code] :
+       {std::tuple<uint32_t, std::string_view, uint8_t>{Add, "i32.add", 0x6A},
+        {Sub, "i32.sub", 0x6B},
+        {Mul, "i32.mul", 0x6C},
+        {DivU, "i32.div_u", 0x6E},
+        {RemU, "i32.rem_u", 0x70},
+        {LtU, "i32.lt_u", 0x49}}) {
+    get(B, SP).i32Const(4).op("i32.sub", 0x6B);
+    B.index("local.tee", 0x22, SP);
+    get(B, SP).mem("i32.load", 0x28, 2, 0);
+    get(B, SP).mem("i32.load", 0x28, 2, 4);
+    B.op(Name, Code).mem("i32.store", 0x36, 2, 0);
+    Advance(B, Op, 4).end();
+  }
+  /// Jz target: pop and branch if zero.
+  get(B, SP).mem("i32.load", 0x28, 2, 0).op("i32.eqz", 0x45);
+  get(B, SP).i32Const(4).op("i32.sub", 0x6B);
+  set(B, SP).block("if", 0x04);
+  get(B, PC).mem("i32.load", 0x28, 2, OffProg + 4);
+  set(B, PC).elseBranch();
+  get(B, PC).i32Const(8).op("i32.add", 0x6A);
+  set(B, PC).end().index("br", 0x0C, Dispatch(Jz)).end();
+  /// Jmp target.
+  get(B, PC).mem("i32.load", 0x28, 2, OffProg + 4);
+  set(B, PC).index("br", 0x0C, Dispatch(Jmp)).end().end();
+  /// Result: fold the program result.
+  get(B, 1).i32Const(7).op("i32.rotl", 0x77);
+  get(B, Ret).op("i32.add", 0x6A);
+  set(B, 1);
+
+  DataSegment Code{OffProg, {}};
+  for (const auto Word : Prog) {
+    append(Code.Data, Word);
+  }
+
+  std::vector<ValType> Locals(3, ValType::I32);
+  Guest G;
+  G.Name = "interp";
+  G.Wasm = makeKernel("interp", "macro", B, 0, Locals, {Code}).Wasm;
+  G.Arg = 8;
+  G.Expected = UINT32_C(76884540);
+  return G;
+}
+
+} // namespace
+
+/// Generate built-in guests. See "tools/ssvm-bench/guest.h".
+std::vector<Guest> makeGuests() {
+  std::vector<Guest> Guests;
+  Guests.push_back(makeMatmul());
+  Guests.push_back(makeSHA256());
+  Guests.push_back(makeJSON());
+  Guests.push_back(makeRegex());
+  Guests.push_back(makeInterp());
+  return Guests;
+}
+
+/// Load manifest. See "tools/ssvm-bench/guest.h".
+Expect<std::vector<Guest>> loadManifest(const std::string &Path) {
+  std::ifstream Fin(Path);
+  if (!Fin) {
+    return Unexpect(ErrCode::InvalidPath);
+  }
+  const std::filesystem::path Dir =
+      std::filesystem::absolute(Path).parent_path();
+  std::vector<Guest> Guests;
+  std::string Line;
+  while (std::getline(Fin, Line)) {
+    std::istringstream Iss(Line);
+    Guest G;
+    std::string GuestPath;
+    if (!(Iss >> G.Name) || G.Name[0] == '#') {
+      continue;
+    }
+    if (!(Iss >> GuestPath)) {
+      return Unexpect(ErrCode::InvalidPath);
+    }
+    G.Path = (Dir / GuestPath).lexically_normal().string();
+    std::string Arg;
+    while (Iss >> Arg) {
+      G.Args.push_back(Arg);
+    }
+    Guests.push_back(std::move(G));
+  }
+  return Guests;
+}
+
+} // namespace Bench
+} // namespace SSVM
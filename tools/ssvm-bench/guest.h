@@ -0,0 +1,54 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/tools/ssvm-bench/guest.h - End-to-end workload definitions ---===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the declaration of the end-to-end workloads of the macro
+/// benchmark.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "common/errcode.h"
+#include "common/value.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace SSVM {
+namespace Bench {
+
+/// End-to-end workload. Built-in guests are generated kernel modules and run
+/// `run` with `Arg`. External guests are WASI commands loaded from `Path` and
+/// run `_start` with `Args`.
+struct Guest {
+  std::string Name;
+  /// Built-in guest.
+  Bytes Wasm;
+  uint32_t Arg = 0;
+  /// Expected return value of `run`, used to check the execution result.
+  std::optional<uint32_t> Expected;
+  /// External guest.
+  std::string Path;
+  std::vector<std::string> Args;
+
+  bool isWasi() const { return !Path.empty(); }
+};
+
+/// Generate the built-in guests.
+std::vector<Guest> makeGuests();
+
+/// Load external guests from manifest file.
+///
+/// Every non-empty line not starting with `#` describes a guest as
+/// `name path [args...]`. Relative paths are resolved against the directory
+/// of the manifest.
+Expect<std::vector<Guest>> loadManifest(const std::string &Path);
+
+} // namespace Bench
+} // namespace SSVM
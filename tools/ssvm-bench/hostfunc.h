@@ -0,0 +1,42 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/tools/ssvm-bench/hostfunc.h - Benchmark host module ----------===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the host module imported by the benchmark kernels.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "kernel.h"
+#include "runtime/hostfunc.h"
+#include "runtime/importobj.h"
+
+#include <memory>
+
+namespace SSVM {
+namespace Bench {
+
+/// Trivial host function used to measure the host call overhead.
+class BenchInc : public Runtime::HostFunction<BenchInc> {
+public:
+  BenchInc() : Runtime::HostFunction<BenchInc>(0) {}
+  Expect<uint32_t> body(Runtime::Instance::MemoryInstance &MemInst,
+                        uint32_t Val) {
+    return Val + 1;
+  }
+};
+
+class BenchModule : public Runtime::ImportObject {
+public:
+  BenchModule() : ImportObject(std::string(kHostModuleName)) {
+    addHostFunc(std::string(kHostFuncName), std::make_unique<BenchInc>());
+  }
+  virtual ~BenchModule() = default;
+};
+
+} // namespace Bench
+} // namespace SSVM
@@ -0,0 +1,197 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "json.h"
+
+#include <cstdlib>
+
+namespace SSVM {
+namespace Bench {
+
+/// Recursive descent parser. Unicode escapes are kept as-is.
+class JSONParser {
+public:
+  JSONParser(std::string_view Text) : Text(Text) {}
+
+  std::optional<JSONValue> parseDocument() {
+    auto Val = parseValue();
+    skipSpace();
+    if (!Val || Pos != Text.size()) {
+      return std::nullopt;
+    }
+    return Val;
+  }
+
+private:
+  void skipSpace() {
+    while (Pos < Text.size() &&
+           (Text[Pos] == ' ' || Text[Pos] == '\t' || Text[Pos] == '\n' ||
+            Text[Pos] == '\r')) {
+      ++Pos;
+    }
+  }
+
+  bool consume(std::string_view Token) {
+    if (Text.substr(Pos, Token.size()) == Token) {
+      Pos += Token.size();
+      return true;
+    }
+    return false;
+  }
+
+  std::optional<std::string> parseString() {
+    if (!consume("\"")) {
+      return std::nullopt;
+    }
+    std::string Str;
+    while (Pos < Text.size() && Text[Pos] != '"') {
+      if (Text[Pos] == '\\' && Pos + 1 < Text.size()) {
+        ++Pos;
+        switch (Text[Pos]) {
+        case 'n':
+          Str.push_back('\n');
+          break;
+        case 't':
+          Str.push_back('\t');
+          break;
+        case 'r':
+          Str.push_back('\r');
+          break;
+        case 'b':
+          Str.push_back('\b');
+          break;
+        case 'f':
+          Str.push_back('\f');
+          break;
+        case 'u':
+          Str.append("\\u");
+          break;
+        default:
+          Str.push_back(Text[Pos]);
+          break;
+        }
+      } else {
+        Str.push_back(Text[Pos]);
+      }
+      ++Pos;
+    }
+    if (!consume("\"")) {
+      return std::nullopt;
+    }
+    return Str;
+  }
+
+  std::optional<JSONValue> parseValue() {
+    skipSpace();
+    if (Pos >= Text.size()) {
+      return std::nullopt;
+    }
+    JSONValue Val;
+    const char C = Text[Pos];
+    if (C == '{') {
+      ++Pos;
+      Val.K = JSONValue::Kind::Object;
+      skipSpace();
+      if (consume("}")) {
+        return Val;
+      }
+      do {
+        skipSpace();
+        auto Key = parseString();
+        skipSpace();
+        if (!Key || !consume(":")) {
+          return std::nullopt;
+        }
+        auto Elem = parseValue();
+        if (!Elem) {
+          return std::nullopt;
+        }
+        Val.Keys.push_back(std::move(*Key));
+        Val.Elems.push_back(std::move(*Elem));
+        skipSpace();
+      } while (consume(","));
+      return consume("}") ? std::optional<JSONValue>(std::move(Val))
+                          : std::nullopt;
+    }
+    if (C == '[') {
+      ++Pos;
+      Val.K = JSONValue::Kind::Array;
+      skipSpace();
+      if (consume("]")) {
+        return Val;
+      }
+      do {
+        auto Elem = parseValue();
+        if (!Elem) {
+          return std::nullopt;
+        }
+        Val.Elems.push_back(std::move(*Elem));
+        skipSpace();
+      } while (consume(","));
+      return consume("]") ? std::optional<JSONValue>(std::move(Val))
+                          : std::nullopt;
+    }
+    if (C == '"') {
+      auto Str = parseString();
+      if (!Str) {
+        return std::nullopt;
+      }
+      Val.K = JSONValue::Kind::String;
+      Val.Str = std::move(*Str);
+      return Val;
+    }
+    if (consume("true") || consume("false")) {
+      Val.K = JSONValue::Kind::Bool;
+      Val.Bool = (C == 't');
+      return Val;
+    }
+    if (consume("null")) {
+      return Val;
+    }
+    /// Number.
+    const std::string Rest(Text.substr(Pos, 64));
+    char *End = nullptr;
+    Val.Num = std::strtod(Rest.c_str(), &End);
+    if (End == Rest.c_str()) {
+      return std::nullopt;
+    }
+    Pos += End - Rest.c_str();
+    Val.K = JSONValue::Kind::Number;
+    return Val;
+  }
+
+  std::string_view Text;
+  size_t Pos = 0;
+};
+
+/// Parse JSON text. See "tools/ssvm-bench/json.h".
+std::optional<JSONValue> JSONValue::parse(std::string_view Text) {
+  return JSONParser(Text).parseDocument();
+}
+
+/// Get object member. See "tools/ssvm-bench/json.h".
+const JSONValue *JSONValue::get(std::string_view Key) const {
+  for (size_t I = 0; I < Keys.size(); ++I) {
+    if (Keys[I] == Key) {
+      return &Elems[I];
+    }
+  }
+  return nullptr;
+}
+
+/// Get number member. See "tools/ssvm-bench/json.h".
+std::optional<double> JSONValue::getNumber(std::string_view Key) const {
+  if (const auto *Val = get(Key); Val && Val->K == Kind::Number) {
+    return Val->Num;
+  }
+  return std::nullopt;
+}
+
+/// Get string member. See "tools/ssvm-bench/json.h".
+std::string JSONValue::getString(std::string_view Key) const {
+  if (const auto *Val = get(Key); Val && Val->K == Kind::String) {
+    return Val->Str;
+  }
+  return {};
+}
+
+} // namespace Bench
+} // namespace SSVM
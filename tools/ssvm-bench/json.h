@@ -0,0 +1,56 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/tools/ssvm-bench/json.h - Minimal JSON reader ----------------===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains a minimal JSON reader for the result files of
+/// ssvm-bench.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace SSVM {
+namespace Bench {
+
+class JSONValue {
+public:
+  enum class Kind { Null, Bool, Number, String, Array, Object };
+
+  /// Parse JSON text. Return nullopt if the text is malformed.
+  static std::optional<JSONValue> parse(std::string_view Text);
+
+  Kind getKind() const { return K; }
+  bool getBool() const { return Bool; }
+  double getNumber() const { return Num; }
+  const std::string &getString() const { return Str; }
+  /// Elements of array, or values of object.
+  const std::vector<JSONValue> &getElements() const { return Elems; }
+
+  /// Member of object with given key. Return nullptr if not found.
+  const JSONValue *get(std::string_view Key) const;
+  /// Number member of object, or nullopt if missing or not a number.
+  std::optional<double> getNumber(std::string_view Key) const;
+  /// String member of object, or empty string if missing or not a string.
+  std::string getString(std::string_view Key) const;
+
+private:
+  Kind K = Kind::Null;
+  double Num = 0.0;
+  bool Bool = false;
+  std::string Str;
+  std::vector<std::string> Keys;
+  std::vector<JSONValue> Elems;
+
+  friend class JSONParser;
+};
+
+} // namespace Bench
+} // namespace SSVM
@@ -0,0 +1,553 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "kernel.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace SSVM {
+namespace Bench {
+
+namespace {
+
+/// Number of times the kernel unit is repeated in one loop iteration.
+constexpr uint32_t kUnroll = 4;
+/// Instructions of the loop skeleton executed per iteration: 3 before the
+/// kernel body and 5 after it.
+constexpr uint32_t kLoopOverhead = 8;
+/// Instructions of the callee `$add` executed per call.
+constexpr uint32_t kCalleeOps = 3;
+
+void writeU32(Bytes &Buf, uint32_t Val) {
+  do {
+    uint8_t Byte = Val & 0x7FU;
+    Val >>= 7;
+    if (Val != 0) {
+      Byte |= 0x80U;
+    }
+    Buf.push_back(Byte);
+  } while (Val != 0);
+}
+
+void writeS64(Bytes &Buf, int64_t Val) {
+  bool More = true;
+  while (More) {
+    uint8_t Byte = Val & 0x7FU;
+    Val >>= 7;
+    if ((Val == 0 && (Byte & 0x40U) == 0) ||
+        (Val == -1 && (Byte & 0x40U) != 0)) {
+      More = false;
+    } else {
+      Byte |= 0x80U;
+    }
+    Buf.push_back(Byte);
+  }
+}
+
+void writeName(Bytes &Buf, std::string_view Name) {
+  writeU32(Buf, Name.size());
+  Buf.insert(Buf.end(), Name.begin(), Name.end());
+}
+
+void writeSection(Bytes &Buf, uint8_t Id, const Bytes &Content) {
+  Buf.push_back(Id);
+  writeU32(Buf, Content.size());
+  Buf.insert(Buf.end(), Content.begin(), Content.end());
+}
+
+std::string_view toText(ValType Type) {
+  switch (Type) {
+  case ValType::I32:
+    return "i32";
+  case ValType::I64:
+    return "i64";
+  case ValType::F32:
+    return "f32";
+  case ValType::F64:
+    return "f64";
+  default:
+    return "";
+  }
+}
+
+std::string hexFloat(double Val) {
+  char Buf[64];
+  std::snprintf(Buf, sizeof(Buf), "%a", Val);
+  return Buf;
+}
+
+} // namespace
+
+/// Assemble kernel module. See "tools/ssvm-bench/kernel.h".
+Kernel makeKernel(std::string Name, std::string Class, const FuncBuilder &Body,
+                  uint32_t OpsPerIter, const std::vector<ValType> &ExtraLocals,
+                  const std::vector<DataSegment> &Data) {
+  /// Loop skeleton of `$run`. Local 0 is the iteration counter, locals 1 to 4
+  /// are the i32, i64, f64 and f32 accumulators.
+  FuncBuilder Run(2);
+  Run.block("block", 0x02).block("loop", 0x03);
+  Run.index("local.get", 0x20, 0).op("i32.eqz", 0x45).index("br_if", 0x0D, 1);
+  Bytes Code = Run.getCode();
+  std::string Text = Run.getText();
+  Code.insert(Code.end(), Body.getCode().begin(), Body.getCode().end());
+  Text += Body.getText();
+
+  FuncBuilder Epilog(4);
+  Epilog.index("local.get", 0x20, 0)
+      .i32Const(1)
+      .op("i32.sub", 0x6B)
+      .index("local.set", 0x21, 0)
+      .index("br", 0x0C, 0)
+      .end()
+      .end();
+  /// Fold every accumulator into the result so that AOT can not discard the
+  /// kernel body.
+  Epilog.index("local.get", 0x20, 1)
+      .index("local.get", 0x20, 2)
+      .op("i32.wrap_i64", 0xA7)
+      .op("i32.add", 0x6A)
+      .index("local.get", 0x20, 3)
+      .f64Const(1.0)
+      .op("f64.gt", 0x64)
+      .op("i32.add", 0x6A)
+      .index("local.get", 0x20, 4)
+      .f32Const(1.0f)
+      .op("f32.gt", 0x5E)
+      .op("i32.add", 0x6A);
+  Code.insert(Code.end(), Epilog.getCode().begin(), Epilog.getCode().end());
+  Text += Epilog.getText();
+
+  Kernel K;
+  K.Name = std::move(Name);
+  K.Class = std::move(Class);
+  K.OpsPerIter = OpsPerIter + kLoopOverhead;
+
+  /// Binary format.
+  Bytes &W = K.Wasm;
+  W = {0x00, 0x61, 0x73, 0x6D, 0x01, 0x00, 0x00, 0x00};
+  {
+    /// Type section: 0: [i32] -> [i32], 1: [i32 i32] -> [i32].
+    Bytes Sec = {0x02, 0x60, 0x01, 0x7F, 0x01, 0x7F,
+                 0x60, 0x02, 0x7F, 0x7F, 0x01, 0x7F};
+    writeSection(W, 0x01, Sec);
+  }
+  {
+    /// Import section: host function as function index 0.
+    Bytes Sec = {0x01};
+    writeName(Sec, kHostModuleName);
+    writeName(Sec, kHostFuncName);
+    Sec.insert(Sec.end(), {0x00, 0x00});
+    writeSection(W, 0x02, Sec);
+  }
+  /// Function section: 1: `$add`, 2: `$run`.
+  writeSection(W, 0x03, {0x02, 0x01, 0x00});
+  /// Table section: funcref table with limits [1, 1].
+  writeSection(W, 0x04, {0x01, 0x70, 0x01, 0x01, 0x01});
+  /// Memory section: limits [1, 1].
+  writeSection(W, 0x05, {0x01, 0x01, 0x01, 0x01});
+  {
+    /// Export section: `run`.
+    Bytes Sec = {0x01};
+    writeName(Sec, "run");
+    Sec.insert(Sec.end(), {0x00, 0x02});
+    writeSection(W, 0x07, Sec);
+  }
+  /// Element section: table[0] = `$add`.
+  writeSection(W, 0x09, {0x01, 0x00, 0x41, 0x00, 0x0B, 0x01, 0x01});
+  {
+    /// Code section.
+    Bytes Sec = {0x02};
+    const Bytes Add = {0x00, 0x20, 0x00, 0x20, 0x01, 0x6A, 0x0B};
+    writeU32(Sec, Add.size());
+    Sec.insert(Sec.end(), Add.begin(), Add.end());
+    Bytes Body;
+    writeU32(Body, 4 + ExtraLocals.size());
+    Body.insert(Body.end(), {0x01, 0x7F, 0x01, 0x7E, 0x01, 0x7C, 0x01, 0x7D});
+    for (const auto Type : ExtraLocals) {
+      Body.push_back(0x01);
+      Body.push_back(static_cast<uint8_t>(Type));
+    }
+    Body.insert(Body.end(), Code.begin(), Code.end());
+    Body.push_back(0x0B);
+    writeU32(Sec, Body.size());
+    Sec.insert(Sec.end(), Body.begin(), Body.end());
+    writeSection(W, 0x0A, Sec);
+  }
+  if (!Data.empty()) {
+    /// Data section.
+    Bytes Sec;
+    writeU32(Sec, Data.size());
+    for (const auto &Seg : Data) {
+      Sec.insert(Sec.end(), {0x00, 0x41});
+      writeS64(Sec, static_cast<int32_t>(Seg.Offset));
+      Sec.push_back(0x0B);
+      writeU32(Sec, Seg.Data.size());
+      Sec.insert(Sec.end(), Seg.Data.begin(), Seg.Data.end());
+    }
+    writeSection(W, 0x0B, Sec);
+  }
+
+  /// Text format.
+  std::string &T = K.Wat;
+  T += ";; ssvm-bench kernel: " + K.Name + " (" + K.Class + ")\n";
+  T += "(module\n";
+  T += "  (type (;0;) (func (param i32) (result i32)))\n";
+  T += "  (type (;1;) (func (param i32 i32) (result i32)))\n";
+  T += "  (import \"" + std::string(kHostModuleName) + "\" \"" +
+       std::string(kHostFuncName) + "\" (func (;0;) (type 0)))\n";
+  T += "  (func (;1;) (type 1) (param i32 i32) (result i32)\n";
+  T += "    local.get 0\n    local.get 1\n    i32.add)\n";
+  T += "  (func (;2;) (type 0) (param i32) (result i32)\n";
+  T += "    (local i32 i64 f64 f32";
+  for (const auto Type : ExtraLocals) {
+    T += " ";
+    T += toText(Type);
+  }
+  T += ")\n";
+  T += Text;
+  T.back() = ')';
+  T += "\n";
+  T += "  (table (;0;) 1 1 funcref)\n";
+  T += "  (memory (;0;) 1 1)\n";
+  T += "  (export \"run\" (func 2))\n";
+  T += "  (elem (;0;) (i32.const 0) func 1)";
+  for (size_t I = 0; I < Data.size(); ++I) {
+    T += "\n  (data (;" + std::to_string(I) + ";) (i32.const " +
+         std::to_string(Data[I].Offset) + ") \"";
+    for (const auto Byte : Data[I].Data) {
+      char Buf[4];
+      std::snprintf(Buf, sizeof(Buf), "\\%02x", Byte);
+      T += Buf;
+    }
+    T += "\")";
+  }
+  T += ")\n";
+  return K;
+}
+
+/// Emit instruction without immediates. See "tools/ssvm-bench/kernel.h".
+FuncBuilder &FuncBuilder::op(std::string_view Name, uint8_t Code) {
+  this->Code.push_back(Code);
+  line(Name);
+  ++InstrCnt;
+  return *this;
+}
+
+/// Emit instruction with index immediate. See "tools/ssvm-bench/kernel.h".
+FuncBuilder &FuncBuilder::index(std::string_view Name, uint8_t Code,
+                                uint32_t Idx) {
+  this->Code.push_back(Code);
+  writeU32(this->Code, Idx);
+  line(std::string(Name) + " " + std::to_string(Idx));
+  ++InstrCnt;
+  return *this;
+}
+
+/// Emit structured control instruction. See "tools/ssvm-bench/kernel.h".
+FuncBuilder &FuncBuilder::block(std::string_view Name, uint8_t Code,
+                                ValType Result) {
+  this->Code.push_back(Code);
+  this->Code.push_back(static_cast<uint8_t>(Result));
+  if (Result == ValType::None) {
+    line(Name);
+  } else {
+    line(std::string(Name) + " (result " + std::string(toText(Result)) + ")");
+  }
+  ++InstrCnt;
+  ++Depth;
+  return *this;
+}
+
+/// Emit else marker. See "tools/ssvm-bench/kernel.h".
+FuncBuilder &FuncBuilder::elseBranch() {
+  Code.push_back(0x05);
+  --Depth;
+  line("else");
+  ++Depth;
+  return *this;
+}
+
+/// Emit end marker. See "tools/ssvm-bench/kernel.h".
+FuncBuilder &FuncBuilder::end() {
+  Code.push_back(0x0B);
+  --Depth;
+  line("end");
+  return *this;
+}
+
+/// Emit br_table instruction. See "tools/ssvm-bench/kernel.h".
+FuncBuilder &FuncBuilder::brTable(const std::vector<uint32_t> &Labels,
+                                  uint32_t Default) {
+  Code.push_back(0x0E);
+  writeU32(Code, Labels.size());
+  std::string Str = "br_table";
+  for (const auto Label : Labels) {
+    writeU32(Code, Label);
+    Str += " " + std::to_string(Label);
+  }
+  writeU32(Code, Default);
+  line(Str + " " + std::to_string(Default));
+  ++InstrCnt;
+  return *this;
+}
+
+/// Emit call_indirect instruction. See "tools/ssvm-bench/kernel.h".
+FuncBuilder &FuncBuilder::callIndirect(uint32_t TypeIdx) {
+  Code.push_back(0x11);
+  writeU32(Code, TypeIdx);
+  Code.push_back(0x00);
+  line("call_indirect (type " + std::to_string(TypeIdx) + ")");
+  ++InstrCnt;
+  return *this;
+}
+
+/// Emit memory instruction. See "tools/ssvm-bench/kernel.h".
+FuncBuilder &FuncBuilder::mem(std::string_view Name, uint8_t Code,
+                              uint32_t Align, uint32_t Offset) {
+  this->Code.push_back(Code);
+  writeU32(this->Code, Align);
+  writeU32(this->Code, Offset);
+  std::string Str(Name);
+  if (Offset != 0) {
+    Str += " offset=" + std::to_string(Offset);
+  }
+  line(Str + " align=" + std::to_string(1U << Align));
+  ++InstrCnt;
+  return *this;
+}
+
+/// Emit i32.const instruction. See "tools/ssvm-bench/kernel.h".
+FuncBuilder &FuncBuilder::i32Const(int32_t Val) {
+  Code.push_back(0x41);
+  writeS64(Code, Val);
+  line("i32.const " + std::to_string(Val));
+  ++InstrCnt;
+  return *this;
+}
+
+/// Emit i64.const instruction. See "tools/ssvm-bench/kernel.h".
+FuncBuilder &FuncBuilder::i64Const(int64_t Val) {
+  Code.push_back(0x42);
+  writeS64(Code, Val);
+  line("i64.const " + std::to_string(Val));
+  ++InstrCnt;
+  return *this;
+}
+
+/// Emit f32.const instruction. See "tools/ssvm-bench/kernel.h".
+FuncBuilder &FuncBuilder::f32Const(float Val) {
+  Code.push_back(0x43);
+  uint8_t Buf[sizeof(float)];
+  std::memcpy(Buf, &Val, sizeof(float));
+  Code.insert(Code.end(), Buf, Buf + sizeof(float));
+  line("f32.const " + hexFloat(Val));
+  ++InstrCnt;
+  return *this;
+}
+
+/// Emit f64.const instruction. See "tools/ssvm-bench/kernel.h".
+FuncBuilder &FuncBuilder::f64Const(double Val) {
+  Code.push_back(0x44);
+  uint8_t Buf[sizeof(double)];
+  std::memcpy(Buf, &Val, sizeof(double));
+  Code.insert(Code.end(), Buf, Buf + sizeof(double));
+  line("f64.const " + hexFloat(Val));
+  ++InstrCnt;
+  return *this;
+}
+
+void FuncBuilder::line(std::string_view Str) {
+  Text.append(Depth * 2, ' ');
+  Text.append(Str);
+  Text.push_back('\n');
+}
+
+/// Generate benchmark kernels. See "tools/ssvm-bench/kernel.h".
+std::vector<Kernel> makeKernels() {
+  std::vector<Kernel> Kernels;
+
+  /// Empty loop: measures the loop skeleton only.
+  {
+    FuncBuilder B;
+    Kernels.push_back(makeKernel("loop.empty", "control", B, 0));
+  }
+
+  /// Integer ALU.
+  {
+    FuncBuilder B;
+    for (uint32_t I = 0; I < kUnroll; ++I) {
+      B.index("local.get", 0x20, 1)
+          .i32Const(static_cast<int32_t>(0x9E3779B1U))
+          .op("i32.mul", 0x6C)
+          .index("local.get", 0x20, 0)
+          .op("i32.add", 0x6A)
+          .i32Const(13)
+          .op("i32.rotl", 0x77)
+          .i32Const(0x5BD1E995)
+          .op("i32.xor", 0x73)
+          .index("local.set", 0x21, 1);
+    }
+    Kernels.push_back(makeKernel("i32.alu", "int", B, B.getInstrCount()));
+  }
+  {
+    FuncBuilder B;
+    for (uint32_t I = 0; I < kUnroll; ++I) {
+      B.index("local.get", 0x20, 2)
+          .i64Const(INT64_C(0x5851F42D4C957F2D))
+          .op("i64.mul", 0x7E)
+          .i64Const(29)
+          .op("i64.shr_u", 0x88)
+          .index("local.get", 0x20, 2)
+          .op("i64.xor", 0x85)
+          .i64Const(1442695040888963407)
+          .op("i64.add", 0x7C)
+          .index("local.set", 0x21, 2);
+    }
+    Kernels.push_back(makeKernel("i64.alu", "int", B, B.getInstrCount()));
+  }
+
+  /// Floating point arithmetic.
+  {
+    FuncBuilder B;
+    for (uint32_t I = 0; I < kUnroll; ++I) {
+      B.index("local.get", 0x20, 4)
+          .f32Const(1.5f)
+          .op("f32.mul", 0x94)
+          .op("f32.sqrt", 0x91)
+          .f32Const(0.25f)
+          .op("f32.add", 0x92)
+          .index("local.set", 0x21, 4);
+    }
+    Kernels.push_back(makeKernel("f32.arith", "float", B, B.getInstrCount()));
+  }
+  {
+    FuncBuilder B;
+    for (uint32_t I = 0; I < kUnroll; ++I) {
+      B.index("local.get", 0x20, 3)
+          .f64Const(1.0000001)
+          .op("f64.mul", 0xA2)
+          .f64Const(0.5)
+          .op("f64.add", 0xA0)
+          .f64Const(1.5)
+          .op("f64.div", 0xA3)
+          .index("local.set", 0x21, 3);
+    }
+    Kernels.push_back(makeKernel("f64.arith", "float", B, B.getInstrCount()));
+  }
+
+  /// Memory load and store.
+  {
+    FuncBuilder B;
+    for (uint32_t I = 0; I < kUnroll; ++I) {
+      B.index("local.get", 0x20, 0)
+          .i32Const(0xFFC)
+          .op("i32.and", 0x71)
+          .index("local.get", 0x20, 0)
+          .i32Const(0xFFC)
+          .op("i32.and", 0x71)
+          .mem("i32.load", 0x28, 2, I * 4)
+          .index("local.get", 0x20, 1)
+          .op("i32.add", 0x6A)
+          .mem("i32.store", 0x36, 2, I * 4 + 64);
+    }
+    Kernels.push_back(
+        makeKernel("i32.load_store", "memory", B, B.getInstrCount()));
+  }
+  {
+    FuncBuilder B;
+    for (uint32_t I = 0; I < kUnroll; ++I) {
+      B.index("local.get", 0x20, 2)
+          .index("local.get", 0x20, 0)
+          .i32Const(0xFF8)
+          .op("i32.and", 0x71)
+          .mem("i64.load", 0x29, 3, I * 8)
+          .op("i64.add", 0x7C)
+          .index("local.set", 0x21, 2)
+          .index("local.get", 0x20, 0)
+          .i32Const(0xFFF)
+          .op("i32.and", 0x71)
+          .index("local.get", 0x20, 1)
+          .mem("i32.store8", 0x3A, 0, I);
+    }
+    Kernels.push_back(
+        makeKernel("mixed.load_store", "memory", B, B.getInstrCount()));
+  }
+
+  /// Control flow: block, br_if, br_table and if/else.
+  {
+    FuncBuilder B;
+    uint32_t ElseCnt = 0;
+    for (uint32_t I = 0; I < kUnroll; ++I) {
+      B.block("block", 0x02)
+          .index("local.get", 0x20, 0)
+          .op("i32.eqz", 0x45)
+          .index("br_if", 0x0D, 0)
+          .index("local.get", 0x20, 0)
+          .i32Const(3)
+          .op("i32.and", 0x71)
+          .brTable({0, 0, 0}, 0)
+          .end();
+      B.index("local.get", 0x20, 0)
+          .i32Const(1)
+          .op("i32.and", 0x71)
+          .block("if", 0x04)
+          .index("local.get", 0x20, 1)
+          .i32Const(1)
+          .op("i32.add", 0x6A)
+          .index("local.set", 0x21, 1)
+          .elseBranch();
+      const uint32_t Before = B.getInstrCount();
+      B.index("local.get", 0x20, 1)
+          .i32Const(3)
+          .op("i32.xor", 0x73)
+          .index("local.set", 0x21, 1)
+          .end();
+      ElseCnt += B.getInstrCount() - Before;
+    }
+    /// Only one arm of each if/else is executed.
+    Kernels.push_back(
+        makeKernel("block.br", "control", B, B.getInstrCount() - ElseCnt));
+  }
+
+  /// Direct calls. The callee instructions are included in the op count.
+  {
+    FuncBuilder B;
+    for (uint32_t I = 0; I < kUnroll; ++I) {
+      B.index("local.get", 0x20, 1)
+          .index("local.get", 0x20, 0)
+          .index("call", 0x10, 1)
+          .index("local.set", 0x21, 1);
+    }
+    Kernels.push_back(makeKernel("call", "call", B,
+                                 B.getInstrCount() + kUnroll * kCalleeOps));
+  }
+
+  /// Indirect calls through the table.
+  {
+    FuncBuilder B;
+    for (uint32_t I = 0; I < kUnroll; ++I) {
+      B.index("local.get", 0x20, 1)
+          .index("local.get", 0x20, 0)
+          .i32Const(0)
+          .callIndirect(1)
+          .index("local.set", 0x21, 1);
+    }
+    Kernels.push_back(makeKernel("call_indirect", "call_indirect", B,
+                                 B.getInstrCount() + kUnroll * kCalleeOps));
+  }
+
+  /// Host function calls. The host function counts as one op.
+  {
+    FuncBuilder B;
+    for (uint32_t I = 0; I < kUnroll; ++I) {
+      B.index("local.get", 0x20, 1)
+          .index("call", 0x10, 0)
+          .index("local.set", 0x21, 1);
+    }
+    Kernels.push_back(makeKernel("host.call", "host", B, B.getInstrCount()));
+  }
+
+  return Kernels;
+}
+
+} // namespace Bench
+} // namespace SSVM
@@ -0,0 +1,112 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/tools/ssvm-bench/kernel.h - Benchmark kernel definitions -----===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the declaration of the benchmark kernels and the small
+/// wasm module builder which generates both the binary and the `.wat` text of
+/// every kernel.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "common/types.h"
+#include "common/value.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace SSVM {
+namespace Bench {
+
+/// Function body builder. Every emitted instruction is recorded both as wasm
+/// binary and as one line of `.wat` text.
+class FuncBuilder {
+public:
+  /// `Indent` is the nesting level of the first emitted instruction in the
+  /// text format. The default is the body of the kernel loop.
+  explicit FuncBuilder(uint32_t Indent = 4) : Depth(Indent) {}
+
+  /// Instructions without immediates.
+  FuncBuilder &op(std::string_view Name, uint8_t Code);
+  /// Instructions with one u32 index immediate.
+  FuncBuilder &index(std::string_view Name, uint8_t Code, uint32_t Idx);
+  /// Structured control instructions. `Result` is `ValType::None` for void.
+  FuncBuilder &block(std::string_view Name, uint8_t Code,
+                     ValType Result = ValType::None);
+  FuncBuilder &elseBranch();
+  FuncBuilder &end();
+  FuncBuilder &brTable(const std::vector<uint32_t> &Labels, uint32_t Default);
+  FuncBuilder &callIndirect(uint32_t TypeIdx);
+  /// Memory instructions with memarg.
+  FuncBuilder &mem(std::string_view Name, uint8_t Code, uint32_t Align,
+                   uint32_t Offset);
+  /// Constant instructions.
+  FuncBuilder &i32Const(int32_t Val);
+  FuncBuilder &i32Const(uint32_t Val) {
+    return i32Const(static_cast<int32_t>(Val));
+  }
+  FuncBuilder &i64Const(int64_t Val);
+  FuncBuilder &f32Const(float Val);
+  FuncBuilder &f64Const(double Val);
+
+  /// Number of emitted instructions (excluding `end` and `else` markers).
+  uint32_t getInstrCount() const { return InstrCnt; }
+  /// Encoded instructions, without the terminating `end`.
+  const Bytes &getCode() const { return Code; }
+  /// Text of the instructions, one per line.
+  const std::string &getText() const { return Text; }
+
+private:
+  void line(std::string_view Str);
+
+  Bytes Code;
+  std::string Text;
+  uint32_t Depth;
+  uint32_t InstrCnt = 0;
+};
+
+/// Benchmark kernel. The generated module exports `run (param i32) (result
+/// i32)`, which executes the kernel loop body the given number of times.
+struct Kernel {
+  /// Kernel name, e.g. `i32.alu`.
+  std::string Name;
+  /// Opcode class, e.g. `int`, `float`, `memory`.
+  std::string Class;
+  /// Wasm instructions executed per loop iteration, including loop overhead.
+  uint32_t OpsPerIter;
+  /// Wasm binary of the module.
+  Bytes Wasm;
+  /// Text format of the module.
+  std::string Wat;
+};
+
+/// Name and function of the host function imported by every kernel module.
+inline constexpr std::string_view kHostModuleName = "bench";
+inline constexpr std::string_view kHostFuncName = "inc";
+
+/// Data segment placed in the linear memory of a kernel module.
+struct DataSegment {
+  uint32_t Offset;
+  Bytes Data;
+};
+
+/// Assemble a kernel module whose `run` function executes `Body` in a loop.
+/// Locals 0 to 4 of `Body` are the loop counter and the i32, i64, f64 and f32
+/// accumulators, followed by `ExtraLocals`. `OpsPerIter` excludes the loop
+/// overhead.
+Kernel makeKernel(std::string Name, std::string Class, const FuncBuilder &Body,
+                  uint32_t OpsPerIter,
+                  const std::vector<ValType> &ExtraLocals = {},
+                  const std::vector<DataSegment> &Data = {});
+
+/// Generate all benchmark kernels.
+std::vector<Kernel> makeKernels();
+
+} // namespace Bench
+} // namespace SSVM
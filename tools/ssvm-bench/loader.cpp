@@ -0,0 +1,223 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "bench.h"
+
+#include "common/ast/module.h"
+#include "loader/filemgr.h"
+#include "support/filesystem.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+
+namespace {
+
+/// Number of heap allocations of this process.
+std::atomic<uint64_t> AllocCount = 0;
+
+} // namespace
+
+/// Count heap allocations for the loader benchmark.
+void *operator new(std::size_t Size) {
+  AllocCount.fetch_add(1, std::memory_order_relaxed);
+  if (void *Ptr = std::malloc(Size ? Size : 1)) {
+    return Ptr;
+  }
+  throw std::bad_alloc();
+}
+void operator delete(void *Ptr) noexcept { std::free(Ptr); }
+void operator delete(void *Ptr, std::size_t) noexcept { std::free(Ptr); }
+
+namespace SSVM {
+namespace Bench {
+
+namespace {
+
+/// File managers measured by the loader benchmark.
+enum class Manager : uint8_t { FStream, Vector, Mmap };
+
+std::string_view toString(Manager M) {
+  switch (M) {
+  case Manager::FStream:
+    return "fstream";
+  case Manager::Vector:
+    return "vector";
+  case Manager::Mmap:
+    return "mmap";
+  }
+  return "";
+}
+
+struct Module {
+  std::string Path;
+  Bytes Code;
+};
+
+struct Result {
+  Manager M;
+  Stats MBPerSec;
+  Stats NsPerByte;
+  Stats FreeNsPerByte;
+  double AllocsPerModule;
+};
+
+/// Parse one module with given file manager.
+Expect<std::unique_ptr<AST::Module>> parseModule(Manager M, const Module &Mod) {
+  static FileMgrFStream FSMgr;
+  static FileMgrVector FVMgr;
+  static FileMgrMmap FMMgr;
+  FileMgr *Mgr = nullptr;
+  switch (M) {
+  case Manager::FStream:
+    if (auto Res = FSMgr.setPath(Mod.Path); !Res) {
+      return Unexpect(Res);
+    }
+    Mgr = &FSMgr;
+    break;
+  case Manager::Vector:
+    if (auto Res = FVMgr.setCode(Mod.Code); !Res) {
+      return Unexpect(Res);
+    }
+    Mgr = &FVMgr;
+    break;
+  case Manager::Mmap:
+    if (auto Res = FMMgr.setPath(Mod.Path); !Res) {
+      return Unexpect(Res);
+    }
+    Mgr = &FMMgr;
+    break;
+  }
+  auto ASTMod = std::make_unique<AST::Module>();
+  if (auto Res = ASTMod->loadBinary(*Mgr); !Res) {
+    return Unexpect(Res);
+  }
+  return ASTMod;
+}
+
+/// Collect the modules under the directory which the file managers can parse.
+std::vector<Module> collectModules(const std::string &Dir) {
+  std::vector<std::filesystem::path> Paths;
+  std::error_code EC;
+  for (const auto &Entry : std::filesystem::directory_iterator(Dir, EC)) {
+    if (Entry.is_regular_file() && Entry.path().extension() == ".wasm") {
+      Paths.push_back(Entry.path());
+    }
+  }
+  std::sort(Paths.begin(), Paths.end());
+
+  std::vector<Module> Modules;
+  for (const auto &Path : Paths) {
+    std::ifstream Fin(Path, std::ios::binary);
+    Module Mod{Path.string(),
+               Bytes(std::istreambuf_iterator<char>(Fin),
+                     std::istreambuf_iterator<char>())};
+    if (!parseModule(Manager::Vector, Mod)) {
+      std::cerr << "Skip unparsable module " << Mod.Path << std::endl;
+      continue;
+    }
+    Modules.push_back(std::move(Mod));
+  }
+  return Modules;
+}
+
+void writeStats(std::ostream &OS, std::string_view Name, const Stats &S) {
+  OS << ", \"" << Name << "\": {\"mean\": " << S.Mean
+     << ", \"stddev\": " << S.Stddev << ", \"min\": " << S.Min
+     << ", \"max\": " << S.Max << "}";
+}
+
+void writeJSON(std::ostream &OS, const Options &Opt, size_t ModuleCount,
+               uint64_t TotalBytes, const std::vector<Result> &Results) {
+  OS << std::setprecision(3) << std::fixed;
+  OS << "{\n";
+  OS << "  \"format\": \"ssvm-bench-loader\",\n";
+  OS << "  \"version\": 1,\n";
+  OS << "  \"samples\": " << Opt.Samples << ",\n";
+  OS << "  \"modules\": " << ModuleCount << ",\n";
+  OS << "  \"bytes\": " << TotalBytes << ",\n";
+  OS << "  \"results\": [";
+  for (size_t I = 0; I < Results.size(); ++I) {
+    const auto &R = Results[I];
+    OS << (I == 0 ? "\n" : ",\n");
+    OS << "    {\"manager\": \"" << toString(R.M) << "\"";
+    writeStats(OS, "mb_per_s", R.MBPerSec);
+    writeStats(OS, "ns_per_byte", R.NsPerByte);
+    writeStats(OS, "free_ns_per_byte", R.FreeNsPerByte);
+    OS << ", \"allocs_per_module\": " << R.AllocsPerModule << "}";
+  }
+  OS << "\n  ]\n";
+  OS << "}\n";
+}
+
+} // namespace
+
+/// Run loader benchmark. See "tools/ssvm-bench/bench.h".
+int runLoader(const Options &Opt) {
+  const std::vector<Module> Modules = collectModules(Opt.LoaderDir);
+  uint64_t TotalBytes = 0;
+  for (const auto &Mod : Modules) {
+    TotalBytes += Mod.Code.size();
+  }
+  if (TotalBytes == 0) {
+    std::cerr << "No module found in " << Opt.LoaderDir << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::vector<Result> Results;
+  for (const auto M : {Manager::FStream, Manager::Vector, Manager::Mmap}) {
+    if (toString(M).find(Opt.Filter) == std::string_view::npos) {
+      continue;
+    }
+    std::vector<double> MBPerSec, NsPerByte, FreeNsPerByte;
+    uint64_t Allocs = 0;
+    std::vector<std::unique_ptr<AST::Module>> Parsed;
+    Parsed.reserve(Modules.size());
+    for (uint32_t I = 0; I < Opt.Samples; ++I) {
+      const uint64_t AllocStart = AllocCount.load(std::memory_order_relaxed);
+      const auto Start = std::chrono::steady_clock::now();
+      for (const auto &Mod : Modules) {
+        if (auto Res = parseModule(M, Mod)) {
+          Parsed.push_back(std::move(*Res));
+        } else {
+          std::cerr << Mod.Path << " failed with " << toString(M)
+                    << ". Error code: " << static_cast<uint32_t>(Res.error())
+                    << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+      const auto Stop = std::chrono::steady_clock::now();
+      Allocs += AllocCount.load(std::memory_order_relaxed) - AllocStart;
+      Parsed.clear();
+      const auto Freed = std::chrono::steady_clock::now();
+      const double Ns =
+          std::chrono::duration<double, std::nano>(Stop - Start).count();
+      const double FreeNs =
+          std::chrono::duration<double, std::nano>(Freed - Stop).count();
+      MBPerSec.push_back(TotalBytes / Ns * 1e9 / (1 << 20));
+      NsPerByte.push_back(Ns / TotalBytes);
+      FreeNsPerByte.push_back(FreeNs / TotalBytes);
+    }
+    Result R{M, computeStats(MBPerSec), computeStats(NsPerByte),
+             computeStats(FreeNsPerByte),
+             static_cast<double>(Allocs) / Opt.Samples / Modules.size()};
+    std::cerr << toString(M) << ": " << R.MBPerSec.Mean << " MB/s, "
+              << R.AllocsPerModule << " allocations per module" << std::endl;
+    Results.push_back(R);
+  }
+
+  if (Opt.OutputPath.empty()) {
+    writeJSON(std::cout, Opt, Modules.size(), TotalBytes, Results);
+  } else {
+    std::ofstream Fout(Opt.OutputPath);
+    writeJSON(Fout, Opt, Modules.size(), TotalBytes, Results);
+  }
+  return EXIT_SUCCESS;
+}
+
+} // namespace Bench
+} // namespace SSVM
@@ -0,0 +1,281 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "bench.h"
+#include "guest.h"
+#include "hostfunc.h"
+
+#include "host/wasi/wasimodule.h"
+#include "vm/configure.h"
+#include "vm/vm.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace SSVM {
+namespace Bench {
+
+namespace {
+
+/// Status reported by the child when the guest returned a wrong result.
+constexpr uint32_t kStatusMismatch = UINT32_MAX;
+
+/// Phase times of one run in microseconds. Written through a pipe by the child
+/// process.
+struct Sample {
+  uint32_t Status;
+  double Load;
+  double Validate;
+  double Instantiate;
+  double Execute;
+};
+
+struct Result {
+  const Guest *G;
+  RunMode Mode;
+  Stats Load;
+  Stats Validate;
+  Stats Instantiate;
+  Stats Execute;
+  long PeakRSS;
+};
+
+/// Load, validate, instantiate, and execute guest, timing every phase.
+Sample runGuest(const Guest &G, RunMode Mode, const std::string &SoPath,
+                bool Lazy) {
+  using Clock = std::chrono::steady_clock;
+  const auto Micro = [](Clock::time_point Start, Clock::time_point Stop) {
+    return std::chrono::duration<double, std::micro>(Stop - Start).count();
+  };
+  Sample S{0, 0.0, 0.0, 0.0, 0.0};
+
+  VM::Configure Conf;
+  Conf.setLazyLoading(Lazy);
+  if (G.isWasi()) {
+    Conf.addVMType(VM::Configure::VMType::Wasi);
+  }
+  VM::VM VM(Conf);
+  BenchModule HostMod;
+  if (G.isWasi()) {
+    auto *WasiMod = dynamic_cast<Host::WasiModule *>(
+        VM.getImportModule(VM::Configure::VMType::Wasi));
+    auto &CmdArgs = WasiMod->getEnv().getCmdArgs();
+    CmdArgs.push_back(G.Path);
+    CmdArgs.insert(CmdArgs.end(), G.Args.begin(), G.Args.end());
+  } else if (auto Res = VM.registerModule(HostMod); !Res) {
+    S.Status = static_cast<uint32_t>(Res.error());
+    return S;
+  }
+
+  const auto T0 = Clock::now();
+  Expect<void> Res;
+  if (Mode == RunMode::AOT) {
+    Res = VM.loadWasm(SoPath);
+  } else if (G.isWasi()) {
+    Res = VM.loadWasm(G.Path);
+  } else {
+    Res = VM.loadWasm(G.Wasm);
+  }
+  const auto T1 = Clock::now();
+  if (Res) {
+    Res = VM.validate();
+  }
+  const auto T2 = Clock::now();
+  if (Res) {
+    Res = VM.instantiate();
+  }
+  const auto T3 = Clock::now();
+  if (!Res) {
+    S.Status = static_cast<uint32_t>(Res.error());
+    return S;
+  }
+  if (G.isWasi()) {
+    if (auto Ret = VM.execute("_start");
+        !Ret && Ret.error() != ErrCode::Terminated) {
+      S.Status = static_cast<uint32_t>(Ret.error());
+    }
+  } else {
+    const std::vector<ValVariant> Params = {G.Arg};
+    if (auto Ret = VM.execute("run", Params)) {
+      if (G.Expected && std::get<uint32_t>((*Ret)[0]) != *G.Expected) {
+        S.Status = kStatusMismatch;
+      }
+    } else {
+      S.Status = static_cast<uint32_t>(Ret.error());
+    }
+  }
+  const auto T4 = Clock::now();
+
+  S.Load = Micro(T0, T1);
+  S.Validate = Micro(T1, T2);
+  S.Instantiate = Micro(T2, T3);
+  S.Execute = Micro(T3, T4);
+  return S;
+}
+
+/// Run guest in a child process to measure its peak resident set size.
+std::optional<Sample> runGuestInChild(const Guest &G, RunMode Mode,
+                                     const std::string &SoPath, bool Lazy,
+                                     long &PeakRSS) {
+  int Fds[2];
+  if (pipe(Fds) != 0) {
+    return std::nullopt;
+  }
+  std::cout.flush();
+  std::cerr.flush();
+  const pid_t Pid = fork();
+  if (Pid < 0) {
+    close(Fds[0]);
+    close(Fds[1]);
+    return std::nullopt;
+  }
+  if (Pid == 0) {
+    close(Fds[0]);
+    const Sample S = runGuest(G, Mode, SoPath, Lazy);
+    const bool Written = write(Fds[1], &S, sizeof(S)) == sizeof(S);
+    close(Fds[1]);
+    _exit(Written ? EXIT_SUCCESS : EXIT_FAILURE);
+  }
+
+  close(Fds[1]);
+  Sample S;
+  const bool Read = read(Fds[0], &S, sizeof(S)) == sizeof(S);
+  close(Fds[0]);
+  int WStatus = 0;
+  struct rusage Usage;
+  if (wait4(Pid, &WStatus, 0, &Usage) < 0 || !Read || !WIFEXITED(WStatus) ||
+      WEXITSTATUS(WStatus) != EXIT_SUCCESS) {
+    return std::nullopt;
+  }
+  PeakRSS = std::max(PeakRSS, Usage.ru_maxrss);
+  return S;
+}
+
+void writeStats(std::ostream &OS, std::string_view Name, const Stats &S) {
+  OS << ", \"" << Name << "\": {\"mean\": " << S.Mean
+     << ", \"stddev\": " << S.Stddev << ", \"min\": " << S.Min
+     << ", \"max\": " << S.Max << "}";
+}
+
+void writeJSON(std::ostream &OS, const Options &Opt,
+               const std::vector<Result> &Results) {
+  OS << std::setprecision(3) << std::fixed;
+  OS << "{\n";
+  OS << "  \"format\": \"ssvm-bench-macro\",\n";
+  OS << "  \"version\": 1,\n";
+  OS << "  \"samples\": " << Opt.Samples << ",\n";
+  OS << "  \"results\": [";
+  for (size_t I = 0; I < Results.size(); ++I) {
+    const auto &R = Results[I];
+    OS << (I == 0 ? "\n" : ",\n");
+    OS << "    {\"guest\": \"" << R.G->Name << "\", \"mode\": \""
+       << toString(R.Mode) << "\"";
+    writeStats(OS, "load_us", R.Load);
+    writeStats(OS, "validate_us", R.Validate);
+    writeStats(OS, "instantiate_us", R.Instantiate);
+    writeStats(OS, "execute_us", R.Execute);
+    OS << ", \"peak_rss_kib\": " << R.PeakRSS << "}";
+  }
+  OS << "\n  ]\n";
+  OS << "}\n";
+}
+
+} // namespace
+
+/// Run macro benchmark. See "tools/ssvm-bench/bench.h".
+int runMacro(const Options &Opt) {
+  std::vector<Guest> Guests = makeGuests();
+  if (!Opt.Manifest.empty()) {
+    if (auto Res = loadManifest(Opt.Manifest)) {
+      Guests.insert(Guests.end(), std::make_move_iterator(Res->begin()),
+                    std::make_move_iterator(Res->end()));
+    } else {
+      std::cerr << "Failed to read manifest " << Opt.Manifest << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  std::vector<const Guest *> Selected;
+  for (const auto &G : Guests) {
+    if (G.Name.find(Opt.Filter) != std::string::npos) {
+      Selected.push_back(&G);
+    }
+  }
+
+  if (Opt.List) {
+    for (const auto *G : Selected) {
+      std::cout << G->Name << '\t' << (G->isWasi() ? G->Path : "built-in")
+                << std::endl;
+    }
+    return EXIT_SUCCESS;
+  }
+
+  std::vector<Result> Results;
+  for (const auto *G : Selected) {
+    for (const auto Mode : Opt.getModes()) {
+      std::string SoPath;
+      if (Mode == RunMode::AOT) {
+        auto Res = G->isWasi() ? compileAOT(G->Path, G->Name)
+                               : compileAOT(G->Wasm, G->Name);
+        if (!Res) {
+          std::cerr << G->Name << " compile failed. Error code: "
+                    << static_cast<uint32_t>(Res.error()) << std::endl;
+          return EXIT_FAILURE;
+        }
+        SoPath = std::move(*Res);
+      }
+
+      std::vector<double> Load, Validate, Instantiate, Execute;
+      long PeakRSS = 0;
+      for (uint32_t I = 0; I < Opt.Samples; ++I) {
+        auto Res = runGuestInChild(*G, Mode, SoPath, Opt.Lazy, PeakRSS);
+        if (!Res) {
+          std::cerr << G->Name << " failed to run in child process."
+                    << std::endl;
+          return EXIT_FAILURE;
+        }
+        if (Res->Status == kStatusMismatch) {
+          std::cerr << G->Name << " returned a wrong result." << std::endl;
+          return EXIT_FAILURE;
+        }
+        if (Res->Status != 0) {
+          std::cerr << G->Name << " failed. Error code: " << Res->Status
+                    << std::endl;
+          return EXIT_FAILURE;
+        }
+        Load.push_back(Res->Load);
+        Validate.push_back(Res->Validate);
+        Instantiate.push_back(Res->Instantiate);
+        Execute.push_back(Res->Execute);
+      }
+      Result R{G,
+               Mode,
+               computeStats(Load),
+               computeStats(Validate),
+               computeStats(Instantiate),
+               computeStats(Execute),
+               PeakRSS};
+      std::cerr << G->Name << " (" << toString(Mode)
+                << "): execute " << R.Execute.Mean << " us, peak RSS "
+                << R.PeakRSS << " KiB" << std::endl;
+      Results.push_back(R);
+    }
+  }
+
+  if (Opt.OutputPath.empty()) {
+    writeJSON(std::cout, Opt, Results);
+  } else {
+    std::ofstream Fout(Opt.OutputPath);
+    writeJSON(Fout, Opt, Results);
+  }
+  return EXIT_SUCCESS;
+}
+
+} // namespace Bench
+} // namespace SSVM
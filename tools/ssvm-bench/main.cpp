@@ -0,0 +1,108 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "bench.h"
+
+#include "support/log.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <string>
+
+namespace {
+
+using SSVM::Bench::Options;
+
+void printUsage() {
+  std::cerr
+      << "Usage: ./ssvm-bench [options]\n"
+         "       ./ssvm-bench --macro [--manifest FILE] [options]\n"
+         "       ./ssvm-bench --loader DIR [options]\n"
+         "       ./ssvm-bench --compare BASE.json NEW.json [--threshold PCT]\n"
+         "  --mode interpreter|aot|all  execution modes to measure\n"
+         "  --iterations N              loop iterations per sample\n"
+         "  --samples N                 samples per kernel or guest\n"
+         "  --filter STR                run kernels whose name contains STR\n"
+         "  --output FILE               write JSON results to FILE\n"
+         "  --dump-wat DIR              write the generated .wat kernels\n"
+         "  --list                      list kernels or guests and exit\n"
+         "  --macro                     run the end-to-end workloads\n"
+         "  --manifest FILE             add external WASI guests\n"
+         "  --lazy                      decode function bodies on first call\n"
+         "  --loader DIR                measure parsing throughput of modules\n"
+         "  --compare BASE NEW          diff two result files\n"
+         "  --threshold PCT             allowed slowdown, default 5\n";
+}
+
+std::optional<Options> parseOptions(int Argc, char *Argv[]) {
+  Options Opt;
+  for (int I = 1; I < Argc; ++I) {
+    const std::string Arg(Argv[I]);
+    const bool HasValue = I + 1 < Argc;
+    if (Arg == "--mode" && HasValue) {
+      const std::string Mode(Argv[++I]);
+      Opt.RunInterpreter = (Mode == "interpreter" || Mode == "all");
+      Opt.RunAOT = (Mode == "aot" || Mode == "all");
+      if (!Opt.RunInterpreter && !Opt.RunAOT) {
+        return std::nullopt;
+      }
+    } else if (Arg == "--iterations" && HasValue) {
+      Opt.Iterations = std::stoul(Argv[++I]);
+    } else if (Arg == "--samples" && HasValue) {
+      Opt.Samples = std::max(1UL, std::stoul(Argv[++I]));
+    } else if (Arg == "--filter" && HasValue) {
+      Opt.Filter = Argv[++I];
+    } else if (Arg == "--output" && HasValue) {
+      Opt.OutputPath = Argv[++I];
+    } else if (Arg == "--dump-wat" && HasValue) {
+      Opt.WatDir = Argv[++I];
+    } else if (Arg == "--list") {
+      Opt.List = true;
+    } else if (Arg == "--macro") {
+      Opt.Macro = true;
+    } else if (Arg == "--manifest" && HasValue) {
+      Opt.Manifest = Argv[++I];
+    } else if (Arg == "--lazy") {
+      Opt.Lazy = true;
+    } else if (Arg == "--loader" && HasValue) {
+      Opt.LoaderDir = Argv[++I];
+    } else if (Arg == "--compare" && I + 2 < Argc) {
+      Opt.CompareBase = Argv[++I];
+      Opt.CompareNew = Argv[++I];
+    } else if (Arg == "--threshold" && HasValue) {
+      Opt.Threshold = std::stod(Argv[++I]);
+    } else {
+      return std::nullopt;
+    }
+  }
+  return Opt;
+}
+
+} // namespace
+
+int main(int Argc, char *Argv[]) {
+  const auto Opt = parseOptions(Argc, Argv);
+  if (!Opt) {
+    printUsage();
+    return EXIT_FAILURE;
+  }
+  SSVM::Log::setErrorLoggingLevel();
+
+  if (!Opt->CompareBase.empty()) {
+    return SSVM::Bench::runCompare(*Opt);
+  }
+  if (!Opt->LoaderDir.empty()) {
+    return SSVM::Bench::runLoader(*Opt);
+  }
+#ifndef SSVM_BENCH_AOT
+  if (Opt->RunAOT) {
+    std::cerr << "AOT mode is not available: built without the AOT runtime."
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+#endif
+  if (Opt->Macro) {
+    return SSVM::Bench::runMacro(*Opt);
+  }
+  return SSVM::Bench::runMicro(*Opt);
+}
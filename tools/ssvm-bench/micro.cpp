@@ -0,0 +1,162 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "bench.h"
+#include "hostfunc.h"
+#include "kernel.h"
+
+#include "support/filesystem.h"
+#include "vm/configure.h"
+#include "vm/vm.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+namespace SSVM {
+namespace Bench {
+
+namespace {
+
+struct Result {
+  const Kernel *K;
+  RunMode Mode;
+  uint32_t Checksum;
+  Stats NsPerOp;
+};
+
+/// Load, validate, and instantiate kernel, then time `run` for every sample.
+Expect<Result> runKernel(const Kernel &K, RunMode Mode, const Options &Opt) {
+  VM::Configure Conf;
+  VM::VM VM(Conf);
+  BenchModule HostMod;
+  if (auto Res = VM.registerModule(HostMod); !Res) {
+    return Unexpect(Res);
+  }
+
+  if (Mode == RunMode::Interpreter) {
+    if (auto Res = VM.loadWasm(K.Wasm); !Res) {
+      return Unexpect(Res);
+    }
+  } else {
+    if (auto Path = compileAOT(K.Wasm, K.Name)) {
+      if (auto Res = VM.loadWasm(*Path); !Res) {
+        return Unexpect(Res);
+      }
+    } else {
+      return Unexpect(Path);
+    }
+  }
+  if (auto Res = VM.validate(); !Res) {
+    return Unexpect(Res);
+  }
+  if (auto Res = VM.instantiate(); !Res) {
+    return Unexpect(Res);
+  }
+
+  /// Warm up with a tenth of the iterations.
+  const std::vector<ValVariant> WarmUpParams = {Opt.Iterations / 10 + 1};
+  if (auto Res = VM.execute("run", WarmUpParams); !Res) {
+    return Unexpect(Res);
+  }
+
+  const double Ops = static_cast<double>(Opt.Iterations) * K.OpsPerIter;
+  std::vector<double> NsPerOp;
+  NsPerOp.reserve(Opt.Samples);
+  const std::vector<ValVariant> Params = {Opt.Iterations};
+  uint32_t Checksum = 0;
+  for (uint32_t I = 0; I < Opt.Samples; ++I) {
+    const auto Start = std::chrono::steady_clock::now();
+    auto Res = VM.execute("run", Params);
+    const auto Stop = std::chrono::steady_clock::now();
+    if (!Res) {
+      return Unexpect(Res);
+    }
+    Checksum = std::get<uint32_t>((*Res)[0]);
+    const std::chrono::duration<double, std::nano> Elapsed = Stop - Start;
+    NsPerOp.push_back(Elapsed.count() / Ops);
+  }
+  return Result{&K, Mode, Checksum, computeStats(NsPerOp)};
+}
+
+void writeJSON(std::ostream &OS, const Options &Opt,
+               const std::vector<Result> &Results) {
+  OS << std::setprecision(6) << std::fixed;
+  OS << "{\n";
+  OS << "  \"format\": \"ssvm-bench-micro\",\n";
+  OS << "  \"version\": 1,\n";
+  OS << "  \"iterations\": " << Opt.Iterations << ",\n";
+  OS << "  \"samples\": " << Opt.Samples << ",\n";
+  OS << "  \"results\": [";
+  for (size_t I = 0; I < Results.size(); ++I) {
+    const auto &R = Results[I];
+    OS << (I == 0 ? "\n" : ",\n");
+    OS << "    {\"kernel\": \"" << R.K->Name << "\", \"class\": \""
+       << R.K->Class << "\", \"mode\": \"" << toString(R.Mode)
+       << "\", \"ops_per_iter\": " << R.K->OpsPerIter
+       << ", \"checksum\": " << R.Checksum
+       << ", \"ns_per_op\": {\"mean\": " << R.NsPerOp.Mean
+       << ", \"stddev\": " << R.NsPerOp.Stddev
+       << ", \"min\": " << R.NsPerOp.Min << ", \"max\": " << R.NsPerOp.Max
+       << "}}";
+  }
+  OS << "\n  ]\n";
+  OS << "}\n";
+}
+
+} // namespace
+
+/// Run micro benchmark. See "tools/ssvm-bench/bench.h".
+int runMicro(const Options &Opt) {
+  const std::vector<Kernel> Kernels = makeKernels();
+  std::vector<const Kernel *> Selected;
+  for (const auto &K : Kernels) {
+    if (K.Name.find(Opt.Filter) != std::string::npos) {
+      Selected.push_back(&K);
+    }
+  }
+
+  if (Opt.List) {
+    for (const auto *K : Selected) {
+      std::cout << K->Name << '\t' << K->Class << '\t' << K->OpsPerIter
+                << std::endl;
+    }
+    return EXIT_SUCCESS;
+  }
+
+  if (!Opt.WatDir.empty()) {
+    std::filesystem::create_directories(Opt.WatDir);
+    for (const auto *K : Selected) {
+      std::ofstream Fout(std::filesystem::path(Opt.WatDir) /
+                         (K->Name + ".wat"));
+      Fout << K->Wat;
+    }
+    return EXIT_SUCCESS;
+  }
+
+  std::vector<Result> Results;
+  for (const auto *K : Selected) {
+    for (const auto Mode : Opt.getModes()) {
+      if (auto Res = runKernel(*K, Mode, Opt)) {
+        std::cerr << K->Name << " (" << toString(Mode)
+                  << "): " << Res->NsPerOp.Mean << " ns/op" << std::endl;
+        Results.push_back(*Res);
+      } else {
+        std::cerr << K->Name << " failed. Error code: "
+                  << static_cast<uint32_t>(Res.error()) << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  if (Opt.OutputPath.empty()) {
+    writeJSON(std::cout, Opt, Results);
+  } else {
+    std::ofstream Fout(Opt.OutputPath);
+    writeJSON(Fout, Opt, Results);
+  }
+  return EXIT_SUCCESS;
+}
+
+} // namespace Bench
+} // namespace SSVM
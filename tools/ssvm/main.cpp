@@ -4,30 +4,49 @@
 #include "vm/vm.h"
 
 #include <iostream>
+#include <string_view>
 
 int main(int Argc, char *Argv[]) {
-  if (Argc < 3) {
+  SSVM::VM::Configure Conf;
+  int ArgBase = 1;
+  bool HostStats = false;
+  while (ArgBase < Argc) {
+    const std::string_view Option(Argv[ArgBase]);
+    if (Option == "--cache-dir" && ArgBase + 1 < Argc) {
+      /// Keep validated modules in the directory.
+      Conf.setCacheDir(Argv[ArgBase + 1]);
+      ArgBase += 2;
+    } else if (Option == "--host-stats") {
+      /// Print the host function statistics to stderr at exit.
+      Conf.setHostFuncStats(true);
+      HostStats = true;
+      ArgBase += 1;
+    } else {
+      break;
+    }
+  }
+  if (Argc < ArgBase + 2) {
     /// Arg0: ./ssvm
-    /// Arg1: wasm file
+    /// Arg1: wasm file or module cache file
     /// Arg2: invoke function name
     /// Arg3...: inputs
-    std::cout << "Usage: ./ssvm wasm_file.wasm func_name [args...]"
+    std::cout << "Usage: ./ssvm [--cache-dir DIR] [--host-stats] "
+                 "wasm_file.wasm func_name [args...]"
               << std::endl;
     return 0;
   }
 
-  std::string InputPath(Argv[1]);
-  SSVM::VM::Configure Conf;
+  std::string InputPath(Argv[ArgBase]);
   SSVM::VM::VM VM(Conf);
 
   /// Parameters and return values.
   std::vector<SSVM::ValVariant> Params, Results;
   uint32_t Err = 0;
 
-  for (int I = 3; I < Argc; I++) {
+  for (int I = ArgBase + 2; I < Argc; I++) {
     Params.push_back(static_cast<uint32_t>(std::stoul(Argv[I])));
   }
-  if (auto Res = VM.runWasmFile(InputPath, Argv[2], Params)) {
+  if (auto Res = VM.runWasmFile(InputPath, Argv[ArgBase + 1], Params)) {
     Results = *Res;
     for (auto &It : Results) {
       std::cout << " Return value: " << std::get<uint32_t>(It) << std::endl;
@@ -37,5 +56,9 @@ int main(int Argc, char *Argv[]) {
     std::cout << " Failed. Code : " << Err << std::endl;
   }
 
+  if (HostStats) {
+    VM.dumpHostFuncStats(std::cerr);
+  }
+
   return Err;
 }